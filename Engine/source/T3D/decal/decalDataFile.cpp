@@ -31,6 +31,8 @@
 #include "T3D/decal/decalData.h"
 
 
+bool DecalDataFile::smUseClipCache = true;
+
 template<>
 void* Resource<DecalDataFile>::create( const Torque::Path &path )
 {
@@ -141,6 +143,24 @@ bool DecalDataFile::write( Stream& stream )
 		stream.write( inst->mTextureRectIdx );   
       stream.write( inst->mSize );
       stream.write( inst->mRenderPriority );
+
+      // Save the clipped geometry so it doesn't have to be
+      // clipped again when the file is loaded.
+      const bool hasGeometry = inst->mVerts && !( inst->mFlags & ClipDecal );
+      const U32 vertCount = hasGeometry ? inst->mVertCount : 0;
+      const U32 indxCount = hasGeometry ? inst->mIndxCount : 0;
+      stream.write( vertCount );
+      stream.write( indxCount );
+      for ( U32 j = 0; j < vertCount; j++ )
+      {
+         const DecalVertex &vert = inst->mVerts[j];
+         mathWrite( stream, vert.point );
+         mathWrite( stream, vert.normal );
+         mathWrite( stream, vert.tangent );
+         mathWrite( stream, vert.texCoord );
+      }
+      for ( U32 j = 0; j < indxCount; j++ )
+         stream.write( inst->mIndices[j] );
    }
 
    // Clear the dirty flag.
@@ -175,7 +195,7 @@ bool DecalDataFile::read( Stream &stream )
    // Now the version number.
    U8 version;
    stream.read( &version );
-   if ( version != (U8)FILE_VERSION )
+   if ( version < (U8)MIN_FILE_VERSION || version > (U8)FILE_VERSION )
    {
       Con::errorf( "DecalDataFile::read() - file versions do not match!" );
       Con::errorf( "You must manually delete the old .decals file before continuing!" );
@@ -218,6 +238,8 @@ bool DecalDataFile::read( Stream &stream )
 
    U8 dataIndex;   
    DecalData *data;
+   DecalVertex skipVert;
+   U16 skipIndex;
 
    // Now read all the DecalInstance(s).
    stream.read( &count );
@@ -240,9 +262,38 @@ bool DecalDataFile::read( Stream &stream )
       inst->mIndices = NULL;
       inst->mVertCount = 0;
       inst->mIndxCount = 0;
+      inst->mLastAlpha = -1.0f;
 
       data = allDatablocks[ dataIndex ];
 
+      U32 vertCount = 0;
+      U32 indxCount = 0;
+      if ( version >= 6 )
+      {
+         stream.read( &vertCount );
+         stream.read( &indxCount );
+      }
+
+      // Use the geometry saved with the decal if we can or else
+      // read past it and let the decal be clipped when it renders.
+      const bool useGeometry = data && smUseClipCache && vertCount && indxCount;
+      if ( useGeometry )
+      {
+         gDecalManager->allocDecalGeometry( inst, vertCount, indxCount );
+         inst->mFlags &= ~ClipDecal;
+      }
+
+      for ( U32 j = 0; j < vertCount; j++ )
+      {
+         DecalVertex &vert = useGeometry ? inst->mVerts[j] : skipVert;
+         mathRead( stream, &vert.point );
+         mathRead( stream, &vert.normal );
+         mathRead( stream, &vert.tangent );
+         mathRead( stream, &vert.texCoord );
+      }
+      for ( U32 j = 0; j < indxCount; j++ )
+         stream.read( useGeometry ? &inst->mIndices[j] : &skipIndex );
+
       if ( data )          
       {         
          inst->mDataBlock = data;
@@ -48,7 +48,11 @@ class DecalDataFile
 {
    protected:
 
-      enum { FILE_VERSION = 5 };
+      /// Version 6 added the clipped geometry of the decals.
+      enum { FILE_VERSION = 6 };
+
+      /// The oldest version which can still be read.
+      enum { MIN_FILE_VERSION = 5 };
 
       /// Set to true if the file is dirty and
       /// needs to be saved before being destroyed.
@@ -90,6 +94,10 @@ class DecalDataFile
    
    public:
 
+      /// If true, decals loaded with clipped geometry use it instead
+      /// of being clipped against the scene again.
+      static bool smUseClipCache;
+
       DecalDataFile();
       virtual ~DecalDataFile();
 
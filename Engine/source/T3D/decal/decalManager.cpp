@@ -48,6 +48,7 @@
 #include "core/module.h"
 #include "T3D/decal/decalData.h"
 #include "console/engineAPI.h"
+#include "platform/threads/threadPoolBatch.h"
 
 
 extern bool gEditingMission;
@@ -83,6 +84,7 @@ F32       DecalManager::smDecalLifeTimeScale = 1.0f;
 bool      DecalManager::smPoolBuffers = true;
 const U32 DecalManager::smMaxVerts = 6000;
 const U32 DecalManager::smMaxIndices = 10000;
+S32       DecalManager::smParallelClipThreshold = 8;
 
 DecalManager *gDecalManager = NULL;
 
@@ -242,6 +244,9 @@ DecalManager::~DecalManager()
 
    for( U32 i = 0; i < NUM_SIZE_CLASSES; ++ i )
       delete mChunkers[ i ];
+
+   for( U32 i = 0; i < mClipJobs.size(); ++ i )
+      delete mClipJobs[ i ];
 }
 
 void DecalManager::consoleInit()
@@ -261,6 +266,18 @@ void DecalManager::consoleInit()
       "If false, will just clear them at the end of a frame.\n"
       "@ingroup Decals" );
 
+   Con::addVariable( "$Decals::parallelClipThreshold", TypeS32, &smParallelClipThreshold,
+      "The number of decals which need clipping in the same frame before the "
+      "clipping is spread across the worker threads.  Set to 0 to always clip "
+      "on the main thread.\n\n"
+      "@ingroup Decals" );
+
+   Con::addVariable( "$Decals::useClipCache", TypeBool, &DecalDataFile::smUseClipCache,
+      "If true, decals loaded from a decal file use the clipped geometry saved "
+      "with them instead of being clipped against the scene again.  Turn this off "
+      "after changing the geometry under saved decals.\n\n"
+      "@ingroup Decals" );
+
    Con::addVariable( "$Decals::debugRender", TypeBool, &smDebugRender,
       "If true, the decal spheres will be visualized when in the editor.\n\n"
       "@ingroup Decals" );
@@ -309,18 +326,133 @@ bool DecalManager::clipDecal( DecalInstance *decal, Vector<Point3F> *edgeVerts,
 {
    PROFILE_SCOPE( DecalManager_clipDecal );
 
-   // Free old verts and indices.
-   _freeBuffers( decal );
+   if ( mClipJobs.empty() )
+      mClipJobs.push_back( new ClipJob );
+
+   ClipJob *job = mClipJobs[0];
+   _beginClip( job, decal, clipDepth, edgeVerts != NULL );
+   _clipJob( job );
+
+   if ( edgeVerts )
+   {
+      edgeVerts->clear();
+      edgeVerts->merge( job->edgeVerts );
+   }
+
+   return _endClip( job );
+}
+
+U32 DecalManager::clipDecals( const Vector<DecalInstance*> &decals )
+{
+   Vector<bool> succeeded;
+   succeeded.setSize( decals.size() );
+
+   _clipDecals( decals.address(), decals.size(), succeeded.address() );
+
+   U32 count = 0;
+   for ( U32 i = 0; i < succeeded.size(); i++ )
+      count += succeeded[i];
+
+   return count;
+}
+
+struct DecalManager::ClipWorkItem : public ThreadPoolBatch::Item
+{
+   DecalManager *mManager;
+   ClipJob **mJobs;
+   U32 mCount;
+
+   ClipWorkItem( DecalManager *manager, ClipJob **jobs, U32 count )
+      :  mManager( manager ),
+         mJobs( jobs ),
+         mCount( count ) {}
+
+protected:
+
+   virtual void executeItem()
+   {
+      for ( U32 i = 0; i < mCount; i++ )
+         mManager->_clipJob( mJobs[i] );
+   }
+};
+
+void DecalManager::_clipDecals( DecalInstance * const *decals, U32 count, bool *outSucceeded )
+{
+   PROFILE_SCOPE( DecalManager_clipDecals );
+
+   ThreadPool &pool = ThreadPool::GLOBAL();
+
+   // Work through the decals in rounds so that we only hold
+   // on to the geometry of a limited number of them at once.
+   const U32 jobsPerRound = 64 * ( pool.getNumThreads() + 1 );
+
+   for ( U32 first = 0; first < count; first += jobsPerRound )
+   {
+      const U32 numJobs = getMin( jobsPerRound, count - first );
+      while ( mClipJobs.size() < numJobs )
+         mClipJobs.push_back( new ClipJob );
+
+      // The scene container is not thread safe so
+      // gather the geometry on this thread.
+      PROFILE_START( DecalManager_clipDecals_buildPolyList );
+      for ( U32 i = 0; i < numJobs; i++ )
+         _beginClip( mClipJobs[i], decals[ first + i ], NULL, false );
+      PROFILE_END();
+
+      U32 numRanges = 1;
+      if ( smParallelClipThreshold > 0 && numJobs >= U32( smParallelClipThreshold ) )
+      {
+         const U32 minJobsPerRange = getMax( U32( smParallelClipThreshold ) / 2, 1U );
+         numRanges = mClamp( numJobs / minJobsPerRange, 1, pool.getNumThreads() + 1 );
+      }
+
+      if ( numRanges < 2 )
+      {
+         for ( U32 i = 0; i < numJobs; i++ )
+            _clipJob( mClipJobs[i] );
+      }
+      else
+      {
+         Vector< ThreadSafeRef< ClipWorkItem > > items;
+         items.setSize( numRanges );
+
+         ThreadPoolBatch batch;
+
+         const U32 jobsPerRange = numJobs / numRanges;
+         U32 start = 0;
+         for ( U32 i = 0; i < numRanges; i++, start += jobsPerRange )
+         {
+            const U32 rangeCount = ( i == numRanges - 1 ) ? numJobs - start : jobsPerRange;
+            items[i] = new ClipWorkItem( this, mClipJobs.address() + start, rangeCount );
+            batch.add( items[i] );
+         }
+
+         batch.wait();
+      }
+
+      for ( U32 i = 0; i < numJobs; i++ )
+         outSucceeded[ first + i ] = _endClip( mClipJobs[i] );
+   }
+}
+
+void DecalManager::_beginClip( ClipJob *job, DecalInstance *decal, const Point2F *clipDepth, bool wantEdgeVerts )
+{
+   job->decal = decal;
+   job->wantEdgeVerts = wantEdgeVerts;
+   job->succeeded = false;
+   job->verts.clear();
+   job->indices.clear();
+   job->edgeVerts.clear();
 
    F32 halfSize = decal->mSize * 0.5f;
    
    // Ugly hack for ProjectedShadow!
    F32 halfSizeZ = clipDepth ? clipDepth->x : halfSize;
    F32 negHalfSize = clipDepth ? clipDepth->y : halfSize;
-   Point3F decalHalfSize( halfSize, halfSize, halfSize );
    Point3F decalHalfSizeZ( halfSizeZ, halfSizeZ, halfSizeZ );
 
-   MatrixF projMat( true );
+   MatrixF &projMat = job->projMat;
+   projMat.identity();
    decal->getWorldMatrix( &projMat );
 
    const VectorF &crossVec = decal->mNormal;
@@ -330,59 +462,85 @@ bool DecalManager::clipDecal( DecalInstance *decal, Vector<Point3F> *edgeVerts,
    projMat.getColumn( 0, &newRight );
    projMat.getColumn( 1, &newFwd );   
 
-   VectorF objRight( 1.0f, 0, 0 );
-   VectorF objFwd( 0, 1.0f, 0 );
-   VectorF objUp( 0, 0, 1.0f );
+   const DecalData *decalData = decal->mDataBlock;
 
    // See above re: decalHalfSizeZ hack.
-   mClipper.clear();
-   mClipper.mPlaneList.setSize(6);
-   mClipper.mPlaneList[0].set( ( decalPos + ( -newRight * halfSize ) ), -newRight );
-   mClipper.mPlaneList[1].set( ( decalPos + ( -newFwd * halfSize ) ), -newFwd );
-   mClipper.mPlaneList[2].set( ( decalPos + ( -crossVec * decalHalfSizeZ ) ), -crossVec );
-   mClipper.mPlaneList[3].set( ( decalPos + ( newRight * halfSize ) ), newRight );
-   mClipper.mPlaneList[4].set( ( decalPos + ( newFwd * halfSize ) ), newFwd );
-   mClipper.mPlaneList[5].set( ( decalPos + ( crossVec * negHalfSize ) ), crossVec );
+   ClippedPolyList &clipper = job->clipper;
+   clipper.clear();
+   clipper.mPlaneList.setSize(6);
+   clipper.mPlaneList[0].set( ( decalPos + ( -newRight * halfSize ) ), -newRight );
+   clipper.mPlaneList[1].set( ( decalPos + ( -newFwd * halfSize ) ), -newFwd );
+   clipper.mPlaneList[2].set( ( decalPos + ( -crossVec * decalHalfSizeZ ) ), -crossVec );
+   clipper.mPlaneList[3].set( ( decalPos + ( newRight * halfSize ) ), newRight );
+   clipper.mPlaneList[4].set( ( decalPos + ( newFwd * halfSize ) ), newFwd );
+   clipper.mPlaneList[5].set( ( decalPos + ( crossVec * negHalfSize ) ), crossVec );
+
+   clipper.mNormal = decal->mNormal;
+   clipper.mNormalTolCosineRadians = mCos( mDegToRad( decalData->clippingAngle ) );
+
+   // The geometry list has no planes so it keeps every poly
+   // facing the decal without clipping it.
+   ClippedPolyList &geometry = job->geometry;
+   geometry.clear();
+   geometry.mPlaneList.clear();
+   geometry.mNormal = clipper.mNormal;
+   geometry.mNormalTolCosineRadians = clipper.mNormalTolCosineRadians;
 
-   mClipper.mNormal = decal->mNormal;
+   Box3F box( -decalHalfSizeZ, decalHalfSizeZ );
+
+   projMat.mul( box );
+
+   getContainer()->buildPolyList( PLC_Decal, box, decalData->clippingMasks, &geometry );   
+}
+
+void DecalManager::_clipJob( ClipJob *job )
+{
+   PROFILE_SCOPE( DecalManager_clipJob );
 
+   DecalInstance *decal = job->decal;
    const DecalData *decalData = decal->mDataBlock;
+   ClippedPolyList &clipper = job->clipper;
+   const ClippedPolyList &geometry = job->geometry;
 
-   mClipper.mNormalTolCosineRadians = mCos( mDegToRad( decalData->clippingAngle ) );
+   F32 halfSize = decal->mSize * 0.5f;
+   Point3F decalHalfSize( halfSize, halfSize, halfSize );
 
-   Box3F box( -decalHalfSizeZ, decalHalfSizeZ );
+   VectorF objRight( 1.0f, 0, 0 );
+   VectorF objFwd( 0, 1.0f, 0 );
 
-   projMat.mul( box );
+   // Feed the gathered geometry through the clipper.  It is already
+   // in world space so the clipper keeps its identity transform.
+   for ( U32 i = 0; i < geometry.mVertexList.size(); i++ )
+      clipper.addPointAndNormal( geometry.mVertexList[i].point, geometry.mNormalList[i] );
 
-   PROFILE_START( DecalManager_clipDecal_buildPolyList );
-   getContainer()->buildPolyList( PLC_Decal, box, decalData->clippingMasks, &mClipper );   
-   PROFILE_END();
+   for ( U32 i = 0; i < geometry.mPolyList.size(); i++ )
+   {
+      const ClippedPolyList::Poly &poly = geometry.mPolyList[i];
 
-   mClipper.cullUnusedVerts();
-   mClipper.triangulate();
+      clipper.begin( poly.material, poly.surfaceKey );
+      for ( U32 j = 0; j < poly.vertexCount; j++ )
+         clipper.vertex( geometry.mIndexList[ poly.vertexStart + j ] );
+      clipper.plane( poly.plane );
+      clipper.end();
+   }
+
+   clipper.cullUnusedVerts();
+   clipper.triangulate();
    
-   const U32 numVerts = mClipper.mVertexList.size();
-   const U32 numIndices = mClipper.mIndexList.size();
+   const U32 numVerts = clipper.mVertexList.size();
+   const U32 numIndices = clipper.mIndexList.size();
 
    if ( !numVerts || !numIndices )
-      return false;
+      return;
 
    // Fail if either of the buffer metrics exceeds our limits
    // on dynamic geometry buffers.
    if ( numVerts > smMaxVerts ||
         numIndices > smMaxIndices )
-      return false;
+      return;
 
    if ( !decalData->skipVertexNormals )
-      mClipper.generateNormals();
-   
-#ifdef DECALMANAGER_DEBUG
-   mDebugPlanes.clear();
-   mDebugPlanes.merge( mClipper.mPlaneList );
-#endif
-
-   decal->mVertCount = numVerts;
-   decal->mIndxCount = numIndices;
+      clipper.generateNormals();
    
    Vector<Point3F> tmpPoints;
 
@@ -392,6 +550,7 @@ bool DecalManager::clipDecal( DecalInstance *decal, Vector<Point3F> *edgeVerts,
    
    Point3F lowerLeft(( -objFwd * decalHalfSize ) + ( objRight * decalHalfSize ));
 
+   MatrixF projMat( job->projMat );
    projMat.inverse();
 
    _generateWindingOrder( lowerLeft, &tmpPoints );
@@ -404,18 +563,17 @@ bool DecalManager::clipDecal( DecalInstance *decal, Vector<Point3F> *edgeVerts,
    Point2F uv( 0, 0 );
    Point3F vecX(0.0f, 0.0f, 0.0f);
 
-   // Allocate memory for vert and index arrays
-   _allocBuffers( decal );  
+   job->verts.setSize( numVerts );
+   job->indices.setSize( numIndices );
 
-   // Mark this so that the color will be assigned on these verts the next
-   // time it renders, since we just threw away the previous verts.
-   decal->mLastAlpha = -1;
-   
    Point3F vertPoint( 0, 0, 0 );
 
-   for ( U32 i = 0; i < mClipper.mVertexList.size(); i++ )
+   const RectF &rect = decalData->texRect[decal->mTextureRectIdx];
+
+   for ( U32 i = 0; i < numVerts; i++ )
    {
-      const ClippedPolyList::Vertex &vert = mClipper.mVertexList[i];
+      const ClippedPolyList::Vertex &vert = clipper.mVertexList[i];
+      DecalVertex &outVert = job->verts[i];
       vertPoint = vert.point;
 
       // Transform this point to
@@ -430,73 +588,107 @@ bool DecalManager::clipDecal( DecalInstance *decal, Vector<Point3F> *edgeVerts,
       // Get our UV.
       uv = quadToSquare.transform( Point2F( vertPoint.x, vertPoint.y ) );
 
-      const RectF &rect = decal->mDataBlock->texRect[decal->mTextureRectIdx];
-
       uv *= rect.extent;
       uv += rect.point;      
 
       // Set the world space vertex position.
-      decal->mVerts[i].point = vert.point;
+      outVert.point = vert.point;
       
-      decal->mVerts[i].texCoord.set( uv.x, uv.y );
+      outVert.texCoord.set( uv.x, uv.y );
       
-      if ( mClipper.mNormalList.empty() )
+      if ( clipper.mNormalList.empty() )
          continue;
 
-      decal->mVerts[i].normal = mClipper.mNormalList[i];
-      decal->mVerts[i].normal.normalize();
+      outVert.normal = clipper.mNormalList[i];
+      outVert.normal.normalize();
 
-      if( mFabs( decal->mVerts[i].normal.z ) > 0.8f ) 
-         mCross( decal->mVerts[i].normal, Point3F( 1.0f, 0.0f, 0.0f ), &vecX );
-      else if ( mFabs( decal->mVerts[i].normal.x ) > 0.8f )
-         mCross( decal->mVerts[i].normal, Point3F( 0.0f, 1.0f, 0.0f ), &vecX );
-      else if ( mFabs( decal->mVerts[i].normal.y ) > 0.8f )
-         mCross( decal->mVerts[i].normal, Point3F( 0.0f, 0.0f, 1.0f ), &vecX );
+      if( mFabs( outVert.normal.z ) > 0.8f ) 
+         mCross( outVert.normal, Point3F( 1.0f, 0.0f, 0.0f ), &vecX );
+      else if ( mFabs( outVert.normal.x ) > 0.8f )
+         mCross( outVert.normal, Point3F( 0.0f, 1.0f, 0.0f ), &vecX );
+      else if ( mFabs( outVert.normal.y ) > 0.8f )
+         mCross( outVert.normal, Point3F( 0.0f, 0.0f, 1.0f ), &vecX );
    
-      decal->mVerts[i].tangent = mCross( decal->mVerts[i].normal, vecX );
+      outVert.tangent = mCross( outVert.normal, vecX );
    }
 
    U32 curIdx = 0;
-   for ( U32 j = 0; j < mClipper.mPolyList.size(); j++ )
+   for ( U32 j = 0; j < clipper.mPolyList.size(); j++ )
    {
       // Write indices for each Poly
-      ClippedPolyList::Poly *poly = &mClipper.mPolyList[j];                  
+      ClippedPolyList::Poly *poly = &clipper.mPolyList[j];                  
 
       AssertFatal( poly->vertexCount == 3, "Got non-triangle poly!" );
 
-      decal->mIndices[curIdx] = mClipper.mIndexList[poly->vertexStart];         
+      job->indices[curIdx] = clipper.mIndexList[poly->vertexStart];         
       curIdx++;
-      decal->mIndices[curIdx] = mClipper.mIndexList[poly->vertexStart + 1];            
+      job->indices[curIdx] = clipper.mIndexList[poly->vertexStart + 1];            
       curIdx++;
-      decal->mIndices[curIdx] = mClipper.mIndexList[poly->vertexStart + 2];                
+      job->indices[curIdx] = clipper.mIndexList[poly->vertexStart + 2];                
       curIdx++;
    } 
 
-   if ( !edgeVerts )
-      return true;
+   job->succeeded = true;
+
+   if ( !job->wantEdgeVerts )
+      return;
 
    Point3F tmpHullPt( 0, 0, 0 );
    Vector<Point3F> tmpHullPts;
 
-   for ( U32 i = 0; i < mClipper.mVertexList.size(); i++ )
+   for ( U32 i = 0; i < numVerts; i++ )
    {
-      const ClippedPolyList::Vertex &vert = mClipper.mVertexList[i];
+      const ClippedPolyList::Vertex &vert = clipper.mVertexList[i];
       tmpHullPt = vert.point;
       projMat.mulP( tmpHullPt );
       tmpHullPts.push_back( tmpHullPt );
    }
 
-   edgeVerts->clear();
-   U32 verts = _generateConvexHull( tmpHullPts, edgeVerts );
-   edgeVerts->setSize( verts );
+   Vector<Point3F> &edgeVerts = job->edgeVerts;
+   U32 verts = _generateConvexHull( tmpHullPts, &edgeVerts );
+   edgeVerts.setSize( verts );
 
-   projMat.inverse();
-   for ( U32 i = 0; i < edgeVerts->size(); i++ )
-      projMat.mulP( (*edgeVerts)[i] );
+   for ( U32 i = 0; i < edgeVerts.size(); i++ )
+      job->projMat.mulP( edgeVerts[i] );
+}
+
+bool DecalManager::_endClip( ClipJob *job )
+{
+   DecalInstance *decal = job->decal;
+
+   // Free old verts and indices.
+   _freeBuffers( decal );
+
+   if ( !job->succeeded )
+      return false;
+
+#ifdef DECALMANAGER_DEBUG
+   mDebugPlanes.clear();
+   mDebugPlanes.merge( job->clipper.mPlaneList );
+#endif
+
+   allocDecalGeometry( decal, job->verts.size(), job->indices.size() );
+   dMemcpy( decal->mVerts, job->verts.address(), sizeof( DecalVertex ) * decal->mVertCount );
+   dMemcpy( decal->mIndices, job->indices.address(), sizeof( U16 ) * decal->mIndxCount );
 
    return true;
 }
 
+void DecalManager::allocDecalGeometry( DecalInstance *decal, U32 vertCount, U32 indexCount )
+{
+   _freeBuffers( decal );
+
+   decal->mVertCount = vertCount;
+   decal->mIndxCount = indexCount;
+
+   // Allocate memory for vert and index arrays
+   _allocBuffers( decal );  
+
+   // Mark this so that the color will be assigned on these verts the next
+   // time it renders, since we just threw away the previous verts.
+   decal->mLastAlpha = -1;
+}
+
 DecalInstance* DecalManager::addDecal( const Point3F &pos,
                                        const Point3F &normal,
                                        F32 rotAroundNormal,
@@ -1062,7 +1254,7 @@ void DecalManager::prepRenderImage( SceneRenderState* state )
 
    // Loop through DecalQueue once for preRendering work.
    // 1. Update DecalInstance fade (over time)
-   // 2. Clip geometry if flagged to do so.
+   // 2. Queue clipping of the geometry if flagged to do so.
    // 3. Calculate lod - if decal is far enough away it will not render.
    for ( U32 i = 0; i < mDecalQueue.size(); i++ )
    {
@@ -1102,35 +1294,61 @@ void DecalManager::prepRenderImage( SceneRenderState* state )
          }
       }
 
-      // Build clipped geometry for this decal if needed.
+      // Queue up clipped geometry for this decal if needed.
       if ( dinst->mFlags & ClipDecal && !( dinst->mFlags & CustomDecal ) )
       {  
          // Turn off the flag so we don't continually try to clip
          // if it fails.
          dinst->mFlags = dinst->mFlags & ~ClipDecal;
 
-         if ( !(dinst->mFlags & CustomDecal) && !clipDecal( dinst ) )
-         {
-            // Clipping failed to get any geometry...
-
-            // Remove it from the render queue.
-            mDecalQueue.erase_fast( i );
-            i--;
+         mClipQueue.push_back( dinst );
+      }
+   }
 
-            // If the decal is one placed at run-time (not the editor)
-            // then we should also permanently delete the decal instance.
-            if ( !(dinst->mFlags & SaveDecal) )
-            {
-               removeDecal( dinst );
-            }
+   // Clip all the decals which need it together so
+   // the work can be spread across the thread pool.
+   if ( !mClipQueue.empty() )
+   {
+      static Vector<bool> clipped;
+      clipped.setSize( mClipQueue.size() );
+      _clipDecals( mClipQueue.address(), mClipQueue.size(), clipped.address() );
 
-            // If this is a decal placed by the editor it will be
-            // flagged to attempt clipping again the next time it is
-            // modified. For now we just skip rendering it.      
+      for ( U32 i = 0; i < mClipQueue.size(); i++ )
+      {
+         if ( clipped[i] )
             continue;
-         }         
+
+         // Clipping failed to get any geometry...
+         dinst = mClipQueue[i];
+
+         // Remove it from the render queue.
+         mDecalQueue.erase_fast( mDecalQueue.find_next( dinst ) );
+
+         // If the decal is one placed at run-time (not the editor)
+         // then we should also permanently delete the decal instance.
+         if ( !(dinst->mFlags & SaveDecal) )
+         {
+            removeDecal( dinst );
+         }
+
+         // If this is a decal placed by the editor it will be
+         // flagged to attempt clipping again the next time it is
+         // modified. For now we just skip rendering it.      
       }
 
+      mClipQueue.clear();
+   }
+
+   // Loop through DecalQueue again for the work which needs the geometry.
+   // 1. Skip decals without geometry.
+   // 2. Update the vertex alpha.
+   for ( U32 i = 0; i < mDecalQueue.size(); i++ )
+   {
+      dinst = mDecalQueue[i];
+      ddata = dinst->mDataBlock;
+
+      pixelSize = dinst->calcPixelSize( state->getViewport().extent.y, state->getCameraPosition(), state->getWorldToScreenScale().y );
+
       // If we get here and the decal still does not have any geometry
       // skip rendering it. It must be an editor placed decal that failed
       // to clip any geometry but has not yet been flagged to try again.
@@ -93,12 +93,42 @@ class DecalManager : public SceneObject
 
    protected:
       
-      /// The clipper we keep around between decal updates
+      /// A decal being clipped.  The scene geometry around the decal
+      /// is gathered on the main thread so that clipping it and building
+      /// the vertices can happen on a worker thread.
+      struct ClipJob
+      {
+         DecalInstance *decal;
+
+         /// Decal space to world space.
+         MatrixF projMat;
+
+         /// The scene geometry facing the decal in world space.
+         ClippedPolyList geometry;
+
+         /// Clips the geometry to the decal box.
+         ClippedPolyList clipper;
+
+         /// The results of _clipJob().
+         Vector<DecalVertex> verts;
+         Vector<U16> indices;
+         Vector<Point3F> edgeVerts;
+         bool wantEdgeVerts;
+         bool succeeded;
+      };
+
+      struct ClipWorkItem;
+      friend struct ClipWorkItem;
+
+      /// The jobs we keep around between decal updates
       /// to avoid excessive memory allocations.
-      ClippedPolyList mClipper;
+      Vector<ClipJob*> mClipJobs;
 
       Vector<DecalInstance*> mDecalQueue;
 
+      /// Decals in mDecalQueue which need to be clipped this frame.
+      Vector<DecalInstance*> mClipQueue;
+
       StringTableEntry mDataFileName;
       Resource<DecalDataFile> mData;
       
@@ -139,6 +169,11 @@ class DecalManager : public SceneObject
       static const U32 smMaxVerts;
       static const U32 smMaxIndices;
 
+      /// Minimum number of decals clipped together before the
+      /// clipping is spread across the thread pool.  Zero or
+      /// less keeps the clipping on the main thread.
+      static S32 smParallelClipThreshold;
+
       // Assume that a class is already given for the object:
       //    Point with coordinates {float x, y;}
       //===================================================================
@@ -161,6 +196,20 @@ class DecalManager : public SceneObject
       
       void _generateWindingOrder( const Point3F &cornerPoint, Vector<Point3F> *sortPoints );
 
+      /// Gathers the scene geometry for clipping the decal into the job.
+      void _beginClip( ClipJob *job, DecalInstance *decal, const Point2F *clipDepth, bool wantEdgeVerts );
+
+      /// Clips the job's geometry and builds the decal vertices.  This
+      /// only reads the decal so it can run on any thread.
+      void _clipJob( ClipJob *job );
+
+      /// Replaces the geometry of the job's decal with the clipped result.
+      bool _endClip( ClipJob *job );
+
+      /// Clips several decals at once, spreading the work across
+      /// the thread pool when there are enough of them.
+      void _clipDecals( DecalInstance * const *decals, U32 count, bool *outSucceeded );
+
       // Helpers for creating and deleting the vert and index arrays
       // held by DecalInstance.
       void _allocBuffers( DecalInstance *inst );
@@ -262,6 +311,18 @@ class DecalManager : public SceneObject
 
       bool clipDecal( DecalInstance *decal, Vector<Point3F> *edgeVerts = NULL, const Point2F *clipDepth = NULL );
 
+      /// Clips all the decals in the list, using the thread pool if there are
+      /// enough of them.  Decals which fail to clip are left without geometry.
+      /// Returns the number of decals which were clipped successfully.
+      U32 clipDecals( const Vector<DecalInstance*> &decals );
+
+      /// Replaces the decal's geometry with uninitialized vertex and index
+      /// arrays of the given sizes.  Used to restore geometry clipped earlier.
+      void allocDecalGeometry( DecalInstance *decal, U32 vertCount, U32 indexCount );
+
+      /// Frees the decal's vertex and index arrays.
+      void freeDecalGeometry( DecalInstance *decal ) { _freeBuffers( decal ); }
+
       void notifyDecalModified( DecalInstance *inst );
       
       Signal< void() >& getClearDataSignal() { return mClearDataSignal; }
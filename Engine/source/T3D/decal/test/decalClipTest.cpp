@@ -0,0 +1,223 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2014 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "T3D/decal/decalManager.h"
+#include "T3D/decal/decalData.h"
+#include "T3D/decal/decalInstance.h"
+#include "scene/sceneManager.h"
+#include "scene/sceneObject.h"
+#include "collision/abstractPolyList.h"
+#include "math/mRandom.h"
+#include "console/console.h"
+
+/// A flat, finely tessellated floor for the decals to clip against.
+class DecalClipTestFloor : public SceneObject
+{
+   typedef SceneObject Parent;
+
+public:
+
+   DecalClipTestFloor()
+   {
+      mNetFlags.set( IsGhost );
+      mTypeMask |= StaticShapeObjectType;
+      mObjBox.set( Point3F( -500, -500, -1 ), Point3F( 500, 500, 1 ) );
+   }
+
+   bool onAdd()
+   {
+      if ( !Parent::onAdd() )
+         return false;
+
+      resetWorldBox();
+      return true;
+   }
+
+   bool buildPolyList( PolyListContext context, AbstractPolyList *polyList, const Box3F &box, const SphereF &sphere )
+   {
+      const F32 cellSize = 0.5f;
+      const S32 minX = mFloor( box.minExtents.x / cellSize );
+      const S32 minY = mFloor( box.minExtents.y / cellSize );
+      const S32 maxX = mCeil( box.maxExtents.x / cellSize );
+      const S32 maxY = mCeil( box.maxExtents.y / cellSize );
+
+      polyList->setObject( this );
+      polyList->setTransform( &MatrixF::Identity, Point3F::One );
+
+      const PlaneF up( Point3F::Zero, Point3F( 0, 0, 1 ) );
+      for ( S32 y = minY; y < maxY; y++ )
+      {
+         for ( S32 x = minX; x < maxX; x++ )
+         {
+            const U32 base = polyList->addPoint( Point3F( x * cellSize, y * cellSize, 0 ) );
+            polyList->addPoint( Point3F( ( x + 1 ) * cellSize, y * cellSize, 0 ) );
+            polyList->addPoint( Point3F( ( x + 1 ) * cellSize, ( y + 1 ) * cellSize, 0 ) );
+            polyList->addPoint( Point3F( x * cellSize, ( y + 1 ) * cellSize, 0 ) );
+
+            polyList->begin( 0, 0 );
+            for ( U32 i = 0; i < 4; i++ )
+               polyList->vertex( base + i );
+            polyList->plane( up );
+            polyList->end();
+         }
+      }
+
+      return true;
+   }
+};
+
+FIXTURE(DecalClip)
+{
+public:
+   DecalClipTestFloor *floor;
+   DecalData *data;
+   Vector<DecalInstance*> decals;
+
+   void SetUp()
+   {
+      floor = NULL;
+      data = NULL;
+
+      if ( !gDecalManager || !gClientSceneGraph )
+         return;
+
+      floor = new DecalClipTestFloor();
+      floor->registerObject();
+      gClientSceneGraph->addObjectToScene( floor );
+
+      data = new DecalData();
+      data->size = 2.0f;
+      data->registerObject();
+   }
+
+   void TearDown()
+   {
+      for ( U32 i = 0; i < decals.size(); i++ )
+      {
+         gDecalManager->freeDecalGeometry( decals[i] );
+         delete decals[i];
+      }
+      decals.clear();
+
+      if ( data )
+         data->deleteObject();
+      if ( floor )
+      {
+         gClientSceneGraph->removeObjectFromScene( floor );
+         floor->deleteObject();
+      }
+   }
+
+   /// Scatters decals with random rotations over the floor.
+   void createDecals( U32 count, U32 seed )
+   {
+      MRandomLCG rand( seed );
+      for ( U32 i = 0; i < count; i++ )
+      {
+         DecalInstance *decal = new DecalInstance();
+         decal->mDataBlock = data;
+         decal->mPosition.set( rand.randF( -400, 400 ), rand.randF( -400, 400 ), 0.1f );
+         decal->mNormal.set( 0, 0, 1 );
+         const F32 angle = rand.randF( 0, M_2PI_F );
+         decal->mTangent.set( mCos( angle ), mSin( angle ), 0 );
+         decal->mSize = data->size * rand.randF( 0.5f, 2.0f );
+         decals.push_back( decal );
+      }
+   }
+};
+
+TEST_FIX(DecalClip, ParallelMatchesSerial)
+{
+   if ( !floor )
+   {
+      Con::printf( "DecalClip: no decal manager or scene, skipping." );
+      return;
+   }
+
+   const U32 count = 200;
+   createDecals( count, 1234 );
+
+   // Clip one at a time like the editor does.
+   Vector< Vector<DecalVertex> > serialVerts;
+   Vector< Vector<U16> > serialIndices;
+   serialVerts.setSize( count );
+   serialIndices.setSize( count );
+   for ( U32 i = 0; i < count; i++ )
+   {
+      ASSERT_TRUE( gDecalManager->clipDecal( decals[i] ) );
+      serialVerts[i].set( decals[i]->mVerts, decals[i]->mVertCount );
+      serialIndices[i].set( decals[i]->mIndices, decals[i]->mIndxCount );
+   }
+
+   EXPECT_EQ( gDecalManager->clipDecals( decals ), count );
+
+   for ( U32 i = 0; i < count; i++ )
+   {
+      const DecalInstance *decal = decals[i];
+      ASSERT_EQ( decal->mVertCount, serialVerts[i].size() );
+      ASSERT_EQ( decal->mIndxCount, serialIndices[i].size() );
+
+      for ( U32 v = 0; v < decal->mVertCount; v++ )
+      {
+         EXPECT_TRUE( decal->mVerts[v].point.equal( serialVerts[i][v].point ) );
+         EXPECT_TRUE( decal->mVerts[v].texCoord.equal( serialVerts[i][v].texCoord ) );
+      }
+      for ( U32 j = 0; j < decal->mIndxCount; j++ )
+         EXPECT_EQ( decal->mIndices[j], serialIndices[i][j] );
+   }
+}
+
+TEST_FIX(DecalClip, StressTestClip)
+{
+   // 10k decals clipped serially and then on the thread pool.
+   if ( !floor )
+   {
+      Con::printf( "DecalClip: no decal manager or scene, skipping." );
+      return;
+   }
+
+   const U32 count = 10000;
+   createDecals( count, 42 );
+
+   const S32 oldThreshold = Con::getIntVariable( "$Decals::parallelClipThreshold" );
+   const char *names[2] = { "serial", "parallel" };
+
+   for ( U32 mode = 0; mode < 2; mode++ )
+   {
+      Con::setIntVariable( "$Decals::parallelClipThreshold", mode ? oldThreshold : 0 );
+
+      const U32 start = Platform::getRealMilliseconds();
+      const U32 clipped = gDecalManager->clipDecals( decals );
+      const U32 ms = Platform::getRealMilliseconds() - start;
+
+      Con::printf( "DecalClip %s: %d decals clipped in %d ms (%.1f us per decal)",
+         names[mode], clipped, ms, F32( ms ) * 1000.0f / count );
+
+      EXPECT_EQ( clipped, count );
+   }
+
+   Con::setIntVariable( "$Decals::parallelClipThreshold", oldThreshold );
+}
+
+#endif
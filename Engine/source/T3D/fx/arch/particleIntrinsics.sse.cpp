@@ -0,0 +1,272 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "T3D/fx/particleStore.h"
+
+#if (defined( TORQUE_CPU_X86 ) || defined( TORQUE_CPU_X64 ))
+#include "T3D/fx/particleIntrinsics.h"
+#include "T3D/fx/arch/particleIntrinsics.arch.h"
+#include <xmmintrin.h>
+
+void particle_integrate_SSE( const ParticleStreams &s, U32 start, U32 count, F32 dt,
+                             const Point3F &wind, const Point3F &offset )
+{
+   const __m128 vDt = _mm_set1_ps( dt );
+   const __m128 vWindX = _mm_set1_ps( wind.x );
+   const __m128 vWindY = _mm_set1_ps( wind.y );
+   const __m128 vWindZ = _mm_set1_ps( wind.z );
+   const __m128 vOffX = _mm_set1_ps( offset.x );
+   const __m128 vOffY = _mm_set1_ps( offset.y );
+   const __m128 vOffZ = _mm_set1_ps( offset.z );
+   const __m128 vGravity = _mm_set1_ps( -9.81f );
+
+   const U32 end = start + ( count & ~3 );
+   for ( U32 i = start; i < end; i += 4 )
+   {
+      const __m128 drag = _mm_loadu_ps( s.drag + i );
+      const __m128 windCoef = _mm_loadu_ps( s.wind + i );
+      const __m128 constrain = _mm_loadu_ps( s.constrain + i );
+
+      __m128 velX = _mm_loadu_ps( s.velX + i );
+      __m128 velY = _mm_loadu_ps( s.velY + i );
+      __m128 velZ = _mm_loadu_ps( s.velZ + i );
+
+      __m128 ax = _mm_sub_ps( _mm_loadu_ps( s.accX + i ), _mm_mul_ps( velX, drag ) );
+      __m128 ay = _mm_sub_ps( _mm_loadu_ps( s.accY + i ), _mm_mul_ps( velY, drag ) );
+      __m128 az = _mm_sub_ps( _mm_loadu_ps( s.accZ + i ), _mm_mul_ps( velZ, drag ) );
+      ax = _mm_add_ps( ax, _mm_mul_ps( vWindX, windCoef ) );
+      ay = _mm_add_ps( ay, _mm_mul_ps( vWindY, windCoef ) );
+      az = _mm_add_ps( az, _mm_mul_ps( vWindZ, windCoef ) );
+      az = _mm_add_ps( az, _mm_mul_ps( vGravity, _mm_loadu_ps( s.gravity + i ) ) );
+
+      velX = _mm_add_ps( velX, _mm_mul_ps( ax, vDt ) );
+      velY = _mm_add_ps( velY, _mm_mul_ps( ay, vDt ) );
+      velZ = _mm_add_ps( velZ, _mm_mul_ps( az, vDt ) );
+      _mm_storeu_ps( s.velX + i, velX );
+      _mm_storeu_ps( s.velY + i, velY );
+      _mm_storeu_ps( s.velZ + i, velZ );
+
+      const __m128 localX = _mm_add_ps( _mm_loadu_ps( s.localX + i ), _mm_mul_ps( velX, vDt ) );
+      const __m128 localY = _mm_add_ps( _mm_loadu_ps( s.localY + i ), _mm_mul_ps( velY, vDt ) );
+      const __m128 localZ = _mm_add_ps( _mm_loadu_ps( s.localZ + i ), _mm_mul_ps( velZ, vDt ) );
+      _mm_storeu_ps( s.localX + i, localX );
+      _mm_storeu_ps( s.localY + i, localY );
+      _mm_storeu_ps( s.localZ + i, localZ );
+
+      _mm_storeu_ps( s.posX + i, _mm_add_ps( localX, _mm_mul_ps( vOffX, constrain ) ) );
+      _mm_storeu_ps( s.posY + i, _mm_add_ps( localY, _mm_mul_ps( vOffY, constrain ) ) );
+      _mm_storeu_ps( s.posZ + i, _mm_add_ps( localZ, _mm_mul_ps( vOffZ, constrain ) ) );
+   }
+
+   particle_integrate_C( s, end, count & 3, dt, wind, offset );
+}
+
+/// Replaces the lanes of the destination selected by the mask.
+static inline void _storeMasked( F32 *dest, __m128 value, __m128 mask )
+{
+   const __m128 old = _mm_loadu_ps( dest );
+   _mm_storeu_ps( dest, _mm_or_ps( _mm_and_ps( mask, value ), _mm_andnot_ps( mask, old ) ) );
+}
+
+void particle_update_keys_SSE( const ParticleStreams &s, U32 start, U32 count,
+                               const ParticleKeys *keys, const LinearColorF &fadeColor, F32 fadeSize )
+{
+   const __m128 vZero = _mm_setzero_ps();
+   const __m128 vOne = _mm_set1_ps( 1.0f );
+   const __m128 vFadeR = _mm_set1_ps( fadeColor.red );
+   const __m128 vFadeG = _mm_set1_ps( fadeColor.green );
+   const __m128 vFadeB = _mm_set1_ps( fadeColor.blue );
+   const __m128 vFadeA = _mm_set1_ps( fadeColor.alpha );
+   const __m128 vFadeSize = _mm_set1_ps( fadeSize );
+
+   // The key search is scalar; the values for the two bracketing
+   // keys are gathered into lanes and blended together.
+   F32 frac[4], valid[4];
+   F32 r0[4], g0[4], b0[4], a0[4], size0[4];
+   F32 r1[4], g1[4], b1[4], a1[4], size1[4];
+
+   const U32 end = start + ( count & ~3 );
+   for ( U32 i = start; i < end; i += 4 )
+   {
+      for ( U32 lane = 0; lane < 4; lane++ )
+      {
+         const U32 p = i + lane;
+         if ( s.age[p] > s.lifetime[p] )
+            s.age[p] = s.lifetime[p];
+
+         const ParticleKeys &k = keys[ s.keySet[p] ];
+         const F32 t = (F32)s.age[p] / (F32)s.lifetime[p];
+
+         U32 key = 1;
+         while ( key < ParticleData::PDC_NUM_KEYS && k.times[key] < t )
+            key++;
+
+         if ( key == ParticleData::PDC_NUM_KEYS )
+         {
+            // Keep the last values; the blend below discards this lane.
+            valid[lane] = 0.0f;
+            key = ParticleData::PDC_NUM_KEYS - 1;
+            frac[lane] = 0.0f;
+         }
+         else
+         {
+            valid[lane] = 1.0f;
+            frac[lane] = ( t - k.times[key-1] ) / ( k.times[key] - k.times[key-1] );
+         }
+
+         const LinearColorF &c0 = k.colors[key-1];
+         const LinearColorF &c1 = k.colors[key];
+         r0[lane] = c0.red;   g0[lane] = c0.green;   b0[lane] = c0.blue;   a0[lane] = c0.alpha;
+         r1[lane] = c1.red;   g1[lane] = c1.green;   b1[lane] = c1.blue;   a1[lane] = c1.alpha;
+         size0[lane] = k.sizes[key-1];
+         size1[lane] = k.sizes[key];
+      }
+
+      const __m128 mask = _mm_cmpneq_ps( _mm_loadu_ps( valid ), vZero );
+      const __m128 f = _mm_loadu_ps( frac );
+      const __m128 invF = _mm_sub_ps( vOne, f );
+
+      // Colors clamp the factor like LinearColorF::interpolate, sizes do not.
+      const __m128 cf = _mm_min_ps( _mm_max_ps( f, vZero ), vOne );
+      const __m128 invCf = _mm_sub_ps( vOne, cf );
+
+      #define BLEND_CHANNEL( dest, c0, c1, fade ) \
+         _storeMasked( dest + i, _mm_mul_ps( _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( c0 ), invCf ), \
+                                                         _mm_mul_ps( _mm_loadu_ps( c1 ), cf ) ), fade ), mask )
+
+      BLEND_CHANNEL( s.red, r0, r1, vFadeR );
+      BLEND_CHANNEL( s.green, g0, g1, vFadeG );
+      BLEND_CHANNEL( s.blue, b0, b1, vFadeB );
+      BLEND_CHANNEL( s.alpha, a0, a1, vFadeA );
+
+      #undef BLEND_CHANNEL
+
+      const __m128 size = _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( size0 ), invF ),
+                                      _mm_mul_ps( _mm_loadu_ps( size1 ), f ) );
+      _storeMasked( s.size + i, _mm_mul_ps( size, vFadeSize ), mask );
+   }
+
+   particle_update_keys_C( s, end, count & 3, keys, fadeColor, fadeSize );
+}
+
+void particle_build_billboards_SSE( const ParticleStreams &s, const U32 *order, U32 count,
+                                    const ParticleKeys *keys, const Point3F &right, const Point3F &up,
+                                    const LinearColorF &colorScale, GFXVertexPCT *outVerts )
+{
+   // Same as ParticleEmitter::AgedSpinToRadians.
+   const F32 agedSpinToRadians = ( 1.0f / 1000.0f ) * ( 1.0f / 360.0f ) * M_PI_F * 2.0f;
+
+   const __m128 vHalf = _mm_set1_ps( 0.5f );
+   const __m128 vZero = _mm_setzero_ps();
+   const __m128 vOne = _mm_set1_ps( 1.0f );
+   const __m128 vRightX = _mm_set1_ps( right.x );
+   const __m128 vRightY = _mm_set1_ps( right.y );
+   const __m128 vRightZ = _mm_set1_ps( right.z );
+   const __m128 vUpX = _mm_set1_ps( up.x );
+   const __m128 vUpY = _mm_set1_ps( up.y );
+   const __m128 vUpZ = _mm_set1_ps( up.z );
+   const __m128 vScaleR = _mm_set1_ps( colorScale.red );
+   const __m128 vScaleG = _mm_set1_ps( colorScale.green );
+   const __m128 vScaleB = _mm_set1_ps( colorScale.blue );
+   const __m128 vScaleA = _mm_set1_ps( colorScale.alpha );
+
+   F32 sinA[4], cosA[4];
+
+   // Corner outputs, indexed [corner][lane].
+   F32 cornerX[4][4], cornerY[4][4], cornerZ[4][4];
+   F32 red[4], green[4], blue[4], alpha[4];
+
+   GFXVertexPCT *verts = outVerts;
+   const U32 end = count & ~3;
+   for ( U32 n = 0; n < end; n += 4, verts += 16 )
+   {
+      const U32 i0 = order[n], i1 = order[n+1], i2 = order[n+2], i3 = order[n+3];
+
+      for ( U32 lane = 0; lane < 4; lane++ )
+      {
+         const U32 i = order[n + lane];
+         mSinCos( s.spinSpeed[i] * s.age[i] * agedSpinToRadians, sinA[lane], cosA[lane] );
+      }
+
+      const __m128 sy = _mm_loadu_ps( sinA );
+      const __m128 cy = _mm_loadu_ps( cosA );
+      const __m128 width = _mm_mul_ps( _mm_set_ps( s.size[i3], s.size[i2], s.size[i1], s.size[i0] ), vHalf );
+
+      // The spun right and up axes of each quad.
+      const __m128 rx = _mm_mul_ps( _mm_add_ps( _mm_mul_ps( vRightX, cy ), _mm_mul_ps( vUpX, sy ) ), width );
+      const __m128 ry = _mm_mul_ps( _mm_add_ps( _mm_mul_ps( vRightY, cy ), _mm_mul_ps( vUpY, sy ) ), width );
+      const __m128 rz = _mm_mul_ps( _mm_add_ps( _mm_mul_ps( vRightZ, cy ), _mm_mul_ps( vUpZ, sy ) ), width );
+      const __m128 ux = _mm_mul_ps( _mm_sub_ps( _mm_mul_ps( vUpX, cy ), _mm_mul_ps( vRightX, sy ) ), width );
+      const __m128 uy = _mm_mul_ps( _mm_sub_ps( _mm_mul_ps( vUpY, cy ), _mm_mul_ps( vRightY, sy ) ), width );
+      const __m128 uz = _mm_mul_ps( _mm_sub_ps( _mm_mul_ps( vUpZ, cy ), _mm_mul_ps( vRightZ, sy ) ), width );
+
+      const __m128 px = _mm_set_ps( s.posX[i3], s.posX[i2], s.posX[i1], s.posX[i0] );
+      const __m128 py = _mm_set_ps( s.posY[i3], s.posY[i2], s.posY[i1], s.posY[i0] );
+      const __m128 pz = _mm_set_ps( s.posZ[i3], s.posZ[i2], s.posZ[i1], s.posZ[i0] );
+
+      const __m128 minusRx = _mm_sub_ps( px, rx ), plusRx = _mm_add_ps( px, rx );
+      const __m128 minusRy = _mm_sub_ps( py, ry ), plusRy = _mm_add_ps( py, ry );
+      const __m128 minusRz = _mm_sub_ps( pz, rz ), plusRz = _mm_add_ps( pz, rz );
+
+      _mm_storeu_ps( cornerX[0], _mm_add_ps( minusRx, ux ) );
+      _mm_storeu_ps( cornerY[0], _mm_add_ps( minusRy, uy ) );
+      _mm_storeu_ps( cornerZ[0], _mm_add_ps( minusRz, uz ) );
+      _mm_storeu_ps( cornerX[1], _mm_sub_ps( minusRx, ux ) );
+      _mm_storeu_ps( cornerY[1], _mm_sub_ps( minusRy, uy ) );
+      _mm_storeu_ps( cornerZ[1], _mm_sub_ps( minusRz, uz ) );
+      _mm_storeu_ps( cornerX[2], _mm_sub_ps( plusRx, ux ) );
+      _mm_storeu_ps( cornerY[2], _mm_sub_ps( plusRy, uy ) );
+      _mm_storeu_ps( cornerZ[2], _mm_sub_ps( plusRz, uz ) );
+      _mm_storeu_ps( cornerX[3], _mm_add_ps( plusRx, ux ) );
+      _mm_storeu_ps( cornerY[3], _mm_add_ps( plusRy, uy ) );
+      _mm_storeu_ps( cornerZ[3], _mm_add_ps( plusRz, uz ) );
+
+      #define SCALE_CHANNEL( dest, src, scale ) \
+         _mm_storeu_ps( dest, _mm_min_ps( _mm_max_ps( _mm_mul_ps( \
+            _mm_set_ps( src[i3], src[i2], src[i1], src[i0] ), scale ), vZero ), vOne ) )
+
+      SCALE_CHANNEL( red, s.red, vScaleR );
+      SCALE_CHANNEL( green, s.green, vScaleG );
+      SCALE_CHANNEL( blue, s.blue, vScaleB );
+      SCALE_CHANNEL( alpha, s.alpha, vScaleA );
+
+      #undef SCALE_CHANNEL
+
+      for ( U32 lane = 0; lane < 4; lane++ )
+      {
+         GFXVertexPCT *quad = verts + lane * 4;
+         const GFXVertexColor vertColor( LinearColorF( red[lane], green[lane], blue[lane], alpha[lane] ) );
+         const Point2F *texCoords = keys[ s.keySet[ order[n + lane] ] ].texCoords;
+
+         for ( U32 v = 0; v < 4; v++ )
+         {
+            quad[v].point.set( cornerX[v][lane], cornerY[v][lane], cornerZ[v][lane] );
+            quad[v].color = vertColor;
+            quad[v].texCoord = texCoords[v];
+         }
+      }
+   }
+
+   particle_build_billboards_C( s, order + end, count & 3, keys, right, up, colorScale, verts );
+}
+
+#endif
@@ -50,6 +50,7 @@
 #include "renderInstance/renderDeferredMgr.h"
 #include "console/engineAPI.h"
 #include "T3D/assets/MaterialAsset.h"
+#include "platform/threads/threadPoolBatch.h"
 
 /// This is used for rendering ground cover billboards.
 GFXImplementVertexFormat( GCVertex )
@@ -419,12 +420,54 @@ void GroundCoverCell::renderBillboards( SceneRenderState *state, BaseMatInstance
 }
 
 
+/// Fills the placements of one GroundCover cell on the thread pool.
+class GroundCoverCellWorkItem : public ThreadPoolBatch::Item
+{
+public:
+
+   typedef ThreadPoolBatch::Item Parent;
+
+   GroundCoverCellWorkItem(   const GroundCover *cover,
+                              GroundCoverCell *cell,
+                              const Vector<TerrainBlock*> *terrains,
+                              U32 placementCount,
+                              S32 randSeed )
+      :  mCover( cover ),
+         mCell( cell ),
+         mTerrains( terrains ),
+         mPlacementCount( placementCount ),
+         mRandSeed( randSeed ) {}
+
+protected:
+
+   const GroundCover *mCover;
+   GroundCoverCell *mCell;
+
+   /// The terrains to place on which are owned by the
+   /// grid update waiting on this item.
+   const Vector<TerrainBlock*> *mTerrains;
+
+   U32 mPlacementCount;
+   S32 mRandSeed;
+
+   // ThreadPoolBatch::Item
+   virtual void executeItem()
+   {
+      mCover->_fillCell( mCell, *mTerrains, mPlacementCount, mRandSeed );
+   }
+};
+
+
 U32 GroundCover::smStatRenderedCells = 0;
 U32 GroundCover::smStatRenderedBillboards = 0;
 U32 GroundCover::smStatRenderedBatches = 0;
 U32 GroundCover::smStatRenderedShapes = 0;
+U32 GroundCover::smStatGeneratedCells = 0;
 F32 GroundCover::smDensityScale = 1.0f;
 F32 GroundCover::smFadeScale = 1.0f;
+S32 GroundCover::smMaxCellsPerUpdate = 4;
+bool GroundCover::smParallelGeneration = true;
+bool GroundCover::smPrefetchCells = true;
 
 ConsoleDocClass( GroundCover,
    "@brief Covers the ground in a field of objects (IE: Grass, Flowers, etc)."
@@ -448,6 +491,7 @@ GroundCover::GroundCover()
    // By initializing this to a big value we
    // ensure we warp on first render.
    mGridIndex.set( S32_MAX, S32_MAX );
+   mLastCullerPos.zero();
 
    mMaxPlacement = 1000;
    mLastPlacementCount = 0;
@@ -644,6 +688,17 @@ void GroundCover::consoleInit()
 	   "@ingroup Foliage\n");
    Con::addVariable( "$GroundCover::renderedShapes", TypeS32, &smStatRenderedShapes, "Stat for number of rendered shapes.\n"
 	   "@ingroup Foliage\n");
+   Con::addVariable( "$GroundCover::generatedCells", TypeS32, &smStatGeneratedCells, "Stat for number of generated cells.\n"
+	   "@ingroup Foliage\n");
+
+   Con::addVariable( "$GroundCover::maxCellsPerUpdate", TypeS32, &smMaxCellsPerUpdate, "The maximum number of cells generated in one grid update.  The "
+      "whole visible grid is still generated after a camera warp.  Zero removes the limit.\n"
+	   "@ingroup Foliage\n");
+   Con::addVariable( "$GroundCover::parallelGeneration", TypeBool, &smParallelGeneration, "If true new cells are generated on the global thread pool.\n"
+	   "@ingroup Foliage\n");
+   Con::addVariable( "$GroundCover::prefetchCells", TypeBool, &smPrefetchCells, "If true unused cell generation budget is spent on the cells "
+      "ahead of the camera's direction of motion.\n"
+	   "@ingroup Foliage\n");
 
    Parent::consoleInit();
 }
@@ -931,6 +986,10 @@ void GroundCover::_freeCells()
       mAllocCellList.setSize( maxCells );
    }
 
+   // Any prefetched cells are in the allocation list.
+   mPrefetchCells.clear();
+   mPrefetchIndices.clear();
+
    // Move all the alloced cells into the free list.
    mFreeCellList.clear();
    mFreeCellList.merge( mAllocCellList );
@@ -1048,17 +1107,8 @@ void GroundCover::_initialize( U32 cellCount, U32 cellPlacementCount )
    }
 }
 
-GroundCoverCell* GroundCover::_generateCell( const Point2I& index, 
-                                             const Box3F& bounds, 
-                                             U32 placementCount,
-                                             S32 randSeed )
+GroundCoverCell* GroundCover::_allocCell()
 {
-   PROFILE_SCOPE(GroundCover_GenerateCell);
-
-   const Vector<SceneObject*> terrainBlocks = getContainer()->getTerrains();
-   if ( terrainBlocks.empty() )
-      return NULL;
-
    // Grab a free cell or allocate a new one.
    GroundCoverCell* cell;
    if ( mFreeCellList.empty() )
@@ -1073,8 +1123,29 @@ GroundCoverCell* GroundCover::_generateCell( const Point2I& index,
    }
 
    cell->mDirty = true;
-   cell->mIndex = index;
-   cell->mBounds = bounds;
+   return cell;
+}
+
+Box3F GroundCover::_getCellBounds( const Point2I& worldIndex, F32 cellSize ) const
+{
+   // Get the terrain elevation range for setting the default cell bounds.
+   const F32   terrainMinHeight = -5000.0f, 
+               terrainMaxHeight = 5000.0f;
+
+   Box3F bounds;
+   bounds.minExtents.set( worldIndex.x * cellSize, worldIndex.y * cellSize, terrainMinHeight );
+   bounds.maxExtents.set( bounds.minExtents.x + cellSize, bounds.minExtents.y + cellSize, terrainMaxHeight );
+   return bounds;
+}
+
+void GroundCover::_fillCell(  GroundCoverCell* cell,
+                              const Vector<TerrainBlock*>& terrainBlocks,
+                              U32 placementCount,
+                              S32 randSeed ) const
+{
+   PROFILE_SCOPE(GroundCover_GenerateCell);
+
+   const Box3F bounds = cell->mBounds;
 
    Point3F pos( 0, 0, 0 );
 
@@ -1215,15 +1286,12 @@ GroundCoverCell* GroundCover::_generateCell( const Point2I& index,
 
          // Which terrain do I place on?
          if ( terrainBlocks.size() == 1 )
-            terrainBlock = dynamic_cast< TerrainBlock* >( terrainBlocks.first() );
+            terrainBlock = terrainBlocks.first();
          else
          {
             for ( U32 blockIDx = 0; blockIDx < terrainBlocks.size(); blockIDx++ )
             {
-               TerrainBlock *terrain = dynamic_cast< TerrainBlock* >( terrainBlocks[ blockIDx ] );
-               if( !terrain )
-                  continue;
-
+               TerrainBlock *terrain = terrainBlocks[ blockIDx ];
                const Box3F &terrBounds = terrain->getWorldBox();
 
                if (  cp.x < terrBounds.minExtents.x || cp.x > terrBounds.maxExtents.x ||
@@ -1369,8 +1437,108 @@ GroundCoverCell* GroundCover::_generateCell( const Point2I& index,
    cell->mRenderBounds = renderBounds;
    cell->mBounds.minExtents.z = renderBounds.minExtents.z;
    cell->mBounds.maxExtents.z = renderBounds.maxExtents.z;
+}
 
-   return cell;
+void GroundCover::_fillCells(  const Vector<GroundCoverCell*>& cells,
+                              const Vector<S32>& seeds,
+                              const Vector<TerrainBlock*>& terrains,
+                              U32 placementCount )
+{
+   PROFILE_SCOPE( GroundCover_FillCells );
+
+   if ( !smParallelGeneration || cells.size() < 2 )
+   {
+      for ( S32 i = 0; i < cells.size(); i++ )
+         _fillCell( cells[i], terrains, placementCount, seeds[i] );
+      return;
+   }
+
+   // Each cell holds hundreds of placements which is plenty
+   // of work for one item.  The main thread will run items 
+   // itself while waiting on the batch.
+   Vector< ThreadSafeRef< GroundCoverCellWorkItem > > items;
+   items.reserve( cells.size() );
+
+   ThreadPoolBatch batch;
+   for ( S32 i = 0; i < cells.size(); i++ )
+   {
+      items.push_back( new GroundCoverCellWorkItem( this, cells[i], &terrains, placementCount, seeds[i] ) );
+      batch.add( items.last() );
+   }
+
+   batch.wait();
+}
+
+GroundCoverCell* GroundCover::_takePrefetchedCell( const Point2I& worldIndex )
+{
+   for ( S32 i = 0; i < mPrefetchIndices.size(); i++ )
+   {
+      if ( mPrefetchIndices[i] != worldIndex )
+         continue;
+
+      GroundCoverCell *cell = mPrefetchCells[i];
+      mPrefetchCells.erase_fast( i );
+      mPrefetchIndices.erase_fast( i );
+      return cell;
+   }
+
+   return NULL;
+}
+
+U32 GroundCover::_prefetchCells( const Point2I& index,
+                                 F32 cellSize,
+                                 U32 budget,
+                                 Vector<GroundCoverCell*>& outCells,
+                                 Vector<S32>& outSeeds )
+{
+   const Point3F &pos = mCuller.getPosition();
+
+   // We can only guess where we're going if we're moving.
+   Point2F dir( pos.x - mLastCullerPos.x, pos.y - mLastCullerPos.y );
+   const F32 maxAxis = getMax( mFabs( dir.x ), mFabs( dir.y ) );
+   if ( maxAxis < POINT_EPSILON )
+      return 0;
+
+   // Scale the direction so that the major axis moves exactly 
+   // one cell which gives us the grid we'll shift into next.
+   dir /= maxAxis;
+   const Point2I nextIndex(   (S32)mFloor( ( pos.x + dir.x * cellSize - mRadius ) / cellSize ),
+                              (S32)mFloor( ( pos.y + dir.y * cellSize - mRadius ) / cellSize ) );
+
+   // Generate the cells of the next grid which aren't part
+   // of the current one and which we haven't already done.
+   U32 generated = 0;
+   for ( S32 y = 0; y < mGridSize && generated < budget; y++ )
+   {
+      for ( S32 x = 0; x < mGridSize && generated < budget; x++ )
+      {
+         const Point2I worldIndex = nextIndex + Point2I( x, y );
+         const Point2I gridIndex = worldIndex - index;
+         if (  gridIndex.x >= 0 && gridIndex.x < (S32)mGridSize &&
+               gridIndex.y >= 0 && gridIndex.y < (S32)mGridSize )
+            continue;
+
+         if ( mPrefetchIndices.contains( worldIndex ) )
+            continue;
+
+         const Box3F bounds = _getCellBounds( worldIndex, cellSize );
+         if ( mCuller.isCulled( bounds ) )
+            continue;
+
+         GroundCoverCell *cell = _allocCell();
+         cell->mIndex = gridIndex;
+         cell->mBounds = bounds;
+
+         mPrefetchCells.push_back( cell );
+         mPrefetchIndices.push_back( worldIndex );
+
+         outCells.push_back( cell );
+         outSeeds.push_back( _getCellSeed( worldIndex ) );
+         ++generated;
+      }
+   }
+
+   return generated;
 }
 
 void GroundCover::onTerrainUpdated( U32 flags, TerrainBlock *tblock, const Point2I& min, const Point2I& max )
@@ -1417,6 +1585,24 @@ void GroundCover::onTerrainUpdated( U32 flags, TerrainBlock *tblock, const Point
             _recycleCell( cell );
          }
       }
+
+      // And any prefetched cells.
+      for ( S32 i = 0; i < mPrefetchCells.size(); )
+      {
+         GroundCoverCell* cell = mPrefetchCells[ i ];
+
+         const Box3F& bounds = cell->getBounds();
+         dirty.minExtents.z = bounds.minExtents.z;
+         dirty.maxExtents.z = bounds.maxExtents.z;
+         if ( bounds.isOverlapped( dirty ) )
+         {
+            _recycleCell( cell );
+            mPrefetchCells.erase_fast( i );
+            mPrefetchIndices.erase_fast( i );
+         }
+         else
+            i++;
+      }
    }
 }
 
@@ -1486,74 +1672,93 @@ void GroundCover::_updateCoverGrid( const Frustum &culler )
       mScratchGrid[ ( newIndex.y * mGridSize ) + newIndex.x ] = cell;
    }
 
-   // Get the terrain elevation range for setting the default cell bounds.
-   F32   terrainMinHeight = -5000.0f, 
-         terrainMaxHeight = 5000.0f;
+   // Recycle the prefetched cells we've moved away from.
+   for ( S32 i = 0; i < mPrefetchCells.size(); )
+   {
+      const Point2I gridIndex = mPrefetchIndices[ i ] - index;
+      if (  gridIndex.x < -1 || gridIndex.x > (S32)mGridSize ||
+            gridIndex.y < -1 || gridIndex.y > (S32)mGridSize )
+      {
+         _recycleCell( mPrefetchCells[ i ] );
+         mPrefetchCells.erase_fast( i );
+         mPrefetchIndices.erase_fast( i );
+      }
+      else
+         i++;
+   }
+
+   // Gather the terrains we place on once for all the new cells.
+   const Vector<SceneObject*> &sceneTerrains = getContainer()->getTerrains();
+   Vector<TerrainBlock*> terrains;
+   terrains.reserve( sceneTerrains.size() );
+   for ( U32 i = 0; i < sceneTerrains.size(); i++ )
+   {
+      TerrainBlock *terrain = dynamic_cast< TerrainBlock* >( sceneTerrains[ i ] );
+      if ( terrain )
+         terrains.push_back( terrain );
+   }
 
    // Go thru the scratch grid copying each cell back to the
-   // cell grid and creating new cells as needed.
+   // cell grid and allocating new cells as needed.
    //
-   // By limiting ourselves to only one new cell generation per
-   // update we're lowering the performance hiccup during movement
-   // without getting into the complexity of threading.  The delay
-   // in generation is rarely noticeable in normal play.
+   // The placements of the new cells are generated together
+   // afterwards on the thread pool.  We still limit the number
+   // of new cells per update so that fast movement doesn't spike
+   // the frame time.  The delay in generation is rarely noticeable
+   // in normal play and most cells entering the grid were already 
+   // prefetched.
    //
    // The only caveat is that we need to generate the entire visible
    // grid when we warp.
-   U32 cellsGenerated = 0;
+   const U32 budget = didWarp || smMaxCellsPerUpdate <= 0 ? U32_MAX : (U32)smMaxCellsPerUpdate;
+   Vector<GroundCoverCell*> newCells;
+   Vector<S32> newSeeds;
    for ( S32 i = 0; i < mScratchGrid.size(); i++ )
    {
       GroundCoverCell* cell = mScratchGrid[ i ];
-      if ( !cell && ( cellsGenerated == 0 || didWarp ) )
+      if ( !cell )
       {
          // Get the index point of this new cell.
          S32 y = i / mGridSize;
          S32 x = i - ( y * mGridSize );
          Point2I newIndex = index + Point2I( x, y );
 
-         // What will be the world placement bounds for this cell.
-         Box3F bounds;
-         bounds.minExtents.set( newIndex.x * cellSize, newIndex.y * cellSize, terrainMinHeight );
-         bounds.maxExtents.set( bounds.minExtents.x + cellSize, bounds.minExtents.y + cellSize, terrainMaxHeight );
-
-         if ( mCuller.isCulled( bounds ) )
+         cell = _takePrefetchedCell( newIndex );
+         if ( cell )
+            cell->mIndex.set( x, y );
+         else if ( !terrains.empty() && newCells.size() < budget )
          {
-            mCellGrid[ i ] = NULL;
-            continue;
-         }
+            // What will be the world placement bounds for this cell.
+            const Box3F bounds = _getCellBounds( newIndex, cellSize );
 
-         // We need to allocate a new cell.
-         //
-         // TODO: This is the expensive call and where we should optimize. In
-         // particular the next best optimization would be to take advantage of
-         // multiple cores so that we can generate all the cells in one update.
-         //
-         // Instead of generating the cell here we would allocate a cell and stick
-         // it into a thread safe queue (maybe lockless) as well as the mCellGrid.
-         // Once all were allocated we would do something like this...
-         //
-         // TorqueParallelProcess( cellsToGenerateQueue, _generateCell );
-         //
-         // Internally this function would pass the queue to some global pre-allocated
-         // worker threads which are locked to a particular core.  While the main 
-         // thread waits for the worker threads to finish it will process cells itself.
-         // 
+            if ( mCuller.isCulled( bounds ) )
+            {
+               mCellGrid[ i ] = NULL;
+               continue;
+            }
 
-         cell = _generateCell(   newIndex - index, 
-                                 bounds, 
-                                 placementCount, 
-                                 mRandomSeed + mAbs( newIndex.x ) + mAbs( newIndex.y ) );
+            cell = _allocCell();
+            cell->mIndex.set( x, y );
+            cell->mBounds = bounds;
 
-         // Increment our generation count.
-         if ( cell )
-            ++cellsGenerated;
+            newCells.push_back( cell );
+            newSeeds.push_back( _getCellSeed( newIndex ) );
+         }
       }
 
       mCellGrid[ i ] = cell;
    }
 
+   // Spend what is left of the budget on the cells ahead of us.
+   if ( smPrefetchCells && !didWarp && !terrains.empty() && newCells.size() < budget )
+      _prefetchCells( index, cellSize, budget - newCells.size(), newCells, newSeeds );
+
+   _fillCells( newCells, newSeeds, terrains, placementCount );
+   smStatGeneratedCells += newCells.size();
+
    // Store the new grid index.
    mGridIndex = index;
+   mLastCullerPos = culler.getPosition();
 }
 
 void GroundCover::prepRenderImage( SceneRenderState *state )
@@ -1568,6 +1773,7 @@ void GroundCover::prepRenderImage( SceneRenderState *state )
       smStatRenderedBillboards = 0;
       smStatRenderedBatches = 0;
       smStatRenderedShapes = 0;
+      smStatGeneratedCells = 0;
    }
 
    // TODO: Make sure that the ground cover stops rendering
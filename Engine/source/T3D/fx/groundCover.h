@@ -49,6 +49,7 @@
 
 class TerrainBlock;
 class GroundCoverCell;
+class GroundCoverCellWorkItem;
 class TSShapeInstance;
 class Material;
 class MaterialParameters;
@@ -115,6 +116,7 @@ class GroundCover : public SceneObject
 {
    friend class GroundCoverShaderConstHandles;
    friend class GroundCoverCell;
+   friend class GroundCoverCellWorkItem;
    typedef SceneObject Parent;
 
 public:
@@ -222,6 +224,17 @@ protected:
    /// This is the index to the first grid cell.
    Point2I mGridIndex;
 
+   /// Cells generated ahead of the camera which have not
+   /// yet entered the grid.
+   CellVector mPrefetchCells;
+
+   /// The world grid index of each cell in mPrefetchCells.
+   Vector<Point2I> mPrefetchIndices;
+
+   /// The culling position at the last grid update used to
+   /// find the direction in which to prefetch.
+   Point3F mLastCullerPos;
+
    /// The maximum amount of cover elements to include in
    /// the grid at any one time.  The actual amount may be
    /// less than this based on randomization.
@@ -259,6 +272,10 @@ protected:
    /// Stat for number of rendered shapes.
    static U32 smStatRenderedShapes;
 
+   /// Stat for number of generated cells including
+   /// the prefetched ones.
+   static U32 smStatGeneratedCells;
+
    /// The global ground cover LOD scalar which controls
    /// the percentage of the maximum amount of cover to put
    /// down.  It scales both rendering cost and placement
@@ -266,6 +283,18 @@ protected:
    static F32 smDensityScale;   
    static F32 smFadeScale;
 
+   /// The maximum number of cells generated in one grid
+   /// update unless the camera warped.  Cells that don't
+   /// fit are generated over the following updates.
+   static S32 smMaxCellsPerUpdate;
+
+   /// If true cells are generated on the global thread pool.
+   static bool smParallelGeneration;
+
+   /// If true spare cell generation budget is used to build
+   /// the cells the camera is moving towards.
+   static bool smPrefetchCells;
+
    BaseMatInstance* mMaterialInst;
 
    DECLARE_MATERIALASSET(GroundCover, Material);
@@ -401,11 +430,41 @@ protected:
    /// Returns a cell to the free list.
    void _recycleCell( GroundCoverCell* cell );
 
-   /// Generates a new cell using the recycle list when possible.
-   GroundCoverCell* _generateCell(  const Point2I& index,
-                                    const Box3F& bounds, 
-                                    U32 placementCount,
-                                    S32 randSeed );
+   /// Returns a cell from the free list or allocates a new one.
+   GroundCoverCell* _allocCell();
+
+   /// Returns the world space placement bounds for the cell
+   /// at the world grid index.
+   Box3F _getCellBounds( const Point2I& worldIndex, F32 cellSize ) const;
+
+   /// Returns the placement seed for the cell at the world grid index.
+   S32 _getCellSeed( const Point2I& worldIndex ) const { return mRandomSeed + mAbs( worldIndex.x ) + mAbs( worldIndex.y ); }
+
+   /// Removes the prefetched cell at the world grid index
+   /// and returns it or NULL if it wasn't prefetched.
+   GroundCoverCell* _takePrefetchedCell( const Point2I& worldIndex );
+
+   /// Prefetches the cells the camera is moving towards.
+   /// @return The number of cells generated.
+   U32 _prefetchCells(  const Point2I& index,
+                        F32 cellSize,
+                        U32 budget,
+                        Vector<GroundCoverCell*>& outCells,
+                        Vector<S32>& outSeeds );
+
+   /// Generates the placements for the cells, in parallel when enabled.
+   void _fillCells(  const Vector<GroundCoverCell*>& cells,
+                     const Vector<S32>& seeds,
+                     const Vector<TerrainBlock*>& terrains,
+                     U32 placementCount );
+
+   /// Fills a cell with its cover placements.  This only reads
+   /// GroundCover and terrain state so it can be called from a
+   /// worker thread while the main thread is blocked on it.
+   void _fillCell(   GroundCoverCell* cell,
+                     const Vector<TerrainBlock*>& terrains,
+                     U32 placementCount,
+                     S32 randSeed ) const;
 
    void _debugRender( ObjectRenderInst *ri, SceneRenderState *state, BaseMatInstance *overrideMat );
 };
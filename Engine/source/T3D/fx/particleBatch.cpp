@@ -0,0 +1,530 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "T3D/fx/particleBatch.h"
+
+#include "T3D/fx/particleEmitter.h"
+#include "T3D/gameBase/gameProcess.h"
+#include "scene/sceneManager.h"
+#include "scene/sceneRenderState.h"
+#include "renderInstance/renderPassManager.h"
+#include "platform/threads/threadPoolBatch.h"
+#include "console/consoleTypes.h"
+#include "console/engineAPI.h"
+#include "core/module.h"
+
+
+bool ParticleBatch::smEnabled = true;
+U32 ParticleBatch::smNumDraws = 0;
+U32 ParticleBatch::smNumEmittersDrawn = 0;
+HashMap< ParticleEmitterData*, ParticleBatch* > ParticleBatch::smBatches;
+
+AFTER_MODULE_INIT( Sim )
+{
+   Con::addVariable( "$Particle::batchEmitters", TypeBool, &ParticleBatch::smEnabled,
+      "@brief If true, emitters which share a datablock are updated together and drawn "
+      "with as few draw calls as possible.\n\n"
+      "Only emitters using particle store storage, without a sort priority and with a single "
+      "texture are batched.  Only affects emitters which start emitting after it is changed.\n\n"
+      "@ingroup FX\n" );
+   Con::addVariable( "$Particle::batchDraws", TypeS32, &ParticleBatch::smNumDraws,
+      "@brief The number of draws submitted by particle batches since it was last reset.\n\n"
+      "@ingroup FX\n" );
+   Con::addVariable( "$Particle::batchEmittersDrawn", TypeS32, &ParticleBatch::smNumEmittersDrawn,
+      "@brief The number of emitters drawn by particle batches since $Particle::batchDraws "
+      "was last reset.\n\n"
+      "@ingroup FX\n" );
+}
+
+IMPLEMENT_CONOBJECT( ParticleBatch );
+
+ConsoleDocClass( ParticleBatch,
+   "@brief Updates and draws the emitters which share a ParticleEmitterData.\n\n"
+
+   "Particle batches are created on the client as emitters start emitting and are "
+   "deleted once their last emitter is gone.  They cannot be created from script.\n\n"
+
+   "@see $Particle::batchEmitters\n"
+   "@ingroup FX\n"
+   "@internal"
+);
+
+
+//-----------------------------------------------------------------------------
+// UpdateWorkItem
+//-----------------------------------------------------------------------------
+struct ParticleBatch::UpdateWorkItem : public ThreadPoolBatch::Item
+{
+   ParticleBatch *mBatch;
+   U32 mStart;
+   U32 mEnd;
+
+   UpdateWorkItem( ParticleBatch *batch, U32 start, U32 end )
+      :  mBatch( batch ),
+         mStart( start ),
+         mEnd( end ) {}
+
+protected:
+
+   virtual void executeItem()
+   {
+      mBatch->_updatePending( mStart, mEnd );
+   }
+};
+
+//-----------------------------------------------------------------------------
+// join
+//-----------------------------------------------------------------------------
+ParticleBatch* ParticleBatch::join( ParticleEmitter *emitter )
+{
+   ParticleEmitterData *data = emitter->getDataBlock();
+
+   ParticleBatch *batch = find( data );
+   if ( !batch )
+   {
+      batch = new ParticleBatch();
+      batch->mEmitterData = data;
+      if ( !batch->registerObject() )
+      {
+         delete batch;
+         return NULL;
+      }
+
+      smBatches.insert( data, batch );
+   }
+
+   batch->mEmitters.push_back( emitter );
+   return batch;
+}
+
+//-----------------------------------------------------------------------------
+// find
+//-----------------------------------------------------------------------------
+ParticleBatch* ParticleBatch::find( ParticleEmitterData *data )
+{
+   HashMap< ParticleEmitterData*, ParticleBatch* >::iterator iter = smBatches.find( data );
+   return iter != smBatches.end() ? iter->value : NULL;
+}
+
+//-----------------------------------------------------------------------------
+// leave
+//-----------------------------------------------------------------------------
+void ParticleBatch::leave( ParticleEmitter *emitter )
+{
+   for ( U32 i = 0; i < mEmitters.size(); i++ )
+   {
+      if ( mEmitters[i] == emitter )
+      {
+         mEmitters.erase_fast( i );
+         break;
+      }
+   }
+
+   if ( !mEmitters.empty() || !isProperlyAdded() || isDeleted() )
+      return;
+
+   // Take the batch out of the map right away so a new emitter
+   // doesn't join it before the deferred delete happens.
+   HashMap< ParticleEmitterData*, ParticleBatch* >::iterator iter = smBatches.find( mEmitterData );
+   if ( iter != smBatches.end() && iter->value == this )
+      smBatches.erase( iter );
+
+   safeDeleteObject();
+}
+
+//-----------------------------------------------------------------------------
+// ParticleBatch
+//-----------------------------------------------------------------------------
+ParticleBatch::ParticleBatch()
+   :  mEmitterData( NULL ),
+      mPrimBuffSize( 0 )
+{
+   // Batches only exist on the client.
+   mNetFlags.set( IsGhost );
+}
+
+//-----------------------------------------------------------------------------
+// onAdd
+//-----------------------------------------------------------------------------
+bool ParticleBatch::onAdd()
+{
+   if ( !mEmitterData || !Parent::onAdd() )
+      return false;
+
+   // Go away with the emitters when the mission ends.
+   SimGroup *cleanup = dynamic_cast<SimGroup *>( Sim::findObject( "ClientMissionCleanup") );
+   if ( cleanup != NULL )
+      cleanup->addObject( this );
+
+   removeFromProcessList();
+
+   mObjBox.set( Point3F( -0.5f, -0.5f, -0.5f ), Point3F( 0.5f, 0.5f, 0.5f ) );
+   resetWorldBox();
+
+   gClientSceneGraph->addObjectToScene( this );
+   ClientProcessList::get()->addObject( this );
+
+   return true;
+}
+
+//-----------------------------------------------------------------------------
+// onRemove
+//-----------------------------------------------------------------------------
+void ParticleBatch::onRemove()
+{
+   HashMap< ParticleEmitterData*, ParticleBatch* >::iterator iter = smBatches.find( mEmitterData );
+   if ( iter != smBatches.end() && iter->value == this )
+      smBatches.erase( iter );
+
+   // Anything still in the batch goes back to taking
+   // care of itself the next time it emits.
+   for ( U32 i = 0; i < mEmitters.size(); i++ )
+      mEmitters[i]->mBatch = NULL;
+   mEmitters.clear();
+
+   removeFromScene();
+   Parent::onRemove();
+}
+
+//-----------------------------------------------------------------------------
+// processTick
+//-----------------------------------------------------------------------------
+void ParticleBatch::processTick( const Move *move )
+{
+   // Emitters delete themselves here, which takes them out of
+   // mEmitters, so walk backwards.
+   for ( S32 i = mEmitters.size() - 1; i >= 0; i-- )
+   {
+      if ( i < mEmitters.size() )
+         mEmitters[i]->processTick( move );
+   }
+}
+
+//-----------------------------------------------------------------------------
+// advanceTime
+//-----------------------------------------------------------------------------
+void ParticleBatch::advanceTime( F32 dt )
+{
+   Parent::advanceTime( dt );
+
+   PROFILE_SCOPE( ParticleBatch_advanceTime );
+
+   // Age the particles on this thread as that can delete
+   // emitters and start their deferred deletion.
+   const U32 threshold = ParticleStore::smParallelUpdateThreshold;
+   U32 numPending = 0;
+
+   mPending.clear();
+   for ( U32 i = 0; i < mEmitters.size(); i++ )
+   {
+      ParticleEmitter *emitter = mEmitters[i];
+      const U32 ms = emitter->advanceParticles( dt );
+      if ( ms == 0 )
+         continue;
+
+      // Big emitters split their own update across the pool.
+      if ( threshold != 0 && emitter->mStore.size() >= threshold )
+      {
+         emitter->update( ms );
+         continue;
+      }
+
+      mPending.increment();
+      PendingUpdate &pending = mPending.last();
+      pending.emitter = emitter;
+      pending.ms = ms;
+      numPending += emitter->mStore.size();
+   }
+
+   // Hand out the small emitters in ranges of about the same number
+   // of particles, with the same minimum range size as the store uses.
+   U32 numRanges = 1;
+   if ( threshold != 0 && numPending >= threshold )
+   {
+      ThreadPool &pool = ThreadPool::GLOBAL();
+      const U32 minParticlesPerRange = getMax( threshold / 2, 1U );
+      numRanges = mClamp( numPending / minParticlesPerRange, 1, pool.getNumThreads() + 1 );
+      numRanges = getMin( numRanges, (U32)mPending.size() );
+   }
+
+   if ( numRanges < 2 )
+      _updatePending( 0, mPending.size() );
+   else
+   {
+      Vector< ThreadSafeRef< UpdateWorkItem > > items;
+      items.reserve( numRanges );
+
+      ThreadPoolBatch batch;
+
+      U32 start = 0;
+      U32 particles = 0;
+      for ( U32 i = 0; i < mPending.size(); i++ )
+      {
+         particles += mPending[i].emitter->mStore.size();
+
+         // Cut once this range holds its share of the particles.
+         const U32 target = U64( numPending ) * ( items.size() + 1 ) / numRanges;
+         if ( particles >= target || i == mPending.size() - 1 )
+         {
+            items.push_back( new UpdateWorkItem( this, start, i + 1 ) );
+            batch.add( items.last() );
+            start = i + 1;
+         }
+      }
+
+      batch.wait();
+   }
+
+   _updateBounds();
+}
+
+//-----------------------------------------------------------------------------
+// _updatePending
+//-----------------------------------------------------------------------------
+void ParticleBatch::_updatePending( U32 start, U32 end )
+{
+   PROFILE_SCOPE( ParticleBatch_updatePending );
+
+   for ( U32 i = start; i < end; i++ )
+      mPending[i].emitter->update( mPending[i].ms );
+}
+
+//-----------------------------------------------------------------------------
+// _updateBounds
+//-----------------------------------------------------------------------------
+void ParticleBatch::_updateBounds()
+{
+   Box3F bounds = Box3F::Invalid;
+   for ( U32 i = 0; i < mEmitters.size(); i++ )
+   {
+      if ( mEmitters[i]->n_parts > 0 )
+         bounds.intersect( mEmitters[i]->getWorldBox() );
+   }
+
+   if ( !bounds.isValidBox() )
+      return;
+
+   // The batch has no transform of its own so the
+   // object box is in world space.
+   mObjBox = bounds;
+   MatrixF temp = getTransform();
+   setTransform( temp );
+}
+
+//-----------------------------------------------------------------------------
+// _allocPrimBuffer
+//-----------------------------------------------------------------------------
+void ParticleBatch::_allocPrimBuffer( U32 count )
+{
+   if ( mPrimBuff.isValid() && count <= mPrimBuffSize )
+      return;
+
+   mPrimBuffSize = getMin( getNextPow2( count ), MaxParticlesPerDraw );
+
+   // Same ordering as ParticleEmitterData::allocPrimBuffer().
+   U16 *indices;
+   mPrimBuff.set( GFX, mPrimBuffSize * 6, 0, GFXBufferTypeStatic );
+   mPrimBuff.lock( &indices );
+   for ( U32 i = 0; i < mPrimBuffSize; i++, indices += 6 )
+   {
+      const U16 offset = i * 4;
+      indices[0] = 0 + offset;
+      indices[1] = 1 + offset;
+      indices[2] = 3 + offset;
+      indices[3] = 1 + offset;
+      indices[4] = 3 + offset;
+      indices[5] = 2 + offset;
+   }
+   mPrimBuff.unlock();
+}
+
+//-----------------------------------------------------------------------------
+// prepRenderImage
+//-----------------------------------------------------------------------------
+
+S32 QSORT_CALLBACK ParticleBatch::_cmpVisibleEmitters( const void *p1, const void *p2 )
+{
+   const VisibleEmitter *ve1 = (const VisibleEmitter*)p1;
+   const VisibleEmitter *ve2 = (const VisibleEmitter*)p2;
+
+   if ( ve2->distSq > ve1->distSq )
+      return 1;
+   else if ( ve2->distSq == ve1->distSq )
+      return 0;
+   else
+      return -1;
+}
+
+void ParticleBatch::prepRenderImage( SceneRenderState *state )
+{
+   if ( state->isReflectPass() && !mEmitterData->renderReflection )
+      return;
+
+   // Never render into shadows.
+   if ( state->isShadowPass() )
+      return;
+
+   PROFILE_SCOPE( ParticleBatch_prepRenderImage );
+
+   const Point3F &camPos = state->getCameraPosition();
+   const Frustum &frustum = state->getCullingFrustum();
+
+   mVisible.clear();
+   for ( U32 i = 0; i < mEmitters.size(); i++ )
+   {
+      ParticleEmitter *emitter = mEmitters[i];
+      if ( emitter->mDead ||
+           emitter->n_parts == 0 ||
+           emitter->n_parts > MaxParticlesPerDraw )
+         continue;
+
+      const Box3F &box = emitter->getWorldBox();
+      if ( frustum.isCulled( box ) )
+         continue;
+
+      mVisible.increment();
+      VisibleEmitter &visible = mVisible.last();
+      visible.emitter = emitter;
+      visible.distSq = box.getSqDistanceToPoint( camPos );
+   }
+
+   if ( mVisible.empty() )
+      return;
+
+   // The particles of one emitter are sorted in copyStoreToVB(), so
+   // drawing the emitters far to near keeps the blending close to
+   // what separate draws would give.
+   dQsort( mVisible.address(), mVisible.size(), sizeof( VisibleEmitter ), _cmpVisibleEmitters );
+
+   // Split into draws at emitter boundaries so that
+   // each draw fits in the 16 bit index buffer.
+   Vector<U32> drawEnds( __FILE__, __LINE__ );
+   Vector<U32> drawCounts( __FILE__, __LINE__ );
+   U32 count = 0;
+   U32 maxCount = 0;
+   for ( U32 i = 0; i < mVisible.size(); i++ )
+   {
+      const U32 emitterCount = mVisible[i].emitter->n_parts;
+      if ( count + emitterCount > MaxParticlesPerDraw )
+      {
+         drawEnds.push_back( i );
+         drawCounts.push_back( count );
+         count = 0;
+      }
+      count += emitterCount;
+      maxCount = getMax( maxCount, count );
+   }
+   drawEnds.push_back( mVisible.size() );
+   drawCounts.push_back( count );
+
+   _allocPrimBuffer( maxCount );
+
+   // The render instances point at the handles so they
+   // must not move once the first one is submitted.
+   mVertBuffs.setSize( drawEnds.size() );
+
+   U32 start = 0;
+   for ( U32 i = 0; i < drawEnds.size(); i++ )
+   {
+      _submitDraw( state, i, start, drawEnds[i], drawCounts[i] );
+      start = drawEnds[i];
+   }
+}
+
+//-----------------------------------------------------------------------------
+// _submitDraw
+//-----------------------------------------------------------------------------
+void ParticleBatch::_submitDraw( SceneRenderState *state, U32 draw, U32 start, U32 end, U32 count )
+{
+   RenderPassManager *renderManager = state->getRenderPass();
+   const Point3F &camPos = state->getCameraPosition();
+   const LinearColorF &ambientColor = state->getAmbientLightColor();
+
+   GFXVertexBufferHandle<GFXVertexPCT> &vertBuff = mVertBuffs[draw];
+   vertBuff.set( GFX, count * 4, GFXBufferTypeVolatile );
+
+   PROFILE_START( ParticleBatch_copyToVB );
+
+   Box3F bounds = Box3F::Invalid;
+   GFXVertexPCT *verts = vertBuff.lock();
+   for ( U32 i = start; i < end; i++ )
+   {
+      ParticleEmitter *emitter = mVisible[i].emitter;
+      emitter->copyStoreToVB( camPos, ambientColor, verts );
+      verts += emitter->n_parts * 4;
+      bounds.intersect( emitter->getWorldBox() );
+   }
+   vertBuff.unlock();
+
+   PROFILE_END();
+
+   ParticleRenderInst *ri = renderManager->allocInst<ParticleRenderInst>();
+
+   ri->vertBuff = &vertBuff;
+   ri->primBuff = &mPrimBuff;
+   ri->translucentSort = true;
+   ri->type = RenderPassManager::RIT_Particle;
+   ri->sortDistSq = bounds.getSqDistanceToPoint( camPos );
+
+   // Draw the system offscreen unless the highResOnly flag is set on the datablock
+   ri->systemState = ( mEmitterData->highResOnly ? PSS_AwaitingHighResDraw : PSS_AwaitingOffscreenDraw );
+
+   ri->modelViewProj = renderManager->allocUniqueXform(  GFX->getProjectionMatrix() * 
+                                                         GFX->getViewMatrix() * 
+                                                         GFX->getWorldMatrix() );
+
+   // The offscreen pass needs a box around all of the particles.
+   MatrixF bbObjToWorld( true );
+   Point3F boxScale = bounds.getExtents();
+   boxScale.x = getMax( boxScale.x, 1.0f );
+   boxScale.y = getMax( boxScale.y, 1.0f );
+   boxScale.z = getMax( boxScale.z, 1.0f );
+   bbObjToWorld.scale( boxScale );
+   bbObjToWorld.setPosition( bounds.getCenter() );
+
+   ri->bbModelViewProj = renderManager->allocUniqueXform( *ri->modelViewProj * bbObjToWorld );
+
+   ri->wsPosition = bounds.getCenter();
+
+   ri->count = count;
+
+   ri->blendStyle = mEmitterData->blendStyle;
+
+   ri->glow = mEmitterData->glow;
+
+   // Batched emitters all use one texture.
+   if ( mEmitterData->textureHandle )
+      ri->diffuseTex = &*( mEmitterData->textureHandle );
+   else
+      ri->diffuseTex = &*( mEmitterData->particleDataBlocks[0]->getTextureResource() );
+
+   ri->softnessDistance = mEmitterData->softnessDistance;
+
+   // Sort by texture too.
+   ri->defaultKey = ri->diffuseTex ? (uintptr_t)ri->diffuseTex : (uintptr_t)ri->vertBuff;
+
+   renderManager->addInst( ri );
+
+   smNumDraws++;
+   smNumEmittersDrawn += end - start;
+}
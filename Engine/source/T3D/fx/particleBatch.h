@@ -0,0 +1,169 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _PARTICLEBATCH_H_
+#define _PARTICLEBATCH_H_
+
+#ifndef _GAMEBASE_H_
+#include "T3D/gameBase/gameBase.h"
+#endif
+#ifndef _TDICTIONARY_H_
+#include "core/util/tDictionary.h"
+#endif
+#ifndef _GFXVERTEXBUFFER_H_
+#include "gfx/gfxVertexBuffer.h"
+#endif
+#ifndef _GFXPRIMITIVEBUFFER_H_
+#include "gfx/gfxPrimitiveBuffer.h"
+#endif
+
+class ParticleEmitter;
+class ParticleEmitterData;
+
+
+/// Simulates and draws all the emitters which share a ParticleEmitterData.
+///
+/// Emitters that can be batched join the batch for their datablock
+/// instead of adding themselves to the scene and the process list.  The
+/// batch advances all of its emitters in a single pass, spreading the
+/// update of the small ones across the thread pool, and copies their
+/// particles into one volatile vertex buffer so they are drawn with a
+/// single ParticleRenderInst.  The emitters still own their particles
+/// and their emission state.
+///
+/// Batches are created and deleted as emitters join and leave them.
+///
+/// @see ParticleEmitter::canBatch
+class ParticleBatch : public GameBase
+{
+   typedef GameBase Parent;
+
+public:
+
+   /// The most particles one draw can index with 16 bit indices.
+   static const U32 MaxParticlesPerDraw = 16384;
+
+   /// If false, emitters are not batched.  Only affects
+   /// emitters which start emitting after it changes.
+   static bool smEnabled;
+
+   /// Number of ParticleRenderInsts submitted by all batches
+   /// since the counters were last reset.
+   static U32 smNumDraws;
+
+   /// Number of emitters drawn by all batches since the
+   /// counters were last reset.
+   static U32 smNumEmittersDrawn;
+
+   /// Returns the batch for the emitter's datablock,
+   /// creating it if needed, and adds the emitter to it.
+   static ParticleBatch* join( ParticleEmitter *emitter );
+
+   /// Returns the batch for the datablock or NULL if there is none.
+   static ParticleBatch* find( ParticleEmitterData *data );
+
+   /// Removes the emitter from the batch.  The batch deletes
+   /// itself once its last emitter has left.
+   void leave( ParticleEmitter *emitter );
+
+   /// Returns the number of batches which currently exist.
+   static U32 getNumBatches() { return smBatches.size(); }
+
+   /// Resets smNumDraws and smNumEmittersDrawn.
+   static void resetStats() { smNumDraws = 0; smNumEmittersDrawn = 0; }
+
+   ParticleBatch();
+
+   DECLARE_CONOBJECT( ParticleBatch );
+
+   ParticleEmitterData* getEmitterData() const { return mEmitterData; }
+
+   U32 getNumEmitters() const { return mEmitters.size(); }
+
+   // SimObject
+   bool onAdd();
+   void onRemove();
+
+   // ProcessObject
+   void processTick( const Move *move );
+   void advanceTime( F32 dt );
+
+   // SceneObject
+   void prepRenderImage( SceneRenderState *state );
+
+protected:
+
+   struct UpdateWorkItem;
+   friend struct UpdateWorkItem;
+
+   /// An emitter whose particles still need to be moved this frame.
+   struct PendingUpdate
+   {
+      ParticleEmitter *emitter;
+      U32 ms;
+   };
+
+   /// An emitter which is drawn this frame.
+   struct VisibleEmitter
+   {
+      ParticleEmitter *emitter;
+      F32 distSq;
+   };
+
+   /// The open batches by datablock.
+   static HashMap< ParticleEmitterData*, ParticleBatch* > smBatches;
+
+   ParticleEmitterData *mEmitterData;
+
+   Vector< ParticleEmitter* > mEmitters;
+
+   /// Emitters gathered by advanceTime for the threaded update.
+   Vector< PendingUpdate > mPending;
+
+   /// Emitters gathered by prepRenderImage.
+   Vector< VisibleEmitter > mVisible;
+
+   /// One volatile buffer per draw of the current pass.
+   Vector< GFXVertexBufferHandle< GFXVertexPCT > > mVertBuffs;
+
+   /// Quad indices for up to mPrimBuffSize particles.
+   GFXPrimitiveBufferHandle mPrimBuff;
+   U32 mPrimBuffSize;
+
+   /// Moves the particles of the emitters in mPending[start,end).
+   void _updatePending( U32 start, U32 end );
+
+   /// Grows the primitive buffer to index at least count particles.
+   void _allocPrimBuffer( U32 count );
+
+   /// Sets the bounds to the union of the emitters' bounds.
+   void _updateBounds();
+
+   /// Submits draw number draw for mVisible[start,end) which
+   /// holds count particles.
+   void _submitDraw( SceneRenderState *state, U32 draw, U32 start, U32 end, U32 count );
+
+   /// qsort callback which sorts VisibleEmitters far to near.
+   static S32 QSORT_CALLBACK _cmpVisibleEmitters( const void *p1, const void *p2 );
+};
+
+#endif // _PARTICLEBATCH_H_
@@ -27,6 +27,7 @@
 
 #include "platform/platform.h"
 #include "T3D/fx/particleEmitter.h"
+#include "T3D/fx/particleBatch.h"
 
 #include "scene/sceneManager.h"
 #include "scene/sceneRenderState.h"
@@ -42,6 +43,7 @@
 #include "T3D/gameBase/gameProcess.h"
 #include "lighting/lightInfo.h"
 #include "console/engineAPI.h"
+#include "core/module.h"
 
 #if defined(AFX_CAP_PARTICLE_POOLS) 
 #include "afx/util/afxParticlePool.h"
@@ -49,6 +51,22 @@
 
 Point3F ParticleEmitter::mWindVelocity( 0.0, 0.0, 0.0 );
 const F32 ParticleEmitter::AgedSpinToRadians = (1.0f/1000.0f) * (1.0f/360.0f) * M_PI_F * 2.0f;
+bool ParticleEmitter::smUseParticleStore = true;
+
+AFTER_MODULE_INIT( Sim )
+{
+   Con::addVariable( "$Particle::useStore", TypeBool, &ParticleEmitter::smUseParticleStore,
+      "@brief If true, emitters keep their particles in structure of arrays storage which is "
+      "updated and turned into vertices with SIMD code.\n\n"
+      "Ribbon and pooled emitters always use the particle list.  Only affects emitters created "
+      "after it is changed.\n\n"
+      "@ingroup FX\n" );
+   Con::addVariable( "$Particle::parallelUpdateThreshold", TypeS32, &ParticleStore::smParallelUpdateThreshold,
+      "@brief Minimum number of particles in an emitter before its update is split across the "
+      "worker threads.\n\n"
+      "Set to 0 to always update on the main thread.\n\n"
+      "@ingroup FX\n" );
+}
 
 IMPLEMENT_CO_DATABLOCK_V1(ParticleEmitterData);
 IMPLEMENT_CONOBJECT(ParticleEmitter);
@@ -989,6 +1007,8 @@ ParticleEmitter::ParticleEmitter()
    part_list_head.next = NULL;
    n_part_capacity = 0;
    n_parts = 0;
+   mUseStore = false;
+   mBatch = NULL;
 
    mThetaOld = 0;
    mPhiOld = 0;
@@ -1063,6 +1083,13 @@ bool ParticleEmitter::onAdd()
      pool->addParticleEmitter(this);
 #endif
 
+   // The pool is only known now so pick the particle storage here.
+   if ( usesParticleStore() != mUseStore )
+   {
+      mUseStore = !mUseStore;
+      allocParticles();
+   }
+
    return true;
 }
 
@@ -1080,6 +1107,12 @@ void ParticleEmitter::onRemove()
   }
 #endif
 
+   if ( mBatch )
+   {
+      mBatch->leave( this );
+      mBatch = NULL;
+   }
+
    removeFromScene();
    Parent::onRemove();
 }
@@ -1100,31 +1133,18 @@ bool ParticleEmitter::onNewDataBlock( GameBaseData *dptr, bool reload )
       mLifetimeMS += S32( gRandGen.randI() % (2 * mDataBlock->lifetimeVarianceMS + 1)) - S32(mDataBlock->lifetimeVarianceMS );
    }
 
-   //   Allocate particle structures and init the freelist. Member part_store
-   //   is a Vector so that we can allocate more particles if partListInitSize
-   //   turns out to be too small. 
-   //
-   if (mDataBlock->partListInitSize > 0)
+   if ( isProperlyAdded() )
+      mUseStore = usesParticleStore();
+   allocParticles();
+
+   // The particles are gone so the next emit finds a new home.
+   if ( mBatch && mBatch->getEmitterData() != mDataBlock )
    {
-      for( S32 i = 0; i < part_store.size(); i++ )
-      {
-         delete [] part_store[i];
-      }
-      part_store.clear();
-      n_part_capacity = mDataBlock->partListInitSize;
-      Particle* store_block = new Particle[n_part_capacity];
-      part_store.push_back(store_block);
-      part_freelist = store_block;
-      Particle* last_part = part_freelist;
-      Particle* part = last_part+1;
-      for( S32 i = 1; i < n_part_capacity; i++, part++, last_part++ )
-      {
-         last_part->next = part;
-      }
-      store_block[n_part_capacity-1].next = NULL;
-      part_list_head.next = NULL;
-      n_parts = 0;
+      mBatch->leave( this );
+      mBatch = NULL;
    }
+   updateParticleKeys();
+
    if (mDataBlock->isTempClone())
    {
      db_temp_clone = true;
@@ -1135,6 +1155,147 @@ bool ParticleEmitter::onNewDataBlock( GameBaseData *dptr, bool reload )
    return true;
 }
 
+//-----------------------------------------------------------------------------
+// usesParticleStore
+//-----------------------------------------------------------------------------
+bool ParticleEmitter::usesParticleStore() const
+{
+   if ( !smUseParticleStore || !mDataBlock || mDataBlock->ribbonParticles )
+      return false;
+
+#if defined(AFX_CAP_PARTICLE_POOLS)
+   if ( pool )
+      return false;
+#endif
+
+   return true;
+}
+
+//-----------------------------------------------------------------------------
+// allocParticles
+//-----------------------------------------------------------------------------
+void ParticleEmitter::allocParticles()
+{
+   if ( mDataBlock->partListInitSize <= 0 )
+      return;
+
+   for( S32 i = 0; i < part_store.size(); i++ )
+   {
+      delete [] part_store[i];
+   }
+   part_store.clear();
+   part_freelist = NULL;
+   part_list_head.next = NULL;
+   mStore.clear();
+   n_parts = 0;
+
+   n_part_capacity = mDataBlock->partListInitSize;
+
+   // The store grows itself; n_part_capacity only tracks
+   // the size of the primitive buffer.
+   if ( mUseStore )
+   {
+      mStore.reserve( n_part_capacity );
+      return;
+   }
+
+   //   Allocate particle structures and init the freelist. Member part_store
+   //   is a Vector so that we can allocate more particles if partListInitSize
+   //   turns out to be too small. 
+   //
+   Particle* store_block = new Particle[n_part_capacity];
+   part_store.push_back(store_block);
+   part_freelist = store_block;
+   Particle* last_part = part_freelist;
+   Particle* part = last_part+1;
+   for( S32 i = 1; i < n_part_capacity; i++, part++, last_part++ )
+   {
+      last_part->next = part;
+   }
+   store_block[n_part_capacity-1].next = NULL;
+}
+
+//-----------------------------------------------------------------------------
+// updateParticleKeys
+//-----------------------------------------------------------------------------
+void ParticleEmitter::updateParticleKeys()
+{
+   if ( !mDataBlock )
+      return;
+
+   ParticleKeys keys;
+   for( S32 i = 0; i < mDataBlock->particleDataBlocks.size(); i++ )
+   {
+      keys.set( mDataBlock->particleDataBlocks[i],
+                mDataBlock->useEmitterColors ? colors : NULL,
+                mDataBlock->useEmitterSizes ? sizes : NULL );
+      mStore.setKeys( i, keys );
+   }
+}
+
+//-----------------------------------------------------------------------------
+// getFadeScales
+//-----------------------------------------------------------------------------
+void ParticleEmitter::getFadeScales( LinearColorF *outColor, F32 *outSize ) const
+{
+   const F32 colorFade = mDataBlock->fade_color ? fade_amt : 1.0f;
+   const F32 alphaFade = mDataBlock->fade_alpha ? fade_amt : 1.0f;
+   outColor->set( colorFade, colorFade, colorFade, alphaFade );
+   *outSize = mDataBlock->fade_size ? fade_amt : 1.0f;
+}
+
+//-----------------------------------------------------------------------------
+// canBatch
+//-----------------------------------------------------------------------------
+bool ParticleEmitter::canBatch() const
+{
+   if ( !ParticleBatch::smEnabled || !mUseStore || sort_priority != 0 || !isProperlyAdded() )
+      return false;
+
+   // A batch draws with 16 bit indices.
+   if ( n_parts > ParticleBatch::MaxParticlesPerDraw ||
+        mDataBlock->partListInitSize > ParticleBatch::MaxParticlesPerDraw )
+      return false;
+
+   if ( mDataBlock->textureHandle )
+      return true;
+
+   // Otherwise each particle uses the texture of its
+   // datablock and a draw can only bind one.
+   const GFXTextureObject *texture = mDataBlock->particleDataBlocks[0]->getTextureResource();
+   for ( S32 i = 1; i < mDataBlock->particleDataBlocks.size(); i++ )
+   {
+      if ( mDataBlock->particleDataBlocks[i]->getTextureResource() != texture )
+         return false;
+   }
+
+   return true;
+}
+
+//-----------------------------------------------------------------------------
+// enterWorld
+//-----------------------------------------------------------------------------
+void ParticleEmitter::enterWorld()
+{
+   if ( mBatch && !canBatch() )
+   {
+      mBatch->leave( this );
+      mBatch = NULL;
+   }
+
+   if ( n_parts == 0 || mBatch || getSceneManager() != NULL )
+      return;
+
+   if ( canBatch() )
+      mBatch = ParticleBatch::join( this );
+
+   if ( !mBatch )
+   {
+      gClientSceneGraph->addObjectToScene(this);
+      ClientProcessList::get()->addObject(this);
+   }
+}
+
 //-----------------------------------------------------------------------------
 // getCollectiveColor
 //-----------------------------------------------------------------------------
@@ -1144,9 +1305,18 @@ LinearColorF ParticleEmitter::getCollectiveColor()
 	LinearColorF color = LinearColorF(0.0f, 0.0f, 0.0f);
 
    count = n_parts;
-   for( Particle* part = part_list_head.next; part != NULL; part = part->next )
+   if ( mUseStore )
+   {
+      const ParticleStreams &streams = mStore.getStreams();
+      for( U32 i = 0; i < mStore.size(); i++ )
+         color += LinearColorF( streams.red[i], streams.green[i], streams.blue[i], streams.alpha[i] );
+   }
+   else
    {
-      color += part->color;
+      for( Particle* part = part_list_head.next; part != NULL; part = part->next )
+      {
+         color += part->color;
+      }
    }
 
 	if(count > 0)
@@ -1182,7 +1352,7 @@ void ParticleEmitter::prepRenderImage(SceneRenderState* state)
 
    if (  mDead ||
          n_parts == 0 || 
-         part_list_head.next == NULL )
+         ( !mUseStore && part_list_head.next == NULL ) )
       return;
 
    RenderPassManager *renderManager = state->getRenderPass();
@@ -1224,6 +1394,8 @@ void ParticleEmitter::prepRenderImage(SceneRenderState* state)
    // use first particle's texture unless there is an emitter texture to override it
    if (mDataBlock->textureHandle)
      ri->diffuseTex = &*(mDataBlock->textureHandle);
+   else if (mUseStore)
+     ri->diffuseTex = &*(mStore.getDataBlock(mStore.size() - 1)->getTextureResource());
    else
      ri->diffuseTex = &*(part_list_head.next->dataBlock->getTextureResource());
 
@@ -1245,6 +1417,8 @@ void ParticleEmitter::setSizes( F32 *sizeList )
    {
       sizes[i] = sizeList[i];
    }
+
+   updateParticleKeys();
 }
 
 //-----------------------------------------------------------------------------
@@ -1256,6 +1430,8 @@ void ParticleEmitter::setColors( LinearColorF *colorList )
    {
       colors[i] = colorList[i];
    }
+
+   updateParticleKeys();
 }
 
 //-----------------------------------------------------------------------------
@@ -1284,7 +1460,7 @@ void ParticleEmitter::deleteWhenEmpty()
          deleteObject();
       }
       else
-         AssertFatal( getSceneManager() != NULL, "ParticleEmitter not on process list and won't get ticked to death" );
+         AssertFatal( getSceneManager() != NULL || mBatch != NULL, "ParticleEmitter not on process list and won't get ticked to death" );
    }
 }
 
@@ -1415,7 +1591,24 @@ void ParticleEmitter::emitParticles(const Point3F& start,
       // NOTE: We are assuming that the just added particle is at the head of our
       //  list.  If that changes, so must this...
       U32 advanceMS = numMilliseconds - currTime;
-      if (mDataBlock->overrideAdvance == false && advanceMS != 0) 
+      if (mUseStore && mDataBlock->overrideAdvance == false && advanceMS != 0)
+      {
+         // The store keeps the newest particle last.
+         const U32 last = mStore.size() - 1;
+         if (advanceMS > mStore.getStreams().lifetime[last])
+         {
+            mStore.remove(last);
+            n_parts--;
+         }
+         else
+         {
+            LinearColorF fadeColor;
+            F32 fadeSize;
+            getFadeScales(&fadeColor, &fadeSize);
+            mStore.updateRange(last, 1, F32(advanceMS) / 1000.0f, mWindVelocity, pos_pe, fadeColor, fadeSize);
+         }
+      }
+      else if (mDataBlock->overrideAdvance == false && advanceMS != 0) 
       {
          Particle* last_part = part_list_head.next;
          if (advanceMS > last_part->totalLifetime) 
@@ -1460,11 +1653,7 @@ void ParticleEmitter::emitParticles(const Point3F& start,
       updateBBox();
 
 
-   if( n_parts > 0 && getSceneManager() == NULL )
-   {
-      gClientSceneGraph->addObjectToScene(this);
-      ClientProcessList::get()->addObject(this);
-   }
+   enterWorld();
 
    mLastPosition = end;
    mHasLastPosition = true;
@@ -1530,11 +1719,7 @@ void ParticleEmitter::emitParticles(const Point3F& rCenter,
    resetWorldBox();
 
    // Make sure we're part of the world
-   if( n_parts > 0 && getSceneManager() == NULL )
-   {
-      gClientSceneGraph->addObjectToScene(this);
-      ClientProcessList::get()->addObject(this);
-   }
+   enterWorld();
 
    mHasLastPosition = false;
 }
@@ -1549,7 +1734,20 @@ void ParticleEmitter::updateBBox()
    Point3F minPt(1e10,   1e10,  1e10);
    Point3F maxPt(-1e10, -1e10, -1e10);
 
-   for (Particle* part = part_list_head.next; part != NULL; part = part->next)
+   if (mUseStore)
+   {
+      const ParticleStreams &s = mStore.getStreams();
+      for (U32 i = 0; i < mStore.size(); i++)
+      {
+         const Point3F pos(s.posX[i], s.posY[i], s.posZ[i]);
+         const Point3F vel(s.velX[i], s.velY[i], s.velZ[i]);
+         Point3F particleSize(s.size[i] * 0.5f);
+         F32 motion = getMax((vel.len() * s.lifetime[i] / 1000.0f), 1.0f);
+         minPt.setMin(pos - particleSize - Point3F(motion));
+         maxPt.setMax(pos + particleSize + Point3F(motion));
+      }
+   }
+   else
    {
       for (Particle* part = part_list_head.next; part != NULL; part = part->next)
       {
@@ -1588,20 +1786,30 @@ void ParticleEmitter::addParticle(const Point3F& pos, const Point3F& axis, const
    {
       // In an emergency we allocate additional particles in blocks of 16.
       // This should happen rarely.
-      Particle* store_block = new Particle[16];
-      part_store.push_back(store_block);
-      n_part_capacity += 16;
-      for (S32 i = 0; i < 16; i++)
+      if (!mUseStore)
       {
-        store_block[i].next = part_freelist;
-        part_freelist = &store_block[i];
+         Particle* store_block = new Particle[16];
+         part_store.push_back(store_block);
+         for (S32 i = 0; i < 16; i++)
+         {
+           store_block[i].next = part_freelist;
+           part_freelist = &store_block[i];
+         }
       }
+      n_part_capacity += 16;
       mDataBlock->allocPrimBuffer(n_part_capacity); // allocate larger primitive buffer or will crash 
    }
-   Particle* pNew = part_freelist;
-   part_freelist = pNew->next;
-   pNew->next = part_list_head.next;
-   part_list_head.next = pNew;
+
+   // The store copies the particle in once it is initialized.
+   Particle storeParticle;
+   Particle* pNew = &storeParticle;
+   if (!mUseStore)
+   {
+      pNew = part_freelist;
+      part_freelist = pNew->next;
+      pNew->next = part_list_head.next;
+      part_list_head.next = pNew;
+   }
 
    // for earlier access to constrain_pos, the ParticleData datablock is chosen here instead
    // of later in the method.
@@ -1669,16 +1877,26 @@ void ParticleEmitter::addParticle(const Point3F& pos, const Point3F& axis, const
    pNew->currentAge = age_offset;
    pNew->t_last = 0.0f;
    // ribbon particles only use the first particle
+   U32 keySet = 0;
    if(mDataBlock->ribbonParticles)
    {
       mDataBlock->particleDataBlocks[0]->initializeParticle(pNew, vel);
    }
    else
    {
-      U32 dBlockIndex = gRandGen.randI() % mDataBlock->particleDataBlocks.size();
-   mDataBlock->particleDataBlocks[dBlockIndex]->initializeParticle(pNew, vel);
+      keySet = gRandGen.randI() % mDataBlock->particleDataBlocks.size();
+      mDataBlock->particleDataBlocks[keySet]->initializeParticle(pNew, vel);
    }
-   updateKeyData( pNew );
+
+   if (mUseStore)
+   {
+      LinearColorF fadeColor;
+      F32 fadeSize;
+      getFadeScales(&fadeColor, &fadeSize);
+      mStore.updateKeys(mStore.add(*pNew, keySet), 1, fadeColor, fadeSize);
+   }
+   else
+      updateKeyData( pNew );
 
 }
 
@@ -1701,37 +1919,54 @@ void ParticleEmitter::processTick(const Move*)
 //-----------------------------------------------------------------------------
 void ParticleEmitter::advanceTime(F32 dt)
 {
-   if( dt < 0.00001 ) return;
+   const U32 numMSToUpdate = advanceParticles( dt );
+   if( numMSToUpdate != 0 )
+      update( numMSToUpdate );
+}
+
+//-----------------------------------------------------------------------------
+// advanceParticles
+//-----------------------------------------------------------------------------
+U32 ParticleEmitter::advanceParticles(F32 dt)
+{
+   if( dt < 0.00001 ) return 0;
 
    Parent::advanceTime(dt);
 
    if( dt > 0.5 ) dt = 0.5;
 
-   if( mDead ) return;
+   if( mDead ) return 0;
 
    mElapsedTimeMS += (S32)(dt * 1000.0f);
 
    U32 numMSToUpdate = (U32)(dt * 1000.0f);
-   if( numMSToUpdate == 0 ) return;
+   if( numMSToUpdate == 0 ) return 0;
 
    // TODO: Prefetch
 
    // remove dead particles
-   Particle* last_part = &part_list_head;
-   for (Particle* part = part_list_head.next; part != NULL; part = part->next)
+   if (mUseStore)
    {
-     part->currentAge += numMSToUpdate;
-     if (part->currentAge > part->totalLifetime)
-     {
-       n_parts--;
-       last_part->next = part->next;
-       part->next = part_freelist;
-       part_freelist = part;
-       part = last_part;
-     }
-     else
+     n_parts -= mStore.advanceAge(numMSToUpdate);
+   }
+   else
+   {
+     Particle* last_part = &part_list_head;
+     for (Particle* part = part_list_head.next; part != NULL; part = part->next)
      {
-       last_part = part;
+       part->currentAge += numMSToUpdate;
+       if (part->currentAge > part->totalLifetime)
+       {
+         n_parts--;
+         last_part->next = part->next;
+         part->next = part_freelist;
+         part_freelist = part;
+         part = last_part;
+       }
+       else
+       {
+         last_part = part;
+       }
      }
    }
 
@@ -1740,13 +1975,10 @@ void ParticleEmitter::advanceTime(F32 dt)
    if (n_parts < 1 && mDeleteWhenEmpty)
    {
       mDeleteOnTick = true;
-      return;
+      return 0;
    }
 
-   if( numMSToUpdate != 0 && n_parts > 0 )
-   {
-      update( numMSToUpdate );
-   }
+   return n_parts > 0 ? numMSToUpdate : 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -1826,6 +2058,15 @@ void ParticleEmitter::update( U32 ms )
 {
    F32 t = F32(ms)/1000.0f; // AFX -- moved outside loop, no need to recalculate this for every particle
 
+   if (mUseStore)
+   {
+      LinearColorF fadeColor;
+      F32 fadeSize;
+      getFadeScales(&fadeColor, &fadeSize);
+      mStore.update(t, mWindVelocity, pos_pe, fadeColor, fadeSize);
+      return;
+   }
+
    for (Particle* part = part_list_head.next; part != NULL; part = part->next)
    {
       Point3F a = part->acc;
@@ -1873,12 +2114,61 @@ S32 QSORT_CALLBACK cmpSortParticles(const void* p1, const void* p2)
       return -1;
 }
 
-void ParticleEmitter::copyToVB( const Point3F &camPos, const LinearColorF &ambientColor )
+// structure used for sorting particles in the particle store.
+struct SortParticleIndex
 {
-   static Vector<SortParticle> orderedVector(__FILE__, __LINE__);
+   U32 index;
+   F32 k;
+};
+
+static S32 QSORT_CALLBACK cmpSortParticleIndices(const void* p1, const void* p2)
+{
+   const SortParticleIndex* sp1 = (const SortParticleIndex*)p1;
+   const SortParticleIndex* sp2 = (const SortParticleIndex*)p2;
+
+   if (sp2->k > sp1->k)
+      return 1;
+   else if (sp2->k == sp1->k)
+      return 0;
+   else
+      return -1;
+}
 
+void ParticleEmitter::copyToVB( const Point3F &camPos, const LinearColorF &ambientColor )
+{
    PROFILE_START(ParticleEmitter_copyToVB);
 
+   static Vector<ParticleVertexType> tempBuff(2048);
+   tempBuff.reserve( n_parts*4 + 64); // make sure tempBuff is big enough
+
+   if (mUseStore)
+      copyStoreToVB( camPos, ambientColor, tempBuff.address() );
+   else
+      copyListToVB( camPos, ambientColor, tempBuff.address() );
+
+   PROFILE_START(ParticleEmitter_copyToVB_LockCopy);
+   // create new VB if emitter size grows
+   if( !mVertBuff || n_parts > mCurBuffSize )
+   {
+      mCurBuffSize = n_parts;
+      mVertBuff.set( GFX, n_parts * 4, GFXBufferTypeDynamic );
+   }
+   // lock and copy tempBuff to video RAM
+   ParticleVertexType *verts = mVertBuff.lock();
+   dMemcpy( verts, tempBuff.address(), n_parts * 4 * sizeof(ParticleVertexType) );
+   mVertBuff.unlock();
+   PROFILE_END();
+
+   PROFILE_END();
+}
+
+//-----------------------------------------------------------------------------
+// Copy the particle list to the vertex buffer
+//-----------------------------------------------------------------------------
+void ParticleEmitter::copyListToVB( const Point3F &camPos, const LinearColorF &ambientColor, ParticleVertexType *buffPtr )
+{
+   static Vector<SortParticle> orderedVector(__FILE__, __LINE__);
+
    PROFILE_START(ParticleEmitter_copyToVB_Sort);
    // build sorted list of particles (far to near)
    if (mDataBlock->sortParticles)
@@ -1901,10 +2191,6 @@ void ParticleEmitter::copyToVB( const Point3F &camPos, const LinearColorF &ambie
    }
    PROFILE_END();
 
-   static Vector<ParticleVertexType> tempBuff(2048);
-   tempBuff.reserve( n_parts*4 + 64); // make sure tempBuff is big enough
-   ParticleVertexType *buffPtr = tempBuff.address(); // use direct pointer (faster)
-   
    if (mDataBlock->ribbonParticles)
    {
       PROFILE_START(ParticleEmitter_copyToVB_Ribbon);
@@ -2081,20 +2367,100 @@ void ParticleEmitter::copyToVB( const Point3F &camPos, const LinearColorF &ambie
 
       PROFILE_END();
    }
+}
 
-   PROFILE_START(ParticleEmitter_copyToVB_LockCopy);
-   // create new VB if emitter size grows
-   if( !mVertBuff || n_parts > mCurBuffSize )
+//-----------------------------------------------------------------------------
+// Copy the particle store to the vertex buffer
+//-----------------------------------------------------------------------------
+void ParticleEmitter::copyStoreToVB( const Point3F &camPos, const LinearColorF &ambientColor, ParticleVertexType *buffPtr )
+{
+   static Vector<SortParticleIndex> orderedVector(__FILE__, __LINE__);
+   static Vector<U32> order(__FILE__, __LINE__);
+
+   const U32 count = mStore.size();
+   const ParticleStreams &streams = mStore.getStreams();
+   order.setSize( count );
+
+   PROFILE_START(ParticleEmitter_copyStoreToVB_Sort);
+   if (mDataBlock->sortParticles)
    {
-      mCurBuffSize = n_parts;
-      mVertBuff.set( GFX, n_parts * 4, GFXBufferTypeDynamic );
+      // build sorted list of particles (far to near)
+      MatrixF modelview = GFX->getWorldMatrix();
+      Point3F viewvec; modelview.getRow(1, &viewvec);
+
+      orderedVector.setSize( count );
+      for (U32 i = 0; i < count; i++)
+      {
+         orderedVector[i].index = i;
+         orderedVector[i].k = streams.posX[i] * viewvec.x + streams.posY[i] * viewvec.y + streams.posZ[i] * viewvec.z;
+      }
+
+      dQsort(orderedVector.address(), count, sizeof(SortParticleIndex), cmpSortParticleIndices);
+
+      // reverseOrder fills the buffer from the back.
+      for (U32 i = 0; i < count; i++)
+         order[i] = orderedVector[ mDataBlock->reverseOrder ? count - 1 - i : i ].index;
+   }
+   else
+   {
+      // Newest first like the particle list.
+      for (U32 i = 0; i < count; i++)
+         order[i] = mDataBlock->reverseOrder ? i : count - 1 - i;
    }
-   // lock and copy tempBuff to video RAM
-   ParticleVertexType *verts = mVertBuff.lock();
-   dMemcpy( verts, tempBuff.address(), n_parts * 4 * sizeof(ParticleVertexType) );
-   mVertBuff.unlock();
    PROFILE_END();
 
+   if (mDataBlock->orientParticles || mDataBlock->alignParticles)
+   {
+      PROFILE_START(ParticleEmitter_copyStoreToVB_Orient);
+
+      Particle part;
+      for (U32 i = 0; i < count; i++, buffPtr += 4)
+      {
+         mStore.get( order[i], &part );
+         if (mDataBlock->orientParticles)
+            setupOriented( &part, camPos, ambientColor, buffPtr );
+         else
+            setupAligned( &part, ambientColor, buffPtr );
+      }
+
+      PROFILE_END();
+      return;
+   }
+
+   PROFILE_START(ParticleEmitter_copyStoreToVB_NonOriented);
+
+   MatrixF camView = GFX->getWorldMatrix();
+   camView.transpose();  // inverse - this gets the particles facing camera
+
+   // Same as the lerp between the color and the lit color in setupBillboard().
+   const F32 ambientLerp = mClampF( mDataBlock->ambientFactor, 0.0f, 1.0f );
+   const LinearColorF colorScale( mLerp( 1.0f, ambientColor.red, ambientLerp ),
+                                  mLerp( 1.0f, ambientColor.green, ambientLerp ),
+                                  mLerp( 1.0f, ambientColor.blue, ambientLerp ),
+                                  mLerp( 1.0f, ambientColor.alpha, ambientLerp ) );
+
+   mStore.buildBillboards( order.address(), count, camView, colorScale, buffPtr );
+
+   // Patch in the UVs for the current frame of animated particles.
+   for (U32 i = 0; i < count; i++, buffPtr += 4)
+   {
+      const U32 index = order[i];
+      ParticleData *dataBlock = mStore.getDataBlock( index );
+      if (!dataBlock->animateTexture || dataBlock->animTexFrames.empty())
+         continue;
+
+      S32 fm = (S32)(streams.age[index]*(1.0/1000.0)*dataBlock->framesPerSec);
+      U8 fm_tile = dataBlock->animTexFrames[fm % dataBlock->numFrames];
+      S32 uv[4];
+      uv[0] = fm_tile + fm_tile/dataBlock->animTexTiling.x;
+      uv[1] = uv[0] + (dataBlock->animTexTiling.x + 1);
+      uv[2] = uv[1] + 1;
+      uv[3] = uv[0] + 1;
+
+      for (U32 v = 0; v < 4; v++)
+         buffPtr[v].texCoord = dataBlock->animTexUVs[uv[v]];
+   }
+
    PROFILE_END();
 }
 
@@ -2677,6 +3043,10 @@ void ParticleEmitter::setForcedObjBox(Box3F& box)
 void ParticleEmitter::setSortPriority(S8 priority) 
 {
   sort_priority = (priority == 0) ? 1 : priority;
+
+  // Batches draw without a sort priority.
+  if (mBatch)
+    enterWorld();
 #if defined(AFX_CAP_PARTICLE_POOLS)
   if (pool)
     pool->setSortPriority(sort_priority);
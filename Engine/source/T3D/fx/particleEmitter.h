@@ -43,9 +43,13 @@
 #ifndef _PARTICLE_H_
 #include "T3D/fx/particle.h"
 #endif
+#ifndef _PARTICLESTORE_H_
+#include "T3D/fx/particleStore.h"
+#endif
 
 class RenderPassManager;
 class ParticleData;
+class ParticleBatch;
 
 #ifdef TORQUE_AFX_ENABLED
 	#define AFX_CAP_PARTICLE_POOLS
@@ -156,6 +160,7 @@ public:
 class ParticleEmitter : public GameBase
 {
    typedef GameBase Parent;
+   friend class ParticleBatch;
 #if defined(AFX_CAP_PARTICLE_POOLS) 
    friend class afxParticlePool;
 #endif 
@@ -171,6 +176,11 @@ class ParticleEmitter : public GameBase
 
    static Point3F mWindVelocity;
    static void setWindVelocity( const Point3F &vel ){ mWindVelocity = vel; }
+
+   /// If true, emitters which support it keep their particles in a
+   /// ParticleStore rather than the linked list.  Takes effect for
+   /// emitters added after it changes.
+   static bool smUseParticleStore;
    
    LinearColorF getCollectiveColor();
 
@@ -256,6 +266,35 @@ class ParticleEmitter : public GameBase
    /// Updates the bounding box for the particle system
    void updateBBox();
 
+   /// Returns true if the particles can be kept in mStore.  Ribbons,
+   /// pooled emitters and subclasses which adjust individual particles
+   /// need the linked list.
+   virtual bool usesParticleStore() const;
+
+   /// Allocate the particle list or store for the current datablock.
+   void allocParticles();
+
+   /// Rebuild the store's key sets from the datablock and the
+   /// emitter's color and size overrides.
+   void updateParticleKeys();
+
+   /// Returns the scales the datablock's fade flags apply to the
+   /// particle colors and sizes.
+   void getFadeScales( LinearColorF *outColor, F32 *outSize ) const;
+
+   /// Returns true if the emitter can be simulated and drawn
+   /// by the ParticleBatch for its datablock.
+   bool canBatch() const;
+
+   /// Makes sure an emitter with particles gets ticked and drawn, either
+   /// by joining a ParticleBatch or by adding itself to the client scene
+   /// and process list.  Leaves its batch if it can no longer be batched.
+   void enterWorld();
+
+   /// Ages the particles and removes the dead ones.  Returns the number
+   /// of milliseconds the remaining particles need to be moved by.
+   U32 advanceParticles( F32 dt );
+
    /// @}
   protected:
    bool onAdd();
@@ -268,6 +307,8 @@ class ParticleEmitter : public GameBase
   protected:
    void prepRenderImage( SceneRenderState *state );
    void copyToVB( const Point3F &camPos, const LinearColorF &ambientColor );
+   void copyListToVB( const Point3F &camPos, const LinearColorF &ambientColor, ParticleVertexType *buffPtr );
+   void copyStoreToVB( const Point3F &camPos, const LinearColorF &ambientColor, ParticleVertexType *buffPtr );
 
    // PEngine interface
   private:
@@ -326,6 +367,14 @@ protected:
    Particle   part_list_head;
    S32        n_part_capacity;
    S32        n_parts;
+
+   /// Structure of arrays particle storage used instead of the
+   /// list when mUseStore is set.  n_parts is kept in sync.
+   ParticleStore mStore;
+   bool       mUseStore;
+
+   /// The batch which ticks and draws this emitter, if any.
+   ParticleBatch *mBatch;
 private:    
    S32       mCurBuffSize;
 
@@ -0,0 +1,173 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "T3D/fx/particleIntrinsics.h"
+#include "T3D/fx/arch/particleIntrinsics.arch.h"
+
+#include "T3D/fx/particleStore.h"
+#include "core/module.h"
+
+
+void (*particle_integrate)( const ParticleStreams &streams, U32 start, U32 count, F32 dt,
+                            const Point3F &wind, const Point3F &offset ) = NULL;
+
+void (*particle_update_keys)( const ParticleStreams &streams, U32 start, U32 count,
+                              const ParticleKeys *keys, const LinearColorF &fadeColor, F32 fadeSize ) = NULL;
+
+void (*particle_build_billboards)( const ParticleStreams &streams, const U32 *order, U32 count,
+                                   const ParticleKeys *keys, const Point3F &right, const Point3F &up,
+                                   const LinearColorF &colorScale, GFXVertexPCT *outVerts ) = NULL;
+
+//------------------------------------------------------------------------------
+// Default C++ Implementations
+//------------------------------------------------------------------------------
+
+void particle_integrate_C( const ParticleStreams &s, U32 start, U32 count, F32 dt,
+                           const Point3F &wind, const Point3F &offset )
+{
+   const U32 end = start + count;
+   for ( U32 i = start; i < end; i++ )
+   {
+      const F32 ax = s.accX[i] - s.velX[i] * s.drag[i] + wind.x * s.wind[i];
+      const F32 ay = s.accY[i] - s.velY[i] * s.drag[i] + wind.y * s.wind[i];
+      F32 az = s.accZ[i] - s.velZ[i] * s.drag[i] + wind.z * s.wind[i];
+      az += -9.81f * s.gravity[i];
+
+      s.velX[i] += ax * dt;
+      s.velY[i] += ay * dt;
+      s.velZ[i] += az * dt;
+
+      s.localX[i] += s.velX[i] * dt;
+      s.localY[i] += s.velY[i] * dt;
+      s.localZ[i] += s.velZ[i] * dt;
+
+      s.posX[i] = s.localX[i] + offset.x * s.constrain[i];
+      s.posY[i] = s.localY[i] + offset.y * s.constrain[i];
+      s.posZ[i] = s.localZ[i] + offset.z * s.constrain[i];
+   }
+}
+
+void particle_update_keys_C( const ParticleStreams &s, U32 start, U32 count,
+                             const ParticleKeys *keys, const LinearColorF &fadeColor, F32 fadeSize )
+{
+   const U32 end = start + count;
+   for ( U32 i = start; i < end; i++ )
+   {
+      if ( s.age[i] > s.lifetime[i] )
+         s.age[i] = s.lifetime[i];
+
+      const ParticleKeys &k = keys[ s.keySet[i] ];
+      const F32 t = (F32)s.age[i] / (F32)s.lifetime[i];
+
+      // Find the first key at or past the age.  If there
+      // isn't one the particle keeps its last values.
+      U32 key = 1;
+      while ( key < ParticleData::PDC_NUM_KEYS && k.times[key] < t )
+         key++;
+      if ( key == ParticleData::PDC_NUM_KEYS )
+         continue;
+
+      const F32 f = ( t - k.times[key-1] ) / ( k.times[key] - k.times[key-1] );
+
+      LinearColorF color;
+      color.interpolate( k.colors[key-1], k.colors[key], f );
+
+      s.red[i] = color.red * fadeColor.red;
+      s.green[i] = color.green * fadeColor.green;
+      s.blue[i] = color.blue * fadeColor.blue;
+      s.alpha[i] = color.alpha * fadeColor.alpha;
+
+      s.size[i] = ( k.sizes[key-1] * ( 1.0f - f ) + k.sizes[key] * f ) * fadeSize;
+   }
+}
+
+void particle_build_billboards_C( const ParticleStreams &s, const U32 *order, U32 count,
+                                  const ParticleKeys *keys, const Point3F &right, const Point3F &up,
+                                  const LinearColorF &colorScale, GFXVertexPCT *outVerts )
+{
+   // Same as ParticleEmitter::AgedSpinToRadians.
+   const F32 agedSpinToRadians = ( 1.0f / 1000.0f ) * ( 1.0f / 360.0f ) * M_PI_F * 2.0f;
+
+   GFXVertexPCT *verts = outVerts;
+   for ( U32 n = 0; n < count; n++, verts += 4 )
+   {
+      const U32 i = order[n];
+
+      F32 sy, cy;
+      mSinCos( s.spinSpeed[i] * s.age[i] * agedSpinToRadians, sy, cy );
+
+      // The spun right and up axes of the quad.
+      const F32 width = s.size[i] * 0.5f;
+      const Point3F r = ( right * cy + up * sy ) * width;
+      const Point3F u = ( up * cy - right * sy ) * width;
+      const Point3F pos( s.posX[i], s.posY[i], s.posZ[i] );
+
+      LinearColorF color( s.red[i] * colorScale.red,
+                          s.green[i] * colorScale.green,
+                          s.blue[i] * colorScale.blue,
+                          s.alpha[i] * colorScale.alpha );
+      color.clamp();
+      const GFXVertexColor vertColor( color );
+
+      const Point2F *texCoords = keys[ s.keySet[i] ].texCoords;
+
+      verts[0].point = pos - r + u;
+      verts[1].point = pos - r - u;
+      verts[2].point = pos + r - u;
+      verts[3].point = pos + r + u;
+
+      for ( U32 v = 0; v < 4; v++ )
+      {
+         verts[v].color = vertColor;
+         verts[v].texCoord = texCoords[v];
+      }
+   }
+}
+
+//------------------------------------------------------------------------------
+// Initializer.
+//------------------------------------------------------------------------------
+
+MODULE_BEGIN( ParticleIntrinsics )
+
+   MODULE_INIT_AFTER( 3D )
+
+   MODULE_INIT
+   {
+      // Assign defaults (C++ versions)
+      particle_integrate = particle_integrate_C;
+      particle_update_keys = particle_update_keys_C;
+      particle_build_billboards = particle_build_billboards_C;
+
+      // Find the best implementation for the current CPU
+      if ( Platform::SystemInfo.processor.properties & CPU_PROP_SSE )
+      {
+         #if ( defined( TORQUE_CPU_X86 ) || defined( TORQUE_CPU_X64 ) )
+            particle_integrate = particle_integrate_SSE;
+            particle_update_keys = particle_update_keys_SSE;
+            particle_build_billboards = particle_build_billboards_SSE;
+         #endif
+      }
+   }
+
+MODULE_END;
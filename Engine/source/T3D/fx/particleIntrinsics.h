@@ -0,0 +1,100 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _PARTICLEINTRINSICS_H_
+#define _PARTICLEINTRINSICS_H_
+
+struct ParticleStreams;
+struct ParticleKeys;
+struct GFXVertexPCT;
+class Point3F;
+class LinearColorF;
+
+/// Integrate the velocity and position of a range of particles.
+///
+/// The acceleration is the constant acceleration less drag, plus wind
+/// and gravity.  The world position is the local position plus the
+/// emitter offset for constrained particles.
+///
+/// @param streams  The particle streams.
+/// @param start    First particle to update.
+/// @param count    Number of particles to update.
+/// @param dt       Time step in seconds.
+/// @param wind     Wind velocity.
+/// @param offset   Emitter position for constrained particles.
+extern void (*particle_integrate)( const ParticleStreams &streams,
+                                   U32 start,
+                                   U32 count,
+                                   F32 dt,
+                                   const Point3F &wind,
+                                   const Point3F &offset );
+
+/// Interpolate the color and size keys of a range of particles by age.
+///
+/// @param streams    The particle streams.
+/// @param start      First particle to update.
+/// @param count      Number of particles to update.
+/// @param keys       Key sets indexed by ParticleStreams::keySet.
+/// @param fadeColor  Scale applied to the interpolated color.
+/// @param fadeSize   Scale applied to the interpolated size.
+extern void (*particle_update_keys)( const ParticleStreams &streams,
+                                     U32 start,
+                                     U32 count,
+                                     const ParticleKeys *keys,
+                                     const LinearColorF &fadeColor,
+                                     F32 fadeSize );
+
+/// Expand particles into camera facing quads.
+///
+/// @param streams     The particle streams.
+/// @param order       Indices of the particles to write in order.
+/// @param count       Number of entries in order.
+/// @param keys        Key sets indexed by ParticleStreams::keySet.
+/// @param right       Camera right vector.
+/// @param up          Camera up vector.
+/// @param colorScale  Scale applied to the particle colors.
+/// @param outVerts    Receives four vertices per particle.
+extern void (*particle_build_billboards)( const ParticleStreams &streams,
+                                          const U32 *order,
+                                          U32 count,
+                                          const ParticleKeys *keys,
+                                          const Point3F &right,
+                                          const Point3F &up,
+                                          const LinearColorF &colorScale,
+                                          GFXVertexPCT *outVerts );
+
+/// @name Portable Versions
+/// The SIMD versions finish the particles left over from
+/// their last full vector with these.
+/// @{
+
+extern void particle_integrate_C( const ParticleStreams &streams, U32 start, U32 count, F32 dt,
+                                  const Point3F &wind, const Point3F &offset );
+extern void particle_update_keys_C( const ParticleStreams &streams, U32 start, U32 count,
+                                    const ParticleKeys *keys, const LinearColorF &fadeColor, F32 fadeSize );
+extern void particle_build_billboards_C( const ParticleStreams &streams, const U32 *order, U32 count,
+                                         const ParticleKeys *keys, const Point3F &right, const Point3F &up,
+                                         const LinearColorF &colorScale, GFXVertexPCT *outVerts );
+
+/// @}
+
+#endif // _PARTICLEINTRINSICS_H_
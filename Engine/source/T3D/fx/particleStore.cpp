@@ -0,0 +1,376 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "T3D/fx/particleStore.h"
+
+#include "T3D/fx/particleIntrinsics.h"
+#include "math/mMatrix.h"
+#include "platform/profiler.h"
+#include "platform/threads/threadPoolBatch.h"
+
+
+U32 ParticleStore::smParallelUpdateThreshold = 4096;
+
+namespace {
+
+   /// Number of F32 and U32 streams in ParticleStreams.
+   enum
+   {
+      NumFloatStreams = 25,
+      NumIntStreams = 3,
+   };
+
+   /// Keep every stream a multiple of four entries so they all
+   /// start on a 16 byte boundary.
+   inline U32 _alignCapacity( U32 capacity )
+   {
+      return ( capacity + 3 ) & ~3;
+   }
+}
+
+//-----------------------------------------------------------------------------
+
+void ParticleKeys::set( const ParticleData *data, const LinearColorF *colorOverride, const F32 *sizeOverride )
+{
+   for ( U32 i = 0; i < ParticleData::PDC_NUM_KEYS; i++ )
+   {
+      times[i] = data->times[i];
+      colors[i] = colorOverride ? colorOverride[i] : data->colors[i];
+
+      // The datablock's size bias only applies to its own sizes.
+      sizes[i] = sizeOverride ? sizeOverride[i] : data->sizes[i] * data->sizeBias;
+   }
+
+   for ( U32 i = 0; i < 4; i++ )
+      texCoords[i] = data->texCoords[i];
+}
+
+//-----------------------------------------------------------------------------
+
+ParticleStore::ParticleStore()
+   :  mDataBlocks( NULL ),
+      mMemory( NULL ),
+      mCount( 0 ),
+      mCapacity( 0 )
+{
+   dMemset( &mStreams, 0, sizeof( mStreams ) );
+}
+
+ParticleStore::~ParticleStore()
+{
+   if ( mMemory )
+      dFree_aligned( mMemory );
+}
+
+void ParticleStore::reserve( U32 capacity )
+{
+   capacity = _alignCapacity( capacity );
+   if ( capacity <= mCapacity )
+      return;
+
+   const dsize_t streamSize = capacity * sizeof( F32 );
+   const dsize_t totalSize = streamSize * ( NumFloatStreams + NumIntStreams ) +
+                             capacity * sizeof( ParticleData* );
+
+   U8 *memory = (U8*)dMalloc_aligned( totalSize, 16 );
+
+   // Carve the streams out of the block in declaration order.  The
+   // old streams are laid out the same way so each one is copied
+   // from the matching pointer.
+   ParticleStreams streams;
+   F32 **floatStreams = &streams.posX;
+   F32 **oldFloatStreams = &mStreams.posX;
+   for ( U32 i = 0; i < NumFloatStreams; i++ )
+   {
+      floatStreams[i] = (F32*)( memory + streamSize * i );
+      if ( mCount )
+         dMemcpy( floatStreams[i], oldFloatStreams[i], mCount * sizeof( F32 ) );
+   }
+
+   U32 **intStreams = &streams.age;
+   U32 **oldIntStreams = &mStreams.age;
+   for ( U32 i = 0; i < NumIntStreams; i++ )
+   {
+      intStreams[i] = (U32*)( memory + streamSize * ( NumFloatStreams + i ) );
+      if ( mCount )
+         dMemcpy( intStreams[i], oldIntStreams[i], mCount * sizeof( U32 ) );
+   }
+
+   ParticleData **dataBlocks = (ParticleData**)( memory + streamSize * ( NumFloatStreams + NumIntStreams ) );
+   if ( mCount )
+      dMemcpy( dataBlocks, mDataBlocks, mCount * sizeof( ParticleData* ) );
+
+   if ( mMemory )
+      dFree_aligned( mMemory );
+
+   mMemory = memory;
+   mStreams = streams;
+   mDataBlocks = dataBlocks;
+   mCapacity = capacity;
+}
+
+void ParticleStore::setKeys( U32 keySet, const ParticleKeys &keys )
+{
+   if ( keySet >= mKeys.size() )
+      mKeys.setSize( keySet + 1 );
+
+   mKeys[keySet] = keys;
+}
+
+U32 ParticleStore::add( const Particle &part, U32 keySet )
+{
+   AssertFatal( keySet < mKeys.size(), "ParticleStore::add - Bad key set!" );
+
+   if ( mCount == mCapacity )
+      reserve( getMax( mCapacity * 2, 64U ) );
+
+   const U32 i = mCount++;
+   ParticleStreams &s = mStreams;
+
+   s.posX[i] = part.pos.x;
+   s.posY[i] = part.pos.y;
+   s.posZ[i] = part.pos.z;
+   s.localX[i] = part.pos_local.x;
+   s.localY[i] = part.pos_local.y;
+   s.localZ[i] = part.pos_local.z;
+   s.velX[i] = part.vel.x;
+   s.velY[i] = part.vel.y;
+   s.velZ[i] = part.vel.z;
+   s.accX[i] = part.acc.x;
+   s.accY[i] = part.acc.y;
+   s.accZ[i] = part.acc.z;
+   s.orientX[i] = part.orientDir.x;
+   s.orientY[i] = part.orientDir.y;
+   s.orientZ[i] = part.orientDir.z;
+
+   s.drag[i] = part.dataBlock->dragCoefficient;
+   s.wind[i] = part.dataBlock->windCoefficient;
+   s.gravity[i] = part.dataBlock->gravityCoefficient;
+   s.constrain[i] = part.dataBlock->constrain_pos ? 1.0f : 0.0f;
+
+   s.red[i] = part.color.red;
+   s.green[i] = part.color.green;
+   s.blue[i] = part.color.blue;
+   s.alpha[i] = part.color.alpha;
+   s.size[i] = part.size;
+   s.spinSpeed[i] = part.spinSpeed;
+
+   s.age[i] = part.currentAge;
+   s.lifetime[i] = getMax( part.totalLifetime, 1U );
+   s.keySet[i] = keySet;
+
+   mDataBlocks[i] = part.dataBlock;
+
+   return i;
+}
+
+void ParticleStore::get( U32 index, Particle *outPart ) const
+{
+   AssertFatal( index < mCount, "ParticleStore::get - Index out of range!" );
+
+   const ParticleStreams &s = mStreams;
+   const U32 i = index;
+
+   outPart->pos.set( s.posX[i], s.posY[i], s.posZ[i] );
+   outPart->pos_local.set( s.localX[i], s.localY[i], s.localZ[i] );
+   outPart->vel.set( s.velX[i], s.velY[i], s.velZ[i] );
+   outPart->acc.set( s.accX[i], s.accY[i], s.accZ[i] );
+   outPart->orientDir.set( s.orientX[i], s.orientY[i], s.orientZ[i] );
+   outPart->color.set( s.red[i], s.green[i], s.blue[i], s.alpha[i] );
+   outPart->size = s.size[i];
+   outPart->spinSpeed = s.spinSpeed[i];
+   outPart->currentAge = s.age[i];
+   outPart->totalLifetime = s.lifetime[i];
+   outPart->dataBlock = mDataBlocks[i];
+   outPart->next = NULL;
+}
+
+void ParticleStore::_copyParticle( U32 from, U32 to )
+{
+   F32 **floatStreams = &mStreams.posX;
+   for ( U32 i = 0; i < NumFloatStreams; i++ )
+      floatStreams[i][to] = floatStreams[i][from];
+
+   U32 **intStreams = &mStreams.age;
+   for ( U32 i = 0; i < NumIntStreams; i++ )
+      intStreams[i][to] = intStreams[i][from];
+
+   mDataBlocks[to] = mDataBlocks[from];
+}
+
+void ParticleStore::remove( U32 index )
+{
+   AssertFatal( index < mCount, "ParticleStore::remove - Index out of range!" );
+
+   const U32 numToMove = mCount - index - 1;
+   mCount--;
+   if ( numToMove == 0 )
+      return;
+
+   F32 **floatStreams = &mStreams.posX;
+   for ( U32 i = 0; i < NumFloatStreams; i++ )
+      dMemmove( floatStreams[i] + index, floatStreams[i] + index + 1, numToMove * sizeof( F32 ) );
+
+   U32 **intStreams = &mStreams.age;
+   for ( U32 i = 0; i < NumIntStreams; i++ )
+      dMemmove( intStreams[i] + index, intStreams[i] + index + 1, numToMove * sizeof( U32 ) );
+
+   dMemmove( mDataBlocks + index, mDataBlocks + index + 1, numToMove * sizeof( ParticleData* ) );
+}
+
+U32 ParticleStore::advanceAge( U32 ms )
+{
+   U32 *age = mStreams.age;
+   const U32 *lifetime = mStreams.lifetime;
+
+   // Age everything and find the first particle to die.
+   U32 firstDead = mCount;
+   for ( U32 i = 0; i < mCount; i++ )
+   {
+      age[i] += ms;
+      if ( age[i] > lifetime[i] && firstDead == mCount )
+         firstDead = i;
+   }
+
+   if ( firstDead == mCount )
+      return 0;
+
+   // Compact the survivors in place, keeping their order.
+   U32 numAlive = firstDead;
+   for ( U32 i = firstDead + 1; i < mCount; i++ )
+   {
+      if ( age[i] <= lifetime[i] )
+         _copyParticle( i, numAlive++ );
+   }
+
+   const U32 numRemoved = mCount - numAlive;
+   mCount = numAlive;
+   return numRemoved;
+}
+
+void ParticleStore::updateRange( U32 start, U32 count, F32 dt, const Point3F &wind, const Point3F &offset,
+                                 const LinearColorF &fadeColor, F32 fadeSize )
+{
+   AssertFatal( start + count <= mCount, "ParticleStore::updateRange - Range out of bounds!" );
+
+   particle_integrate( mStreams, start, count, dt, wind, offset );
+   particle_update_keys( mStreams, start, count, mKeys.address(), fadeColor, fadeSize );
+}
+
+void ParticleStore::updateKeys( U32 start, U32 count, const LinearColorF &fadeColor, F32 fadeSize )
+{
+   AssertFatal( start + count <= mCount, "ParticleStore::updateKeys - Range out of bounds!" );
+
+   particle_update_keys( mStreams, start, count, mKeys.address(), fadeColor, fadeSize );
+}
+
+//-----------------------------------------------------------------------------
+
+/// Updates a contiguous range of the particles for update().
+struct ParticleStore::UpdateWorkItem : public ThreadPoolBatch::Item
+{
+   ParticleStore *mStore;
+   U32 mStart;
+   U32 mCount;
+   F32 mDt;
+   Point3F mWind;
+   Point3F mOffset;
+   LinearColorF mFadeColor;
+   F32 mFadeSize;
+
+   UpdateWorkItem( ParticleStore *store, U32 start, U32 count, F32 dt, const Point3F &wind,
+                   const Point3F &offset, const LinearColorF &fadeColor, F32 fadeSize )
+      :  mStore( store ),
+         mStart( start ),
+         mCount( count ),
+         mDt( dt ),
+         mWind( wind ),
+         mOffset( offset ),
+         mFadeColor( fadeColor ),
+         mFadeSize( fadeSize ) {}
+
+protected:
+
+   virtual void executeItem()
+   {
+      mStore->updateRange( mStart, mCount, mDt, mWind, mOffset, mFadeColor, mFadeSize );
+   }
+};
+
+void ParticleStore::update( F32 dt, const Point3F &wind, const Point3F &offset,
+                            const LinearColorF &fadeColor, F32 fadeSize )
+{
+   PROFILE_SCOPE( ParticleStore_update );
+
+   if ( mCount == 0 )
+      return;
+
+   U32 numRanges = 1;
+   if ( smParallelUpdateThreshold != 0 && mCount >= smParallelUpdateThreshold )
+   {
+      // One range per worker plus one for this thread, but don't cut
+      // the particles into slivers that aren't worth the overhead.
+      ThreadPool &pool = ThreadPool::GLOBAL();
+      const U32 minParticlesPerRange = getMax( smParallelUpdateThreshold / 2, 1U );
+      numRanges = mClamp( mCount / minParticlesPerRange, 1, pool.getNumThreads() + 1 );
+   }
+
+   if ( numRanges < 2 )
+   {
+      updateRange( 0, mCount, dt, wind, offset, fadeColor, fadeSize );
+      return;
+   }
+
+   Vector< ThreadSafeRef< UpdateWorkItem > > items;
+   items.setSize( numRanges );
+
+   ThreadPoolBatch batch;
+
+   // Keep the ranges a multiple of four so only the
+   // last one runs through the scalar remainder.
+   const U32 particlesPerRange = _alignCapacity( mCount / numRanges );
+   U32 start = 0;
+   for ( U32 i = 0; i < numRanges && start < mCount; i++, start += particlesPerRange )
+   {
+      const U32 count = ( i == numRanges - 1 ) ? mCount - start : getMin( particlesPerRange, mCount - start );
+      items[i] = new UpdateWorkItem( this, start, count, dt, wind, offset, fadeColor, fadeSize );
+      batch.add( items[i] );
+   }
+
+   batch.wait();
+}
+
+//-----------------------------------------------------------------------------
+
+void ParticleStore::buildBillboards( const U32 *order, U32 count, const MatrixF &camView,
+                                     const LinearColorF &colorScale, GFXVertexPCT *outVerts ) const
+{
+   PROFILE_SCOPE( ParticleStore_buildBillboards );
+
+   // The billboard corners lie in the x/z plane of the camera.
+   Point3F right, up;
+   camView.getColumn( 0, &right );
+   camView.getColumn( 2, &up );
+
+   particle_build_billboards( mStreams, order, count, mKeys.address(), right, up, colorScale, outVerts );
+}
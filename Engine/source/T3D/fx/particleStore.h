@@ -0,0 +1,191 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _PARTICLESTORE_H_
+#define _PARTICLESTORE_H_
+
+#ifndef _PARTICLE_H_
+#include "T3D/fx/particle.h"
+#endif
+#ifndef _GFXVERTEXTYPES_H_
+#include "gfx/gfxVertexTypes.h"
+#endif
+
+class MatrixF;
+
+
+/// Pointers to the per-particle streams of a ParticleStore.
+///
+/// Every stream holds one entry per particle, so particle i is made
+/// up of the i'th entry of each of them.  This is what the particle
+/// kernels in particleIntrinsics.h work on.
+struct ParticleStreams
+{
+   F32 *posX, *posY, *posZ;            ///< World position.
+   F32 *localX, *localY, *localZ;      ///< Position before the emitter offset is applied.
+   F32 *velX, *velY, *velZ;
+   F32 *accX, *accY, *accZ;            ///< Constant acceleration.
+   F32 *orientX, *orientY, *orientZ;   ///< Ejection axis for oriented particles.
+
+   F32 *drag;                          ///< ParticleData::dragCoefficient
+   F32 *wind;                          ///< ParticleData::windCoefficient
+   F32 *gravity;                       ///< ParticleData::gravityCoefficient
+   F32 *constrain;                     ///< 1 if the position follows the emitter, else 0.
+
+   F32 *red, *green, *blue, *alpha;
+   F32 *size;
+   F32 *spinSpeed;
+
+   U32 *age;                           ///< Current age in ms.
+   U32 *lifetime;                      ///< Total lifetime in ms, always at least 1.
+   U32 *keySet;                        ///< Index of the ParticleKeys used for color and size.
+};
+
+/// The color and size keys of one ParticleData as seen by an emitter.
+///
+/// The emitter resolves its color and size overrides and the datablock's
+/// size bias into these once, rather than for every particle update.
+struct ParticleKeys
+{
+   F32 times[ ParticleData::PDC_NUM_KEYS ];
+   LinearColorF colors[ ParticleData::PDC_NUM_KEYS ];
+   F32 sizes[ ParticleData::PDC_NUM_KEYS ];
+
+   /// Billboard texture coordinates.
+   Point2F texCoords[4];
+
+   void set( const ParticleData *data, const LinearColorF *colorOverride, const F32 *sizeOverride );
+};
+
+
+/// Structure of arrays storage for the particles of one emitter.
+///
+/// Particles are kept packed at the front of the streams in the order
+/// they were added, so the newest particle is always the last one.
+///
+/// Integration, key interpolation and billboard generation go through
+/// the vectorized kernels in particleIntrinsics.h.  Large stores split
+/// their update across the global thread pool.
+class ParticleStore
+{
+public:
+
+   /// Minimum number of particles before update() is split across the
+   /// worker threads of the global thread pool.  0 never splits.
+   static U32 smParallelUpdateThreshold;
+
+   ParticleStore();
+   ~ParticleStore();
+
+   /// Number of live particles.
+   U32 size() const { return mCount; }
+
+   bool empty() const { return mCount == 0; }
+
+   U32 getCapacity() const { return mCapacity; }
+
+   /// Make room for at least the given number of particles.
+   void reserve( U32 capacity );
+
+   /// Remove all particles.  The memory is kept.
+   void clear() { mCount = 0; }
+
+   /// Set the keys for a key set index.  Emitters use one key
+   /// set per entry in ParticleEmitterData::particleDataBlocks.
+   void setKeys( U32 keySet, const ParticleKeys &keys );
+
+   U32 getNumKeySets() const { return mKeys.size(); }
+   const ParticleKeys& getKeys( U32 keySet ) const { return mKeys[keySet]; }
+
+   /// Append a particle and return its index.
+   U32 add( const Particle &part, U32 keySet );
+
+   /// Read a particle back into the AoS representation.
+   void get( U32 index, Particle *outPart ) const;
+
+   /// Remove a particle.  The particles after it move down one slot.
+   void remove( U32 index );
+
+   ParticleData* getDataBlock( U32 index ) const { return mDataBlocks[index]; }
+
+   const ParticleStreams& getStreams() const { return mStreams; }
+
+   /// Add to the age of every particle and remove the ones which
+   /// have outlived their lifetime.
+   /// @return The number of particles removed.
+   U32 advanceAge( U32 ms );
+
+   /// Integrate the velocities and positions and interpolate the keys of
+   /// a range of particles.
+   ///
+   /// @param start      First particle to update.
+   /// @param count      Number of particles to update.
+   /// @param dt         Time step in seconds.
+   /// @param wind       Wind velocity.
+   /// @param offset     Emitter position for constrained particles.
+   /// @param fadeColor  Scale applied to the interpolated color.
+   /// @param fadeSize   Scale applied to the interpolated size.
+   void updateRange( U32 start, U32 count, F32 dt, const Point3F &wind, const Point3F &offset,
+                     const LinearColorF &fadeColor, F32 fadeSize );
+
+   /// Update all particles, splitting the work across the thread pool
+   /// when there are at least smParallelUpdateThreshold of them.
+   /// @see updateRange
+   void update( F32 dt, const Point3F &wind, const Point3F &offset,
+                const LinearColorF &fadeColor, F32 fadeSize );
+
+   /// Interpolate the keys of a range of particles without moving them.
+   void updateKeys( U32 start, U32 count, const LinearColorF &fadeColor, F32 fadeSize );
+
+   /// Write camera facing quads for the particles.
+   ///
+   /// @param order       Indices of the particles to write in order.
+   /// @param count       Number of entries in order.
+   /// @param camView     The inverse of the camera rotation.
+   /// @param colorScale  Scale applied to the particle colors; used to
+   ///   blend in the ambient light.
+   /// @param outVerts    Receives four vertices per particle.
+   void buildBillboards( const U32 *order, U32 count, const MatrixF &camView,
+                         const LinearColorF &colorScale, GFXVertexPCT *outVerts ) const;
+
+protected:
+
+   ParticleStreams mStreams;
+
+   /// The datablock of each particle.
+   ParticleData **mDataBlocks;
+
+   /// The single allocation which holds all the streams.
+   void *mMemory;
+
+   U32 mCount;
+   U32 mCapacity;
+
+   Vector<ParticleKeys> mKeys;
+
+   /// Copy every stream entry of a particle to another slot.
+   void _copyParticle( U32 from, U32 to );
+
+   struct UpdateWorkItem;
+};
+
+#endif // _PARTICLESTORE_H_
@@ -0,0 +1,267 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2014 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "T3D/fx/groundCover.h"
+#include "terrain/terrData.h"
+#include "terrain/terrFile.h"
+#include "scene/sceneContainer.h"
+#include "gfx/bitmap/gBitmap.h"
+#include "core/resourceManager.h"
+#include "console/console.h"
+
+/// Exposes the cell grid of a GroundCover which lives
+/// in a private container rather than a scene.
+class GroundCoverTestObject : public GroundCover
+{
+public:
+
+   GroundCoverTestObject( SceneContainer *container )
+   {
+      mContainer = container;
+
+      mRadius = 100.0f;
+      mGridSize = 9;
+      mMaxPlacement = 20000;
+
+      // Skip _initialize() which needs a device for the
+      // primitive buffer and only set up what generation uses.
+      const U32 cells = mGridSize * mGridSize;
+      mCellGrid.setSize( cells );
+      dMemset( mCellGrid.address(), 0, mCellGrid.memSize() );
+      mScratchGrid.setSize( cells );
+      mLastPlacementCount = getMax( ( (F32)mMaxPlacement * smDensityScale ) / F32( cells ), 0.0f );
+
+      mNormalizedProbability[0] = 0.7f;
+      mNormalizedProbability[1] = 0.3f;
+      mMaxClumpCount[1] = 4;
+      mClumpRadius[1] = 2.0f;
+      mMaxSlope[1] = 30.0f;
+   }
+
+   ~GroundCoverTestObject()
+   {
+      _deleteCells();
+      mContainer = NULL;
+   }
+
+   void update( const Point3F &pos )
+   {
+      MatrixF cameraMat( true );
+      cameraMat.setPosition( pos );
+      mCuller.set( false, -0.1f, 0.1f, 0.075f, -0.075f, 0.1f, 1000.0f, cameraMat );
+      _updateCoverGrid( mCuller );
+   }
+
+   U32 getNumCells() const
+   {
+      U32 count = 0;
+      for ( S32 i = 0; i < mCellGrid.size(); i++ )
+         count += mCellGrid[i] != NULL;
+      return count;
+   }
+
+   bool hasCell( U32 i ) const { return mCellGrid[i] != NULL; }
+   U32 getGridCellCount() const { return mCellGrid.size(); }
+   U32 getNumPrefetched() const { return mPrefetchCells.size(); }
+};
+
+FIXTURE(GroundCover)
+{
+public:
+   SceneContainer *container;
+   TerrainBlock *terrain;
+   String fileName;
+
+   bool oldParallel;
+   bool oldPrefetch;
+   S32 oldMaxCells;
+
+   void SetUp()
+   {
+      container = new SceneContainer();
+      terrain = NULL;
+
+      oldParallel = Con::getBoolVariable( "$GroundCover::parallelGeneration" );
+      oldPrefetch = Con::getBoolVariable( "$GroundCover::prefetchCells" );
+      oldMaxCells = Con::getIntVariable( "$GroundCover::maxCellsPerUpdate" );
+   }
+
+   void TearDown()
+   {
+      Con::setBoolVariable( "$GroundCover::parallelGeneration", oldParallel );
+      Con::setBoolVariable( "$GroundCover::prefetchCells", oldPrefetch );
+      Con::setIntVariable( "$GroundCover::maxCellsPerUpdate", oldMaxCells );
+
+      if ( terrain )
+         container->removeObject( terrain );
+      SAFE_DELETE( terrain );
+      SAFE_DELETE( container );
+      if ( fileName.isNotEmpty() )
+         dFileDelete( fileName );
+   }
+
+   /// Creates a rolling terrain in the test container.
+   void createTerrain( U32 size )
+   {
+      GBitmap heightMap( size, size, false, GFXFormatL16 );
+      for ( U32 y = 0; y < size; y++ )
+      {
+         U16 *row = (U16*)heightMap.getAddress( 0, y );
+         for ( U32 x = 0; x < size; x++ )
+         {
+            const F32 h = 0.5f + 0.25f * mSin( x * 0.05f ) * mCos( y * 0.03f );
+            row[x] = convertHostToBEndian( (U16)( h * U16_MAX ) );
+         }
+      }
+
+      Vector<U8> layerMap;
+      layerMap.setSize( size * size );
+      dMemset( layerMap.address(), 0, layerMap.memSize() );
+
+      TerrainFile *file = new TerrainFile;
+      file->import( heightMap, 100.0f, layerMap, Vector<String>(), false );
+
+      fileName = String::ToString( "groundCoverTest%d.ter", size );
+      ASSERT_TRUE( file->save( fileName ) );
+      delete file;
+
+      Resource<TerrainFile> res = ResourceManager::get().load( fileName );
+      ASSERT_TRUE( res != NULL );
+
+      terrain = new TerrainBlock();
+      terrain->setFile( res );
+      container->addObject( terrain );
+   }
+};
+
+TEST_FIX(GroundCover, BudgetLimitsGeneration)
+{
+   createTerrain( 1024 );
+   ASSERT_TRUE( terrain != NULL );
+
+   Con::setIntVariable( "$GroundCover::maxCellsPerUpdate", 2 );
+   Con::setBoolVariable( "$GroundCover::prefetchCells", false );
+
+   GroundCoverTestObject cover( container );
+
+   // The first update is a warp which generates
+   // all the visible cells regardless of budget.
+   Con::setIntVariable( "$GroundCover::generatedCells", 0 );
+   cover.update( Point3F( 200.0f, 200.0f, 50.0f ) );
+   const U32 visibleCells = cover.getNumCells();
+   EXPECT_GT( visibleCells, 0 );
+   EXPECT_EQ( (S32)visibleCells, Con::getIntVariable( "$GroundCover::generatedCells" ) );
+
+   // Moving a single cell at a time stays within budget.
+   const F32 cellSize = 200.0f / 8.0f;
+   for ( U32 i = 1; i <= 4; i++ )
+   {
+      Con::setIntVariable( "$GroundCover::generatedCells", 0 );
+      cover.update( Point3F( 200.0f, 200.0f + cellSize * i, 50.0f ) );
+      EXPECT_LE( Con::getIntVariable( "$GroundCover::generatedCells" ), 2 );
+   }
+
+   // Standing still fills in the rest.
+   for ( U32 i = 0; i < 40; i++ )
+      cover.update( Point3F( 200.0f, 200.0f + cellSize * 4, 50.0f ) );
+   EXPECT_EQ( visibleCells, cover.getNumCells() );
+}
+
+TEST_FIX(GroundCover, ParallelMatchesSerial)
+{
+   createTerrain( 1024 );
+   ASSERT_TRUE( terrain != NULL );
+
+   Con::setIntVariable( "$GroundCover::maxCellsPerUpdate", 4 );
+   Con::setBoolVariable( "$GroundCover::prefetchCells", true );
+
+   GroundCoverTestObject serial( container );
+   GroundCoverTestObject parallel( container );
+
+   for ( U32 frame = 0; frame < 120; frame++ )
+   {
+      const Point3F pos( 300.0f, 100.0f + frame * 5.0f, 50.0f );
+
+      Con::setBoolVariable( "$GroundCover::parallelGeneration", false );
+      serial.update( pos );
+
+      Con::setBoolVariable( "$GroundCover::parallelGeneration", true );
+      parallel.update( pos );
+
+      ASSERT_EQ( serial.getNumCells(), parallel.getNumCells() ) << "frame " << frame;
+      ASSERT_EQ( serial.getNumPrefetched(), parallel.getNumPrefetched() ) << "frame " << frame;
+      for ( U32 i = 0; i < serial.getGridCellCount(); i++ )
+         ASSERT_EQ( serial.hasCell( i ), parallel.hasCell( i ) ) << "frame " << frame << " cell " << i;
+   }
+
+   // Moving forward leaves cells prefetched ahead of us.
+   EXPECT_GT( parallel.getNumPrefetched(), 0 );
+}
+
+TEST_FIX(GroundCover, StressTestFlyThrough)
+{
+   // A fast fly-through in three modes: one serial cell per
+   // update as before, parallel generation, and parallel with
+   // prefetching.  The worst update is the number to watch.
+   createTerrain( 2048 );
+   ASSERT_TRUE( terrain != NULL );
+
+   const U32 numFrames = 250;
+   const F32 speed = 6.0f;
+
+   const char *modeNames[] = { "serial", "parallel", "prefetch" };
+   for ( U32 mode = 0; mode < 3; mode++ )
+   {
+      Con::setBoolVariable( "$GroundCover::parallelGeneration", mode > 0 );
+      Con::setBoolVariable( "$GroundCover::prefetchCells", mode == 2 );
+      Con::setIntVariable( "$GroundCover::maxCellsPerUpdate", mode == 0 ? 1 : 4 );
+
+      GroundCoverTestObject cover( container );
+
+      // Warp in first so that we only measure the movement.
+      cover.update( Point3F( 200.0f, 200.0f, 50.0f ) );
+
+      U32 worstMs = 0;
+      U32 missingCells = 0;
+      U32 generated = 0;
+      const U32 start = Platform::getRealMilliseconds();
+      for ( U32 frame = 1; frame <= numFrames; frame++ )
+      {
+         Con::setIntVariable( "$GroundCover::generatedCells", 0 );
+
+         const U32 frameStart = Platform::getRealMilliseconds();
+         cover.update( Point3F( 200.0f + frame * speed * 0.5f, 200.0f + frame * speed, 50.0f ) );
+         worstMs = getMax( worstMs, Platform::getRealMilliseconds() - frameStart );
+
+         generated += Con::getIntVariable( "$GroundCover::generatedCells" );
+         missingCells += cover.getGridCellCount() - cover.getNumCells();
+      }
+      const U32 totalMs = Platform::getRealMilliseconds() - start;
+
+      Con::printf( "GroundCover: %s fly-through, %d frames, worst %d ms, total %d ms, %d cells generated, %d empty grid cells",
+         modeNames[mode], numFrames, worstMs, totalMs, generated, missingCells );
+   }
+}
+
+#endif
@@ -0,0 +1,242 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2014 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "testing/nullGFXDevice.h"
+#include "T3D/fx/particleBatch.h"
+#include "T3D/fx/particleEmitter.h"
+#include "T3D/fx/particle.h"
+#include "T3D/gameBase/gameProcess.h"
+#include "scene/sceneManager.h"
+#include "scene/sceneRenderState.h"
+#include "renderInstance/renderPassManager.h"
+#include "gfx/gfxDevice.h"
+#include "console/console.h"
+
+/// Counts the particle render instances which reach the bins.
+static U32 gParticleBatchTestDraws = 0;
+
+static void _countParticleDraw(RenderInst *inst)
+{
+   gParticleBatchTestDraws++;
+}
+
+FIXTURE(ParticleBatch)
+{
+public:
+   NullGFXDevice device;
+   ParticleData *particleData;
+   ParticleEmitterData *emitterData;
+   Vector<ParticleEmitter*> emitters;
+   bool oldEnabled;
+
+   void SetUp()
+   {
+      device.create();
+
+      oldEnabled = ParticleBatch::smEnabled;
+
+      String errorStr;
+
+      particleData = new ParticleData();
+      particleData->lifetimeMS = 1000;
+      particleData->lifetimeVarianceMS = 0;
+      particleData->assignName("ParticleBatchTestParticle");
+      particleData->registerObject();
+      particleData->preload(false, errorStr);
+
+      emitterData = new ParticleEmitterData();
+      emitterData->ejectionPeriodMS = 8;
+      emitterData->periodVarianceMS = 0;
+      emitterData->particleString = StringTable->insert("ParticleBatchTestParticle");
+      emitterData->registerObject();
+      emitterData->preload(false, errorStr);
+   }
+
+   void TearDown()
+   {
+      deleteEmitters();
+
+      emitterData->deleteObject();
+      particleData->deleteObject();
+
+      ParticleBatch::smEnabled = oldEnabled;
+
+      device.destroy();
+   }
+
+   void createEmitters(U32 count)
+   {
+      for (U32 i = 0; i < count; i++)
+      {
+         ParticleEmitter *emitter = new ParticleEmitter();
+         emitter->onNewDataBlock(emitterData, false);
+         ASSERT_TRUE(emitter->registerObject());
+         emitters.push_back(emitter);
+      }
+   }
+
+   void deleteEmitters()
+   {
+      for (U32 i = 0; i < emitters.size(); i++)
+         emitters[i]->deleteObject();
+      emitters.clear();
+   }
+
+   /// Emits from each emitter at its spot on a grid.
+   void emit(U32 ms)
+   {
+      for (U32 i = 0; i < emitters.size(); i++)
+      {
+         const Point3F pos(F32(i % 25) * 4.0f - 48.0f, 10.0f + F32(i / 25) * 4.0f, 0.0f);
+         emitters[i]->emitParticles(pos, true, Point3F(0, 0, 1), Point3F::Zero, ms);
+      }
+   }
+};
+
+TEST_FIX(ParticleBatch, JoinAndLeave)
+{
+   // Batches hook into the client scene and process list.
+   if (!gClientSceneGraph || !ClientProcessList::get())
+   {
+      Con::printf("ParticleBatch: no client scene, skipping.");
+      return;
+   }
+
+   ParticleBatch::smEnabled = true;
+   createEmitters(3);
+
+   // Nothing joins before it has particles.
+   EXPECT_TRUE(ParticleBatch::find(emitterData) == NULL);
+
+   emit(100);
+   ParticleBatch *batch = ParticleBatch::find(emitterData);
+   ASSERT_TRUE(batch != NULL);
+   EXPECT_EQ(batch->getNumEmitters(), 3);
+
+   // Sorted emitters draw on their own.
+   emitters[0]->setSortPriority(1);
+   EXPECT_EQ(batch->getNumEmitters(), 2);
+   EXPECT_TRUE(emitters[0]->getSceneManager() != NULL);
+
+   emitters[1]->deleteObject();
+   emitters.erase(1);
+   EXPECT_EQ(batch->getNumEmitters(), 1);
+
+   // The last one out closes the batch.
+   emitters[1]->deleteObject();
+   emitters.erase(1);
+   EXPECT_TRUE(ParticleBatch::find(emitterData) == NULL);
+}
+
+TEST_FIX(ParticleBatch, StressTest500Emitters)
+{
+   // 500 emitters sharing one datablock, rendered with batching
+   // off and on.  Compare the draw counts and the frame times.
+   if (!gClientSceneGraph || !ClientProcessList::get())
+   {
+      Con::printf("ParticleBatch: no client scene, skipping.");
+      return;
+   }
+
+   const U32 numEmitters = 500;
+   const U32 numFrames = 100;
+   const U32 frameMs = 32;
+
+   RenderPassManager *pass = new RenderPassManager();
+   pass->registerObject();
+   pass->getAddSignal(RenderPassManager::RIT_Particle).notify(&_countParticleDraw);
+
+   const RectI viewport(0, 0, 1024, 768);
+   MatrixF cameraMat(true);
+   cameraMat.setPosition(Point3F(0, -40, 10));
+   const Frustum frustum(false, -0.1f, 0.1f, 0.075f, -0.075f, 0.1f, 1000.0f, cameraMat);
+
+   MatrixF worldToCamera(cameraMat);
+   worldToCamera.inverse();
+   MatrixF projection;
+   frustum.getProjectionMatrix(&projection);
+
+   GFX->setWorldMatrix(worldToCamera);
+   GFX->setProjectionMatrix(projection);
+
+   for (U32 mode = 0; mode < 2; mode++)
+   {
+      ParticleBatch::smEnabled = mode == 1;
+      createEmitters(numEmitters);
+
+      // Let the emitters fill up.
+      for (U32 frame = 0; frame < 1000 / frameMs; frame++)
+      {
+         emit(frameMs);
+         ClientProcessList::get()->advanceTime(frameMs);
+      }
+
+      Vector<SceneObject*> objects;
+      ParticleBatch *batch = ParticleBatch::find(emitterData);
+      if (batch)
+         objects.push_back(batch);
+      for (U32 i = 0; i < emitters.size(); i++)
+      {
+         if (emitters[i]->getSceneManager())
+            objects.push_back(emitters[i]);
+      }
+
+      gParticleBatchTestDraws = 0;
+      U32 simMs = 0;
+      U32 renderMs = 0;
+      for (U32 frame = 0; frame < numFrames; frame++)
+      {
+         U32 start = Platform::getRealMilliseconds();
+         emit(frameMs);
+         ClientProcessList::get()->advanceTime(frameMs);
+         simMs += Platform::getRealMilliseconds() - start;
+
+         start = Platform::getRealMilliseconds();
+         SceneRenderState state(gClientSceneGraph, SPT_Diffuse,
+            SceneCameraState(viewport, frustum, worldToCamera, projection), pass, false);
+         state.renderObjects(objects.address(), objects.size());
+         renderMs += Platform::getRealMilliseconds() - start;
+      }
+
+      Con::printf("ParticleBatch %s: %d emitters, %d draws per frame, %.2f ms simulating and %.2f ms preparing draws per frame",
+         mode ? "batched" : "unbatched",
+         numEmitters,
+         gParticleBatchTestDraws / numFrames,
+         F32(simMs) / numFrames,
+         F32(renderMs) / numFrames);
+
+      // Without batching every visible emitter is a draw.
+      if (mode == 1)
+      {
+         EXPECT_TRUE(batch != NULL);
+         EXPECT_LT(gParticleBatchTestDraws / numFrames, numEmitters / 10);
+      }
+
+      deleteEmitters();
+   }
+
+   pass->deleteObject();
+}
+
+#endif
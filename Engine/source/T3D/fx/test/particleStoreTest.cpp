@@ -0,0 +1,371 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2014 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "testing/nullGFXDevice.h"
+#include "T3D/fx/particleStore.h"
+#include "T3D/fx/particleIntrinsics.h"
+#include "T3D/fx/arch/particleIntrinsics.arch.h"
+#include "gfx/gfxDevice.h"
+#include "math/mMatrix.h"
+#include "math/mRandom.h"
+#include "console/console.h"
+
+FIXTURE(ParticleStore)
+{
+public:
+   NullGFXDevice device;
+   ParticleData *data;
+
+   void SetUp()
+   {
+      // The null device sets up the vertex color packing.
+      device.create();
+
+      data = new ParticleData();
+      data->dragCoefficient = 0.5f;
+      data->windCoefficient = 0.3f;
+      data->gravityCoefficient = 0.2f;
+      for (U32 i = 0; i < ParticleData::PDC_NUM_KEYS; i++)
+      {
+         data->times[i] = getMin(i * 0.25f, 1.0f);
+         data->colors[i].set(i / 8.0f, 1.0f - i / 8.0f, 0.5f, 1.0f - i / 16.0f);
+         data->sizes[i] = 1.0f + i;
+      }
+   }
+
+   void TearDown()
+   {
+      delete data;
+
+      device.destroy();
+   }
+
+   /// Sets up two key sets.  The second one runs out of keys
+   /// half way through the lifetime.
+   void setKeys(ParticleStore &store)
+   {
+      ParticleKeys keys;
+      keys.set(data, NULL, NULL);
+      store.setKeys(0, keys);
+
+      keys.times[2] = 0.5f;
+      for (U32 i = 3; i < ParticleData::PDC_NUM_KEYS; i++)
+         keys.times[i] = -1.0f;
+      store.setKeys(1, keys);
+   }
+
+   /// Fill a store with random particles.
+   void fill(ParticleStore &store, U32 count, U32 seed)
+   {
+      MRandomLCG rand(seed);
+      setKeys(store);
+
+      Particle part;
+      part.dataBlock = data;
+      part.orientDir.set(0, 0, 0);
+      for (U32 i = 0; i < count; i++)
+      {
+         part.pos.set(rand.randF(-10, 10), rand.randF(-10, 10), rand.randF(-10, 10));
+         part.pos_local = part.pos;
+         part.vel.set(rand.randF(-5, 5), rand.randF(-5, 5), rand.randF(-5, 5));
+         part.acc.set(0, 0, rand.randF(-1, 1));
+         part.color.set(rand.randF(), rand.randF(), rand.randF(), rand.randF());
+         part.size = rand.randF(0.5f, 4.0f);
+         part.spinSpeed = rand.randF(-180, 180);
+         part.totalLifetime = rand.randI(500, 3000);
+         part.currentAge = rand.randI(0, 500);
+         store.add(part, i % 2);
+      }
+   }
+
+   static void expectStreamsNear(const F32 *a, const F32 *b, U32 count, const char *name)
+   {
+      for (U32 i = 0; i < count; i++)
+      {
+         const F32 tolerance = getMax(mFabs(a[i]), 1.0f) * 1e-4f;
+         ASSERT_NEAR(a[i], b[i], tolerance) << name << " differs at particle " << i;
+      }
+   }
+
+   static void expectStoresNear(const ParticleStore &a, const ParticleStore &b)
+   {
+      ASSERT_EQ(a.size(), b.size());
+      const ParticleStreams &sa = a.getStreams();
+      const ParticleStreams &sb = b.getStreams();
+      expectStreamsNear(sa.posX, sb.posX, a.size(), "posX");
+      expectStreamsNear(sa.posY, sb.posY, a.size(), "posY");
+      expectStreamsNear(sa.posZ, sb.posZ, a.size(), "posZ");
+      expectStreamsNear(sa.velX, sb.velX, a.size(), "velX");
+      expectStreamsNear(sa.velY, sb.velY, a.size(), "velY");
+      expectStreamsNear(sa.velZ, sb.velZ, a.size(), "velZ");
+      expectStreamsNear(sa.red, sb.red, a.size(), "red");
+      expectStreamsNear(sa.green, sb.green, a.size(), "green");
+      expectStreamsNear(sa.blue, sb.blue, a.size(), "blue");
+      expectStreamsNear(sa.alpha, sb.alpha, a.size(), "alpha");
+      expectStreamsNear(sa.size, sb.size, a.size(), "size");
+   }
+};
+
+TEST_FIX(ParticleStore, AddGetRemove)
+{
+   ParticleStore store;
+   setKeys(store);
+
+   Particle part;
+   part.dataBlock = data;
+   for (U32 i = 0; i < 100; i++)
+   {
+      part.pos.set(F32(i), 0, 0);
+      part.spinSpeed = F32(i);
+      part.currentAge = 0;
+      part.totalLifetime = (i % 3 == 0) ? 5 : 100;
+      EXPECT_EQ(store.add(part, 0), i);
+   }
+   EXPECT_EQ(store.size(), 100);
+   EXPECT_GE(store.getCapacity(), 100);
+
+   Particle out;
+   store.get(43, &out);
+   EXPECT_EQ(out.pos.x, 43.0f);
+   EXPECT_EQ(out.totalLifetime, 100);
+   EXPECT_EQ(out.dataBlock, data);
+
+   // Every third particle dies and the survivors keep their order.
+   EXPECT_EQ(store.advanceAge(10), 34);
+   ASSERT_EQ(store.size(), 66);
+   const ParticleStreams &s = store.getStreams();
+   for (U32 i = 0; i < store.size(); i++)
+   {
+      EXPECT_NE(U32(s.spinSpeed[i]) % 3, 0);
+      EXPECT_EQ(s.age[i], 10);
+      if (i > 0)
+         EXPECT_GT(s.spinSpeed[i], s.spinSpeed[i - 1]);
+   }
+
+   store.remove(0);
+   EXPECT_EQ(store.size(), 65);
+   EXPECT_EQ(s.spinSpeed[0], 2.0f);
+
+   store.remove(store.size() - 1);
+   EXPECT_EQ(s.spinSpeed[store.size() - 1], 97.0f);
+
+   store.clear();
+   EXPECT_TRUE(store.empty());
+};
+
+TEST_FIX(ParticleStore, KernelsMatchReference)
+{
+   // Odd count so the SIMD kernels run their remainder too.
+   const U32 count = 1003;
+   const Point3F wind(1.0f, -2.0f, 0.5f);
+   const Point3F offset(3.0f, 4.0f, 5.0f);
+   const LinearColorF fade(0.5f, 0.5f, 0.5f, 0.75f);
+
+   ParticleStore reference, store;
+   fill(reference, count, 1234);
+   fill(store, count, 1234);
+
+   for (U32 step = 0; step < 8; step++)
+   {
+      reference.advanceAge(32);
+      store.advanceAge(32);
+
+      particle_integrate_C(reference.getStreams(), 0, reference.size(), 0.032f, wind, offset);
+      particle_update_keys_C(reference.getStreams(), 0, reference.size(), &reference.getKeys(0), fade, 0.9f);
+      store.updateRange(0, store.size(), 0.032f, wind, offset, fade, 0.9f);
+
+      expectStoresNear(reference, store);
+   }
+};
+
+TEST_FIX(ParticleStore, ParallelUpdateMatches)
+{
+   const U32 count = 20003;
+   const Point3F wind(1.0f, 0.0f, 0.0f);
+
+   ParticleStore serial, parallel;
+   fill(serial, count, 99);
+   fill(parallel, count, 99);
+
+   const U32 oldThreshold = ParticleStore::smParallelUpdateThreshold;
+
+   ParticleStore::smParallelUpdateThreshold = 0;
+   serial.update(0.032f, wind, Point3F::Zero, LinearColorF::WHITE, 1.0f);
+
+   ParticleStore::smParallelUpdateThreshold = 1000;
+   parallel.update(0.032f, wind, Point3F::Zero, LinearColorF::WHITE, 1.0f);
+
+   ParticleStore::smParallelUpdateThreshold = oldThreshold;
+
+   // The ranges fall on the same SIMD boundaries so the
+   // results match exactly.
+   const ParticleStreams &a = serial.getStreams();
+   const ParticleStreams &b = parallel.getStreams();
+   for (U32 i = 0; i < count; i++)
+   {
+      ASSERT_EQ(a.posX[i], b.posX[i]);
+      ASSERT_EQ(a.posZ[i], b.posZ[i]);
+      ASSERT_EQ(a.size[i], b.size[i]);
+      ASSERT_EQ(a.alpha[i], b.alpha[i]);
+   }
+};
+
+TEST_FIX(ParticleStore, BillboardsMatchReference)
+{
+   const U32 count = 37;
+   ParticleStore store;
+   fill(store, count, 7);
+
+   Vector<U32> order;
+   for (U32 i = 0; i < count; i++)
+      order.push_back(count - 1 - i);
+
+   MatrixF camView(EulerF(0.3f, 0.2f, 0.1f));
+   const LinearColorF colorScale(0.5f, 0.75f, 1.0f, 1.0f);
+
+   Vector<GFXVertexPCT> verts;
+   verts.setSize(count * 4);
+   store.buildBillboards(order.address(), count, camView, colorScale, verts.address());
+
+   // The same math as ParticleEmitter::setupBillboard().
+   const Point3F basePoints[4] =
+   {
+      Point3F(-1.0f, 0.0f,  1.0f),
+      Point3F(-1.0f, 0.0f, -1.0f),
+      Point3F( 1.0f, 0.0f, -1.0f),
+      Point3F( 1.0f, 0.0f,  1.0f)
+   };
+   const F32 agedSpinToRadians = (1.0f/1000.0f) * (1.0f/360.0f) * M_PI_F * 2.0f;
+
+   const ParticleStreams &s = store.getStreams();
+   for (U32 n = 0; n < count; n++)
+   {
+      const U32 i = order[n];
+      const ParticleKeys &keys = store.getKeys(s.keySet[i]);
+
+      F32 sy, cy;
+      mSinCos(s.spinSpeed[i] * s.age[i] * agedSpinToRadians, sy, cy);
+
+      LinearColorF color(s.red[i], s.green[i], s.blue[i], s.alpha[i]);
+      color *= colorScale;
+      color.clamp();
+      const GFXVertexColor vertColor(color);
+
+      for (U32 v = 0; v < 4; v++)
+      {
+         Point3F point(cy * basePoints[v].x - sy * basePoints[v].z,
+                       0.0f,
+                       sy * basePoints[v].x + cy * basePoints[v].z);
+         camView.mulV(point);
+         point *= s.size[i] * 0.5f;
+         point += Point3F(s.posX[i], s.posY[i], s.posZ[i]);
+
+         const GFXVertexPCT &vert = verts[n * 4 + v];
+         EXPECT_NEAR(vert.point.x, point.x, 1e-4f);
+         EXPECT_NEAR(vert.point.y, point.y, 1e-4f);
+         EXPECT_NEAR(vert.point.z, point.z, 1e-4f);
+         EXPECT_EQ(vert.color.getPackedColorData(), vertColor.getPackedColorData());
+         EXPECT_EQ(vert.texCoord, keys.texCoords[v]);
+      }
+   }
+};
+
+TEST_FIX(ParticleStore, StressTestUpdate)
+{
+   // Particles per millisecond through aging, integration and
+   // billboard generation: portable kernels, SIMD kernels, then
+   // SIMD kernels split across the thread pool.
+   const U32 count = 100000;
+   const U32 frames = 50;
+   const Point3F wind(1.0f, 0.0f, 0.0f);
+
+   ParticleStore store;
+   Vector<U32> order;
+   order.setSize(count);
+   for (U32 i = 0; i < count; i++)
+      order[i] = count - 1 - i;
+
+   Vector<GFXVertexPCT> verts;
+   verts.setSize(count * 4);
+
+   MatrixF camView(EulerF(0.3f, 0.2f, 0.1f));
+
+   void (*simdIntegrate)(const ParticleStreams&, U32, U32, F32, const Point3F&, const Point3F&) = particle_integrate;
+   void (*simdUpdateKeys)(const ParticleStreams&, U32, U32, const ParticleKeys*, const LinearColorF&, F32) = particle_update_keys;
+   void (*simdBillboards)(const ParticleStreams&, const U32*, U32, const ParticleKeys*, const Point3F&, const Point3F&, const LinearColorF&, GFXVertexPCT*) = particle_build_billboards;
+
+   const U32 oldThreshold = ParticleStore::smParallelUpdateThreshold;
+   const char *names[3] = { "C", "SIMD", "SIMD threaded" };
+
+   for (U32 mode = 0; mode < 3; mode++)
+   {
+      if (mode == 0)
+      {
+         particle_integrate = particle_integrate_C;
+         particle_update_keys = particle_update_keys_C;
+         particle_build_billboards = particle_build_billboards_C;
+      }
+      else
+      {
+         particle_integrate = simdIntegrate;
+         particle_update_keys = simdUpdateKeys;
+         particle_build_billboards = simdBillboards;
+      }
+      ParticleStore::smParallelUpdateThreshold = (mode == 2) ? oldThreshold : 0;
+
+      // Long enough lifetimes that nothing dies during the run.
+      store.clear();
+      fill(store, count, 42);
+      for (U32 i = 0; i < count; i++)
+         store.getStreams().lifetime[i] = 100000;
+
+      U32 updateMs = 0;
+      U32 billboardMs = 0;
+      for (U32 frame = 0; frame < frames; frame++)
+      {
+         U32 start = Platform::getRealMilliseconds();
+         store.advanceAge(32);
+         store.update(0.032f, wind, Point3F::Zero, LinearColorF::WHITE, 1.0f);
+         updateMs += Platform::getRealMilliseconds() - start;
+
+         start = Platform::getRealMilliseconds();
+         store.buildBillboards(order.address(), count, camView, LinearColorF::WHITE, verts.address());
+         billboardMs += Platform::getRealMilliseconds() - start;
+      }
+
+      Con::printf("ParticleStore %s: %.0f particles updated per ms, %.0f billboards per ms",
+         names[mode],
+         F32(count) * frames / getMax(updateMs, 1U),
+         F32(count) * frames / getMax(billboardMs, 1U));
+   }
+
+   particle_integrate = simdIntegrate;
+   particle_update_keys = simdUpdateKeys;
+   particle_build_billboards = simdBillboards;
+   ParticleStore::smParallelUpdateThreshold = oldThreshold;
+
+   EXPECT_EQ(store.size(), count);
+};
+
+#endif
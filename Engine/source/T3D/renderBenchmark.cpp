@@ -0,0 +1,421 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "T3D/renderBenchmark.h"
+
+#include "T3D/gameFunctions.h"
+#include "T3D/gameBase/gameConnection.h"
+#include "scene/sceneManager.h"
+#include "renderInstance/renderPassManager.h"
+#include "renderInstance/renderBinManager.h"
+#include "postFx/postEffectManager.h"
+#include "materials/materialManager.h"
+#include "shaderGen/shaderGen.h"
+#include "gfx/gfxTextureManager.h"
+#include "gfx/gfxTransformSaver.h"
+#include "gfx/gfxCardProfile.h"
+#include "core/stream/fileStream.h"
+#include "console/engineAPI.h"
+
+#include "persistence/rapidjson/prettywriter.h"
+
+
+bool RenderBenchmark::smRecording = false;
+Vector<RenderBenchmark::CameraNode> RenderBenchmark::smRecordedNodes;
+
+RenderBenchmark::RenderBenchmark()
+   :  mCurrentFrame( NULL ),
+      mSize( 0, 0 )
+{
+}
+
+RenderBenchmark::~RenderBenchmark()
+{
+}
+
+bool RenderBenchmark::loadPath( const String &path, Vector<CameraNode> *outNodes )
+{
+   FileStream *stream = FileStream::createAndOpen( path, Torque::FS::File::Read );
+   if ( !stream )
+   {
+      Con::errorf( "RenderBenchmark::loadPath - Could not open '%s'!", path.c_str() );
+      return false;
+   }
+
+   outNodes->clear();
+
+   char line[512];
+   while ( stream->getStatus() == Stream::Ok )
+   {
+      stream->readLine( (U8*)line, sizeof( line ) );
+
+      Point3F pos, axis;
+      F32 angle, fov;
+      if ( dSscanf( line, "%g %g %g %g %g %g %g %g",
+                    &pos.x, &pos.y, &pos.z,
+                    &axis.x, &axis.y, &axis.z, &angle, &fov ) != 8 )
+         continue;
+
+      CameraNode node;
+      AngAxisF( axis, angle ).setMatrix( &node.transform );
+      node.transform.setPosition( pos );
+      node.fov = mDegToRad( fov );
+      outNodes->push_back( node );
+   }
+
+   delete stream;
+   return !outNodes->empty();
+}
+
+bool RenderBenchmark::savePath( const String &path, const Vector<CameraNode> &nodes )
+{
+   FileStream *stream = FileStream::createAndOpen( path, Torque::FS::File::Write );
+   if ( !stream )
+   {
+      Con::errorf( "RenderBenchmark::savePath - Could not open '%s'!", path.c_str() );
+      return false;
+   }
+
+   char line[512];
+   for ( U32 i = 0; i < nodes.size(); i++ )
+   {
+      const CameraNode &node = nodes[i];
+      const Point3F pos = node.transform.getPosition();
+      const AngAxisF aa( node.transform );
+
+      dSprintf( line, sizeof( line ), "%g %g %g %g %g %g %g %g",
+         pos.x, pos.y, pos.z,
+         aa.axis.x, aa.axis.y, aa.axis.z, aa.angle,
+         mRadToDeg( node.fov ) );
+
+      stream->writeLine( (const U8*)line );
+   }
+
+   delete stream;
+   return true;
+}
+
+bool RenderBenchmark::run( const Vector<CameraNode> &nodes, const Point2I &size, U32 framesPerNode )
+{
+   if ( !GFX || !gClientSceneGraph )
+   {
+      Con::errorf( "RenderBenchmark::run - There is no device or client scene!" );
+      return false;
+   }
+
+   if ( size.x <= 0 || size.y <= 0 || nodes.empty() )
+      return false;
+
+   framesPerNode = getMax( framesPerNode, 1U );
+   mSize = size;
+   mFrames.clear();
+
+   // ShaderGen skips the null device unless asked for shaders.  The
+   // materials initialized until now have none, so rebuild them.
+   if ( GFX->getAdapterType() == NullDevice && !SHADERGEN->isInitialized() )
+   {
+      SHADERGEN->enableNullDeviceShaders();
+      MATMGR->flushAndReInitInstances();
+   }
+
+   // Render offscreen so that the results don't depend
+   // on the canvas or window size.
+   GFXTexHandle color( size.x, size.y, GFXFormatR8G8B8A8, &GFXRenderTargetProfile, "RenderBenchmark color" );
+   GFXTexHandle depth( size.x, size.y, GFXFormatD24S8, &GFXZTargetProfile, "RenderBenchmark depth" );
+
+   GFXTextureTargetRef target = GFX->allocRenderToTextureTarget( false );
+   if ( target.isNull() )
+   {
+      Con::errorf( "RenderBenchmark::run - Could not allocate a render target!" );
+      return false;
+   }
+
+   target->attachTexture( GFXTextureTarget::Color0, color );
+   target->attachTexture( GFXTextureTarget::DepthStencil, depth );
+
+   RenderPassManager::getRenderBinSignal().notify( this, &RenderBenchmark::_onRenderBin );
+
+   for ( U32 i = 0; i < nodes.size(); i++ )
+   {
+      mFrames.increment();
+      FrameStats &frame = mFrames.last();
+      frame.node = i;
+      mCurrentFrame = &frame;
+
+      const U32 start = Platform::getRealMilliseconds();
+
+      for ( U32 f = 0; f < framesPerNode; f++ )
+      {
+         // The statistics are the same for every
+         // repeat, so only keep the last one.
+         frame.bins.clear();
+         _renderNode( nodes[i], target );
+      }
+
+      frame.cpuMs = F32( Platform::getRealMilliseconds() - start ) / F32( framesPerNode );
+
+      const GFXDeviceStatistics *stats = GFX->getDeviceStatistics();
+      frame.drawCalls = stats->mDrawCalls;
+      frame.polyCount = stats->mPolyCount;
+      frame.renderTargetChanges = stats->mRenderTargetChanges;
+      frame.stateBlockChanges = stats->mStateBlockChanges;
+      frame.shaderChanges = stats->mShaderChanges;
+      frame.shaderConstBufferUploads = stats->mShaderConstBufferUploads;
+   }
+
+   mCurrentFrame = NULL;
+   RenderPassManager::getRenderBinSignal().remove( this, &RenderBenchmark::_onRenderBin );
+
+   return true;
+}
+
+void RenderBenchmark::_renderNode( const CameraNode &node, GFXTextureTarget *target )
+{
+   PROFILE_SCOPE( RenderBenchmark_RenderNode );
+
+   GFXTransformSaver saver;
+
+   GFX->setActiveRenderTarget( target );
+   GFX->beginScene();
+   GFX->setViewport( RectI( Point2I::Zero, mSize ) );
+   GFX->clear( GFXClearTarget | GFXClearZBuffer | GFXClearStencil, ColorI( 0, 0, 0, 0 ), 1.0f, 0 );
+
+   Frustum frustum;
+   frustum.set( false,
+                node.fov,
+                F32( mSize.x ) / F32( mSize.y ),
+                gClientSceneGraph->getNearClip(),
+                gClientSceneGraph->getVisibleDistance() );
+   GFX->setFrustum( frustum );
+
+   MatrixF worldToCamera = node.transform;
+   worldToCamera.inverse();
+   GFX->setWorldMatrix( worldToCamera );
+
+   gClientSceneGraph->setDisplayTargetResolution( mSize );
+   gClientSceneGraph->setNonClipProjection( GFX->getProjectionMatrix() );
+   PFXMGR->setFrameMatrices( worldToCamera, GFX->getProjectionMatrix() );
+
+   GameRenderWorld();
+
+   GFX->endScene();
+}
+
+void RenderBenchmark::_onRenderBin( RenderBinManager *bin, const SceneRenderState *state, bool preRender )
+{
+   // The element list is complete before the bin renders.
+   if ( !preRender || !mCurrentFrame )
+      return;
+
+   const char *passName = "";
+   if ( bin->getRenderPass() && bin->getRenderPass()->getName() )
+      passName = bin->getRenderPass()->getName();
+
+   const String name = String::ToString( "%s.%s", passName, bin->getRenderInstType().getName().c_str() );
+
+   Vector<BinCount> &bins = mCurrentFrame->bins;
+   for ( U32 i = 0; i < bins.size(); i++ )
+   {
+      if ( bins[i].name == name )
+      {
+         bins[i].count += bin->getElementCount();
+         return;
+      }
+   }
+
+   bins.increment();
+   bins.last().name = name;
+   bins.last().count = bin->getElementCount();
+}
+
+bool RenderBenchmark::writeJSON( const String &path ) const
+{
+   FileStream *stream = FileStream::createAndOpen( path, Torque::FS::File::Write );
+   if ( !stream )
+   {
+      Con::errorf( "RenderBenchmark::writeJSON - Could not open '%s'!", path.c_str() );
+      return false;
+   }
+
+   F32 totalMs = 0.0f;
+   F32 maxMs = 0.0f;
+   S32 maxDrawCalls = 0;
+   for ( U32 i = 0; i < mFrames.size(); i++ )
+   {
+      totalMs += mFrames[i].cpuMs;
+      maxMs = getMax( maxMs, mFrames[i].cpuMs );
+      maxDrawCalls = getMax( maxDrawCalls, mFrames[i].drawCalls );
+   }
+
+   rapidjson::PrettyWriter<FileStream> writer( *stream );
+
+   writer.StartObject();
+
+   writer.Key( "device" );
+   writer.String( GFX->getCardProfiler()->getRendererString().c_str() );
+   writer.Key( "width" );
+   writer.Int( mSize.x );
+   writer.Key( "height" );
+   writer.Int( mSize.y );
+
+   writer.Key( "summary" );
+   writer.StartObject();
+   writer.Key( "frames" );
+   writer.Uint( mFrames.size() );
+   writer.Key( "avgCpuMs" );
+   writer.Double( mFrames.empty() ? 0.0 : totalMs / mFrames.size() );
+   writer.Key( "maxCpuMs" );
+   writer.Double( maxMs );
+   writer.Key( "maxDrawCalls" );
+   writer.Int( maxDrawCalls );
+   writer.EndObject();
+
+   writer.Key( "frames" );
+   writer.StartArray();
+   for ( U32 i = 0; i < mFrames.size(); i++ )
+   {
+      const FrameStats &frame = mFrames[i];
+
+      writer.StartObject();
+      writer.Key( "node" );
+      writer.Uint( frame.node );
+      writer.Key( "cpuMs" );
+      writer.Double( frame.cpuMs );
+      writer.Key( "drawCalls" );
+      writer.Int( frame.drawCalls );
+      writer.Key( "polyCount" );
+      writer.Int( frame.polyCount );
+      writer.Key( "renderTargetChanges" );
+      writer.Int( frame.renderTargetChanges );
+      writer.Key( "stateBlockChanges" );
+      writer.Int( frame.stateBlockChanges );
+      writer.Key( "shaderChanges" );
+      writer.Int( frame.shaderChanges );
+      writer.Key( "shaderConstBufferUploads" );
+      writer.Int( frame.shaderConstBufferUploads );
+
+      writer.Key( "bins" );
+      writer.StartObject();
+      for ( U32 j = 0; j < frame.bins.size(); j++ )
+      {
+         writer.Key( frame.bins[j].name.c_str() );
+         writer.Uint( frame.bins[j].count );
+      }
+      writer.EndObject();
+
+      writer.EndObject();
+   }
+   writer.EndArray();
+
+   writer.EndObject();
+
+   delete stream;
+   return true;
+}
+
+void RenderBenchmark::startRecording()
+{
+   if ( smRecording )
+      return;
+
+   smRecordedNodes.clear();
+   smRecording = true;
+   GFXDevice::getDeviceEventSignal().notify( &RenderBenchmark::_onDeviceEvent );
+}
+
+bool RenderBenchmark::stopRecording( const String &path )
+{
+   if ( !smRecording )
+      return false;
+
+   smRecording = false;
+   GFXDevice::getDeviceEventSignal().remove( &RenderBenchmark::_onDeviceEvent );
+
+   const bool saved = savePath( path, smRecordedNodes );
+   smRecordedNodes.clear();
+   return saved;
+}
+
+bool RenderBenchmark::_onDeviceEvent( GFXDevice::GFXDeviceEventType evt )
+{
+   if ( evt != GFXDevice::deEndOfFrame )
+      return true;
+
+   GameConnection *connection = GameConnection::getConnectionToServer();
+   if ( !connection )
+      return true;
+
+   CameraNode node;
+   F32 fov;
+   if (  connection->getControlCameraTransform( 0.0f, &node.transform ) &&
+         connection->getControlCameraFov( &fov ) )
+   {
+      node.fov = mDegToRad( fov );
+      smRecordedNodes.push_back( node );
+   }
+
+   return true;
+}
+
+DefineEngineFunction( startRenderBenchmarkRecording, void, (),,
+   "@brief Starts recording the client camera every frame for use with runRenderBenchmark().\n\n"
+   "@see stopRenderBenchmarkRecording\n"
+   "@ingroup Rendering\n" )
+{
+   RenderBenchmark::startRecording();
+}
+
+DefineEngineFunction( stopRenderBenchmarkRecording, bool, ( const char *pathFile ),,
+   "@brief Stops recording the client camera and saves the camera path.\n\n"
+   "@param pathFile The camera path file to write.\n"
+   "@return Returns true if the path was saved.\n"
+   "@ingroup Rendering\n" )
+{
+   return RenderBenchmark::stopRecording( pathFile );
+}
+
+DefineEngineFunction( runRenderBenchmark, bool, ( const char *pathFile, const char *outFile, S32 width, S32 height, S32 framesPerNode ), ( 1280, 720, 4 ),
+   "@brief Renders a recorded camera path through the client scene and writes "
+   "the per-frame CPU time and device statistics to a JSON file.\n\n"
+   "This is normally run on the null device to measure the CPU side cost of "
+   "rendering without a GPU.\n\n"
+   "@param pathFile The camera path recorded with startRenderBenchmarkRecording().\n"
+   "@param outFile The JSON file to write.\n"
+   "@param width The width of the offscreen target.\n"
+   "@param height The height of the offscreen target.\n"
+   "@param framesPerNode How many times each node is rendered to average the CPU time.\n"
+   "@return Returns true if the benchmark ran and the results were written.\n"
+   "@ingroup Rendering\n" )
+{
+   Vector<RenderBenchmark::CameraNode> nodes;
+   if ( !RenderBenchmark::loadPath( pathFile, &nodes ) )
+      return false;
+
+   RenderBenchmark benchmark;
+   if ( !benchmark.run( nodes, Point2I( width, height ), framesPerNode ) )
+      return false;
+
+   Con::printf( "runRenderBenchmark - Rendered %d camera nodes.", nodes.size() );
+
+   return benchmark.writeJSON( outFile );
+}
@@ -0,0 +1,150 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _RENDERBENCHMARK_H_
+#define _RENDERBENCHMARK_H_
+
+#ifndef _MMATRIX_H_
+#include "math/mMatrix.h"
+#endif
+#ifndef _MPOINT2_H_
+#include "math/mPoint2.h"
+#endif
+#ifndef _TVECTOR_H_
+#include "core/util/tVector.h"
+#endif
+#ifndef _GFXDEVICE_H_
+#include "gfx/gfxDevice.h"
+#endif
+
+class RenderBinManager;
+class SceneRenderState;
+
+
+/// Renders a recorded camera path through the full render pass pipeline
+/// and collects per-frame CPU time and device statistics.
+///
+/// This is meant to run on the null device so that the CPU side cost of
+/// rendering can be tracked on machines without a GPU.  It works on any
+/// device, but then the timings include the driver.
+///
+/// Camera paths are plain text with one node per line:
+///
+/// @code
+/// px py pz ax ay az angle fov
+/// @endcode
+///
+/// ... where the position and axis/angle come from the camera transform
+/// and the field of view is in degrees.
+///
+/// @see startRenderBenchmarkRecording
+/// @see runRenderBenchmark
+class RenderBenchmark
+{
+public:
+
+   struct CameraNode
+   {
+      MatrixF transform;
+
+      /// The camera field of view in radians.
+      F32 fov;
+   };
+
+   struct BinCount
+   {
+      /// The render pass and bin type: "DiffusePass.Mesh".
+      String name;
+
+      /// Render instances submitted to the bin.
+      U32 count;
+   };
+
+   struct FrameStats
+   {
+      /// The camera node this frame rendered.
+      U32 node;
+
+      /// The average CPU time to render this node.
+      F32 cpuMs;
+
+      S32 drawCalls;
+      S32 polyCount;
+      S32 renderTargetChanges;
+      S32 stateBlockChanges;
+      S32 shaderChanges;
+      S32 shaderConstBufferUploads;
+
+      Vector<BinCount> bins;
+   };
+
+   RenderBenchmark();
+   ~RenderBenchmark();
+
+   /// Reads a camera path file.
+   static bool loadPath( const String &path, Vector<CameraNode> *outNodes );
+
+   /// Writes a camera path file.
+   static bool savePath( const String &path, const Vector<CameraNode> &nodes );
+
+   /// Renders every node in the path at the given resolution
+   /// into an offscreen target.
+   ///
+   /// @param framesPerNode  Each node is rendered this many times and the
+   ///                       CPU time averaged as the platform timer only
+   ///                       has millisecond resolution.
+   bool run( const Vector<CameraNode> &nodes, const Point2I &size, U32 framesPerNode );
+
+   /// Writes the collected frames out as JSON.
+   bool writeJSON( const String &path ) const;
+
+   const Vector<FrameStats>& getFrames() const { return mFrames; }
+
+   /// Starts recording the client camera every frame.
+   static void startRecording();
+
+   /// Stops recording and writes the recorded path to disk.
+   static bool stopRecording( const String &path );
+
+   static bool isRecording() { return smRecording; }
+
+protected:
+
+   Vector<FrameStats> mFrames;
+
+   /// The frame currently being rendered.
+   FrameStats *mCurrentFrame;
+
+   /// The size of the offscreen target.
+   Point2I mSize;
+
+   void _renderNode( const CameraNode &node, GFXTextureTarget *target );
+
+   void _onRenderBin( RenderBinManager *bin, const SceneRenderState *state, bool preRender );
+
+   static bool smRecording;
+   static Vector<CameraNode> smRecordedNodes;
+
+   static bool _onDeviceEvent( GFXDevice::GFXDeviceEventType evt );
+};
+
+#endif // _RENDERBENCHMARK_H_
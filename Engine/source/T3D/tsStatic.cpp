@@ -1277,6 +1277,16 @@ bool TSStatic::buildPolyList(PolyListContext context, AbstractPolyList* polyList
    return true;
 }
 
+bool TSStatic::buildOccluderPolyList(const SceneCameraState& cameraState, AbstractPolyList* polyList, const Box3F& box)
+{
+   // Bounds would hide everything behind the shape's box, so only
+   // real collision meshes are used for occlusion.
+   if (mCollisionType != CollisionMesh && mCollisionType != VisibleMesh)
+      return false;
+
+   return buildPolyList(PLC_Collision, polyList, box, SphereF(box.getCenter(), box.len() * 0.5f));
+}
+
 bool TSStatic::buildExportPolyList(ColladaUtils::ExportData* exportData, const Box3F& box, const SphereF&)
 {
    if (!mShapeInstance)
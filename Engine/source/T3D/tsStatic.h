@@ -161,6 +161,7 @@ protected:
    bool castRayRendered(const Point3F& start, const Point3F& end, RayInfo* info);
    bool buildPolyList(PolyListContext context, AbstractPolyList* polyList, const Box3F& box, const SphereF& sphere);
    bool buildExportPolyList(ColladaUtils::ExportData* exportData, const Box3F& box, const SphereF&);
+   bool buildOccluderPolyList(const SceneCameraState& cameraState, AbstractPolyList* polyList, const Box3F& box);
    void buildConvex(const Box3F& box, Convex* convex);
 
    bool _createShape();
@@ -230,6 +230,9 @@ protected:
   void          afx_emitParticles(const Point3F& start, const Point3F& end, const Point3F& velocity, const U32 numMilliseconds);
   void          preCompute(const MatrixF& mat);
 
+  // AFX emitters adjust and allocate individual particles in the list.
+  virtual bool  usesParticleStore() const { return false; }
+
   virtual void  sub_particleUpdate(Particle*);
   virtual void  sub_preCompute(const MatrixF& mat)=0;
   virtual void  sub_addParticle(const Point3F& pos, const Point3F& vel, const U32 age_offset, S32 part_idx)=0;
@@ -0,0 +1,88 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "collision/occluderPolyList.h"
+
+
+OccluderPolyList::OccluderPolyList()
+{
+   VECTOR_SET_ASSOCIATION(mVertexList);
+   VECTOR_SET_ASSOCIATION(mIndexList);
+   VECTOR_SET_ASSOCIATION(mPolyIndices);
+
+   mCurrObject       = NULL;
+   mBaseMatrix       = MatrixF::Identity;
+   mMatrix           = MatrixF::Identity;
+   mTransformMatrix  = MatrixF::Identity;
+   mScale.set(1.0f, 1.0f, 1.0f);
+
+   mPlaneTransformer.setIdentity();
+
+   mInterestNormalRegistered = false;
+}
+
+void OccluderPolyList::clear()
+{
+   mVertexList.clear();
+   mIndexList.clear();
+   mPolyIndices.clear();
+}
+
+const PlaneF& OccluderPolyList::getIndexedPlane(const U32 index)
+{
+   static const PlaneF dummy( 0, 0, 0, -1 );
+   return dummy;
+}
+
+U32 OccluderPolyList::addPoint( const Point3F &p )
+{
+   // Apply the transform
+   Point3F tp = p * mScale;
+   mMatrix.mulP( tp );
+
+   mVertexList.push_back( tp );
+   return mVertexList.size() - 1;
+}
+
+void OccluderPolyList::begin( BaseMatInstance* material, U32 surfaceKey )
+{
+   mPolyIndices.clear();
+}
+
+void OccluderPolyList::vertex( U32 vi )
+{
+   mPolyIndices.push_back( vi );
+}
+
+void OccluderPolyList::end()
+{
+   // Triangulate the polygon as a fan.
+   for ( U32 i = 2; i < mPolyIndices.size(); i++ )
+   {
+      mIndexList.push_back( mPolyIndices[0] );
+      mIndexList.push_back( mPolyIndices[i - 1] );
+      mIndexList.push_back( mPolyIndices[i] );
+   }
+
+   mPolyIndices.clear();
+}
@@ -0,0 +1,83 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _OCCLUDERPOLYLIST_H_
+#define _OCCLUDERPOLYLIST_H_
+
+#ifndef _ABSTRACTPOLYLIST_H_
+#include "collision/abstractPolyList.h"
+#endif
+
+
+/// A polylist which gathers world-space geometry as an indexed triangle list
+/// for rasterization into a SceneOcclusionBuffer.
+///
+/// Polygons are triangulated as fans.  Materials and planes are ignored.
+///
+/// @see SceneObject::buildOccluderPolyList
+class OccluderPolyList : public AbstractPolyList
+{
+public:
+
+   OccluderPolyList();
+   virtual ~OccluderPolyList() {}
+
+   // AbstractPolyList
+   U32 addPoint(const Point3F& p);
+   U32 addPlane(const PlaneF& plane) { return 0; }
+   void begin(BaseMatInstance* material,U32 surfaceKey);
+   void plane(U32 v1,U32 v2,U32 v3) {}
+   void plane(const PlaneF& p) {}
+   void plane(const U32 index) {}
+   void vertex(U32 vi);
+   void end();
+   const PlaneF& getIndexedPlane(const U32 index);
+
+   /// Clears any captured geometry.
+   void clear();
+
+   /// Returns true if no triangles have been captured.
+   bool isEmpty() const { return mIndexList.empty(); }
+
+   /// Returns the world-space vertices.
+   const Vector<Point3F>& getVertexList() const { return mVertexList; }
+
+   /// Returns three vertex indices for every triangle.
+   const Vector<U32>& getIndexList() const { return mIndexList; }
+
+   /// Returns the number of triangles captured.
+   U32 getNumTriangles() const { return mIndexList.size() / 3; }
+
+protected:
+
+   /// The transformed vertices.
+   Vector<Point3F> mVertexList;
+
+   /// The triangle indices.
+   Vector<U32> mIndexList;
+
+   /// The vertex indices of the polygon currently being built.
+   Vector<U32> mPolyIndices;
+};
+
+
+#endif  // _OCCLUDERPOLYLIST_H_
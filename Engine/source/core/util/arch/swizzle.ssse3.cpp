@@ -0,0 +1,60 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+
+#if (defined( TORQUE_CPU_X86 ) || defined( TORQUE_CPU_X64 ))
+#include "core/util/swizzle.h"
+#include "core/util/arch/swizzle.arch.h"
+#include <tmmintrin.h>
+
+// GCC and Clang only allow the intrinsics of instruction sets that
+// are enabled, so mark the function as needing SSSE3.  It is only
+// installed after checking the CPU supports it.
+#if defined(TORQUE_COMPILER_GCC) || defined(__clang__)
+__attribute__((target("ssse3")))
+#endif
+void swizzleBytes4_SSSE3( void *destination, const void *source, const dsize_t size, const dsize_t *map )
+{
+   U8 *dest = reinterpret_cast<U8 *>( destination );
+   const U8 *src = reinterpret_cast<const U8 *>( source );
+
+   // Shuffle four chunks at a time.
+   const __m128i mask = _mm_setr_epi8(
+      map[0],      map[1],      map[2],      map[3],
+      map[0] + 4,  map[1] + 4,  map[2] + 4,  map[3] + 4,
+      map[0] + 8,  map[1] + 8,  map[2] + 8,  map[3] + 8,
+      map[0] + 12, map[1] + 12, map[2] + 12, map[3] + 12 );
+
+   const dsize_t vectorSize = size & ~dsize_t(15);
+   for ( dsize_t i = 0; i < vectorSize; i += 16 )
+   {
+      const __m128i texels = _mm_loadu_si128( (const __m128i*)( src + i ) );
+      _mm_storeu_si128( (__m128i*)( dest + i ), _mm_shuffle_epi8( texels, mask ) );
+   }
+
+   // Do the remainder in C.
+   if ( vectorSize < size )
+      swizzleBytes4_c( dest + vectorSize, src + vectorSize, size - vectorSize, map );
+}
+
+#endif
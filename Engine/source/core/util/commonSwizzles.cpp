@@ -20,7 +20,34 @@
 // IN THE SOFTWARE.
 //-----------------------------------------------------------------------------
 
+#include "platform/platform.h"
 #include "core/util/swizzle.h"
+#include "core/util/arch/swizzle.arch.h"
+#include "core/module.h"
+
+
+void swizzleBytes4_c( void *destination, const void *source, const dsize_t size, const dsize_t *map )
+{
+   U8 *dest = reinterpret_cast<U8 *>( destination );
+   const U8 *src = reinterpret_cast<const U8 *>( source );
+
+   // Fast divide by 4 since we are assured a proper size.  Read
+   // the whole chunk first in case we're swizzling in place.
+   for( dsize_t i = 0; i < size >> 2; i++ )
+   {
+      const U8 chunk[4] = { src[0], src[1], src[2], src[3] };
+
+      dest[0] = chunk[map[0]];
+      dest[1] = chunk[map[1]];
+      dest[2] = chunk[map[2]];
+      dest[3] = chunk[map[3]];
+
+      src += 4;
+      dest += 4;
+   }
+}
+
+void (*swizzleBytes4)( void *destination, const void *source, const dsize_t size, const dsize_t *map ) = swizzleBytes4_c;
 
 namespace Swizzles
 {
@@ -39,4 +66,30 @@ namespace Swizzles
    Swizzle<U8, 4> abgr( _abgr );
 
    NullSwizzle<U8, 4> null;
-}
\ No newline at end of file
+}
+
+void swizzleInstallLibrary( U32 properties )
+{
+   if ( !properties )
+      // detect what's available
+      properties = Platform::SystemInfo.processor.properties;
+   else
+      // Make sure we're not asking for anything that's not supported
+      properties &= Platform::SystemInfo.processor.properties;
+
+   swizzleBytes4 = swizzleBytes4_c;
+
+#if defined(TORQUE_CPU_X86) || defined(TORQUE_CPU_X64)
+   if ( properties & CPU_PROP_SSE3xt )
+      swizzleBytes4 = swizzleBytes4_SSSE3;
+#endif
+}
+
+MODULE_BEGIN( Swizzles )
+
+   MODULE_INIT
+   {
+      swizzleInstallLibrary();
+   }
+
+MODULE_END;
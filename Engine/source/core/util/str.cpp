@@ -238,7 +238,7 @@ struct StringDataImpl
       StringChar*       mString;       ///< so we can inspect data in a debugger
 #endif
 
-      U32               mRefCount;     ///< String reference count; string is not refcounted if this is U32_MAX (necessary for thread-safety of interned strings and the empty string).
+      volatile U32      mRefCount;     ///< String reference count; string is not refcounted if this is U32_MAX (necessary for thread-safety of interned strings and the empty string).
       U32               mLength;       ///< String length in bytes excluding null.
       mutable U32       mNumChars;     ///< Character count; varies from byte count for strings with multi-bytes characters.
       mutable U32       mHashCase;     ///< case-sensitive hash
@@ -293,18 +293,26 @@ class String::StringData : protected StringDataImpl
          return ( mRefCount > 1 );
       }
 
+      /// The reference count is updated atomically so that strings
+      /// can be shared between the main thread and worker threads.
       void addRef()
       {
          if( mRefCount != U32_MAX )
-            mRefCount ++;
+            dFetchAndAdd( mRefCount, 1 );
       }
 
       void release()
       {
          if( mRefCount != U32_MAX )
          {
-            -- mRefCount;
-            if( !mRefCount )
+            U32 count;
+            do
+            {
+               count = mRefCount;
+            }
+            while( !dCompareAndSwap( mRefCount, count, count - 1 ) );
+
+            if( count == 1 )
                delete this;
          }
       }
@@ -74,6 +74,20 @@ public:
    virtual void ToBuffer( void *destination, const void *source, const dsize_t size ) const;
 };
 
+/// Swizzles 4 byte chunks of memory by the map.  The source and destination
+/// may be the same.  This is replaced with a SIMD version on CPUs which
+/// support it.
+/// @see swizzleInstallLibrary
+extern void (*swizzleBytes4)( void *destination, const void *source, const dsize_t size, const dsize_t *map );
+
+/// The C version of swizzleBytes4.
+extern void swizzleBytes4_c( void *destination, const void *source, const dsize_t size, const dsize_t *map );
+
+/// Installs the fastest swizzle routines for the CPU, limited to the
+/// given CPU_PROP flags.  Zero installs the fastest ones available and
+/// CPU_PROP_C installs the C versions.
+extern void swizzleInstallLibrary( U32 properties = 0 );
+
 // Null swizzle
 template<class T, dsize_t mapLength>
 class NullSwizzle : public Swizzle<T, mapLength>
@@ -152,6 +166,6 @@ inline void Swizzle<T, mapLength>::InPlace( void *memory, const dsize_t size ) c
 //------------------------------------------------------------------------------
 
 // Template specializations for certain swizzles
-//#include "core/util/swizzleSpec.h"
+#include "core/util/swizzleSpec.h"
 
 #endif
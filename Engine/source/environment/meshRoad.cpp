@@ -56,6 +56,7 @@
 #include "T3D/physics/physicsBody.h"
 #include "T3D/physics/physicsCollision.h"
 #include "environment/nodeListManager.h"
+#include "platform/threads/threadPool.h"
 #ifdef TORQUE_AFX_ENABLED
 #include "afx/ce/afxZodiacMgr.h"
 #endif
@@ -866,6 +867,54 @@ F32 MeshRoadSegment::distanceToSurface(const Point3F &pnt) const
    return mPlanes[4].distToPlane( pnt );
 }
 
+//------------------------------------------------------------------------------
+// MeshRoadGeometryWorkItem Class
+//------------------------------------------------------------------------------
+
+/// Builds the vertex and index data of a road on a worker
+/// thread.  It owns a copy of everything it reads, so the road
+/// can keep changing or be deleted while it runs.
+///
+/// @see MeshRoad::_generateVerts
+class MeshRoadGeometryWorkItem : public ThreadPool::WorkItem
+{
+public:
+
+   typedef ThreadPool::WorkItem Parent;
+
+   MeshRoadGeometryWorkItem( const MeshRoad *road )
+      :  mSlices( road->mSlices ),
+         mSegmentCount( road->mSegments.size() ),
+         mProfile( road->mSideProfile ),
+         mWidthSubdivisions( road->mWidthSubdivisions ),
+         mTextureLength( road->mTextureLength )
+   {
+   }
+
+   const MeshRoad::Geometry& getGeometry() const { return mGeometry; }
+
+protected:
+
+   MeshRoadSliceVector mSlices;
+
+   U32 mSegmentCount;
+
+   MeshRoadProfile mProfile;
+
+   S32 mWidthSubdivisions;
+
+   F32 mTextureLength;
+
+   MeshRoad::Geometry mGeometry;
+
+   // ThreadPool::WorkItem
+   virtual void execute()
+   {
+      MeshRoad::_buildGeometry( mSlices, mSegmentCount, mProfile, mWidthSubdivisions, mTextureLength, mGeometry );
+   }
+};
+
+
 //------------------------------------------------------------------------------
 // MeshRoad Class
 //------------------------------------------------------------------------------
@@ -891,6 +940,8 @@ bool MeshRoad::smShowBatches = false;
 bool MeshRoad::smShowSpline = true;
 bool MeshRoad::smShowRoad = true;
 bool MeshRoad::smShowRoadProfile = false;
+bool MeshRoad::smIncrementalRegen = true;
+bool MeshRoad::smAsyncGeometry = true;
 bool MeshRoad::smWireframe = true;
 SimObjectPtr<SimSet> MeshRoad::smServerMeshRoadSet = NULL;
 
@@ -899,7 +950,11 @@ GFXStateBlockRef MeshRoad::smWireframeSB;
 IMPLEMENT_CO_NETOBJECT_V1(MeshRoad);
 
 MeshRoad::MeshRoad()
-: mTextureLength( 5.0f ),
+: mDirtyNodeStart( 1 ),
+  mDirtyNodeEnd( 0 ),
+  mPendingNodeCount( 0 ),
+  mPendingNodeStart( 0 ),
+  mTextureLength( 5.0f ),
   mBreakAngle( 3.0f ),
   mWidthSubdivisions( 0 ),
   mPhysicsRep( NULL )
@@ -981,6 +1036,12 @@ void MeshRoad::consoleInit()
       "@ingroup Editors\n");
    Con::addVariable( "$MeshRoad::showRoadProfile", TypeBool, &MeshRoad::smShowRoadProfile, "If true, the road profile will be shown in the editor.\n"
       "@ingroup Editors\n");
+   Con::addVariable( "$MeshRoad::incrementalRegen", TypeBool, &MeshRoad::smIncrementalRegen, "If true, node edits only regenerate the part of the road "
+      "shaped by the changed nodes rather than the whole road.\n"
+      "@ingroup Editors\n");
+   Con::addVariable( "$MeshRoad::asyncGeometry", TypeBool, &MeshRoad::smAsyncGeometry, "If true, the client builds the road vertex and index buffers on a worker "
+      "thread and swaps them in when done. The old buffers render until then.\n"
+      "@ingroup Editors\n");
 }
 
 bool MeshRoad::addNodeFromField( void *object, const char *index, const char *data )
@@ -1076,6 +1137,8 @@ void MeshRoad::onRemove()
 {
    SAFE_DELETE( mPhysicsRep );
 
+   mGeometryItem = NULL;
+
    mConvexList->nukeList();
 
    for ( U32 i = 0; i < SurfaceCount; i++ )
@@ -1192,6 +1255,9 @@ void MeshRoad::prepRenderImage( SceneRenderState* state )
    if ( mNodes.size() <= 1 )
       return;
 
+   // Swap in the geometry if the worker has finished it.
+   _updateGeometry();
+
    RenderPassManager *renderPass = state->getRenderPass();
    
    // Normal Road RenderInstance
@@ -1441,14 +1507,41 @@ U32 MeshRoad::packUpdate(NetConnection * con, U32 mask, BitStream * stream)
       }
    }
 
-   if ( stream->writeFlag( mask & NodeMask ) )
+   const U32 nodeByteSize = 32; // Based on sending all of a node's parameters
+
+   // Test if we can fit the nodes within the current stream.
+   // We make sure we leave 100 bytes still free in the stream for whatever
+   // may follow us.
+   S32 allowedBytes = stream->getWriteByteSize() - 100;
+
+   // When the nodes were only edited in place just send the range
+   // that changed.  Otherwise, or if the range won't fit, fall back
+   // to sending all of the nodes.
+   const bool hasDirtyNodes = mDirtyNodeStart <= mDirtyNodeEnd && mDirtyNodeEnd < mNodes.size();
+   const U32 dirtyCount = hasDirtyNodes ? mDirtyNodeEnd - mDirtyNodeStart + 1 : 0;
+   const bool sendRange =  ( mask & NodeRangeMask ) && 
+                           !( mask & NodeMask ) && 
+                           hasDirtyNodes &&
+                           (S32)( nodeByteSize * dirtyCount ) < allowedBytes;
+   const bool sendAll = ( mask & NodeMask ) || ( ( mask & NodeRangeMask ) && hasDirtyNodes && !sendRange );
+
+   if ( stream->writeFlag( sendRange ) )
    {
-      const U32 nodeByteSize = 32; // Based on sending all of a node's parameters
+      stream->writeInt( mNodes.size(), 16 );
+      stream->writeInt( mDirtyNodeStart, 16 );
+      stream->writeInt( dirtyCount, 16 );
+
+      for ( U32 i = mDirtyNodeStart; i <= mDirtyNodeEnd; i++ )
+      {
+         mathWrite( *stream, mNodes[i].point );
+         stream->write( mNodes[i].width );
+         stream->write( mNodes[i].depth );
+         mathWrite( *stream, mNodes[i].normal );         
+      }
+   }
 
-      // Test if we can fit all of our nodes within the current stream.
-      // We make sure we leave 100 bytes still free in the stream for whatever
-      // may follow us.
-      S32 allowedBytes = stream->getWriteByteSize() - 100;
+   if ( stream->writeFlag( sendAll ) )
+   {
       if ( stream->writeFlag( (nodeByteSize * mNodes.size()) < allowedBytes ) )
       {
          // All nodes should fit, so send them out now.
@@ -1508,9 +1601,15 @@ void MeshRoad::unpackUpdate(NetConnection * con, BitStream * stream)
    // Unpack Parent.
    Parent::unpackUpdate(con, stream);
 
+   // Set if anything other than an in place node
+   // edit requires the whole road to be regenerated.
+   bool fullUpdate = false;
+
    // MeshRoadMask
    if(stream->readFlag())
    {
+      fullUpdate = true;
+
       MatrixF		ObjectMatrix;
       stream->readAffineTransform(&ObjectMatrix);
       Parent::setTransform(ObjectMatrix);
@@ -1532,6 +1631,8 @@ void MeshRoad::unpackUpdate(NetConnection * con, BitStream * stream)
    // ProfileMask
    if(stream->readFlag())
    {
+      fullUpdate = true;
+
       Point3F pos;
 
       mSideProfile.mNodes.clear();
@@ -1555,9 +1656,50 @@ void MeshRoad::unpackUpdate(NetConnection * con, BitStream * stream)
       mSideProfile.generateNormals();
    }
 
+   // NodeRangeMask
+   bool hasRange = false;
+   U32 rangeStart = 0;
+   U32 rangeCount = 0;
+   if ( stream->readFlag() )
+   {
+      U32 nodeCount = stream->readInt( 16 );
+      rangeStart = stream->readInt( 16 );
+      rangeCount = stream->readInt( 16 );
+
+      MeshRoadNodeVector nodes;
+      nodes.setSize( rangeCount );
+      for ( U32 i = 0; i < rangeCount; i++ )
+      {
+         mathRead( *stream, &nodes[i].point );
+         stream->read( &nodes[i].width );   
+         stream->read( &nodes[i].depth );
+         mathRead( *stream, &nodes[i].normal );
+      }
+
+      if ( nodeCount == mNodes.size() && rangeStart + rangeCount <= nodeCount )
+      {
+         for ( U32 i = 0; i < rangeCount; i++ )
+            mNodes[rangeStart + i] = nodes[i];
+
+         hasRange = rangeCount > 0;
+      }
+      else
+      {
+         // The range was made after a change in node count, so the
+         // full node list is still on its way as events.  Hold on to
+         // the range and apply it over the list once it arrives.
+         mPendingNodeCount = nodeCount;
+         mPendingNodeStart = rangeStart;
+         mPendingNodes = nodes;
+      }
+   }
+
    // NodeMask
    if ( stream->readFlag() )
    {
+      fullUpdate = true;
+      mPendingNodes.clear();
+
       if (stream->readFlag())
       {
          // Nodes have been passed in this update
@@ -1602,8 +1744,18 @@ void MeshRoad::unpackUpdate(NetConnection * con, BitStream * stream)
       }
    }
 
-   if ( stream->readFlag() && isProperlyAdded() )   
-      _regenerate();
+   // RegenMask
+   const bool regen = stream->readFlag();
+
+   if ( isProperlyAdded() )
+   {
+      // A node range on its own only needs the spans
+      // it shapes regenerated.
+      if ( hasRange && !fullUpdate )
+         _regenerateNodes( rangeStart, rangeStart + rangeCount - 1 );
+      else if ( regen || hasRange )
+         _regenerate();
+   }
 }
 
 void MeshRoad::setTransform( const MatrixF &mat )
@@ -2316,11 +2468,8 @@ void MeshRoad::_regenerate()
       getSceneManager()->notifyObjectDirty( this );
 }
 
-void MeshRoad::_generateSlices()
-{      
-   if ( mNodes.size() < 2 )
-      return;
-
+void MeshRoad::_initSpline( CatmullRom<MeshRoadSplineNode> &spline ) const
+{
    // Create the spline, initialized with the MeshRoadNode(s)
    U32 nodeCount = mNodes.size();
    MeshRoadSplineNode *splineNodes = new MeshRoadSplineNode[nodeCount];
@@ -2338,74 +2487,207 @@ void MeshRoad::_generateSlices()
       splineNode.normal = node.normal;
    }
 
-   CatmullRom<MeshRoadSplineNode> spline;
    spline.initialize( nodeCount, splineNodes );
    delete [] splineNodes;
+}
+
+void MeshRoad::_generateSpanSlices(  CatmullRom<MeshRoadSplineNode> &spline,
+                                       U32 i,
+                                       MeshRoadSplineNode &lastBreakNode,
+                                       VectorF &lastBreakVector,
+                                       MeshRoadSliceVector &outSlices ) const
+{
+   const U32 nodeCount = mNodes.size();
+
+   MeshRoadSlice slice;
+
+   F32 t1 = spline.getTime(i);
+   F32 t0 = spline.getTime(i-1);
+   
+   F32 segLength = spline.arcLength( t0, t1 );
+
+   U32 numSegments = mCeil( segLength / MIN_METERS_PER_SEGMENT );
+   numSegments = getMax( numSegments, (U32)1 );
+   F32 tstep = ( t1 - t0 ) / numSegments; 
+
+   U32 startIdx = 0;
+   U32 endIdx = ( i == nodeCount - 1 ) ? numSegments + 1 : numSegments;
+
+   for ( U32 j = startIdx; j < endIdx; j++ )
+   {
+      F32 t = t0 + tstep * j;
+      MeshRoadSplineNode splineNode = spline.evaluate(t);
+
+      VectorF toNodeVec = splineNode.getPosition() - lastBreakNode.getPosition();
+      toNodeVec.normalizeSafe();
+
+      if ( lastBreakVector.isZero() )
+         lastBreakVector = toNodeVec;
+
+      F32 angle = mRadToDeg( mAcos( mDot( toNodeVec, lastBreakVector ) ) );
+
+      if ( j == startIdx || 
+         ( j == endIdx - 1 && i == nodeCount - 1 ) ||
+           angle > mBreakAngle )
+      {
+         // Push back a spline node
+         slice.p1.set( splineNode.x, splineNode.y, splineNode.z );            
+         slice.width = splineNode.width;
+         slice.depth = splineNode.depth;
+         slice.normal = splineNode.normal;   
+         slice.normal.normalize();
+         slice.parentNodeIdx = i-1;
+         slice.t = t;
+         outSlices.push_back( slice );         
+
+         lastBreakVector = splineNode.getPosition() - lastBreakNode.getPosition();
+         lastBreakVector.normalizeSafe();
+
+         lastBreakNode = splineNode;
+      }          
+   }
+}
+
+void MeshRoad::_generateSlices()
+{      
+   if ( mNodes.size() < 2 )
+      return;
+
+   const U32 nodeCount = mNodes.size();
+
+   CatmullRom<MeshRoadSplineNode> spline;
+   _initSpline( spline );
 
    mSlices.clear();
-      
+   mSpanSlices.setSize( nodeCount );
+   mSpanBreakNodes.setSize( nodeCount );
+   mSpanBreakVectors.setSize( nodeCount );
+
    VectorF lastBreakVector(0,0,0);      
-   MeshRoadSlice slice;
    MeshRoadSplineNode lastBreakNode;
    lastBreakNode = spline.evaluate(0.0f);
 
-   for ( U32 i = 1; i < mNodes.size(); i++ )
+   mSpanBreakNodes[0] = lastBreakNode;
+   mSpanBreakVectors[0] = lastBreakVector;
+
+   for ( U32 i = 1; i < nodeCount; i++ )
    {
-      F32 t1 = spline.getTime(i);
-      F32 t0 = spline.getTime(i-1);
-      
-      F32 segLength = spline.arcLength( t0, t1 );
+      mSpanSlices[i-1] = mSlices.size();
+      _generateSpanSlices( spline, i, lastBreakNode, lastBreakVector, mSlices );
+      mSpanBreakNodes[i] = lastBreakNode;
+      mSpanBreakVectors[i] = lastBreakVector;
+   }
 
-      U32 numSegments = mCeil( segLength / MIN_METERS_PER_SEGMENT );
-      numSegments = getMax( numSegments, (U32)1 );
-      F32 tstep = ( t1 - t0 ) / numSegments; 
+   mSpanSlices[nodeCount-1] = mSlices.size();
 
-      U32 startIdx = 0;
-      U32 endIdx = ( i == nodeCount - 1 ) ? numSegments + 1 : numSegments;
+   _finishSlices( 0, mSlices.size() );
+   _updateSliceBounds();
 
-      for ( U32 j = startIdx; j < endIdx; j++ )
-      {
-         F32 t = t0 + tstep * j;
-         MeshRoadSplineNode splineNode = spline.evaluate(t);
+   _generateSegments();   
+}
+
+void MeshRoad::_regenerateNodes( U32 start, U32 end )
+{
+   const U32 nodeCount = mNodes.size();
+
+   // The first node sets our transform and can drive the profile
+   // depth, and a change in the node count shifts every span after
+   // it, so those need the whole road regenerated.
+   if (  !smIncrementalRegen ||
+         start == 0 || 
+         start > end ||
+         end >= nodeCount ||
+         mSlices.empty() ||
+         mSpanSlices.size() != nodeCount )
+   {
+      _regenerate();
+      return;
+   }
 
-         VectorF toNodeVec = splineNode.getPosition() - lastBreakNode.getPosition();
-         toNodeVec.normalizeSafe();
+   CatmullRom<MeshRoadSplineNode> spline;
+   _initSpline( spline );
 
-         if ( lastBreakVector.isZero() )
-            lastBreakVector = toNodeVec;
+   // A span is shaped by the two nodes on either side of it, so
+   // a node change reaches from one span before it to two after.
+   const U32 firstSpan = getMax( start, (U32)2 ) - 1;
+   const U32 lastDirtySpan = getMin( end + 2, nodeCount - 1 );
 
-         F32 angle = mRadToDeg( mAcos( mDot( toNodeVec, lastBreakVector ) ) );
+   MeshRoadSplineNode lastBreakNode = mSpanBreakNodes[firstSpan-1];
+   VectorF lastBreakVector = mSpanBreakVectors[firstSpan-1];
 
-         if ( j == startIdx || 
-            ( j == endIdx - 1 && i == mNodes.size() - 1 ) ||
-              angle > mBreakAngle )
-         {
-            // Push back a spline node
-            slice.p1.set( splineNode.x, splineNode.y, splineNode.z );            
-            slice.width = splineNode.width;
-            slice.depth = splineNode.depth;
-            slice.normal = splineNode.normal;   
-            slice.normal.normalize();
-            slice.parentNodeIdx = i-1;
-            slice.t = t;
-            mSlices.push_back( slice );         
-
-            lastBreakVector = splineNode.getPosition() - lastBreakNode.getPosition();
-            lastBreakVector.normalizeSafe();
-
-            lastBreakNode = splineNode;
-         }          
-      }
+   MeshRoadSliceVector newSlices;
+   Vector<U32> newSpanSlices;
+
+   // Keep going past the dirty spans until the break state
+   // settles back to what it was, after which the old slices
+   // downstream are still valid.
+   U32 lastSpan = firstSpan;
+   for ( ; lastSpan < nodeCount; lastSpan++ )
+   {
+      newSpanSlices.push_back( newSlices.size() );
+      _generateSpanSlices( spline, lastSpan, lastBreakNode, lastBreakVector, newSlices );
+
+      const bool settled = 
+         lastSpan >= lastDirtySpan &&
+         ( lastBreakNode.getPosition() - mSpanBreakNodes[lastSpan].getPosition() ).lenSquared() < 1e-6f &&
+         ( lastBreakVector - mSpanBreakVectors[lastSpan] ).lenSquared() < 1e-8f;
+
+      mSpanBreakNodes[lastSpan] = lastBreakNode;
+      mSpanBreakVectors[lastSpan] = lastBreakVector;
+
+      if ( settled )
+         break;
    }
-   
+
+   lastSpan = getMin( lastSpan, nodeCount - 1 );
+
+   // Splice the new slices in place of the old ones.  The untouched
+   // slices keep the spline time they were generated with, which is
+   // only used while generating.
+   const U32 sliceStart = mSpanSlices[firstSpan-1];
+   const U32 oldCount = mSpanSlices[lastSpan] - sliceStart;
+   const U32 newCount = newSlices.size();
+   const U32 copyCount = getMin( oldCount, newCount );
+
+   for ( U32 i = 0; i < copyCount; i++ )
+      mSlices[sliceStart + i] = newSlices[i];
+
+   if ( oldCount > newCount )
+      mSlices.erase( sliceStart + newCount, oldCount - newCount );
+   else
+   {
+      for ( U32 i = copyCount; i < newCount; i++ )
+         mSlices.insert( sliceStart + i, newSlices[i] );
+   }
+
+   for ( U32 i = firstSpan; i <= lastSpan; i++ )
+      mSpanSlices[i-1] = sliceStart + newSpanSlices[i-firstSpan];
+   for ( U32 i = lastSpan; i < nodeCount; i++ )
+      mSpanSlices[i] = mSpanSlices[i] - oldCount + newCount;
+
+   // The slice orientation depends on its neighbors, so the slices
+   // bordering the new ones need finishing again as well.
+   const U32 finishStart = getMax( sliceStart, (U32)1 ) - 1;
+   const U32 finishEnd = getMin( sliceStart + newCount + 1, (U32)mSlices.size() );
+   _finishSlices( finishStart, finishEnd );
+   _updateSliceBounds();
+
+   // The segments point into the slices, so they are always rebuilt.
+   _generateSegments();
+
+   if( getSceneManager() != NULL )
+      getSceneManager()->notifyObjectDirty( this );
+}
+
+void MeshRoad::_finishSlices( U32 start, U32 end )
+{
    MatrixF mat(true);
-   Box3F box;
 
    U32 lastProfileNode = mSideProfile.mNodes.size() - 1;
    F32 depth = mSideProfile.mNodes[lastProfileNode].getPosition().y;
    F32 bttmOffset = mSideProfile.mNodes[lastProfileNode].getPosition().x;
 
-   for ( U32 i = 0; i < mSlices.size(); i++ )
+   for ( U32 i = start; i < end; i++ )
    {
       // Calculate uvec, fvec, and rvec for all slices
       calcSliceTransform( i, mat );
@@ -2420,21 +2702,8 @@ void MeshRoad::_generateSlices()
       slicePtr->pb0 = slicePtr->p0 + slicePtr->uvec * depth - slicePtr->rvec * bttmOffset;
       slicePtr->pb2 = slicePtr->p2 + slicePtr->uvec * depth + slicePtr->rvec * bttmOffset;
 
-     // Generate or extend the object/world bounds
-      if ( i == 0 )
-      {
-         box.minExtents = slicePtr->p0;
-         box.maxExtents = slicePtr->p2;
-         box.extend(slicePtr->pb0 );
-         box.extend(slicePtr->pb2 );
-      }
-      else
-      {
-         box.extend(slicePtr->p0 );
-         box.extend(slicePtr->p2 );
-         box.extend(slicePtr->pb0 );
-         box.extend(slicePtr->pb2 );
-      }
+      slicePtr->verts.clear();
+      slicePtr->norms.clear();
 
       // Right side
       Point3F pos;
@@ -2463,11 +2732,9 @@ void MeshRoad::_generateSlices()
          {
             mSideProfile.getNodeWorldPos(0, pos);
             slicePtr->verts.push_back(pos);
-            box.extend( pos );
 
             pos.z -= slicePtr->depth;
             slicePtr->verts.push_back(pos);
-            box.extend( pos );
 
             if(i)
                slicePtr->pb0 = pos;
@@ -2487,7 +2754,6 @@ void MeshRoad::_generateSlices()
             {
                mSideProfile.getNodeWorldPos(j, pos);
                slicePtr->verts.push_back(pos);
-               box.extend( pos );
             }
 
             for(U32 j = 0; j < mSideProfile.mNodeNormals.size(); j++)
@@ -2498,11 +2764,37 @@ void MeshRoad::_generateSlices()
          }
       }
    } 
+}
+
+void MeshRoad::_updateSliceBounds()
+{
+   Box3F box;
+
+   for ( U32 i = 0; i < mSlices.size(); i++ )
+   {
+      const MeshRoadSlice &slice = mSlices[i];
+
+      // Generate or extend the object/world bounds
+      if ( i == 0 )
+      {
+         box.minExtents = slice.p0;
+         box.maxExtents = slice.p2;
+      }
+      else
+      {
+         box.extend( slice.p0 );
+         box.extend( slice.p2 );
+      }
+
+      box.extend( slice.pb0 );
+      box.extend( slice.pb2 );
+
+      for ( U32 j = 0; j < slice.verts.size(); j++ )
+         box.extend( slice.verts[j] );
+   }
 
    mWorldBox = box;
    resetObjectBox();
-
-   _generateSegments();   
 }
 
 void MeshRoad::_generateSegments()
@@ -2546,43 +2838,8 @@ void MeshRoad::_generateSegments()
 
 void MeshRoad::_generateVerts()
 {           
-   const U32 widthDivisions = getMax( 0, mWidthSubdivisions );
-   const F32 divisionStep = 1.0f / (F32)( widthDivisions + 1 );
    const U32 sliceCount = mSlices.size();
-   const U32 segmentCount = mSegments.size();
-
-   U32 numProfSide, numProfTop, numProfBottom;
-
-   numProfSide = numProfTop = numProfBottom = 0;
 
-   // Find how many profile segments are set to side, top, and bottom materials
-   for ( U32 i = 0; i < mSideProfile.mSegMtrls.size(); i++)
-   {
-      switch(mSideProfile.mSegMtrls[i])
-      {
-      case Side:     numProfSide++;    break;
-      case Top:      numProfTop++;     break;
-      case Bottom:   numProfBottom++;  break;
-      }
-   }
-
-   F32 profLen = mSideProfile.getProfileLen();
-
-   mVertCount[Top] = ( 2 + widthDivisions ) * sliceCount;
-   mVertCount[Top] += sliceCount * numProfTop * 4;
-   mTriangleCount[Top] = segmentCount * 2 * ( widthDivisions + 1 );
-   mTriangleCount[Top] += segmentCount * numProfTop * 4;
-
-   mVertCount[Bottom] = sliceCount * 2;
-   mVertCount[Bottom] += sliceCount * numProfBottom * 4;
-   mTriangleCount[Bottom] = segmentCount * 2;
-   mTriangleCount[Bottom] += segmentCount * numProfBottom * 4;
-
-   mVertCount[Side] = sliceCount * numProfSide * 4;               // side verts
-   mVertCount[Side] += mSideProfile.mNodes.size() * 4;            // end cap verts
-   mTriangleCount[Side] = segmentCount * numProfSide * 4;         // side tris
-   mTriangleCount[Side] += mSideProfile.mCap.getNumTris() * 2;    // end cap tris
-   
    // Calculate TexCoords for Slices
 
    F32 texCoordV = 0.0f;
@@ -2600,19 +2857,80 @@ void MeshRoad::_generateVerts()
       slice.texCoordV = texCoordV;
    }
 
+   // Build the buffers on a worker when enabled and there is
+   // already geometry to render while we wait for it.
+   if ( smAsyncGeometry && !mVB[Top].isNull() )
+   {
+      mGeometryItem = new MeshRoadGeometryWorkItem( this );
+      ThreadPool::GLOBAL().queueWorkItem( mGeometryItem );
+      return;
+   }
+
+   mGeometryItem = NULL;
+
+   Geometry geometry;
+   _buildGeometry( mSlices, mSegments.size(), mSideProfile, mWidthSubdivisions, mTextureLength, geometry );
+   _uploadGeometry( geometry );
+}
+
+void MeshRoad::_buildGeometry(   const MeshRoadSliceVector &slices,
+                                 U32 segmentCount,
+                                 MeshRoadProfile &profile,
+                                 S32 widthSubdivisions,
+                                 F32 textureLength,
+                                 Geometry &outGeometry )
+{
+   PROFILE_SCOPE( MeshRoad_buildGeometry );
+
+   const U32 widthDivisions = getMax( 0, widthSubdivisions );
+   const F32 divisionStep = 1.0f / (F32)( widthDivisions + 1 );
+   const U32 sliceCount = slices.size();
+
+   U32 numProfSide, numProfTop, numProfBottom;
+
+   numProfSide = numProfTop = numProfBottom = 0;
+
+   // Find how many profile segments are set to side, top, and bottom materials
+   for ( U32 i = 0; i < profile.mSegMtrls.size(); i++)
+   {
+      switch(profile.mSegMtrls[i])
+      {
+      case Side:     numProfSide++;    break;
+      case Top:      numProfTop++;     break;
+      case Bottom:   numProfBottom++;  break;
+      }
+   }
+
+   F32 profLen = profile.getProfileLen();
+
+   outGeometry.vertCount[Top] = ( 2 + widthDivisions ) * sliceCount;
+   outGeometry.vertCount[Top] += sliceCount * numProfTop * 4;
+   outGeometry.triangleCount[Top] = segmentCount * 2 * ( widthDivisions + 1 );
+   outGeometry.triangleCount[Top] += segmentCount * numProfTop * 4;
+
+   outGeometry.vertCount[Bottom] = sliceCount * 2;
+   outGeometry.vertCount[Bottom] += sliceCount * numProfBottom * 4;
+   outGeometry.triangleCount[Bottom] = segmentCount * 2;
+   outGeometry.triangleCount[Bottom] += segmentCount * numProfBottom * 4;
+
+   outGeometry.vertCount[Side] = sliceCount * numProfSide * 4;          // side verts
+   outGeometry.vertCount[Side] += profile.mNodes.size() * 4;            // end cap verts
+   outGeometry.triangleCount[Side] = segmentCount * numProfSide * 4;    // side tris
+   outGeometry.triangleCount[Side] += profile.mCap.getNumTris() * 2;    // end cap tris
+   
    // Make Vertex Buffers
    GFXVertexPNTT *pVert = NULL;
    U32 vertCounter = 0;
 
    // Top Buffers...
 
-   mVB[Top].set( GFX, mVertCount[Top], GFXBufferTypeStatic );   
-   pVert = mVB[Top].lock(); 
+   outGeometry.verts[Top].setSize( outGeometry.vertCount[Top] );
+   pVert = outGeometry.verts[Top].address();
    vertCounter = 0;
    
    for ( U32 i = 0; i < sliceCount; i++ )
    {
-      MeshRoadSlice &slice = mSlices[i];      
+      const MeshRoadSlice &slice = slices[i];      
       
       pVert->point = slice.p0;    
       pVert->normal = slice.uvec;
@@ -2645,18 +2963,18 @@ void MeshRoad::_generateVerts()
    {
       for ( U32 i = 0; i < sliceCount; i++ )
       {
-         MeshRoadSlice &slice = mSlices[i];
+         const MeshRoadSlice &slice = slices[i];
 
          // Right Side
-         for ( U32 j = 0; j < mSideProfile.mNodes.size()-1; j++)
+         for ( U32 j = 0; j < profile.mNodes.size()-1; j++)
          {
-            if(mSideProfile.mSegMtrls[j] == Top)
+            if(profile.mSegMtrls[j] == Top)
             {
                // Vertex 1
                pVert->point = slice.verts[j];
                pVert->normal = slice.norms[2*j];
                pVert->tangent = slice.fvec;
-               pVert->texCoord.set(mSideProfile.getNodePosPercent(j)*profLen/mTextureLength,slice.texCoordV);
+               pVert->texCoord.set(profile.getNodePosPercent(j)*profLen/textureLength,slice.texCoordV);
                pVert++;
                vertCounter++;
 
@@ -2664,22 +2982,22 @@ void MeshRoad::_generateVerts()
                pVert->point = slice.verts[j+1];
                pVert->normal = slice.norms[2*j+1];
                pVert->tangent = slice.fvec;
-               pVert->texCoord.set(mSideProfile.getNodePosPercent(j+1)*profLen/mTextureLength,slice.texCoordV);
+               pVert->texCoord.set(profile.getNodePosPercent(j+1)*profLen/textureLength,slice.texCoordV);
                pVert++;
                vertCounter++;
             }
          }
 
          // Left Side
-         for( U32 j = mSideProfile.mNodes.size(); j < 2*mSideProfile.mNodes.size()-1; j++)
+         for( U32 j = profile.mNodes.size(); j < 2*profile.mNodes.size()-1; j++)
          {
-            if(mSideProfile.mSegMtrls[j-mSideProfile.mNodes.size()] == Top)
+            if(profile.mSegMtrls[j-profile.mNodes.size()] == Top)
             {
                // Vertex 1
                pVert->point = slice.verts[j];
                pVert->normal = slice.norms[2*j-2];
                pVert->tangent = slice.fvec;
-               pVert->texCoord.set(mSideProfile.getNodePosPercent(j)*profLen/mTextureLength,slice.texCoordV);
+               pVert->texCoord.set(profile.getNodePosPercent(j)*profLen/textureLength,slice.texCoordV);
                pVert++;
                vertCounter++;
 
@@ -2687,7 +3005,7 @@ void MeshRoad::_generateVerts()
                pVert->point = slice.verts[j+1];
                pVert->normal = slice.norms[2*j-1];
                pVert->tangent = slice.fvec;
-               pVert->texCoord.set(mSideProfile.getNodePosPercent(j+1)*profLen/mTextureLength,slice.texCoordV);
+               pVert->texCoord.set(profile.getNodePosPercent(j+1)*profLen/textureLength,slice.texCoordV);
                pVert++;
                vertCounter++;
             }
@@ -2695,19 +3013,18 @@ void MeshRoad::_generateVerts()
       }
    }
 
-   AssertFatal( vertCounter == mVertCount[Top], "MeshRoad, wrote incorrect number of verts in mVB[Top]!" );
+   AssertFatal( vertCounter == outGeometry.vertCount[Top], "MeshRoad, wrote incorrect number of verts in mVB[Top]!" );
 
-   mVB[Top].unlock();
 
    // Bottom Buffer...
 
-   mVB[Bottom].set( GFX, mVertCount[Bottom], GFXBufferTypeStatic );   
-   pVert = mVB[Bottom].lock(); 
+   outGeometry.verts[Bottom].setSize( outGeometry.vertCount[Bottom] );
+   pVert = outGeometry.verts[Bottom].address();
    vertCounter = 0;
 
    for ( U32 i = 0; i < sliceCount; i++ )
    {
-      MeshRoadSlice &slice = mSlices[i];      
+      const MeshRoadSlice &slice = slices[i];      
 
       pVert->point = slice.pb2;    
       pVert->normal = -slice.uvec;
@@ -2728,18 +3045,18 @@ void MeshRoad::_generateVerts()
    {
       for ( U32 i = 0; i < sliceCount; i++ )
       {
-         MeshRoadSlice &slice = mSlices[i];
+         const MeshRoadSlice &slice = slices[i];
 
          // Right Side
-         for ( U32 j = 0; j < mSideProfile.mNodes.size()-1; j++)
+         for ( U32 j = 0; j < profile.mNodes.size()-1; j++)
          {
-            if(mSideProfile.mSegMtrls[j] == Bottom)
+            if(profile.mSegMtrls[j] == Bottom)
             {
                // Vertex 1
                pVert->point = slice.verts[j];
                pVert->normal = slice.norms[2*j];
                pVert->tangent = slice.fvec;
-               pVert->texCoord.set(mSideProfile.getNodePosPercent(j)*profLen/mTextureLength,slice.texCoordV);
+               pVert->texCoord.set(profile.getNodePosPercent(j)*profLen/textureLength,slice.texCoordV);
                pVert++;
                vertCounter++;
 
@@ -2747,22 +3064,22 @@ void MeshRoad::_generateVerts()
                pVert->point = slice.verts[j+1];
                pVert->normal = slice.norms[2*j+1];
                pVert->tangent = slice.fvec;
-               pVert->texCoord.set(mSideProfile.getNodePosPercent(j+1)*profLen/mTextureLength,slice.texCoordV);
+               pVert->texCoord.set(profile.getNodePosPercent(j+1)*profLen/textureLength,slice.texCoordV);
                pVert++;
                vertCounter++;
             }
          }
 
          // Left Side
-         for( U32 j = mSideProfile.mNodes.size(); j < 2*mSideProfile.mNodes.size()-1; j++)
+         for( U32 j = profile.mNodes.size(); j < 2*profile.mNodes.size()-1; j++)
          {
-            if(mSideProfile.mSegMtrls[j-mSideProfile.mNodes.size()] == Bottom)
+            if(profile.mSegMtrls[j-profile.mNodes.size()] == Bottom)
             {
                // Vertex 1
                pVert->point = slice.verts[j];
                pVert->normal = slice.norms[2*j-2];
                pVert->tangent = slice.fvec;
-               pVert->texCoord.set(mSideProfile.getNodePosPercent(j)*profLen/mTextureLength,slice.texCoordV);
+               pVert->texCoord.set(profile.getNodePosPercent(j)*profLen/textureLength,slice.texCoordV);
                pVert++;
                vertCounter++;
 
@@ -2770,7 +3087,7 @@ void MeshRoad::_generateVerts()
                pVert->point = slice.verts[j+1];
                pVert->normal = slice.norms[2*j-1];
                pVert->tangent = slice.fvec;
-               pVert->texCoord.set(mSideProfile.getNodePosPercent(j+1)*profLen/mTextureLength,slice.texCoordV);
+               pVert->texCoord.set(profile.getNodePosPercent(j+1)*profLen/textureLength,slice.texCoordV);
                pVert++;
                vertCounter++;
             }
@@ -2778,32 +3095,31 @@ void MeshRoad::_generateVerts()
       }
    }
 
-   AssertFatal( vertCounter == mVertCount[Bottom], "MeshRoad, wrote incorrect number of verts in mVB[Bottom]!" );
+   AssertFatal( vertCounter == outGeometry.vertCount[Bottom], "MeshRoad, wrote incorrect number of verts in mVB[Bottom]!" );
 
-   mVB[Bottom].unlock();
 
    // Side Buffers...
 
-   mVB[Side].set( GFX, mVertCount[Side], GFXBufferTypeStatic );   
-   pVert = mVB[Side].lock(); 
+   outGeometry.verts[Side].setSize( outGeometry.vertCount[Side] );
+   pVert = outGeometry.verts[Side].address();
    vertCounter = 0;
 
    if(numProfSide)
    {
       for ( U32 i = 0; i < sliceCount; i++ )
       {
-         MeshRoadSlice &slice = mSlices[i];
+         const MeshRoadSlice &slice = slices[i];
 
          // Right Side
-         for( U32 j = 0; j < mSideProfile.mNodes.size()-1; j++)
+         for( U32 j = 0; j < profile.mNodes.size()-1; j++)
          {
-            if(mSideProfile.mSegMtrls[j] == Side)
+            if(profile.mSegMtrls[j] == Side)
             {
                // Segment Vertex 1
                pVert->point = slice.verts[j];
                pVert->normal = slice.norms[2*j];
                pVert->tangent = slice.fvec;
-               pVert->texCoord.set(mSideProfile.getNodePosPercent(j)*profLen/mTextureLength,slice.texCoordV);
+               pVert->texCoord.set(profile.getNodePosPercent(j)*profLen/textureLength,slice.texCoordV);
                pVert++;
                vertCounter++;
 
@@ -2811,22 +3127,22 @@ void MeshRoad::_generateVerts()
                pVert->point = slice.verts[j+1];
                pVert->normal = slice.norms[2*j+1];
                pVert->tangent = slice.fvec;
-               pVert->texCoord.set(mSideProfile.getNodePosPercent(j+1)*profLen/mTextureLength,slice.texCoordV);
+               pVert->texCoord.set(profile.getNodePosPercent(j+1)*profLen/textureLength,slice.texCoordV);
                pVert++;
                vertCounter++;
             }
          }
 
          // Left Side
-         for( U32 j = mSideProfile.mNodes.size(); j < 2*mSideProfile.mNodes.size()-1; j++)
+         for( U32 j = profile.mNodes.size(); j < 2*profile.mNodes.size()-1; j++)
          {
-            if(mSideProfile.mSegMtrls[j-mSideProfile.mNodes.size()] == Side)
+            if(profile.mSegMtrls[j-profile.mNodes.size()] == Side)
             {
                // Segment Vertex 1
                pVert->point = slice.verts[j];
                pVert->normal = slice.norms[2*j-2];
                pVert->tangent = slice.fvec;
-               pVert->texCoord.set(mSideProfile.getNodePosPercent(j)*profLen/mTextureLength,slice.texCoordV);
+               pVert->texCoord.set(profile.getNodePosPercent(j)*profLen/textureLength,slice.texCoordV);
                pVert++;
                vertCounter++;
 
@@ -2834,7 +3150,7 @@ void MeshRoad::_generateVerts()
                pVert->point = slice.verts[j+1];
                pVert->normal = slice.norms[2*j-1];
                pVert->tangent = slice.fvec;
-               pVert->texCoord.set(mSideProfile.getNodePosPercent(j+1)*profLen/mTextureLength,slice.texCoordV);
+               pVert->texCoord.set(profile.getNodePosPercent(j+1)*profLen/textureLength,slice.texCoordV);
                pVert++;
                vertCounter++;
             }
@@ -2847,9 +3163,9 @@ void MeshRoad::_generateVerts()
    VectorF norm;
    VectorF tang;
 
-   for( U32 i = 0; i < mSlices.size(); i += mSlices.size()-1)
+   for( U32 i = 0; i < slices.size(); i += slices.size()-1)
    {
-      MeshRoadSlice &slice = mSlices[i];
+      const MeshRoadSlice &slice = slices[i];
 
       // Back cap
       if(i)
@@ -2865,34 +3181,33 @@ void MeshRoad::_generateVerts()
       }
 
       // Right side
-      for( U32 j = 0; j < mSideProfile.mNodes.size(); j++)
+      for( U32 j = 0; j < profile.mNodes.size(); j++)
       {
          pVert->point = slice.verts[j];
          pVert->normal = norm;
          pVert->tangent = tang;
-         pos = mSideProfile.mNodes[j].getPosition();
-         pVert->texCoord.set(pos.x/mTextureLength, pos.y/mTextureLength);
+         pos = profile.mNodes[j].getPosition();
+         pVert->texCoord.set(pos.x/textureLength, pos.y/textureLength);
          pVert++;
          vertCounter++;
       }
 
       // Left side
-      for( U32 j = 2*mSideProfile.mNodes.size()-1; j >= mSideProfile.mNodes.size(); j--)
+      for( U32 j = 2*profile.mNodes.size()-1; j >= profile.mNodes.size(); j--)
       {
          pVert->point = slice.verts[j];
          pVert->normal = norm;
          pVert->tangent = tang;
-         pos = mSideProfile.mNodes[j-mSideProfile.mNodes.size()].getPosition();
+         pos = profile.mNodes[j-profile.mNodes.size()].getPosition();
          pos.x = -pos.x - slice.width;
-         pVert->texCoord.set(pos.x/mTextureLength, pos.y/mTextureLength);
+         pVert->texCoord.set(pos.x/textureLength, pos.y/textureLength);
          pVert++;
          vertCounter++;
       }
    }
 
-   AssertFatal( vertCounter == mVertCount[Side], "MeshRoad, wrote incorrect number of verts in mVB[Side]!" );
+   AssertFatal( vertCounter == outGeometry.vertCount[Side], "MeshRoad, wrote incorrect number of verts in mVB[Side]!" );
 
-   mVB[Side].unlock();
 
    // Make Primitive Buffers   
    U32 p00, p01, p11, p10;
@@ -2903,15 +3218,14 @@ void MeshRoad::_generateVerts()
 
    // Top Primitive Buffer
 
-   mPB[Top].set( GFX, mTriangleCount[Top] * 3, mTriangleCount[Top], GFXBufferTypeStatic );
-
-   mPB[Top].lock(&pIdx);     
+   outGeometry.indices[Top].setSize( outGeometry.triangleCount[Top] * 3 );
+   pIdx = outGeometry.indices[Top].address();
    curIdx = 0; 
    offset = 0;
 
    const U32 rowStride = 2 + widthDivisions;
  
-   for ( U32 i = 0; i < mSegments.size(); i++ )
+   for ( U32 i = 0; i < segmentCount; i++ )
    {		
       for ( U32 j = 0; j < widthDivisions + 1; j++ )
       {
@@ -2990,19 +3304,17 @@ void MeshRoad::_generateVerts()
       }
    }
 
-   AssertFatal( curIdx == mTriangleCount[Top] * 3, "MeshRoad, wrote incorrect number of indices in mPB[Top]!" );
+   AssertFatal( curIdx == outGeometry.triangleCount[Top] * 3, "MeshRoad, wrote incorrect number of indices in mPB[Top]!" );
 
-   mPB[Top].unlock();
 
    // Bottom Primitive Buffer
 
-   mPB[Bottom].set( GFX, mTriangleCount[Bottom] * 3, mTriangleCount[Bottom], GFXBufferTypeStatic );
-
-   mPB[Bottom].lock(&pIdx);     
+   outGeometry.indices[Bottom].setSize( outGeometry.triangleCount[Bottom] * 3 );
+   pIdx = outGeometry.indices[Bottom].address();
    curIdx = 0; 
    offset = 0;
 
-   for ( U32 i = 0; i < mSegments.size(); i++ )
+   for ( U32 i = 0; i < segmentCount; i++ )
    {		
       p00 = offset;
       p10 = offset + 1;
@@ -3076,21 +3388,19 @@ void MeshRoad::_generateVerts()
       }
    }
 
-   AssertFatal( curIdx == mTriangleCount[Bottom] * 3, "MeshRoad, wrote incorrect number of indices in mPB[Bottom]!" );
+   AssertFatal( curIdx == outGeometry.triangleCount[Bottom] * 3, "MeshRoad, wrote incorrect number of indices in mPB[Bottom]!" );
 
-   mPB[Bottom].unlock();
 
    // Side Primitive Buffer
 
-   mPB[Side].set( GFX, mTriangleCount[Side] * 3, mTriangleCount[Side], GFXBufferTypeStatic );
-
-   mPB[Side].lock(&pIdx);     
+   outGeometry.indices[Side].setSize( outGeometry.triangleCount[Side] * 3 );
+   pIdx = outGeometry.indices[Side].address();
    curIdx = 0; 
    offset = 4 * numProfSide;
 
    if(numProfSide)
    {
-      for ( U32 i = 0; i < mSegments.size(); i++ )
+      for ( U32 i = 0; i < segmentCount; i++ )
       {
          // Loop through profile segments on right side
          for( U32 j = 0; j < numProfSide; j++)
@@ -3137,32 +3447,60 @@ void MeshRoad::_generateVerts()
    // Cap the front
    offset = sliceCount * numProfSide * 4;
 
-   for ( U32 i = 0; i < mSideProfile.mCap.getNumTris(); i++ )
+   for ( U32 i = 0; i < profile.mCap.getNumTris(); i++ )
    {
-      pIdx[curIdx] = mSideProfile.mCap.getTriIdx(i, 0) + offset;
+      pIdx[curIdx] = profile.mCap.getTriIdx(i, 0) + offset;
       curIdx++;
-      pIdx[curIdx] = mSideProfile.mCap.getTriIdx(i, 1) + offset;
+      pIdx[curIdx] = profile.mCap.getTriIdx(i, 1) + offset;
       curIdx++;
-      pIdx[curIdx] = mSideProfile.mCap.getTriIdx(i, 2) + offset;
+      pIdx[curIdx] = profile.mCap.getTriIdx(i, 2) + offset;
       curIdx++;
    }
 
    // Cap the back
-   offset += mSideProfile.mNodes.size() * 2;
+   offset += profile.mNodes.size() * 2;
 
-   for ( U32 i = 0; i < mSideProfile.mCap.getNumTris(); i++ )
+   for ( U32 i = 0; i < profile.mCap.getNumTris(); i++ )
    {
-      pIdx[curIdx] = mSideProfile.mCap.getTriIdx(i, 2) + offset;
+      pIdx[curIdx] = profile.mCap.getTriIdx(i, 2) + offset;
       curIdx++;
-      pIdx[curIdx] = mSideProfile.mCap.getTriIdx(i, 1) + offset;
+      pIdx[curIdx] = profile.mCap.getTriIdx(i, 1) + offset;
       curIdx++;
-      pIdx[curIdx] = mSideProfile.mCap.getTriIdx(i, 0) + offset;
+      pIdx[curIdx] = profile.mCap.getTriIdx(i, 0) + offset;
       curIdx++;
    }
 
-   AssertFatal( curIdx == mTriangleCount[Side] * 3, "MeshRoad, wrote incorrect number of indices in mPB[Side]!" );
+   AssertFatal( curIdx == outGeometry.triangleCount[Side] * 3, "MeshRoad, wrote incorrect number of indices in mPB[Side]!" );
+
+}
+
+void MeshRoad::_uploadGeometry( const Geometry &geometry )
+{
+   for ( U32 i = 0; i < SurfaceCount; i++ )
+   {
+      mVertCount[i] = geometry.vertCount[i];
+      mTriangleCount[i] = geometry.triangleCount[i];
+
+      mVB[i].set( GFX, mVertCount[i], GFXBufferTypeStatic );
+      GFXVertexPNTT *pVert = mVB[i].lock();
+      dMemcpy( pVert, geometry.verts[i].address(), mVertCount[i] * sizeof( GFXVertexPNTT ) );
+      mVB[i].unlock();
+
+      U16 *pIdx = NULL;
+      mPB[i].set( GFX, mTriangleCount[i] * 3, mTriangleCount[i], GFXBufferTypeStatic );
+      mPB[i].lock( &pIdx );
+      dMemcpy( pIdx, geometry.indices[i].address(), mTriangleCount[i] * 3 * sizeof( U16 ) );
+      mPB[i].unlock();
+   }
+}
+
+void MeshRoad::_updateGeometry()
+{
+   if ( !mGeometryItem || !mGeometryItem->hasExecuted() )
+      return;
 
-   mPB[Side].unlock();
+   _uploadGeometry( mGeometryItem->getGeometry() );
+   mGeometryItem = NULL;
 }
 
 const MeshRoadNode& MeshRoad::getNode( U32 idx )
@@ -3185,9 +3523,7 @@ void MeshRoad::setNodeNormal( U32 idx, const VectorF &normal )
 
    mNodes[idx].normal = normal;
 
-   regenerate();
-
-   setMaskBits( NodeMask | RegenMask );
+   _setNodesDirty( idx, idx );
 }
 
 Point3F MeshRoad::getNodePosition( U32 idx )
@@ -3205,9 +3541,7 @@ void MeshRoad::setNodePosition( U32 idx, const Point3F &pos )
 
    mNodes[idx].point = pos;
 
-   regenerate();
-
-   setMaskBits( NodeMask | RegenMask );
+   _setNodesDirty( idx, idx );
 }
 
 U32 MeshRoad::addNode( const Point3F &pos, const F32 &width, const F32 &depth, const VectorF &normal )
@@ -3230,6 +3564,15 @@ void MeshRoad::buildNodesFromList( MeshRoadNodeList* list )
       _addNode( list->mPositions[i], list->mWidths[i], list->mDepths[i], list->mNormals[i] );
    }
 
+   // Apply any node range which arrived ahead of the list.
+   if ( mPendingNodeCount == mNodes.size() && mPendingNodeStart + mPendingNodes.size() <= mNodes.size() )
+   {
+      for ( U32 i = 0; i < mPendingNodes.size(); i++ )
+         mNodes[mPendingNodeStart + i] = mPendingNodes[i];
+   }
+
+   mPendingNodes.clear();
+
    _regenerate();
 }
 
@@ -3237,6 +3580,9 @@ U32 MeshRoad::insertNode( const Point3F &pos, const F32 &width, const F32 &depth
 {
    U32 ret = _insertNode( pos, width, depth, normal, idx );
 
+   mDirtyNodeStart = 1;
+   mDirtyNodeEnd = 0;
+
    regenerate();
 
    setMaskBits( NodeMask | RegenMask );
@@ -3256,9 +3602,7 @@ void MeshRoad::setNode( const Point3F &pos, const F32 &width, const F32 &depth,
    node.depth = depth;
    node.normal = normal;
 
-   regenerate();
-
-   setMaskBits( NodeMask | RegenMask );
+   _setNodesDirty( idx, idx );
 }
 
 void MeshRoad::setNodeWidth( U32 idx, F32 meters )
@@ -3269,9 +3613,8 @@ void MeshRoad::setNodeWidth( U32 idx, F32 meters )
       return;
 
    mNodes[idx].width = meters;
-   _regenerate();
 
-   setMaskBits( RegenMask | NodeMask );
+   _setNodesDirty( idx, idx );
 }
 
 F32 MeshRoad::getNodeWidth( U32 idx )
@@ -3291,9 +3634,7 @@ void MeshRoad::setNodeDepth( U32 idx, F32 meters )
 
    mNodes[idx].depth = meters;
 
-   _regenerate();
-
-   setMaskBits( MeshRoadMask | RegenMask | NodeMask );
+   _setNodesDirty( idx, idx );
 }
 
 F32 MeshRoad::getNodeDepth( U32 idx )
@@ -3424,6 +3765,9 @@ void MeshRoad::deleteNode( U32 idx )
    mNodes.erase(idx);   
    _regenerate();
 
+   mDirtyNodeStart = 1;
+   mDirtyNodeEnd = 0;
+
    setMaskBits( RegenMask | NodeMask );
 }
 
@@ -3437,6 +3781,10 @@ U32 MeshRoad::_addNode( const Point3F &pos, const F32 &width, const F32 &depth,
    node.depth = depth;
    node.normal = normal;
 
+   // The full node list covers any edited range.
+   mDirtyNodeStart = 1;
+   mDirtyNodeEnd = 0;
+
    setMaskBits( NodeMask | RegenMask );
 
    return mNodes.size() - 1;
@@ -3523,6 +3871,35 @@ void MeshRoad::regenerate()
    setMaskBits( RegenMask );
 }
 
+void MeshRoad::_setNodesDirty( U32 start, U32 end )
+{
+   _regenerateNodes( start, end );
+
+   // Grow the range of nodes the clients may be missing.  It only
+   // shrinks along with a full node update, so that resending a
+   // dropped update always covers every node edited since then.
+   if ( mDirtyNodeStart > mDirtyNodeEnd )
+   {
+      mDirtyNodeStart = start;
+      mDirtyNodeEnd = end;
+   }
+   else
+   {
+      mDirtyNodeStart = getMin( mDirtyNodeStart, start );
+      mDirtyNodeEnd = getMax( mDirtyNodeEnd, end );
+   }
+
+   // Once most of the road has changed just send all of it.
+   if ( ( mDirtyNodeEnd - mDirtyNodeStart + 1 ) * 2 > mNodes.size() )
+   {
+      mDirtyNodeStart = 1;
+      mDirtyNodeEnd = 0;
+      setMaskBits( NodeMask | RegenMask );
+   }
+   else
+      setMaskBits( NodeRangeMask | RegenMask );
+}
+
 //-------------------------------------------------------------------------
 // Console Methods
 //-------------------------------------------------------------------------
@@ -49,6 +49,9 @@
 #ifndef _CONVEX_H_
 #include "collision/convex.h"
 #endif
+#ifndef _THREADSAFEREFCOUNT_H_
+#include "platform/threads/threadSafeRefCount.h"
+#endif
 
 #include "math/util/decomposePoly.h"
 
@@ -479,6 +482,8 @@ inline const Point3F& MeshRoadSegment::operator[](U32 index) const
 
 class PhysicsBody;
 struct MeshRoadNodeList;
+class MeshRoadGeometryWorkItem;
+template<typename TYPE> class CatmullRom;
 
 class MeshRoad : public SceneObject
 {
@@ -488,6 +493,7 @@ private:
    friend class GuiMeshRoadEditorUndoAction;
    friend class MeshRoadConvex;
    friend class MeshRoadProfile;
+   friend class MeshRoadGeometryWorkItem;
 
    typedef SceneObject		Parent;
 
@@ -500,7 +506,8 @@ private:
       SelectedMask      = Parent::NextFreeMask << 4,
       MaterialMask      = Parent::NextFreeMask << 5,
       ProfileMask       = Parent::NextFreeMask << 6,
-      NextFreeMask      = Parent::NextFreeMask << 7,
+      NodeRangeMask     = Parent::NextFreeMask << 7,
+      NextFreeMask      = Parent::NextFreeMask << 8,
    };   
 
 public:
@@ -588,6 +595,14 @@ public:
    static bool smShowRoadProfile;
    static SimObjectPtr<SimSet> smServerMeshRoadSet;   
 
+   /// If true node edits only regenerate the slices of the
+   /// spline spans touched by the changed nodes.
+   static bool smIncrementalRegen;
+
+   /// If true the client builds the vertex and index data on
+   /// a worker thread and swaps it in once it is complete.
+   static bool smAsyncGeometry;
+
 protected:
 
    void _initMaterial();
@@ -602,6 +617,35 @@ protected:
    void _generateSegments();
    void _generateVerts();   
 
+   /// Regenerates only the spline spans affected by a change
+   /// to the nodes from start to end inclusive.  Falls back to
+   /// _regenerate() when the change can't be done in place.
+   void _regenerateNodes( U32 start, U32 end );
+
+   /// Regenerates the nodes from start to end inclusive and
+   /// queues them for the clients.
+   void _setNodesDirty( U32 start, U32 end );
+
+   void _initSpline( CatmullRom<MeshRoadSplineNode> &spline ) const;
+
+   /// Appends the slices for the spline span ending at node
+   /// spanIdx, updating the last break state as it goes.
+   void _generateSpanSlices(  CatmullRom<MeshRoadSplineNode> &spline,
+                              U32 spanIdx,
+                              MeshRoadSplineNode &lastBreakNode,
+                              VectorF &lastBreakVector,
+                              MeshRoadSliceVector &outSlices ) const;
+
+   /// Calculates the transform, edges and profile verts of the
+   /// slices from start up to but not including end.
+   void _finishSlices( U32 start, U32 end );
+
+   void _updateSliceBounds();
+
+   /// Uploads the geometry from the pending build item
+   /// once it has finished.
+   void _updateGeometry();
+
 protected:
 
    MeshRoadSliceVector mSlices;
@@ -618,6 +662,54 @@ protected:
       SurfaceCount = 3
    };
 
+   /// The vertex and index data for each surface which is
+   /// built off the GFX buffers, so that it can be done on
+   /// a worker thread.
+   struct Geometry
+   {
+      Vector<GFXVertexPNTT> verts[SurfaceCount];
+      Vector<U16> indices[SurfaceCount];
+      U32 vertCount[SurfaceCount];
+      U32 triangleCount[SurfaceCount];
+   };
+
+   /// Fills the geometry for the slices and profile.  This only
+   /// touches the arguments, so it is safe to call from any thread.
+   static void _buildGeometry(   const MeshRoadSliceVector &slices,
+                                 U32 segmentCount,
+                                 MeshRoadProfile &profile,
+                                 S32 widthSubdivisions,
+                                 F32 textureLength,
+                                 Geometry &outGeometry );
+
+   /// Copies the geometry into the GFX buffers.
+   void _uploadGeometry( const Geometry &geometry );
+
+   /// The index of the first slice in each spline span with
+   /// the total slice count in the last element.
+   Vector<U32> mSpanSlices;
+
+   /// The slice break state at the end of each spline span
+   /// with the starting state in the first element.
+   Vector<MeshRoadSplineNode> mSpanBreakNodes;
+   Vector<VectorF> mSpanBreakVectors;
+
+   /// The range of nodes changed since the last full node
+   /// update was sent to the clients or empty if start > end.
+   U32 mDirtyNodeStart;
+   U32 mDirtyNodeEnd;
+
+   /// A node range received on the client before the full
+   /// node list it was made from.
+   /// @see buildNodesFromList
+   U32 mPendingNodeCount;
+   U32 mPendingNodeStart;
+   MeshRoadNodeVector mPendingNodes;
+
+   /// The geometry being built on a worker thread or NULL
+   /// if there is none pending.
+   ThreadSafeRef<MeshRoadGeometryWorkItem> mGeometryItem;
+
    GFXVertexBufferHandle<GFXVertexPNTT> mVB[SurfaceCount];   
    GFXPrimitiveBufferHandle mPB[SurfaceCount];      
 
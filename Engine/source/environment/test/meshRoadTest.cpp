@@ -0,0 +1,169 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2014 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "environment/meshRoad.h"
+#include "console/console.h"
+#include "math/mRandom.h"
+
+FIXTURE(MeshRoad)
+{
+public:
+   bool oldIncremental;
+
+   void SetUp()
+   {
+      oldIncremental = Con::getBoolVariable( "$MeshRoad::incrementalRegen" );
+   }
+
+   void TearDown()
+   {
+      Con::setBoolVariable( "$MeshRoad::incrementalRegen", oldIncremental );
+   }
+
+   /// Returns the position of a node on a winding road
+   /// with 4 meters between nodes.
+   static Point3F nodePos( U32 i )
+   {
+      return Point3F( i * 4.0f, 40.0f * mSin( i * 0.05f ), 2.0f * mSin( i * 0.13f ) );
+   }
+
+   /// Creates a server road from the nodes.
+   static MeshRoad* createRoad( const Vector<Point3F> &points, const Vector<F32> &widths )
+   {
+      MeshRoad *road = new MeshRoad();
+
+      char buffer[256];
+      for ( U32 i = 0; i < points.size(); i++ )
+      {
+         dSprintf( buffer, sizeof( buffer ), "%g %g %g %g %g 0 0 1", points[i].x, points[i].y, points[i].z, widths[i], 5.0f );
+         road->setDataField( StringTable->insert( "Node" ), NULL, buffer );
+      }
+
+      if ( !road->registerObject() )
+      {
+         delete road;
+         return NULL;
+      }
+
+      return road;
+   }
+
+   static void makeNodes( U32 count, Vector<Point3F> *points, Vector<F32> *widths )
+   {
+      points->setSize( count );
+      widths->setSize( count );
+      for ( U32 i = 0; i < count; i++ )
+      {
+         (*points)[i] = nodePos( i );
+         (*widths)[i] = 10.0f;
+      }
+   }
+};
+
+TEST_FIX(MeshRoad, IncrementalMatchesFull)
+{
+   Con::setBoolVariable( "$MeshRoad::incrementalRegen", true );
+
+   Vector<Point3F> points;
+   Vector<F32> widths;
+   makeNodes( 100, &points, &widths );
+
+   MeshRoad *road = createRoad( points, widths );
+   ASSERT_TRUE( road != NULL );
+
+   // Edit a few nodes in place.
+   points[50] += Point3F( 0.0f, 3.0f, 0.5f );
+   road->setNodePosition( 50, points[50] );
+   widths[20] = 14.0f;
+   road->setNodeWidth( 20, widths[20] );
+   points[98] += Point3F( 2.0f, -1.0f, 0.0f );
+   road->setNodePosition( 98, points[98] );
+
+   // Build the same road from scratch.
+   MeshRoad *expected = createRoad( points, widths );
+   ASSERT_TRUE( expected != NULL );
+
+   ASSERT_EQ( expected->getSegmentCount(), road->getSegmentCount() );
+   for ( U32 i = 0; i < road->getSegmentCount(); i++ )
+   {
+      const MeshRoadSegment &a = road->getSegment( i );
+      const MeshRoadSegment &b = expected->getSegment( i );
+      for ( U32 j = 0; j < 8; j++ )
+      {
+         EXPECT_NEAR( a[j].x, b[j].x, 0.001f );
+         EXPECT_NEAR( a[j].y, b[j].y, 0.001f );
+         EXPECT_NEAR( a[j].z, b[j].z, 0.001f );
+      }
+   }
+
+   EXPECT_NEAR( road->getRoadLength(), expected->getRoadLength(), 0.01f );
+   EXPECT_TRUE( road->getWorldBox().isValidBox() );
+   EXPECT_NEAR( ( road->getWorldBox().minExtents - expected->getWorldBox().minExtents ).len(), 0.0f, 0.001f );
+   EXPECT_NEAR( ( road->getWorldBox().maxExtents - expected->getWorldBox().maxExtents ).len(), 0.0f, 0.001f );
+
+   road->deleteObject();
+   expected->deleteObject();
+}
+
+TEST_FIX(MeshRoad, StressTestNodeEdits)
+{
+   // Time the server takes to regenerate a 2 km, 500 node
+   // road after each of 50 single node edits.
+   const U32 numNodes = 500;
+   const U32 numEdits = 50;
+
+   Vector<Point3F> points;
+   Vector<F32> widths;
+   makeNodes( numNodes, &points, &widths );
+
+   U32 start = Platform::getRealMilliseconds();
+   MeshRoad *road = createRoad( points, widths );
+   ASSERT_TRUE( road != NULL );
+   const U32 createMs = Platform::getRealMilliseconds() - start;
+
+   Con::printf( "MeshRoad: %.0f m road with %d nodes and %d segments created in %d ms",
+      road->getRoadLength(), numNodes, road->getSegmentCount(), createMs );
+
+   for ( U32 mode=0; mode < 2; mode++ )
+   {
+      Con::setBoolVariable( "$MeshRoad::incrementalRegen", mode == 1 );
+
+      MRandomLCG rand( 1234 );
+
+      start = Platform::getRealMilliseconds();
+      for ( U32 i=0; i < numEdits; i++ )
+      {
+         const U32 idx = rand.randI( 1, numNodes - 2 );
+         road->setNodePosition( idx, nodePos( idx ) + Point3F( 0.0f, rand.randF( -2.0f, 2.0f ), 0.0f ) );
+      }
+      const U32 editMs = Platform::getRealMilliseconds() - start;
+
+      Con::printf( "MeshRoad: %s regeneration %.2f ms per node edit",
+         mode == 0 ? "full" : "incremental", F32( editMs ) / numEdits );
+   }
+
+   road->deleteObject();
+}
+
+#endif
@@ -183,12 +183,8 @@ void ForestUpdateAction::_swapState()
    {
       const ForestItem &item = prevItems[i];
 
-      // Save the current state so we can reverse this swap.
-      //
-      // Note that we do 'not' want the const ref returned by findItem
-      // because when we call updateItem below we would lose our copy
-      // of the items state before the call.
-      //
+      // Save the current state so we can reverse this swap.  findItem
+      // decodes the item into a copy, so it survives the updateItem below.
       ForestItem newItem = mData->findItem( item.getKey() );
 
       if ( !newItem.isValid() )
@@ -24,6 +24,7 @@
 #include "forest/forest.h"
 
 #include "forest/forestCell.h"
+#include "forest/forestCellCuller.h"
 #include "forest/forestCollision.h"
 #include "forest/forestDataFile.h"
 #include "forest/forestWindMgr.h"
@@ -137,6 +138,16 @@ void Forest::consoleInit()
       "A debugging aid which renders the forest bounds.\n"
       "@ingroup Forest\n" );
 
+   Con::addVariable("$Forest::compactItems", TypeBool, &ForestItemStore::smCompactItems,
+      "If true forest items are stored with a quantized position, yaw, and scale which "
+      "uses much less memory.  Items which would move visibly when quantized always keep "
+      "their full transform.  Only affects items added after it is changed.\n"
+      "@ingroup Forest\n" );
+   Con::addVariable("$Forest::parallelCullThreshold", TypeS32, &ForestCellCuller::smParallelThreshold,
+      "The number of forest cells which must be reached at the top of the cell trees "
+      "before culling is split across the thread pool.  Zero disables threaded culling.\n"
+      "@ingroup Forest\n" );
+
    // The canvas signal lets us know to clear the rendering stats.
    GuiCanvas::getGuiCanvasFrameSignal().notify( &Forest::_clearStats );
 }
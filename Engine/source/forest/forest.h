@@ -83,6 +83,7 @@ class Forest : public SceneObject
 {
    friend class CreateForestEvent;
    friend class ForestConvex;
+   friend class ForestCellCuller;
 
 protected:
 
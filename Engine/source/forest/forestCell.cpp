@@ -39,6 +39,7 @@ ForestCell::ForestCell( const RectF &rect ) :
    mRect( rect ),
    mBounds( Box3F::Invalid ),
    mIsDirty( false ),
+   mItems( rect ),
    mLargestItem( ForestItem::Invalid ),
    mIsInteriorOnly( false )
 {
@@ -140,14 +141,15 @@ S32 ForestCell::render( TSRenderState *rdata, const Frustum *culler )
    // so we can maybe save some overhead by preparing
    // the item for rendering once.
 
-   Vector<ForestItem>::iterator item = mItems.begin();
-   for ( ; item != mItems.end(); item++ )
+   for ( U32 i=0; i < mItems.size(); i++ )
    {
+      const ForestItem item = mItems.getItem( i );
+
       // Do we need to cull individual items?
-      if ( culler && culler->isCulled( item->getWorldBox() ) )
+      if ( culler && culler->isCulled( item.getWorldBox() ) )
          continue;
 
-      if ( item->getData()->render( rdata, *item ) )
+      if ( item.getData()->render( rdata, item ) )
          ++itemsRendered;
    }
 
@@ -177,14 +179,14 @@ void ForestCell::_updateBounds()
    }
 
    // Loop thru all the items in this cell.
-   Vector<ForestItem>::const_iterator item = mItems.begin();
-   for ( ; item != mItems.end(); item++ )
+   for ( U32 i=0; i < mItems.size(); i++ )
    {
-      mBounds.intersect( (*item).getWorldBox() );
+      const ForestItem item = mItems.getItem( i );
+      mBounds.intersect( item.getWorldBox() );
 
-      radius = (*item).getRadius();
+      radius = item.getRadius();
       if ( radius > mLargestItem.getRadius() )
-         mLargestItem = (*item);
+         mLargestItem = item;
    }
 }
 
@@ -228,37 +230,13 @@ void ForestCell::_updateZoning( const SceneZoneSpaceManager *zoneManager )
 
 bool ForestCell::findIndexByKey( ForestItemKey key, U32 *outIndex ) const
 {
-   // Do a simple binary search.
-
-   U32   i = 0,
-         lo = 0,
-         hi = mItems.size();
-   
-   const ForestItem *items = mItems.address();
-
-   while ( lo < hi ) 
-   {
-      i = (lo + hi) / 2;
-
-      if ( key < items[i].getKey() )
-         hi = i;
-      else if ( key > items[i].getKey() )
-         lo = i + 1;
-      else
-      {
-         *outIndex = i;
-         return true;
-      }
-   }
-
-   *outIndex = lo;
-   return false;
+   return mItems.findIndexByKey( key, outIndex );
 }
 
-const ForestItem& ForestCell::insertItem( ForestItemKey key,
-                                          ForestItemData *data,
-                                          const MatrixF &xfm,
-                                          F32 scale )
+ForestItem ForestCell::insertItem(  ForestItemKey key,
+                                    ForestItemData *data,
+                                    const MatrixF &xfm,
+                                    F32 scale )
 {
    AssertFatal( key != 0, "ForestCell::insertItem() - Got null key!" );
    AssertFatal( data != NULL, "ForestCell::insertItem() - Got null datablock!" );
@@ -282,15 +260,16 @@ const ForestItem& ForestCell::insertItem( ForestItemKey key,
          mSubCells[i] = new ForestCell( _makeChildRect( i ) );
 
       // Now push all our current children down.
-      Vector<ForestItem>::iterator item = mItems.begin();
-      for ( ; item != mItems.end(); item++ )
+      MatrixF itemXfm;
+      for ( U32 i=0; i < mItems.size(); i++ )
       {
-         U32 index = _getSubCell( item->getPosition().x, item->getPosition().y );
+         mItems.getTransform( i, &itemXfm );
+         U32 index = _getSubCell( itemXfm.getPosition().x, itemXfm.getPosition().y );
 
-         mSubCells[index]->insertItem( item->getKey(), 
-                                       item->getData(), 
-                                       item->getTransform(), 
-                                       item->getScale() );
+         mSubCells[index]->insertItem( mItems.getKey( i ), 
+                                       mItems.getData( i ), 
+                                       itemXfm, 
+                                       mItems.getScale( i ) );
       }
 
       // Clean up.
@@ -303,7 +282,7 @@ const ForestItem& ForestCell::insertItem( ForestItemKey key,
    {
       // Ok... kick this item down then.
       U32 index = _getSubCell( xfm.getPosition().x, xfm.getPosition().y );
-      const ForestItem &result = mSubCells[index]->insertItem( key, data, xfm, scale );
+      const ForestItem result = mSubCells[index]->insertItem( key, data, xfm, scale );
 
       AssertFatal( index == _getSubCell( result.getPosition().x, result.getPosition().y ), "ForestCell::insertItem() - binning is hosed." );
 
@@ -332,19 +311,10 @@ const ForestItem& ForestCell::insertItem( ForestItemKey key,
    U32 index;
    bool found = findIndexByKey( key, &index );
    
-   // If we didn't find one then insert it.
-   if ( !found )
-      mItems.insert( index );
+   // Insert it if we didn't find one or update the item settings.
+   mItems.set( index, !found, key, data, xfm, scale );
 
-   // Update the item settings.
-   ForestItem &item = mItems[ index ];   
-   item.setData( data );
-   item.setTransform( xfm, scale );
-
-   if ( !found )
-      item.setKey( key );
-
-   return item;
+   return mItems.getItem( index );
 }
 
 bool ForestCell::removeItem( ForestItemKey key, const Point3F &keyPos, bool deleteIfEmpty )
@@ -425,7 +395,7 @@ void ForestCell::getItems( Vector<ForestItem> *outItems ) const
       }
 
       // Get the items.
-      outItems->merge( cell->getItems() );
+      cell->getItems().getItems( outItems );
    }
 }
 
@@ -457,17 +427,17 @@ void ForestCell::buildPhysicsRep( Forest *forest )
       const static SphereF dummySphere( Point3F::Zero, 0 );       
 
       // Step thru them and build collision data.
-      ForestItemVector::iterator itemItr = mItems.begin();
       ConcretePolyList polyList;
-      for ( ; itemItr != mItems.end(); itemItr++ )
+      for ( U32 i=0; i < mItems.size(); i++ )
       {
-         const ForestItem &item = *itemItr;
-         const ForestItemData *itemData = item.getData();
+         const ForestItemData *itemData = mItems.getData( i );
          
          // If not collidable don't need to build anything.
          if ( !itemData->mCollidable )
             continue;
 
+         const ForestItem item = mItems.getItem( i );
+
          // TODO: When we add breakable tree support this is where
          // we would need to store their collision data seperately.
 
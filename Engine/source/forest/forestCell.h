@@ -26,6 +26,9 @@
 #ifndef _FORESTITEM_H_
 #include "forest/forestItem.h"
 #endif
+#ifndef _FORESTITEMSTORE_H_
+#include "forest/forestItemStore.h"
+#endif
 #ifndef _H_FOREST_
 #include "forest/forest.h"
 #endif
@@ -45,6 +48,7 @@ class PhysicsBody;
 class ForestCell
 {
    friend class Forest;
+   friend class ForestCellCuller;
 
 protected:
 
@@ -61,7 +65,7 @@ protected:
    Box3F mBounds;
 
    /// All the items in this cell.
-   Vector<ForestItem> mItems;
+   ForestItemStore mItems;
 
    /// A vector of the current batches 
    /// associated with this cell.
@@ -156,6 +160,8 @@ public:
 
    bool hasBatches() const { return !mBatches.empty(); }
 
+   const Vector<ForestCellBatch*>& getBatches() const { return mBatches; }
+
    void buildBatches();
 
    void freeBatches();
@@ -182,10 +188,14 @@ public:
 
    const ForestItem& getLargestItem() const { return mLargestItem; }
 
-   const ForestItem& insertItem( ForestItemKey key,
-                                 ForestItemData *data,
-                                 const MatrixF &xfm,
-                                 F32 scale );
+   /// Inserts or updates the item and returns it as it
+   /// was stored which may differ slightly from the passed
+   /// transform and scale.
+   /// @see ForestItemStore
+   ForestItem insertItem(  ForestItemKey key,
+                           ForestItemData *data,
+                           const MatrixF &xfm,
+                           F32 scale );
 
    bool removeItem( ForestItemKey key, const Point3F &keyPos, bool deleteIfEmpty = false );
 
@@ -198,7 +208,7 @@ public:
    void getChildren( Vector<const ForestCell*> *outCells ) const { outCells->merge( mSubCells, 4 ); }
 
    /// Returns the items from this one cell.
-   const Vector<ForestItem>& getItems() const { return mItems; }
+   const ForestItemStore& getItems() const { return mItems; }
 
    /// Returns the items from this cell and all its sub-cells.
    void getItems( Vector<ForestItem> *outItems ) const;
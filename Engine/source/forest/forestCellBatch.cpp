@@ -28,6 +28,7 @@
 
 ForestCellBatch::ForestCellBatch()
    :  mDirty( false ),
+      mPacked( false ),
       mBounds( Box3F::Invalid )
 {
 }
@@ -52,6 +53,7 @@ bool ForestCellBatch::add( const ForestItem &item )
    // Add it to our list and we'll populate the VB at render time.
    mItems.push_back( item );
    mDirty = true;
+   mPacked = false;
 
    // Expand out bounds.
    const Box3F &box = item.getWorldBox();
@@ -59,12 +61,23 @@ bool ForestCellBatch::add( const ForestItem &item )
    return true;
 }
 
+void ForestCellBatch::pack()
+{
+   if ( !needsPack() )
+      return;
+
+   _packBatch();
+   mPacked = true;
+}
+
 void ForestCellBatch::render( SceneRenderState *state )
 {
    if ( mDirty )
    {
+      pack();
       _rebuildBatch();
       mDirty = false;
+      mPacked = false;
    }
 
    _render( state );
@@ -36,6 +36,10 @@ protected:
    /// objects need to be repacked.
    bool mDirty; 
 
+   /// Set when the batch has been packed for the
+   /// next rebuild.
+   bool mPacked;
+
    /// The items in the batch.
    Vector<ForestItem> mItems;
 
@@ -43,6 +47,11 @@ protected:
    Box3F mBounds;
 
    virtual bool _prepBatch( const ForestItem &item ) = 0;
+
+   /// Does the CPU side of the rebuild without touching any GFX 
+   /// resources or datablocks so that it can run on a worker thread.
+   virtual void _packBatch() {}
+
    virtual void _rebuildBatch() = 0;
    virtual void _render( const SceneRenderState *state ) = 0;
 
@@ -54,6 +63,14 @@ public:
    bool add( const ForestItem &item );
    S32 getItemCount() const { return mItems.size(); }
 
+   /// Returns true if pack() has work to do before the next render.
+   bool needsPack() const { return mDirty && !mPacked; }
+
+   /// Prepares the rebuild of a changed batch ahead of rendering.  It
+   /// is safe to call from a worker thread as long as the batch isn't
+   /// rendered or changed until it returns.
+   void pack();
+
    void render( SceneRenderState *state );
    const Box3F& getWorldBox() const { return mBounds; }
 };
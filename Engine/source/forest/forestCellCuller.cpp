@@ -0,0 +1,250 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "forest/forestCellCuller.h"
+
+#include "forest/forest.h"
+#include "forest/forestCell.h"
+#include "scene/sceneManager.h"
+#include "scene/sceneRenderState.h"
+#include "math/util/frustum.h"
+#include "platform/threads/threadPoolBatch.h"
+#include "platform/profiler.h"
+
+
+S32 ForestCellCuller::smParallelThreshold = 64;
+
+
+/// Walks a set of forest subtrees on a worker thread.
+struct ForestCellCuller::WorkItem : public ThreadPoolBatch::Item
+{
+   const ForestCellCuller *mOwner;
+   Vector<ForestCell*> mStack;
+   Vector<ForestCulledCell> mCells;
+   U32 mItems;
+
+   WorkItem( const ForestCellCuller *owner )
+      :  mOwner( owner ),
+         mItems( 0 ) {}
+
+protected:
+
+   virtual void executeItem()
+   {
+      mOwner->_cullCells( mStack, &mCells, &mItems );
+   }
+};
+
+
+ForestCellCuller::ForestCellCuller( const Frustum &culler, const Point3F &camPos, const SceneRenderState *state )
+   :  mCuller( culler ),
+      mCamPos( camPos ),
+      mState( state )
+{
+}
+
+ForestCellCuller::CellResult ForestCellCuller::_testCell( ForestCell *cell, ForestCulledCell *outCell, U32 *ioItems ) const
+{
+   const Box3F &cellBounds = cell->getBounds();
+
+   // If the cell is empty or its bounds is outside the frustum
+   // bounds then we have nothing nothing more to do.
+   if ( cell->isEmpty() || !mCuller.getBounds().isOverlapped( cellBounds ) )
+      return CellCulled;
+
+   // Can we cull this cell entirely?
+   const U32 clipMask = mCuller.testPlanes( cellBounds, Frustum::PlaneMaskAll );
+   if ( clipMask == -1 )
+      return CellCulled;
+
+   if ( mState )
+   {
+      const SceneCullingState &cullingState = mState->getCullingState();
+
+      // Test cell visibility for interior zones.      
+      const bool visibleInside = !cell->getZoneOverlap().empty() ? cullingState.getZoneVisibilityFlags().testAny( cell->getZoneOverlap() ) : false;
+
+      // Test cell visibility for outdoor zone, but only
+      // if we need to.
+      bool visibleOutside = false;
+      if( !cell->mIsInteriorOnly && !visibleInside )
+      {         
+         U32 outdoorZone = SceneZoneSpaceManager::RootZoneId;
+         visibleOutside = !cullingState.isCulled( cellBounds, &outdoorZone, 1 );
+      }
+
+      // Skip cell if neither visible indoors nor outdoors.
+      if( !visibleInside && !visibleOutside )
+         return CellCulled;
+   }
+
+   *ioItems += cell->getItems().size();
+
+   outCell->cell = cell;
+   outCell->clipMask = clipMask;
+   outCell->billboard = Forest::smForceImposters;
+
+   // If the largest item in the cell can be billboarded
+   // at the cell distance to the camera... then the whole
+   // cell can be billboarded.
+   if ( !outCell->billboard && mState )
+   {
+      const F32 dist = cellBounds.getDistanceToPoint( mCamPos );
+      const ForestItem &largestItem = cell->getLargestItem();
+
+      if ( dist > 0.0f && largestItem.canBillboard( mState, dist ) )
+      {
+         // If the largest item is too small to see at
+         // this distance then nothing in the cell is.
+         if ( largestItem.isTooSmall( mState, dist ) )
+            return CellCulled;
+
+         outCell->billboard = true;
+      }
+   }
+
+   if ( outCell->billboard )
+   {
+      // If imposters are disabled then skip out.
+      return Forest::smDisableImposters ? CellCulled : CellVisible;
+   }
+
+   // If this isn't a leaf then recurse.
+   return cell->isLeaf() ? CellVisible : CellRecurse;
+}
+
+void ForestCellCuller::_cullCells( Vector<ForestCell*> &stack, Vector<ForestCulledCell> *outCells, U32 *ioItems ) const
+{
+   ForestCulledCell culled;
+
+   // Now loop till we run out of cells.
+   while ( !stack.empty() )
+   {
+      // Pop off the next cell.
+      ForestCell *cell = stack.last();
+      stack.pop_back();
+
+      switch ( _testCell( cell, &culled, ioItems ) )
+      {
+         case CellVisible:
+            outCells->push_back( culled );
+            break;
+
+         case CellRecurse:
+            cell->getChildren( &stack );
+            break;
+
+         default:
+            break;
+      }
+   }
+}
+
+void ForestCellCuller::cull( const Vector<ForestCell*> &rootCells, Vector<ForestCulledCell> *outCells, U32 *outItems ) const
+{
+   PROFILE_SCOPE( ForestCellCuller_cull );
+
+   U32 items = 0;
+   Vector<ForestCell*> frontier( rootCells );
+   const U32 threshold = getMax( smParallelThreshold, 0 );
+
+   // Walk the top of the trees breadth first till we 
+   // have enough cells to split the rest of the walk.
+   if ( threshold != 0 )
+   {
+      Vector<ForestCell*> next;
+      ForestCulledCell culled;
+
+      while ( !frontier.empty() && frontier.size() < threshold )
+      {
+         next.clear();
+
+         for ( U32 i=0; i < frontier.size(); i++ )
+         {
+            switch ( _testCell( frontier[i], &culled, &items ) )
+            {
+               case CellVisible:
+                  outCells->push_back( culled );
+                  break;
+
+               case CellRecurse:
+                  frontier[i]->getChildren( &next );
+                  break;
+
+               default:
+                  break;
+            }
+         }
+
+         frontier = next;
+      }
+   }
+
+   ThreadPool &pool = ThreadPool::GLOBAL();
+
+   U32 numRanges = 1;
+   if ( threshold != 0 && frontier.size() >= threshold )
+   {
+      const U32 minCellsPerRange = getMax( threshold / 2, 1U );
+      numRanges = mClamp( frontier.size() / minCellsPerRange, 1, pool.getNumThreads() + 1 );
+   }
+
+   if ( numRanges < 2 )
+   {
+      _cullCells( frontier, outCells, &items );
+
+      if ( outItems )
+         *outItems = items;
+
+      return;
+   }
+
+   PROFILE_SCOPE( ForestCellCuller_cull_Parallel );
+
+   Vector< ThreadSafeRef< WorkItem > > workItems;
+   workItems.setSize( numRanges );
+
+   ThreadPoolBatch batch;
+
+   for ( U32 i=0; i < numRanges; i++ )
+      workItems[i] = new WorkItem( this );
+
+   // Deal out the cells so that each worker gets 
+   // a mix of near and far subtrees.
+   for ( U32 i=0; i < frontier.size(); i++ )
+      workItems[ i % numRanges ]->mStack.push_back( frontier[i] );
+
+   for ( U32 i=0; i < numRanges; i++ )
+      batch.add( workItems[i] );
+
+   batch.wait();
+
+   for ( U32 i=0; i < numRanges; i++ )
+   {
+      outCells->merge( workItems[i]->mCells );
+      items += workItems[i]->mItems;
+   }
+
+   if ( outItems )
+      *outItems = items;
+}
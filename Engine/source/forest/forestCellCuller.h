@@ -0,0 +1,115 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _FORESTCELLCULLER_H_
+#define _FORESTCELLCULLER_H_
+
+#ifndef _TVECTOR_H_
+#include "core/util/tVector.h"
+#endif
+#ifndef _MPOINT3_H_
+#include "math/mPoint3.h"
+#endif
+
+class ForestCell;
+class Frustum;
+class SceneRenderState;
+
+
+/// A visible cell found by ForestCellCuller.
+struct ForestCulledCell
+{
+   ForestCell *cell;
+
+   /// The frustum planes the cell bounds intersect or
+   /// zero if the cell is fully within the frustum.
+   U32 clipMask;
+
+   /// If true the whole cell is rendered with imposter 
+   /// batches else it is a leaf cell whose items are
+   /// rendered individually.
+   bool billboard;
+};
+
+
+/// Walks the forest cell quad trees finding the visible cells 
+/// and picking which are rendered as imposter batches.
+///
+/// The top of the trees is walked on the calling thread until there
+/// are enough cells to split the rest of the walk across the global
+/// thread pool.  Each worker walks whole subtrees so that the lazy
+/// cell bounds updates never touch a cell shared with another worker.
+///
+/// @note Like ThreadPoolBatch this must only be used from the main thread.
+///
+class ForestCellCuller
+{
+protected:
+
+   const Frustum &mCuller;
+
+   const Point3F mCamPos;
+
+   /// The optional scene state used for zone culling and
+   /// for the item level of detail.  Without it only the 
+   /// frustum is tested and nothing is billboarded unless
+   /// Forest::smForceImposters is set.
+   const SceneRenderState *mState;
+
+   /// The result of testing one cell.
+   enum CellResult
+   {
+      CellCulled,
+      CellVisible,
+      CellRecurse,
+   };
+
+   /// Tests the cell and adds the number of items in it
+   /// to the count if it passes the visibility tests.
+   CellResult _testCell( ForestCell *cell, ForestCulledCell *outCell, U32 *ioItems ) const;
+
+   /// Walks the cells and their children depth first.
+   void _cullCells( Vector<ForestCell*> &stack, Vector<ForestCulledCell> *outCells, U32 *ioItems ) const;
+
+   struct WorkItem;
+
+public:
+
+   /// The number of cells which must be reached at the top of 
+   /// the trees before the walk is split across the thread pool.
+   /// Zero or less always walks on the calling thread.  It is exposed
+   /// to the console as $Forest::parallelCullThreshold.
+   static S32 smParallelThreshold;
+
+   ForestCellCuller( const Frustum &culler, const Point3F &camPos, const SceneRenderState *state );
+
+   /// Finds the visible cells under the root cells.
+   ///
+   /// @param rootCells The top level cells which are tested first.
+   /// @param outCells The visible cells.  The order is not defined.
+   /// @param outItems Optionally returns the number of items in all
+   ///   the cells which passed the visibility tests.
+   ///
+   void cull( const Vector<ForestCell*> &rootCells, Vector<ForestCulledCell> *outCells, U32 *outItems = NULL ) const;
+};
+
+#endif // _FORESTCELLCULLER_H_
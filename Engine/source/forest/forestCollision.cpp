@@ -396,7 +396,7 @@ bool ForestCell::castRay( const Point3F &start, const Point3F &end, RayInfo *out
    {
       for ( U32 i = 0; i < mItems.size(); i++ )
       {     
-         if ( mItems[i].castRay( start, end, outInfo, rendered ) )
+         if ( mItems.getItem( i ).castRay( start, end, outInfo, rendered ) )
          {
             if ( outInfo->t < shortest.t )
                shortest = *outInfo;
@@ -302,10 +302,10 @@ void ForestData::_onItemReload()
    }
 }
 
-const ForestItem& ForestData::addItem( ForestItemData *data,
-                                       const Point3F &position,
-                                       F32 rotation,
-                                       F32 scale )
+ForestItem ForestData::addItem(  ForestItemData *data,
+                                 const Point3F &position,
+                                 F32 rotation,
+                                 F32 scale )
 {
    MatrixF xfm;
    xfm.set( EulerF( 0, 0, rotation ), position );
@@ -316,10 +316,10 @@ const ForestItem& ForestData::addItem( ForestItemData *data,
                      scale );
 }
 
-const ForestItem& ForestData::addItem( ForestItemKey key,
-                                       ForestItemData *data,
-                                       const MatrixF &xfm,
-                                       F32 scale )
+ForestItem ForestData::addItem(  ForestItemKey key,
+                                 ForestItemData *data,
+                                 const MatrixF &xfm,
+                                 F32 scale )
 {
    ForestCell *bucket = _findOrCreateBucket( xfm.getPosition() );
    
@@ -328,11 +328,11 @@ const ForestItem& ForestData::addItem( ForestItemKey key,
    return bucket->insertItem( key, data, xfm, scale );
 }
 
-const ForestItem& ForestData::updateItem( ForestItemKey key,
-                                          const Point3F &keyPosition,
-                                          ForestItemData *newData,
-                                          const MatrixF &newXfm,
-                                          F32 newScale )
+ForestItem ForestData::updateItem(  ForestItemKey key,
+                                    const Point3F &keyPosition,
+                                    ForestItemData *newData,
+                                    const MatrixF &newXfm,
+                                    F32 newScale )
 {
    Point2I bucketKey = _getBucketKey( keyPosition );
 
@@ -350,7 +350,7 @@ const ForestItem& ForestData::updateItem( ForestItemKey key,
    return addItem( key, newData, newXfm, newScale );
 }
 
-const ForestItem& ForestData::updateItem( ForestItem &item )
+ForestItem ForestData::updateItem( ForestItem &item )
 {
    return updateItem( item.getKey(), 
                       item.getPosition(), 
@@ -379,7 +379,7 @@ bool ForestData::removeItem( ForestItemKey key, const Point3F &keyPosition )
    return true;
 }
 
-const ForestItem& ForestData::findItem( ForestItemKey key, const Point3F &keyPos ) const
+ForestItem ForestData::findItem( ForestItemKey key, const Point3F &keyPos ) const
 {
    PROFILE_SCOPE( ForestData_findItem );
 
@@ -392,12 +392,12 @@ const ForestItem& ForestData::findItem( ForestItemKey key, const Point3F &keyPos
 
    U32 index;
    if ( cell && cell->findIndexByKey( key, &index ) )
-      return cell->getItems()[ index ];
+      return cell->getItems().getItem( index );
 
    return ForestItem::Invalid;
 }
 
-const ForestItem& ForestData::findItem( ForestItemKey key ) const
+ForestItem ForestData::findItem( ForestItemKey key ) const
 {
    PROFILE_SCOPE( ForestData_findItem_Slow );
 
@@ -428,7 +428,7 @@ const ForestItem& ForestData::findItem( ForestItemKey key ) const
       // Finally search for the item.
       U32 index;
       if ( cell->findIndexByKey( key, &index ) )
-         return cell->getItems()[ index ];
+         return cell->getItems().getItem( index );
    }
 
    return ForestItem::Invalid;
@@ -463,7 +463,7 @@ U32 ForestData::getItems( Vector<ForestItem> *outItems ) const
 
       // Get the items.
       count += cell->getItems().size();
-      outItems->merge( cell->getItems() );
+      cell->getItems().getItems( outItems );
    }
 
    return count;
@@ -477,7 +477,6 @@ U32 ForestData::getItems( const Frustum &culler, Vector<ForestItem> *outItems )
 
    Vector<ForestCell*> stack;
    getCells( &stack );
-   Vector<ForestItem>::const_iterator iter;
    U32 count = 0;
 
    // Now loop till we run out of cells.
@@ -498,12 +497,13 @@ U32 ForestData::getItems( const Frustum &culler, Vector<ForestItem> *outItems )
       }
 
       // Get the items.
-      iter = cell->getItems().begin();
-      for ( ; iter != cell->getItems().end(); iter++ )
+      const ForestItemStore &items = cell->getItems();
+      for ( U32 i=0; i < items.size(); i++ )
       {
-         if ( !culler.isCulled( iter->getWorldBox() ) )
+         const ForestItem item = items.getItem( i );
+         if ( !culler.isCulled( item.getWorldBox() ) )
          {
-            outItems->merge( cell->getItems() );
+            outItems->push_back( item );
             count++;
          }
       }
@@ -543,11 +543,11 @@ U32 ForestData::getItems( const Box3F &box, Vector<ForestItem> *outItems ) const
       }
 
       // Finally look thru the items.
-      const Vector<ForestItem> &items = cell->getItems();
-      Vector<ForestItem>::const_iterator item = items.begin();
-      for ( ; item != items.end(); item++ )
+      const ForestItemStore &items = cell->getItems();
+      for ( U32 i=0; i < items.size(); i++ )
       {
-         if ( item->getWorldBox().isOverlapped( box ) )
+         const ForestItem item = items.getItem( i );
+         if ( item.getWorldBox().isOverlapped( box ) )
          {
             // If we don't have an output vector then the user just
             // wanted to know if any object existed... so early out.
@@ -555,7 +555,7 @@ U32 ForestData::getItems( const Box3F &box, Vector<ForestItem> *outItems ) const
                return 1;
 
             ++count;
-            outItems->push_back( *item );
+            outItems->push_back( item );
          }
       }
    }
@@ -600,11 +600,11 @@ U32 ForestData::getItems( const Point3F &point, F32 radius, Vector<ForestItem> *
       }
 
       // Finally look thru the items.
-      const Vector<ForestItem> &items = cell->getItems();
-      Vector<ForestItem>::const_iterator item = items.begin();
-      for ( ; item != items.end(); item++ )
+      const ForestItemStore &items = cell->getItems();
+      for ( U32 i=0; i < items.size(); i++ )
       {
-         if ( item->getWorldBox().getSqDistanceToPoint( point ) < radiusSq )
+         const ForestItem item = items.getItem( i );
+         if ( item.getWorldBox().getSqDistanceToPoint( point ) < radiusSq )
          {
             // If we don't have an output vector then the user just
             // wanted to know if any object existed... so early out.
@@ -612,7 +612,7 @@ U32 ForestData::getItems( const Point3F &point, F32 radius, Vector<ForestItem> *
                return 1;
 
             ++count;
-            outItems->push_back( *item );
+            outItems->push_back( item );
          }
       }
    }
@@ -654,13 +654,13 @@ U32 ForestData::getItems( const Point2F &point, F32 radius, Vector<ForestItem> *
       }
 
       // Finally look thru the items.
-      const Vector<ForestItem> &items = cell->getItems();
-      Vector<ForestItem>::const_iterator item = items.begin();
+      const ForestItemStore &items = cell->getItems();
       F32 compareDist;
-      for ( ; item != items.end(); item++ )
+      for ( U32 i=0; i < items.size(); i++ )
       {
-         compareDist = mSquared( radius + item->getData()->mRadius );
-         if ( item->getSqDistanceToPoint( point ) < compareDist )
+         const ForestItem item = items.getItem( i );
+         compareDist = mSquared( radius + item.getData()->mRadius );
+         if ( item.getSqDistanceToPoint( point ) < compareDist )
          {
             // If we don't have an output vector then the user just
             // wanted to know if any object existed... so early out.
@@ -668,7 +668,7 @@ U32 ForestData::getItems( const Point2F &point, F32 radius, Vector<ForestItem> *
                return 1;
 
             ++count;
-            outItems->push_back( *item );
+            outItems->push_back( item );
          }
       }
    }
@@ -704,14 +704,13 @@ U32 ForestData::getItems( const ForestItemData *data, Vector<ForestItem> *outIte
       }
 
       // Get the items.
-      const Vector<ForestItem> &items = cell->getItems();
-      Vector<ForestItem>::const_iterator item = items.begin();
-      for ( ; item != items.end(); item++ )
+      const ForestItemStore &items = cell->getItems();
+      for ( U32 i=0; i < items.size(); i++ )
       {
-         if ( item->getData() == data )
+         if ( items.getData( i ) == data )
          {
             ++count;
-            outItems->push_back( *item );
+            outItems->push_back( items.getItem( i ) );
          }
       }
    }
@@ -764,11 +763,10 @@ U32 ForestData::getDatablocks( Vector<ForestItemData*> *outVector ) const
       }
 
       // Go thru the items.
-      const Vector<ForestItem> &items = cell->getItems();
-      Vector<ForestItem>::const_iterator item = items.begin();
-      for ( ; item != items.end(); item++ )
+      const ForestItemStore &items = cell->getItems();
+      for ( U32 i=0; i < items.size(); i++ )
       {
-         ForestItemData *data = item->getData();
+         ForestItemData *data = items.getData( i );
 
          if (T3D::find( outVector->begin(), outVector->end(), data ) != outVector->end() )
             continue;
@@ -97,32 +97,36 @@ class ForestData
       ///
       bool write( const char *path );
 
-      const ForestItem& addItem( ForestItemData *data,
-                                 const Point3F &position,
-                                 F32 rotation,
-                                 F32 scale );
-
-      const ForestItem& addItem( ForestItemKey key,
-                                 ForestItemData *data,
-                                 const MatrixF &xfm,
-                                 F32 scale );
-
-      const ForestItem& updateItem( ForestItemKey key,
-                                    const Point3F &keyPosition,
-                                    ForestItemData *newData,
-                                    const MatrixF &newXfm,
-                                    F32 newscale );
+      /// Adds the item and returns it as it was stored.  The cells
+      /// store items compactly so the returned transform and scale 
+      /// may differ very slightly from the ones passed.
+      /// @see ForestItemStore
+      ForestItem addItem(  ForestItemData *data,
+                           const Point3F &position,
+                           F32 rotation,
+                           F32 scale );
+
+      ForestItem addItem(  ForestItemKey key,
+                           ForestItemData *data,
+                           const MatrixF &xfm,
+                           F32 scale );
+
+      ForestItem updateItem(  ForestItemKey key,
+                              const Point3F &keyPosition,
+                              ForestItemData *newData,
+                              const MatrixF &newXfm,
+                              F32 newscale );
      
-      const ForestItem& updateItem( ForestItem &item );
+      ForestItem updateItem( ForestItem &item );
 
       bool removeItem( ForestItemKey key, const Point3F &keyPosition );
 
       /// Performs a search using the position to limit tested cells.
-      const ForestItem& findItem( ForestItemKey key, const Point3F &keyPosition ) const;
+      ForestItem findItem( ForestItemKey key, const Point3F &keyPosition ) const;
 
       /// Does an exhaustive search thru all cells looking for 
       /// the item.  This method is slow and should be avoided.
-      const ForestItem& findItem( ForestItemKey key ) const;
+      ForestItem findItem( ForestItemKey key ) const;
 
       /// Fills a vector with a copy of all the items in the data set.
       ///
@@ -131,8 +131,15 @@ public:
 
    virtual bool render( TSRenderState *rdata, const ForestItem &item ) const { return false; }
 
+   /// Returns true if the item can be rendered as an imposter at the distance.
+   /// @note This is called from the forest culling threads so it must not 
+   /// change any state.
    virtual bool canBillboard( const SceneRenderState *state, const ForestItem &item, F32 distToCamera ) const { return false; }
 
+   /// Returns true if the item is too small to be seen at the distance.
+   /// @note Like canBillboard this is called from the forest culling threads.
+   virtual bool isTooSmall( const SceneRenderState *state, const ForestItem &item, F32 distToCamera ) const { return false; }
+
    virtual ForestCellBatch* allocateBatch() const { return NULL; }
 
    typedef Signal<void(void)> ReloadSignal;
@@ -242,6 +249,11 @@ public:
       return mDataBlock && mDataBlock->canBillboard( state, *this, distToCamera );
    }
 
+   inline bool isTooSmall( const SceneRenderState *state, F32 distToCamera ) const
+   {
+      return mDataBlock && mDataBlock->isTooSmall( state, *this, distToCamera );
+   }
+
    /// Collision
    /// @{
    
@@ -0,0 +1,364 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "forest/forestItemStore.h"
+
+#include "platform/profiler.h"
+
+
+const F32 ForestItemStore::PositionTolerance = 0.02f;
+const F32 ForestItemStore::RotationTolerance = 0.0001f;
+const F32 ForestItemStore::ScaleTolerance = 0.001f;
+
+bool ForestItemStore::smCompactItems = true;
+
+
+ForestItemStore::ForestItemStore( const RectF &rect )
+   :  mRect( rect )
+{
+}
+
+void ForestItemStore::clear()
+{
+   mKeys.clear();
+   mPosX.clear();
+   mPosY.clear();
+   mPosZ.clear();
+   mYaw.clear();
+   mScale.clear();
+   mData.clear();
+   mDataPalette.clear();
+   mFullKeys.clear();
+   mFullXfms.clear();
+   mFullScales.clear();
+   mFullData.clear();
+}
+
+void ForestItemStore::compact()
+{
+   mKeys.compact();
+   mPosX.compact();
+   mPosY.compact();
+   mPosZ.compact();
+   mYaw.compact();
+   mScale.compact();
+   mData.compact();
+   mDataPalette.compact();
+   mFullKeys.compact();
+   mFullXfms.compact();
+   mFullScales.compact();
+   mFullData.compact();
+}
+
+bool ForestItemStore::findIndexByKey( ForestItemKey key, U32 *outIndex ) const
+{
+   // Do a simple binary search.
+
+   U32   i = 0,
+         lo = 0,
+         hi = mKeys.size();
+   
+   const ForestItemKey *keys = mKeys.address();
+
+   while ( lo < hi ) 
+   {
+      i = (lo + hi) / 2;
+
+      if ( key < keys[i] )
+         hi = i;
+      else if ( key > keys[i] )
+         lo = i + 1;
+      else
+      {
+         *outIndex = i;
+         return true;
+      }
+   }
+
+   *outIndex = lo;
+   return false;
+}
+
+S32 ForestItemStore::_findFull( ForestItemKey key ) const
+{
+   U32   lo = 0,
+         hi = mFullKeys.size();
+
+   while ( lo < hi ) 
+   {
+      const U32 i = (lo + hi) / 2;
+
+      if ( key < mFullKeys[i] )
+         hi = i;
+      else if ( key > mFullKeys[i] )
+         lo = i + 1;
+      else
+         return i;
+   }
+
+   return -1;
+}
+
+void ForestItemStore::_eraseFull( ForestItemKey key )
+{
+   const S32 index = _findFull( key );
+   if ( index < 0 )
+      return;
+
+   mFullKeys.erase( index );
+   mFullXfms.erase( index );
+   mFullScales.erase( index );
+   mFullData.erase( index );
+}
+
+U8 ForestItemStore::_getDataIndex( ForestItemData *data )
+{
+   for ( U32 i=0; i < mDataPalette.size(); i++ )
+   {
+      if ( mDataPalette[i] == data )
+         return i;
+   }
+
+   // Datablocks are never removed from the palette as items
+   // are erased, so clean it up before it overflows.
+   if ( mDataPalette.size() >= FullData )
+      _compactPalette();
+
+   // Any more datablocks than that go in the side table.
+   if ( mDataPalette.size() >= FullData )
+      return FullData;
+
+   mDataPalette.push_back( data );
+   return mDataPalette.size() - 1;
+}
+
+void ForestItemStore::_compactPalette()
+{
+   Vector<ForestItemData*> palette;
+   U8 remap[ U8_MAX + 1 ];
+   remap[ FullData ] = FullData;
+
+   for ( U32 i=0; i < mDataPalette.size(); i++ )
+   {
+      // Only keep the datablocks still in use.
+      if ( T3D::find( mData.begin(), mData.end(), (U8)i ) == mData.end() )
+         continue;
+
+      remap[i] = palette.size();
+      palette.push_back( mDataPalette[i] );
+   }
+
+   for ( U32 i=0; i < mData.size(); i++ )
+      mData[i] = remap[ mData[i] ];
+
+   mDataPalette = palette;
+}
+
+bool ForestItemStore::_quantize( const MatrixF &xfm, 
+                                 F32 scale, 
+                                 U16 *outX, 
+                                 U16 *outY, 
+                                 U16 *outYaw, 
+                                 U16 *outScale ) const
+{
+   if ( !smCompactItems )
+      return false;
+
+   // The position must stay within the cell so that
+   // the item is still found by its position.
+   const Point3F pos = xfm.getPosition();
+   const F32 stepX = mRect.extent.x / 65536.0f;
+   const F32 stepY = mRect.extent.y / 65536.0f;
+   const F32 qx = mFloor( ( pos.x - mRect.point.x ) / stepX + 0.5f );
+   const F32 qy = mFloor( ( pos.y - mRect.point.y ) / stepY + 0.5f );
+   if ( qx < 0.0f || qx > 65535.0f || qy < 0.0f || qy > 65535.0f )
+      return false;
+
+   const F32 x = mRect.point.x + qx * stepX;
+   const F32 y = mRect.point.y + qy * stepY;
+   if (  mFabs( x - pos.x ) > PositionTolerance ||
+         mFabs( y - pos.y ) > PositionTolerance ||
+         x >= mRect.point.x + mRect.extent.x ||
+         y >= mRect.point.y + mRect.extent.y )
+      return false;
+
+   // Find the yaw and make sure rebuilding the
+   // rotation from it gives back the same matrix.
+   const F32 *m = xfm;
+   F32 turns = mAtan2( m[ MatrixF::idx( 0, 1 ) ], m[ MatrixF::idx( 1, 1 ) ] ) / M_2PI_F;
+   if ( turns < 0.0f )
+      turns += 1.0f;
+   const U32 yaw = (U32)( turns * 65535.0f + 0.5f ) % 65535;
+
+   MatrixF rot;
+   rot.set( EulerF( 0.0f, 0.0f, yaw * ( M_2PI_F / 65535.0f ) ) );
+   const F32 *r = rot;
+   for ( U32 row=0; row < 3; row++ )
+   {
+      for ( U32 col=0; col < 3; col++ )
+      {
+         const U32 i = MatrixF::idx( row, col );
+         if ( mFabs( r[i] - m[i] ) > RotationTolerance )
+            return false;
+      }
+   }
+
+   const F32 qscale = mFloor( scale * ( 1 << ScaleShift ) + 0.5f );
+   if (  qscale < 1.0f || 
+         qscale > 65535.0f ||
+         mFabs( qscale / ( 1 << ScaleShift ) - scale ) > scale * ScaleTolerance )
+      return false;
+
+   *outX = (U16)qx;
+   *outY = (U16)qy;
+   *outYaw = (U16)yaw;
+   *outScale = (U16)qscale;
+   return true;
+}
+
+void ForestItemStore::set( U32 index, bool insert, ForestItemKey key, ForestItemData *data, const MatrixF &xfm, F32 scale )
+{
+   if ( insert )
+   {
+      mKeys.insert( index, key );
+      mPosX.insert( index );
+      mPosY.insert( index );
+      mPosZ.insert( index );
+      mYaw.insert( index );
+      mScale.insert( index );
+      mData.insert( index, 0 );
+   }
+   else if ( isFullTransform( index ) )
+      _eraseFull( key );
+
+   AssertFatal( mKeys[index] == key, "ForestItemStore::set() - Got the wrong key!" );
+
+   mData[index] = _getDataIndex( data );
+   mPosZ[index] = xfm.getPosition().z;
+
+   if (  mData[index] != FullData &&
+         _quantize( xfm, scale, &mPosX[index], &mPosY[index], &mYaw[index], &mScale[index] ) )
+      return;
+
+   // Keep the full transform in the side table.
+   mYaw[index] = FullTransform;
+
+   U32 fullIndex = 0;
+   while ( fullIndex < mFullKeys.size() && mFullKeys[fullIndex] < key )
+      fullIndex++;
+
+   mFullKeys.insert( fullIndex, key );
+   mFullXfms.insert( fullIndex, xfm );
+   mFullScales.insert( fullIndex, scale );
+   mFullData.insert( fullIndex, data );
+}
+
+void ForestItemStore::erase( U32 index )
+{
+   if ( isFullTransform( index ) )
+      _eraseFull( mKeys[index] );
+
+   mKeys.erase( index );
+   mPosX.erase( index );
+   mPosY.erase( index );
+   mPosZ.erase( index );
+   mYaw.erase( index );
+   mScale.erase( index );
+   mData.erase( index );
+}
+
+ForestItemData* ForestItemStore::getData( U32 index ) const
+{
+   if ( mData[index] == FullData )
+      return mFullData[ _findFull( mKeys[index] ) ];
+
+   return mDataPalette[ mData[index] ];
+}
+
+Point3F ForestItemStore::getPosition( U32 index ) const
+{
+   if ( isFullTransform( index ) )
+      return mFullXfms[ _findFull( mKeys[index] ) ].getPosition();
+
+   return Point3F(   mRect.point.x + mPosX[index] * ( mRect.extent.x / 65536.0f ),
+                     mRect.point.y + mPosY[index] * ( mRect.extent.y / 65536.0f ),
+                     mPosZ[index] );
+}
+
+F32 ForestItemStore::getScale( U32 index ) const
+{
+   if ( isFullTransform( index ) )
+      return mFullScales[ _findFull( mKeys[index] ) ];
+
+   return (F32)mScale[index] / ( 1 << ScaleShift );
+}
+
+void ForestItemStore::getTransform( U32 index, MatrixF *outXfm ) const
+{
+   if ( isFullTransform( index ) )
+   {
+      *outXfm = mFullXfms[ _findFull( mKeys[index] ) ];
+      return;
+   }
+
+   outXfm->set( EulerF( 0.0f, 0.0f, mYaw[index] * ( M_2PI_F / 65535.0f ) ), getPosition( index ) );
+}
+
+ForestItem ForestItemStore::getItem( U32 index ) const
+{
+   MatrixF xfm;
+   getTransform( index, &xfm );
+
+   ForestItem item;
+   item.setKey( mKeys[index] );
+   item.setData( getData( index ) );
+   item.setTransform( xfm, getScale( index ) );
+   return item;
+}
+
+void ForestItemStore::getItems( Vector<ForestItem> *outItems ) const
+{
+   PROFILE_SCOPE( ForestItemStore_getItems );
+
+   const U32 start = outItems->size();
+   outItems->setSize( start + mKeys.size() );
+
+   for ( U32 i=0; i < mKeys.size(); i++ )
+      (*outItems)[ start + i ] = getItem( i );
+}
+
+U32 ForestItemStore::getMemoryUsage() const
+{
+   return   mKeys.memSize() +
+            mPosX.memSize() +
+            mPosY.memSize() +
+            mPosZ.memSize() +
+            mYaw.memSize() +
+            mScale.memSize() +
+            mData.memSize() +
+            mDataPalette.memSize() +
+            mFullKeys.memSize() +
+            mFullXfms.memSize() +
+            mFullScales.memSize() +
+            mFullData.memSize();
+}
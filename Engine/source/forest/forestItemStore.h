@@ -0,0 +1,188 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _FORESTITEMSTORE_H_
+#define _FORESTITEMSTORE_H_
+
+#ifndef _FORESTITEM_H_
+#include "forest/forestItem.h"
+#endif
+
+
+/// A compact structure of arrays store for the items 
+/// within a leaf ForestCell.
+///
+/// Most items are only positioned, rotated about the up axis and
+/// uniformly scaled.  These are stored as a position quantized
+/// relative to the cell rect, a quantized yaw and scale, and an
+/// index into a small per-cell datablock palette.
+///
+/// Items with any other rotation or which would move more than
+/// the tolerances when quantized keep their full transform in a
+/// side table, so nothing placed in the editor is ever mangled.
+/// So do the items whose datablock doesn't fit in the palette.
+///
+/// The items are sorted by key and are decoded into a full
+/// ForestItem on request.
+///
+class ForestItemStore
+{
+protected:
+
+   /// The rect the item positions are quantized to.
+   RectF mRect;
+
+   /// The sorted item keys.
+   Vector<ForestItemKey> mKeys;
+
+   /// The position within the cell rect quantized 
+   /// to 1/65536 of the rect extent.
+   Vector<U16> mPosX;
+   Vector<U16> mPosY;
+
+   /// The position height which isn't bounded by the cell.
+   Vector<F32> mPosZ;
+
+   /// The rotation about the up axis quantized to 1/65535
+   /// of a circle or FullTransform if the item is stored 
+   /// in the full transform side table.
+   Vector<U16> mYaw;
+
+   /// The scale in 4.12 fixed point.
+   Vector<U16> mScale;
+
+   /// The index into the datablock palette or FullData
+   /// if the datablock is in the side table.
+   Vector<U8> mData;
+
+   /// The datablocks used by the items.
+   Vector<ForestItemData*> mDataPalette;
+
+   /// The keys of the items with full transforms sorted
+   /// in the same order as the main arrays.
+   Vector<ForestItemKey> mFullKeys;
+   Vector<MatrixF> mFullXfms;
+   Vector<F32> mFullScales;
+   Vector<ForestItemData*> mFullData;
+
+   /// Returns the full transform side table index
+   /// of the item key or -1 if it has none.
+   S32 _findFull( ForestItemKey key ) const;
+
+   void _eraseFull( ForestItemKey key );
+
+   /// Returns the palette index of the datablock adding it
+   /// if needed, or FullData if the palette is full.
+   U8 _getDataIndex( ForestItemData *data );
+
+   /// Removes the datablocks no item uses from the palette.
+   void _compactPalette();
+
+   /// Quantizes the transform and scale and returns true if
+   /// they are within the tolerances.
+   bool _quantize(   const MatrixF &xfm, 
+                     F32 scale, 
+                     U16 *outX, 
+                     U16 *outY, 
+                     U16 *outYaw, 
+                     U16 *outScale ) const;
+
+public:
+
+   enum 
+   {
+      /// The yaw value which marks an item as
+      /// stored in the full transform side table.
+      FullTransform = U16_MAX,
+
+      /// The palette index which marks an item's datablock
+      /// as stored in the full transform side table.
+      FullData = U8_MAX,
+
+      /// The number of fractional bits in the scale.
+      ScaleShift = 12,
+   };
+
+   /// The largest distance an item may move when it is quantized.
+   static const F32 PositionTolerance;
+
+   /// The largest change in any rotation matrix element 
+   /// when the yaw is quantized.
+   static const F32 RotationTolerance;
+
+   /// The largest relative change in scale when it is quantized.
+   static const F32 ScaleTolerance;
+
+   /// If false all items are stored with their full transform.
+   /// It is exposed to the console as $Forest::compactItems.
+   static bool smCompactItems;
+
+   ForestItemStore( const RectF &rect );
+
+   /// Returns the number of items.
+   U32 size() const { return mKeys.size(); }
+
+   bool empty() const { return mKeys.empty(); }
+
+   /// Removes all the items.
+   void clear();
+
+   /// Releases any unused memory.
+   void compact();
+
+   /// The find function does a binary search thru the sorted
+   /// keys.  If the key is found then the index is the position 
+   /// of the item. If the key is not found the index is the 
+   /// correct insertion position for adding the new item.
+   bool findIndexByKey( ForestItemKey key, U32 *outIndex ) const;
+
+   /// Inserts the item at the insertion index from findIndexByKey 
+   /// or replaces the item already at the index.
+   void set( U32 index, bool insert, ForestItemKey key, ForestItemData *data, const MatrixF &xfm, F32 scale );
+
+   /// Removes the item at the index.
+   void erase( U32 index );
+
+   ForestItemKey getKey( U32 index ) const { return mKeys[index]; }
+
+   ForestItemData* getData( U32 index ) const;
+
+   /// Returns true if the item is stored with its full transform.
+   bool isFullTransform( U32 index ) const { return mYaw[index] == FullTransform; }
+
+   Point3F getPosition( U32 index ) const;
+
+   F32 getScale( U32 index ) const;
+
+   void getTransform( U32 index, MatrixF *outXfm ) const;
+
+   /// Decodes the item at the index.
+   ForestItem getItem( U32 index ) const;
+
+   /// Decodes and appends all the items.
+   void getItems( Vector<ForestItem> *outItems ) const;
+
+   /// Returns the number of bytes allocated by the store.
+   U32 getMemoryUsage() const;
+};
+
+#endif // _FORESTITEMSTORE_H_
@@ -24,6 +24,8 @@
 
 #include "forest/forest.h"
 #include "forest/forestCell.h"
+#include "forest/forestCellBatch.h"
+#include "forest/forestCellCuller.h"
 #include "forest/forestDataFile.h"
 
 #include "gfx/gfxTransformSaver.h"
@@ -38,6 +40,7 @@
 #include "gfx/primBuilder.h"
 #include "gfx/gfxDrawUtil.h"
 #include "math/mathUtils.h"
+#include "platform/threads/threadPoolBatch.h"
 
 
 U32   Forest::smTotalCells = 0;
@@ -61,6 +64,23 @@ void Forest::_clearStats(bool beginFrame)
    }
 }
 
+/// Packs a set of imposter batches on a worker thread.
+struct ForestBatchPackWorkItem : public ThreadPoolBatch::Item
+{
+   /// The most batches packed by one work item.
+   static const U32 MaxBatches = 16;
+
+   Vector<ForestCellBatch*> mBatches;
+
+protected:
+
+   virtual void executeItem()
+   {
+      for ( U32 i=0; i < mBatches.size(); i++ )
+         mBatches[i]->pack();
+   }
+};
+
 void Forest::prepRenderImage( SceneRenderState *state )
 {
    PROFILE_SCOPE(Forest_RenderCells);
@@ -119,134 +139,111 @@ void Forest::prepRenderImage( SceneRenderState *state )
       culler.setFarDist( visFarDist );
    }
 
-   Box3F worldBox;
-
    // Used for debug drawing.
    GFXDrawUtil* drawer = GFX->getDrawUtil();
    drawer->clearBitmapModulation();
 
-   // Go thru the visible cells.
-   const Box3F &cullerBounds = culler.getBounds();
+   // Find the visible cells.
    const Point3F &camPos = state->getDiffuseCameraPosition();
    
-   U32 clipMask;
-   smAverageItemsPerCell = 0.0f;
-   U32 cellsProcessed = 0;
-   ForestCell *cell;
-   
    // First get all the top level cells which 
    // intersect the frustum.
-   Vector<ForestCell*> cellStack;
-   mData->getCells( culler, &cellStack );
-
-   // Get the culling zone state.
-   const BitVector &zoneState = state->getCullingState().getZoneVisibilityFlags();
-
-   // Now loop till we run out of cells.
-   while ( !cellStack.empty() )
+   Vector<ForestCell*> rootCells;
+   mData->getCells( culler, &rootCells );
+
+   // Walk the cell trees which is split across the
+   // thread pool for large forests.
+   Vector<ForestCulledCell> cells;
+   U32 cellItems = 0;
+   ForestCellCuller( culler, camPos, state ).cull( rootCells, &cells, &cellItems );
+
+   // Update the stats.
+   smAverageItemsPerCell = (F32)cellItems;
+   const U32 cellsProcessed = cells.size();
+
+   // Create any missing batches for the billboarded cells and 
+   // pack the changed ones on the thread pool while we render 
+   // the items of the other cells.
+   Vector< ThreadSafeRef< ForestBatchPackWorkItem > > packItems;
+   ThreadPoolBatch packBatch;
+
+   for ( U32 i=0; i < cells.size(); i++ )
    {
-      // Pop off the next cell.
-      cell = cellStack.last();
-      cellStack.pop_back();
-
-      const Box3F &cellBounds = cell->getBounds();
-
-      // If the cell is empty or its bounds is outside the frustum
-      // bounds then we have nothing nothing more to do.
-      if ( cell->isEmpty() || !cullerBounds.isOverlapped( cellBounds ) )
+      if ( !cells[i].billboard )
          continue;
 
-      // Can we cull this cell entirely?
-      clipMask = culler.testPlanes( cellBounds, Frustum::PlaneMaskAll );
-      if ( clipMask == -1 )
-         continue;
-
-      // Test cell visibility for interior zones.      
-      const bool visibleInside = !cell->getZoneOverlap().empty() ? zoneState.testAny( cell->getZoneOverlap() ) : false;
+      ForestCell *cell = cells[i].cell;
 
-      // Test cell visibility for outdoor zone, but only
-      // if we need to.
-      bool visibleOutside = false;
-      if( !cell->mIsInteriorOnly && !visibleInside )
-      {         
-         U32 outdoorZone = SceneZoneSpaceManager::RootZoneId;
-         visibleOutside = !state->getCullingState().isCulled( cellBounds, &outdoorZone, 1 );
-      }
+      // Ok... everything in this cell should be batched.  First
+      // create the batches if we don't have any.
+      if ( !cell->hasBatches() )
+         cell->buildBatches();
 
-      // Skip cell if neither visible indoors nor outdoors.
-      if( !visibleInside && !visibleOutside )
-         continue;
-
-      // Update the stats.
-      smAverageItemsPerCell += cell->getItems().size();
-      ++cellsProcessed;
-      //if ( cell->isLeaf() )
-         //++leafCellsProcessed;
-
-      // Get the distance from the camera to the cell bounds.
-      F32 dist = cellBounds.getDistanceToPoint( camPos );
-
-      // If the largest item in the cell can be billboarded
-      // at the cell distance to the camera... then the whole
-      // cell can be billboarded.
-      //
-      if (  smForceImposters || 
-            ( dist > 0.0f && cell->getLargestItem().canBillboard( state, dist ) ) )
+      const Vector<ForestCellBatch*> &batches = cell->getBatches();
+      for ( U32 j=0; j < batches.size(); j++ )
       {
-         // If imposters are disabled then skip out.
-         if ( smDisableImposters )
+         if ( !batches[j]->needsPack() )
             continue;
 
-         // if cell are to far for largest item, then skip out.
-         if( TSShapeInstance::smLastPixelSize < TSShapeInstance::smSmallestVisiblePixelSize )
-            continue;
-
-         PROFILE_SCOPE(Forest_RenderBatches);
-
-         // Keep track of how many cells were batched.
-         ++smCellsBatched;
+         if ( packItems.empty() || packItems.last()->mBatches.size() >= ForestBatchPackWorkItem::MaxBatches )
+         {
+            packItems.increment();
+            packItems.last() = new ForestBatchPackWorkItem();
+            packBatch.add( packItems.last() );
+         }
 
-         // Ok... everything in this cell should be batched.  First
-         // create the batches if we don't have any.
-         if ( !cell->hasBatches() )
-            cell->buildBatches();
-
-         //if ( drawCells )
-            //mCellRenderFlag[ cellIter - theCells.begin() ] = 1;
+         packItems.last()->mBatches.push_back( batches[j] );
+      }
+   }
 
-         // TODO: Light queries for batches?
+   packBatch.issue();
 
-         // Now render the batches... we pass the culler if the
-         // cell wasn't fully visible so that each batch can be culled.
-         smCellItemsBatched += cell->renderBatches( state, clipMask != 0 ? &culler : NULL );
+   for ( U32 i=0; i < cells.size(); i++ )
+   {
+      if ( cells[i].billboard )
          continue;
-      }
 
-      // If this isn't a leaf then recurse.
-      if ( !cell->isLeaf() )
-      {
-         cell->getChildren( &cellStack );
-         continue;
-      }
+      ForestCell *cell = cells[i].cell;
+      const U32 clipMask = cells[i].clipMask;
 
       // This cell has mixed billboards and mesh based items.
       ++smCellsRendered;
 
       PROFILE_SCOPE(Forest_RenderItems);
 
-      //if ( drawCells )
-         //mCellRenderFlag[ cellIter - theCells.begin() ] = 2;
-
       // Use the cell bounds as the light query volume.
       //
       // This means all forward lit items in this cell will 
       // get the same lights, but it performs much better.
-      lightQuery.init( cellBounds );
+      lightQuery.init( cell->getBounds() );
 
       // This cell is visible... have it render its items.
       smCellItemsRendered += cell->render( &rdata, clipMask != 0 ? &culler : NULL );
    }
 
+   // Make sure the batches are packed before rendering them.
+   packBatch.wait();
+
+   for ( U32 i=0; i < cells.size(); i++ )
+   {
+      if ( !cells[i].billboard )
+         continue;
+
+      PROFILE_SCOPE(Forest_RenderBatches);
+
+      ForestCell *cell = cells[i].cell;
+      const U32 clipMask = cells[i].clipMask;
+
+      // Keep track of how many cells were batched.
+      ++smCellsBatched;
+
+      // TODO: Light queries for batches?
+
+      // Now render the batches... we pass the culler if the
+      // cell wasn't fully visible so that each batch can be culled.
+      smCellItemsBatched += cell->renderBatches( state, clipMask != 0 ? &culler : NULL );
+   }
+
    // Keep track of the average items per cell.
    if ( cellsProcessed > 0 )
       smAverageItemsPerCell /= (F32)cellsProcessed;
@@ -80,7 +80,7 @@ void WindDeformationHLSL::processVert( Vector<ShaderComponent*> &componentList,
                                        const MaterialFeatureData &fd )
 {
    MultiLine *meta = new MultiLine;
-   output = meta;
+   setOutput( meta );
 
    // We combined all the tree parameters into one float4 to
    // save constant space and reduce the memory copied to the
@@ -106,7 +106,7 @@ void WindDeformationHLSL::processVert( Vector<ShaderComponent*> &componentList,
       windDirAndSpeed->setName( "inst_windDirAndSpeed" );
       windDirAndSpeed->setType( "float3" );
 
-      mInstancingFormat->addElement( "windDirAndSpeed", GFXDeclType_Float3, windDirAndSpeed->constNum );
+      getInstancingFormat()->addElement( "windDirAndSpeed", GFXDeclType_Float3, windDirAndSpeed->constNum );
    }
    else
    {
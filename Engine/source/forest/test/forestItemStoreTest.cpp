@@ -0,0 +1,324 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2014 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "forest/forestItemStore.h"
+#include "forest/forestCell.h"
+#include "forest/forestCellCuller.h"
+#include "forest/forestDataFile.h"
+#include "math/util/frustum.h"
+#include "math/mRandom.h"
+#include "console/console.h"
+
+/// A datablock with a fixed box so that the items
+/// don't need a shape.
+class ForestTestItemData : public ForestItemData
+{
+public:
+   Box3F mBox;
+
+   ForestTestItemData() : mBox( -1.0f, -1.0f, 0.0f, 1.0f, 1.0f, 8.0f ) {}
+
+   const Box3F& getObjBox() const { return mBox; }
+};
+
+FIXTURE(ForestItemStore)
+{
+public:
+   bool oldCompact;
+   S32 oldThreshold;
+   ForestTestItemData data[2];
+
+   void SetUp()
+   {
+      oldCompact = Con::getBoolVariable( "$Forest::compactItems" );
+      oldThreshold = Con::getIntVariable( "$Forest::parallelCullThreshold" );
+   }
+
+   void TearDown()
+   {
+      Con::setBoolVariable( "$Forest::compactItems", oldCompact );
+      Con::setIntVariable( "$Forest::parallelCullThreshold", oldThreshold );
+   }
+
+   static void expectNear( const MatrixF &a, const MatrixF &b, F32 posTol, F32 rotTol )
+   {
+      const F32 *ma = a;
+      const F32 *mb = b;
+      for ( U32 row=0; row < 3; row++ )
+      {
+         for ( U32 col=0; col < 3; col++ )
+            EXPECT_NEAR( ma[ MatrixF::idx( row, col ) ], mb[ MatrixF::idx( row, col ) ], rotTol );
+      }
+
+      const Point3F posA = a.getPosition();
+      const Point3F posB = b.getPosition();
+      EXPECT_NEAR( posA.x, posB.x, posTol );
+      EXPECT_NEAR( posA.y, posB.y, posTol );
+      EXPECT_EQ( posA.z, posB.z );
+   }
+
+   /// Fills the forest with items spread over the area.
+   void plant( ForestData &forest, U32 numItems, F32 size )
+   {
+      MRandomLCG rand( 17 );
+      for ( U32 i=0; i < numItems; i++ )
+      {
+         const Point3F pos( rand.randF() * size, rand.randF() * size, rand.randF() * 20.0f );
+         forest.addItem( &data[ i & 1 ], pos, rand.randF() * M_2PI_F, rand.randF( 0.5f, 2.0f ) );
+      }
+   }
+
+   /// Returns the cells the culler found sorted.
+   static void cull( const ForestData &forest, const Frustum &frustum, Vector<ForestCulledCell> *outCells, U32 *outItems )
+   {
+      Vector<ForestCell*> roots;
+      forest.getCells( frustum, &roots );
+      ForestCellCuller( frustum, frustum.getPosition(), NULL ).cull( roots, outCells, outItems );
+      dQsort( outCells->address(), outCells->size(), sizeof( ForestCulledCell ), compareCells );
+   }
+
+   static S32 QSORT_CALLBACK compareCells( const void *a, const void *b )
+   {
+      const ForestCell *cellA = ( (const ForestCulledCell*)a )->cell;
+      const ForestCell *cellB = ( (const ForestCulledCell*)b )->cell;
+      return cellA < cellB ? -1 : ( cellA > cellB ? 1 : 0 );
+   }
+
+   static Frustum makeFrustum( const Point3F &pos )
+   {
+      MatrixF cameraMat( EulerF( -0.3f, 0.0f, 0.5f ), pos );
+      return Frustum( false, -0.5f, 0.5f, 0.375f, -0.375f, 0.5f, 1500.0f, cameraMat );
+   }
+};
+
+TEST_FIX(ForestItemStore, RoundTrip)
+{
+   Con::setBoolVariable( "$Forest::compactItems", true );
+
+   ForestItemStore store( RectF( 100.0f, -200.0f, 250.0f, 250.0f ) );
+   MRandomLCG rand( 3 );
+
+   const U32 numItems = 500;
+   Vector<MatrixF> xfms;
+   Vector<F32> scales;
+   for ( U32 i=0; i < numItems; i++ )
+   {
+      const Point3F pos( 100.0f + rand.randF() * 250.0f, -200.0f + rand.randF() * 250.0f, rand.randF( -50.0f, 50.0f ) );
+      xfms.push_back( MatrixF( EulerF( 0.0f, 0.0f, rand.randF() * M_2PI_F ), pos ) );
+      scales.push_back( rand.randF( 0.25f, 4.0f ) );
+
+      U32 index;
+      EXPECT_FALSE( store.findIndexByKey( i + 1, &index ) );
+      store.set( index, true, i + 1, &data[ i & 1 ], xfms.last(), scales.last() );
+   }
+
+   ASSERT_EQ( store.size(), numItems );
+
+   for ( U32 i=0; i < numItems; i++ )
+   {
+      U32 index;
+      ASSERT_TRUE( store.findIndexByKey( i + 1, &index ) );
+      EXPECT_FALSE( store.isFullTransform( index ) );
+
+      const ForestItem item = store.getItem( index );
+      EXPECT_EQ( item.getKey(), i + 1 );
+      EXPECT_EQ( item.getData(), &data[ i & 1 ] );
+      EXPECT_LE( mFabs( item.getScale() - scales[i] ), scales[i] * ForestItemStore::ScaleTolerance );
+      expectNear( item.getTransform(), xfms[i], ForestItemStore::PositionTolerance, ForestItemStore::RotationTolerance );
+   }
+
+   // It should be much smaller than the items themselves.
+   EXPECT_LT( store.getMemoryUsage() * 2, numItems * sizeof( ForestItem ) );
+}
+
+TEST_FIX(ForestItemStore, FullTransformFallback)
+{
+   Con::setBoolVariable( "$Forest::compactItems", true );
+
+   ForestItemStore store( RectF( 0.0f, 0.0f, 64.0f, 64.0f ) );
+
+   // Tilted, too large to quantize, and a compact item between them.
+   const MatrixF tilted( EulerF( 0.4f, 0.0f, 1.0f ), Point3F( 10.0f, 10.0f, 0.0f ) );
+   const MatrixF upright( EulerF( 0.0f, 0.0f, 2.0f ), Point3F( 20.0f, 20.0f, 0.0f ) );
+
+   store.set( 0, true, 1, &data[0], tilted, 1.0f );
+   store.set( 1, true, 2, &data[0], upright, 1.0f );
+   store.set( 2, true, 3, &data[1], upright, 40.0f );
+
+   EXPECT_TRUE( store.isFullTransform( 0 ) );
+   EXPECT_FALSE( store.isFullTransform( 1 ) );
+   EXPECT_TRUE( store.isFullTransform( 2 ) );
+
+   // The full transforms come back exactly.
+   EXPECT_TRUE( store.getItem( 0 ).getTransform() == tilted );
+   EXPECT_EQ( store.getScale( 2 ), 40.0f );
+
+   // Replacing an item moves it between the tables.
+   store.set( 0, false, 1, &data[1], upright, 1.0f );
+   EXPECT_FALSE( store.isFullTransform( 0 ) );
+   store.set( 1, false, 2, &data[0], tilted, 1.0f );
+   EXPECT_TRUE( store.isFullTransform( 1 ) );
+   EXPECT_TRUE( store.getItem( 1 ).getTransform() == tilted );
+   EXPECT_EQ( store.getData( 0 ), &data[1] );
+
+   store.erase( 1 );
+   ASSERT_EQ( store.size(), 2 );
+   EXPECT_EQ( store.getKey( 1 ), 3 );
+   EXPECT_EQ( store.getScale( 1 ), 40.0f );
+
+   // With compaction off everything is kept as is.
+   Con::setBoolVariable( "$Forest::compactItems", false );
+   store.set( 0, false, 1, &data[1], upright, 1.0f );
+   EXPECT_TRUE( store.isFullTransform( 0 ) );
+   EXPECT_TRUE( store.getItem( 0 ).getTransform() == upright );
+}
+
+TEST_FIX(ForestItemStore, DatablockOverflow)
+{
+   Con::setBoolVariable( "$Forest::compactItems", true );
+
+   ForestItemStore store( RectF( 0.0f, 0.0f, 64.0f, 64.0f ) );
+
+   // More datablocks than the palette holds.
+   const U32 numData = 300;
+   Vector<ForestTestItemData*> datas;
+   for ( U32 i=0; i <= numData; i++ )
+      datas.push_back( new ForestTestItemData );
+
+   for ( U32 i=0; i < numData; i++ )
+   {
+      const MatrixF xfm( EulerF( 0.0f, 0.0f, 1.0f ), Point3F( 1.0f + i * 0.2f, 10.0f, 0.0f ) );
+      store.set( i, true, i + 1, datas[i], xfm, 1.0f );
+   }
+
+   // The ones past the palette are kept in the side table.
+   for ( U32 i=0; i < numData; i++ )
+   {
+      EXPECT_EQ( store.getData( i ), datas[i] );
+      EXPECT_EQ( store.isFullTransform( i ), i >= ForestItemStore::FullData );
+   }
+
+   // Once some are unused a new datablock fits in the palette again.
+   for ( U32 i=0; i < 100; i++ )
+      store.erase( 0 );
+
+   const MatrixF xfm( EulerF( 0.0f, 0.0f, 1.0f ), Point3F( 30.0f, 30.0f, 0.0f ) );
+   store.set( store.size(), true, numData + 1, datas[numData], xfm, 1.0f );
+   EXPECT_FALSE( store.isFullTransform( store.size() - 1 ) );
+
+   for ( U32 i=0; i < store.size(); i++ )
+      EXPECT_EQ( store.getData( i ), datas[ store.getKey( i ) - 1 ] );
+
+   for ( U32 i=0; i < datas.size(); i++ )
+      delete datas[i];
+}
+
+TEST_FIX(ForestItemStore, ParallelCullMatchesSerial)
+{
+   ForestData forest;
+   plant( forest, 50000, 3000.0f );
+
+   const Frustum frustum = makeFrustum( Point3F( 100.0f, 100.0f, 60.0f ) );
+
+   Con::setIntVariable( "$Forest::parallelCullThreshold", 0 );
+   Vector<ForestCulledCell> serial;
+   U32 serialItems = 0;
+   cull( forest, frustum, &serial, &serialItems );
+
+   Con::setIntVariable( "$Forest::parallelCullThreshold", 4 );
+   Vector<ForestCulledCell> parallel;
+   U32 parallelItems = 0;
+   cull( forest, frustum, &parallel, &parallelItems );
+
+   EXPECT_GT( serial.size(), 0 );
+   EXPECT_EQ( serialItems, parallelItems );
+   ASSERT_EQ( serial.size(), parallel.size() );
+   for ( U32 i=0; i < serial.size(); i++ )
+   {
+      EXPECT_EQ( serial[i].cell, parallel[i].cell );
+      EXPECT_EQ( serial[i].clipMask, parallel[i].clipMask );
+   }
+}
+
+TEST_FIX(ForestItemStore, StressTestMemoryAndCull)
+{
+   // Bytes per item and cell culling time for 2 million items.
+   const U32 numItems = 2000000;
+   const U32 numCulls = 20;
+
+   Con::setBoolVariable( "$Forest::compactItems", true );
+
+   ForestData forest;
+   U32 start = Platform::getRealMilliseconds();
+   plant( forest, numItems, 8000.0f );
+   const U32 plantMs = Platform::getRealMilliseconds() - start;
+
+   // Add up the memory used by the leaf cells.
+   U32 storeBytes = 0;
+   U32 leafCells = 0;
+   Vector<ForestCell*> stack;
+   forest.getCells( &stack );
+   while ( !stack.empty() )
+   {
+      ForestCell *cell = stack.last();
+      stack.pop_back();
+
+      if ( cell->isBranch() )
+      {
+         cell->getChildren( &stack );
+         continue;
+      }
+
+      storeBytes += cell->getItems().getMemoryUsage();
+      ++leafCells;
+   }
+
+   Con::printf( "ForestItemStore: %d items in %d cells planted in %d ms, %.1f bytes per item stored vs %d bytes per ForestItem",
+      numItems, leafCells, plantMs, F32( storeBytes ) / numItems, (S32)sizeof( ForestItem ) );
+
+   EXPECT_LT( storeBytes, numItems * sizeof( ForestItem ) / 2 );
+
+   const Frustum frustum = makeFrustum( Point3F( 4000.0f, 1000.0f, 80.0f ) );
+
+   for ( U32 mode=0; mode < 2; mode++ )
+   {
+      Con::setIntVariable( "$Forest::parallelCullThreshold", mode == 0 ? 0 : 64 );
+
+      Vector<ForestCulledCell> cells;
+      U32 items = 0;
+
+      start = Platform::getRealMilliseconds();
+      for ( U32 i=0; i < numCulls; i++ )
+      {
+         cells.clear();
+         cull( forest, frustum, &cells, &items );
+      }
+      const U32 cullMs = Platform::getRealMilliseconds() - start;
+
+      Con::printf( "ForestItemStore: %s cull found %d cells with %d items in %.2f ms",
+         mode == 0 ? "serial" : "parallel", cells.size(), items, F32( cullMs ) / numCulls );
+   }
+}
+
+#endif
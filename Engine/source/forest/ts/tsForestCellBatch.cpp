@@ -56,27 +56,12 @@ bool TSForestCellBatch::_prepBatch( const ForestItem &item )
    return true;
 }
 
-void TSForestCellBatch::_rebuildBatch()
+void TSForestCellBatch::_packBatch()
 {
-   // Clean up first.
-   mVB = NULL;
-   if ( mItems.empty() )
-      return;
-
-   // How big do we need to make this?
-   U32 verts = mItems.size() * 6;
-   mVB.set( GFX, verts, GFXBufferTypeStatic );
-   if ( !mVB.isValid() )
-   {
-      // If we failed it is probably because we requested
-      // a size bigger than a VB can be.  Warn the user.
-      AssertWarn( false, "TSForestCellBatch::_rebuildBatch: Batch too big... try reducing the forest cell size!" );
-      return;
-   }
+   PROFILE_SCOPE( TSForestCellBatch_packBatch );
 
-   // Fill this puppy!
-   ImposterState *vertPtr = mVB.lock();
-   if(!vertPtr) return;
+   mVerts.setSize( mItems.size() * 6 );
+   ImposterState *vertPtr = mVerts.address();
 
    Vector<ForestItem>::const_iterator item = mItems.begin();
 
@@ -115,8 +100,39 @@ void TSForestCellBatch::_rebuildBatch()
       vertPtr->corner = 0;
       ++vertPtr;
    }
+}
+
+void TSForestCellBatch::_rebuildBatch()
+{
+   // Clean up first.
+   mVB = NULL;
+   if ( mItems.empty() )
+      return;
+
+   // How big do we need to make this?
+   U32 verts = mItems.size() * 6;
+   mVB.set( GFX, verts, GFXBufferTypeStatic );
+   if ( !mVB.isValid() )
+   {
+      // If we failed it is probably because we requested
+      // a size bigger than a VB can be.  Warn the user.
+      AssertWarn( false, "TSForestCellBatch::_rebuildBatch: Batch too big... try reducing the forest cell size!" );
+      return;
+   }
+
+   // Fill this puppy!
+   ImposterState *vertPtr = mVB.lock();
+   if(!vertPtr) return;
+
+   // The vertices were packed ahead of time.
+   AssertFatal( mVerts.size() == verts, "TSForestCellBatch::_rebuildBatch - The batch was not packed!" );
+   dMemcpy( vertPtr, mVerts.address(), verts * sizeof( ImposterState ) );
 
    mVB.unlock();
+
+   // We don't need the packed copy anymore.
+   mVerts.clear();
+   mVerts.compact();
 }
 
 void TSForestCellBatch::_render( const SceneRenderState *state )
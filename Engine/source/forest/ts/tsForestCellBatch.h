@@ -51,8 +51,13 @@ protected:
 
    TSLastDetail *mDetail;
 
+   /// The packed vertices waiting to be copied 
+   /// into the vertex buffer.
+   Vector<ImposterState> mVerts;
+
    // ForestCellBatch
    virtual bool _prepBatch( const ForestItem &item );
+   virtual void _packBatch();
    virtual void _rebuildBatch();
    virtual void _render( const SceneRenderState *state );
 
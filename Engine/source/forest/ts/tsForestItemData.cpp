@@ -196,6 +196,47 @@ ForestCellBatch* TSForestItemData::allocateBatch() const
    return new TSForestCellBatch( lastDetail );
 }
 
+F32 TSForestItemData::_getPixelSize( const SceneRenderState *state, F32 scaledDistance ) const
+{
+   // This is the same calculation done in 
+   // TSShapeInstance::setDetailFromDistance.
+   const F32 pixelScale = (state->getViewport().extent.x / state->getViewport().extent.y)*2;
+   const F32 pixelRadius = ( mShape->mRadius / scaledDistance ) * state->getWorldToScreenScale().y * pixelScale;
+   return pixelRadius * TSShapeInstance::smDetailAdjust;
+}
+
+S32 TSForestItemData::_getDetailFromDistance( const SceneRenderState *state, F32 scaledDistance ) const
+{
+   // This mirrors TSShapeInstance::setDetailFromDistance, but since
+   // it is called from the forest culling threads it cannot use the
+   // shared shape instance.
+
+   if ( scaledDistance <= 0.0f )
+      return mShape->mDetailLevelLookup[0].level;
+
+   // Legacy shapes which select the detail by screen error 
+   // need a shape instance... just use the highest detail.
+   if ( mShape->mUseDetailFromScreenError )
+      return 0;
+
+   F32 pixelSize = _getPixelSize( state, scaledDistance );
+   if ( pixelSize < TSShapeInstance::smSmallestVisiblePixelSize )
+      return -1;
+
+   if ( pixelSize <= mShape->mSmallestVisibleSize )
+      pixelSize = mShape->mSmallestVisibleSize + 0.01f;
+
+   // Clamp it to an acceptable range for the lookup table.
+   const U32 index = (U32)mClampF( pixelSize, 0, mShape->mDetailLevelLookup.size() - 1 );
+   S32 dl = mShape->mDetailLevelLookup[ index ].level;
+
+   // Restrict the chosen detail level by cutoff value.
+   if ( TSShapeInstance::smNumSkipRenderDetails > 0 && dl >= 0 )
+      dl = getMax( dl, getMin( TSShapeInstance::smNumSkipRenderDetails, mShape->mSmallestVisibleDL ) );
+
+   return dl;
+}
+
 bool TSForestItemData::canBillboard( const SceneRenderState *state, const ForestItem &item, F32 distToCamera ) const
 {
    PROFILE_SCOPE( TSForestItemData_canBillboard );
@@ -203,9 +244,7 @@ bool TSForestItemData::canBillboard( const SceneRenderState *state, const Forest
    if ( !mShape )
       return false;
 
-   // Use the shape instance to do the work it normally does.
-   TSShapeInstance *shapeInstance = _getShapeInstance();
-   const S32 dl = shapeInstance->setDetailFromDistance( state, distToCamera / item.getScale() );
+   const S32 dl = _getDetailFromDistance( state, distToCamera / item.getScale() );
 
    // This item has a null LOD... lets consider 
    // that as being billboarded.
@@ -219,6 +258,14 @@ bool TSForestItemData::canBillboard( const SceneRenderState *state, const Forest
    return false;
 }
 
+bool TSForestItemData::isTooSmall( const SceneRenderState *state, const ForestItem &item, F32 distToCamera ) const
+{
+   if ( !mShape || distToCamera <= 0.0f || mShape->mUseDetailFromScreenError )
+      return false;
+
+   return _getPixelSize( state, distToCamera / item.getScale() ) < TSShapeInstance::smSmallestVisiblePixelSize;
+}
+
 bool TSForestItemData::render( TSRenderState *rdata, const ForestItem &item ) const
 {
    PROFILE_SCOPE( TSForestItemData_render );
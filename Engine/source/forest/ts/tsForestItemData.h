@@ -62,6 +62,13 @@ protected:
 
    void _updateCollisionDetails();
 
+   /// Returns the screen size of the shape at the scaled distance.
+   F32 _getPixelSize( const SceneRenderState *state, F32 scaledDistance ) const;
+
+   /// Returns the detail level the shape instance would select at 
+   /// the scaled distance without changing the shape instance.
+   S32 _getDetailFromDistance( const SceneRenderState *state, F32 scaledDistance ) const;
+
    // ForestItemData
    void _preload() { _loadShape(); }
 
@@ -90,6 +97,7 @@ public:
    bool render( TSRenderState *rdata, const ForestItem& item ) const;
    ForestCellBatch* allocateBatch() const;
    bool canBillboard( const SceneRenderState *state, const ForestItem &item, F32 distToCamera ) const;
+   bool isTooSmall( const SceneRenderState *state, const ForestItem &item, F32 distToCamera ) const;
    bool buildPolyList( const ForestItem& item, AbstractPolyList *polyList, const Box3F *box ) const { return false; }
 };
 
@@ -1231,6 +1231,9 @@ void GFXD3D11Device::setShader(GFXShader *shader, bool force)
    {
       GFXD3D11Shader *d3dShader = static_cast<GFXD3D11Shader*>(shader);
 
+      if (d3dShader->mPixShader != mLastPixShader || d3dShader->mVertShader != mLastVertShader || force)
+         mDeviceStatistics.mShaderChanges++;
+
       if (d3dShader->mPixShader != mLastPixShader || force)
       {
         mD3DDeviceContext->PSSetShader( d3dShader->mPixShader, NULL, 0);
@@ -25,10 +25,15 @@
 #include "core/frameAllocator.h"
 #include "core/stream/fileStream.h"
 #include "core/util/safeDelete.h"
+#include "core/util/fourcc.h"
 #include "console/console.h"
+#include "gfx/gfxShaderCache.h"
 
 extern bool gDisassembleAllShaders;
 
+/// The shader cache format of our compiled bytecode.
+static const U32 sD3D11BytecodeFormat = MakeFourCC( 'D', 'X', 'B', 'C' );
+
 #pragma comment(lib, "d3dcompiler.lib")
 
 gfxD3DIncludeRef GFXD3D11Shader::smD3DInclude = NULL;
@@ -349,6 +354,10 @@ void GFXD3D11ShaderConstBuffer::_createBuffers()
          }
       }
    }
+   // The new device buffers are empty so the first
+   // activate needs to copy all of our content.
+   mVertexConstBuffer->setDirty( true );
+   mPixelConstBuffer->setDirty( true );
 }
 
 GFXShader* GFXD3D11ShaderConstBuffer::getShader()
@@ -593,80 +602,30 @@ void GFXD3D11ShaderConstBuffer::activate( GFXD3D11ShaderConstBuffer *prevShaderB
    // Alot of the calls here are inlined... be careful 
    // what you change.
 
-   // If the buffer has changed we need to compare it
-   // with the new buffer to see if we can skip copying
-   // equal buffer content.
-   //
-   // If the buffer hasn't changed then we only will
-   // be copying the changes that have occured since
-   // the last activate call.
-   if ( prevShaderBuffer != this )
-   {
-      // If the previous buffer is dirty, than we can't compare 
-      // against it, because it hasn't sent its contents to the
-      // card yet and must be copied.
-      if ( prevShaderBuffer && !prevShaderBuffer->isDirty() )
-      {
-         PROFILE_SCOPE(GFXD3D11ShaderConstBuffer_activate_dirty_check_1);
-         // If the buffer content is equal then we set the dirty
-         // flag to false knowing the current state of the card matches
-         // the new buffer.
-         //
-         // If the content is not equal we set the dirty flag to
-         // true which causes the full content of the buffer to be
-         // copied to the card.
-         //
-         mVertexConstBuffer->setDirty( !prevShaderBuffer->mVertexConstBuffer->isEqual( mVertexConstBuffer ) );
-         mPixelConstBuffer->setDirty( !prevShaderBuffer->mPixelConstBuffer->isEqual( mPixelConstBuffer ) ); 
-      } 
-      else
-      {
-         // This happens rarely... but it can happen.
-         // We copy the entire dirty state to the card.
-         PROFILE_SCOPE(GFXD3D11ShaderConstBuffer_activate_dirty_check_2);
+   // Every const buffer owns its device buffers and they hold
+   // whatever was last uploaded from it, so we only need to copy
+   // the sub-buffers which changed since the last activate.  If
+   // a different buffer was active before we must rebind ours.
+   const bool rebind = prevShaderBuffer != this;
 
-         mVertexConstBuffer->setDirty( true );
-         mPixelConstBuffer->setDirty( true );
-      }      
-   }
+   // Count the buffer once however many sub-buffers it sends.
+   if ( mVertexConstBuffer->isDirty() || mPixelConstBuffer->isDirty() )
+      GFX->getDeviceStatistics()->mShaderConstBufferUploads++;
 
-   D3D11_MAPPED_SUBRESOURCE pConstData;
-   ZeroMemory(&pConstData, sizeof(D3D11_MAPPED_SUBRESOURCE));
-   
-   const U8* buf;
-   U32 nbBuffers = 0;
-   if(mVertexConstBuffer->isDirty())
+   if ( rebind || mVertexConstBuffer->isDirty() )
    {
-      const Vector<ConstSubBufferDesc> &subBuffers = mVertexConstBufferLayout->getSubBufferDesc();
-      // TODO: This is not very effecient updating the whole lot, re-implement the dirty system to work with multiple constant buffers.
-      // TODO: Implement DX 11.1 UpdateSubresource1 which supports updating ranges with constant buffers
-      buf = mVertexConstBuffer->getEntireBuffer();
-      for (U32 i = 0; i < subBuffers.size(); ++i)
-      {
-         const ConstSubBufferDesc &desc = subBuffers[i];
-         mDeviceContext->UpdateSubresource(mConstantBuffersV[i], 0, NULL, buf + desc.start, desc.size, 0);
-         nbBuffers++;
-      }
-
-      mDeviceContext->VSSetConstantBuffers(0, nbBuffers, mConstantBuffersV);
+      PROFILE_SCOPE(GFXD3D11ShaderConstBuffer_activate_vertex);
+      const U32 nbBuffers = _updateSubBuffers( mVertexConstBuffer, mVertexConstBufferLayout, mConstantBuffersV );
+      if ( rebind )
+         mDeviceContext->VSSetConstantBuffers(0, nbBuffers, mConstantBuffersV);
    }
 
-   nbBuffers = 0;
-
-   if(mPixelConstBuffer->isDirty())    
+   if ( rebind || mPixelConstBuffer->isDirty() )
    {
-      const Vector<ConstSubBufferDesc> &subBuffers = mPixelConstBufferLayout->getSubBufferDesc();
-      // TODO: This is not very effecient updating the whole lot, re-implement the dirty system to work with multiple constant buffers.
-      // TODO: Implement DX 11.1 UpdateSubresource1 which supports updating ranges with constant buffers
-      buf = mPixelConstBuffer->getEntireBuffer();
-      for (U32 i = 0; i < subBuffers.size(); ++i)
-      {
-         const ConstSubBufferDesc &desc = subBuffers[i];
-         mDeviceContext->UpdateSubresource(mConstantBuffersP[i], 0, NULL, buf + desc.start, desc.size, 0);
-         nbBuffers++;
-      }
-
-      mDeviceContext->PSSetConstantBuffers(0, nbBuffers, mConstantBuffersP);
+      PROFILE_SCOPE(GFXD3D11ShaderConstBuffer_activate_pixel);
+      const U32 nbBuffers = _updateSubBuffers( mPixelConstBuffer, mPixelConstBufferLayout, mConstantBuffersP );
+      if ( rebind )
+         mDeviceContext->PSSetConstantBuffers(0, nbBuffers, mConstantBuffersP);
    }
 
    #ifdef TORQUE_DEBUG
@@ -682,6 +641,29 @@ void GFXD3D11ShaderConstBuffer::activate( GFXD3D11ShaderConstBuffer *prevShaderB
    mWasLost = false;
 }
 
+U32 GFXD3D11ShaderConstBuffer::_updateSubBuffers( GenericConstBuffer *buffer,
+                                                  GFXD3D11ConstBufferLayout *layout,
+                                                  ID3D11Buffer **deviceBuffers )
+{
+   const Vector<ConstSubBufferDesc> &subBuffers = layout->getSubBufferDesc();
+   if ( !buffer->isDirty() )
+      return subBuffers.size();
+
+   // TODO: Implement DX 11.1 UpdateSubresource1 which supports updating ranges with constant buffers
+   const U8 *buf = buffer->getEntireBuffer();
+   for (U32 i = 0; i < subBuffers.size(); ++i)
+   {
+      const ConstSubBufferDesc &desc = subBuffers[i];
+      if ( !buffer->isRangeDirty( desc.start, desc.size ) )
+         continue;
+
+      mDeviceContext->UpdateSubresource(deviceBuffers[i], 0, NULL, buf + desc.start, desc.size, 0);
+   }
+
+   buffer->setDirty( false );
+   return subBuffers.size();
+}
+
 void GFXD3D11ShaderConstBuffer::onShaderReload( GFXD3D11Shader *shader )
 {
    AssertFatal( shader == mShader, "GFXD3D11ShaderConstBuffer::onShaderReload is hosed!" );
@@ -896,7 +878,40 @@ bool GFXD3D11Shader::_compileShader( const Torque::Path &filePath,
       s.read(bufSize, buffer);
       buffer[bufSize] = 0;
 
-      res = D3DCompile(buffer, bufSize, realPath.getFullPath().c_str(), defines, smD3DInclude, "main", target, flags, 0, &code, &errorBuff);
+      // The cache is keyed on the preprocessed source so
+      // that a change to any include invalidates the entry.
+      U64 cacheKey = 0;
+      bool cached = false;
+      if ( GFXShaderCache::isEnabled() )
+      {
+         ID3DBlob* preprocessed = NULL;
+         if ( SUCCEEDED( D3DPreprocess(buffer, bufSize, realPath.getFullPath().c_str(), defines, smD3DInclude, &preprocessed, NULL) ) )
+         {
+            const U32 compilerVersion = D3D_COMPILER_VERSION;
+            cacheKey = GFXShaderCache::hashKey( preprocessed->GetBufferPointer(), preprocessed->GetBufferSize(), cacheKey );
+            cacheKey = GFXShaderCache::hashKey( target, cacheKey );
+            cacheKey = GFXShaderCache::hashKey( &flags, sizeof( flags ), cacheKey );
+            cacheKey = GFXShaderCache::hashKey( &compilerVersion, sizeof( compilerVersion ), cacheKey );
+            SAFE_RELEASE(preprocessed);
+
+            Vector<U8> bytecode;
+            if ( GFXShaderCache::load( cacheKey, sD3D11BytecodeFormat, bytecode ) )
+            {
+               res = D3DCreateBlob(bytecode.size(), &code);
+               AssertISV(SUCCEEDED(res), "Unable to create buffer!");
+               dMemcpy(code->GetBufferPointer(), bytecode.address(), bytecode.size());
+               cached = true;
+            }
+         }
+      }
+
+      if ( !cached )
+      {
+         res = D3DCompile(buffer, bufSize, realPath.getFullPath().c_str(), defines, smD3DInclude, "main", target, flags, 0, &code, &errorBuff);
+
+         if ( cacheKey && SUCCEEDED(res) && code )
+            GFXShaderCache::save( cacheKey, sD3D11BytecodeFormat, code->GetBufferPointer(), code->GetBufferSize() );
+      }
       
    }
 
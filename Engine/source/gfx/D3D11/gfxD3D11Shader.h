@@ -351,6 +351,10 @@ protected:
 
    void _createBuffers();
 
+   /// Copies the dirty sub-buffers to the device buffers, clears
+   /// the dirty state and returns the number of sub-buffers.
+   U32 _updateSubBuffers( GenericConstBuffer *buffer, GFXD3D11ConstBufferLayout *layout, ID3D11Buffer **deviceBuffers );
+
    template<class T>
    inline void SET_CONSTANT(GFXShaderConstHandle* handle,
       const T& fv,
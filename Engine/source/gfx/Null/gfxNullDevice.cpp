@@ -29,8 +29,11 @@
 #include "gfx/gfxPrimitiveBuffer.h"
 #include "gfx/gfxCardProfile.h"
 #include "gfx/gfxTextureManager.h"
+#include "gfx/gfxShader.h"
 #include "gfx/bitmap/gBitmap.h"
 #include "core/util/safeDelete.h"
+#include "core/util/swizzle.h"
+#include "gfx/gfxVertexColor.h"
 
 
 GFXAdapter::CreateDeviceInstanceDelegate GFXNullDevice::mCreateDeviceInstance(GFXNullDevice::createInstance); 
@@ -112,6 +115,12 @@ protected:
 
          SAFE_DELETE( retTex->mBitmap );
          retTex->mBitmap = new GBitmap(width, height);
+
+         // Render targets and the benchmark harness size
+         // themselves off of these, so keep them honest.
+         retTex->mTextureSize.set( width, height, depth );
+         retTex->mFormat = format;
+         retTex->mMipLevels = numMipLevels;
          return retTex;
       };
 
@@ -280,6 +289,147 @@ private:
    GFXStateBlockDesc mDefaultDesc;
 };
 
+//
+// GFXNullShader
+//
+// The null shader compiles nothing and exposes no constants.  It exists
+// so that the material system can build its passes on the null device
+// and headless rendering exercises the same code paths as a real device.
+//
+class GFXNullShaderConstHandle : public GFXShaderConstHandle
+{
+public:
+   GFXNullShaderConstHandle( const String &name ) : mName( name ) {}
+
+   virtual const String& getName() const { return mName; }
+   virtual GFXShaderConstType getType() const { return GFXSCT_Float; }
+   virtual U32 getArraySize() const { return 1; }
+   virtual S32 getSamplerRegister() const { return -1; }
+
+private:
+   String mName;
+};
+
+class GFXNullShaderConstBuffer : public GFXShaderConstBuffer
+{
+public:
+   GFXNullShaderConstBuffer( GFXShader *shader ) : mShader( shader ), mDirty( true ) { mWasLost = false; }
+
+   /// Returns true if constants were set since the last call,
+   /// the way a real device would upload the buffer.
+   bool takeDirty() { const bool dirty = mDirty; mDirty = false; return dirty; }
+
+   virtual GFXShader* getShader() { return mShader; }
+
+   virtual void set(GFXShaderConstHandle* handle, const F32 f) { mDirty = true; }
+   virtual void set(GFXShaderConstHandle* handle, const Point2F& fv) { mDirty = true; }
+   virtual void set(GFXShaderConstHandle* handle, const Point3F& fv) { mDirty = true; }
+   virtual void set(GFXShaderConstHandle* handle, const Point4F& fv) { mDirty = true; }
+   virtual void set(GFXShaderConstHandle* handle, const PlaneF& fv) { mDirty = true; }
+   virtual void set(GFXShaderConstHandle* handle, const LinearColorF& fv) { mDirty = true; }
+   virtual void set(GFXShaderConstHandle* handle, const S32 f) { mDirty = true; }
+   virtual void set(GFXShaderConstHandle* handle, const Point2I& fv) { mDirty = true; }
+   virtual void set(GFXShaderConstHandle* handle, const Point3I& fv) { mDirty = true; }
+   virtual void set(GFXShaderConstHandle* handle, const Point4I& fv) { mDirty = true; }
+   virtual void set(GFXShaderConstHandle* handle, const AlignedArray<F32>& fv) { mDirty = true; }
+   virtual void set(GFXShaderConstHandle* handle, const AlignedArray<Point2F>& fv) { mDirty = true; }
+   virtual void set(GFXShaderConstHandle* handle, const AlignedArray<Point3F>& fv) { mDirty = true; }
+   virtual void set(GFXShaderConstHandle* handle, const AlignedArray<Point4F>& fv) { mDirty = true; }
+   virtual void set(GFXShaderConstHandle* handle, const AlignedArray<S32>& fv) { mDirty = true; }
+   virtual void set(GFXShaderConstHandle* handle, const AlignedArray<Point2I>& fv) { mDirty = true; }
+   virtual void set(GFXShaderConstHandle* handle, const AlignedArray<Point3I>& fv) { mDirty = true; }
+   virtual void set(GFXShaderConstHandle* handle, const AlignedArray<Point4I>& fv) { mDirty = true; }
+   virtual void set(GFXShaderConstHandle* handle, const MatrixF& mat, const GFXShaderConstType matrixType = GFXSCT_Float4x4) { mDirty = true; }
+   virtual void set(GFXShaderConstHandle* handle, const MatrixF* mat, const U32 arraySize, const GFXShaderConstType matrixType = GFXSCT_Float4x4) { mDirty = true; }
+
+   // GFXResource
+   virtual const String describeSelf() const { return String(); }
+   virtual void zombify() {}
+   virtual void resurrect() {}
+
+private:
+   GFXShader *mShader;
+   bool mDirty;
+};
+
+class GFXNullShader : public GFXShader
+{
+public:
+   virtual ~GFXNullShader()
+   {
+      for ( HandleMap::Iterator iter = mHandles.begin(); iter != mHandles.end(); ++iter )
+         delete iter->value;
+   }
+
+   virtual GFXShaderConstBufferRef allocConstBuffer() { return new GFXNullShaderConstBuffer( this ); }
+   virtual const Vector<GFXShaderConstDesc>& getShaderConstDesc() const { return mConstDesc; }
+
+   virtual GFXShaderConstHandle* getShaderConstHandle( const String& name )
+   {
+      HandleMap::Iterator iter = mHandles.find( name );
+      if ( iter != mHandles.end() )
+         return iter->value;
+
+      GFXNullShaderConstHandle *handle = new GFXNullShaderConstHandle( name );
+      mHandles.insert( name, handle );
+      return handle;
+   }
+
+   virtual GFXShaderConstHandle* findShaderConstHandle( const String& name ) { return NULL; }
+   virtual U32 getAlignmentValue( const GFXShaderConstType constType ) const { return 16; }
+
+   // GFXResource
+   virtual void zombify() {}
+   virtual void resurrect() {}
+
+protected:
+   virtual bool _init() { return true; }
+
+   typedef Map<String,GFXNullShaderConstHandle*> HandleMap;
+   HandleMap mHandles;
+   Vector<GFXShaderConstDesc> mConstDesc;
+};
+
+//
+// GFXNullTextureTarget
+//
+class GFXNullTextureTarget : public GFXTextureTarget
+{
+public:
+   GFXNullTextureTarget() : mSize( 0, 0 ), mFormat( GFXFormatR8G8B8A8 ) {}
+
+   virtual const Point2I getSize() { return mSize; }
+   virtual GFXFormat getFormat() { return mFormat; }
+
+   virtual void attachTexture( RenderSlot slot, GFXTextureObject *tex, U32 mipLevel = 0, U32 zOffset = 0 )
+   {
+      if ( slot == Color0 && tex && tex != GFXTextureTarget::sDefaultDepthStencil )
+      {
+         mSize.set( tex->getWidth(), tex->getHeight() );
+         mFormat = tex->getFormat();
+      }
+   }
+
+   virtual void attachTexture( RenderSlot slot, GFXCubemap *tex, U32 face, U32 mipLevel = 0 )
+   {
+      if ( slot == Color0 && tex )
+      {
+         mSize.set( tex->getSize(), tex->getSize() );
+         mFormat = tex->getFormat();
+      }
+   }
+
+   virtual void resolve() {}
+
+   // GFXResource
+   virtual void zombify() {}
+   virtual void resurrect() {}
+
+private:
+   Point2I mSize;
+   GFXFormat mFormat;
+};
+
 //
 // GFXNullDevice
 //
@@ -290,6 +440,8 @@ GFXDevice *GFXNullDevice::createInstance( U32 adapterIndex )
 }
 
 GFXNullDevice::GFXNullDevice()
+   :  mPixelShaderVersion( 0.0f ),
+      mCurrentShader( NULL )
 {
    clip.set(0, 0, 800, 800);
 
@@ -297,6 +449,9 @@ GFXNullDevice::GFXNullDevice()
    gScreenShot = new ScreenShot();
    mCardProfiler = new GFXNullCardProfiler();
    mCardProfiler->init();
+
+   // Code which fills vertex buffers still packs vertex colors.
+   GFXVertexColor::setSwizzle( &Swizzles::rgba );
 }
 
 GFXNullDevice::~GFXNullDevice()
@@ -358,6 +513,9 @@ void GFXNullDevice::init( const GFXVideoMode &mode, PlatformWindow *window )
 {
    mCardProfiler = new GFXNullCardProfiler();
    mCardProfiler->init();
+
+   // Code which fills vertex buffers still packs vertex colors.
+   GFXVertexColor::setSwizzle( &Swizzles::rgba );
 }
 
 GFXStateBlockRef GFXNullDevice::createStateBlockInternal(const GFXStateBlockDesc& desc)
@@ -365,6 +523,55 @@ GFXStateBlockRef GFXNullDevice::createStateBlockInternal(const GFXStateBlockDesc
    return new GFXNullStateBlock();
 }
 
+GFXShader* GFXNullDevice::createShader()
+{
+   return new GFXNullShader();
+}
+
+void GFXNullDevice::setShader( GFXShader *shader, bool force )
+{
+   if ( mCurrentShader == shader && !force )
+      return;
+
+   mCurrentShader = shader;
+   mDeviceStatistics.mShaderChanges++;
+}
+
+GFXTextureTarget* GFXNullDevice::allocRenderToTextureTarget( bool genMips )
+{
+   GFXNullTextureTarget *target = new GFXNullTextureTarget();
+   target->registerResourceWithDevice( this );
+   return target;
+}
+
+void GFXNullDevice::_preDraw( U32 primitiveCount )
+{
+   if ( mStateDirty )
+      updateStates();
+
+   if (  mCurrentShaderConstBuffer &&
+         static_cast<GFXNullShaderConstBuffer*>( mCurrentShaderConstBuffer )->takeDirty() )
+      mDeviceStatistics.mShaderConstBufferUploads++;
+
+   mDeviceStatistics.mDrawCalls++;
+   mDeviceStatistics.mPolyCount += primitiveCount;
+}
+
+void GFXNullDevice::drawPrimitive( GFXPrimitiveType primType, U32 vertexStart, U32 primitiveCount )
+{
+   _preDraw( primitiveCount );
+}
+
+void GFXNullDevice::drawIndexedPrimitive( GFXPrimitiveType primType,
+                                          U32 startVertex,
+                                          U32 minIndex,
+                                          U32 numVerts,
+                                          U32 startIndex,
+                                          U32 primitiveCount )
+{
+   _preDraw( primitiveCount );
+}
+
 //
 // Register this device with GFXInit
 //
@@ -131,7 +131,7 @@ public:
 
    ///@}
 
-   virtual GFXTextureTarget *allocRenderToTextureTarget(bool genMips=true){return NULL;};
+   virtual GFXTextureTarget *allocRenderToTextureTarget(bool genMips=true);
    virtual GFXWindowTarget *allocWindowTarget(PlatformWindow *window)
    {
       return new GFXNullWindowTarget();
@@ -139,26 +139,32 @@ public:
 
    virtual void _updateRenderTargets(){};
 
-   virtual F32 getPixelShaderVersion() const { return 0.0f; };
-   virtual void setPixelShaderVersion( F32 version ) { };
-   virtual U32 getNumSamplers() const { return 0; };
-   virtual U32 getNumRenderTargets() const { return 0; };
+   /// The null device reports no shader support unless told otherwise with
+   /// setPixelShaderVersion().  Headless rendering uses this to get the
+   /// material and lighting systems to run as they would on a real device.
+   virtual F32 getPixelShaderVersion() const { return mPixelShaderVersion; };
+   virtual void setPixelShaderVersion( F32 version ) { mPixelShaderVersion = version; };
+   virtual U32 getNumSamplers() const { return mPixelShaderVersion > 0.0f ? GFX_TEXTURE_STAGE_COUNT : 0; };
+   virtual U32 getNumRenderTargets() const { return mPixelShaderVersion > 0.0f ? 4 : 0; };
 
-   virtual GFXShader* createShader() { return NULL; };
+   virtual GFXShader* createShader();
+   virtual void setShader( GFXShader *shader, bool force = false );
 
    virtual void copyResource(GFXTextureObject *pDst, GFXCubemap *pSrc, const U32 face) { };
    virtual void clear( U32 flags, const LinearColorF& color, F32 z, U32 stencil ) { };
    virtual void clearColorAttachment(const U32 attachment, const LinearColorF& color) { };
-   virtual bool beginSceneInternal() { return true; };
-   virtual void endSceneInternal() { };
+   virtual bool beginSceneInternal() { mCanCurrentlyRender = true; return true; };
+   virtual void endSceneInternal() { mCanCurrentlyRender = false; };
 
-   virtual void drawPrimitive( GFXPrimitiveType primType, U32 vertexStart, U32 primitiveCount ) { };
+   /// Draws do nothing but still go through the state tracking
+   /// and update the device statistics like a real device.
+   virtual void drawPrimitive( GFXPrimitiveType primType, U32 vertexStart, U32 primitiveCount );
    virtual void drawIndexedPrimitive(  GFXPrimitiveType primType, 
                                        U32 startVertex, 
                                        U32 minIndex, 
                                        U32 numVerts, 
                                        U32 startIndex, 
-                                       U32 primitiveCount ) { };
+                                       U32 primitiveCount );
 
    virtual void setClipRect( const RectI &rect ) { };
    virtual const RectI &getClipRect() const { return clip; };
@@ -180,6 +186,12 @@ public:
 private:
    typedef GFXDevice Parent;
    RectI clip;
+
+   F32 mPixelShaderVersion;
+   GFXShader *mCurrentShader;
+
+   /// Does the bookkeeping a real device does before each draw.
+   void _preDraw( U32 primitiveCount );
 };
 
 #endif
@@ -23,6 +23,8 @@
 #include "gfx/bitmap/bitmapUtils.h"
 
 #include "platform/platform.h"
+#include "core/module.h"
+#include "math/mMathFn.h"
 
 
 void bitmapExtrude5551_c(const void *srcMip, void *mip, U32 srcHeight, U32 srcWidth)
@@ -221,10 +223,81 @@ void bitmapExtrudeFPRGBA_c(const void *srcMip, void *mip, U32 srcHeight, U32 src
    }
 }
 
+//--------------------------------------------------------------------------
+/// Tables for converting between 8 bit sRGB and 16 bit linear values.  The
+/// linear values are brought back through a 12 bit table which is built so
+/// that every sRGB value survives the round trip.
+struct SRGBTables
+{
+   U16 toLinear[256];
+   U8 toSRGB[4096];
+
+   SRGBTables()
+   {
+      for (U32 i = 0; i < 256; i++)
+      {
+         const F32 c = i / 255.0f;
+         const F32 linear = c <= 0.04045f ? c / 12.92f : mPow((c + 0.055f) / 1.055f, 2.4f);
+         toLinear[i] = (U16)mClamp(S32(linear * 65535.0f + 0.5f), 0, 65535);
+      }
+
+      // Pick the nearest sRGB value to the center of each bucket.
+      U32 srgb = 0;
+      for (U32 i = 0; i < 4096; i++)
+      {
+         const U32 center = (i << 4) + 8;
+         while (srgb < 255 && U32(toLinear[srgb + 1]) + toLinear[srgb] <= center * 2)
+            srgb++;
+         toSRGB[i] = srgb;
+      }
+   }
+};
+
+static const SRGBTables& _getSRGBTables()
+{
+   // Built on first use, which may be on a worker thread.
+   static SRGBTables tables;
+   return tables;
+}
+
+void bitmapExtrudeRGBA_sRGB_c(const void *srcMip, void *mip, U32 srcHeight, U32 srcWidth)
+{
+   const SRGBTables &tables = _getSRGBTables();
+
+   const U8 *src = (const U8 *) srcMip;
+   U8 *dst = (U8 *) mip;
+   U32 stride = srcHeight != 1 ? (srcWidth) * 4 : 0;
+   U32 next = srcWidth != 1 ? 4 : 0;
+
+   U32 width  = srcWidth  >> 1;
+   U32 height = srcHeight >> 1;
+   if (width  == 0) width  = 1;
+   if (height == 0) height = 1;
+
+   // Average the color in linear space and the alpha as is.
+   for(U32 y = 0; y < height; y++)
+   {
+      for(U32 x = 0; x < width; x++)
+      {
+         for (U32 c = 0; c < 3; c++)
+         {
+            const U32 sum = tables.toLinear[src[c]] + tables.toLinear[src[c + next]] +
+                            tables.toLinear[src[c + stride]] + tables.toLinear[src[c + stride + next]];
+            *dst++ = tables.toSRGB[((sum + 2) >> 2) >> 4];
+         }
+
+         *dst++ = (U32(src[3]) + U32(src[3 + next]) + U32(src[3 + stride]) + U32(src[3 + stride + next]) + 2) >> 2;
+         src += 4 + next;
+      }
+      src += stride;   // skip
+   }
+}
+
 void (*bitmapExtrude5551)(const void *srcMip, void *mip, U32 height, U32 width) = bitmapExtrude5551_c;
 void (*bitmapExtrudeRGB)(const void *srcMip, void *mip, U32 srcHeight, U32 srcWidth) = bitmapExtrudeRGB_c;
 void (*bitmapExtrudeRGBA)(const void *srcMip, void *mip, U32 srcHeight, U32 srcWidth) = bitmapExtrudeRGBA_c;
 void (*bitmapExtrudeFPRGBA)(const void *srcMip, void *mip, U32 srcHeight, U32 srcWidth) = bitmapExtrudeFPRGBA_c;
+void (*bitmapExtrudeRGBA_sRGB)(const void *srcMip, void *mip, U32 srcHeight, U32 srcWidth) = bitmapExtrudeRGBA_sRGB_c;
 
 
 //--------------------------------------------------------------------------
@@ -330,3 +403,35 @@ void bitmapConvertA8_to_RGBA_c( U8 **src, U32 pixels )
 }
 
 void (*bitmapConvertA8_to_RGBA)( U8 **src, U32 pixels ) = bitmapConvertA8_to_RGBA_c;
+
+//------------------------------------------------------------------------------
+
+#if defined(TORQUE_CPU_X86) || defined(TORQUE_CPU_X64)
+extern void bitmapInstallLibrary_SSE2();
+#endif
+
+void bitmapInstallLibrary(U32 properties)
+{
+   if (!properties)
+      // detect what's available
+      properties = Platform::SystemInfo.processor.properties;
+   else
+      // Make sure we're not asking for anything that's not supported
+      properties &= Platform::SystemInfo.processor.properties;
+
+   bitmapExtrudeRGBA = bitmapExtrudeRGBA_c;
+
+#if defined(TORQUE_CPU_X86) || defined(TORQUE_CPU_X64)
+   if (properties & CPU_PROP_SSE2)
+      bitmapInstallLibrary_SSE2();
+#endif
+}
+
+MODULE_BEGIN( BitmapUtils )
+
+   MODULE_INIT
+   {
+      bitmapInstallLibrary();
+   }
+
+MODULE_END;
@@ -31,6 +31,7 @@ extern void (*bitmapExtrude5551)(const void *srcMip, void *mip, U32 height, U32
 extern void (*bitmapExtrudeRGB)(const void *srcMip, void *mip, U32 height, U32 width);
 extern void (*bitmapExtrudeRGBA)(const void *srcMip, void *mip, U32 height, U32 width);
 extern void(*bitmapExtrudeFPRGBA)(const void *srcMip, void *mip, U32 height, U32 width);
+extern void (*bitmapExtrudeRGBA_sRGB)(const void *srcMip, void *mip, U32 height, U32 width);
 extern void (*bitmapConvertRGB_to_5551)(U8 *src, U32 pixels);
 extern void (*bitmapConvertRGB_to_1555)(U8 *src, U32 pixels);
 extern void (*bitmapConvertRGB_to_RGBX)( U8 **src, U32 pixels );
@@ -39,4 +40,10 @@ extern void (*bitmapConvertA8_to_RGBA)( U8 **src, U32 pixels );
 
 void bitmapExtrudeRGB_c(const void *srcMip, void *mip, U32 height, U32 width);
 
+/// Installs the fastest bitmap routines supported by the CPU.  This
+/// is done at startup, but can be called again to pick other routines.
+///
+/// @param properties   The CPU_PROP flags to use or zero to detect them.
+void bitmapInstallLibrary(U32 properties = 0);
+
 #endif //_BITMAPUTILS_H_
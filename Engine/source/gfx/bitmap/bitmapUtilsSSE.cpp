@@ -0,0 +1,111 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "gfx/bitmap/bitmapUtils.h"
+
+#if defined(TORQUE_CPU_X86) || defined(TORQUE_CPU_X64)
+
+#include <emmintrin.h>
+
+// GCC and Clang only allow the intrinsics of instruction sets that
+// are enabled, so mark the functions which need more than the build
+// targets.  They are only called after checking the CPU supports them.
+#if defined(TORQUE_COMPILER_GCC) || defined(__clang__)
+#define BITMAP_TARGET(isa) __attribute__((target(isa)))
+#else
+#define BITMAP_TARGET(isa)
+#endif
+
+extern void bitmapExtrudeRGBA_c(const void *srcMip, void *mip, U32 srcHeight, U32 srcWidth);
+
+/// Box filters four texels at a time with the same rounding as the C version.
+BITMAP_TARGET("sse2")
+void bitmapExtrudeRGBA_SSE2(const void *srcMip, void *mip, U32 srcHeight, U32 srcWidth)
+{
+   // Single column mips are too narrow to bother.
+   if (srcWidth < 8)
+   {
+      bitmapExtrudeRGBA_c(srcMip, mip, srcHeight, srcWidth);
+      return;
+   }
+
+   const U8 *src = (const U8 *) srcMip;
+   U8 *dst = (U8 *) mip;
+   U32 stride = srcHeight != 1 ? (srcWidth) * 4 : 0;
+
+   U32 width  = srcWidth  >> 1;
+   U32 height = srcHeight >> 1;
+   if (height == 0) height = 1;
+
+   const U32 numVectorTexels = width & ~3;
+
+   const __m128i zero = _mm_setzero_si128();
+   const __m128i round = _mm_set1_epi16(2);
+
+   for(U32 y = 0; y < height; y++)
+   {
+      for(U32 x = 0; x < numVectorTexels; x += 4)
+      {
+         // Eight source texels from each row make four destination texels.
+         const __m128i top0 = _mm_loadu_si128((const __m128i*)src);
+         const __m128i top1 = _mm_loadu_si128((const __m128i*)(src + 16));
+         const __m128i bot0 = _mm_loadu_si128((const __m128i*)(src + stride));
+         const __m128i bot1 = _mm_loadu_si128((const __m128i*)(src + stride + 16));
+
+         // Add the rows with two texels in each register.
+         const __m128i sum01 = _mm_add_epi16(_mm_unpacklo_epi8(top0, zero), _mm_unpacklo_epi8(bot0, zero));
+         const __m128i sum23 = _mm_add_epi16(_mm_unpackhi_epi8(top0, zero), _mm_unpackhi_epi8(bot0, zero));
+         const __m128i sum45 = _mm_add_epi16(_mm_unpacklo_epi8(top1, zero), _mm_unpacklo_epi8(bot1, zero));
+         const __m128i sum67 = _mm_add_epi16(_mm_unpackhi_epi8(top1, zero), _mm_unpackhi_epi8(bot1, zero));
+
+         // Then add the neighboring texels.
+         __m128i lo = _mm_add_epi16(_mm_unpacklo_epi64(sum01, sum23), _mm_unpackhi_epi64(sum01, sum23));
+         __m128i hi = _mm_add_epi16(_mm_unpacklo_epi64(sum45, sum67), _mm_unpackhi_epi64(sum45, sum67));
+
+         lo = _mm_srli_epi16(_mm_add_epi16(lo, round), 2);
+         hi = _mm_srli_epi16(_mm_add_epi16(hi, round), 2);
+
+         _mm_storeu_si128((__m128i*)dst, _mm_packus_epi16(lo, hi));
+
+         src += 32;
+         dst += 16;
+      }
+
+      // Do the remainder in C.
+      for(U32 x = numVectorTexels; x < width; x++)
+      {
+         for (U32 c = 0; c < 4; c++)
+            *dst++ = (U32(src[c]) + U32(src[c + 4]) + U32(src[c + stride]) + U32(src[c + stride + 4]) + 2) >> 2;
+         src += 8;
+      }
+
+      src += stride;   // skip
+   }
+}
+
+void bitmapInstallLibrary_SSE2()
+{
+   bitmapExtrudeRGBA = bitmapExtrudeRGBA_SSE2;
+}
+
+#endif
@@ -610,6 +610,33 @@ template<> void *Resource<DDSFile>::create( const Torque::Path &path )
    Con::printf( "Resource<DDSFile>::create - [%s]", path.getFullPath().c_str() );
 #endif
 
+   return DDSFile::readFile( path, DDSFile::smDropMipCount );
+}
+
+template<> ResourceBase::Signature  Resource<DDSFile>::signature()
+{
+   return MakeFourCC('D','D','S',' '); // Direct Draw Surface
+}
+
+Resource<DDSFile> DDSFile::load( const Torque::Path &path, U32 dropMipCount )
+{
+   PROFILE_SCOPE( DDSFile_load );
+   
+   // HACK:  It sucks that we cannot pass parameters into 
+   // the resource manager loading system.
+   DDSFile::smDropMipCount = dropMipCount;
+   Resource<DDSFile> ret = ResourceManager::get().load( path );
+   DDSFile::smDropMipCount = 0;
+
+   // Any kind of error checking or path stepping can happen here
+
+   return ret;
+}
+
+//------------------------------------------------------------------------------
+
+DDSFile* DDSFile::readFile( const Torque::Path &path, U32 dropMipCount )
+{
    FileStream stream;
 
    stream.open( path.getFullPath(), Torque::FS::File::Read );
@@ -619,7 +646,7 @@ template<> void *Resource<DDSFile>::create( const Torque::Path &path )
 
    DDSFile *retDDS = new DDSFile;
 
-   if( !retDDS->read( stream, DDSFile::smDropMipCount ) )
+   if( !retDDS->read( stream, dropMipCount ) )
    {
       delete retDDS;
       return NULL;
@@ -635,26 +662,6 @@ template<> void *Resource<DDSFile>::create( const Torque::Path &path )
    return retDDS;
 }
 
-template<> ResourceBase::Signature  Resource<DDSFile>::signature()
-{
-   return MakeFourCC('D','D','S',' '); // Direct Draw Surface
-}
-
-Resource<DDSFile> DDSFile::load( const Torque::Path &path, U32 dropMipCount )
-{
-   PROFILE_SCOPE( DDSFile_load );
-   
-   // HACK:  It sucks that we cannot pass parameters into 
-   // the resource manager loading system.
-   DDSFile::smDropMipCount = dropMipCount;
-   Resource<DDSFile> ret = ResourceManager::get().load( path );
-   DDSFile::smDropMipCount = 0;
-
-   // Any kind of error checking or path stepping can happen here
-
-   return ret;
-}
-
 //------------------------------------------------------------------------------
 
 DDSFile *DDSFile::createDDSFileFromGBitmap( const GBitmap *gbmp )
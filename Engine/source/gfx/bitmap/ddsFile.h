@@ -173,6 +173,12 @@ struct DDSFile
 
    static Resource<DDSFile> load( const Torque::Path &path, U32 dropMipCount );
 
+   /// Reads a DDS file directly without going thru the ResourceManager.
+   ///
+   /// This is safe to call from worker threads.  The caller owns the
+   /// returned DDSFile which is NULL if the file could not be read.
+   static DDSFile* readFile( const Torque::Path &path, U32 dropMipCount );
+
    // For debugging fun!
    static S32 smActiveCopies;
 
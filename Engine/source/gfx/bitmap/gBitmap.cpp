@@ -455,6 +455,13 @@ void GBitmap::extrudeMipLevels(bool clearBorders)
          break;
       }
 
+      case GFXFormatR8G8B8A8_SRGB:
+      {
+         for(U32 i = 1; i < mNumMipLevels; i++)
+            bitmapExtrudeRGBA_sRGB(getBits(i - 1), getWritableBits(i), getHeight(i-1), getWidth(i-1));
+         break;
+      }
+
       case GFXFormatR16G16B16A16F:
       {
          for (U32 i = 1; i < mNumMipLevels; i++)
@@ -1226,13 +1233,35 @@ template<> void *Resource<GBitmap>::create(const Torque::Path &path)
    Con::printf( "Resource<GBitmap>::create - [%s]", path.getFullPath().c_str() );
 #endif
 
+   return GBitmap::readFile( path );
+}
+
+template<> ResourceBase::Signature  Resource<GBitmap>::signature()
+{
+   return MakeFourCC('b','i','t','m');
+}
+
+Resource<GBitmap> GBitmap::load(const Torque::Path &path)
+{
+   Resource<GBitmap> ret = _load( path );
+   if ( ret != NULL )
+      return ret;
+
+   // Do a recursive search.
+   return _search( path );
+}
+
+GBitmap* GBitmap::readFile(const Torque::Path &path)
+{
+   PROFILE_SCOPE( GBitmap_readFile );
+
    FileStream  stream;
 
    stream.open( path.getFullPath(), Torque::FS::File::Read );
 
    if ( stream.getStatus() != Stream::Ok )
    {
-      Con::errorf( "Resource<GBitmap>::create - failed to open '%s'", path.getFullPath().c_str() );
+      Con::errorf( "GBitmap::readFile - failed to open '%s'", path.getFullPath().c_str() );
       return NULL;
    }
 
@@ -1240,7 +1269,7 @@ template<> void *Resource<GBitmap>::create(const Torque::Path &path)
    const String extension = path.getExtension();
    if( !bmp->readBitmap( extension, stream ) )
    {
-      Con::errorf( "Resource<GBitmap>::create - error reading '%s'", path.getFullPath().c_str() );
+      Con::errorf( "GBitmap::readFile - error reading '%s'", path.getFullPath().c_str() );
       delete bmp;
       bmp = NULL;
    }
@@ -1248,21 +1277,6 @@ template<> void *Resource<GBitmap>::create(const Torque::Path &path)
    return bmp;
 }
 
-template<> ResourceBase::Signature  Resource<GBitmap>::signature()
-{
-   return MakeFourCC('b','i','t','m');
-}
-
-Resource<GBitmap> GBitmap::load(const Torque::Path &path)
-{
-   Resource<GBitmap> ret = _load( path );
-   if ( ret != NULL )
-      return ret;
-
-   // Do a recursive search.
-   return _search( path );
-}
-
 Resource<GBitmap> GBitmap::_load(const Torque::Path &path)
 {
    PROFILE_SCOPE( GBitmap_load );
@@ -118,6 +118,11 @@ public:
    ///
    static Resource<GBitmap> load(const Torque::Path &path);
 
+   /// Reads a bitmap from the file without going through the resource
+   /// manager, so unlike load() it can be called from any thread.  The
+   /// path must have an extension.  Returns NULL on failure.
+   static GBitmap* readFile(const Torque::Path &path);
+
 protected:
 
    static Resource<GBitmap> _load(const Torque::Path &path);
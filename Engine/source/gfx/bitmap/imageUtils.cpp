@@ -102,7 +102,7 @@ namespace ImageUtil
    }
 
    // compress DDSFile
-   bool ddsCompress(DDSFile *srcDDS, const GFXFormat compressFormat,const CompressQuality compressQuality)
+   bool ddsCompress(DDSFile *srcDDS, const GFXFormat compressFormat,const CompressQuality compressQuality, const bool useThreadPool)
    {
       if (srcDDS->mBytesPerPixel != 4)
       {
@@ -143,14 +143,19 @@ namespace ImageUtil
                U8 *dstBits = new U8[mipSz];
                dstDataStore[dataIndex] = dstBits;
 
-               ThreadSafeRef<CompressJob> item(new CompressJob(srcBits, dstBits, srcDDS->getWidth(currentMip), srcDDS->getHeight(currentMip), compressFormat, compressQuality));
-               pThreadPool->queueWorkItem(item);
-
+               if (useThreadPool)
+               {
+                  ThreadSafeRef<CompressJob> item(new CompressJob(srcBits, dstBits, srcDDS->getWidth(currentMip), srcDDS->getHeight(currentMip), compressFormat, compressQuality));
+                  pThreadPool->queueWorkItem(item);
+               }
+               else
+                  rawCompress(srcBits, dstBits, srcDDS->getWidth(currentMip), srcDDS->getHeight(currentMip), compressFormat, compressQuality);
             }
          }
 
          //wait for work items to finish
-         pThreadPool->waitForAllItems();
+         if (useThreadPool)
+            pThreadPool->waitForAllItems();
 
          for (S32 cubeFace = 0; cubeFace < nCubeFaces; cubeFace++)
          {
@@ -171,8 +176,9 @@ namespace ImageUtil
          // Create a new surface, this will be the DXT compressed surface. Once we
          // are done, we can discard the old surface, and replace it with this one.
          DDSFile::SurfaceData *pNewSurface = new DDSFile::SurfaceData();
-         //no point using threading if only 1 mip
-         const bool useThreading = bool(mipCount > 1);
+         //no point using threading if only 1 mip, and a pool worker
+         //can't wait on the pool as it counts itself as pending
+         const bool useThreading = useThreadPool && mipCount > 1;
          for (U32 currentMip = 0; currentMip < mipCount; currentMip++)
          {
             const U8 *pSrcBits = pSrcSurface->mMips[currentMip];
@@ -46,8 +46,8 @@ namespace ImageUtil
 
    // compress raw pixel data, expects rgba format
    bool rawCompress(const U8 *srcRGBA, U8 *dst, const S32 width, const S32 height, const GFXFormat compressFormat, const CompressQuality compressQuality = LowQuality);
-   // compress DDSFile
-   bool ddsCompress(DDSFile *srcDDS, const GFXFormat compressFormat, const CompressQuality compressQuality = LowQuality);
+   // compress DDSFile, pass useThreadPool false when calling from a thread pool worker
+   bool ddsCompress(DDSFile *srcDDS, const GFXFormat compressFormat, const CompressQuality compressQuality = LowQuality, const bool useThreadPool = true);
    // decompress compressed pixel data, dest data should be rgba format
    bool decompress(const U8 *src, U8 *dstRGBA, const S32 width, const S32 height, const GFXFormat srcFormat);
    //swizzle dds file
@@ -99,15 +99,6 @@ static void pngFlushDataFn(png_structp /*png_ptr*/)
    //
 }
 
-static png_voidp pngMallocFn(png_structp /*png_ptr*/, png_size_t size)
-{
-   return FrameAllocator::alloc(size);
-}
-
-static void pngFreeFn(png_structp /*png_ptr*/, png_voidp /*mem*/)
-{
-}
-
 static png_voidp pngRealMallocFn(png_structp /*png_ptr*/, png_size_t size)
 {
    return (png_voidp)dMalloc(size);
@@ -149,7 +140,8 @@ static bool sReadPNG(Stream &stream, GBitmap *bitmap)
       return false;
    }
 
-   U32 prevWaterMark = FrameAllocator::getWaterMark();
+   // Textures are read on the texture loader threads, so stay off
+   // the frame allocator, which belongs to the main thread.
    png_structp png_ptr = png_create_read_struct_2(PNG_LIBPNG_VER_STRING,
       NULL,
       pngFatalErrorFn,
@@ -159,10 +151,7 @@ static bool sReadPNG(Stream &stream, GBitmap *bitmap)
       pngRealFreeFn);
 
    if (png_ptr == NULL) 
-   {
-      FrameAllocator::setWaterMark(prevWaterMark);
       return false;
-   }
 
    png_infop info_ptr = png_create_info_struct(png_ptr);
    if (info_ptr == NULL) 
@@ -170,8 +159,6 @@ static bool sReadPNG(Stream &stream, GBitmap *bitmap)
       png_destroy_read_struct(&png_ptr,
          (png_infopp)NULL,
          (png_infopp)NULL);
-
-      FrameAllocator::setWaterMark(prevWaterMark);
       return false;
    }
 
@@ -181,8 +168,6 @@ static bool sReadPNG(Stream &stream, GBitmap *bitmap)
       png_destroy_read_struct(&png_ptr,
          &info_ptr,
          (png_infopp)NULL);
-
-      FrameAllocator::setWaterMark(prevWaterMark);
       return false;
    }
 
@@ -314,8 +299,6 @@ static bool sReadPNG(Stream &stream, GBitmap *bitmap)
    // Check this bitmap for transparency
    bitmap->checkForTransparency();
 
-   FrameAllocator::setWaterMark(prevWaterMark);
-
    return true;
 }
 
@@ -344,8 +327,8 @@ static bool _writePNG(GBitmap *bitmap, Stream &stream, U32 compressionLevel, U32
       pngFatalErrorFn,
       pngWarningFn,
       NULL,
-      pngMallocFn,
-      pngFreeFn);
+      pngRealMallocFn,
+      pngRealFreeFn);
    if (png_ptr == NULL)
       return (false);
 
@@ -418,18 +401,18 @@ static bool _writePNG(GBitmap *bitmap, Stream &stream, U32 compressionLevel, U32
    }
 
    png_write_info(png_ptr, info_ptr);
-   FrameAllocatorMarker marker;
-   png_bytep* row_pointers = (png_bytep*)marker.alloc( height * sizeof( png_bytep ) );
+   Vector<png_bytep> row_pointers;
+   row_pointers.setSize( height );
    for (U32 i=0; i<height; i++)
       row_pointers[i] = const_cast<png_bytep>(bitmap->getAddress(0, i));
 
-   png_write_image(png_ptr, row_pointers);
+   png_write_image(png_ptr, row_pointers.address());
 
    // Write S3TC data if present...
    // Write FXT1 data if present...
 
    png_write_end(png_ptr, info_ptr);
-   png_destroy_write_struct(&png_ptr, (png_infopp)NULL);
+   png_destroy_write_struct(&png_ptr, &info_ptr);
 
    return true;
 }
@@ -438,14 +421,10 @@ static bool _writePNG(GBitmap *bitmap, Stream &stream, U32 compressionLevel, U32
 //--------------------------------------------------------------------------
 static bool sWritePNG(GBitmap *bitmap, Stream &stream, U32 compressionLevel)
 {
-   U32 waterMark = FrameAllocator::getWaterMark();
-
+   // Bitmaps are also written from worker threads, e.g. the terrain
+   // base texture cache, so this stays off the frame allocator.
    if ( compressionLevel < 10 )
-   {
-      bool retVal = _writePNG(bitmap, stream, compressionLevel, 0, PNG_ALL_FILTERS);
-      FrameAllocator::setWaterMark(waterMark);
-      return retVal;
-   }
+      return _writePNG(bitmap, stream, compressionLevel, 0, PNG_ALL_FILTERS);
 
    // check all our methods of compression to find the best one and use it
    U8* buffer = new U8[1 << 22]; // 4 Megs.  Should be enough...
@@ -473,13 +452,9 @@ static bool sWritePNG(GBitmap *bitmap, Stream &stream, U32 compressionLevel)
          {
             pMemStream->setPosition(0);
 
-            U32 waterMarkInner = FrameAllocator::getWaterMark();
-
             if (_writePNG(bitmap, *pMemStream, cl, zStrategies[zs], pngFilters[pf]) == false)
                AssertFatal(false, "Handle this error!");
 
-            FrameAllocator::setWaterMark(waterMarkInner);
-
             if (pMemStream->getPosition() < minSize) 
             {
                minSize = pMemStream->getPosition();
@@ -496,13 +471,10 @@ static bool sWritePNG(GBitmap *bitmap, Stream &stream, U32 compressionLevel)
    delete [] buffer;
 
 
-   bool retVal = _writePNG(bitmap, stream,
+   return _writePNG(bitmap, stream,
       bestCLevel,
       zStrategies[bestStrategy],
       pngFilters[bestFilter]);
-   FrameAllocator::setWaterMark(waterMark);
-
-   return retVal;
 }
 
 //--------------------------------------------------------------------------
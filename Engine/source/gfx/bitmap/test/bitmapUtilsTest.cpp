@@ -0,0 +1,180 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2014 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "gfx/bitmap/bitmapUtils.h"
+#include "gfx/bitmap/gBitmap.h"
+#include "core/util/swizzle.h"
+#include "math/mRandom.h"
+#include "console/console.h"
+
+FIXTURE(BitmapUtils)
+{
+public:
+   GBitmap* source;
+
+   void SetUp()
+   {
+      MRandomLCG random(1376312589);
+
+      source = new GBitmap(1024, 1024, false, GFXFormatR8G8B8A8);
+      U8 *bits = source->getWritableBits();
+      for (U32 i = 0; i < source->getSurfaceSize(0); i++)
+         bits[i] = random.randI(0, 255);
+   }
+
+   void TearDown()
+   {
+      delete source;
+
+      // Put back the routines for this CPU.
+      bitmapInstallLibrary();
+      swizzleInstallLibrary();
+   }
+
+   /// Returns a copy of the source with its mips built by the C routines
+   /// if cOnly is set, or by the fastest routines otherwise.
+   GBitmap* extrude(bool cOnly)
+   {
+      bitmapInstallLibrary(cOnly ? CPU_PROP_C : 0);
+
+      GBitmap *bmp = new GBitmap(*source);
+      bmp->extrudeMipLevels();
+      return bmp;
+   }
+};
+
+TEST_FIX(BitmapUtils, ExtrudeMatchesC)
+{
+   GBitmap *expected = extrude(true);
+   GBitmap *actual = extrude(false);
+
+   ASSERT_EQ(expected->getNumMipLevels(), actual->getNumMipLevels());
+   for (U32 i = 1; i < expected->getNumMipLevels(); i++)
+      EXPECT_EQ(0, dMemcmp(expected->getBits(i), actual->getBits(i), expected->getSurfaceSize(i)))
+         << "Mip " << i << " differs from the C version";
+
+   delete expected;
+   delete actual;
+}
+
+TEST_FIX(BitmapUtils, ExtrudeSRGB)
+{
+   // A checker of black and white averages to mid gray in linear
+   // space, which is much brighter than 128 in sRGB.
+   GBitmap bmp(2, 2, true, GFXFormatR8G8B8A8_SRGB);
+   U8 *bits = bmp.getWritableBits();
+   for (U32 i = 0; i < 4; i++)
+   {
+      const U8 value = (i == 0 || i == 3) ? 255 : 0;
+      bits[i * 4 + 0] = bits[i * 4 + 1] = bits[i * 4 + 2] = value;
+      bits[i * 4 + 3] = value;
+   }
+
+   bitmapExtrudeRGBA_sRGB(bmp.getBits(0), bmp.getWritableBits(1), 2, 2);
+
+   const U8 *mip = bmp.getBits(1);
+   EXPECT_NEAR(188, mip[0], 1);
+   EXPECT_EQ(mip[0], mip[1]);
+   EXPECT_EQ(mip[0], mip[2]);
+
+   // Alpha isn't gamma corrected.
+   EXPECT_EQ(128, mip[3]);
+
+   // Flat colors keep their value.
+   GBitmap flat(4, 4, true, GFXFormatR8G8B8A8_SRGB);
+   for (U32 value = 0; value < 256; value++)
+   {
+      dMemset(flat.getWritableBits(0), value, flat.getSurfaceSize(0));
+      flat.extrudeMipLevels();
+      EXPECT_EQ(value, flat.getBits(2)[0]);
+   }
+}
+
+TEST_FIX(BitmapUtils, SwizzleMatchesC)
+{
+   const U32 size = 1024 + 12;
+   U8 *expected = new U8[size];
+   U8 *actual = new U8[size];
+
+   swizzleInstallLibrary(CPU_PROP_C);
+   Swizzles::bgra.ToBuffer(expected, source->getBits(), size);
+
+   // The fast version has to work in place.
+   swizzleInstallLibrary();
+   dMemcpy(actual, source->getBits(), size);
+   Swizzles::bgra.InPlace(actual, size);
+
+   EXPECT_EQ(0, dMemcmp(expected, actual, size));
+   EXPECT_EQ(source->getBits()[2], actual[0]);
+   EXPECT_EQ(source->getBits()[0], actual[2]);
+
+   delete [] expected;
+   delete [] actual;
+}
+
+TEST_FIX(BitmapUtils, StressTestKernels)
+{
+   // MB/s of each mip and swizzle routine, first with the C
+   // versions installed and then with the best for this CPU.
+
+   const U32 numIterations = 20;
+   const F32 numMB = F32(source->getSurfaceSize(0) * numIterations) / (1024.f * 1024.f);
+
+   U8 *mip = new U8[source->getSurfaceSize(0) / 4];
+   U8 *swizzled = new U8[source->getSurfaceSize(0)];
+
+   Con::printf("BitmapUtils throughput on %ix%i RGBA8:", source->getWidth(), source->getHeight());
+
+   for (U32 pass = 0; pass < 2; pass++)
+   {
+      const bool cOnly = pass == 0;
+      bitmapInstallLibrary(cOnly ? CPU_PROP_C : 0);
+      swizzleInstallLibrary(cOnly ? CPU_PROP_C : 0);
+
+      U32 start = Platform::getRealMilliseconds();
+      for (U32 n = 0; n < numIterations; n++)
+         bitmapExtrudeRGBA(source->getBits(), mip, source->getHeight(), source->getWidth());
+      const U32 boxTime = Platform::getRealMilliseconds() - start;
+
+      start = Platform::getRealMilliseconds();
+      for (U32 n = 0; n < numIterations; n++)
+         bitmapExtrudeRGBA_sRGB(source->getBits(), mip, source->getHeight(), source->getWidth());
+      const U32 srgbTime = Platform::getRealMilliseconds() - start;
+
+      start = Platform::getRealMilliseconds();
+      for (U32 n = 0; n < numIterations; n++)
+         Swizzles::bgra.ToBuffer(swizzled, source->getBits(), source->getSurfaceSize(0));
+      const U32 swizzleTime = Platform::getRealMilliseconds() - start;
+
+      Con::printf("   %s:", cOnly ? "C" : "installed");
+      Con::printf("      box extrude:  %.1f MB/s", numMB * 1000.f / F32(getMax(boxTime, 1U)));
+      Con::printf("      sRGB extrude: %.1f MB/s", numMB * 1000.f / F32(getMax(srgbTime, 1U)));
+      Con::printf("      bgra swizzle: %.1f MB/s", numMB * 1000.f / F32(getMax(swizzleTime, 1U)));
+   }
+
+   delete [] mip;
+   delete [] swizzled;
+}
+
+#endif
@@ -63,6 +63,7 @@ void GenericConstBufferLayout::addParameter(const String& name, const GFXShaderC
    desc.arraySize = arraySize;
    desc.alignValue = alignValue;
    desc.index = mCurrentIndex++;
+   mParamIndex.insert(name, mParams.size());
    mParams.push_back(desc);
    mBufferSize = getMax(desc.offset + desc.size, mBufferSize);
    AssertFatal(mBufferSize, "Empty constant buffer!");
@@ -138,15 +139,12 @@ bool GenericConstBufferLayout::setMatrix(const ParamDesc& pd, const GFXShaderCon
 
 bool GenericConstBufferLayout::getDesc(const String& name, ParamDesc& param) const
 {
-   for (U32 i = 0; i < mParams.size(); i++)
-   {
-      if (mParams[i].name.equal(name))
-      {
-         param = mParams[i];
-         return true;
-      }
-   } 
-   return false;
+   Map<StringCase,U32>::ConstIterator iter = mParamIndex.find(name);
+   if (iter == mParamIndex.end())
+      return false;
+
+   param = mParams[iter->value];
+   return true;
 }
 
 bool GenericConstBufferLayout::getDesc(const U32 index, ParamDesc& param) const
@@ -204,6 +202,7 @@ bool GenericConstBufferLayout::read(Stream* s)
    if (!s->read(&numParams))
       return false;
    mParams.setSize(numParams);
+   mParamIndex.clear();
    mBufferSize = 0;
    mCurrentIndex = 0;
    for (U32 i = 0; i < mParams.size(); i++)
@@ -225,6 +224,7 @@ bool GenericConstBufferLayout::read(Stream* s)
          return false;
       mBufferSize = getMax(mParams[i].offset + mParams[i].size, mBufferSize);
       mCurrentIndex = getMax(mParams[i].index, mCurrentIndex);
+      mParamIndex.insert(mParams[i].name, i);
    }
    mCurrentIndex++;
    return true;
@@ -233,6 +233,7 @@ bool GenericConstBufferLayout::read(Stream* s)
 void GenericConstBufferLayout::clear()
 {
    mParams.clear();    
+   mParamIndex.clear();
    mBufferSize = 0;
    mCurrentIndex = 0;
    mTimesCleared++;
@@ -253,6 +254,11 @@ GenericConstBuffer::GenericConstBuffer(GenericConstBufferLayout* layout)
       // will work in release as well.
       dMemset( mBuffer, 0xFFFF, mLayout->getBufferSize() );
 
+      // One bit per range rounded up to whole words.
+      const U32 ranges = ( mLayout->getBufferSize() + DirtyRangeSize - 1 ) >> DirtyRangeShift;
+      mDirtyRanges.setSize( ( ranges + 31 ) >> 5 );
+      _setDirtyRanges( false );
+
       #ifdef TORQUE_DEBUG
       
          // Clear the debug assignment tracking.
@@ -142,6 +142,10 @@ protected:
    
    /// Vector of parameter descriptions.
    Params mParams;
+
+   /// Maps the parameter names to their index in mParams.
+   Map<StringCase,U32> mParamIndex;
+
    U32 mBufferSize;
    U32 mCurrentIndex;
 
@@ -228,6 +232,14 @@ public:
    /// @see setDirty
    inline bool isDirty() const { return mDirtyEnd != 0; }
 
+   /// Returns true if any part of the byte range has been modified
+   /// since the last call to getDirtyBuffer or setDirty.
+   ///
+   /// The changes are tracked at DirtyRangeSize granularity, so a
+   /// device with several constant buffers packed into one layout can
+   /// skip uploading the ones which didn't change.
+   inline bool isRangeDirty( U32 start, U32 size ) const;
+
    /// Returns true if have the same layout and hold the same 
    /// data as the input buffer.
    inline bool isEqual( const GenericConstBuffer *buffer ) const;
@@ -235,6 +247,11 @@ public:
    /// Returns our layout object.
    inline GenericConstBufferLayout* getLayout() const { return mLayout; }
 
+   /// The size in bytes of the ranges tracked by the dirty bits,
+   /// which is a single 16 byte shader register.
+   static const U32 DirtyRangeShift = 4;
+   static const U32 DirtyRangeSize = 1 << DirtyRangeShift;
+
    #ifdef TORQUE_DEBUG
    
       /// Helper function used to assert on unset constants.
@@ -247,6 +264,9 @@ protected:
    /// Returns a pointer to the raw buffer
    inline const U8* getBuffer() const { return mBuffer; }
 
+   /// Sets or clears all the dirty range bits.
+   inline void _setDirtyRanges( bool dirty );
+
    /// Called by the inlined set functions above to do the
    /// real dirty work of copying the data to the right location
    /// within the buffer.
@@ -272,6 +292,9 @@ protected:
    /// is not dirty.
    U32 mDirtyEnd;
 
+   /// One bit for each DirtyRangeSize block of the 
+   /// buffer which is set when the block is modified.
+   Vector<U32> mDirtyRanges;
 
    #ifdef TORQUE_DEBUG
    
@@ -317,9 +340,35 @@ inline void GenericConstBuffer::internalSet( const GenericConstBufferLayout::Par
       // later in GenericConstBuffer::getDirtyBuffer.
       mDirtyStart = getMin( pd.offset, mDirtyStart );
       mDirtyEnd = getMax( pd.offset + pd.size, mDirtyEnd );
+
+      // Most constants touch one or two registers.
+      const U32 last = ( pd.offset + pd.size - 1 ) >> DirtyRangeShift;
+      for ( U32 i = pd.offset >> DirtyRangeShift; i <= last; i++ )
+         mDirtyRanges[ i >> 5 ] |= 1 << ( i & 31 );
    }
 }
 
+inline void GenericConstBuffer::_setDirtyRanges( bool dirty )
+{
+   dMemset( mDirtyRanges.address(), dirty ? 0xFF : 0, mDirtyRanges.memSize() );
+}
+
+inline bool GenericConstBuffer::isRangeDirty( U32 start, U32 size ) const
+{
+   // Reject ranges outside of the dirty span first.
+   if ( size == 0 || start >= mDirtyEnd || start + size <= mDirtyStart )
+      return false;
+
+   const U32 last = ( start + size - 1 ) >> DirtyRangeShift;
+   for ( U32 i = start >> DirtyRangeShift; i <= last; i++ )
+   {
+      if ( mDirtyRanges[ i >> 5 ] & ( 1 << ( i & 31 ) ) )
+         return true;
+   }
+
+   return false;
+}
+
 inline void GenericConstBuffer::setDirty( bool dirty )
 { 
    if ( !mBuffer )
@@ -335,6 +384,8 @@ inline void GenericConstBuffer::setDirty( bool dirty )
       mDirtyStart = U32_MAX;
       mDirtyEnd = 0;
    }
+
+   _setDirtyRanges( dirty );
 }
 
 inline const U8* GenericConstBuffer::getDirtyBuffer( U32 *start, U32 *size )
@@ -351,6 +402,7 @@ inline const U8* GenericConstBuffer::getDirtyBuffer( U32 *start, U32 *size )
    // Clear the dirty state while we're here.
    mDirtyStart = U32_MAX;
    mDirtyEnd = 0;
+   _setDirtyRanges( false );
 
    return buffer;
 }
@@ -0,0 +1,457 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "gfx/gfxCommandBuffer.h"
+
+#include "gfx/gfxPrimitiveBuffer.h"
+#include "gfx/gfxVertexBuffer.h"
+#include "gfx/gfxShader.h"
+#include "gfx/gfxCubemap.h"
+#include "platform/profiler.h"
+#include "platform/threads/thread.h"
+
+
+void GFXCommandBuffer::ReplayStats::clear()
+{
+   mNumCommands = 0;
+   mNumSubmitted = 0;
+   mNumFiltered = 0;
+   mNumDrawCalls = 0;
+}
+
+//-----------------------------------------------------------------------------
+
+/// The device state as far as a replay knows it.  Nothing is known when a
+/// replay starts or after a callback as the state could be anything then.
+class GFXCommandBuffer::ReplayState
+{
+public:
+
+   /// A tracked piece of device state.
+   struct Slot
+   {
+      bool known;
+      const void *value;
+      U32 extra;
+
+      Slot() : known( false ), value( NULL ), extra( 0 ) {}
+
+      /// Returns true if setting the given value would change the state
+      /// and remembers it as the current one.
+      bool update( const void *newValue, U32 newExtra = 0 )
+      {
+         if ( known && value == newValue && extra == newExtra )
+            return false;
+
+         known = true;
+         value = newValue;
+         extra = newExtra;
+         return true;
+      }
+   };
+
+   Slot shader;
+   Slot constBuffer;
+   Slot stateBlock;
+   Slot textures[ GFX_TEXTURE_STAGE_COUNT ];
+   Slot vertexBuffers[ VertexStreamCount ];
+   Slot vertexFormat;
+   Slot primitiveBuffer;
+
+   bool worldKnown;
+   bool viewKnown;
+   bool projKnown;
+   MatrixF world;
+   MatrixF view;
+   MatrixF proj;
+
+   ReplayState() { reset(); }
+
+   void reset()
+   {
+      shader.known = false;
+      constBuffer.known = false;
+      stateBlock.known = false;
+      for ( U32 i = 0; i < GFX_TEXTURE_STAGE_COUNT; i++ )
+         textures[i].known = false;
+      for ( U32 i = 0; i < VertexStreamCount; i++ )
+         vertexBuffers[i].known = false;
+      vertexFormat.known = false;
+      primitiveBuffer.known = false;
+
+      worldKnown = false;
+      viewKnown = false;
+      projKnown = false;
+   }
+
+   static bool updateMatrix( bool &known, MatrixF &current, const MatrixF &mat )
+   {
+      if ( known && dMemcmp( (const F32*)current, (const F32*)mat, sizeof( F32 ) * 16 ) == 0 )
+         return false;
+
+      known = true;
+      current = mat;
+      return true;
+   }
+};
+
+//-----------------------------------------------------------------------------
+
+GFXCommandBuffer::GFXCommandBuffer()
+   : mLastPrimitiveBuffer( NULL )
+{
+   VECTOR_SET_ASSOCIATION( mCommands );
+   VECTOR_SET_ASSOCIATION( mMatrices );
+   VECTOR_SET_ASSOCIATION( mCallbacks );
+   VECTOR_SET_ASSOCIATION( mResourceRefs );
+   VECTOR_SET_ASSOCIATION( mPendingRefs );
+}
+
+void GFXCommandBuffer::clear()
+{
+   mCommands.clear();
+   mMatrices.clear();
+   mCallbacks.clear();
+   mResourceRefs.clear();
+   mPendingRefs.clear();
+   mLastPrimitiveBuffer = NULL;
+}
+
+GFXCommandBuffer::Command& GFXCommandBuffer::_addCommand( CommandType type, U32 slot, void *resource )
+{
+   mCommands.increment();
+
+   Command &cmd = mCommands.last();
+   cmd.type = type;
+   cmd.slot = slot;
+   cmd.resource = resource;
+   return cmd;
+}
+
+void GFXCommandBuffer::_holdResource( StrongRefBase *resource )
+{
+   if ( !resource )
+      return;
+
+   // Recording code sets the same resources over and over,
+   // so skip holding the one held last.
+   if ( ThreadManager::isMainThread() )
+   {
+      if ( mResourceRefs.empty() || mResourceRefs.last() != resource )
+         mResourceRefs.push_back( resource );
+   }
+   else if ( mPendingRefs.empty() || mPendingRefs.last() != resource )
+      mPendingRefs.push_back( resource );
+}
+
+void GFXCommandBuffer::_addMatrix( CommandType type, const MatrixF &mat )
+{
+   _addCommand( type ).args[0] = mMatrices.size();
+   mMatrices.push_back( mat );
+}
+
+U32 GFXCommandBuffer::getNumCommands( CommandType type ) const
+{
+   U32 count = 0;
+   for ( U32 i = 0; i < mCommands.size(); i++ )
+   {
+      if ( mCommands[i].type == type )
+         count++;
+   }
+
+   return count;
+}
+
+//-----------------------------------------------------------------------------
+
+void GFXCommandBuffer::setShader( GFXShader *shader, bool force )
+{
+   _addCommand( CmdSetShader, 0, shader ).args[0] = force;
+   _holdResource( shader );
+}
+
+void GFXCommandBuffer::setShaderConstBuffer( GFXShaderConstBuffer *buffer )
+{
+   _addCommand( CmdSetShaderConstBuffer, 0, buffer );
+   _holdResource( buffer );
+}
+
+void GFXCommandBuffer::setStateBlock( GFXStateBlock *block )
+{
+   AssertFatal( block, "GFXCommandBuffer::setStateBlock - NULL state block!" );
+   _addCommand( CmdSetStateBlock, 0, block );
+   _holdResource( block );
+}
+
+void GFXCommandBuffer::setTexture( U32 stage, GFXTextureObject *texture )
+{
+   AssertFatal( stage < GFX_TEXTURE_STAGE_COUNT, "GFXCommandBuffer::setTexture - Out of range stage!" );
+   _addCommand( CmdSetTexture, stage, texture );
+   _holdResource( texture );
+}
+
+void GFXCommandBuffer::setCubeTexture( U32 stage, GFXCubemap *cubemap )
+{
+   AssertFatal( stage < GFX_TEXTURE_STAGE_COUNT, "GFXCommandBuffer::setCubeTexture - Out of range stage!" );
+   _addCommand( CmdSetCubeTexture, stage, cubemap );
+   _holdResource( cubemap );
+}
+
+void GFXCommandBuffer::setVertexBuffer( GFXVertexBuffer *buffer, U32 stream, U32 frequency )
+{
+   AssertFatal( stream < VertexStreamCount, "GFXCommandBuffer::setVertexBuffer - Bad stream index!" );
+   _addCommand( CmdSetVertexBuffer, stream, buffer ).args[0] = frequency;
+   _holdResource( buffer );
+}
+
+void GFXCommandBuffer::setVertexFormat( const GFXVertexFormat *vertexFormat )
+{
+   _addCommand( CmdSetVertexFormat, 0, const_cast< GFXVertexFormat* >( vertexFormat ) );
+}
+
+void GFXCommandBuffer::setPrimitiveBuffer( GFXPrimitiveBuffer *buffer )
+{
+   _addCommand( CmdSetPrimitiveBuffer, 0, buffer );
+   _holdResource( buffer );
+   mLastPrimitiveBuffer = buffer;
+}
+
+void GFXCommandBuffer::setWorldMatrix( const MatrixF &mat )
+{
+   _addMatrix( CmdSetWorldMatrix, mat );
+}
+
+void GFXCommandBuffer::setViewMatrix( const MatrixF &mat )
+{
+   _addMatrix( CmdSetViewMatrix, mat );
+}
+
+void GFXCommandBuffer::setProjectionMatrix( const MatrixF &mat )
+{
+   _addMatrix( CmdSetProjectionMatrix, mat );
+}
+
+void GFXCommandBuffer::drawPrimitive( GFXPrimitiveType primType, U32 vertexStart, U32 primitiveCount )
+{
+   Command &cmd = _addCommand( CmdDrawPrimitive );
+   cmd.args[0] = primType;
+   cmd.args[1] = vertexStart;
+   cmd.args[2] = primitiveCount;
+}
+
+void GFXCommandBuffer::drawIndexedPrimitive(   GFXPrimitiveType primType,
+                                                U32 startVertex,
+                                                U32 minIndex,
+                                                U32 numVerts,
+                                                U32 startIndex,
+                                                U32 primitiveCount )
+{
+   Command &cmd = _addCommand( CmdDrawIndexedPrimitive );
+   cmd.args[0] = primType;
+   cmd.args[1] = startVertex;
+   cmd.args[2] = minIndex;
+   cmd.args[3] = numVerts;
+   cmd.args[4] = startIndex;
+   cmd.args[5] = primitiveCount;
+}
+
+void GFXCommandBuffer::drawPrimitive( const GFXPrimitive &prim )
+{
+   // Like GFXDevice, leave adding the index buffer offset to drawIndexedPrimitive.
+   drawIndexedPrimitive(   prim.type,
+                           prim.startVertex,
+                           prim.minIndex,
+                           prim.numVertices,
+                           prim.startIndex,
+                           prim.numPrimitives );
+}
+
+void GFXCommandBuffer::drawPrimitive( U32 primitiveIndex )
+{
+   AssertFatal( mLastPrimitiveBuffer, "GFXCommandBuffer::drawPrimitive - No primitive buffer has been recorded!" );
+   AssertFatal( primitiveIndex < mLastPrimitiveBuffer->mPrimitiveCount, "GFXCommandBuffer::drawPrimitive - Out of range primitive index!" );
+   drawPrimitive( mLastPrimitiveBuffer->mPrimitiveArray[primitiveIndex] );
+}
+
+void GFXCommandBuffer::addCallback( const Callback &callback )
+{
+   _addCommand( CmdCallback ).args[0] = mCallbacks.size();
+   mCallbacks.push_back( callback );
+}
+
+//-----------------------------------------------------------------------------
+
+void GFXCommandBuffer::replay( GFXDevice *device, ReplayStats *outStats ) const
+{
+   const GFXCommandBuffer *buffer = this;
+   replayAll( device, &buffer, 1, outStats );
+}
+
+void GFXCommandBuffer::replayAll( GFXDevice *device, const GFXCommandBuffer *const *buffers, U32 numBuffers, ReplayStats *outStats )
+{
+   PROFILE_SCOPE( GFXCommandBuffer_replay );
+
+   AssertFatal( device, "GFXCommandBuffer::replayAll - No device!" );
+
+   ReplayState state;
+   ReplayStats stats;
+
+   for ( U32 i = 0; i < numBuffers; i++ )
+      buffers[i]->_replay( device, state, stats );
+
+   if ( outStats )
+   {
+      outStats->mNumCommands += stats.mNumCommands;
+      outStats->mNumSubmitted += stats.mNumSubmitted;
+      outStats->mNumFiltered += stats.mNumFiltered;
+      outStats->mNumDrawCalls += stats.mNumDrawCalls;
+   }
+}
+
+void GFXCommandBuffer::_replay( GFXDevice *device, ReplayState &state, ReplayStats &stats ) const
+{
+   // Now that we're on the device thread reference
+   // what was recorded on the worker threads.
+   for ( U32 i = 0; i < mPendingRefs.size(); i++ )
+      mResourceRefs.push_back( mPendingRefs[i] );
+   mPendingRefs.clear();
+
+   const U32 numCommands = mCommands.size();
+   stats.mNumCommands += numCommands;
+
+   for ( U32 i = 0; i < numCommands; i++ )
+   {
+      const Command &cmd = mCommands[i];
+      bool submit = true;
+
+      switch ( cmd.type )
+      {
+         case CmdSetShader:
+            submit = state.shader.update( cmd.resource ) || cmd.args[0];
+            if ( submit )
+               device->setShader( (GFXShader*)cmd.resource, cmd.args[0] );
+            break;
+
+         case CmdSetShaderConstBuffer:
+            // The device reads the constants when drawing, so setting
+            // the same buffer again is redundant even if it was changed.
+            submit = state.constBuffer.update( cmd.resource );
+            if ( submit )
+               device->setShaderConstBuffer( (GFXShaderConstBuffer*)cmd.resource );
+            break;
+
+         case CmdSetStateBlock:
+            submit = state.stateBlock.update( cmd.resource );
+            if ( submit )
+               device->setStateBlock( (GFXStateBlock*)cmd.resource );
+            break;
+
+         case CmdSetTexture:
+            submit = state.textures[cmd.slot].update( cmd.resource, CmdSetTexture );
+            if ( submit )
+               device->setTexture( cmd.slot, (GFXTextureObject*)cmd.resource );
+            break;
+
+         case CmdSetCubeTexture:
+            submit = state.textures[cmd.slot].update( cmd.resource, CmdSetCubeTexture );
+            if ( submit )
+               device->setCubeTexture( cmd.slot, (GFXCubemap*)cmd.resource );
+            break;
+
+         case CmdSetVertexBuffer:
+         {
+            GFXVertexBuffer *buffer = (GFXVertexBuffer*)cmd.resource;
+            submit = state.vertexBuffers[cmd.slot].update( buffer, cmd.args[0] );
+            if ( submit )
+            {
+               device->setVertexBuffer( buffer, cmd.slot, cmd.args[0] );
+
+               // The first stream also sets the vertex format.
+               if ( buffer && cmd.slot == 0 )
+                  state.vertexFormat.update( &buffer->mVertexFormat );
+            }
+            break;
+         }
+
+         case CmdSetVertexFormat:
+            submit = state.vertexFormat.update( cmd.resource );
+            if ( submit )
+            {
+               device->setVertexFormat( (const GFXVertexFormat*)cmd.resource );
+
+               // Setting the first stream again has to restore its format.
+               state.vertexBuffers[0].known = false;
+            }
+            break;
+
+         case CmdSetPrimitiveBuffer:
+            submit = state.primitiveBuffer.update( cmd.resource );
+            if ( submit )
+               device->setPrimitiveBuffer( (GFXPrimitiveBuffer*)cmd.resource );
+            break;
+
+         case CmdSetWorldMatrix:
+            submit = ReplayState::updateMatrix( state.worldKnown, state.world, mMatrices[cmd.args[0]] );
+            if ( submit )
+               device->setWorldMatrix( state.world );
+            break;
+
+         case CmdSetViewMatrix:
+            submit = ReplayState::updateMatrix( state.viewKnown, state.view, mMatrices[cmd.args[0]] );
+            if ( submit )
+               device->setViewMatrix( state.view );
+            break;
+
+         case CmdSetProjectionMatrix:
+            submit = ReplayState::updateMatrix( state.projKnown, state.proj, mMatrices[cmd.args[0]] );
+            if ( submit )
+               device->setProjectionMatrix( state.proj );
+            break;
+
+         case CmdDrawPrimitive:
+            device->drawPrimitive( (GFXPrimitiveType)cmd.args[0], cmd.args[1], cmd.args[2] );
+            stats.mNumDrawCalls++;
+            break;
+
+         case CmdDrawIndexedPrimitive:
+            device->drawIndexedPrimitive( (GFXPrimitiveType)cmd.args[0], cmd.args[1], cmd.args[2], cmd.args[3], cmd.args[4], cmd.args[5] );
+            stats.mNumDrawCalls++;
+            break;
+
+         case CmdCallback:
+            mCallbacks[cmd.args[0]]();
+            state.reset();
+            break;
+
+         default:
+            AssertFatal( false, "GFXCommandBuffer::_replay - Unknown command!" );
+            submit = false;
+            break;
+      }
+
+      if ( submit )
+         stats.mNumSubmitted++;
+      else
+         stats.mNumFiltered++;
+   }
+}
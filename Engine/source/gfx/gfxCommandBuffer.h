@@ -0,0 +1,214 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _GFXCOMMANDBUFFER_H_
+#define _GFXCOMMANDBUFFER_H_
+
+#ifndef _GFXDEVICE_H_
+#include "gfx/gfxDevice.h"
+#endif
+#ifndef _UTIL_DELEGATE_H_
+#include "core/util/delegate.h"
+#endif
+
+
+/// A list of device commands that is recorded now and replayed on
+/// the device later.
+///
+/// Recording does not touch the device at all, so command buffers can be
+/// filled on worker threads as long as each buffer is only used by a single
+/// thread at a time.  Replaying has to happen on the thread that owns the
+/// device.  Several buffers replayed with replayAll() are submitted in order
+/// as if they were a single buffer.
+///
+/// Replay drops state changes that would set what is already set, so
+/// recording code can simply set everything it needs for each draw.
+///
+/// The buffer holds a reference to each recorded resource until it is
+/// cleared, so it can be replayed any number of times.  Reference counts
+/// are not thread safe, so resources recorded on a worker thread are only
+/// referenced when the buffer is first replayed and whoever records them
+/// must keep them alive until then.
+///
+/// @note Vertex formats are not referenced and must outlive the buffer.
+/// The contents of shader constant buffers are read when the draw is
+/// submitted and not when it is recorded.
+class GFXCommandBuffer
+{
+public:
+
+   typedef Delegate< void() > Callback;
+
+   /// The number of vertex streams that can be recorded.  This
+   /// is the same as the number GFXDevice keeps track of.
+   static const U32 VertexStreamCount = 4;
+
+   /// The types of recorded commands.
+   enum CommandType
+   {
+      CmdSetShader,
+      CmdSetShaderConstBuffer,
+      CmdSetStateBlock,
+      CmdSetTexture,
+      CmdSetCubeTexture,
+      CmdSetVertexBuffer,
+      CmdSetVertexFormat,
+      CmdSetPrimitiveBuffer,
+      CmdSetWorldMatrix,
+      CmdSetViewMatrix,
+      CmdSetProjectionMatrix,
+      CmdDrawPrimitive,
+      CmdDrawIndexedPrimitive,
+      CmdCallback,
+
+      NumCommandTypes
+   };
+
+   /// Counts gathered during a replay.
+   struct ReplayStats
+   {
+      /// Number of commands that were replayed.
+      U32 mNumCommands;
+
+      /// Number of commands that were submitted to the device.
+      U32 mNumSubmitted;
+
+      /// Number of state changes that were dropped as redundant.
+      U32 mNumFiltered;
+
+      /// Number of draw calls submitted.
+      U32 mNumDrawCalls;
+
+      ReplayStats() { clear(); }
+
+      void clear();
+   };
+
+   GFXCommandBuffer();
+
+   /// @name Recording
+   /// These mirror the GFXDevice methods of the same name.
+   /// @{
+
+   void setShader( GFXShader *shader, bool force = false );
+   void setShaderConstBuffer( GFXShaderConstBuffer *buffer );
+   void setStateBlock( GFXStateBlock *block );
+   void setTexture( U32 stage, GFXTextureObject *texture );
+   void setCubeTexture( U32 stage, GFXCubemap *cubemap );
+   void setVertexBuffer( GFXVertexBuffer *buffer, U32 stream = 0, U32 frequency = 0 );
+   void setVertexFormat( const GFXVertexFormat *vertexFormat );
+   void setPrimitiveBuffer( GFXPrimitiveBuffer *buffer );
+   void setWorldMatrix( const MatrixF &mat );
+   void setViewMatrix( const MatrixF &mat );
+   void setProjectionMatrix( const MatrixF &mat );
+
+   void drawPrimitive( GFXPrimitiveType primType, U32 vertexStart, U32 primitiveCount );
+   void drawIndexedPrimitive( GFXPrimitiveType primType,
+                              U32 startVertex,
+                              U32 minIndex,
+                              U32 numVerts,
+                              U32 startIndex,
+                              U32 primitiveCount );
+   void drawPrimitive( const GFXPrimitive &prim );
+
+   /// Draws a primitive of the primitive buffer last set on this
+   /// command buffer.
+   void drawPrimitive( U32 primitiveIndex );
+
+   /// Adds a callback that runs on the device thread at this point of the
+   /// replay.  This is the way to do work that cannot be recorded, like
+   /// filling shader constants.  As the callback can change any device
+   /// state, no state changes are filtered against what came before it.
+   void addCallback( const Callback &callback );
+
+   /// @}
+
+   /// Removes all recorded commands.
+   void clear();
+
+   /// Returns true if there are no recorded commands.
+   bool isEmpty() const { return mCommands.empty(); }
+
+   /// Returns the number of recorded commands.
+   U32 getNumCommands() const { return mCommands.size(); }
+
+   /// Returns the number of recorded commands of the given type.
+   U32 getNumCommands( CommandType type ) const;
+
+   /// Submits the recorded commands to the device.  The commands stay
+   /// recorded so the buffer can be replayed again.
+   ///
+   /// @param device The device to submit to.  Must be called on the
+   ///   thread that owns it.
+   /// @param outStats If not NULL, the counts of this replay are
+   ///   added to it.
+   void replay( GFXDevice *device, ReplayStats *outStats = NULL ) const;
+
+   /// Replays the given buffers in order.  Redundant state changes are
+   /// also filtered across buffer boundaries.
+   static void replayAll( GFXDevice *device, const GFXCommandBuffer *const *buffers, U32 numBuffers, ReplayStats *outStats = NULL );
+
+protected:
+
+   struct Command
+   {
+      CommandType type;
+
+      /// The texture stage or vertex stream.
+      U32 slot;
+
+      /// The resource of a state change.
+      void *resource;
+
+      /// Additional arguments.  Draws keep their parameters here,
+      /// matrix and callback commands the index into the
+      /// respective list.
+      U32 args[ 6 ];
+   };
+
+   class ReplayState;
+
+   Vector< Command > mCommands;
+   Vector< MatrixF > mMatrices;
+   Vector< Callback > mCallbacks;
+
+   /// The primitive buffer last recorded for drawPrimitive( U32 ).
+   GFXPrimitiveBuffer *mLastPrimitiveBuffer;
+
+   /// The references keeping the recorded resources alive.
+   mutable Vector< StrongRefPtr< StrongRefBase > > mResourceRefs;
+
+   /// Resources recorded off the main thread which are
+   /// referenced on the next replay.
+   mutable Vector< StrongRefBase* > mPendingRefs;
+
+   Command& _addCommand( CommandType type, U32 slot = 0, void *resource = NULL );
+
+   /// Keeps the resource alive for as long as it is recorded.
+   void _holdResource( StrongRefBase *resource );
+
+   void _addMatrix( CommandType type, const MatrixF &mat );
+
+   void _replay( GFXDevice *device, ReplayState &state, ReplayStats &stats ) const;
+};
+
+#endif // _GFXCOMMANDBUFFER_H_
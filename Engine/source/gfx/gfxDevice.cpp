@@ -32,9 +32,12 @@
 #include "gfx/gfxPrimitiveBuffer.h"
 #include "gfx/gfxShader.h"
 #include "gfx/gfxStateBlock.h"
+#include "gfx/gfxShaderCache.h"
 #include "gfx/screenshot.h"
 #include "gfx/gfxStringEnumTranslate.h"
 #include "gfx/gfxTextureManager.h"
+#include "gfx/gfxTextureStreamer.h"
+#include "gfx/gfxTextureLoader.h"
 
 #include "core/frameAllocator.h"
 #include "core/stream/fileStream.h"
@@ -66,6 +69,15 @@ void GFXDevice::initConsole()
       "procedural shader folder.\n"
       "@ingroup GFX\n" );
 
+   Con::addVariable( "$shaders::binaryCache", TypeBool, &GFXShaderCache::smEnabled,
+      "Enables the persistent cache of compiled shader programs.\n"
+      "@ingroup GFX\n" );
+
+   Con::addVariable( "$shaders::binaryCachePath", TypeRealString, &GFXShaderCache::smPath,
+      "The folder compiled shader programs are cached in.  If empty the "
+      "binaries folder of $shaderGen::cachePath is used.\n"
+      "@ingroup GFX\n" );
+
    Con::addVariable( "$gfx::disableOcclusionQuery", TypeBool, &smDisableOcclusionQuery,
       "Debug helper that disables all hardware occlusion queries causing "
       "them to return only the visibile state.\n"
@@ -118,6 +130,7 @@ GFXDevice::GFXDevice()
    // Primitive buffer cache
    mPrimitiveBufferDirty = false;
    mTexturesDirty = false;
+   mTextureScreenSize = 0.0f;
    
    // Use of GFX_TEXTURE_STAGE_COUNT in initialization is okay [7/2/2007 Pat]
    for(U32 i = 0; i < GFX_TEXTURE_STAGE_COUNT; i++)
@@ -462,6 +475,7 @@ void GFXDevice::updateStates(bool forceSetAll /*=false*/)
       setStateBlockInternal(mNewStateBlock, false);
       mCurrentStateBlock = mNewStateBlock;
       mStateBlockDirty = false;
+      mDeviceStatistics.mStateBlockChanges++;
    }
 
    _updateRenderTargets();
@@ -677,6 +691,10 @@ void GFXDevice::setTexture( U32 stage, GFXTextureObject *texture )
 {
    AssertFatal(stage < getNumSamplers(), "GFXDevice::setTexture - out of range stage!");
 
+   // Report the use even if the texture is already set.
+   if ( GFXTextureStreamer::smEnabled && texture && texture->mIsStreamed )
+      mTextureManager->getStreamer()->requestScreenSize( texture, mTextureScreenSize );
+
    if (  mTexType[stage] == GFXTDT_Normal &&
          (  ( mTextureDirty[stage] && mNewTexture[stage].getPointer() == texture ) ||
             ( !mTextureDirty[stage] && mCurrentTexture[stage].getPointer() == texture ) ) )
@@ -790,6 +808,14 @@ inline bool GFXDevice::beginScene()
 
    mDeviceStatistics.clear();
 
+   // Upload the textures loaded in the background and apply
+   // the texture streaming feedback from the last frame.
+   if ( mTextureManager )
+   {
+      mTextureManager->getLoader()->update();
+      mTextureManager->getStreamer()->update();
+   }
+
    // Send the start of frame signal.
    getDeviceEventSignal().trigger( GFXDevice::deStartOfFrame );
    mFrameTime->reset();
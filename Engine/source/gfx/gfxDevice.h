@@ -510,6 +510,10 @@ protected:
    bool           mTextureDirty[GFX_TEXTURE_STAGE_COUNT];
    bool           mTexturesDirty;
 
+   /// The screen size passed to the texture streamer.
+   /// @see setTextureScreenSize
+   F32            mTextureScreenSize;
+
    // This maps a GFXStateBlockDesc hash value to a GFXStateBlockRef
    typedef Map<U32, GFXStateBlockRef> StateBlockMap;
    StateBlockMap mCurrentStateBlocks;
@@ -877,6 +881,12 @@ public:
 
    ///
    void setTexture(U32 stage, GFXTextureObject *texture);
+
+   /// Sets the size in pixels on screen of the object using the textures
+   /// set after this call.  It is passed to the texture streamer as usage
+   /// feedback.  Zero means the size is unknown.
+   /// @see GFXTextureStreamer::requestScreenSize
+   void setTextureScreenSize( F32 size ) { mTextureScreenSize = size; }
    void setCubeTexture( U32 stage, GFXCubemap *cubemap );
    void setCubeArrayTexture( U32 stage, GFXCubemapArray *cubemapArray);
    void setTextureArray( U32 stage, GFXTextureArray *textureArray);
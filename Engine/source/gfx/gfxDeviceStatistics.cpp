@@ -36,6 +36,9 @@ void GFXDeviceStatistics::setPrefix(const String& prefix)
    vnPolyCount = prefix + "polyCount";
    vnDrawCalls = prefix + "drawCalls";
    vnRenderTargetChanges = prefix + "renderTargetChanges";
+   vnStateBlockChanges = prefix + "stateBlockChanges";
+   vnShaderChanges = prefix + "shaderChanges";
+   vnShaderConstBufferUploads = prefix + "shaderConstBufferUploads";
 }
 
 /// Clear stats
@@ -44,6 +47,9 @@ void GFXDeviceStatistics::clear()
    mPolyCount = 0;
    mDrawCalls = 0;
    mRenderTargetChanges = 0;
+   mStateBlockChanges = 0;
+   mShaderChanges = 0;
+   mShaderConstBufferUploads = 0;
 }
 
 /// Copy from source (should just be a memcpy, but that may change later) used in 
@@ -54,6 +60,9 @@ void GFXDeviceStatistics::start(GFXDeviceStatistics * source)
    mPolyCount = source->mPolyCount;
    mDrawCalls = source->mDrawCalls;
    mRenderTargetChanges = source->mRenderTargetChanges;
+   mStateBlockChanges = source->mStateBlockChanges;
+   mShaderChanges = source->mShaderChanges;
+   mShaderConstBufferUploads = source->mShaderConstBufferUploads;
 }
 
 /// Used with start to get a subset of stats on a device.  Basically will do
@@ -63,6 +72,9 @@ void GFXDeviceStatistics::end(GFXDeviceStatistics * source)
    mPolyCount = source->mPolyCount - mPolyCount;
    mDrawCalls = source->mDrawCalls - mDrawCalls;
    mRenderTargetChanges = source->mRenderTargetChanges - mRenderTargetChanges;   
+   mStateBlockChanges = source->mStateBlockChanges - mStateBlockChanges;
+   mShaderChanges = source->mShaderChanges - mShaderChanges;
+   mShaderConstBufferUploads = source->mShaderConstBufferUploads - mShaderConstBufferUploads;
 }
 
 /// Exports the stats to the console
@@ -71,4 +83,7 @@ void GFXDeviceStatistics::exportToConsole()
    Con::setIntVariable(vnPolyCount, mPolyCount);
    Con::setIntVariable(vnDrawCalls, mDrawCalls);
    Con::setIntVariable(vnRenderTargetChanges, mRenderTargetChanges);
+   Con::setIntVariable(vnStateBlockChanges, mStateBlockChanges);
+   Con::setIntVariable(vnShaderChanges, mShaderChanges);
+   Con::setIntVariable(vnShaderConstBufferUploads, mShaderConstBufferUploads);
 }
\ No newline at end of file
@@ -34,6 +34,9 @@ public:
    S32 mPolyCount;
    S32 mDrawCalls;
    S32 mRenderTargetChanges;
+   S32 mStateBlockChanges;          ///< State blocks applied to the device.
+   S32 mShaderChanges;              ///< Shaders bound on the device.
+   S32 mShaderConstBufferUploads;   ///< Const buffers activated with changed constants, once per activation.
 
    GFXDeviceStatistics();
 
@@ -57,6 +60,9 @@ private:
    String vnPolyCount;
    String vnDrawCalls;
    String vnRenderTargetChanges;
+   String vnStateBlockChanges;
+   String vnShaderChanges;
+   String vnShaderConstBufferUploads;
 };
 
 #endif
\ No newline at end of file
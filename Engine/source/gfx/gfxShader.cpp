@@ -38,6 +38,7 @@ GFXShader::GFXShader()
       mReloadKey( 0 ),
       mInstancingFormat( NULL )
 {
+   VECTOR_SET_ASSOCIATION( mConstIdHandles );
 }
 
 GFXShader::~GFXShader()
@@ -126,6 +127,21 @@ void GFXShader::_updateDesc()
    GFXShaderMacro::stringize( mMacros, &mDescription );   
 }
 
+GFXShaderConstHandle* GFXShader::_cacheConstIdHandle( const GFXShaderConstId &id )
+{
+   const U32 index = id.getId();
+   if ( index >= mConstIdHandles.size() )
+   {
+      const U32 oldSize = mConstIdHandles.size();
+      mConstIdHandles.setSize( index + 1 );
+      dMemset( mConstIdHandles.address() + oldSize, 0, ( index + 1 - oldSize ) * sizeof( GFXShaderConstHandle* ) );
+   }
+
+   GFXShaderConstHandle *handle = getShaderConstHandle( id.getName() );
+   mConstIdHandles[index] = handle;
+   return handle;
+}
+
 void GFXShader::addGlobalMacro( const String &name, const String &value )
 {
    // Check to see if we already have this macro.
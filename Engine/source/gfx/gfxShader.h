@@ -26,6 +26,9 @@
 #ifndef _GFXRESOURCE_H_
 #include "gfx/gfxResource.h"
 #endif
+#ifndef _GFXSHADERCONSTID_H_
+#include "gfx/gfxShaderConstId.h"
+#endif
 #ifndef _TORQUE_STRING_H_
 #include "core/util/str.h"
 #endif
@@ -264,6 +267,10 @@ protected:
 
    GFXVertexFormat *mInstancingFormat;
 
+   /// The handles returned for each GFXShaderConstId indexed
+   /// by the id and filled in on first use.
+   Vector<GFXShaderConstHandle*> mConstIdHandles;
+
    /// A protected constructor so it cannot be instantiated.
    GFXShader();
 
@@ -332,6 +339,14 @@ public:
    /// if the constant doesn't exist at this time.
    virtual GFXShaderConstHandle* getShaderConstHandle( const String& name ) = 0; 
 
+   /// Returns a shader constant handle for an interned constant.
+   ///
+   /// The first call for an id goes thru the name lookup above, after
+   /// that the handle is returned directly from a table indexed by the
+   /// id.  This is safe because the handles live as long as the shader
+   /// and are only invalidated, not deleted, on reload.
+   inline GFXShaderConstHandle* getShaderConstHandle( const GFXShaderConstId &id );
+
    /// Returns a shader constant handle for the name constant, if the variable doesn't exist NULL is returned.
    virtual GFXShaderConstHandle* findShaderConstHandle( const String& name ) = 0;
 
@@ -375,8 +390,22 @@ protected:
 
    /// Called to update the description string after init.
    void _updateDesc();
+
+   /// Resolves and caches the handle for an id on a table miss.
+   GFXShaderConstHandle* _cacheConstIdHandle( const GFXShaderConstId &id );
 };
 
+inline GFXShaderConstHandle* GFXShader::getShaderConstHandle( const GFXShaderConstId &id )
+{
+   AssertFatal( id.isValid(), "GFXShader::getShaderConstHandle - Got an invalid constant id!" );
+
+   const U32 index = id.getId();
+   if ( index < mConstIdHandles.size() && mConstIdHandles[index] )
+      return mConstIdHandles[index];
+
+   return _cacheConstIdHandle( id );
+}
+
 /// A strong pointer to a reference counted GFXShader.
 typedef StrongRefPtr<GFXShader> GFXShaderRef;
 
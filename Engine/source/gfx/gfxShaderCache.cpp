@@ -0,0 +1,173 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "gfx/gfxShaderCache.h"
+
+#include "core/stream/fileStream.h"
+#include "core/util/fourcc.h"
+#include "core/util/hashFunction.h"
+#include "core/volume.h"
+#include "console/engineAPI.h"
+#include "platform/profiler.h"
+
+
+bool GFXShaderCache::smEnabled = true;
+String GFXShaderCache::smPath;
+U32 GFXShaderCache::smHits = 0;
+U32 GFXShaderCache::smMisses = 0;
+
+/// Identifies a cache file and its layout.
+static const U32 sCacheFileTag = MakeFourCC( 'T', 'S', 'B', 'C' );
+static const U32 sCacheFileVersion = 1;
+
+/// The size of the file header: tag, version, key, format, size and data hash.
+static const U32 sCacheHeaderSize = 4 + 4 + 8 + 4 + 4 + 8;
+
+
+U64 GFXShaderCache::hashKey( const void *data, U32 size, U64 key )
+{
+   return Torque::hash64( (const U8*)data, size, key );
+}
+
+String GFXShaderCache::_getFilePath( U64 key )
+{
+   String path = smPath;
+   if ( path.isEmpty() )
+   {
+      // Keep the binaries next to the generated source unless
+      // that only lives in memory.
+      path = Con::getVariable( "$shaderGen::cachePath" );
+      if ( path.isEmpty() || path.equal( "shadergen:" ) )
+         return String::EmptyString;
+
+      path += "/binaries";
+   }
+
+   return String::ToString( "%s/%08x%08x.tsb", path.c_str(), (U32)( key >> 32 ), (U32)key );
+}
+
+bool GFXShaderCache::isEnabled()
+{
+   return smEnabled && _getFilePath( 0 ).isNotEmpty();
+}
+
+bool GFXShaderCache::load( U64 key, U32 format, Vector<U8> &outData )
+{
+   PROFILE_SCOPE( GFXShaderCache_Load );
+
+   outData.clear();
+
+   if ( !smEnabled )
+      return false;
+
+   const String filePath = _getFilePath( key );
+   if ( filePath.isEmpty() || !Torque::FS::IsFile( filePath ) )
+   {
+      smMisses++;
+      return false;
+   }
+
+   FileStream stream;
+   if ( !stream.open( filePath, Torque::FS::File::Read ) )
+   {
+      smMisses++;
+      return false;
+   }
+
+   U32 tag = 0, version = 0, fileFormat = 0, size = 0;
+   U64 fileKey = 0, dataHash = 0;
+   stream.read( &tag );
+   stream.read( &version );
+   stream.read( &fileKey );
+   stream.read( &fileFormat );
+   stream.read( &size );
+   stream.read( &dataHash );
+
+   // A mismatch is just a stale entry which will
+   // get replaced once the program is compiled.
+   if (  tag != sCacheFileTag ||
+         version != sCacheFileVersion ||
+         fileKey != key ||
+         fileFormat != format ||
+         size == 0 ||
+         size != stream.getStreamSize() - sCacheHeaderSize )
+   {
+      smMisses++;
+      return false;
+   }
+
+   outData.setSize( size );
+   if (  !stream.read( size, outData.address() ) ||
+         hashKey( outData.address(), size, 0 ) != dataHash )
+   {
+      Con::warnf( "GFXShaderCache::load - Discarding corrupt cache file '%s'.", filePath.c_str() );
+      outData.clear();
+      smMisses++;
+      return false;
+   }
+
+   smHits++;
+   return true;
+}
+
+bool GFXShaderCache::save( U64 key, U32 format, const void *data, U32 size )
+{
+   PROFILE_SCOPE( GFXShaderCache_Save );
+
+   if ( !smEnabled || !data || size == 0 )
+      return false;
+
+   const String filePath = _getFilePath( key );
+   if ( filePath.isEmpty() || !Torque::FS::CreatePath( filePath ) )
+      return false;
+
+   FileStream stream;
+   if ( !stream.open( filePath, Torque::FS::File::Write ) )
+   {
+      Con::warnf( "GFXShaderCache::save - Failed to write cache file '%s'.", filePath.c_str() );
+      return false;
+   }
+
+   stream.write( sCacheFileTag );
+   stream.write( sCacheFileVersion );
+   stream.write( key );
+   stream.write( format );
+   stream.write( size );
+   stream.write( hashKey( data, size, 0 ) );
+   return stream.write( size, data );
+}
+
+void GFXShaderCache::remove( U64 key )
+{
+   const String filePath = _getFilePath( key );
+   if ( filePath.isNotEmpty() && Torque::FS::IsFile( filePath ) )
+      Torque::FS::Remove( filePath );
+}
+
+DefineEngineFunction( getShaderCacheStats, String, (),,
+   "Returns the number of shader programs loaded from and missing from "
+   "the persistent shader cache as \"hits misses\".\n"
+   "@ingroup GFX\n" )
+{
+   return String::ToString( "%u %u", GFXShaderCache::getHitCount(), GFXShaderCache::getMissCount() );
+}
@@ -0,0 +1,99 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _GFXSHADERCACHE_H_
+#define _GFXSHADERCACHE_H_
+
+#ifndef _TVECTOR_H_
+#include "core/util/tVector.h"
+#endif
+#ifndef _TORQUE_STRING_H_
+#include "core/util/str.h"
+#endif
+
+
+/// A persistent on disk cache of compiled shader programs.
+///
+/// Entries are keyed by a 64bit hash which the device builds from
+/// everything that affects the compiled output: the fully expanded
+/// source, the macros, the compile target and the driver.  Each entry
+/// is stored in its own file under the cache path along with its key,
+/// a device specific format tag and a hash of the data, so a stale or
+/// truncated file is simply treated as a miss and overwritten.
+///
+/// The cache is written to the "binaries" folder of $shaderGen::cachePath
+/// unless $shaders::binaryCachePath is set.  It is disabled when the
+/// procedural shaders are only kept in memory.
+class GFXShaderCache
+{
+public:
+
+   /// Enables the cache.
+   /// Exposed to script via $shaders::binaryCache.
+   static bool smEnabled;
+
+   /// The folder the cached programs are written to.
+   /// Exposed to script via $shaders::binaryCachePath.
+   static String smPath;
+
+   /// Combines a block of data into a cache key.
+   static U64 hashKey( const void *data, U32 size, U64 key );
+
+   /// Combines a string into a cache key.
+   static U64 hashKey( const String &str, U64 key ) { return hashKey( str.c_str(), str.length(), key ); }
+
+   /// Returns true if the cache is enabled and has somewhere to write.
+   static bool isEnabled();
+
+   /// Reads a cached program.
+   ///
+   /// @param key       The key the program was saved under.
+   /// @param format    The device specific format of the data.
+   /// @param outData   Filled with the program data.
+   /// @return Returns false if there is no valid entry.
+   static bool load( U64 key, U32 format, Vector<U8> &outData );
+
+   /// Writes a program to the cache replacing any existing entry.
+   static bool save( U64 key, U32 format, const void *data, U32 size );
+
+   /// Deletes the cached file for the key.
+   static void remove( U64 key );
+
+   /// @name Statistics
+   /// @{
+
+   static U32 getHitCount() { return smHits; }
+   static U32 getMissCount() { return smMisses; }
+   static void resetStats() { smHits = smMisses = 0; }
+
+   /// @}
+
+protected:
+
+   static U32 smHits;
+   static U32 smMisses;
+
+   /// Returns the file the entry for the key is stored in.
+   static String _getFilePath( U64 key );
+};
+
+#endif // _GFXSHADERCACHE_H_
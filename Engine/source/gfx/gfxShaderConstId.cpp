@@ -0,0 +1,83 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "gfx/gfxShaderConstId.h"
+
+#include "core/util/tDictionary.h"
+#include "core/util/tVector.h"
+#include "platform/threads/mutex.h"
+
+
+namespace
+{
+   /// The names are interned from static initializers and
+   /// from worker threads, so the registry is created on
+   /// first use and guarded by a mutex.
+   struct ConstIdRegistry
+   {
+      Map<String,U32> ids;
+      Vector<String> names;
+      Mutex mutex;
+   };
+
+   ConstIdRegistry& _getRegistry()
+   {
+      static ConstIdRegistry sRegistry;
+      return sRegistry;
+   }
+}
+
+U32 GFXShaderConstId::intern( const String &name )
+{
+   ConstIdRegistry &registry = _getRegistry();
+   MutexHandle mh;
+   mh.lock( &registry.mutex, true );
+
+   Map<String,U32>::Iterator iter = registry.ids.find( name );
+   if ( iter != registry.ids.end() )
+      return iter->value;
+
+   const U32 id = registry.names.size();
+   registry.names.push_back( name );
+   registry.ids.insert( name, id );
+   return id;
+}
+
+String GFXShaderConstId::getName() const
+{
+   if ( !isValid() )
+      return String::EmptyString;
+
+   ConstIdRegistry &registry = _getRegistry();
+   MutexHandle mh;
+   mh.lock( &registry.mutex, true );
+   return registry.names[mId];
+}
+
+U32 GFXShaderConstId::getCount()
+{
+   ConstIdRegistry &registry = _getRegistry();
+   MutexHandle mh;
+   mh.lock( &registry.mutex, true );
+   return registry.names.size();
+}
@@ -0,0 +1,78 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _GFXSHADERCONSTID_H_
+#define _GFXSHADERCONSTID_H_
+
+#ifndef _TORQUE_STRING_H_
+#include "core/util/str.h"
+#endif
+
+
+/// An interned shader constant name.
+///
+/// Each distinct name is assigned a small dense id the first time it
+/// is seen.  GFXShader uses the id to index a per-shader table of
+/// handles, so code which resolves the same constants on many shaders
+/// skips the string hash and compare of the name lookup.
+///
+/// Declare these once, usually as statics, and pass them to
+/// GFXShader::getShaderConstHandle().
+///
+/// @see ShaderGenVars
+class GFXShaderConstId
+{
+public:
+
+   /// The id of a default constructed constant.
+   static const U32 InvalidId = U32_MAX;
+
+   GFXShaderConstId() : mId( InvalidId ) {}
+
+   /// Interns the name.
+   explicit GFXShaderConstId( const String &name ) : mId( intern( name ) ) {}
+
+   /// Returns the dense id of the name.
+   U32 getId() const { return mId; }
+
+   /// Returns true if this refers to a name.
+   bool isValid() const { return mId != InvalidId; }
+
+   /// Returns the interned name.
+   String getName() const;
+
+   bool operator ==( const GFXShaderConstId &id ) const { return mId == id.mId; }
+   bool operator !=( const GFXShaderConstId &id ) const { return mId != id.mId; }
+
+   /// Returns the id for the name, assigning a new one if
+   /// this is the first time the name has been seen.
+   static U32 intern( const String &name );
+
+   /// Returns the number of names interned so far.
+   static U32 getCount();
+
+protected:
+
+   U32 mId;
+};
+
+#endif // _GFXSHADERCONSTID_H_
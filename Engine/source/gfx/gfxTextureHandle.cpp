@@ -75,6 +75,21 @@ bool GFXTexHandle::set( const String &texName, GFXTextureProfile *profile, const
    return isValid();
 }
 
+bool GFXTexHandle::setAsync( const String &texName, GFXTextureProfile *profile, const String &desc )
+{
+   free();
+
+   AssertFatal( texName.isNotEmpty(), "Texture name is empty" );
+   StrongObjectRef::set( TEXMGR->createTextureAsync( texName, profile ) );
+
+   #ifdef TORQUE_DEBUG
+      if ( getPointer() )
+         getPointer()->mDebugDescription = desc;
+   #endif
+
+   return isValid();
+}
+
 bool GFXTexHandle::set(const String &texNameR, const String &texNameG, const String &texNameB, const String &texNameA, U32 inputKey[4], GFXTextureProfile *profile, const String &desc)
 {
    // Clear the existing texture first, so that
@@ -0,0 +1,101 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "gfx/gfxTextureLoadQueue.h"
+
+#include "gfx/bitmap/gBitmap.h"
+#include "gfx/bitmap/ddsFile.h"
+#include "core/util/path.h"
+#include "platform/threads/threadPool.h"
+
+
+static const String sDDSExt( "dds" );
+
+
+/// Reads and decodes a texture file on the thread pool.
+class GFXTextureLoadQueue::LoadItem : public ThreadPool::WorkItem
+{
+public:
+
+   LoadItem( GFXTextureLoadQueue *queue, GFXTextureObject *texture, U32 serial, const String &path, U32 dropMips, bool noMip )
+      : mQueue( queue ),
+        mPath( path ),
+        mNoMip( noMip )
+   {
+      mResult.texture = texture;
+      mResult.serial = serial;
+      mResult.dropMips = dropMips;
+      mResult.dds = NULL;
+      mResult.bitmap = NULL;
+   }
+
+protected:
+
+   ThreadSafeRef< GFXTextureLoadQueue > mQueue;
+   Torque::Path mPath;
+   bool mNoMip;
+   Result mResult;
+
+   virtual void execute()
+   {
+      // A NULL result is still returned so that the
+      // owner knows the read is no longer pending.
+      if ( sDDSExt.equal( mPath.getExtension(), String::NoCase ) )
+         mResult.dds = DDSFile::readFile( mPath, mResult.dropMips );
+      else
+      {
+         mResult.bitmap = GBitmap::readFile( mPath );
+
+         // Build the mips here so that the upload doesn't have to.
+         GBitmap *bmp = mResult.bitmap;
+         if (  bmp &&
+               !mNoMip &&
+               bmp->getNumMipLevels() == 1 &&
+               bmp->getFormat() != GFXFormatA8 &&
+               isPow2( bmp->getWidth() ) &&
+               isPow2( bmp->getHeight() ) )
+            bmp->extrudeMipLevels();
+      }
+
+      mQueue->mResults.pushBack( mResult );
+   }
+};
+
+
+GFXTextureLoadQueue::~GFXTextureLoadQueue()
+{
+   Result result;
+   while ( mResults.tryPopFront( result ) )
+      freeResult( result );
+}
+
+void GFXTextureLoadQueue::queueLoad( GFXTextureObject *texture, U32 serial, const String &path, U32 dropMips, bool noMip )
+{
+   ThreadPool::GLOBAL().queueWorkItem( new LoadItem( this, texture, serial, path, dropMips, noMip ) );
+}
+
+void GFXTextureLoadQueue::freeResult( const Result &result )
+{
+   delete result.dds;
+   delete result.bitmap;
+}
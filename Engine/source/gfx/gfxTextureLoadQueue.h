@@ -0,0 +1,86 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _GFXTEXTURELOADQUEUE_H_
+#define _GFXTEXTURELOADQUEUE_H_
+
+#ifndef _TORQUE_STRING_H_
+#include "core/util/str.h"
+#endif
+#ifndef _THREADSAFEREFCOUNT_H_
+#include "platform/threads/threadSafeRefCount.h"
+#endif
+#ifndef _THREADSAFEDEQUE_H_
+#include "platform/threads/threadSafeDeque.h"
+#endif
+
+class GFXTextureObject;
+class GBitmap;
+struct DDSFile;
+
+
+/// Reads texture files on the thread pool for the GFXTextureLoader
+/// and the GFXTextureStreamer and holds the results until the owner
+/// picks them up on the main thread.
+///
+/// The queue is shared with the work items so that either the
+/// owner or the items still in flight can go away first.
+class GFXTextureLoadQueue : public ThreadSafeRefCount< GFXTextureLoadQueue >
+{
+public:
+
+   struct Result
+   {
+      GFXTextureObject *texture;
+
+      /// The owner's id for the request, used to match the result to
+      /// the texture in case it was deleted while the read was in flight.
+      U32 serial;
+
+      U32 dropMips;
+
+      /// The data read or NULL if the read failed.
+      DDSFile *dds;
+      GBitmap *bitmap;
+   };
+
+   ~GFXTextureLoadQueue();
+
+   /// Reads the file on the thread pool.  A DDS is read without
+   /// its top @a dropMips mips, any other bitmap gets its mips
+   /// built unless @a noMip is set.
+   void queueLoad( GFXTextureObject *texture, U32 serial, const String &path, U32 dropMips, bool noMip );
+
+   /// Takes the next finished read, returns false if there is none.
+   bool popResult( Result &result ) { return mResults.tryPopFront( result ); }
+
+   /// Deletes the data read.
+   static void freeResult( const Result &result );
+
+protected:
+
+   class LoadItem;
+
+   ThreadSafeDeque< Result > mResults;
+};
+
+#endif // _GFXTEXTURELOADQUEUE_H_
@@ -0,0 +1,170 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "gfx/gfxTextureLoader.h"
+
+#include "gfx/gfxDevice.h"
+#include "gfx/gfxTextureManager.h"
+#include "gfx/gfxTextureObject.h"
+#include "core/volume.h"
+#include "console/engineAPI.h"
+
+
+bool GFXTextureLoader::smEnabled = true;
+U32 GFXTextureLoader::smMaxUploadsPerFrame = 4;
+
+GFXTextureLoader::GFXTextureLoader( GFXTextureManager *manager )
+   :  mManager( manager ),
+      mLoadQueue( new GFXTextureLoadQueue ),
+      mNextSerial( 0 )
+{
+}
+
+GFXTextureLoader::~GFXTextureLoader()
+{
+}
+
+void GFXTextureLoader::add( GFXTextureObject *texture, const String &path, U32 dropMips )
+{
+   AssertFatal( texture, "GFXTextureLoader::add - Got a NULL texture!" );
+   AssertFatal( !isLoading( texture ), "GFXTextureLoader::add - The texture is already loading!" );
+
+   Entry entry;
+   entry.serial = mNextSerial++;
+   entry.path = path;
+
+   mEntries.insertUnique( texture, entry );
+
+   _requestLoad( texture, entry, dropMips );
+}
+
+void GFXTextureLoader::remove( GFXTextureObject *texture )
+{
+   // Any load in flight is discarded when it
+   // fails to find a matching entry.
+   mEntries.erase( texture );
+}
+
+bool GFXTextureLoader::isLoading( GFXTextureObject *texture ) const
+{
+   return mEntries.find( texture ) != mEntries.end();
+}
+
+void GFXTextureLoader::update()
+{
+   PROFILE_SCOPE( GFXTextureLoader_Update );
+
+   // We can't touch textures while the device is lost.
+   if ( mManager->mTextureManagerState != GFXTextureManager::Living )
+      return;
+
+   LoadResult result;
+   for ( U32 i = 0; i < smMaxUploadsPerFrame && mLoadQueue->popResult( result ); )
+   {
+      // Discarded loads don't count towards the uploads.
+      EntryMap::Iterator iter = mEntries.find( result.texture );
+      if ( iter != mEntries.end() && iter->value.serial == result.serial )
+         i++;
+
+      _onLoaded( result );
+   }
+}
+
+void GFXTextureLoader::wait( GFXTextureObject *texture )
+{
+   if ( !isLoading( texture ) )
+      return;
+
+   PROFILE_SCOPE( GFXTextureLoader_Wait );
+
+   while ( isLoading( texture ) )
+      _waitForLoad();
+}
+
+void GFXTextureLoader::flush()
+{
+   PROFILE_SCOPE( GFXTextureLoader_Flush );
+
+   while ( !mEntries.isEmpty() )
+      _waitForLoad();
+}
+
+void GFXTextureLoader::_waitForLoad()
+{
+   LoadResult result;
+   if ( mLoadQueue->popResult( result ) )
+      _onLoaded( result );
+   else
+      Platform::sleep( 1 );
+}
+
+void GFXTextureLoader::_requestLoad( GFXTextureObject *texture, const Entry &entry, U32 dropMips )
+{
+   mLoadQueue->queueLoad( texture, entry.serial, entry.path, dropMips, texture->mProfile->noMip() );
+}
+
+void GFXTextureLoader::_onLoaded( const LoadResult &result )
+{
+   PROFILE_SCOPE( GFXTextureLoader_OnLoaded );
+
+   EntryMap::Iterator iter = mEntries.find( result.texture );
+   if ( iter == mEntries.end() || iter->value.serial != result.serial )
+   {
+      // The texture was deleted or reloaded.
+      GFXTextureLoadQueue::freeResult( result );
+      return;
+   }
+
+   const Torque::Path path( iter->value.path );
+   mEntries.erase( iter );
+
+   GFXTextureObject *texture = result.texture;
+   GFXTextureObject *loaded = NULL;
+
+   if ( result.dds )
+      loaded = mManager->_createTexture( result.dds, texture->mProfile, false, texture );
+   else if ( result.bitmap )
+      loaded = mManager->_createTexture( result.bitmap, texture->mTextureLookupName, texture->mProfile, false, texture );
+
+   GFXTextureLoadQueue::freeResult( result );
+
+   if ( !loaded )
+   {
+      // Leave the placeholder so the material still renders.
+      Con::errorf( "GFXTextureLoader - Failed to load '%s'!", path.getFullPath().c_str() );
+      return;
+   }
+
+   // Now that the texture holds the file's data we can
+   // watch it for changes like any other file texture.
+   texture->mPath = path;
+   Torque::FS::AddChangeNotification( path, mManager, &GFXTextureManager::_onFileChanged );
+}
+
+DefineEngineFunction( flushTextureLoads, void, (),,
+   "Blocks until all textures being loaded in the background are ready.\n"
+   "@ingroup GFX\n" )
+{
+   if ( GFXDevice::get() )
+      TEXMGR->getLoader()->flush();
+}
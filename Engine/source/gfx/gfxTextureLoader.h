@@ -0,0 +1,125 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _GFXTEXTURELOADER_H_
+#define _GFXTEXTURELOADER_H_
+
+#ifndef _TDICTIONARY_H_
+#include "core/util/tDictionary.h"
+#endif
+#ifndef _TORQUE_STRING_H_
+#include "core/util/str.h"
+#endif
+#ifndef _GFXTEXTURELOADQUEUE_H_
+#include "gfx/gfxTextureLoadQueue.h"
+#endif
+
+class GFXTextureManager;
+class GFXTextureObject;
+class GFXTextureProfile;
+
+
+/// Loads texture files on the thread pool.
+///
+/// A texture loaded asynchronously is returned right away as a tiny
+/// placeholder which is registered under the file's name, so further
+/// requests for the same file share it.  The file is decoded and its
+/// mips are built by a worker thread.  On update() the finished data
+/// is uploaded into the placeholder in place, so any handles, materials
+/// or state already pointing at it pick up the real texture.
+///
+/// @see GFXTextureManager::createTextureAsync()
+class GFXTextureLoader
+{
+public:
+
+   /// Enables asynchronous loading.
+   /// Exposed to script via $pref::Video::asyncTextureLoading.
+   static bool smEnabled;
+
+   /// The maximum number of finished textures uploaded in one
+   /// update so that a burst of loads is spread over frames.
+   static U32 smMaxUploadsPerFrame;
+
+   GFXTextureLoader( GFXTextureManager *manager );
+   virtual ~GFXTextureLoader();
+
+   /// Starts loading a resolved texture file into the placeholder.
+   ///
+   /// @param texture      The placeholder texture.
+   /// @param path         The DDS or bitmap file to load.
+   /// @param dropMips     The number of top mips to skip when reading a DDS.
+   void add( GFXTextureObject *texture, const String &path, U32 dropMips );
+
+   /// Forgets the texture, discarding its load if it is still in flight.
+   void remove( GFXTextureObject *texture );
+
+   /// Returns true if the texture is still waiting for its data.
+   bool isLoading( GFXTextureObject *texture ) const;
+
+   /// Uploads finished loads into their textures.
+   /// Called once per frame from GFXDevice::beginScene().
+   void update();
+
+   /// Blocks until the texture's load has been uploaded.
+   void wait( GFXTextureObject *texture );
+
+   /// Blocks until all loads in flight have been uploaded.
+   void flush();
+
+   U32 getPendingLoads() const { return mEntries.size(); }
+
+protected:
+
+   struct Entry
+   {
+      /// Unique id used to match loads to the texture
+      /// in case it is deleted while the load is in flight.
+      U32 serial;
+
+      String path;
+   };
+
+   typedef GFXTextureLoadQueue::Result LoadResult;
+
+   GFXTextureManager *mManager;
+
+   typedef HashTable<GFXTextureObject*,Entry> EntryMap;
+   EntryMap mEntries;
+
+   ThreadSafeRef<GFXTextureLoadQueue> mLoadQueue;
+
+   U32 mNextSerial;
+
+   /// Starts reading the file for the texture.  By default this
+   /// decodes it on the thread pool and returns the result to update().
+   virtual void _requestLoad( GFXTextureObject *texture, const Entry &entry, U32 dropMips );
+
+   /// Uploads the next finished load or sleeps if there isn't one.
+   void _waitForLoad();
+
+   /// Uploads the loaded data into the texture.  This takes
+   /// ownership of the data and must be called on the main thread.
+   void _onLoaded( const LoadResult &result );
+};
+
+#endif // _GFXTEXTURELOADER_H_
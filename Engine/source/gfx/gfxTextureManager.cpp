@@ -26,11 +26,14 @@
 #include "gfx/gfxDevice.h"
 #include "gfx/gfxCardProfile.h"
 #include "gfx/gfxStringEnumTranslate.h"
+#include "gfx/gfxTextureStreamer.h"
+#include "gfx/gfxTextureLoader.h"
 #include "gfx/bitmap/imageUtils.h"
 #include "core/strings/stringFunctions.h"
 #include "core/util/safeDelete.h"
 #include "core/resourceManager.h"
 #include "core/volume.h"
+#include "core/stream/fileStream.h"
 #include "core/util/dxt5nmSwizzle.h"
 #include "console/consoleTypes.h"
 #include "console/engineAPI.h"
@@ -62,6 +65,26 @@ void GFXTextureManager::init()
       "as not allowing down scaling.\n"
       "@ingroup GFX\n" );
 
+   Con::addVariable( "$pref::Video::textureStreaming", TypeBool, &GFXTextureStreamer::smEnabled,
+      "If true DDS textures are created with their smallest mips and the larger "
+      "mips are streamed in as they are needed on screen.\n"
+      "@ingroup GFX\n" );
+
+   Con::addVariable( "$pref::Video::textureStreamingBudget", TypeS32, &GFXTextureStreamer::smBudgetMB,
+      "The video memory budget in megabytes for streamed textures.  The least "
+      "recently used textures lose mips to stay under it.  Zero disables the budget.\n"
+      "@ingroup GFX\n" );
+
+   Con::addVariable( "$pref::Video::textureStreamingStartSize", TypeS32, &GFXTextureStreamer::smStartSize,
+      "Streamed textures are created with their mips dropped until they are no "
+      "larger than this size.\n"
+      "@ingroup GFX\n" );
+
+   Con::addVariable( "$pref::Video::asyncTextureLoading", TypeBool, &GFXTextureLoader::smEnabled,
+      "If true material textures are read and have their mips built on the thread "
+      "pool, with a placeholder texture used until they are ready.\n"
+      "@ingroup GFX\n" );
+
    Con::addVariable( "$pref::Video::missingTexturePath", TypeRealString, &smMissingTexturePath,
       "The file path of the texture to display when the requested texture is missing.\n"
       "@ingroup GFX\n" );
@@ -92,6 +115,8 @@ GFXTextureManager::GFXTextureManager()
 {
    mListHead = mListTail = NULL;
    mTextureManagerState = GFXTextureManager::Living;
+   mStreamer = new GFXTextureStreamer( this );
+   mLoader = new GFXTextureLoader( this );
 
    // Set up the hash table
    mHashCount = 1023;
@@ -105,6 +130,9 @@ GFXTextureManager::~GFXTextureManager()
    if( mHashTable )
       SAFE_DELETE_ARRAY( mHashTable );
 
+   SAFE_DELETE( mStreamer );
+   SAFE_DELETE( mLoader );
+
    mCubemapTable.clear();
 }
 
@@ -335,7 +363,8 @@ GFXTextureObject *GFXTextureManager::_createTexture(  GBitmap *bmp,
       // We downscale the bitmap on the CPU... this is the reason
       // you should be using DDS which already has good looking mips.
       GBitmap *padBmp = bmp;
-      padBmp->extrudeMipLevels();
+      if ( padBmp->getNumMipLevels() == 1 )
+         padBmp->extrudeMipLevels();
       scalePower = getMin( scalePower, padBmp->getNumMipLevels() - 1 );
 
       realWidth  = getMax( (U32)1, padBmp->getWidth() >> scalePower );
@@ -657,7 +686,12 @@ GFXTextureObject *GFXTextureManager::createTexture( const Torque::Path &path, GF
 
    GFXTextureObject *retTexObj = _lookupTexture( pathNoExt, profile );
    if( retTexObj )
+   {
+      // The caller expects the file's data so don't
+      // hand back a placeholder still loading.
+      mLoader->wait( retTexObj );
       return retTexObj;
+   }
 
    const U32 scalePower = getTextureDownscalePower( profile );
 
@@ -668,11 +702,21 @@ GFXTextureObject *GFXTextureManager::createTexture( const Torque::Path &path, GF
       // Check for DDS
       if( sDDSExt.equal(correctPath.getExtension(), String::NoCase ) )
       {
-         dds = DDSFile::load( correctPath, scalePower );
-         if( dds != NULL )
+         if ( GFXTextureStreamer::smEnabled && GFXTextureStreamer::canStream( profile ) )
          {
-            realPath = dds.getPath();
-            retTexObj = createTexture( dds, profile, false );
+            retTexObj = _createStreamedTexture( correctPath, profile );
+            if ( retTexObj )
+               realPath = correctPath;
+         }
+
+         if ( !retTexObj )
+         {
+            dds = DDSFile::load( correctPath, scalePower );
+            if( dds != NULL )
+            {
+               realPath = dds.getPath();
+               retTexObj = createTexture( dds, profile, false );
+            }
          }
       }
       else // Let GBitmap take care of it
@@ -700,11 +744,21 @@ GFXTextureObject *GFXTextureManager::createTexture( const Torque::Path &path, GF
 
       if( Torque::FS::IsFile( tryDDSPath ) )
       {
-         dds = DDSFile::load( tryDDSPath, scalePower );
-         if( dds != NULL )
+         if ( GFXTextureStreamer::smEnabled && GFXTextureStreamer::canStream( profile ) )
          {
-            realPath = dds.getPath();
-            retTexObj = createTexture( dds, profile, false );
+            retTexObj = _createStreamedTexture( tryDDSPath, profile );
+            if ( retTexObj )
+               realPath = tryDDSPath;
+         }
+
+         if ( !retTexObj )
+         {
+            dds = DDSFile::load( tryDDSPath, scalePower );
+            if( dds != NULL )
+            {
+               realPath = dds.getPath();
+               retTexObj = createTexture( dds, profile, false );
+            }
          }
       }
       
@@ -740,6 +794,110 @@ GFXTextureObject *GFXTextureManager::createTexture( const Torque::Path &path, GF
    return retTexObj;
 }
 
+GFXTextureObject *GFXTextureManager::createTextureAsync( const Torque::Path &path, GFXTextureProfile *profile )
+{
+   PROFILE_SCOPE( GFXTextureManager_createTextureAsync );
+
+   if ( !GFXTextureLoader::smEnabled )
+      return createTexture( path, profile );
+
+   Torque::Path correctPath = validatePath(path);
+
+   String pathNoExt = Torque::Path::Join( correctPath.getRoot(), ':', correctPath.getPath() );
+   pathNoExt = Torque::Path::Join( pathNoExt, '/', correctPath.getFileName() );
+
+   GFXTextureObject *retTexObj = _lookupTexture( pathNoExt, profile );
+   if( retTexObj )
+      return retTexObj;
+
+   // Find the file the same way createTexture() does, but 
+   // leave the search up the folder tree to it.
+   Torque::Path realPath;
+   if( Torque::FS::IsFile( correctPath ) )
+      realPath = correctPath;
+   else
+   {
+      Torque::Path tryDDSPath = pathNoExt;
+      if( tryDDSPath.getExtension().isNotEmpty() )
+         tryDDSPath.setFileName( tryDDSPath.getFullFileName() );
+      tryDDSPath.setExtension( sDDSExt );
+
+      if( Torque::FS::IsFile( tryDDSPath ) )
+         realPath = tryDDSPath;
+      else if( !GBitmap::sFindFile( correctPath, &realPath ) )
+         return createTexture( path, profile );
+   }
+
+   const bool isDDS = sDDSExt.equal( realPath.getExtension(), String::NoCase );
+
+   // Streamed textures only load their small mips up front.
+   if ( isDDS && GFXTextureStreamer::smEnabled && GFXTextureStreamer::canStream( profile ) )
+      return createTexture( path, profile );
+
+   retTexObj = _createPlaceholderTexture( pathNoExt, profile );
+   if ( !retTexObj )
+      return createTexture( path, profile );
+
+   mLoader->add( retTexObj, realPath.getFullPath(), isDDS ? getTextureDownscalePower( profile ) : 0 );
+
+   return retTexObj;
+}
+
+GFXTextureObject* GFXTextureManager::_createPlaceholderTexture( const String &resourceName, GFXTextureProfile *profile )
+{
+   // A flat normal for normal maps and mid gray for
+   // everything else looks the least out of place.
+   GBitmap bmp( 1, 1, false, GFXFormatR8G8B8A8 );
+   if ( profile->getType() == GFXTextureProfile::NormalMap )
+      bmp.fill( ColorI( 128, 128, 255, 255 ) );
+   else
+      bmp.fill( ColorI( 128, 128, 128, 255 ) );
+
+   return _createTexture( &bmp, resourceName, profile, false, NULL );
+}
+
+GFXTextureObject* GFXTextureManager::_createStreamedTexture( const Torque::Path &path, GFXTextureProfile *profile )
+{
+   PROFILE_SCOPE( GFXTextureManager_CreateStreamedTexture );
+
+   // Read just the header to figure out how
+   // many mips we should start out with.
+   DDSFile header;
+   {
+      FileStream stream;
+      stream.open( path.getFullPath(), Torque::FS::File::Read );
+      if ( stream.getStatus() != Stream::Ok || !header.readHeader( stream ) )
+         return NULL;
+   }
+
+   // Cubemaps, volumes, and textures without
+   // a mip chain are loaded normally.
+   if (  header.isCubemap() || 
+         header.mFlags.test( DDSFile::VolumeFlag ) ||
+         header.getMipLevels() <= 1 )
+      return NULL;
+
+   const U32 maxDrop = header.getMipLevels() - 1;
+   const U32 minDrop = getMin( getTextureDownscalePower( profile ), maxDrop );
+
+   U32 startDrop = minDrop;
+   while (  startDrop < maxDrop && 
+            getMax( header.getWidth( startDrop ), header.getHeight( startDrop ) ) > U32( getMax( GFXTextureStreamer::smStartSize, 1 ) ) )
+      startDrop++;
+
+   DDSFile *dds = DDSFile::readFile( path, startDrop );
+   if ( !dds )
+      return NULL;
+
+   GFXTextureObject *texture = createTexture( dds, profile, false );
+   delete dds;
+
+   if ( texture && !mStreamer->isStreamed( texture ) )
+      mStreamer->add( texture, path.getFullPath(), startDrop, minDrop );
+
+   return texture;
+}
+
 GFXTextureObject *GFXTextureManager::createTexture(  U32 width, U32 height, void *pixels, GFXFormat format, GFXTextureProfile *profile )
 {
    // For now, stuff everything into a GBitmap and pass it off... This may need to be revisited -- BJG
@@ -1398,6 +1556,8 @@ void GFXTextureManager::deleteTexture( GFXTextureObject *texture )
       mListTail = texture->mPrev;
 
    hashRemove( texture );
+   mStreamer->remove( texture );
+   mLoader->remove( texture );
 
    // If we have a path for the texture then
    // remove change notifications for it.
@@ -1561,6 +1721,10 @@ void GFXTextureManager::_onFileChanged( const Torque::Path &path )
 
    Con::errorf( "[GFXTextureManager::_onFileChanged] : File changed [%s]", path.getFullPath().c_str() );
 
+   // The file may have changed size, so stop streaming
+   // it and just load the whole thing.
+   mStreamer->remove( obj );
+
    const U32 scalePower = getTextureDownscalePower( obj->mProfile );
 
    if ( sDDSExt.equal( path.getExtension(), String::NoCase) )
@@ -1586,6 +1750,8 @@ void GFXTextureManager::reloadTextures()
       const Torque::Path path( tex->mPath );
       if ( !path.isEmpty() )
       {
+         mStreamer->remove( tex );
+
          const U32 scalePower = getTextureDownscalePower( tex->mProfile );
 
          if ( sDDSExt.equal( path.getExtension(), String::NoCase ) )
@@ -50,6 +50,8 @@ namespace Torque
 }
 
 class GFXCubemap;
+class GFXTextureStreamer;
+class GFXTextureLoader;
 
 
 class GFXTextureManager 
@@ -111,6 +113,17 @@ public:
    virtual GFXTextureObject *createTexture(  const Torque::Path &path,
       GFXTextureProfile *profile );
 
+   /// Like createTexture() from a path, but returns a placeholder right
+   /// away and reads the file on the thread pool.  The placeholder is
+   /// filled in place when the load finishes.
+   ///
+   /// Falls back to a normal load if async loading is disabled or the
+   /// file needs to be searched for or streamed.
+   ///
+   /// @see GFXTextureLoader
+   GFXTextureObject *createTextureAsync(  const Torque::Path &path,
+      GFXTextureProfile *profile );
+
    virtual GFXTextureObject *createTexture(  U32 width,
       U32 height,
       void *pixels,
@@ -195,6 +208,12 @@ public:
    /// Used to remove a cubemap from the cache.
    void releaseCubemap( GFXCubemap *cubemap );
 
+   /// Returns the texture streamer.
+   GFXTextureStreamer* getStreamer() const { return mStreamer; }
+
+   /// Returns the async texture loader.
+   GFXTextureLoader* getLoader() const { return mLoader; }
+
 public:
    /// The amount of texture mipmaps to skip when loading a
    /// texture that allows downscaling.
@@ -221,6 +240,15 @@ protected:
    static String smDefaultPrefilterCubemapPath;
    static String smBRDFTexturePath;
 
+   friend class GFXTextureStreamer;
+   friend class GFXTextureLoader;
+
+   /// Streams the mips of DDS textures.
+   GFXTextureStreamer *mStreamer;
+
+   /// Loads texture files on the thread pool.
+   GFXTextureLoader *mLoader;
+
    GFXTextureObject *mListHead;
    GFXTextureObject *mListTail;
 
@@ -277,6 +305,15 @@ protected:
                                        bool deleteDDS,
                                        GFXTextureObject *inObj );
 
+   /// Creates a texture from a DDS file with only the smallest
+   /// mips loaded and adds it to the streamer.  Returns NULL if
+   /// the file should be loaded normally.
+   GFXTextureObject* _createStreamedTexture( const Torque::Path &path, GFXTextureProfile *profile );
+
+   /// Creates the 1x1 texture which stands in for a
+   /// texture while it is loaded asynchronously.
+   GFXTextureObject* _createPlaceholderTexture( const String &resourceName, GFXTextureProfile *profile );
+
    /// Frees the API handles to the texture, for D3D this is a release call
    ///
    /// @note freeTexture MUST NOT DELETE THE TEXTURE OBJECT
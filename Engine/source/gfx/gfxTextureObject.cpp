@@ -99,6 +99,10 @@ GFXTextureObject::GFXTextureObject(GFXDevice *aDevice, GFXTextureProfile *aProfi
 
    mHasTransparency = false;
 
+   mIsStreamed = false;
+   mStreamRequestFrame = U32_MAX;
+   mStreamRequestSize = -1.0f;
+
 #if defined(TORQUE_DEBUG)
    // Active object tracking.
    smActiveTOCount++;
@@ -125,6 +125,15 @@ public:
 
    bool     mHasTransparency;
 
+   /// Set while the texture streamer manages this texture.
+   bool     mIsStreamed;
+
+   /// The streamer frame and the screen size last reported for this
+   /// texture, which let repeated binds in a frame skip the streamer.
+   /// @see GFXTextureStreamer::requestScreenSize
+   U32      mStreamRequestFrame;
+   F32      mStreamRequestSize;
+
    // These two should be removed, and replaced by a reference to a resource
    // object, or data buffer. Something more generic. -patw
    GBitmap           *mBitmap;   ///< GBitmap we are backed by.
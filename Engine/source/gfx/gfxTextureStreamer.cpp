@@ -0,0 +1,341 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "gfx/gfxTextureStreamer.h"
+
+#include "gfx/gfxDevice.h"
+#include "gfx/gfxTextureManager.h"
+#include "gfx/gfxTextureObject.h"
+#include "gfx/bitmap/ddsFile.h"
+#include "gfx/bitmap/imageUtils.h"
+#include "console/engineAPI.h"
+
+
+bool GFXTextureStreamer::smEnabled = false;
+S32 GFXTextureStreamer::smBudgetMB = 512;
+S32 GFXTextureStreamer::smStartSize = 64;
+U32 GFXTextureStreamer::smUnusedFrames = 120;
+U32 GFXTextureStreamer::smMaxPendingLoads = 8;
+
+
+bool GFXTextureStreamer::canStream( const GFXTextureProfile *profile )
+{
+   return   profile &&
+            profile->canDownscale() &&
+            !profile->doStoreBitmap() &&
+            !profile->isDynamic() &&
+            !profile->isRenderTarget() &&
+            !profile->isZTarget() &&
+            !profile->isSystemMemory() &&
+            !profile->noMip();
+}
+
+GFXTextureStreamer::GFXTextureStreamer( GFXTextureManager *manager )
+   :  mManager( manager ),
+      mLoadQueue( new GFXTextureLoadQueue ),
+      mFrame( 0 ),
+      mNextSerial( 0 ),
+      mPendingLoads( 0 )
+{
+}
+
+GFXTextureStreamer::~GFXTextureStreamer()
+{
+}
+
+void GFXTextureStreamer::add( GFXTextureObject *texture, const String &path, U32 residentDrop, U32 minDrop )
+{
+   AssertFatal( texture, "GFXTextureStreamer::add - Got a NULL texture!" );
+   AssertFatal( !isStreamed( texture ), "GFXTextureStreamer::add - The texture is already streamed!" );
+
+   Entry entry;
+   entry.texture = texture;
+   entry.serial = mNextSerial++;
+   entry.path = path;
+   entry.width = texture->getWidth() << residentDrop;
+   entry.height = texture->getHeight() << residentDrop;
+   entry.mips = texture->getMipLevels() + residentDrop;
+   entry.format = texture->getFormat();
+
+   // Never drop below the smallest mip or start
+   // with more mips than we were given.
+   const U32 maxDrop = entry.mips - 1;
+   entry.minDrop = getMin( minDrop, maxDrop );
+   entry.startDrop = entry.minDrop;
+   while (  entry.startDrop < maxDrop &&
+            getMax( entry.width, entry.height ) >> entry.startDrop > U32( getMax( smStartSize, 1 ) ) )
+      entry.startDrop++;
+   entry.startDrop = getMax( entry.startDrop, residentDrop );
+
+   entry.residentDrop = residentDrop;
+   entry.wantedDrop = residentDrop;
+   entry.pendingDrop = -1;
+   entry.lastUsedFrame = mFrame;
+   entry.requestedSize = -1.0f;
+
+   mEntries.insertUnique( texture, entry );
+   texture->mIsStreamed = true;
+   texture->mStreamRequestFrame = U32_MAX;
+}
+
+void GFXTextureStreamer::remove( GFXTextureObject *texture )
+{
+   // Any load in flight is discarded when it
+   // fails to find a matching entry.
+   mEntries.erase( texture );
+   texture->mIsStreamed = false;
+}
+
+bool GFXTextureStreamer::isStreamed( GFXTextureObject *texture ) const
+{
+   return mEntries.find( texture ) != mEntries.end();
+}
+
+void GFXTextureStreamer::requestScreenSize( GFXTextureObject *texture, F32 screenSize )
+{
+   // Textures are bound many times a frame, so skip the lookup
+   // unless the request is bigger than the last one this frame.
+   if ( !texture->mIsStreamed )
+      return;
+
+   if ( texture->mStreamRequestFrame == mFrame )
+   {
+      const F32 lastSize = texture->mStreamRequestSize;
+      if ( lastSize <= 0.0f || ( screenSize > 0.0f && screenSize <= lastSize ) )
+         return;
+   }
+
+   texture->mStreamRequestFrame = mFrame;
+   texture->mStreamRequestSize = screenSize;
+
+   EntryMap::Iterator iter = mEntries.find( texture );
+   if ( iter == mEntries.end() )
+      return;
+
+   Entry &entry = iter->value;
+
+   // An unknown size wins over everything.
+   if ( screenSize <= 0.0f )
+      entry.requestedSize = 0.0f;
+   else if ( entry.requestedSize < 0.0f || ( entry.requestedSize > 0.0f && screenSize > entry.requestedSize ) )
+      entry.requestedSize = screenSize;
+}
+
+U32 GFXTextureStreamer::getResidentDrop( GFXTextureObject *texture ) const
+{
+   EntryMap::ConstIterator iter = mEntries.find( texture );
+   return iter != mEntries.end() ? iter->value.residentDrop : 0;
+}
+
+U32 GFXTextureStreamer::getWantedDrop( GFXTextureObject *texture ) const
+{
+   EntryMap::ConstIterator iter = mEntries.find( texture );
+   return iter != mEntries.end() ? iter->value.wantedDrop : 0;
+}
+
+U64 GFXTextureStreamer::getResidentBytes() const
+{
+   U64 bytes = 0;
+   for ( EntryMap::ConstIterator iter = mEntries.begin(); iter != mEntries.end(); ++iter )
+      bytes += _getSizeInBytes( iter->value, iter->value.residentDrop );
+
+   return bytes;
+}
+
+U64 GFXTextureStreamer::_getSizeInBytes( const Entry &entry, U32 dropMips )
+{
+   const U32 width = getMax( 1U, entry.width >> dropMips );
+   const U32 height = getMax( 1U, entry.height >> dropMips );
+   const U32 mips = entry.mips - getMin( dropMips, entry.mips - 1 );
+
+   if ( ImageUtil::isCompressedFormat( entry.format ) )
+      return DDSFile::getSizeInBytes( entry.format, height, width, mips );
+
+   const U32 byteSize = GFXFormat_getByteSize( entry.format );
+   U64 bytes = 0;
+   for ( U32 i = 0; i < mips; i++ )
+      bytes += getMax( 1U, width >> i ) * getMax( 1U, height >> i ) * byteSize;
+
+   return bytes;
+}
+
+U32 GFXTextureStreamer::_getDropForScreenSize( const Entry &entry, F32 screenSize )
+{
+   if ( screenSize <= 0.0f )
+      return entry.minDrop;
+
+   // Keep the smallest mip that still covers the screen size.
+   const U32 size = getMax( entry.width, entry.height );
+   U32 drop = entry.minDrop;
+   while ( drop < entry.startDrop && F32( size >> ( drop + 1 ) ) >= screenSize )
+      drop++;
+
+   return drop;
+}
+
+S32 QSORT_CALLBACK GFXTextureStreamer::_cmpLeastRecentlyUsed( const void *a, const void *b )
+{
+   const Entry *entryA = *(const Entry**)a;
+   const Entry *entryB = *(const Entry**)b;
+
+   if ( entryA->lastUsedFrame != entryB->lastUsedFrame )
+      return entryA->lastUsedFrame < entryB->lastUsedFrame ? -1 : 1;
+
+   // Textures covering less of the screen go first.
+   return S32( entryB->wantedDrop ) - S32( entryA->wantedDrop );
+}
+
+void GFXTextureStreamer::update()
+{
+   PROFILE_SCOPE( GFXTextureStreamer_Update );
+
+   // We can't touch textures while the device is lost.
+   if ( mManager->mTextureManagerState != GFXTextureManager::Living )
+      return;
+
+   mFrame++;
+
+   LoadResult result;
+   while ( mLoadQueue->popResult( result ) )
+      _onLoaded( result.texture, result.serial, result.dropMips, result.dds );
+
+   if ( mEntries.isEmpty() )
+      return;
+
+   // Pick the residency each texture wants from the usage feedback.
+   U64 wantedBytes = 0;
+   Vector<Entry*> entries;
+   entries.reserve( mEntries.size() );
+
+   for ( EntryMap::Iterator iter = mEntries.begin(); iter != mEntries.end(); ++iter )
+   {
+      Entry &entry = iter->value;
+
+      if ( !smEnabled )
+         entry.wantedDrop = entry.minDrop;
+      else if ( entry.requestedSize >= 0.0f )
+      {
+         entry.lastUsedFrame = mFrame;
+         entry.wantedDrop = _getDropForScreenSize( entry, entry.requestedSize );
+      }
+      else if ( mFrame - entry.lastUsedFrame > smUnusedFrames )
+         entry.wantedDrop = entry.startDrop;
+
+      entry.requestedSize = -1.0f;
+
+      wantedBytes += _getSizeInBytes( entry, entry.wantedDrop );
+      entries.push_back( &entry );
+   }
+
+   // Sort the entries by use so we can demote the
+   // least recently used textures to fit the budget.
+   dQsort( entries.address(), entries.size(), sizeof( Entry* ), _cmpLeastRecentlyUsed );
+
+   const U64 budget = U64( getMax( smBudgetMB, 0 ) ) << 20;
+   if ( smEnabled && budget > 0 )
+   {
+      for ( U32 i = 0; i < entries.size() && wantedBytes > budget; i++ )
+      {
+         Entry &entry = *entries[i];
+         while ( entry.wantedDrop < entry.startDrop && wantedBytes > budget )
+         {
+            wantedBytes -= _getSizeInBytes( entry, entry.wantedDrop ) - _getSizeInBytes( entry, entry.wantedDrop + 1 );
+            entry.wantedDrop++;
+         }
+      }
+   }
+
+   // Demotions go first as they free memory, then promotions
+   // starting with the most recently used textures.
+   for ( U32 i = 0; i < entries.size() && mPendingLoads < smMaxPendingLoads; i++ )
+   {
+      Entry &entry = *entries[i];
+      if ( entry.pendingDrop < 0 && entry.wantedDrop > entry.residentDrop )
+      {
+         entry.pendingDrop = entry.wantedDrop;
+         mPendingLoads++;
+         _requestLoad( entry, entry.wantedDrop );
+      }
+   }
+
+   for ( S32 i = entries.size() - 1; i >= 0 && mPendingLoads < smMaxPendingLoads; i-- )
+   {
+      Entry &entry = *entries[i];
+      if ( entry.pendingDrop < 0 && entry.wantedDrop < entry.residentDrop )
+      {
+         entry.pendingDrop = entry.wantedDrop;
+         mPendingLoads++;
+         _requestLoad( entry, entry.wantedDrop );
+      }
+   }
+}
+
+void GFXTextureStreamer::_requestLoad( const Entry &entry, U32 dropMips )
+{
+   mLoadQueue->queueLoad( entry.texture, entry.serial, entry.path, dropMips, false );
+}
+
+void GFXTextureStreamer::_onLoaded( GFXTextureObject *texture, U32 serial, U32 dropMips, DDSFile *dds )
+{
+   if ( mPendingLoads > 0 )
+      mPendingLoads--;
+
+   EntryMap::Iterator iter = mEntries.find( texture );
+   if ( iter == mEntries.end() || iter->value.serial != serial )
+   {
+      // The texture was deleted or stopped streaming.
+      delete dds;
+      return;
+   }
+
+   Entry &entry = iter->value;
+   entry.pendingDrop = -1;
+
+   if ( !dds )
+   {
+      Con::errorf( "GFXTextureStreamer - Failed to load '%s'!", entry.path.c_str() );
+      mEntries.erase( texture );
+      return;
+   }
+
+   if ( mManager->_createTexture( dds, texture->mProfile, false, texture ) )
+      entry.residentDrop = dropMips;
+
+   delete dds;
+}
+
+DefineEngineFunction( getTextureStreamingStats, String, (),,
+   "@brief Returns the texture streaming statistics.\n\n"
+   "@return A string with the streamed texture count, the resident megabytes "
+   "and the number of loads in flight.\n"
+   "@ingroup GFX\n" )
+{
+   if ( !GFX || !TEXMGR )
+      return String();
+
+   const GFXTextureStreamer *streamer = TEXMGR->getStreamer();
+   return String::ToString( "%d %.2f %d",
+      streamer->getTextureCount(),
+      F64( streamer->getResidentBytes() ) / ( 1024.0 * 1024.0 ),
+      streamer->getPendingLoads() );
+}
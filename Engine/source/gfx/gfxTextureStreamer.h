@@ -0,0 +1,193 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _GFXTEXTURESTREAMER_H_
+#define _GFXTEXTURESTREAMER_H_
+
+#ifndef _TDICTIONARY_H_
+#include "core/util/tDictionary.h"
+#endif
+#ifndef _TORQUE_STRING_H_
+#include "core/util/str.h"
+#endif
+#ifndef _GFXENUMS_H_
+#include "gfx/gfxEnums.h"
+#endif
+#ifndef _GFXTEXTURELOADQUEUE_H_
+#include "gfx/gfxTextureLoadQueue.h"
+#endif
+
+class GFXTextureManager;
+class GFXTextureObject;
+class GFXTextureProfile;
+struct DDSFile;
+
+
+/// Streams the mip levels of DDS textures in and out of video memory.
+///
+/// Streamed textures are created with only their smallest mips resident.
+/// Each frame the material system reports the size on screen of the
+/// objects using a texture with requestScreenSize().  On update() the
+/// streamer decides how many mips each texture needs, demotes the least
+/// recently used textures until the total fits in the byte budget, and
+/// then reloads the textures whose residency changed from DDS data on
+/// the thread pool.
+///
+/// Only textures created by GFXTextureManager::createTexture() from DDS
+/// files with a profile that allows downscaling are streamed.
+///
+/// @see GFXTextureManager::getStreamer()
+class GFXTextureStreamer
+{
+public:
+
+   /// Enables streaming for newly created textures.
+   /// Exposed to script via $pref::Video::textureStreaming.
+   static bool smEnabled;
+
+   /// The video memory budget for streamed textures in megabytes.
+   /// Exposed to script via $pref::Video::textureStreamingBudget.
+   static S32 smBudgetMB;
+
+   /// Streamed textures are created with mips dropped until the
+   /// top mip is no larger than this size.
+   /// Exposed to script via $pref::Video::textureStreamingStartSize.
+   static S32 smStartSize;
+
+   /// The number of frames a texture can go unused before it
+   /// drops back down to its starting mips.
+   static U32 smUnusedFrames;
+
+   /// The maximum number of reloads in flight at once.
+   static U32 smMaxPendingLoads;
+
+   /// Returns true if textures with this profile can be streamed.
+   static bool canStream( const GFXTextureProfile *profile );
+
+   GFXTextureStreamer( GFXTextureManager *manager );
+   virtual ~GFXTextureStreamer();
+
+   /// Starts streaming a texture.
+   ///
+   /// @param texture       The texture which currently has residentDrop
+   ///                      mips missing from the top of the chain.
+   /// @param path          The DDS file to reload mips from.
+   /// @param residentDrop  The number of mips dropped at creation.
+   /// @param minDrop       The number of mips which are never loaded,
+   ///                      normally the texture reduction level.
+   void add( GFXTextureObject *texture, const String &path, U32 residentDrop, U32 minDrop );
+
+   /// Stops streaming the texture, leaving its current mips resident.
+   void remove( GFXTextureObject *texture );
+
+   /// Returns true if the texture is being streamed.
+   bool isStreamed( GFXTextureObject *texture ) const;
+
+   /// Records that the texture is used this frame by an object covering
+   /// the given size in pixels.  Zero means the size is unknown and the
+   /// full resolution should be resident.  Requests which don't grow
+   /// what the texture already asked for this frame return early.
+   void requestScreenSize( GFXTextureObject *texture, F32 screenSize );
+
+   /// Applies finished loads, enforces the budget and issues new loads.
+   /// Called once per frame from GFXDevice::beginScene().
+   void update();
+
+   /// Returns the number of mips missing from the top of
+   /// the texture's chain.
+   U32 getResidentDrop( GFXTextureObject *texture ) const;
+
+   /// Returns the number of mips the streamer wants dropped
+   /// from the texture after the last update.
+   U32 getWantedDrop( GFXTextureObject *texture ) const;
+
+   /// Returns the video memory used by the streamed textures.
+   U64 getResidentBytes() const;
+
+   U32 getTextureCount() const { return mEntries.size(); }
+   U32 getPendingLoads() const { return mPendingLoads; }
+
+protected:
+
+   struct Entry
+   {
+      GFXTextureObject *texture;
+
+      /// Unique id used to match loads to the texture
+      /// in case it is deleted while the load is in flight.
+      U32 serial;
+
+      String path;
+
+      /// The full resolution texture.
+      U32 width;
+      U32 height;
+      U32 mips;
+      GFXFormat format;
+
+      U32 minDrop;
+      U32 startDrop;
+      U32 residentDrop;
+      U32 wantedDrop;
+
+      /// The drop being loaded or -1 if no load is in flight.
+      S32 pendingDrop;
+
+      U32 lastUsedFrame;
+
+      /// The largest size requested since the last update
+      /// or -1 if it was not used.
+      F32 requestedSize;
+   };
+
+   typedef GFXTextureLoadQueue::Result LoadResult;
+
+   GFXTextureManager *mManager;
+
+   typedef HashTable<GFXTextureObject*,Entry> EntryMap;
+   EntryMap mEntries;
+
+   ThreadSafeRef<GFXTextureLoadQueue> mLoadQueue;
+
+   U32 mFrame;
+   U32 mNextSerial;
+   U32 mPendingLoads;
+
+   /// Returns the video memory the texture uses with the given drop.
+   static U64 _getSizeInBytes( const Entry &entry, U32 dropMips );
+
+   /// Returns the drop needed to cover the screen size.
+   static U32 _getDropForScreenSize( const Entry &entry, F32 screenSize );
+
+   /// Sorts entries from least to most recently used.
+   static S32 QSORT_CALLBACK _cmpLeastRecentlyUsed( const void *a, const void *b );
+
+   /// Starts loading the texture with the given drop.  By default this
+   /// reads the DDS on the thread pool and returns the result to update().
+   virtual void _requestLoad( const Entry &entry, U32 dropMips );
+
+   /// Replaces the texture's mips with the loaded DDS.  This takes
+   /// ownership of the DDS and must be called on the main thread.
+   void _onLoaded( GFXTextureObject *texture, U32 serial, U32 dropMips, DDSFile *dds );
+};
+
+#endif // _GFXTEXTURESTREAMER_H_
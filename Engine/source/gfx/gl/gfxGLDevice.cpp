@@ -948,6 +948,7 @@ void GFXGLDevice::setShader(GFXShader *shader, bool force)
       GFXGLShader *glShader = static_cast<GFXGLShader*>( shader );
       glShader->useProgram();
       mCurrentShader = shader;
+      mDeviceStatistics.mShaderChanges++;
    }
    else
    {
@@ -958,7 +959,8 @@ void GFXGLDevice::setShader(GFXShader *shader, bool force)
 void GFXGLDevice::setShaderConstBufferInternal(GFXShaderConstBuffer* buffer)
 {
    PROFILE_SCOPE(GFXGLDevice_setShaderConstBufferInternal);
-   static_cast<GFXGLShaderConstBuffer*>(buffer)->activate();
+   if ( static_cast<GFXGLShaderConstBuffer*>(buffer)->activate() )
+      mDeviceStatistics.mShaderConstBufferUploads++;
 }
 
 U32 GFXGLDevice::getNumSamplers() const
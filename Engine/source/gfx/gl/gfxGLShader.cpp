@@ -31,6 +31,11 @@
 #include "math/mPoint2.h"
 #include "gfx/gfxStructs.h"
 #include "console/console.h"
+#include "gfx/gfxShaderCache.h"
+#include "core/util/fourcc.h"
+
+/// The shader cache format of our program binaries.
+static const U32 sProgramBinaryFormat = MakeFourCC( 'G', 'L', 'P', 'B' );
 
 #define CHECK_AARG(pos, name) static StringTableEntry attr_##name = StringTable->insert(#name); if (argName == attr_##name) { glBindAttribLocation(mProgram, pos, attr_##name); continue; }
 
@@ -360,11 +365,12 @@ void GFXGLShaderConstBuffer::set(GFXShaderConstHandle* handle, const MatrixF* ma
    }
 }
 
-void GFXGLShaderConstBuffer::activate()
+bool GFXGLShaderConstBuffer::activate()
 {
    PROFILE_SCOPE(GFXGLShaderConstBuffer_activate);
-   mShader->setConstantsFromBuffer(this);
+   const bool uploaded = mShader->setConstantsFromBuffer(this);
    mWasLost = false;
+   return uploaded;
 }
 
 const String GFXGLShaderConstBuffer::describeSelf() const
@@ -434,109 +440,138 @@ bool GFXGLShader::_init()
    macros.last().name = "TORQUE_VERTEX_SHADER";
    macros.last().value = "";
    
-   // Default to true so we're "successful" if a vertex/pixel shader wasn't specified.
-   bool compiledVertexShader = true;
-   bool compiledPixelShader = true;
-   
-   // Compile the vertex and pixel shaders if specified.
-   if(!mVertexFile.isEmpty())
-      compiledVertexShader = initShader(mVertexFile, true, macros);
+   // Build the complete source for both stages up front
+   // so that we can look for a cached program first.
+   String vertSource, pixSource;
+   if ( !mVertexFile.isEmpty() && !_getShaderSource( mVertexFile, macros, &vertSource ) )
+      return false;
 
    macros.last().name = "TORQUE_PIXEL_SHADER";
-   if(!mPixelFile.isEmpty())
-      compiledPixelShader = initShader(mPixelFile, false, macros);
-      
-   // If either shader was present and failed to compile, bail.
-   if(!compiledVertexShader || !compiledPixelShader)
+   if ( !mPixelFile.isEmpty() && !_getShaderSource( mPixelFile, macros, &pixSource ) )
       return false;
-  
-   // Link it!
-   glLinkProgram( mProgram );
+
+   // The binary is only valid for the exact driver that built it.
+   const bool useCache = GFXShaderCache::isEnabled() && _isProgramBinarySupported();
+   U64 cacheKey = 0;
+   if ( useCache )
+   {
+      cacheKey = GFXShaderCache::hashKey( (const char*)glGetString( GL_RENDERER ), cacheKey );
+      cacheKey = GFXShaderCache::hashKey( (const char*)glGetString( GL_VERSION ), cacheKey );
+      cacheKey = GFXShaderCache::hashKey( vertSource, cacheKey );
+      cacheKey = GFXShaderCache::hashKey( pixSource, cacheKey );
+   }
+
+   if ( !useCache || !_loadProgramBinary( cacheKey ) )
+   {
+      // Default to true so we're "successful" if a vertex/pixel shader wasn't specified.
+      bool compiledVertexShader = true;
+      bool compiledPixelShader = true;
+
+      // Compile the vertex and pixel shaders if specified.
+      if(!mVertexFile.isEmpty())
+         compiledVertexShader = initShader(mVertexFile, true, vertSource);
+
+      if(!mPixelFile.isEmpty())
+         compiledPixelShader = initShader(mPixelFile, false, pixSource);
+
+      // If either shader was present and failed to compile, bail.
+      if(!compiledVertexShader || !compiledPixelShader)
+         return false;
+
+      if ( useCache )
+         glProgramParameteri( mProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE );
+
+      // Link it!
+      glLinkProgram( mProgram );
    
-   GLint activeAttribs  = 0;
-   glGetProgramiv(mProgram, GL_ACTIVE_ATTRIBUTES, &activeAttribs );
+      GLint activeAttribs  = 0;
+      glGetProgramiv(mProgram, GL_ACTIVE_ATTRIBUTES, &activeAttribs );
    
-   GLint maxLength;
-   glGetProgramiv(mProgram, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxLength);
+      GLint maxLength;
+      glGetProgramiv(mProgram, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxLength);
    
-   FrameTemp<GLchar> tempData(maxLength+1);
-   *tempData.address() = '\0';
-   // Check atributes
-   for (U32 i=0; i<activeAttribs; i++)
-   {
-      GLint size;
-      GLenum type;
+      FrameTemp<GLchar> tempData(maxLength+1);
+      *tempData.address() = '\0';
+      // Check atributes
+      for (U32 i=0; i<activeAttribs; i++)
+      {
+         GLint size;
+         GLenum type;
       
-      glGetActiveAttrib(mProgram, i, maxLength + 1, NULL, &size, &type, tempData.address());
+         glGetActiveAttrib(mProgram, i, maxLength + 1, NULL, &size, &type, tempData.address());
       
-      StringTableEntry argName = StringTable->insert(tempData.address());
+         StringTableEntry argName = StringTable->insert(tempData.address());
       
-      CHECK_AARG(Torque::GL_VertexAttrib_Position,    vPosition);
-      CHECK_AARG(Torque::GL_VertexAttrib_Normal,      vNormal);
-      CHECK_AARG(Torque::GL_VertexAttrib_Color,       vColor);
-      CHECK_AARG(Torque::GL_VertexAttrib_Tangent,     vTangent);
-      CHECK_AARG(Torque::GL_VertexAttrib_TangentW,    vTangentW);
-      CHECK_AARG(Torque::GL_VertexAttrib_Binormal,    vBinormal);
-      CHECK_AARG(Torque::GL_VertexAttrib_TexCoord0,   vTexCoord0);
-      CHECK_AARG(Torque::GL_VertexAttrib_TexCoord1,   vTexCoord1);
-      CHECK_AARG(Torque::GL_VertexAttrib_TexCoord2,   vTexCoord2);
-      CHECK_AARG(Torque::GL_VertexAttrib_TexCoord3,   vTexCoord3);
-      CHECK_AARG(Torque::GL_VertexAttrib_TexCoord4,   vTexCoord4);
-      CHECK_AARG(Torque::GL_VertexAttrib_TexCoord5,   vTexCoord5);
-      CHECK_AARG(Torque::GL_VertexAttrib_TexCoord6,   vTexCoord6);
-      CHECK_AARG(Torque::GL_VertexAttrib_TexCoord7,   vTexCoord7);
-      CHECK_AARG(Torque::GL_VertexAttrib_TexCoord8,   vTexCoord8);
-      CHECK_AARG(Torque::GL_VertexAttrib_TexCoord9,   vTexCoord9);
-   }
+         CHECK_AARG(Torque::GL_VertexAttrib_Position,    vPosition);
+         CHECK_AARG(Torque::GL_VertexAttrib_Normal,      vNormal);
+         CHECK_AARG(Torque::GL_VertexAttrib_Color,       vColor);
+         CHECK_AARG(Torque::GL_VertexAttrib_Tangent,     vTangent);
+         CHECK_AARG(Torque::GL_VertexAttrib_TangentW,    vTangentW);
+         CHECK_AARG(Torque::GL_VertexAttrib_Binormal,    vBinormal);
+         CHECK_AARG(Torque::GL_VertexAttrib_TexCoord0,   vTexCoord0);
+         CHECK_AARG(Torque::GL_VertexAttrib_TexCoord1,   vTexCoord1);
+         CHECK_AARG(Torque::GL_VertexAttrib_TexCoord2,   vTexCoord2);
+         CHECK_AARG(Torque::GL_VertexAttrib_TexCoord3,   vTexCoord3);
+         CHECK_AARG(Torque::GL_VertexAttrib_TexCoord4,   vTexCoord4);
+         CHECK_AARG(Torque::GL_VertexAttrib_TexCoord5,   vTexCoord5);
+         CHECK_AARG(Torque::GL_VertexAttrib_TexCoord6,   vTexCoord6);
+         CHECK_AARG(Torque::GL_VertexAttrib_TexCoord7,   vTexCoord7);
+         CHECK_AARG(Torque::GL_VertexAttrib_TexCoord8,   vTexCoord8);
+         CHECK_AARG(Torque::GL_VertexAttrib_TexCoord9,   vTexCoord9);
+      }
 
-   //always have OUT_col
-   glBindFragDataLocation(mProgram, 0, "OUT_col");
-   // Check OUT_colN
-   for(U32 i=1;i<4;i++)
-   {
-      char buffer[10];
-      dSprintf(buffer, sizeof(buffer), "OUT_col%u",i);
-      GLint location = glGetFragDataLocation(mProgram, buffer);
-      if(location>0)
-         glBindFragDataLocation(mProgram, i, buffer);
+      //always have OUT_col
+      glBindFragDataLocation(mProgram, 0, "OUT_col");
+      // Check OUT_colN
+      for(U32 i=1;i<4;i++)
+      {
+         char buffer[10];
+         dSprintf(buffer, sizeof(buffer), "OUT_col%u",i);
+         GLint location = glGetFragDataLocation(mProgram, buffer);
+         if(location>0)
+            glBindFragDataLocation(mProgram, i, buffer);
 
-   }
+      }
    
-   // Link it again!
-   glLinkProgram( mProgram );
+      // Link it again!
+      glLinkProgram( mProgram );
    
-   GLint linkStatus;
-   glGetProgramiv( mProgram, GL_LINK_STATUS, &linkStatus );
+      GLint linkStatus;
+      glGetProgramiv( mProgram, GL_LINK_STATUS, &linkStatus );
    
-   // Dump the info log to the console
-   U32 logLength = 0;
-   glGetProgramiv(mProgram, GL_INFO_LOG_LENGTH, (GLint*)&logLength);
-   if ( logLength )
-   {
-      FrameAllocatorMarker fam;
-      char* log = (char*)fam.alloc( logLength );
-      glGetProgramInfoLog( mProgram, logLength, NULL, log );
-      
-      if ( linkStatus == GL_FALSE )
+      // Dump the info log to the console
+      U32 logLength = 0;
+      glGetProgramiv(mProgram, GL_INFO_LOG_LENGTH, (GLint*)&logLength);
+      if ( logLength )
       {
-         if ( smLogErrors )
+         FrameAllocatorMarker fam;
+         char* log = (char*)fam.alloc( logLength );
+         glGetProgramInfoLog( mProgram, logLength, NULL, log );
+      
+         if ( linkStatus == GL_FALSE )
          {
-            Con::errorf( "GFXGLShader::init - Error linking shader!" );
-            Con::errorf( "Program %s / %s: %s",
+            if ( smLogErrors )
+            {
+               Con::errorf( "GFXGLShader::init - Error linking shader!" );
+               Con::errorf( "Program %s / %s: %s",
+                  mVertexFile.getFullPath().c_str(), mPixelFile.getFullPath().c_str(), log);
+            }
+         }
+         else if ( smLogWarnings )
+         {
+            Con::warnf( "Program %s / %s: %s",
                mVertexFile.getFullPath().c_str(), mPixelFile.getFullPath().c_str(), log);
          }
       }
-      else if ( smLogWarnings )
-      {
-         Con::warnf( "Program %s / %s: %s",
-            mVertexFile.getFullPath().c_str(), mPixelFile.getFullPath().c_str(), log);
-      }
-   }
 
 
-   // If we failed to link, bail.
-   if ( linkStatus == GL_FALSE )
-      return false;
+      // If we failed to link, bail.
+      if ( linkStatus == GL_FALSE )
+         return false;
+
+      if ( useCache )
+         _saveProgramBinary( cacheKey );
+   }
 
    initConstantDescs();   
    initHandles();
@@ -814,8 +849,9 @@ GFXShaderConstHandle* GFXGLShader::findShaderConstHandle(const String& name)
    }
 }
 
-void GFXGLShader::setConstantsFromBuffer(GFXGLShaderConstBuffer* buffer)
+bool GFXGLShader::setConstantsFromBuffer(GFXGLShaderConstBuffer* buffer)
 {
+   bool uploaded = false;
    for(Vector<GFXGLShaderConstHandle*>::iterator i = mValidHandles.begin(); i != mValidHandles.end(); ++i)
    {
       GFXGLShaderConstHandle* handle = *i;
@@ -830,6 +866,7 @@ void GFXGLShader::setConstantsFromBuffer(GFXGLShaderConstBuffer* buffer)
          
       // Copy new value into our const buffer and set in GL.
       dMemcpy(mConstBuffer + handle->mOffset, buffer->mBuffer + handle->mOffset, handle->getSize());
+      uploaded = true;
       switch(handle->mDesc.constType)
       {
          case GFXSCT_Float:
@@ -879,6 +916,8 @@ void GFXGLShader::setConstantsFromBuffer(GFXGLShaderConstBuffer* buffer)
             break;
       }
    }
+
+   return uploaded;
 }
 
 GFXShaderConstBufferRef GFXGLShader::allocConstBuffer()
@@ -1012,31 +1051,31 @@ char* GFXGLShader::_handleIncludes( const Torque::Path& path, FileStream *s )
    return buffer;
 }
 
-bool GFXGLShader::_loadShaderFromStream(  GLuint shader, 
-                                          const Torque::Path &path, 
-                                          FileStream *s, 
-                                          const Vector<GFXShaderMacro> &macros )
+bool GFXGLShader::_getShaderSource(  const Torque::Path &path, 
+                                    const Vector<GFXShaderMacro> &macros,
+                                    String *outSource )
 {
-   Vector<char*> buffers;
-   Vector<U32> lengths;
-   
-   // The GLSL version declaration must go first!
-   const char *versionDecl = "#version 330\n";
-   buffers.push_back( dStrdup( versionDecl ) );
-   lengths.push_back( dStrlen( versionDecl ) );
+   PROFILE_SCOPE(GFXGLShader_GetShaderSource);
 
-   //Required extensions. These are already checked when creating the GFX adapter, if we make it this far it's supported
-   const char* cubeArrayExt = "#extension GL_ARB_texture_cube_map_array : enable\n";
-   buffers.push_back(dStrdup(cubeArrayExt));
-   lengths.push_back(dStrlen(cubeArrayExt));
+   FileStream stream;
+   if ( !stream.open( path, Torque::FS::File::Read ) )
+   {
+      AssertISV(false, avar("GFXGLShader::initShader - failed to open shader '%s'.", path.getFullPath().c_str()));
 
-   const char* gpuShader5Ext = "#extension GL_ARB_gpu_shader5 : enable\n";
-   buffers.push_back(dStrdup(gpuShader5Ext));
-   lengths.push_back(dStrlen(gpuShader5Ext));
+      if ( smLogErrors )
+         Con::errorf( "GFXGLShader::initShader - Failed to open shader file '%s'.", 
+            path.getFullPath().c_str() );
+
+      return false;
+   }
+
+   // The GLSL version declaration must go first!
+   String source( "#version 330\n" );
 
-   const char* newLine = "\r\n";
-   buffers.push_back(dStrdup(newLine));
-   lengths.push_back(dStrlen(newLine));
+   //Required extensions. These are already checked when creating the GFX adapter, if we make it this far it's supported
+   source += "#extension GL_ARB_texture_cube_map_array : enable\n";
+   source += "#extension GL_ARB_gpu_shader5 : enable\n";
+   source += "\r\n";
 
    // Now add all the macros.
    for( U32 i = 0; i < macros.size(); i++ )
@@ -1044,45 +1083,34 @@ bool GFXGLShader::_loadShaderFromStream(  GLuint shader,
       if(macros[i].name.isEmpty())  // TODO OPENGL
          continue;
 
-      String define = String::ToString( "#define %s %s\n", macros[i].name.c_str(), macros[i].value.c_str() );
-      buffers.push_back( dStrdup( define.c_str() ) );
-      lengths.push_back( define.length() );
+      source += String::ToString( "#define %s %s\n", macros[i].name.c_str(), macros[i].value.c_str() );
    }
    
    // Now finally add the shader source.
-   U32 shaderLen = s->getStreamSize();
-   char *buffer = _handleIncludes(path, s);
+   char *buffer = _handleIncludes(path, &stream);
    if ( !buffer )
       return false;
    
-   buffers.push_back(buffer);
-   lengths.push_back(shaderLen);
-   
-   glShaderSource(shader, buffers.size(), (const GLchar**)const_cast<const char**>(buffers.address()), NULL);
+   source += buffer;
+   dFree( buffer );
 
 #if defined(TORQUE_DEBUG) && defined(TORQUE_DEBUG_GFX)
-   FileStream stream;
-   if ( !stream.open( path.getFullPath()+"_DEBUG", Torque::FS::File::Write ) )
+   FileStream debugStream;
+   if ( !debugStream.open( path.getFullPath()+"_DEBUG", Torque::FS::File::Write ) )
    {
       AssertISV(false, avar("GFXGLShader::initShader - failed to write debug shader '%s'.", path.getFullPath().c_str()));
    }
 
-   for(int i = 0; i < buffers.size(); ++i)
-         stream.writeText(buffers[i]);
+   debugStream.writeText(source.c_str());
 #endif
 
-   // Cleanup the shader source buffer.
-   for ( U32 i=0; i < buffers.size(); i++ )
-      dFree( buffers[i] );
-
-   glCompileShader(shader);
-
+   *outSource = source;
    return true;
 }
 
 bool GFXGLShader::initShader( const Torque::Path &file, 
                               bool isVertex, 
-                              const Vector<GFXShaderMacro> &macros )
+                              const String &source )
 {
    PROFILE_SCOPE(GFXGLShader_CompileShader);
    GLuint activeShader = glCreateShader(isVertex ? GL_VERTEX_SHADER : GL_FRAGMENT_SHADER);
@@ -1092,22 +1120,9 @@ bool GFXGLShader::initShader( const Torque::Path &file,
       mPixelShader = activeShader;
    glAttachShader(mProgram, activeShader);
    
-   
-   // Ok it's not in the shader gen manager, so ask Torque for it
-   FileStream stream;
-   if ( !stream.open( file, Torque::FS::File::Read ) )
-   {
-      AssertISV(false, avar("GFXGLShader::initShader - failed to open shader '%s'.", file.getFullPath().c_str()));
-
-      if ( smLogErrors )
-         Con::errorf( "GFXGLShader::initShader - Failed to open shader file '%s'.", 
-            file.getFullPath().c_str() );
-
-      return false;
-   }
-   
-   if ( !_loadShaderFromStream( activeShader, file, &stream, macros ) )
-      return false;
+   const GLchar *sourceStr = source.c_str();
+   glShaderSource(activeShader, 1, &sourceStr, NULL);
+   glCompileShader(activeShader);
    
    GLint compile;
    glGetShaderiv(activeShader, GL_COMPILE_STATUS, &compile);
@@ -1141,6 +1156,68 @@ bool GFXGLShader::initShader( const Torque::Path &file,
    return compileStatus != GL_FALSE;
 }
 
+bool GFXGLShader::_isProgramBinarySupported()
+{
+   if ( !gglHasExtension(ARB_get_program_binary) )
+      return false;
+
+   GLint numFormats = 0;
+   glGetIntegerv( GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats );
+   return numFormats > 0;
+}
+
+bool GFXGLShader::_loadProgramBinary( U64 key )
+{
+   PROFILE_SCOPE(GFXGLShader_LoadProgramBinary);
+
+   // The data is prefixed with the driver's binary format.
+   Vector<U8> data;
+   if (  !GFXShaderCache::load( key, sProgramBinaryFormat, data ) ||
+         data.size() <= sizeof( GLenum ) )
+      return false;
+
+   GLenum binaryFormat;
+   dMemcpy( &binaryFormat, data.address(), sizeof( GLenum ) );
+   glProgramBinary( mProgram, binaryFormat, data.address() + sizeof( GLenum ), data.size() - sizeof( GLenum ) );
+
+   // The driver is free to reject a binary after an update
+   // in which case we just build the program normally.
+   GLint linkStatus = GL_FALSE;
+   glGetProgramiv( mProgram, GL_LINK_STATUS, &linkStatus );
+   if ( linkStatus == GL_FALSE )
+   {
+      GFXShaderCache::remove( key );
+
+      glDeleteProgram( mProgram );
+      mProgram = glCreateProgram();
+      return false;
+   }
+
+   return true;
+}
+
+void GFXGLShader::_saveProgramBinary( U64 key )
+{
+   PROFILE_SCOPE(GFXGLShader_SaveProgramBinary);
+
+   GLint length = 0;
+   glGetProgramiv( mProgram, GL_PROGRAM_BINARY_LENGTH, &length );
+   if ( length <= 0 )
+      return;
+
+   Vector<U8> data;
+   data.setSize( sizeof( GLenum ) + length );
+
+   GLenum binaryFormat = 0;
+   GLsizei written = 0;
+   glGetProgramBinary( mProgram, length, &written, &binaryFormat, data.address() + sizeof( GLenum ) );
+   if ( written <= 0 )
+      return;
+
+   dMemcpy( data.address(), &binaryFormat, sizeof( GLenum ) );
+   GFXShaderCache::save( key, sProgramBinaryFormat, data.address(), sizeof( GLenum ) + written );
+}
+
 /// Returns our list of shader constants, the material can get this and just set the constants it knows about
 const Vector<GFXShaderConstDesc>& GFXGLShader::getShaderConstDesc() const
 {
@@ -74,19 +74,36 @@ protected:
 
    bool initShader(  const Torque::Path &file, 
                      bool isVertex, 
-                     const Vector<GFXShaderMacro> &macros );
+                     const String &source );
 
    void clearShaders();
    void initConstantDescs();
    void initHandles();
-   void setConstantsFromBuffer(GFXGLShaderConstBuffer* buffer);
+   /// Returns true if any constant had to be sent to GL.
+   bool setConstantsFromBuffer(GFXGLShaderConstBuffer* buffer);
    
    static char* _handleIncludes( const Torque::Path &path, FileStream *s );
 
-   static bool _loadShaderFromStream(  GLuint shader, 
-                                       const Torque::Path& path, 
-                                       FileStream* s, 
-                                       const Vector<GFXShaderMacro>& macros );
+   /// Reads the shader file and returns its complete source with
+   /// the version, extension and macro declarations and all the
+   /// includes expanded.
+   static bool _getShaderSource( const Torque::Path &path, 
+                                 const Vector<GFXShaderMacro> &macros,
+                                 String *outSource );
+
+   /// @name Program binary cache
+   /// @{
+
+   /// Returns true if the driver can hand back linked programs.
+   static bool _isProgramBinarySupported();
+
+   /// Loads a cached program binary into mProgram.
+   bool _loadProgramBinary( U64 key );
+
+   /// Writes the linked mProgram to the shader cache.
+   void _saveProgramBinary( U64 key );
+
+   /// @}
 
    /// @name Internal GL handles
    /// @{
@@ -108,8 +125,9 @@ public:
    GFXGLShaderConstBuffer(GFXGLShader* shader, U32 bufSize, U8* existingConstants);
    ~GFXGLShaderConstBuffer();
    
-   /// Called by GFXGLDevice to activate this buffer.
-   void activate();
+   /// Called by GFXGLDevice to activate this buffer.  Returns
+   /// true if any of the constants had to be uploaded.
+   bool activate();
 
    /// Called when the shader this buffer references is reloaded.
    void onShaderReload( GFXGLShader *shader );
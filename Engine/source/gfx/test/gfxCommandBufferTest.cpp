@@ -0,0 +1,316 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2014 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "gfx/gfxCommandBuffer.h"
+#include "gfx/Null/gfxNullDevice.h"
+#include "gfx/gfxVertexBuffer.h"
+#include "gfx/gfxPrimitiveBuffer.h"
+#include "gfx/gfxVertexTypes.h"
+#include "platform/threads/threadPoolBatch.h"
+
+FIXTURE(GFXCommandBuffer)
+{
+public:
+   /// A null device that counts the calls reaching it.
+   class CountingDevice : public GFXNullDevice
+   {
+   public:
+      U32 mNumSetShader;
+      U32 mNumSetStateBlock;
+      U32 mNumDrawCalls;
+
+      CountingDevice()
+         : mNumSetShader(0), mNumSetStateBlock(0), mNumDrawCalls(0) {}
+
+      GFXVertexBuffer* getCurrentVertexBuffer(U32 stream) const { return mCurrentVertexBuffer[stream]; }
+      GFXPrimitiveBuffer* getCurrentPrimitiveBuffer() const { return mCurrentPrimitiveBuffer; }
+      GFXStateBlock* getNewStateBlock() const { return mNewStateBlock; }
+
+      virtual void setShader(GFXShader *shader, bool force = false) { mNumSetShader++; }
+      virtual void setStateBlock(GFXStateBlock *block) { mNumSetStateBlock++; GFXNullDevice::setStateBlock(block); }
+      virtual void drawPrimitive(GFXPrimitiveType primType, U32 vertexStart, U32 primitiveCount) { mNumDrawCalls++; }
+      virtual void drawIndexedPrimitive(GFXPrimitiveType primType, U32 startVertex, U32 minIndex,
+                                        U32 numVerts, U32 startIndex, U32 primitiveCount) { mNumDrawCalls++; }
+   };
+
+   /// Records draws the way a render bin would, setting all state for each of them.
+   struct RecordItem : public ThreadPoolBatch::Item
+   {
+      GFXCommandBuffer& mBuffer;
+      GFXStateBlock* mStateBlock;
+      GFXVertexBuffer* mVertexBuffer;
+      GFXPrimitiveBuffer* mPrimitiveBuffer;
+      U32 mNumDraws;
+
+      RecordItem(GFXCommandBuffer& buffer, GFXStateBlock* sb, GFXVertexBuffer* vb, GFXPrimitiveBuffer* pb, U32 numDraws)
+         : mBuffer(buffer), mStateBlock(sb), mVertexBuffer(vb), mPrimitiveBuffer(pb), mNumDraws(numDraws) {}
+
+   protected:
+      virtual void executeItem()
+      {
+         for (U32 i = 0; i < mNumDraws; i++)
+         {
+            mBuffer.setStateBlock(mStateBlock);
+            mBuffer.setVertexBuffer(mVertexBuffer);
+            mBuffer.setPrimitiveBuffer(mPrimitiveBuffer);
+            mBuffer.drawIndexedPrimitive(GFXTriangleList, 0, 0, 4, 0, 2);
+         }
+      }
+   };
+
+   CountingDevice* device;
+   GFXStateBlockRef stateBlockA;
+   GFXStateBlockRef stateBlockB;
+   GFXVertexBufferHandle<GFXVertexPC> vertexBuffer;
+   GFXPrimitiveBufferHandle primitiveBuffer;
+
+   void SetUp()
+   {
+      // The counts need a device of their own which
+      // can't be had if one is already running.
+      device = NULL;
+      if (GFXDevice::get())
+         return;
+
+      device = new CountingDevice();
+
+      GFXStateBlockDesc desc;
+      stateBlockA = device->createStateBlock(desc);
+      desc.setZReadWrite(false);
+      stateBlockB = device->createStateBlock(desc);
+
+      vertexBuffer.set(device, 4, GFXBufferTypeStatic);
+      primitiveBuffer.set(device, 6, 2, GFXBufferTypeStatic);
+   }
+
+   void TearDown()
+   {
+      if (!device)
+         return;
+
+      stateBlockA = NULL;
+      stateBlockB = NULL;
+      vertexBuffer = NULL;
+      primitiveBuffer = NULL;
+
+      device->preDestroy();
+      delete device;
+   }
+};
+
+TEST_FIX(GFXCommandBuffer, Recording)
+{
+   GFXCommandBuffer buffer;
+   EXPECT_TRUE(buffer.isEmpty());
+
+   buffer.setPrimitiveBuffer(primitiveBuffer);
+   buffer.setWorldMatrix(MatrixF::Identity);
+   buffer.drawPrimitive(GFXTriangleList, 0, 1);
+   buffer.drawIndexedPrimitive(GFXTriangleList, 0, 0, 3, 0, 1);
+
+   EXPECT_EQ(4, buffer.getNumCommands());
+   EXPECT_EQ(2, buffer.getNumCommands(GFXCommandBuffer::CmdDrawPrimitive) +
+                buffer.getNumCommands(GFXCommandBuffer::CmdDrawIndexedPrimitive));
+   EXPECT_EQ(1, buffer.getNumCommands(GFXCommandBuffer::CmdSetWorldMatrix));
+
+   buffer.clear();
+   EXPECT_TRUE(buffer.isEmpty());
+}
+
+TEST_FIX(GFXCommandBuffer, RedundantStateIsFiltered)
+{
+   if (!device)
+      return;
+
+   const U32 numDraws = 100;
+
+   GFXCommandBuffer buffer;
+   for (U32 i = 0; i < numDraws; i++)
+   {
+      buffer.setShader(NULL);
+      buffer.setStateBlock(stateBlockA);
+      buffer.setVertexBuffer(vertexBuffer);
+      buffer.setPrimitiveBuffer(primitiveBuffer);
+      buffer.setWorldMatrix(MatrixF::Identity);
+      buffer.drawIndexedPrimitive(GFXTriangleList, 0, 0, 4, 0, 2);
+   }
+
+   EXPECT_EQ(numDraws * 6, buffer.getNumCommands());
+
+   GFXCommandBuffer::ReplayStats stats;
+   buffer.replay(device, &stats);
+
+   EXPECT_EQ(numDraws * 6, stats.mNumCommands);
+   EXPECT_EQ(5 + numDraws, stats.mNumSubmitted);
+   EXPECT_EQ((numDraws - 1) * 5, stats.mNumFiltered);
+   EXPECT_EQ(numDraws, stats.mNumDrawCalls);
+
+   EXPECT_EQ(1, device->mNumSetShader);
+   EXPECT_EQ(1, device->mNumSetStateBlock);
+   EXPECT_EQ(numDraws, device->mNumDrawCalls);
+   EXPECT_EQ(vertexBuffer.getPointer(), device->getCurrentVertexBuffer(0));
+   EXPECT_EQ(primitiveBuffer.getPointer(), device->getCurrentPrimitiveBuffer());
+}
+
+TEST_FIX(GFXCommandBuffer, StateChangesAreKept)
+{
+   if (!device)
+      return;
+
+   GFXCommandBuffer buffer;
+   for (U32 i = 0; i < 10; i++)
+   {
+      buffer.setStateBlock(i & 1 ? stateBlockB : stateBlockA);
+      buffer.drawPrimitive(GFXTriangleList, 0, 2);
+   }
+
+   GFXCommandBuffer::ReplayStats stats;
+   buffer.replay(device, &stats);
+
+   EXPECT_EQ(20, stats.mNumSubmitted);
+   EXPECT_EQ(0, stats.mNumFiltered);
+   EXPECT_EQ(10, device->mNumSetStateBlock);
+   EXPECT_EQ(stateBlockB.getPointer(), device->getNewStateBlock());
+
+   // Forced shader changes always go through.
+   buffer.clear();
+   buffer.setShader(NULL, true);
+   buffer.setShader(NULL, true);
+
+   stats.clear();
+   buffer.replay(device, &stats);
+   EXPECT_EQ(2, stats.mNumSubmitted);
+   EXPECT_EQ(2, device->mNumSetShader);
+}
+
+TEST_FIX(GFXCommandBuffer, CallbackResetsFiltering)
+{
+   if (!device)
+      return;
+
+   struct Counter
+   {
+      U32 mCount;
+      void increment() { mCount++; }
+   } counter = { 0 };
+
+   GFXCommandBuffer buffer;
+   buffer.setStateBlock(stateBlockA);
+   buffer.addCallback(GFXCommandBuffer::Callback(&counter, &Counter::increment));
+   buffer.setStateBlock(stateBlockA);
+   buffer.setStateBlock(stateBlockA);
+
+   GFXCommandBuffer::ReplayStats stats;
+   buffer.replay(device, &stats);
+
+   EXPECT_EQ(1, counter.mCount);
+   EXPECT_EQ(3, stats.mNumSubmitted);
+   EXPECT_EQ(1, stats.mNumFiltered);
+   EXPECT_EQ(2, device->mNumSetStateBlock);
+}
+
+TEST_FIX(GFXCommandBuffer, VertexFormatRestoresBuffer)
+{
+   if (!device)
+      return;
+
+   // Setting the same buffer after another format has to go
+   // through as the buffer brings its own format back.
+   GFXCommandBuffer buffer;
+   buffer.setVertexBuffer(vertexBuffer);
+   buffer.setVertexFormat(getGFXVertexFormat<GFXVertexPNT>());
+   buffer.setVertexBuffer(vertexBuffer);
+
+   GFXCommandBuffer::ReplayStats stats;
+   buffer.replay(device, &stats);
+
+   EXPECT_EQ(3, stats.mNumSubmitted);
+   EXPECT_EQ(0, stats.mNumFiltered);
+}
+
+TEST_FIX(GFXCommandBuffer, ResourcesAreReferenced)
+{
+   if (!device)
+      return;
+
+   GFXVertexBufferHandle<GFXVertexPC> temp;
+   temp.set(device, 4, GFXBufferTypeStatic);
+   GFXVertexBuffer* tempBuffer = temp;
+   const U32 refs = tempBuffer->getRefCount();
+
+   GFXCommandBuffer buffer;
+   buffer.setVertexBuffer(temp);
+   buffer.setVertexBuffer(temp);
+   buffer.drawPrimitive(GFXTriangleList, 0, 1);
+   EXPECT_EQ(refs + 1, tempBuffer->getRefCount());
+
+   // The buffer alone keeps it alive across replays.
+   temp = NULL;
+   EXPECT_EQ(refs, tempBuffer->getRefCount());
+   buffer.replay(device);
+   buffer.replay(device);
+   EXPECT_EQ(tempBuffer, device->getCurrentVertexBuffer(0));
+}
+
+TEST_FIX(GFXCommandBuffer, RecordOnWorkerThreads)
+{
+   if (!device)
+      return;
+
+   // Record several buffers concurrently, then replay them in order.
+   // Filtering carries over from one buffer to the next.
+
+   const U32 numBuffers = 8;
+   const U32 numDraws = 64;
+
+   GFXCommandBuffer buffers[numBuffers];
+   const GFXCommandBuffer* bufferList[numBuffers];
+
+   // The workers leave the references to the replay.
+   const U32 refs = stateBlockA->getRefCount();
+
+   ThreadPoolBatch batch;
+   for (U32 i = 0; i < numBuffers; i++)
+   {
+      bufferList[i] = &buffers[i];
+      batch.add(new RecordItem(buffers[i], stateBlockA, vertexBuffer, primitiveBuffer, numDraws));
+   }
+   batch.wait();
+
+   for (U32 i = 0; i < numBuffers; i++)
+      EXPECT_EQ(numDraws * 4, buffers[i].getNumCommands());
+   EXPECT_EQ(refs, stateBlockA->getRefCount());
+
+   GFXCommandBuffer::ReplayStats stats;
+   GFXCommandBuffer::replayAll(device, bufferList, numBuffers, &stats);
+
+   EXPECT_EQ(numBuffers * numDraws * 4, stats.mNumCommands);
+   EXPECT_EQ(3 + numBuffers * numDraws, stats.mNumSubmitted);
+   EXPECT_EQ(numBuffers * numDraws, stats.mNumDrawCalls);
+   EXPECT_EQ(1, device->mNumSetStateBlock);
+   EXPECT_EQ(numBuffers * numDraws, device->mNumDrawCalls);
+   EXPECT_LE(refs + numBuffers, stateBlockA->getRefCount());
+}
+
+#endif
@@ -0,0 +1,108 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2014 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "testing/nullGFXDevice.h"
+#include "gfx/gfxDevice.h"
+#include "gfx/gfxShader.h"
+#include "gfx/gfxStateBlock.h"
+#include "gfx/gfxDeviceStatistics.h"
+#include "console/console.h"
+
+FIXTURE(GFXNullDevice)
+{
+public:
+   NullGFXDevice device;
+
+   void SetUp()
+   {
+      device.create();
+   }
+
+   void TearDown()
+   {
+      device.destroy();
+   }
+};
+
+TEST_FIX(GFXNullDevice, FrameStatistics)
+{
+   if (GFX->getAdapterType() != NullDevice)
+   {
+      Con::printf("GFXNullDevice: not running on the null device, skipping.");
+      return;
+   }
+
+   GFXShaderRef shaderA = GFX->createShader();
+   GFXShaderRef shaderB = GFX->createShader();
+   ASSERT_TRUE(shaderA.isValid() && shaderB.isValid());
+
+   GFXShaderConstBufferRef consts = shaderA->allocConstBuffer();
+
+   GFXStateBlockDesc desc;
+   GFXStateBlockRef opaque = GFX->createStateBlock(desc);
+   desc.setBlend(true);
+   GFXStateBlockRef blended = GFX->createStateBlock(desc);
+   desc.setFillModeWireframe();
+   GFXStateBlockRef wireframe = GFX->createStateBlock(desc);
+
+   // Start from a state block the frame doesn't use.
+   GFX->setStateBlock(wireframe);
+   GFX->updateStates();
+
+   GFX->beginScene();
+
+   GFX->setStateBlock(opaque);
+   GFX->setShader(shaderA);
+   GFX->setShaderConstBuffer(consts);
+   GFX->drawPrimitive(GFXTriangleList, 0, 2);
+
+   // Rebinding the same shader and state is not a change.
+   GFX->setShader(shaderA);
+   GFX->setStateBlock(opaque);
+   GFX->drawPrimitive(GFXTriangleList, 0, 4);
+
+   // Only changed constants are uploaded again.
+   consts->set(shaderA->getShaderConstHandle("$test"), 1.0f);
+
+   GFX->setStateBlock(blended);
+   GFX->setShader(shaderB);
+   GFX->drawIndexedPrimitive(GFXTriangleList, 0, 0, 3, 0, 1);
+
+   GFX->endScene();
+
+   const GFXDeviceStatistics *stats = GFX->getDeviceStatistics();
+   EXPECT_EQ(3, stats->mDrawCalls);
+   EXPECT_EQ(7, stats->mPolyCount);
+   EXPECT_EQ(2, stats->mShaderChanges);
+   EXPECT_EQ(2, stats->mStateBlockChanges);
+   EXPECT_EQ(2, stats->mShaderConstBufferUploads);
+
+   // The next frame starts counting from zero.
+   GFX->beginScene();
+   GFX->endScene();
+   EXPECT_EQ(0, stats->mDrawCalls);
+   EXPECT_EQ(0, stats->mShaderChanges);
+}
+
+#endif
@@ -0,0 +1,97 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2014 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "gfx/gfxShaderCache.h"
+
+FIXTURE(GFXShaderCache)
+{
+public:
+   bool mWasEnabled;
+   String mOldPath;
+   U64 mKey;
+
+   void SetUp()
+   {
+      mWasEnabled = GFXShaderCache::smEnabled;
+      mOldPath = GFXShaderCache::smPath;
+
+      GFXShaderCache::smEnabled = true;
+      GFXShaderCache::smPath = "shaderCacheTest";
+      GFXShaderCache::resetStats();
+
+      mKey = GFXShaderCache::hashKey(String("GFXShaderCacheTest"), 0);
+   }
+
+   void TearDown()
+   {
+      GFXShaderCache::remove(mKey);
+
+      GFXShaderCache::smEnabled = mWasEnabled;
+      GFXShaderCache::smPath = mOldPath;
+   }
+};
+
+TEST_FIX(GFXShaderCache, RoundTrip)
+{
+   U8 program[64];
+   for (U32 i = 0; i < sizeof(program); i++)
+      program[i] = i * 3;
+
+   EXPECT_TRUE(GFXShaderCache::save(mKey, 1, program, sizeof(program)));
+
+   Vector<U8> data;
+   ASSERT_TRUE(GFXShaderCache::load(mKey, 1, data));
+   ASSERT_EQ(data.size(), sizeof(program));
+   EXPECT_EQ(dMemcmp(data.address(), program, sizeof(program)), 0);
+   EXPECT_EQ(GFXShaderCache::getHitCount(), 1U);
+}
+
+TEST_FIX(GFXShaderCache, MismatchIsMiss)
+{
+   U8 program[16] = { 0 };
+   EXPECT_TRUE(GFXShaderCache::save(mKey, 1, program, sizeof(program)));
+
+   // Data written in another format or under another
+   // key must never be handed back.
+   Vector<U8> data;
+   EXPECT_FALSE(GFXShaderCache::load(mKey, 2, data));
+   EXPECT_FALSE(GFXShaderCache::load(mKey + 1, 1, data));
+   EXPECT_TRUE(data.empty());
+   EXPECT_EQ(GFXShaderCache::getMissCount(), 2U);
+}
+
+TEST_FIX(GFXShaderCache, Disabled)
+{
+   GFXShaderCache::smEnabled = false;
+
+   U8 program[16] = { 0 };
+   EXPECT_FALSE(GFXShaderCache::isEnabled());
+   EXPECT_FALSE(GFXShaderCache::save(mKey, 1, program, sizeof(program)));
+
+   GFXShaderCache::smEnabled = true;
+   Vector<U8> data;
+   EXPECT_FALSE(GFXShaderCache::load(mKey, 1, data));
+}
+
+#endif
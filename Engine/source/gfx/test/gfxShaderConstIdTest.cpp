@@ -0,0 +1,200 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2014 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "testing/nullGFXDevice.h"
+#include "gfx/gfxShaderConstId.h"
+#include "gfx/gfxShader.h"
+#include "gfx/genericConstBuffer.h"
+#include "gfx/gfxDevice.h"
+#include "console/console.h"
+
+FIXTURE(GFXShaderConstId)
+{
+public:
+   NullGFXDevice device;
+
+   void SetUp()
+   {
+      // The null shader hands out a handle for any name
+      // which is all the lookup tests need.
+      device.create();
+   }
+
+   void TearDown()
+   {
+      device.destroy();
+   }
+};
+
+TEST_FIX(GFXShaderConstId, Intern)
+{
+   GFXShaderConstId a("$shaderConstIdTestA");
+   GFXShaderConstId b("$shaderConstIdTestB");
+   GFXShaderConstId a2(String("$shaderConstIdTestA"));
+
+   EXPECT_TRUE(a.isValid());
+   EXPECT_TRUE(a == a2);
+   EXPECT_TRUE(a != b);
+   EXPECT_TRUE(a.getName() == String("$shaderConstIdTestA"));
+   EXPECT_LT(b.getId(), GFXShaderConstId::getCount());
+
+   GFXShaderConstId invalid;
+   EXPECT_FALSE(invalid.isValid());
+   EXPECT_TRUE(invalid.getName().isEmpty());
+}
+
+TEST_FIX(GFXShaderConstId, MatchesNameLookup)
+{
+   GFXShaderRef shader = GFX->createShader();
+   ASSERT_TRUE(shader.isValid());
+
+   GFXShaderConstId id("$shaderConstIdTestC");
+   GFXShaderConstHandle *handle = shader->getShaderConstHandle(id);
+   EXPECT_TRUE(handle != NULL);
+   EXPECT_EQ(handle, shader->getShaderConstHandle(String("$shaderConstIdTestC")));
+
+   // The second lookup comes from the id table.
+   EXPECT_EQ(handle, shader->getShaderConstHandle(id));
+}
+
+TEST(GenericConstBuffer, DirtyRanges)
+{
+   GenericConstBufferLayout layout;
+   layout.addParameter("$first", GFXSCT_Float4, 0, 16, 0, 16);
+   layout.addParameter("$matrix", GFXSCT_Float4x4, 16, 64, 0, 16);
+   layout.addParameter("$last", GFXSCT_Float4, 256, 16, 0, 16);
+
+   GenericConstBufferLayout::ParamDesc first, matrix, last;
+   ASSERT_TRUE(layout.getDesc("$first", first));
+   ASSERT_TRUE(layout.getDesc("$matrix", matrix));
+   ASSERT_TRUE(layout.getDesc("$last", last));
+   EXPECT_FALSE(layout.getDesc("$missing", last));
+   EXPECT_EQ(matrix.index, 1U);
+
+   GenericConstBuffer buffer(&layout);
+   EXPECT_FALSE(buffer.isDirty());
+   EXPECT_FALSE(buffer.isRangeDirty(0, layout.getBufferSize()));
+
+   buffer.set(last, Point4F(1, 2, 3, 4));
+   EXPECT_TRUE(buffer.isDirty());
+   EXPECT_TRUE(buffer.isRangeDirty(256, 16));
+   EXPECT_FALSE(buffer.isRangeDirty(0, 256));
+
+   // A range inside the dirty span which wasn't touched.
+   buffer.set(first, Point4F(1, 2, 3, 4));
+   EXPECT_TRUE(buffer.isRangeDirty(0, 16));
+   EXPECT_FALSE(buffer.isRangeDirty(16, 240));
+
+   buffer.setDirty(false);
+   EXPECT_FALSE(buffer.isRangeDirty(0, layout.getBufferSize()));
+
+   // Setting the same value again doesn't dirty anything.
+   buffer.set(first, Point4F(1, 2, 3, 4));
+   EXPECT_FALSE(buffer.isDirty());
+
+   buffer.set(matrix, MatrixF(true), GFXSCT_Float4x4);
+   EXPECT_TRUE(buffer.isRangeDirty(64, 16));
+   EXPECT_FALSE(buffer.isRangeDirty(0, 16));
+   EXPECT_FALSE(buffer.isRangeDirty(80, 192));
+
+   buffer.setDirty(true);
+   EXPECT_TRUE(buffer.isRangeDirty(128, 16));
+}
+
+TEST_FIX(GFXShaderConstId, StressTestPerDrawSetup)
+{
+   // Handle lookups by name against by id for 64 shaders of 64
+   // constants, then the set and dirty sub-buffer walk per draw.
+
+   const U32 numConsts = 64;
+   const U32 numShaders = 64;
+   const U32 numIterations = 200;
+
+   Vector<String> names;
+   Vector<GFXShaderConstId> ids;
+   for (U32 i = 0; i < numConsts; i++)
+   {
+      names.push_back(String::ToString("$shaderConstIdStress%d", i));
+      ids.push_back(GFXShaderConstId(names.last()));
+   }
+
+   Vector<GFXShaderRef> shaders;
+   for (U32 i = 0; i < numShaders; i++)
+      shaders.push_back(GFX->createShader());
+
+   U32 start = Platform::getRealMilliseconds();
+   for (U32 n = 0; n < numIterations; n++)
+      for (U32 s = 0; s < numShaders; s++)
+         for (U32 c = 0; c < numConsts; c++)
+            shaders[s]->getShaderConstHandle(names[c]);
+   const U32 nameTime = Platform::getRealMilliseconds() - start;
+
+   start = Platform::getRealMilliseconds();
+   for (U32 n = 0; n < numIterations; n++)
+      for (U32 s = 0; s < numShaders; s++)
+         for (U32 c = 0; c < numConsts; c++)
+            shaders[s]->getShaderConstHandle(ids[c]);
+   const U32 idTime = Platform::getRealMilliseconds() - start;
+
+   // Lay the constants out as two sub-buffers like the
+   // D3D11 $Globals and $Params buffers.
+   GenericConstBufferLayout layout;
+   for (U32 c = 0; c < numConsts; c++)
+      layout.addParameter(names[c], GFXSCT_Float4, c * 16, 16, 0, 16);
+
+   Vector<GenericConstBufferLayout::ParamDesc> params;
+   params.setSize(numConsts);
+   for (U32 c = 0; c < numConsts; c++)
+      layout.getDesc(c, params[c]);
+
+   GenericConstBuffer buffer(&layout);
+   const U32 subBufferSize = layout.getBufferSize() / 2;
+   const U32 numDraws = numIterations * numShaders * 16;
+
+   U32 uploads = 0;
+   start = Platform::getRealMilliseconds();
+   for (U32 d = 0; d < numDraws; d++)
+   {
+      // Only the per object constants change between draws.
+      for (U32 c = 0; c < 4; c++)
+         buffer.set(params[c], Point4F(F32(d), F32(c), 0, 1));
+
+      for (U32 b = 0; b < 2; b++)
+      {
+         if (buffer.isRangeDirty(b * subBufferSize, subBufferSize))
+            uploads++;
+      }
+      buffer.setDirty(false);
+   }
+   const U32 drawTime = Platform::getRealMilliseconds() - start;
+
+   Con::printf("Shader constant lookups (%d shaders x %d constants x %d):", numShaders, numConsts, numIterations);
+   Con::printf("   by name: %d ms", nameTime);
+   Con::printf("   by id:   %d ms", idTime);
+   Con::printf("Per draw constant setup (%d draws): %d ms, %d of %d sub-buffers uploaded", numDraws, drawTime, uploads, numDraws * 2);
+
+   EXPECT_EQ(uploads, numDraws);
+}
+
+#endif
@@ -0,0 +1,232 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2014 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "testing/nullGFXDevice.h"
+#include "gfx/gfxTextureLoader.h"
+#include "gfx/gfxTextureManager.h"
+#include "gfx/gfxDevice.h"
+#include "gfx/bitmap/gBitmap.h"
+#include "core/stream/fileStream.h"
+#include "math/mRandom.h"
+#include "console/console.h"
+
+FIXTURE(GFXTextureLoader)
+{
+public:
+   /// A loader which builds its loads in memory instead of
+   /// reading them from disk, and holds them until finishLoads().
+   class TestLoader : public GFXTextureLoader
+   {
+   public:
+      Vector<LoadResult> mLoads;
+
+      TestLoader(GFXTextureManager *manager)
+         : GFXTextureLoader(manager) {}
+
+      ~TestLoader()
+      {
+         for (U32 i = 0; i < mLoads.size(); i++)
+            delete mLoads[i].bitmap;
+      }
+
+      void finishLoads()
+      {
+         for (U32 i = 0; i < mLoads.size(); i++)
+            _onLoaded(mLoads[i]);
+         mLoads.clear();
+      }
+
+   protected:
+      virtual void _requestLoad(GFXTextureObject *texture, const Entry &entry, U32 dropMips)
+      {
+         LoadResult result;
+         result.texture = texture;
+         result.serial = entry.serial;
+         result.dds = NULL;
+         result.bitmap = new GBitmap(64, 32, true, GFXFormatR8G8B8A8);
+         mLoads.push_back(result);
+      }
+   };
+
+   NullGFXDevice device;
+   TestLoader* loader;
+   Vector<String> fileNames;
+   bool asyncEnabled;
+
+   void SetUp()
+   {
+      // The loader only needs a texture manager
+      // so any running device will do.
+      device.create();
+
+      loader = new TestLoader(TEXMGR);
+
+      asyncEnabled = GFXTextureLoader::smEnabled;
+   }
+
+   void TearDown()
+   {
+      GFXTextureLoader::smEnabled = asyncEnabled;
+
+      SAFE_DELETE(loader);
+
+      device.destroy();
+
+      for (U32 i = 0; i < fileNames.size(); i++)
+         dFileDelete(fileNames[i]);
+   }
+
+   /// Writes a noisy PNG which is removed after the test.
+   String writeTexture(const char *name, U32 size, MRandomLCG &random)
+   {
+      GBitmap bmp(size, size, false, GFXFormatR8G8B8A8);
+      U8 *bits = bmp.getWritableBits();
+      for (U32 i = 0; i < size * size * 4; i++)
+         bits[i] = U8(random.randI(0, 255));
+
+      String fileName = String::ToString("gfxTextureLoaderTest_%s.png", name);
+      FileStream stream;
+      if (!stream.open(fileName, Torque::FS::File::Write) || !bmp.writeBitmap("png", stream, 1))
+         return String();
+
+      fileNames.push_back(fileName);
+      return fileName;
+   }
+
+   GFXTextureObject* createPlaceholder(GFXTexHandle &handle)
+   {
+      GBitmap bmp(1, 1, false, GFXFormatR8G8B8A8);
+      handle = TEXMGR->createTexture(&bmp, String::EmptyString, &GFXStaticTextureProfile, false);
+      if (handle.isNull())
+         return NULL;
+
+      loader->add(handle, "test.png", 0);
+      return handle;
+   }
+};
+
+TEST_FIX(GFXTextureLoader, FillsPlaceholder)
+{
+   GFXTexHandle handle;
+   GFXTextureObject *tex = createPlaceholder(handle);
+   ASSERT_TRUE(tex != NULL);
+
+   EXPECT_TRUE(loader->isLoading(tex));
+   EXPECT_EQ(1, loader->getPendingLoads());
+   EXPECT_EQ(1, tex->getWidth());
+
+   // The same object now holds the loaded data.
+   loader->finishLoads();
+   EXPECT_FALSE(loader->isLoading(tex));
+   EXPECT_EQ(0, loader->getPendingLoads());
+   EXPECT_EQ(64, tex->getWidth());
+   EXPECT_EQ(32, tex->getHeight());
+   EXPECT_EQ(String("test.png"), Torque::Path(tex->getPath()).getFullFileName());
+
+   handle = NULL;
+}
+
+TEST_FIX(GFXTextureLoader, RemoveDiscardsLoads)
+{
+   GFXTexHandle handle;
+   GFXTextureObject *tex = createPlaceholder(handle);
+   ASSERT_TRUE(tex != NULL);
+
+   // The load finishing after the texture is gone
+   // must leave the placeholder untouched.
+   loader->remove(tex);
+   loader->finishLoads();
+   EXPECT_FALSE(loader->isLoading(tex));
+   EXPECT_EQ(1, tex->getWidth());
+
+   handle = NULL;
+}
+
+TEST_FIX(GFXTextureLoader, StressTestHitches)
+{
+   // Streams in a batch of textures every few frames, like a level
+   // section coming into view, and times each frame once with the
+   // files read on the frame and once with them read in the
+   // background.  The worst frame is the hitch the player sees.
+   const U32 numTextures = 48;
+   const U32 size = 512;
+   const U32 batchSize = 4;
+   const U32 batchFrames = 5;
+
+   MRandomLCG random(1);
+   Vector<String> paths[2];
+   for (U32 mode = 0; mode < 2; mode++)
+   {
+      for (U32 i = 0; i < numTextures; i++)
+      {
+         const String path = writeTexture(String::ToString("%d_%d", mode, i).c_str(), size, random);
+         ASSERT_TRUE(path.isNotEmpty());
+         paths[mode].push_back(path);
+      }
+   }
+
+   for (U32 mode = 0; mode < 2; mode++)
+   {
+      GFXTextureLoader::smEnabled = mode == 1;
+
+      Vector<GFXTexHandle> handles;
+      handles.setSize(numTextures);
+
+      U32 numRequested = 0;
+      U32 numFrames = 0;
+      U32 totalMs = 0;
+      U32 worstMs = 0;
+
+      // Keep running frames until the last upload is done.
+      while (numRequested < numTextures || TEXMGR->getLoader()->getPendingLoads() > 0)
+      {
+         const U32 start = Platform::getRealMilliseconds();
+
+         if (numFrames % batchFrames == 0)
+         {
+            for (U32 i = 0; i < batchSize && numRequested < numTextures; i++, numRequested++)
+               handles[numRequested].setAsync(paths[mode][numRequested], &GFXStaticTextureProfile, "StressTestHitches");
+         }
+
+         GFX->beginScene();
+         GFX->endScene();
+
+         const U32 frameMs = Platform::getRealMilliseconds() - start;
+         totalMs += frameMs;
+         worstMs = getMax(worstMs, frameMs);
+         numFrames++;
+      }
+
+      Con::printf("GFXTextureLoader: async loading %s, %d %dx%d textures over %d frames, %.2f ms average frame, %d ms worst frame",
+         mode ? "on" : "off", numTextures, size, size, numFrames, F32(totalMs) / F32(numFrames), worstMs);
+
+      for (U32 i = 0; i < numTextures; i++)
+      {
+         ASSERT_FALSE(handles[i].isNull());
+         EXPECT_EQ(size, handles[i]->getWidth());
+      }
+   }
+}
+
+#endif
@@ -0,0 +1,277 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2014 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "testing/nullGFXDevice.h"
+#include "gfx/gfxTextureStreamer.h"
+#include "gfx/gfxTextureManager.h"
+#include "gfx/gfxDevice.h"
+#include "gfx/bitmap/gBitmap.h"
+#include "gfx/bitmap/ddsFile.h"
+
+FIXTURE(GFXTextureStreamer)
+{
+public:
+   /// A streamer which builds its loads in memory instead of
+   /// reading them from disk, and holds them until finishLoads().
+   class TestStreamer : public GFXTextureStreamer
+   {
+   public:
+      Vector<LoadResult> mLoads;
+      U32 mNumLoads;
+
+      TestStreamer(GFXTextureManager *manager)
+         : GFXTextureStreamer(manager), mNumLoads(0) {}
+
+      ~TestStreamer()
+      {
+         for (U32 i = 0; i < mLoads.size(); i++)
+            delete mLoads[i].dds;
+      }
+
+      void finishLoads()
+      {
+         for (U32 i = 0; i < mLoads.size(); i++)
+            _onLoaded(mLoads[i].texture, mLoads[i].serial, mLoads[i].dropMips, mLoads[i].dds);
+         mLoads.clear();
+      }
+
+   protected:
+      virtual void _requestLoad(const Entry &entry, U32 dropMips)
+      {
+         mNumLoads++;
+
+         GBitmap bmp(entry.width >> dropMips, entry.height >> dropMips, true, GFXFormatR8G8B8A8);
+
+         LoadResult result;
+         result.texture = entry.texture;
+         result.serial = entry.serial;
+         result.dropMips = dropMips;
+         result.dds = DDSFile::createDDSFileFromGBitmap(&bmp);
+         mLoads.push_back(result);
+      }
+   };
+
+   NullGFXDevice device;
+   TestStreamer* streamer;
+
+   bool enabled;
+   U32 budgetMB;
+   U32 startSize;
+   U32 unusedFrames;
+
+   void SetUp()
+   {
+      // The streamer only needs a texture manager
+      // so any running device will do.
+      device.create();
+
+      streamer = new TestStreamer(TEXMGR);
+
+      enabled = GFXTextureStreamer::smEnabled;
+      budgetMB = GFXTextureStreamer::smBudgetMB;
+      startSize = GFXTextureStreamer::smStartSize;
+      unusedFrames = GFXTextureStreamer::smUnusedFrames;
+
+      GFXTextureStreamer::smEnabled = true;
+      GFXTextureStreamer::smBudgetMB = 0;
+      GFXTextureStreamer::smStartSize = 64;
+      GFXTextureStreamer::smUnusedFrames = 2;
+   }
+
+   void TearDown()
+   {
+      GFXTextureStreamer::smEnabled = enabled;
+      GFXTextureStreamer::smBudgetMB = budgetMB;
+      GFXTextureStreamer::smStartSize = startSize;
+      GFXTextureStreamer::smUnusedFrames = unusedFrames;
+
+      SAFE_DELETE(streamer);
+
+      device.destroy();
+   }
+
+   /// Creates a streamed texture of the given size with
+   /// only the mips below the start size resident.
+   GFXTextureObject* createTexture(GFXTexHandle &handle, U32 size)
+   {
+      U32 drop = 0;
+      while ((size >> drop) > U32(GFXTextureStreamer::smStartSize))
+         drop++;
+
+      GBitmap bmp(size >> drop, size >> drop, true, GFXFormatR8G8B8A8);
+      DDSFile *dds = DDSFile::createDDSFileFromGBitmap(&bmp);
+      handle = TEXMGR->createTexture(dds, &GFXStaticTextureProfile, false);
+      delete dds;
+
+      if (handle.isNull())
+         return NULL;
+
+      streamer->add(handle, "test", drop, 0);
+      return handle;
+   }
+
+   void releaseTexture(GFXTexHandle &handle)
+   {
+      streamer->remove(handle);
+      handle = NULL;
+   }
+};
+
+TEST_FIX(GFXTextureStreamer, Promote)
+{
+   GFXTexHandle handle;
+   GFXTextureObject *tex = createTexture(handle, 256);
+   ASSERT_TRUE(tex != NULL);
+
+   EXPECT_TRUE(streamer->isStreamed(tex));
+   EXPECT_EQ(2, streamer->getResidentDrop(tex));
+   EXPECT_EQ(64, tex->getWidth());
+
+   // Small on screen keeps the starting mips.
+   streamer->requestScreenSize(tex, 32.0f);
+   streamer->update();
+   EXPECT_EQ(2, streamer->getWantedDrop(tex));
+   EXPECT_EQ(0, streamer->mNumLoads);
+
+   // Covering the texture loads the full chain.
+   streamer->requestScreenSize(tex, 256.0f);
+   streamer->update();
+   EXPECT_EQ(0, streamer->getWantedDrop(tex));
+   EXPECT_EQ(1, streamer->getPendingLoads());
+
+   streamer->finishLoads();
+   EXPECT_EQ(0, streamer->getPendingLoads());
+   EXPECT_EQ(0, streamer->getResidentDrop(tex));
+   EXPECT_EQ(256, tex->getWidth());
+
+   releaseTexture(handle);
+   EXPECT_EQ(0, streamer->getTextureCount());
+}
+
+TEST_FIX(GFXTextureStreamer, RepeatedRequests)
+{
+   GFXTexHandle handle;
+   GFXTextureObject *tex = createTexture(handle, 256);
+   ASSERT_TRUE(tex != NULL);
+   EXPECT_TRUE(tex->mIsStreamed);
+
+   // Only requests larger than the last one this frame get through.
+   streamer->requestScreenSize(tex, 128.0f);
+   streamer->requestScreenSize(tex, 32.0f);
+   EXPECT_EQ(128.0f, tex->mStreamRequestSize);
+   streamer->requestScreenSize(tex, 0.0f);
+   streamer->requestScreenSize(tex, 256.0f);
+   EXPECT_EQ(0.0f, tex->mStreamRequestSize);
+
+   streamer->update();
+   EXPECT_EQ(0, streamer->getWantedDrop(tex));
+
+   // The next frame starts over.
+   streamer->requestScreenSize(tex, 32.0f);
+   EXPECT_EQ(32.0f, tex->mStreamRequestSize);
+
+   streamer->remove(tex);
+   EXPECT_FALSE(tex->mIsStreamed);
+   handle = NULL;
+}
+
+TEST_FIX(GFXTextureStreamer, UnusedDecay)
+{
+   GFXTexHandle handle;
+   GFXTextureObject *tex = createTexture(handle, 256);
+   ASSERT_TRUE(tex != NULL);
+
+   streamer->requestScreenSize(tex, 0.0f);
+   streamer->update();
+   streamer->finishLoads();
+   EXPECT_EQ(0, streamer->getResidentDrop(tex));
+
+   // Stays resident until the texture has gone unused
+   // for longer than smUnusedFrames.
+   for (U32 i = 0; i < GFXTextureStreamer::smUnusedFrames; i++)
+      streamer->update();
+   EXPECT_EQ(0, streamer->getWantedDrop(tex));
+
+   streamer->update();
+   EXPECT_EQ(2, streamer->getWantedDrop(tex));
+
+   streamer->finishLoads();
+   EXPECT_EQ(2, streamer->getResidentDrop(tex));
+   EXPECT_EQ(64, tex->getWidth());
+
+   releaseTexture(handle);
+}
+
+TEST_FIX(GFXTextureStreamer, Budget)
+{
+   // Each full chain is a little over 1.3MB so
+   // only one of them fits in the budget.
+   GFXTextureStreamer::smBudgetMB = 2;
+
+   GFXTexHandle handleA, handleB;
+   GFXTextureObject *texA = createTexture(handleA, 512);
+   GFXTextureObject *texB = createTexture(handleB, 512);
+   ASSERT_TRUE(texA != NULL && texB != NULL);
+
+   streamer->requestScreenSize(texA, 0.0f);
+   streamer->update();
+   streamer->finishLoads();
+   EXPECT_EQ(0, streamer->getResidentDrop(texA));
+
+   // The least recently used texture gives up its top mip.
+   streamer->requestScreenSize(texB, 0.0f);
+   streamer->update();
+   EXPECT_EQ(1, streamer->getWantedDrop(texA));
+   EXPECT_EQ(0, streamer->getWantedDrop(texB));
+
+   streamer->finishLoads();
+   EXPECT_EQ(1, streamer->getResidentDrop(texA));
+   EXPECT_EQ(0, streamer->getResidentDrop(texB));
+   EXPECT_LE(streamer->getResidentBytes(), U64(GFXTextureStreamer::smBudgetMB) << 20);
+
+   releaseTexture(handleA);
+   releaseTexture(handleB);
+}
+
+TEST_FIX(GFXTextureStreamer, RemoveDiscardsLoads)
+{
+   GFXTexHandle handle;
+   GFXTextureObject *tex = createTexture(handle, 256);
+   ASSERT_TRUE(tex != NULL);
+
+   streamer->requestScreenSize(tex, 256.0f);
+   streamer->update();
+   EXPECT_EQ(1, streamer->getPendingLoads());
+
+   // The load finishing after the texture stops
+   // streaming must leave it untouched.
+   streamer->remove(tex);
+   streamer->finishLoads();
+   EXPECT_FALSE(streamer->isStreamed(tex));
+   EXPECT_EQ(64, tex->getWidth());
+
+   handle = NULL;
+}
+
+#endif
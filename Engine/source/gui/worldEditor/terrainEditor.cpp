@@ -1986,6 +1986,9 @@ bool checkTerrainBlock(TerrainEditor * object, const char * funcName)
 
 void TerrainEditor::attachTerrain(TerrainBlock *terrBlock)
 {
+   // The brushes edit the terrain file directly.
+   terrBlock->getFile()->pageInAll();
+
    mActiveTerrain = terrBlock;
    mTerrainBlocks.push_back_unique(terrBlock);
 }
@@ -59,6 +59,19 @@ F32 AdvancedLightBinManager::smLightFadeEnd = 75;
 
 bool AdvancedLightBinManager::smAllowLocalLightShadows = true;
 
+bool AdvancedLightBinManager::smUseClusteredLighting = false;
+S32 AdvancedLightBinManager::smMaxLightsPerCluster = 32;
+
+GFX_ImplementTextureProfile( ALClusterDataProfile,
+                             GFXTextureProfile::DiffuseMap,
+                             GFXTextureProfile::PreserveSize |
+                             GFXTextureProfile::NoMipmap |
+                             GFXTextureProfile::Dynamic,
+                             GFXTextureProfile::NONE );
+
+/// The width of the clustered light data texture.
+static const U32 ClusterDataWidth = 1024;
+
 ImplementEnumType( ShadowFilterMode,
    "The shadow filtering modes for Advanced Lighting shadows.\n"
    "@ingroup AdvancedLighting" )
@@ -129,7 +142,8 @@ AdvancedLightBinManager::AdvancedLightBinManager( AdvancedLightManager *lm /* =
    :  RenderBinManager( RIT_LightInfo, 1.0f, 1.0f ), 
       mNumLightsCulled(0), 
       mLightManager(lm), 
-      mShadowManager(sm)
+      mShadowManager(sm),
+      mClusteredLightMaterial(NULL)
 {
    mMRTLightmapsDuringDeferred = true;
 
@@ -196,6 +210,15 @@ void AdvancedLightBinManager::consoleInit()
 
    Con::addVariable("$pref::allowLocalLightShadows", TypeBool, &smAllowLocalLightShadows, "Indicates if local lights(point/spot) can cast shadows.\n");
 
+   Con::addVariable("$pref::Lighting::clustered", TypeBool, &smUseClusteredLighting,
+      "If true the unshadowed point and spot lights are drawn in a single full screen pass "
+      "using a clustered light grid instead of a light volume each.\n"
+      "@ingroup AdvancedLighting\n");
+
+   Con::addVariable("$pref::Lighting::maxLightsPerCluster", TypeS32, &smMaxLightsPerCluster,
+      "The most lights that can affect a single cluster when $pref::Lighting::clustered is enabled.\n"
+      "@ingroup AdvancedLighting\n");
+
 }
 
 bool AdvancedLightBinManager::setTargetSize(const Point2I &newTargetSize)
@@ -254,6 +277,7 @@ void AdvancedLightBinManager::addLight( LightInfo *light )
    lEntry.lightInfo = light;
    lEntry.shadowMap = lsm;
    lEntry.lightMaterial = _getLightMaterial( lightType, shadowType, lsp->hasCookieTex() );
+   lEntry.clustered = shadowType == ShadowType_None && !lsp->hasCookieTex();
 
    if( lightType == LightInfo::Spot )
       lEntry.vertBuffer = mLightManager->getConeMesh( lEntry.numPrims, lEntry.primBuffer );
@@ -405,6 +429,8 @@ void AdvancedLightBinManager::render( SceneRenderState *state )
    else
       vectorMatInfo = _getLightMaterial( LightInfo::Vector, ShadowType_None, false );
 
+   const bool useClustered = smUseClusteredLighting && _getClusteredLightMaterial();
+
    // Initialize and set the per-frame parameters after getting
    // the vector light material as we use lazy creation.
    _setupPerFrameParameters( state );
@@ -447,6 +473,8 @@ void AdvancedLightBinManager::render( SceneRenderState *state )
 
    S32 lightCount = 0;
 
+   mClusteredLights.clear();
+
    // Blend the lights in the bin to the light buffer
    for( LightBinIterator itr = mLightBin.begin(); itr != mLightBin.end(); itr++ )
    {
@@ -469,6 +497,14 @@ void AdvancedLightBinManager::render( SceneRenderState *state )
       if (!curLightMat || curLightInfo->getBrightness() * curLightInfo->getFadeAmount() <= 0.001f)
          continue;
 
+      // Unshadowed lights are gathered up and
+      // drawn together in the clustered pass.
+      if (useClustered && curEntry.clustered)
+      {
+         mClusteredLights.push_back(curLightInfo);
+         continue;
+      }
+
       GFXDEBUGEVENT_SCOPE( AdvancedLightBinManager_Render_Light, ColorI::RED );
 
       setupSGData( sgData, state, curLightInfo );
@@ -500,6 +536,9 @@ void AdvancedLightBinManager::render( SceneRenderState *state )
       lsp->getOcclusionQuery()->end();
    }
 
+   if (!mClusteredLights.empty())
+      _renderClusteredLights(state, sgData);
+
    // Set NULL for active shadow map (so nothing gets confused)
    mShadowManager->setLightShadowMap(NULL);
    GFX->setVertexBuffer( NULL );
@@ -587,6 +626,8 @@ void AdvancedLightBinManager::_deleteLightMaterials()
       delete iter->value;
       
    mLightMaterials.clear();
+
+   SAFE_DELETE( mClusteredLightMaterial );
 }
 
 void AdvancedLightBinManager::_setupPerFrameParameters( const SceneRenderState *state )
@@ -646,6 +687,173 @@ void AdvancedLightBinManager::_setupPerFrameParameters( const SceneRenderState *
                                           farPlane, 
                                           vsFarPlane);
    }
+
+   if ( mClusteredLightMaterial && mClusteredLightMaterial->matInstance )
+      mClusteredLightMaterial->setViewParameters(  frustum.getNearDist(), 
+                                                   frustum.getFarDist(), 
+                                                   frustum.getPosition(), 
+                                                   farPlane, 
+                                                   vsFarPlane);
+}
+
+AdvancedLightBinManager::LightMaterialInfo* AdvancedLightBinManager::_getClusteredLightMaterial()
+{
+   if ( mClusteredLightMaterial )
+      return mClusteredLightMaterial->matInstance ? mClusteredLightMaterial : NULL;
+
+   mClusteredLightMaterial = new LightMaterialInfo( "AL_ClusteredLightMaterial", getGFXVertexFormat<FarFrustumQuadVert>() );
+
+   mClusterDataTarget.registerWithName( "clusteredLights" );
+
+   return mClusteredLightMaterial->matInstance ? mClusteredLightMaterial : NULL;
+}
+
+void AdvancedLightBinManager::_renderClusteredLights( SceneRenderState *state, SceneData &sgData )
+{
+   PROFILE_SCOPE( AdvancedLightBinManager_RenderClusteredLights );
+   GFXDEBUGEVENT_SCOPE( AdvancedLightBinManager_Render_ClusteredLights, ColorI::RED );
+
+   const Frustum &frustum = state->getCameraFrustum();
+   MatrixF invCam( frustum.getTransform() );
+   invCam.inverse();
+
+   mClusterGrid.setMaxLightsPerCluster( getMax( smMaxLightsPerCluster, 1 ) );
+   mClusterGrid.setFrustum( frustum );
+   mClusterGrid.clearLights();
+
+   // The grid works in view space.
+   for ( U32 i = 0; i < mClusteredLights.size(); i++ )
+   {
+      const LightInfo *light = mClusteredLights[i];
+
+      Point3F vsPos;
+      invCam.mulP( light->getPosition(), &vsPos );
+
+      if ( light->getType() == LightInfo::Spot )
+      {
+         VectorF vsDir;
+         invCam.mulV( light->getDirection(), &vsDir );
+         mClusterGrid.addSpotLight( vsPos, light->getRange().x, vsDir, mDegToRad( light->getOuterConeAngle() * 0.5f ) );
+      }
+      else
+         mClusterGrid.addPointLight( vsPos, light->getRange().x );
+   }
+
+   mClusterGrid.bin();
+   _updateClusterData( state );
+
+   Con::setIntVariable( "lightMetrics::clusteredLights", mClusteredLights.size() );
+   Con::setIntVariable( "lightMetrics::droppedClusterLights", mClusterGrid.getDroppedCount() );
+
+   // Setup the full screen pass like the vector light.  The
+   // material needs a light to check for lightmap parameters.
+   setupSGData( sgData, state, NULL );
+   sgData.lights[0] = mClusteredLights.first();
+
+   const U32 headerOffset = mClusterGrid.getLightCount() * 3;
+   const U32 indexOffset = headerOffset + mClusterGrid.getClusterCount();
+
+   MaterialParameters *matParams = mClusteredLightMaterial->matInstance->getMaterialParameters();
+   matParams->setSafe( mClusteredLightMaterial->clusterParams, 
+      Point4F( mClusterGrid.getTilesX(), mClusterGrid.getTilesY(), mClusterGrid.getSlices(), mClusterGrid.getSliceScale() ) );
+   matParams->setSafe( mClusteredLightMaterial->clusterDataParams, 
+      Point4F( 1.0f / frustum.getNearDist(), ClusterDataWidth, headerOffset, indexOffset ) );
+
+   mShadowManager->setLightShadowMap( NULL );
+
+   GFX->setVertexBuffer( mFarFrustumQuadVerts );
+   GFX->setPrimitiveBuffer( NULL );
+
+   mClusteredLightMaterial->matInstance->mSpecialLight = true;
+
+   MatrixSet &matrixSet = getRenderPass()->getMatrixSet();
+   while( mClusteredLightMaterial->matInstance->setupPass( state, sgData ) )
+   {
+      mClusteredLightMaterial->matInstance->setSceneInfo( state, sgData );
+      mClusteredLightMaterial->matInstance->setTransforms( matrixSet, state );
+      GFX->drawPrimitive( GFXTriangleStrip, 0, 2 );
+   }
+
+   mClusteredLights.clear();
+}
+
+/// Writes the next texel of the cluster data, filling the rows in order.
+static inline void _writeClusterTexel( GFXLockedRect *rect, U32 &texel, F32 x, F32 y, F32 z, F32 w )
+{
+   F32 *dest = (F32*)( rect->bits + ( texel / ClusterDataWidth ) * rect->pitch ) + ( texel % ClusterDataWidth ) * 4;
+   dest[0] = x;
+   dest[1] = y;
+   dest[2] = z;
+   dest[3] = w;
+   texel++;
+}
+
+void AdvancedLightBinManager::_updateClusterData( const SceneRenderState *state )
+{
+   PROFILE_SCOPE( AdvancedLightBinManager_UpdateClusterData );
+
+   // Three texels per light, one header per cluster 
+   // with the offset and count, and four indices per texel.
+   const U32 lightCount = mClusterGrid.getLightCount();
+   const U32 clusterCount = mClusterGrid.getClusterCount();
+   const Vector<U32> &indices = mClusterGrid.getLightIndices();
+
+   const U32 headerOffset = lightCount * 3;
+   const U32 indexOffset = headerOffset + clusterCount;
+   const U32 texelCount = indexOffset + ( indices.size() + 3 ) / 4;
+   const U32 height = ( texelCount + ClusterDataWidth - 1 ) / ClusterDataWidth;
+
+   // Only grow the texture.
+   if ( mClusterDataTex.isNull() || mClusterDataTex.getHeight() < height )
+   {
+      mClusterDataTex.set( ClusterDataWidth, height, GFXFormatR32G32B32A32F, &ALClusterDataProfile, 
+         avar( "%s() - mClusterDataTex (line %d)", __FUNCTION__, __LINE__ ) );
+      mClusterDataTarget.setTexture( mClusterDataTex );
+   }
+
+   RectI lockRect( 0, 0, ClusterDataWidth, height );
+   GFXLockedRect *rect = mClusterDataTex.lock( 0, &lockRect );
+   if ( !rect )
+      return;
+
+   U32 texel = 0;
+
+   for ( U32 i = 0; i < lightCount; i++ )
+   {
+      const LightInfo *light = mClusteredLights[i];
+      const Point3F &pos = light->getPosition();
+      const VectorF &dir = light->getDirection();
+      const F32 range = light->getRange().x;
+      const LinearColorF color = light->getColor() * ( light->getBrightness() * light->getFadeAmount() );
+
+      // Point lights get a cone cosine which passes everything.
+      F32 outerCos = -2.0f;
+      F32 cosDelta = 1.0f;
+      if ( light->getType() == LightInfo::Spot )
+      {
+         const F32 outerCone = light->getOuterConeAngle();
+         const F32 innerCone = getMin( light->getInnerConeAngle(), outerCone );
+         outerCos = mCos( mDegToRad( outerCone / 2.0f ) );
+         cosDelta = getMax( mCos( mDegToRad( innerCone / 2.0f ) ) - outerCos, 0.0001f );
+      }
+
+      _writeClusterTexel( rect, texel, pos.x, pos.y, pos.z, 1.0f / mSquared( range ) );
+      _writeClusterTexel( rect, texel, color.red, color.green, color.blue, outerCos );
+      _writeClusterTexel( rect, texel, dir.x, dir.y, dir.z, cosDelta );
+   }
+
+   for ( U32 i = 0; i < clusterCount; i++ )
+      _writeClusterTexel( rect, texel, mClusterGrid.getClusterOffset( i ), mClusterGrid.getClusterLightCount( i ), 0.0f, 0.0f );
+
+   for ( U32 i = 0; i < indices.size(); i += 4 )
+   {
+      _writeClusterTexel( rect, texel, indices[i],
+                           i + 1 < indices.size() ? indices[i + 1] : 0.0f,
+                           i + 2 < indices.size() ? indices[i + 2] : 0.0f,
+                           i + 3 < indices.size() ? indices[i + 3] : 0.0f );
+   }
+
+   mClusterDataTex.unlock();
 }
 
 void AdvancedLightBinManager::setupSGData( SceneData &data, const SceneRenderState* state, LightInfo *light )
@@ -733,7 +941,9 @@ AdvancedLightBinManager::LightMaterialInfo::LightMaterialInfo( const String &mat
    lightRange(NULL),
    lightInvSqrRange(NULL),
    lightAmbient(NULL),
-   lightSpotParams(NULL)
+   lightSpotParams(NULL),
+   clusterParams(NULL),
+   clusterDataParams(NULL)
 {   
    Material *mat = MATMGR->getMaterialDefinitionByName( matName );
    if ( !mat )
@@ -758,6 +968,8 @@ AdvancedLightBinManager::LightMaterialInfo::LightMaterialInfo( const String &mat
    zNearFarInvNearFar = matInstance->getMaterialParameterHandle("$zNearFarInvNearFar");
    lightColor = matInstance->getMaterialParameterHandle("$lightColor");
    lightBrightness = matInstance->getMaterialParameterHandle("$lightBrightness");
+   clusterParams = matInstance->getMaterialParameterHandle("$clusterParams");
+   clusterDataParams = matInstance->getMaterialParameterHandle("$clusterDataParams");
 }
 
 AdvancedLightBinManager::LightMaterialInfo::~LightMaterialInfo()
@@ -41,6 +41,9 @@
 #ifndef _SHADOW_COMMON_H_
 #include "lighting/shadowMap/shadowCommon.h"
 #endif
+#ifndef _CLUSTEREDLIGHTGRID_H_
+#include "lighting/advanced/clusteredLightGrid.h"
+#endif
 
 
 class AdvancedLightManager;
@@ -117,6 +120,13 @@ public:
 
    static bool smAllowLocalLightShadows;
 
+   /// Draws the unshadowed point and spot lights in a single
+   /// full screen pass using a clustered light grid.
+   static bool smUseClusteredLighting;
+
+   /// The most lights a single cluster can hold.
+   static S32 smMaxLightsPerCluster;
+
    // Used for console init
    AdvancedLightBinManager( AdvancedLightManager *lm = NULL, 
                             ShadowMapManager *sm = NULL,
@@ -187,6 +197,10 @@ protected:
       MaterialParameterHandle *lightAmbient;
       MaterialParameterHandle *lightSpotParams;
 
+      // Clustered light grid layout
+      MaterialParameterHandle *clusterParams;
+      MaterialParameterHandle *clusterDataParams;
+
       LightMaterialInfo(   const String &matName, 
                            const GFXVertexFormat *vertexFormat,
                            const Vector<GFXShaderMacro> &macros = Vector<GFXShaderMacro>() );
@@ -213,6 +227,9 @@ protected:
       GFXPrimitiveBuffer* primBuffer;
       GFXVertexBuffer* vertBuffer;
       U32 numPrims;
+
+      /// Set if the light can be drawn by the clustered pass.
+      bool clustered;
    };
 
    Vector<LightBinEntry> mLightBin;
@@ -242,6 +259,36 @@ protected:
 
    LightMaterialInfo* _getLightMaterial( LightInfo::Type lightType, ShadowType shadowType, bool useCookieTex );
 
+   /// @name Clustered Lighting
+   /// @{
+
+   /// The material for the clustered light pass.
+   LightMaterialInfo *mClusteredLightMaterial;
+
+   /// The lights gathered for the clustered pass this frame.
+   Vector<LightInfo*> mClusteredLights;
+
+   ClusteredLightGrid mClusterGrid;
+
+   /// The light data, cluster headers, and light indices packed
+   /// into rows of a float texture.
+   GFXTexHandle mClusterDataTex;
+
+   /// The texture target used to bind mClusterDataTex
+   /// to the clustered light material.
+   NamedTexTarget mClusterDataTarget;
+
+   LightMaterialInfo* _getClusteredLightMaterial();
+
+   /// Bins the gathered lights, uploads the result,
+   /// and draws the full screen clustered light pass.
+   void _renderClusteredLights( SceneRenderState *state, SceneData &sgData );
+
+   /// Packs the binned lights into mClusterDataTex.
+   void _updateClusterData( const SceneRenderState *state );
+
+   /// @}
+
    ///
    void _onShadowFilterChanged();
 
@@ -0,0 +1,369 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "lighting/advanced/clusteredLightGrid.h"
+
+#include "math/mMathFn.h"
+#include "math/util/frustum.h"
+
+
+ClusteredLightGrid::ClusteredLightGrid()
+   :  mTilesX( 16 ),
+      mTilesY( 8 ),
+      mSlices( 24 ),
+      mMaxLightsPerCluster( 32 ),
+      mIsOrtho( false ),
+      mNearDist( 0.0f ),
+      mFarDist( 0.0f ),
+      mNearLeft( 0.0f ),
+      mNearRight( 0.0f ),
+      mNearTop( 0.0f ),
+      mNearBottom( 0.0f ),
+      mSliceScale( 0.0f ),
+      mDroppedCount( 0 )
+{
+   VECTOR_SET_ASSOCIATION( mSphereX );
+   VECTOR_SET_ASSOCIATION( mSphereY );
+   VECTOR_SET_ASSOCIATION( mSphereZ );
+   VECTOR_SET_ASSOCIATION( mSphereRadius );
+   VECTOR_SET_ASSOCIATION( mLights );
+   VECTOR_SET_ASSOCIATION( mHitClusters );
+   VECTOR_SET_ASSOCIATION( mHitLights );
+   VECTOR_SET_ASSOCIATION( mResults );
+   VECTOR_SET_ASSOCIATION( mConeResults );
+   VECTOR_SET_ASSOCIATION( mClusterOffsets );
+   VECTOR_SET_ASSOCIATION( mClusterCounts );
+   VECTOR_SET_ASSOCIATION( mLightIndices );
+}
+
+void ClusteredLightGrid::setDimensions( U32 tilesX, U32 tilesY, U32 slices )
+{
+   AssertFatal( tilesX > 0 && tilesY > 0 && slices > 0, "ClusteredLightGrid::setDimensions - Bad dimensions!" );
+
+   if ( tilesX == mTilesX && tilesY == mTilesY && slices == mSlices )
+      return;
+
+   mTilesX = tilesX;
+   mTilesY = tilesY;
+   mSlices = slices;
+
+   // Force the bounds to be rebuilt.
+   mBounds.clear();
+}
+
+U32 ClusteredLightGrid::getSlice( F32 depth ) const
+{
+   if ( depth <= mNearDist )
+      return 0;
+
+   const S32 slice = (S32)mFloor( mLog( depth / mNearDist ) * mSliceScale );
+   return mClamp( slice, 0, (S32)mSlices - 1 );
+}
+
+F32 ClusteredLightGrid::getSliceDepth( U32 slice ) const
+{
+   if ( slice >= mSlices )
+      return mFarDist;
+
+   return mNearDist * mExp( (F32)slice / mSliceScale );
+}
+
+void ClusteredLightGrid::setFrustum( const Frustum &frustum )
+{
+   AssertFatal( frustum.getNearDist() > 0.0f, "ClusteredLightGrid::setFrustum - The near distance must be positive!" );
+
+   const U32 clusterCount = getClusterCount();
+
+   if (  mBounds.size() == clusterCount &&
+         mIsOrtho == frustum.isOrtho() &&
+         mNearDist == frustum.getNearDist() &&
+         mFarDist == frustum.getFarDist() &&
+         mNearLeft == frustum.getNearLeft() &&
+         mNearRight == frustum.getNearRight() &&
+         mNearTop == frustum.getNearTop() &&
+         mNearBottom == frustum.getNearBottom() )
+      return;
+
+   mIsOrtho = frustum.isOrtho();
+   mNearDist = frustum.getNearDist();
+   mFarDist = frustum.getFarDist();
+   mNearLeft = frustum.getNearLeft();
+   mNearRight = frustum.getNearRight();
+   mNearTop = frustum.getNearTop();
+   mNearBottom = frustum.getNearBottom();
+
+   mSliceScale = (F32)mSlices / mLog( mFarDist / mNearDist );
+
+   mBounds.clear();
+   mBounds.reserve( clusterCount );
+   mSphereX.setSize( clusterCount );
+   mSphereY.setSize( clusterCount );
+   mSphereZ.setSize( clusterCount );
+   mSphereRadius.setSize( clusterCount );
+
+   const F32 tileWidth = ( mNearRight - mNearLeft ) / (F32)mTilesX;
+   const F32 tileHeight = ( mNearTop - mNearBottom ) / (F32)mTilesY;
+
+   U32 cluster = 0;
+   for ( U32 slice = 0; slice < mSlices; slice++ )
+   {
+      const F32 nearDepth = getSliceDepth( slice );
+      const F32 farDepth = getSliceDepth( slice + 1 );
+
+      // The tile edges on the near plane are scaled out to
+      // the slice depths for perspective projections.
+      const F32 nearScale = mIsOrtho ? 1.0f : nearDepth / mNearDist;
+      const F32 farScale = mIsOrtho ? 1.0f : farDepth / mNearDist;
+
+      for ( U32 y = 0; y < mTilesY; y++ )
+      {
+         const F32 top = mNearTop - tileHeight * (F32)y;
+         const F32 bottom = mNearTop - tileHeight * (F32)( y + 1 );
+
+         for ( U32 x = 0; x < mTilesX; x++, cluster++ )
+         {
+            const F32 left = mNearLeft + tileWidth * (F32)x;
+            const F32 right = mNearLeft + tileWidth * (F32)( x + 1 );
+
+            Box3F box;
+            box.minExtents.set(  getMin( left * nearScale, left * farScale ),
+                                 nearDepth,
+                                 getMin( bottom * nearScale, bottom * farScale ) );
+            box.maxExtents.set(  getMax( right * nearScale, right * farScale ),
+                                 farDepth,
+                                 getMax( top * nearScale, top * farScale ) );
+            mBounds.push_back( box );
+
+            const Point3F center = box.getCenter();
+            mSphereX[cluster] = center.x;
+            mSphereY[cluster] = center.y;
+            mSphereZ[cluster] = center.z;
+            mSphereRadius[cluster] = ( box.maxExtents - center ).len();
+         }
+      }
+   }
+}
+
+void ClusteredLightGrid::clearLights()
+{
+   mLights.clear();
+   mHitClusters.clear();
+   mHitLights.clear();
+   mClusterOffsets.clear();
+   mClusterCounts.clear();
+   mLightIndices.clear();
+   mDroppedCount = 0;
+}
+
+U32 ClusteredLightGrid::addPointLight( const Point3F &position, F32 range )
+{
+   mLights.increment();
+   Light &light = mLights.last();
+   light.position = position;
+   light.range = range;
+   light.direction.set( 0.0f, 1.0f, 0.0f );
+   light.cosHalfAngle = -1.0f;
+   light.sinHalfAngle = 0.0f;
+   light.isSpot = false;
+
+   return mLights.size() - 1;
+}
+
+U32 ClusteredLightGrid::addSpotLight( const Point3F &position, F32 range, const VectorF &direction, F32 halfAngle )
+{
+   mLights.increment();
+   Light &light = mLights.last();
+   light.position = position;
+   light.range = range;
+   light.direction = direction;
+   light.direction.normalizeSafe();
+   mSinCos( halfAngle, light.sinHalfAngle, light.cosHalfAngle );
+   light.isSpot = true;
+
+   return mLights.size() - 1;
+}
+
+bool ClusteredLightGrid::_getTileRange(   const Point3F &minPt,
+                                          const Point3F &maxPt,
+                                          U32 *outX0, U32 *outX1,
+                                          U32 *outY0, U32 *outY1 ) const
+{
+   F32 minX = minPt.x;
+   F32 maxX = maxPt.x;
+   F32 minZ = minPt.z;
+   F32 maxZ = maxPt.z;
+
+   if ( !mIsOrtho )
+   {
+      // Project the box onto the near plane.  Only the part past
+      // the near plane matters as there are no clusters before it.
+      const F32 nearY = getMax( minPt.y, mNearDist );
+      const F32 farY = getMax( maxPt.y, mNearDist );
+
+      minX = minX * mNearDist / ( minX < 0.0f ? nearY : farY );
+      maxX = maxX * mNearDist / ( maxX < 0.0f ? farY : nearY );
+      minZ = minZ * mNearDist / ( minZ < 0.0f ? nearY : farY );
+      maxZ = maxZ * mNearDist / ( maxZ < 0.0f ? farY : nearY );
+   }
+
+   if (  maxX < mNearLeft || minX > mNearRight ||
+         maxZ < mNearBottom || minZ > mNearTop )
+      return false;
+
+   // Pad the range a little so that rounding never loses a cluster
+   // on the edge.  The exact test will reject any extra clusters.
+   const F32 pad = 0.001f;
+
+   const F32 toTileX = (F32)mTilesX / ( mNearRight - mNearLeft );
+   const F32 toTileY = (F32)mTilesY / ( mNearTop - mNearBottom );
+
+   *outX0 = mClamp( (S32)mFloor( ( minX - mNearLeft ) * toTileX - pad ), 0, (S32)mTilesX - 1 );
+   *outX1 = mClamp( (S32)mFloor( ( maxX - mNearLeft ) * toTileX + pad ), 0, (S32)mTilesX - 1 );
+   *outY0 = mClamp( (S32)mFloor( ( mNearTop - maxZ ) * toTileY - pad ), 0, (S32)mTilesY - 1 );
+   *outY1 = mClamp( (S32)mFloor( ( mNearTop - minZ ) * toTileY + pad ), 0, (S32)mTilesY - 1 );
+
+   return true;
+}
+
+void ClusteredLightGrid::_binLight( U32 lightIndex )
+{
+   const Light &light = mLights[lightIndex];
+
+   const Point3F minPt = light.position - Point3F( light.range );
+   const Point3F maxPt = light.position + Point3F( light.range );
+
+   if ( maxPt.y < mNearDist || minPt.y > mFarDist )
+      return;
+
+   U32 x0, x1, y0, y1;
+   if ( !_getTileRange( minPt, maxPt, &x0, &x1, &y0, &y1 ) )
+      return;
+
+   // Step the slices out to the stored bounds so that the
+   // log and exp rounding can't skip one.
+   const F32 *sliceMinY = mBounds.getMinY();
+   const F32 *sliceMaxY = mBounds.getMaxY();
+   const U32 sliceStride = mTilesX * mTilesY;
+
+   U32 slice0 = getSlice( minPt.y );
+   U32 slice1 = getSlice( maxPt.y );
+   while ( slice0 > 0 && sliceMaxY[( slice0 - 1 ) * sliceStride] >= minPt.y )
+      slice0--;
+   while ( slice1 + 1 < mSlices && sliceMinY[( slice1 + 1 ) * sliceStride] <= maxPt.y )
+      slice1++;
+
+   const F32 sphere[4] = { light.position.x, light.position.y, light.position.z, light.range };
+   const F32 cone[9] =
+   {
+      light.position.x, light.position.y, light.position.z,
+      light.direction.x, light.direction.y, light.direction.z,
+      light.range, light.cosHalfAngle, light.sinHalfAngle
+   };
+
+   const U32 runLength = x1 - x0 + 1;
+   U8 *results = mResults.address();
+   U8 *coneResults = mConeResults.address();
+
+   for ( U32 slice = slice0; slice <= slice1; slice++ )
+   {
+      for ( U32 y = y0; y <= y1; y++ )
+      {
+         const U32 first = getClusterIndex( x0, y, slice );
+
+         m_sphere_overlap_box3F_soa( sphere,
+            mBounds.getMinX() + first, mBounds.getMinY() + first, mBounds.getMinZ() + first,
+            mBounds.getMaxX() + first, mBounds.getMaxY() + first, mBounds.getMaxZ() + first,
+            runLength, results );
+
+         if ( light.isSpot )
+         {
+            m_cone_overlap_sphere_soa( cone,
+               mSphereX.address() + first, mSphereY.address() + first,
+               mSphereZ.address() + first, mSphereRadius.address() + first,
+               runLength, coneResults );
+
+            for ( U32 i = 0; i < runLength; i++ )
+               results[i] &= coneResults[i];
+         }
+
+         for ( U32 i = 0; i < runLength; i++ )
+         {
+            if ( !results[i] )
+               continue;
+
+            mHitClusters.push_back( first + i );
+            mHitLights.push_back( lightIndex );
+         }
+      }
+   }
+}
+
+void ClusteredLightGrid::bin()
+{
+   AssertFatal( mBounds.size() == getClusterCount(), "ClusteredLightGrid::bin - Call setFrustum first!" );
+
+   const U32 clusterCount = getClusterCount();
+
+   mHitClusters.clear();
+   mHitLights.clear();
+   mResults.setSize( mTilesX );
+   mConeResults.setSize( mTilesX );
+
+   for ( U32 i = 0; i < mLights.size(); i++ )
+      _binLight( i );
+
+   // Count the hits in each cluster.
+   mClusterCounts.setSize( clusterCount );
+   dMemset( mClusterCounts.address(), 0, clusterCount * sizeof( U32 ) );
+
+   for ( U32 i = 0; i < mHitClusters.size(); i++ )
+      mClusterCounts[mHitClusters[i]]++;
+
+   // Lay out the clusters and drop whatever is over the limit.
+   mClusterOffsets.setSize( clusterCount );
+   mDroppedCount = 0;
+
+   U32 offset = 0;
+   for ( U32 i = 0; i < clusterCount; i++ )
+   {
+      const U32 count = getMin( mClusterCounts[i], mMaxLightsPerCluster );
+      mDroppedCount += mClusterCounts[i] - count;
+
+      mClusterOffsets[i] = offset;
+      mClusterCounts[i] = 0;
+      offset += count;
+   }
+
+   // The hits are already in light order so filling
+   // them in order keeps each cluster sorted.
+   mLightIndices.setSize( offset );
+
+   for ( U32 i = 0; i < mHitClusters.size(); i++ )
+   {
+      const U32 cluster = mHitClusters[i];
+      U32 &count = mClusterCounts[cluster];
+
+      if ( count < mMaxLightsPerCluster )
+         mLightIndices[mClusterOffsets[cluster] + count++] = mHitLights[i];
+   }
+}
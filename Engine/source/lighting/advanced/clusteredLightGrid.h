@@ -0,0 +1,198 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _CLUSTEREDLIGHTGRID_H_
+#define _CLUSTEREDLIGHTGRID_H_
+
+#ifndef _MBOXSOA_H_
+#include "math/mBoxSoA.h"
+#endif
+#ifndef _MPOINT3_H_
+#include "math/mPoint3.h"
+#endif
+#ifndef _TVECTOR_H_
+#include "core/util/tVector.h"
+#endif
+
+class Frustum;
+
+
+/// Assigns lights to a grid of view space clusters.
+///
+/// The view frustum is divided into a grid of screen tiles and each
+/// tile is divided in depth into exponentially spaced slices.  A light
+/// is added to every cluster its volume touches, so a single full screen
+/// pass can look up the short list of lights affecting each pixel
+/// instead of drawing a volume per light.
+///
+/// The clusters are numbered slice by slice, then row by row from the
+/// top of the screen, then by column from the left.  Within a cluster
+/// the lights keep the order they were added in, so when a cluster
+/// overflows the lights added last are the ones dropped.
+///
+/// All positions and directions are in view space, where +y is forward
+/// and +z is up, like the Frustum class.
+///
+/// @see AdvancedLightBinManager
+class ClusteredLightGrid
+{
+public:
+
+   /// A light to be binned.
+   struct Light
+   {
+      Point3F position;
+      F32 range;
+
+      /// The unit cone axis for spot lights.
+      VectorF direction;
+      F32 cosHalfAngle;
+      F32 sinHalfAngle;
+
+      bool isSpot;
+   };
+
+   ClusteredLightGrid();
+
+   /// Sets the number of screen tiles across and down and the
+   /// number of depth slices.
+   void setDimensions( U32 tilesX, U32 tilesY, U32 slices );
+
+   U32 getTilesX() const { return mTilesX; }
+   U32 getTilesY() const { return mTilesY; }
+   U32 getSlices() const { return mSlices; }
+   U32 getClusterCount() const { return mTilesX * mTilesY * mSlices; }
+
+   /// Sets the most lights a single cluster can hold.
+   void setMaxLightsPerCluster( U32 maxLights ) { mMaxLightsPerCluster = maxLights; }
+   U32 getMaxLightsPerCluster() const { return mMaxLightsPerCluster; }
+
+   /// Builds the cluster bounds for the frustum.  This does nothing
+   /// if the projection is the same as the last call.
+   void setFrustum( const Frustum &frustum );
+
+   /// Returns the slice holding the view space depth.
+   U32 getSlice( F32 depth ) const;
+
+   /// Returns the view space depth of the near side of a slice.
+   F32 getSliceDepth( U32 slice ) const;
+
+   /// Returns the scale which turns log( depth / near ) into a slice.
+   F32 getSliceScale() const { return mSliceScale; }
+
+   /// Returns the index of a cluster.
+   U32 getClusterIndex( U32 x, U32 y, U32 slice ) const { return ( slice * mTilesY + y ) * mTilesX + x; }
+
+   /// Returns the view space bounds of all the clusters.
+   const Box3FSoA& getClusterBounds() const { return mBounds; }
+
+   /// @name Lights
+   /// @{
+
+   /// Removes all the lights and the results of the last bin().
+   void clearLights();
+
+   /// Adds a point light and returns its index.
+   U32 addPointLight( const Point3F &position, F32 range );
+
+   /// Adds a spot light and returns its index.
+   ///
+   /// @param halfAngle  Half the outer cone angle in radians.
+   U32 addSpotLight( const Point3F &position, F32 range, const VectorF &direction, F32 halfAngle );
+
+   U32 getLightCount() const { return mLights.size(); }
+
+   const Light& getLight( U32 index ) const { return mLights[index]; }
+
+   /// @}
+
+   /// Assigns the lights to the clusters.
+   void bin();
+
+   /// @name Results
+   /// @{
+
+   /// Returns the first entry of the cluster in getLightIndices().
+   U32 getClusterOffset( U32 cluster ) const { return mClusterOffsets[cluster]; }
+
+   /// Returns the number of lights in the cluster.
+   U32 getClusterLightCount( U32 cluster ) const { return mClusterCounts[cluster]; }
+
+   /// The light indices of all the clusters packed together.
+   const Vector<U32>& getLightIndices() const { return mLightIndices; }
+
+   /// Returns the number of light to cluster assignments which
+   /// didn't fit under the per cluster limit in the last bin().
+   U32 getDroppedCount() const { return mDroppedCount; }
+
+   /// @}
+
+protected:
+
+   /// Adds the clusters touched by a light to the hit list.
+   void _binLight( U32 lightIndex );
+
+   /// Finds the range of tiles covered by the view space
+   /// box, returns false if it is off screen.
+   bool _getTileRange( const Point3F &minPt, const Point3F &maxPt, U32 *outX0, U32 *outX1, U32 *outY0, U32 *outY1 ) const;
+
+   U32 mTilesX;
+   U32 mTilesY;
+   U32 mSlices;
+   U32 mMaxLightsPerCluster;
+
+   /// The projection the bounds were built for.
+   bool mIsOrtho;
+   F32 mNearDist;
+   F32 mFarDist;
+   F32 mNearLeft;
+   F32 mNearRight;
+   F32 mNearTop;
+   F32 mNearBottom;
+
+   F32 mSliceScale;
+
+   /// The cluster bounds and the bounding
+   /// spheres used for the spot light test.
+   Box3FSoA mBounds;
+   Vector<F32> mSphereX;
+   Vector<F32> mSphereY;
+   Vector<F32> mSphereZ;
+   Vector<F32> mSphereRadius;
+
+   Vector<Light> mLights;
+
+   /// The cluster and light of every hit found by _binLight.
+   Vector<U32> mHitClusters;
+   Vector<U32> mHitLights;
+
+   /// Scratch space for the batched tests.
+   Vector<U8> mResults;
+   Vector<U8> mConeResults;
+
+   Vector<U32> mClusterOffsets;
+   Vector<U32> mClusterCounts;
+   Vector<U32> mLightIndices;
+   U32 mDroppedCount;
+};
+
+#endif // _CLUSTEREDLIGHTGRID_H_
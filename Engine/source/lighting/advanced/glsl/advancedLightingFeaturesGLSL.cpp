@@ -72,7 +72,7 @@ void DeferredRTLightingFeatGLSL::processVert(   Vector<ShaderComponent*> &compon
    Var *outPosition = (Var*) LangElement::find( "gl_Position" );
    AssertFatal( outPosition, "No gl_Position, ohnoes." );
 
-   output = new GenOp( "   @ = @;\r\n", ssPos, outPosition );
+   setOutput( new GenOp( "   @ = @;\r\n", ssPos, outPosition ) );
 }
 
 void DeferredRTLightingFeatGLSL::processPix( Vector<ShaderComponent*> &componentList,
@@ -143,7 +143,7 @@ void DeferredRTLightingFeatGLSL::processPix( Vector<ShaderComponent*> &component
    if( !fd.features[MFT_VertLit] && !fd.features[MFT_ToneMap] && !fd.features[MFT_LightMap] && !fd.features[MFT_SubSurface] )
       meta->addStatement( new GenOp( "   @;\r\n", assignColor( new GenOp( "vec4(@, 1.0)", d_lightcolor ), Material::Mul ) ) );
 
-   output = meta;
+   setOutput( meta );
 }
 
 ShaderFeature::Resources DeferredRTLightingFeatGLSL::getResources( const MaterialFeatureData &fd )
@@ -218,7 +218,7 @@ void DeferredBumpFeatGLSL::processVert(   Vector<ShaderComponent*> &componentLis
                                   meta,
                                   useTexAnim, useFoliageTexCoord);
 
-      output = meta;
+      setOutput( meta );
    }
    else if (   fd.materialFeatures[MFT_NormalsOut] || 
                !fd.features[MFT_isDeferred] || 
@@ -229,7 +229,7 @@ void DeferredBumpFeatGLSL::processVert(   Vector<ShaderComponent*> &componentLis
    }
    else
    {
-      output = NULL;
+      setOutput( NULL );
    }
 }
 
@@ -237,7 +237,7 @@ void DeferredBumpFeatGLSL::processPix( Vector<ShaderComponent*> &componentList,
                                        const MaterialFeatureData &fd )
 {
    // NULL output in case nothing gets handled
-   output = NULL;
+   setOutput( NULL );
 
    if( fd.features[MFT_DeferredConditioner] )
    {
@@ -302,7 +302,7 @@ void DeferredBumpFeatGLSL::processPix( Vector<ShaderComponent*> &componentList,
       // Note: The reverse mul order is intentional. Affine matrix.
       meta->addStatement( new GenOp( "   @ = half3(tMul( @.xyz, @ ));\r\n", gbNormalDecl, bumpNorm, viewToTangent ) );
 
-      output = meta;
+      setOutput( meta );
       return;
    }
 
@@ -352,7 +352,7 @@ void DeferredBumpFeatGLSL::processPix( Vector<ShaderComponent*> &componentList,
             meta->addStatement(new GenOp("   @.xy += @.xy * @;\r\n", bumpSample, detailBump, detailBumpScale));
          }
 
-         output = meta;
+         setOutput( meta );
 
          return;
       }
@@ -378,12 +378,12 @@ void DeferredBumpFeatGLSL::processPix( Vector<ShaderComponent*> &componentList,
          bumpSample->setName( "bumpSample" );
          LangElement *bumpSampleDecl = new DecOp( bumpSample );
 
-         output = new GenOp( "   @ = tex2D(@, @);\r\n", bumpSampleDecl, bumpMap, texCoord );
+         setOutput( new GenOp( "   @ = tex2D(@, @);\r\n", bumpSampleDecl, bumpMap, texCoord ) );
          return;
       }
    }
 
-   output = NULL;
+   setOutput( NULL );
 }
 
 ShaderFeature::Resources DeferredBumpFeatGLSL::getResources( const MaterialFeatureData &fd )
@@ -506,7 +506,7 @@ void DeferredMinnaertGLSL::processVert(   Vector<ShaderComponent*> &componentLis
    // If there is no deferred information, bail on this feature
    if( !fd.features[MFT_isDeferred] || !fd.features[MFT_RTLighting] )
    {
-      output = NULL;
+      setOutput( NULL );
       return;
    }
 
@@ -514,7 +514,7 @@ void DeferredMinnaertGLSL::processVert(   Vector<ShaderComponent*> &componentLis
    // pixel shader so we can calculate a view vector.
    MultiLine *meta = new MultiLine;
    addOutWsPosition( componentList, fd.features[MFT_UseInstancing], meta );
-   output = meta;
+   setOutput( meta );
 }
 
 void DeferredMinnaertGLSL::processPix( Vector<ShaderComponent*> &componentList, 
@@ -523,7 +523,7 @@ void DeferredMinnaertGLSL::processPix( Vector<ShaderComponent*> &componentList,
    // If there is no deferred information, bail on this feature
    if( !fd.features[MFT_isDeferred] || !fd.features[MFT_RTLighting] )
    {
-      output = NULL;
+      setOutput( NULL );
       return;
    }
 
@@ -559,7 +559,7 @@ void DeferredMinnaertGLSL::processPix( Vector<ShaderComponent*> &componentList,
    meta->addStatement( new GenOp( "   float Minnaert = pow( @, @) * pow(vDotN, 1.0 - @);\r\n", d_NL_Att, minnaertConstant, minnaertConstant ) );
    meta->addStatement( new GenOp( "   @;\r\n", assignColor( new GenOp( "vec4(Minnaert, Minnaert, Minnaert, 1.0)" ), Material::Mul ) ) );
 
-   output = meta;
+   setOutput( meta );
 }
 
 
@@ -582,9 +582,9 @@ void DeferredSubSurfaceGLSL::processPix(  Vector<ShaderComponent*> &componentLis
    {
       targ = (Var*)LangElement::find(getOutputTargetVarName(ShaderFeature::RenderTarget3));
       meta->addStatement(new GenOp("   @.rgb += @.rgb*@.a;\r\n", targ, subSurfaceParams, subSurfaceParams));
-      output = meta;
+      setOutput( meta );
       return;
    }
 
-   output = meta;
+   setOutput( meta );
 }
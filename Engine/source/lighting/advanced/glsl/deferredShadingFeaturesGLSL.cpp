@@ -97,7 +97,7 @@ void DeferredOrmMapGLSL::processPix( Vector<ShaderComponent*> &componentList, co
    }
    meta->addStatement(new GenOp("   @ = @.a;\r\n", new DecOp(metalness), ormConfig));
 
-   output = meta;
+   setOutput( meta );
 }
 
 ShaderFeature::Resources DeferredOrmMapGLSL::getResources( const MaterialFeatureData &fd )
@@ -132,7 +132,7 @@ void DeferredOrmMapGLSL::processVert( Vector<ShaderComponent*> &componentList,
                      fd.features[MFT_TexAnim], 
                      meta, 
                      componentList );
-   output = meta;
+   setOutput( meta );
 }
 
 U32 MatInfoFlagsGLSL::getOutputTargets(const MaterialFeatureData& fd) const
@@ -174,8 +174,8 @@ void MatInfoFlagsGLSL::processPix( Vector<ShaderComponent*> &componentList, cons
    matInfoFlags->uniform = true;
    matInfoFlags->constSortPos = cspPotentialPrimitive;
 
-   meta->addStatement(output = new GenOp("   @.r = @;\r\n", ormConfig, matInfoFlags));
-   output = meta;
+   meta->addStatement(new GenOp("   @.r = @;\r\n", ormConfig, matInfoFlags));
+   setOutput( meta );
 }
 
 U32 ORMConfigVarsGLSL::getOutputTargets(const MaterialFeatureData& fd) const
@@ -225,7 +225,7 @@ void ORMConfigVarsGLSL::processPix( Vector<ShaderComponent*> &componentList, con
    if (fd.features[MFT_InvertRoughness])
       meta->addStatement(new GenOp("   @ = 1.0-@;\r\n", roughness, roughness));
    meta->addStatement(new GenOp("   @.a = @;\r\n", ormConfig, metalness));
-   output = meta;
+   setOutput( meta );
 }
 
 U32 GlowMapGLSL::getOutputTargets(const MaterialFeatureData& fd) const
@@ -261,16 +261,16 @@ void GlowMapGLSL::processPix(Vector<ShaderComponent*>& componentList, const Mate
          targ->setType("vec4");
          targ->setName(getOutputTargetVarName(ShaderFeature::RenderTarget3));
          targ->setStructName("OUT");
-         output = new GenOp("@ = vec4(@.rgb*@,0);", targ, texOp, glowMul);
+         setOutput( new GenOp("@ = vec4(@.rgb*@,0);", targ, texOp, glowMul) );
       }
       else
       {
-         output = new GenOp("@ += vec4(@.rgb*@,0);", targ, texOp, glowMul);
+         setOutput( new GenOp("@ += vec4(@.rgb*@,0);", targ, texOp, glowMul) );
       }
    }
    else
    {
-      output = new GenOp("@ += vec4(@.rgb*@,@.a);", targ, texOp, glowMul, targ);
+      setOutput( new GenOp("@ += vec4(@.rgb*@,@.a);", targ, texOp, glowMul, targ) );
    }
 
 }
@@ -88,7 +88,7 @@ void GBufferConditionerGLSL::processVert( Vector<ShaderComponent*> &componentLis
       return;
 
    MultiLine *meta = new MultiLine;
-   output = meta;
+   setOutput( meta );
 
    // grab incoming vert normal
    Var *inNormal = (Var*) LangElement::find( "normal" );
@@ -114,8 +114,9 @@ void GBufferConditionerGLSL::processVert( Vector<ShaderComponent*> &componentLis
       // TODO: Total hack because Conditioner is directly derived
       // from ShaderFeature and not from ShaderFeatureGLSL.
       NamedFeatureGLSL dummy( String::EmptyString );
-      dummy.setInstancingFormat( mInstancingFormat );
+      dummy.setInstancingFormat( getInstancingFormat() );
       Var *worldViewOnly = dummy.getWorldView( componentList, fd.features[MFT_UseInstancing], meta );
+      dummy.reset();
 
       meta->addStatement(  new GenOp("   @ = tMul(@, float4( normalize(@), 0.0 ) ).xyz;\r\n", 
                               outNormal, worldViewOnly, inNormal ) );
@@ -184,7 +185,7 @@ void GBufferConditionerGLSL::processPix(  Vector<ShaderComponent*> &componentLis
       meta->addStatement( new GenOp( "   @.ba = float2( 0, @ ); // MFT_IsTranslucentZWrite\r\n", outColor, alphaVal ) );
    }
 
-   output = meta;
+   setOutput( meta );
 }
 
 ShaderFeature::Resources GBufferConditionerGLSL::getResources( const MaterialFeatureData &fd )
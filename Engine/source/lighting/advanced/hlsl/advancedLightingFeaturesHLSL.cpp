@@ -72,7 +72,7 @@ void DeferredRTLightingFeatHLSL::processVert(   Vector<ShaderComponent*> &compon
    Var *outPosition = (Var*) LangElement::find( "hpos" );
    AssertFatal( outPosition, "No hpos, ohnoes." );
 
-   output = new GenOp( "   @ = @;\r\n", ssPos, outPosition );
+   setOutput( new GenOp( "   @ = @;\r\n", ssPos, outPosition ) );
 }
 
 void DeferredRTLightingFeatHLSL::processPix( Vector<ShaderComponent*> &componentList,
@@ -151,7 +151,7 @@ void DeferredRTLightingFeatHLSL::processPix( Vector<ShaderComponent*> &component
    if( !fd.features[MFT_VertLit] && !fd.features[MFT_ToneMap] && !fd.features[MFT_LightMap] && !fd.features[MFT_SubSurface] )
       meta->addStatement( new GenOp( "   @;\r\n", assignColor( new GenOp( "float4(@, 1.0)", d_lightcolor ), Material::Mul ) ) );
 
-   output = meta;
+   setOutput( meta );
 }
 
 ShaderFeature::Resources DeferredRTLightingFeatHLSL::getResources( const MaterialFeatureData &fd )
@@ -226,7 +226,7 @@ void DeferredBumpFeatHLSL::processVert(   Vector<ShaderComponent*> &componentLis
                                   meta,
                                   useTexAnim, useFoliageTexCoord);
 
-      output = meta;
+      setOutput( meta );
    }
    else if (   fd.materialFeatures[MFT_NormalsOut] || 
                !fd.features[MFT_isDeferred] || 
@@ -237,7 +237,7 @@ void DeferredBumpFeatHLSL::processVert(   Vector<ShaderComponent*> &componentLis
    }
    else
    {
-      output = NULL;
+      setOutput( NULL );
    }
 }
 
@@ -245,7 +245,7 @@ void DeferredBumpFeatHLSL::processPix( Vector<ShaderComponent*> &componentList,
                                        const MaterialFeatureData &fd )
 {
    // NULL output in case nothing gets handled
-   output = NULL;
+   setOutput( NULL );
 
    if( fd.features[MFT_DeferredConditioner] )
    {
@@ -320,7 +320,7 @@ void DeferredBumpFeatHLSL::processPix( Vector<ShaderComponent*> &componentList,
       // Note: The reverse mul order is intentional. Affine matrix.
       meta->addStatement( new GenOp( "   @ = (half3)mul( @.xyz, @ );\r\n", gbNormalDecl, bumpNorm, viewToTangent ) );
 
-      output = meta;
+      setOutput( meta );
       return;
    }
    else if (fd.features[MFT_AccuMap]) 
@@ -340,7 +340,7 @@ void DeferredBumpFeatHLSL::processPix( Vector<ShaderComponent*> &componentList,
          LangElement *bumpSampleDecl = new DecOp(bumpSample);
 
          Var *bumpMapTex = (Var *)LangElement::find("bumpMapTex");
-         output = new GenOp("   @ = @.Sample(@, @);\r\n", bumpSampleDecl, bumpMapTex, bumpMap, texCoord);
+         setOutput( new GenOp("   @ = @.Sample(@, @);\r\n", bumpSampleDecl, bumpMapTex, bumpMap, texCoord) );
 
          if ( fd.features.hasFeature( MFT_DetailNormalMap ) )
          {
@@ -383,7 +383,7 @@ void DeferredBumpFeatHLSL::processPix( Vector<ShaderComponent*> &componentList,
             meta->addStatement( new GenOp( "   @.xy += @.xy * @;\r\n", bumpSample, detailBump, detailBumpScale ) );
          }
 
-         output = meta;
+         setOutput( meta );
 
          return;
       }
@@ -410,13 +410,13 @@ void DeferredBumpFeatHLSL::processPix( Vector<ShaderComponent*> &componentList,
          bumpSample->setName("bumpSample");
 
          LangElement *bumpSampleDecl = new DecOp(bumpSample);
-         output = new GenOp("   @ = @.Sample(@, @);\r\n", bumpSampleDecl, bumpMapTex, bumpMap, texCoord);
+         setOutput( new GenOp("   @ = @.Sample(@, @);\r\n", bumpSampleDecl, bumpMapTex, bumpMap, texCoord) );
 
          return;
       }
    }
 
-   output = NULL;
+   setOutput( NULL );
 }
 
 ShaderFeature::Resources DeferredBumpFeatHLSL::getResources( const MaterialFeatureData &fd )
@@ -538,7 +538,7 @@ void DeferredMinnaertHLSL::processVert(   Vector<ShaderComponent*> &componentLis
    // If there is no deferred information, bail on this feature
    if( !fd.features[MFT_isDeferred] || !fd.features[MFT_RTLighting] )
    {
-      output = NULL;
+      setOutput( NULL );
       return;
    }
 
@@ -546,7 +546,7 @@ void DeferredMinnaertHLSL::processVert(   Vector<ShaderComponent*> &componentLis
    // pixel shader so we can calculate a view vector.
    MultiLine *meta = new MultiLine;
    addOutWsPosition( componentList, fd.features[MFT_UseInstancing], meta );
-   output = meta;
+   setOutput( meta );
 }
 
 void DeferredMinnaertHLSL::processPix( Vector<ShaderComponent*> &componentList, 
@@ -555,7 +555,7 @@ void DeferredMinnaertHLSL::processPix( Vector<ShaderComponent*> &componentList,
    // If there is no deferred information, bail on this feature
    if( !fd.features[MFT_isDeferred] || !fd.features[MFT_RTLighting] )
    {
-      output = NULL;
+      setOutput( NULL );
       return;
    }
 
@@ -599,7 +599,7 @@ void DeferredMinnaertHLSL::processPix( Vector<ShaderComponent*> &componentList,
    meta->addStatement( new GenOp( "   float Minnaert = pow( @, @) * pow(vDotN, 1.0 - @);\r\n", d_NL_Att, minnaertConstant, minnaertConstant ) );
    meta->addStatement( new GenOp( "   @;\r\n", assignColor( new GenOp( "float4(Minnaert, Minnaert, Minnaert, 1.0)" ), Material::Mul ) ) );
 
-   output = meta;
+   setOutput( meta );
 }
 
 
@@ -622,9 +622,9 @@ void DeferredSubSurfaceHLSL::processPix(  Vector<ShaderComponent*> &componentLis
    {
       targ = (Var*)LangElement::find(getOutputTargetVarName(ShaderFeature::RenderTarget3));
       meta->addStatement(new GenOp("   @.rgb += @.rgb*@.a;\r\n", targ, subSurfaceParams, subSurfaceParams));
-      output = meta;
+      setOutput( meta );
       return;
    }
 
-   output = meta;
+   setOutput( meta );
 }
@@ -104,7 +104,7 @@ void DeferredOrmMapHLSL::processPix( Vector<ShaderComponent*> &componentList, co
    }
    meta->addStatement(new GenOp("   @ = @.a;\r\n", new DecOp(metalness), ormConfig));
 
-   output = meta;
+   setOutput( meta );
 }
 
 ShaderFeature::Resources DeferredOrmMapHLSL::getResources( const MaterialFeatureData &fd )
@@ -139,7 +139,7 @@ void DeferredOrmMapHLSL::processVert( Vector<ShaderComponent*> &componentList,
                      fd.features[MFT_TexAnim], 
                      meta, 
                      componentList );
-   output = meta;
+   setOutput( meta );
 }
 
 U32 MatInfoFlagsHLSL::getOutputTargets(const MaterialFeatureData& fd) const
@@ -176,7 +176,7 @@ void MatInfoFlagsHLSL::processPix( Vector<ShaderComponent*> &componentList, cons
    matInfoFlags->uniform = true;
    matInfoFlags->constSortPos = cspPotentialPrimitive;
 
-   output = new GenOp( "   @.r = @;\r\n", ormConfig, matInfoFlags );
+   setOutput( new GenOp( "   @.r = @;\r\n", ormConfig, matInfoFlags ) );
 }
 
 U32 ORMConfigVarsHLSL::getOutputTargets(const MaterialFeatureData& fd) const
@@ -220,7 +220,7 @@ void ORMConfigVarsHLSL::processPix( Vector<ShaderComponent*> &componentList, con
    if (fd.features[MFT_InvertRoughness])
       meta->addStatement(new GenOp("   @ = 1.0-@;\r\n", roughness, roughness));
    meta->addStatement(new GenOp("   @.a = @;\r\n", ormConfig, metalness));
-   output = meta;
+   setOutput( meta );
 }
 
 U32 GlowMapHLSL::getOutputTargets(const MaterialFeatureData& fd) const
@@ -264,16 +264,16 @@ void GlowMapHLSL::processPix(Vector<ShaderComponent*> &componentList, const Mate
          targ->setType("fragout");
          targ->setName(getOutputTargetVarName(ShaderFeature::RenderTarget3));
          targ->setStructName("OUT");
-         output = new GenOp("@ = float4(@.rgb*@,0);", targ, texOp, glowMul);
+         setOutput( new GenOp("@ = float4(@.rgb*@,0);", targ, texOp, glowMul) );
       }
       else
       {
-         output = new GenOp("@ += float4(@.rgb*@,0);", targ, texOp, glowMul);
+         setOutput( new GenOp("@ += float4(@.rgb*@,0);", targ, texOp, glowMul) );
       }
    }
    else
    {
-      output = new GenOp("@ += float4(@.rgb*@,@.a);", targ, texOp, glowMul, targ);
+      setOutput( new GenOp("@ += float4(@.rgb*@,@.a);", targ, texOp, glowMul, targ) );
    }
 
 }
@@ -88,7 +88,7 @@ void GBufferConditionerHLSL::processVert( Vector<ShaderComponent*> &componentLis
       return;
 
    MultiLine *meta = new MultiLine;
-   output = meta;
+   setOutput( meta );
 
    // grab incoming vert normal
    Var *inNormal = (Var*) LangElement::find( "normal" );
@@ -114,8 +114,9 @@ void GBufferConditionerHLSL::processVert( Vector<ShaderComponent*> &componentLis
       // TODO: Total hack because Conditioner is directly derived
       // from ShaderFeature and not from ShaderFeatureHLSL.
       NamedFeatureHLSL dummy( String::EmptyString );
-      dummy.setInstancingFormat( mInstancingFormat );
+      dummy.setInstancingFormat( getInstancingFormat() );
       Var *worldViewOnly = dummy.getWorldView( componentList, fd.features[MFT_UseInstancing], meta );
+      dummy.reset();
 
       meta->addStatement(  new GenOp("   @ = mul(@, float4( normalize(@), 0.0 ) ).xyz;\r\n", 
                               outNormal, worldViewOnly, inNormal ) );
@@ -189,7 +190,7 @@ void GBufferConditionerHLSL::processPix(  Vector<ShaderComponent*> &componentLis
       meta->addStatement( new GenOp( "   @.ba = float2( 0, @ ); // MFT_IsTranslucentZWrite\r\n", targ, alphaVal ) );
    }
 
-   output = meta;
+   setOutput( meta );
 }
 
 ShaderFeature::Resources GBufferConditionerHLSL::getResources( const MaterialFeatureData &fd )
@@ -0,0 +1,295 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2014 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "lighting/advanced/clusteredLightGrid.h"
+#include "math/mRandom.h"
+#include "math/util/frustum.h"
+#include "console/console.h"
+
+extern void m_sphere_overlap_box3F_soa_C(const F32 *sphere,
+                                         const F32 *minX, const F32 *minY, const F32 *minZ,
+                                         const F32 *maxX, const F32 *maxY, const F32 *maxZ,
+                                         U32 numBoxes, U8 *results);
+
+extern void m_cone_overlap_sphere_soa_C(const F32 *cone,
+                                        const F32 *x, const F32 *y, const F32 *z, const F32 *radius,
+                                        U32 numSpheres, U8 *results);
+
+FIXTURE(ClusteredLightGrid)
+{
+public:
+   Frustum frusta[2];
+
+   void SetUp()
+   {
+      // A typical game camera and an orthographic one.
+      MatrixF xfm(true);
+      frusta[0].set(false, mDegToRad(90.f), 16.f / 9.f, 0.1f, 1000.f, xfm);
+      frusta[1].set(true, -100.f, 100.f, 50.f, -50.f, 1.f, 500.f, xfm);
+   }
+
+   /// Adds lights scattered through the view, a quarter of them spots.
+   void addLights(ClusteredLightGrid &grid, U32 count, F32 farDist, U32 seed)
+   {
+      MRandomLCG random(seed);
+      for (U32 i = 0; i < count; i++)
+      {
+         const F32 depth = random.randF(0.f, farDist * 0.5f);
+         const Point3F pos(random.randF(-depth, depth), depth, random.randF(-depth * 0.5f, depth * 0.5f));
+         const F32 range = random.randF(1.f, 30.f);
+
+         if (i % 4 == 3)
+         {
+            VectorF dir(random.randF(-1.f, 1.f), random.randF(-1.f, 1.f), random.randF(-1.f, 1.f));
+            if (dir.isZero())
+               dir.set(0.f, 1.f, 0.f);
+            grid.addSpotLight(pos, range, dir, mDegToRad(random.randF(5.f, 80.f)));
+         }
+         else
+            grid.addPointLight(pos, range);
+      }
+   }
+
+   /// Returns true if the light touches the bounds of the cluster.
+   static bool touchesBounds(const ClusteredLightGrid &grid, U32 cluster, const ClusteredLightGrid::Light &light)
+   {
+      const Box3F box = grid.getClusterBounds().get(cluster);
+      const Point3F closest = box.getClosestPoint(light.position);
+      return (closest - light.position).lenSquared() <= light.range * light.range;
+   }
+
+   /// Returns true if the light reaches the point.
+   static bool lights(const ClusteredLightGrid::Light &light, const Point3F &pt)
+   {
+      const VectorF toPt = pt - light.position;
+      const F32 dist = toPt.len();
+      if (dist > light.range)
+         return false;
+
+      return !light.isSpot || mDot(toPt, light.direction) >= dist * light.cosHalfAngle;
+   }
+
+   /// Returns the cluster holding a point in the view.
+   static U32 findCluster(const ClusteredLightGrid &grid, const Frustum &frustum, const Point3F &pt)
+   {
+      const F32 scale = frustum.isOrtho() ? 1.f : frustum.getNearDist() / pt.y;
+      const F32 u = (pt.x * scale - frustum.getNearLeft()) / (frustum.getNearRight() - frustum.getNearLeft());
+      const F32 v = (frustum.getNearTop() - pt.z * scale) / (frustum.getNearTop() - frustum.getNearBottom());
+
+      const U32 x = mClamp((S32)(u * grid.getTilesX()), 0, (S32)grid.getTilesX() - 1);
+      const U32 y = mClamp((S32)(v * grid.getTilesY()), 0, (S32)grid.getTilesY() - 1);
+      return grid.getClusterIndex(x, y, grid.getSlice(pt.y));
+   }
+};
+
+TEST_FIX(ClusteredLightGrid, Bounds)
+{
+   ClusteredLightGrid grid;
+   grid.setDimensions(16, 8, 24);
+   grid.setFrustum(frusta[0]);
+
+   EXPECT_EQ(grid.getClusterBounds().size(), grid.getClusterCount());
+
+   // The slices cover the whole depth range.
+   EXPECT_FLOAT_EQ(grid.getSliceDepth(0), 0.1f);
+   EXPECT_FLOAT_EQ(grid.getSliceDepth(24), 1000.f);
+   EXPECT_EQ(grid.getSlice(0.05f), 0);
+   EXPECT_EQ(grid.getSlice(2000.f), 23);
+
+   for (U32 i = 0; i < 24; i++)
+      EXPECT_EQ(grid.getSlice((grid.getSliceDepth(i) + grid.getSliceDepth(i + 1)) * 0.5f), i);
+
+   // The first cluster is in the top left of the nearest slice.
+   const Box3F first = grid.getClusterBounds().get(0);
+   EXPECT_FLOAT_EQ(first.minExtents.x, frusta[0].getNearLeft() * grid.getSliceDepth(1) / 0.1f);
+   EXPECT_FLOAT_EQ(first.minExtents.y, 0.1f);
+   EXPECT_GT(first.maxExtents.z, 0.f);
+}
+
+TEST_FIX(ClusteredLightGrid, Conservative)
+{
+   for (U32 f = 0; f < 2; f++)
+   {
+      const Frustum &frustum = frusta[f];
+
+      ClusteredLightGrid grid;
+      grid.setDimensions(16, 8, 24);
+      grid.setMaxLightsPerCluster(U32_MAX);
+      grid.setFrustum(frustum);
+
+      addLights(grid, 500, frustum.getFarDist(), 1376312589 + f);
+      grid.bin();
+
+      EXPECT_EQ(grid.getDroppedCount(), 0);
+
+      // Every light in a cluster touches its bounds and
+      // the lights are in the order they were added.
+      const Vector<U32> &indices = grid.getLightIndices();
+      for (U32 c = 0; c < grid.getClusterCount(); c++)
+      {
+         const U32 offset = grid.getClusterOffset(c);
+         for (U32 i = 0; i < grid.getClusterLightCount(c); i++)
+         {
+            EXPECT_TRUE(touchesBounds(grid, c, grid.getLight(indices[offset + i])));
+            if (i > 0)
+               EXPECT_LT(indices[offset + i - 1], indices[offset + i]);
+         }
+      }
+
+      // Every light reaching a point is in the cluster holding it.
+      MRandomLCG random(1376312589);
+      for (U32 p = 0; p < 2000; p++)
+      {
+         const U32 l = random.randI(0, grid.getLightCount() - 1);
+         const ClusteredLightGrid::Light &light = grid.getLight(l);
+
+         const Point3F pt = light.position + Point3F(random.randF(-1.f, 1.f), random.randF(-1.f, 1.f), random.randF(-1.f, 1.f)) * light.range;
+         if (!lights(light, pt))
+            continue;
+
+         // Skip points off the screen.
+         const F32 scale = frustum.isOrtho() ? 1.f : frustum.getNearDist() / pt.y;
+         if (  pt.y < frustum.getNearDist() || pt.y > frustum.getFarDist() ||
+               pt.x * scale < frustum.getNearLeft() || pt.x * scale > frustum.getNearRight() ||
+               pt.z * scale < frustum.getNearBottom() || pt.z * scale > frustum.getNearTop())
+            continue;
+
+         const U32 c = findCluster(grid, frustum, pt);
+         const U32 offset = grid.getClusterOffset(c);
+
+         bool found = false;
+         for (U32 i = 0; i < grid.getClusterLightCount(c) && !found; i++)
+            found = indices[offset + i] == l;
+
+         EXPECT_TRUE(found) << "Frustum " << f << " light " << l << " cluster " << c;
+      }
+   }
+}
+
+TEST_FIX(ClusteredLightGrid, MaxLightsPerCluster)
+{
+   ClusteredLightGrid grid;
+   grid.setDimensions(4, 4, 4);
+   grid.setMaxLightsPerCluster(2);
+   grid.setFrustum(frusta[0]);
+
+   // Four lights covering everything; the first two are kept.
+   for (U32 i = 0; i < 4; i++)
+      grid.addPointLight(Point3F(0.f, 10.f, 0.f), 5000.f);
+   grid.bin();
+
+   EXPECT_EQ(grid.getDroppedCount(), grid.getClusterCount() * 2);
+   EXPECT_EQ(grid.getLightIndices().size(), grid.getClusterCount() * 2);
+
+   for (U32 c = 0; c < grid.getClusterCount(); c++)
+   {
+      EXPECT_EQ(grid.getClusterLightCount(c), 2);
+      EXPECT_EQ(grid.getLightIndices()[grid.getClusterOffset(c)], 0);
+      EXPECT_EQ(grid.getLightIndices()[grid.getClusterOffset(c) + 1], 1);
+   }
+
+   // A light behind the camera touches nothing.
+   grid.clearLights();
+   grid.addPointLight(Point3F(0.f, -50.f, 0.f), 10.f);
+   grid.bin();
+
+   EXPECT_TRUE(grid.getLightIndices().empty());
+}
+
+TEST_FIX(ClusteredLightGrid, BatchedTestsMatchC)
+{
+   // Compare whichever versions are installed with the C ones.
+   MRandomLCG random(1376312589);
+
+   const U32 count = 1003;
+   Vector<F32> minX, minY, minZ, maxX, maxY, maxZ, radius;
+   for (U32 i = 0; i < count; i++)
+   {
+      const Point3F center(random.randF(-50.f, 50.f), random.randF(-50.f, 50.f), random.randF(-50.f, 50.f));
+      const Point3F extents(random.randF(0.1f, 10.f), random.randF(0.1f, 10.f), random.randF(0.1f, 10.f));
+      minX.push_back(center.x - extents.x);
+      minY.push_back(center.y - extents.y);
+      minZ.push_back(center.z - extents.z);
+      maxX.push_back(center.x + extents.x);
+      maxY.push_back(center.y + extents.y);
+      maxZ.push_back(center.z + extents.z);
+      radius.push_back(extents.len());
+   }
+
+   Vector<U8> results, resultsC;
+   results.setSize(count);
+   resultsC.setSize(count);
+
+   for (U32 n = 0; n < 20; n++)
+   {
+      const F32 sphere[4] = { random.randF(-50.f, 50.f), random.randF(-50.f, 50.f), random.randF(-50.f, 50.f), random.randF(1.f, 30.f) };
+
+      m_sphere_overlap_box3F_soa(sphere, minX.address(), minY.address(), minZ.address(),
+                                 maxX.address(), maxY.address(), maxZ.address(), count, results.address());
+      m_sphere_overlap_box3F_soa_C(sphere, minX.address(), minY.address(), minZ.address(),
+                                   maxX.address(), maxY.address(), maxZ.address(), count, resultsC.address());
+
+      for (U32 i = 0; i < count; i++)
+         EXPECT_EQ(results[i], resultsC[i]) << "Sphere " << n << " box " << i;
+
+      VectorF dir(random.randF(-1.f, 1.f), random.randF(-1.f, 1.f), random.randF(-1.f, 1.f));
+      dir.normalizeSafe();
+      F32 sinAngle, cosAngle;
+      mSinCos(mDegToRad(random.randF(5.f, 80.f)), sinAngle, cosAngle);
+      const F32 cone[9] = { sphere[0], sphere[1], sphere[2], dir.x, dir.y, dir.z, sphere[3] * 2.f, cosAngle, sinAngle };
+
+      // The box centers are reused as the sphere centers.
+      m_cone_overlap_sphere_soa(cone, minX.address(), minY.address(), minZ.address(), radius.address(), count, results.address());
+      m_cone_overlap_sphere_soa_C(cone, minX.address(), minY.address(), minZ.address(), radius.address(), count, resultsC.address());
+
+      for (U32 i = 0; i < count; i++)
+         EXPECT_EQ(results[i], resultsC[i]) << "Cone " << n << " sphere " << i;
+   }
+}
+
+TEST_FIX(ClusteredLightGrid, StressTestBinning)
+{
+   // Binning time for 1k, 4k and 10k lights.
+
+   const U32 lightCounts[] = { 1000, 4000, 10000 };
+   const U32 numIterations = 10;
+
+   for (U32 n = 0; n < 3; n++)
+   {
+      ClusteredLightGrid grid;
+      grid.setFrustum(frusta[0]);
+      addLights(grid, lightCounts[n], 200.f, 1376312589);
+
+      const U32 start = Platform::getRealMilliseconds();
+      for (U32 i = 0; i < numIterations; i++)
+         grid.bin();
+      const U32 elapsed = Platform::getRealMilliseconds() - start;
+
+      Con::printf("ClusteredLightGrid: %d lights into %d clusters: %.2fms per frame, %d assignments, %d dropped",
+         lightCounts[n], grid.getClusterCount(), F32(elapsed) / numIterations,
+         grid.getLightIndices().size(), grid.getDroppedCount());
+   }
+}
+
+#endif
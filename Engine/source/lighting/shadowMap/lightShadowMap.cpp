@@ -43,6 +43,9 @@
 #include "math/mathIO.h"
 #include "materials/shaderData.h"
 #include "core/module.h"
+#include "gfx/gfxTransformSaver.h"
+#include "gfx/gfxVertexTypes.h"
+#include "T3D/objectTypes.h"
 
 // Used for creation in ShadowMapParams::getOrCreateShadowMap()
 #include "lighting/shadowMap/singleLightShadowMap.h"
@@ -50,6 +53,8 @@
 #include "lighting/shadowMap/cubeLightShadowMap.h"
 #include "lighting/shadowMap/dualParaboloidLightShadowMap.h"
 
+extern bool gEditingMission;
+
 // Remove this when the shader constants are reworked better
 #include "lighting/advanced/advancedLightManager.h"
 #include "lighting/advanced/advancedLightBinManager.h"
@@ -61,6 +66,9 @@ const GFXFormat LightShadowMap::ShadowMapFormat = GFXFormatR32F; // GFXFormatR8G
 
 bool LightShadowMap::smDebugRenderFrustums;
 F32 LightShadowMap::smShadowTexScalar = 1.0f;
+bool LightShadowMap::smCacheStaticShadows = false;
+U32 LightShadowMap::smStaticPassUpdates = 0;
+U32 LightShadowMap::smStaticPassHits = 0;
 
 Vector<LightShadowMap*> LightShadowMap::smUsedShadowMaps;
 Vector<LightShadowMap*> LightShadowMap::smShadowMaps;
@@ -89,7 +97,9 @@ LightShadowMap::LightShadowMap( LightInfo *light )
       mIsViewDependent( false ),
       mLastCull( 0 ),
       mLastScreenSize( 0.0f ),
-      mLastPriority( 0.0f )
+      mLastPriority( 0.0f ),
+      mStaticCacheUsed( false ),
+      mWatchingChanges( false )
 {
    GFXTextureManager::addEventDelegate( this, &LightShadowMap::_onTextureEvent );
 
@@ -100,9 +110,12 @@ LightShadowMap::LightShadowMap( LightInfo *light )
 LightShadowMap::~LightShadowMap()
 {
    mTarget = NULL;
+   mStaticTarget = NULL;
 
    releaseTextures();
 
+   _watchObjectChanges( false );
+
    smShadowMaps.remove( this );
    smUsedShadowMaps.remove( this );
 
@@ -239,6 +252,8 @@ void LightShadowMap::calcLightMatrices( MatrixF &outLightMatrix, const Frustum &
 void LightShadowMap::releaseTextures()
 {
    mShadowMapTex = NULL;
+   mStaticShadowMapTex = NULL;
+   mStaticCache.clear();
    mDebugTarget.setTexture( NULL );
    smUsedShadowMaps.remove( this );
 }
@@ -291,7 +306,18 @@ bool LightShadowMap::setTextureStage( U32 currTexFlag, LightingShaderConstants*
 void LightShadowMap::render(RenderPassManager* renderPass, const SceneRenderState *diffuseState)
 {
    mDebugTarget.setTexture( NULL );
+
+   mStaticCacheUsed = false;
+   if ( smCacheStaticShadows != mWatchingChanges )
+      _watchObjectChanges( smCacheStaticShadows );
+   if ( smCacheStaticShadows )
+      _updateStaticBounds();
+
    _render( renderPass, diffuseState );
+
+   if ( mStaticCacheUsed )
+      _compositeStatic();
+
    mDebugTarget.setTexture( mShadowMapTex );
 
    // Add it to the used list unless we're been updated.
@@ -300,6 +326,196 @@ void LightShadowMap::render(RenderPassManager* renderPass, const SceneRenderStat
       smUsedShadowMaps.push_back( this );
 }
 
+void LightShadowMap::_renderCasters(  SceneRenderState *state, 
+                                       U32 objectMask, 
+                                       GFXTextureObject *depthTarget,
+                                       U32 pass )
+{
+   SceneManager *sceneManager = state->getSceneManager();
+
+   // The editor changes objects in ways the scene is not
+   // always told about, so don't trust the cache while editing.
+   if ( !smCacheStaticShadows || gEditingMission || !depthTarget || mShadowMapTex.isNull() )
+   {
+      sceneManager->renderSceneNoLights( state, objectMask );
+      return;
+   }
+
+   PROFILE_SCOPE( LightShadowMap_renderCasters );
+
+   const MatrixF worldToProj = GFX->getProjectionMatrix() * GFX->getWorldMatrix();
+   const RectI viewport = GFX->getViewport();
+
+   if (  mStaticShadowMapTex.isNull() ||
+         mStaticShadowMapTex->getWidth() != mShadowMapTex->getWidth() ||
+         mStaticShadowMapTex->getHeight() != mShadowMapTex->getHeight() )
+   {
+      mStaticShadowMapTex.set(   mShadowMapTex->getWidth(), mShadowMapTex->getHeight(), 
+                                 ShadowMapFormat, &ShadowMapProfile, 
+                                 "LightShadowMap::mStaticShadowMapTex" );
+      mStaticCache.clear();
+
+      if ( mStaticTarget.isNull() )
+         mStaticTarget = GFX->allocRenderToTextureTarget();
+
+      // Start with nothing cached in the areas no pass covers.
+      GFX->pushActiveRenderTarget();
+      mStaticTarget->attachTexture( GFXTextureTarget::Color0, mStaticShadowMapTex );
+      mStaticTarget->attachTexture( GFXTextureTarget::DepthStencil, NULL );
+      GFX->setActiveRenderTarget( mStaticTarget );
+      GFX->clear( GFXClearTarget, ColorI::WHITE, 1.0f, 0 );
+      GFX->popActiveRenderTarget();
+      GFX->setViewport( viewport );
+   }
+
+   SceneRenderState::ObjectFilterDelegate &filter = state->getObjectFilterDelegate();
+
+   if ( mStaticCache.needsUpdate( pass, worldToProj, viewport ) )
+   {
+      PROFILE_SCOPE( LightShadowMap_renderStaticCasters );
+
+      // Render the static casters into the cache sharing the depth 
+      // buffer with the shadow map so that the dynamic casters 
+      // they hide are rejected below.
+      GFX->pushActiveRenderTarget();
+      mStaticTarget->attachTexture( GFXTextureTarget::Color0, mStaticShadowMapTex );
+      mStaticTarget->attachTexture( GFXTextureTarget::DepthStencil, depthTarget );
+      GFX->setActiveRenderTarget( mStaticTarget, false );
+      GFX->setViewport( viewport );
+
+      _clearStaticViewport();
+
+      filter.bind( &StaticShadowCache::filterStaticCasters );
+      sceneManager->renderSceneNoLights( state, objectMask );
+
+      mStaticTarget->resolve();
+      GFX->popActiveRenderTarget();
+      GFX->setViewport( viewport );
+
+      mStaticCache.markUpdated( pass, worldToProj, viewport );
+      ++smStaticPassUpdates;
+   }
+   else
+      ++smStaticPassHits;
+
+   filter.bind( &StaticShadowCache::filterDynamicCasters );
+   sceneManager->renderSceneNoLights( state, objectMask );
+   filter.clear();
+
+   mStaticCacheUsed = true;
+}
+
+static void _drawClipSpaceQuad( const GFXStateBlockDesc &desc, GFXTextureObject *tex )
+{
+   GFXTransformSaver saver;
+   GFX->setWorldMatrix( MatrixF::Identity );
+   GFX->setViewMatrix( MatrixF::Identity );
+   GFX->setProjectionMatrix( MatrixF::Identity );
+
+   GFXVertexBufferHandle<GFXVertexPCT> verts( GFX, 4, GFXBufferTypeVolatile );
+   GFXVertexPCT *vert = verts.lock();
+   vert[0].point.set( -1.0f, 1.0f, 0.0f );
+   vert[0].texCoord.set( 0.0f, 0.0f );
+   vert[0].color = ColorI::WHITE;
+   vert[1].point.set( 1.0f, 1.0f, 0.0f );
+   vert[1].texCoord.set( 1.0f, 0.0f );
+   vert[1].color = ColorI::WHITE;
+   vert[2].point.set( -1.0f, -1.0f, 0.0f );
+   vert[2].texCoord.set( 0.0f, 1.0f );
+   vert[2].color = ColorI::WHITE;
+   vert[3].point.set( 1.0f, -1.0f, 0.0f );
+   vert[3].texCoord.set( 1.0f, 1.0f );
+   vert[3].color = ColorI::WHITE;
+   verts.unlock();
+
+   GFX->setStateBlockByDesc( desc );
+   if ( tex )
+   {
+      GFX->setTexture( 0, tex );
+      GFX->setupGenericShaders( GFXDevice::GSTexture );
+   }
+   else
+      GFX->setupGenericShaders( GFXDevice::GSColor );
+
+   GFX->setVertexBuffer( verts );
+   GFX->drawPrimitive( GFXTriangleStrip, 0, 2 );
+}
+
+void LightShadowMap::_clearStaticViewport()
+{
+   // A clear of the target would wipe the other passes
+   // on some devices, so fill the viewport instead.
+   GFXStateBlockDesc desc;
+   desc.setZReadWrite( false, false );
+   desc.setCullMode( GFXCullNone );
+
+   _drawClipSpaceQuad( desc, NULL );
+}
+
+void LightShadowMap::_compositeStatic()
+{
+   PROFILE_SCOPE( LightShadowMap_compositeStatic );
+
+   // The shadow map stores depth, so the closest of the
+   // static and dynamic casters wins.
+   GFXStateBlockDesc desc;
+   desc.setZReadWrite( false, false );
+   desc.setCullMode( GFXCullNone );
+   desc.setBlend( true, GFXBlendOne, GFXBlendOne, GFXBlendOpMin );
+   desc.samplersDefined = true;
+   desc.samplers[0] = GFXSamplerStateDesc::getClampPoint();
+
+   GFX->pushActiveRenderTarget();
+   mTarget->attachTexture( GFXTextureTarget::Color0, mShadowMapTex );
+   mTarget->attachTexture( GFXTextureTarget::DepthStencil, NULL );
+   GFX->setActiveRenderTarget( mTarget );
+
+   _drawClipSpaceQuad( desc, mStaticShadowMapTex );
+
+   mTarget->resolve();
+   GFX->popActiveRenderTarget();
+}
+
+void LightShadowMap::_updateStaticBounds()
+{
+   if ( mLight->getType() == LightInfo::Vector )
+   {
+      mStaticCache.setUnbounded();
+      return;
+   }
+
+   const Point3F &pos = mLight->getPosition();
+   const F32 range = mLight->getRange().x;
+   mStaticCache.setBounds( Box3F( pos - Point3F( range, range, range ), pos + Point3F( range, range, range ) ) );
+}
+
+void LightShadowMap::_onObjectChanged( SceneObject *object, const Box3F &worldBox )
+{
+   if (  !smCacheStaticShadows ||
+         !object->isClientObject() ||
+         !StaticShadowCache::isStaticCaster( object->getTypeMask() ) )
+      return;
+
+   if ( mStaticCache.overlaps( worldBox ) )
+      mStaticCache.invalidate();
+}
+
+void LightShadowMap::_watchObjectChanges( bool watch )
+{
+   if ( watch == mWatchingChanges )
+      return;
+
+   mWatchingChanges = watch;
+   if ( watch )
+   {
+      // Changes were missed while we weren't listening.
+      mStaticCache.invalidate();
+      SceneManager::getObjectChangeSignal().notify( this, &LightShadowMap::_onObjectChanged );
+   }
+   else
+      SceneManager::getObjectChangeSignal().remove( this, &LightShadowMap::_onObjectChanged );
+}
+
 BaseMatInstance* LightShadowMap::getShadowMaterial( BaseMatInstance *inMat ) const
 {
    // See if we have an existing material hook.
@@ -458,6 +674,31 @@ LightingShaderConstants::~LightingShaderConstants()
    }
 }
 
+// The shadow constants interned once so that
+// LightingShaderConstants::init doesn't hash the names.
+namespace
+{
+   const GFXShaderConstId sLightParamsId( "$lightParams" );
+   const GFXShaderConstId sLightSpotParamsId( "$lightSpotParams" );
+   const GFXShaderConstId sShadowMapId( "$shadowMap" );
+   const GFXShaderConstId sShadowMapSizeId( "$shadowMapSize" );
+   const GFXShaderConstId sCookieMapId( "$cookieMap" );
+   const GFXShaderConstId sShadowSoftnessId( "$shadowSoftness" );
+   const GFXShaderConstId sAtlasXOffsetId( "$atlasXOffset" );
+   const GFXShaderConstId sAtlasYOffsetId( "$atlasYOffset" );
+   const GFXShaderConstId sAtlasScaleId( "$atlasScale" );
+   const GFXShaderConstId sFadeStartLengthId( "$fadeStartLength" );
+   const GFXShaderConstId sOverDarkPSSMId( "$overDarkPSSM" );
+   const GFXShaderConstId sTapRotationTexId( "$gTapRotationTex" );
+   const GFXShaderConstId sWorldToLightProjId( "$worldToLightProj" );
+   const GFXShaderConstId sViewToLightProjId( "$viewToLightProj" );
+   const GFXShaderConstId sScaleXId( "$scaleX" );
+   const GFXShaderConstId sScaleYId( "$scaleY" );
+   const GFXShaderConstId sOffsetXId( "$offsetX" );
+   const GFXShaderConstId sOffsetYId( "$offsetY" );
+   const GFXShaderConstId sFarPlaneScalePSSMId( "$farPlaneScalePSSM" );
+}
+
 void LightingShaderConstants::init(GFXShader* shader)
 {
    if (mShader.getPointer() != shader)
@@ -469,8 +710,8 @@ void LightingShaderConstants::init(GFXShader* shader)
       mShader->getReloadSignal().notify( this, &LightingShaderConstants::_onShaderReload );
    }
 
-   mLightParamsSC = shader->getShaderConstHandle("$lightParams");
-   mLightSpotParamsSC = shader->getShaderConstHandle("$lightSpotParams");
+   mLightParamsSC = shader->getShaderConstHandle(sLightParamsId);
+   mLightSpotParamsSC = shader->getShaderConstHandle(sLightSpotParamsId);
 
    // NOTE: These are the shader constants used for doing lighting 
    // during the forward pass.  Do not confuse these for the deferred
@@ -486,27 +727,27 @@ void LightingShaderConstants::init(GFXShader* shader)
    mVectorLightColorSC = shader->getShaderConstHandle(ShaderGenVars::vectorLightColor);
    mVectorLightBrightnessSC = shader->getShaderConstHandle(ShaderGenVars::vectorLightBrightness);
 
-   mShadowMapSC = shader->getShaderConstHandle("$shadowMap");
-   mShadowMapSizeSC = shader->getShaderConstHandle("$shadowMapSize");
+   mShadowMapSC = shader->getShaderConstHandle(sShadowMapId);
+   mShadowMapSizeSC = shader->getShaderConstHandle(sShadowMapSizeId);
 
-   mCookieMapSC = shader->getShaderConstHandle("$cookieMap");
+   mCookieMapSC = shader->getShaderConstHandle(sCookieMapId);
 
-   mShadowSoftnessConst = shader->getShaderConstHandle("$shadowSoftness");
-   mAtlasXOffsetSC = shader->getShaderConstHandle("$atlasXOffset");
-   mAtlasYOffsetSC = shader->getShaderConstHandle("$atlasYOffset");
-   mAtlasScaleSC = shader->getShaderConstHandle("$atlasScale");
+   mShadowSoftnessConst = shader->getShaderConstHandle(sShadowSoftnessId);
+   mAtlasXOffsetSC = shader->getShaderConstHandle(sAtlasXOffsetId);
+   mAtlasYOffsetSC = shader->getShaderConstHandle(sAtlasYOffsetId);
+   mAtlasScaleSC = shader->getShaderConstHandle(sAtlasScaleId);
 
-   mFadeStartLength = shader->getShaderConstHandle("$fadeStartLength");
-   mOverDarkFactorPSSM = shader->getShaderConstHandle("$overDarkPSSM");
-   mTapRotationTexSC = shader->getShaderConstHandle( "$gTapRotationTex" );
+   mFadeStartLength = shader->getShaderConstHandle(sFadeStartLengthId);
+   mOverDarkFactorPSSM = shader->getShaderConstHandle(sOverDarkPSSMId);
+   mTapRotationTexSC = shader->getShaderConstHandle( sTapRotationTexId );
 
-   mWorldToLightProjSC = shader->getShaderConstHandle("$worldToLightProj");
-   mViewToLightProjSC = shader->getShaderConstHandle("$viewToLightProj");
-   mScaleXSC = shader->getShaderConstHandle("$scaleX");
-   mScaleYSC = shader->getShaderConstHandle("$scaleY");
-   mOffsetXSC = shader->getShaderConstHandle("$offsetX");
-   mOffsetYSC = shader->getShaderConstHandle("$offsetY");
-   mFarPlaneScalePSSM = shader->getShaderConstHandle("$farPlaneScalePSSM");
+   mWorldToLightProjSC = shader->getShaderConstHandle(sWorldToLightProjId);
+   mViewToLightProjSC = shader->getShaderConstHandle(sViewToLightProjId);
+   mScaleXSC = shader->getShaderConstHandle(sScaleXId);
+   mScaleYSC = shader->getShaderConstHandle(sScaleYId);
+   mOffsetXSC = shader->getShaderConstHandle(sOffsetXId);
+   mOffsetYSC = shader->getShaderConstHandle(sOffsetYId);
+   mFarPlaneScalePSSM = shader->getShaderConstHandle(sFarPlaneScalePSSMId);
 
    mInit = true;
 }
@@ -53,6 +53,9 @@
 #ifndef _PLATFORM_PLATFORMTIMER_H_
 #include "platform/platformTimer.h"
 #endif
+#ifndef _STATICSHADOWCACHE_H_
+#include "lighting/shadowMap/staticShadowCache.h"
+#endif
 
 class ShadowMapManager;
 class SceneManager;
@@ -148,6 +151,16 @@ public:
    /// rendering enabled.
    static bool smDebugRenderFrustums;
 
+   /// If true the static casters are rendered into a cached
+   /// texture which is only refreshed when the light or the
+   /// static objects within its range change.
+   static bool smCacheStaticShadows;
+
+   /// The number of shadow passes which had to render their
+   /// static casters and the number which reused the cache.
+   static U32 smStaticPassUpdates;
+   static U32 smStaticPassHits;
+
 public:
 
    LightShadowMap( LightInfo *light );
@@ -222,6 +235,38 @@ protected:
    virtual void _render(   RenderPassManager* renderPass,
                            const SceneRenderState *diffuseState ) = 0;
 
+   /// Renders the casters of one shadow pass into the active target
+   /// using the current transforms and viewport.  When static shadow
+   /// caching is enabled the static casters are only rendered into
+   /// the cache when it is out of date and the dynamic casters are
+   /// rendered every time.
+   ///
+   /// @param state       The shadow render state for the pass.
+   /// @param objectMask  The object types which cast shadows.
+   /// @param depthTarget The depth buffer attached to mTarget.
+   /// @param pass        The index of the pass within this shadow map.
+   void _renderCasters( SceneRenderState *state, 
+                        U32 objectMask, 
+                        GFXTextureObject *depthTarget,
+                        U32 pass );
+
+   /// Clears the viewport of the static cache texture.
+   void _clearStaticViewport();
+
+   /// Merges the cached static casters into the shadow map.
+   void _compositeStatic();
+
+   /// Updates the static cache bounds from the light.
+   void _updateStaticBounds();
+
+   /// Invalidates the static cache when a static caster
+   /// within the light bounds changes.
+   void _onObjectChanged( SceneObject *object, const Box3F &worldBox );
+
+   /// Starts or stops listening for object changes so that
+   /// maps only pay for the signal while caching is enabled.
+   void _watchObjectChanges( bool watch );
+
    /// If there is a LightDebugInfo attached to the light that owns this map,
    /// then update its information from the given render state.
    ///
@@ -249,6 +294,19 @@ protected:
    GFXTexHandle mShadowMapTex;
    GFXTexHandle mShadowMapDepth;
 
+   /// The cached static casters and the state used to render them.
+   /// @see smCacheStaticShadows
+   GFXTexHandle mStaticShadowMapTex;
+   GFXTextureTargetRef mStaticTarget;
+   StaticShadowCache mStaticCache;
+
+   /// Set when passes rendered with the cache this frame so
+   /// that the static layer is composited after _render().
+   bool mStaticCacheUsed;
+
+   /// True while subscribed to the scene object change signal.
+   bool mWatchingChanges;
+
    // The light we are rendering.
    LightInfo *mLight;   
 
@@ -109,9 +109,9 @@ void ParaboloidLightShadowMap::_render(   RenderPassManager* renderPass,
    GFX->setOrtho(-lightRadius, lightRadius, -lightRadius, lightRadius, 1.0f, lightRadius, true);
 
    // Set up target
+   GFXTextureObject *depthTarget = _getDepthTarget( mShadowMapTex->getWidth(), mShadowMapTex->getHeight() );
    mTarget->attachTexture( GFXTextureTarget::Color0, mShadowMapTex );
-   mTarget->attachTexture( GFXTextureTarget::DepthStencil, 
-      _getDepthTarget( mShadowMapTex->getWidth(), mShadowMapTex->getHeight() ) );
+   mTarget->attachTexture( GFXTextureTarget::DepthStencil, depthTarget );
    GFX->setActiveRenderTarget(mTarget);
    GFX->clear(GFXClearTarget | GFXClearStencil | GFXClearZBuffer, ColorI(255,255,255,255), 1.0f, 0);
 
@@ -132,7 +132,7 @@ void ParaboloidLightShadowMap::_render(   RenderPassManager* renderPass,
    shadowRenderState.setDiffuseCameraTransform( diffuseState->getCameraTransform() );
    shadowRenderState.setWorldToScreenScale( diffuseState->getWorldToScreenScale() );
 
-   sceneManager->renderSceneNoLights( &shadowRenderState, SHADOW_TYPEMASK );
+   _renderCasters( &shadowRenderState, SHADOW_TYPEMASK, depthTarget, 0 );
 
    _debugRender( &shadowRenderState );
  
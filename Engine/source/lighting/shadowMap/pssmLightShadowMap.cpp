@@ -380,7 +380,7 @@ void PSSMLightShadowMap::_render(   RenderPassManager* renderPass,
       if ( i == mNumSplits-1 && params->lastSplitTerrainOnly )
          objectMask = TerrainObjectType;
 
-      sceneManager->renderSceneNoLights( &shadowRenderState, objectMask );
+      _renderCasters( &shadowRenderState, objectMask, mShadowMapDepth, i );
 
       shadowRenderState.getCullingState().clearExtraPlanesCull();
 
@@ -68,6 +68,14 @@ AFTER_MODULE_INIT( Sim )
    Con::NotifyDelegate callabck( &LightShadowMap::releaseAllTextures );
    Con::addVariableNotify( "$pref::Shadows::textureScalar", callabck );
 
+   Con::addVariable( "$pref::Shadows::cacheStatic",
+      TypeBool, &LightShadowMap::smCacheStaticShadows,
+      "@brief Renders static shadow casters into a cached map which is only updated "
+      "when the light or the static objects within its range change.\n"
+      "Dynamic casters are still rendered every frame.  Cube map and dual paraboloid shadows are not cached.\n"
+      "@ingroup AdvancedLighting\n" );
+   Con::addVariableNotify( "$pref::Shadows::cacheStatic", callabck );
+
    Con::addVariable( "$pref::Shadows::disable", 
       TypeBool, &ShadowMapPass::smDisableShadowsPref,
       "Used to disable all shadow rendering.\n"
@@ -51,6 +51,12 @@ U32 ShadowMapPass::smShadowMapPolyCount = 0;
 U32 ShadowMapPass::smRenderTargetChanges = 0;
 U32 ShadowMapPass::smShadowPoolTexturesCount = 0.;
 F32 ShadowMapPass::smShadowPoolMemory = 0.0f;
+U32 ShadowMapPass::smShadowRenderInsts = 0;
+U32 ShadowMapPass::smStaticPassUpdates = 0;
+U32 ShadowMapPass::smStaticPassHits = 0;
+F32 ShadowMapPass::smShadowRenderMs = 0.0f;
+
+U32 ShadowRenderPassManager::smAddedInsts = 0;
 
 bool ShadowMapPass::smDisableShadows = false;
 bool ShadowMapPass::smDisableShadowsEditor = false;
@@ -115,6 +121,22 @@ ShadowMapPass::ShadowMapPass(LightManager* lightManager, ShadowMapManager* shado
    Con::addVariable( "$ShadowStats::poolTexMemory", TypeF32, &smShadowPoolMemory,
       "The shadow stats showing the approximate texture memory usage of the shadow map texture pool.\n"
       "@ingroup AdvancedLighting\n" );
+
+   Con::addVariable( "$ShadowStats::renderInsts", TypeS32, &smShadowRenderInsts,
+      "The shadow stats showing the number of render instances submitted to shadow map renders for this frame.\n"
+      "@ingroup AdvancedLighting\n" );
+
+   Con::addVariable( "$ShadowStats::staticUpdates", TypeS32, &smStaticPassUpdates,
+      "The shadow stats showing the number of shadow passes which rendered their static casters this frame.\n"
+      "@ingroup AdvancedLighting\n" );
+
+   Con::addVariable( "$ShadowStats::staticCached", TypeS32, &smStaticPassHits,
+      "The shadow stats showing the number of shadow passes which reused their cached static casters this frame.\n"
+      "@ingroup AdvancedLighting\n" );
+
+   Con::addVariable( "$ShadowStats::renderMs", TypeF32, &smShadowRenderMs,
+      "The shadow stats showing the CPU milliseconds spent rendering shadow maps this frame.\n"
+      "@ingroup AdvancedLighting\n" );
 }
 
 ShadowMapPass::~ShadowMapPass()
@@ -135,6 +157,9 @@ void ShadowMapPass::render(   SceneManager *sceneManager,
    smActiveShadowMaps = 0;
    smUpdatedShadowMaps = 0;
    smNearShadowMaps = 0;
+   ShadowRenderPassManager::smAddedInsts = 0;
+   LightShadowMap::smStaticPassUpdates = 0;
+   LightShadowMap::smStaticPassHits = 0;
    GFXDeviceStatistics stats;
    stats.start( GFX->getDeviceStatistics() );
 
@@ -243,6 +268,10 @@ void ShadowMapPass::render(   SceneManager *sceneManager,
    smRenderTargetChanges = stats.mRenderTargetChanges;
    smShadowPoolTexturesCount = ShadowMapProfile.getStats().activeCount;
    smShadowPoolMemory = ( ShadowMapProfile.getStats().activeBytes / 1024.0f ) / 1024.0f;
+   smShadowRenderInsts = ShadowRenderPassManager::smAddedInsts;
+   smStaticPassUpdates = LightShadowMap::smStaticPassUpdates;
+   smStaticPassHits = LightShadowMap::smStaticPassHits;
+   smShadowRenderMs = mTimer->getElapsedMs();
 
    // The NULL here is importaint as having it around
    // will cause extra work in AdvancedLightManager::setLightInfo().
@@ -268,5 +297,6 @@ void ShadowRenderPassManager::addInst( RenderInst *inst )
       }
    }
 
+   ++smAddedInsts;
    Parent::addInst(inst);
 }
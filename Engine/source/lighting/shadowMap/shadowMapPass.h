@@ -98,6 +98,10 @@ private:
    static U32 smRenderTargetChanges;
    static U32 smShadowPoolTexturesCount;
    static F32 smShadowPoolMemory;
+   static U32 smShadowRenderInsts;
+   static U32 smStaticPassUpdates;
+   static U32 smStaticPassHits;
+   static F32 smShadowRenderMs;
 
    /// The milliseconds alotted for shadow map updates
    /// on a per frame basis.
@@ -123,6 +127,10 @@ public:
 
    /// Add a RenderInstance to the list
    virtual void addInst( RenderInst *inst );
+
+   /// The number of render instances added since the
+   /// counter was last reset.
+   static U32 smAddedInsts;
 };
 
 #endif // _SHADOWMAPPASS_H_
@@ -76,9 +76,9 @@ void SingleLightShadowMap::_render( RenderPassManager* renderPass,
 
    // Render the shadowmap!
    GFX->pushActiveRenderTarget();
+   GFXTextureObject *depthTarget = _getDepthTarget( mShadowMapTex->getWidth(), mShadowMapTex->getHeight() );
    mTarget->attachTexture( GFXTextureTarget::Color0, mShadowMapTex );
-   mTarget->attachTexture( GFXTextureTarget::DepthStencil, 
-      _getDepthTarget( mShadowMapTex->getWidth(), mShadowMapTex->getHeight() ) );
+   mTarget->attachTexture( GFXTextureTarget::DepthStencil, depthTarget );
    GFX->setActiveRenderTarget(mTarget);
    GFX->clear(GFXClearStencil | GFXClearZBuffer | GFXClearTarget, ColorI(255,255,255), 1.0f, 0);
 
@@ -98,7 +98,7 @@ void SingleLightShadowMap::_render( RenderPassManager* renderPass,
    shadowRenderState.setDiffuseCameraTransform( diffuseState->getCameraTransform() );
    shadowRenderState.setWorldToScreenScale( diffuseState->getWorldToScreenScale() );
 
-   sceneManager->renderSceneNoLights( &shadowRenderState, SHADOW_TYPEMASK );
+   _renderCasters( &shadowRenderState, SHADOW_TYPEMASK, depthTarget, 0 );
 
    _debugRender( &shadowRenderState );
 
@@ -0,0 +1,100 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "lighting/shadowMap/staticShadowCache.h"
+
+#include "scene/sceneObject.h"
+#include "T3D/objectTypes.h"
+
+
+const U32 StaticShadowCache::DynamicCasterTypeMask = DynamicShapeObjectType | EntityObjectType;
+
+bool StaticShadowCache::isStaticCaster( U32 typeMask )
+{
+   return   ( typeMask & ( SHADOW_TYPEMASK | TerrainObjectType ) ) &&
+            ( typeMask & StaticObjectType ) && 
+            !( typeMask & DynamicCasterTypeMask );
+}
+
+bool StaticShadowCache::filterStaticCasters( SceneObject *object )
+{
+   return isStaticCaster( object->getTypeMask() );
+}
+
+bool StaticShadowCache::filterDynamicCasters( SceneObject *object )
+{
+   return !isStaticCaster( object->getTypeMask() );
+}
+
+StaticShadowCache::StaticShadowCache()
+   :  mBounds( Box3F::Invalid ),
+      mUnbounded( false )
+{
+}
+
+void StaticShadowCache::setBounds( const Box3F &bounds )
+{
+   mBounds = bounds;
+   mUnbounded = false;
+}
+
+void StaticShadowCache::setUnbounded()
+{
+   mUnbounded = true;
+}
+
+bool StaticShadowCache::overlaps( const Box3F &box ) const
+{
+   return mUnbounded || mBounds.isOverlapped( box );
+}
+
+void StaticShadowCache::invalidate()
+{
+   for ( U32 i = 0; i < mPasses.size(); i++ )
+      mPasses[i].valid = false;
+}
+
+bool StaticShadowCache::needsUpdate( U32 pass, const MatrixF &worldToProj, const RectI &viewport ) const
+{
+   if ( pass >= mPasses.size() )
+      return true;
+
+   const PassState &state = mPasses[pass];
+   return   !state.valid ||
+            state.viewport != viewport ||
+            dMemcmp( (const F32*)state.worldToProj, (const F32*)worldToProj, sizeof( F32 ) * 16 ) != 0;
+}
+
+void StaticShadowCache::markUpdated( U32 pass, const MatrixF &worldToProj, const RectI &viewport )
+{
+   while ( pass >= mPasses.size() )
+   {
+      mPasses.increment();
+      mPasses.last().valid = false;
+   }
+
+   PassState &state = mPasses[pass];
+   state.worldToProj = worldToProj;
+   state.viewport = viewport;
+   state.valid = true;
+}
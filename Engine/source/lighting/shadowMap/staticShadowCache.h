@@ -0,0 +1,114 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _STATICSHADOWCACHE_H_
+#define _STATICSHADOWCACHE_H_
+
+#ifndef _MMATRIX_H_
+#include "math/mMatrix.h"
+#endif
+#ifndef _MBOX_H_
+#include "math/mBox.h"
+#endif
+#ifndef _MRECT_H_
+#include "math/mRect.h"
+#endif
+#ifndef _TVECTOR_H_
+#include "core/util/tVector.h"
+#endif
+
+class SceneObject;
+
+
+/// Tracks when the static caster layer of a shadow map must be
+/// rendered again.
+///
+/// A shadow map is split into render passes (one per PSSM split,
+/// paraboloid hemisphere, etc).  The static casters of a pass are
+/// only rendered when the pass projection or viewport changes or
+/// when a static object inside the light bounds changes.  Every
+/// other frame only the dynamic casters are rendered and the
+/// cached static layer is composited in.
+class StaticShadowCache
+{
+public:
+
+   /// Object types which always render into the dynamic
+   /// layer of the shadow map.
+   static const U32 DynamicCasterTypeMask;
+
+   /// Returns true if objects of this type can be cached.
+   static bool isStaticCaster( U32 typeMask );
+
+   /// SceneRenderState object filters used to split the
+   /// casters between the static and dynamic passes.
+   /// @{
+   static bool filterStaticCasters( SceneObject *object );
+   static bool filterDynamicCasters( SceneObject *object );
+   /// @}
+
+   StaticShadowCache();
+
+   /// Sets the world space bounds of the light.  Only changes
+   /// to static objects overlapping these bounds invalidate
+   /// the cache.
+   void setBounds( const Box3F &bounds );
+
+   /// Makes every static object change invalidate the cache, which
+   /// is what a vector light covering the whole scene needs.
+   void setUnbounded();
+
+   /// Returns true if a change within the box affects this cache.
+   bool overlaps( const Box3F &box ) const;
+
+   /// Forces all passes to render their static casters again.
+   void invalidate();
+
+   /// Forgets all the pass state, for example when the
+   /// cached texture has been released.
+   void clear() { mPasses.clear(); }
+
+   /// Returns true if the static casters of the pass must be
+   /// rendered for the given light projection and viewport.
+   bool needsUpdate( U32 pass, const MatrixF &worldToProj, const RectI &viewport ) const;
+
+   /// Records the state the static casters of the pass were
+   /// last rendered with.
+   void markUpdated( U32 pass, const MatrixF &worldToProj, const RectI &viewport );
+
+protected:
+
+   struct PassState
+   {
+      MatrixF worldToProj;
+      RectI viewport;
+      bool valid;
+   };
+
+   Vector<PassState> mPasses;
+
+   Box3F mBounds;
+
+   bool mUnbounded;
+};
+
+#endif // _STATICSHADOWCACHE_H_
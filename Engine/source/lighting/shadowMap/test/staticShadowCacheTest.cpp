@@ -0,0 +1,382 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2014 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "testing/nullGFXDevice.h"
+#include "lighting/shadowMap/staticShadowCache.h"
+#include "lighting/shadowMap/lightShadowMap.h"
+#include "lighting/lightInfo.h"
+#include "scene/sceneManager.h"
+#include "scene/sceneRenderState.h"
+#include "renderInstance/renderPassManager.h"
+#include "gfx/gfxDevice.h"
+#include "gfx/gfxTransformSaver.h"
+#include "T3D/objectTypes.h"
+#include "math/mRandom.h"
+#include "console/console.h"
+
+/// The casters prepared for rendering by type.
+static U32 gStaticCastersPrepared = 0;
+static U32 gDynamicCastersPrepared = 0;
+
+/// A box which counts the times it is asked to render.
+class StaticShadowCacheTestBox : public SceneObject
+{
+   typedef SceneObject Parent;
+
+public:
+
+   StaticShadowCacheTestBox( bool isStatic )
+   {
+      mNetFlags.set( IsGhost );
+      mTypeMask |= isStatic ? StaticObjectType | StaticShapeObjectType : DynamicShapeObjectType;
+      mObjBox.set( Point3F( -1, -1, -1 ), Point3F( 1, 1, 1 ) );
+   }
+
+   bool onAdd()
+   {
+      if ( !Parent::onAdd() )
+         return false;
+
+      resetWorldBox();
+      return true;
+   }
+
+   void prepRenderImage( SceneRenderState *state )
+   {
+      if ( getTypeMask() & StaticObjectType )
+         gStaticCastersPrepared++;
+      else
+         gDynamicCastersPrepared++;
+   }
+};
+
+/// A spot shadow map looking down +Y from the light
+/// which renders its casters in a single pass.
+class StaticShadowCacheTestMap : public LightShadowMap
+{
+public:
+
+   StaticShadowCacheTestMap( LightInfo *light )
+      : LightShadowMap( light ) {}
+
+   virtual void setShaderParameters( GFXShaderConstBuffer *params, LightingShaderConstants *lsc ) {}
+   virtual ShadowType getShadowType() const { return ShadowType_Spot; }
+
+protected:
+
+   virtual void _render( RenderPassManager *renderPass, const SceneRenderState *diffuseState )
+   {
+      const U32 texSize = 256;
+      if ( mShadowMapTex.isNull() )
+         mShadowMapTex.set( texSize, texSize, ShadowMapFormat, &ShadowMapProfile, "StaticShadowCacheTestMap" );
+
+      GFXTransformSaver saver;
+
+      MatrixF lightMat( true );
+      lightMat.setPosition( mLight->getPosition() );
+      const Frustum frustum( false, -1.0f, 1.0f, 1.0f, -1.0f, 1.0f, mLight->getRange().x, lightMat );
+
+      MatrixF worldToLight( lightMat );
+      worldToLight.inverse();
+      MatrixF proj;
+      frustum.getProjectionMatrix( &proj );
+
+      GFX->setWorldMatrix( worldToLight );
+      GFX->setProjectionMatrix( proj );
+
+      GFX->pushActiveRenderTarget();
+      GFXTextureObject *depthTarget = _getDepthTarget( texSize, texSize );
+      mTarget->attachTexture( GFXTextureTarget::Color0, mShadowMapTex );
+      mTarget->attachTexture( GFXTextureTarget::DepthStencil, depthTarget );
+      GFX->setActiveRenderTarget( mTarget );
+
+      SceneRenderState state( gClientSceneGraph, SPT_Shadow,
+         SceneCameraState( GFX->getViewport(), frustum, worldToLight, proj ), renderPass, false );
+      _renderCasters( &state, SHADOW_TYPEMASK, depthTarget, 0 );
+
+      mTarget->resolve();
+      GFX->popActiveRenderTarget();
+   }
+};
+
+FIXTURE(StaticShadowCache)
+{
+public:
+   NullGFXDevice device;
+   Vector<StaticShadowCacheTestBox*> boxes;
+   bool cacheStaticShadows;
+
+   void SetUp()
+   {
+      device.create();
+      cacheStaticShadows = LightShadowMap::smCacheStaticShadows;
+   }
+
+   void TearDown()
+   {
+      for ( U32 i = 0; i < boxes.size(); i++ )
+      {
+         gClientSceneGraph->removeObjectFromScene( boxes[i] );
+         boxes[i]->deleteObject();
+      }
+      boxes.clear();
+
+      LightShadowMap::smCacheStaticShadows = cacheStaticShadows;
+      device.destroy();
+   }
+
+   StaticShadowCacheTestBox* createBox( bool isStatic, const Point3F &pos )
+   {
+      StaticShadowCacheTestBox *box = new StaticShadowCacheTestBox( isStatic );
+      MatrixF mat( true );
+      mat.setPosition( pos );
+      box->setTransform( mat );
+      box->registerObject();
+      gClientSceneGraph->addObjectToScene( box );
+      boxes.push_back( box );
+      return box;
+   }
+};
+
+TEST(StaticShadowCache, CasterClassification)
+{
+   EXPECT_TRUE(StaticShadowCache::isStaticCaster(StaticObjectType | StaticShapeObjectType));
+   EXPECT_TRUE(StaticShadowCache::isStaticCaster(StaticObjectType | TerrainObjectType));
+
+   EXPECT_FALSE(StaticShadowCache::isStaticCaster(StaticShapeObjectType))
+      << "Objects without the static type may move.";
+   EXPECT_FALSE(StaticShadowCache::isStaticCaster(StaticObjectType | StaticShapeObjectType | DynamicShapeObjectType));
+   EXPECT_FALSE(StaticShadowCache::isStaticCaster(PlayerObjectType | DynamicShapeObjectType));
+   EXPECT_FALSE(StaticShadowCache::isStaticCaster(StaticObjectType | EnvironmentObjectType))
+      << "Non shadow casters never touch the cache.";
+}
+
+TEST(StaticShadowCache, PassState)
+{
+   StaticShadowCache cache;
+   MatrixF proj(true);
+   const RectI viewport(0, 0, 512, 512);
+
+   EXPECT_TRUE(cache.needsUpdate(0, proj, viewport));
+   cache.markUpdated(0, proj, viewport);
+   EXPECT_FALSE(cache.needsUpdate(0, proj, viewport));
+   EXPECT_TRUE(cache.needsUpdate(1, proj, viewport))
+      << "Passes are cached independently.";
+
+   cache.markUpdated(2, proj, viewport);
+   EXPECT_TRUE(cache.needsUpdate(1, proj, viewport));
+   EXPECT_FALSE(cache.needsUpdate(2, proj, viewport));
+
+   EXPECT_TRUE(cache.needsUpdate(0, proj, RectI(512, 0, 512, 512)))
+      << "Moving the viewport requires an update.";
+
+   MatrixF moved(proj);
+   moved.setPosition(Point3F(0.0f, 0.0f, 0.001f));
+   EXPECT_TRUE(cache.needsUpdate(0, moved, viewport))
+      << "Any projection change requires an update.";
+
+   cache.invalidate();
+   EXPECT_TRUE(cache.needsUpdate(0, proj, viewport));
+   EXPECT_TRUE(cache.needsUpdate(2, proj, viewport));
+
+   cache.markUpdated(0, proj, viewport);
+   cache.clear();
+   EXPECT_TRUE(cache.needsUpdate(0, proj, viewport));
+}
+
+TEST(StaticShadowCache, Bounds)
+{
+   StaticShadowCache cache;
+   EXPECT_FALSE(cache.overlaps(Box3F(-1, -1, -1, 1, 1, 1)))
+      << "Nothing overlaps until bounds are set.";
+
+   cache.setBounds(Box3F(0, 0, 0, 10, 10, 10));
+   EXPECT_TRUE(cache.overlaps(Box3F(9, 9, 9, 11, 11, 11)));
+   EXPECT_FALSE(cache.overlaps(Box3F(11, 11, 11, 12, 12, 12)));
+
+   cache.setUnbounded();
+   EXPECT_TRUE(cache.overlaps(Box3F(1000, 1000, 1000, 1001, 1001, 1001)));
+
+   cache.setBounds(Box3F(0, 0, 0, 10, 10, 10));
+   EXPECT_FALSE(cache.overlaps(Box3F(1000, 1000, 1000, 1001, 1001, 1001)));
+}
+
+TEST_FIX(StaticShadowCache, ReusesStaticLayer)
+{
+   if ( !gClientSceneGraph )
+   {
+      Con::printf( "StaticShadowCache: no client scene, skipping." );
+      return;
+   }
+
+   LightShadowMap::smCacheStaticShadows = true;
+
+   const U32 numStatic = 8;
+   const U32 numDynamic = 3;
+
+   for ( U32 i = 0; i < numStatic; i++ )
+      createBox( true, Point3F( F32( i ) * 3.0f - 12.0f, 30.0f, 0.0f ) );
+   for ( U32 i = 0; i < numDynamic; i++ )
+      createBox( false, Point3F( F32( i ) * 3.0f - 3.0f, 20.0f, 0.0f ) );
+
+   LightInfo light;
+   light.setType( LightInfo::Spot );
+   light.setPosition( Point3F::Zero );
+   light.setRange( 100.0f );
+
+   StaticShadowCacheTestMap *shadowMap = new StaticShadowCacheTestMap( &light );
+   RenderPassManager *pass = new RenderPassManager();
+   pass->registerObject();
+
+   const U32 updates = LightShadowMap::smStaticPassUpdates;
+   const U32 hits = LightShadowMap::smStaticPassHits;
+
+   // The first update fills the static layer.
+   gStaticCastersPrepared = gDynamicCastersPrepared = 0;
+   shadowMap->render( pass, NULL );
+   EXPECT_EQ( numStatic, gStaticCastersPrepared );
+   EXPECT_EQ( numDynamic, gDynamicCastersPrepared );
+   EXPECT_EQ( updates + 1, LightShadowMap::smStaticPassUpdates );
+
+   // The second reuses it and only renders the dynamic casters,
+   // even when one of them moves.
+   MatrixF mat( true );
+   mat.setPosition( Point3F( 0.0f, 25.0f, 0.0f ) );
+   boxes[numStatic]->setTransform( mat );
+
+   gStaticCastersPrepared = gDynamicCastersPrepared = 0;
+   shadowMap->render( pass, NULL );
+   EXPECT_EQ( 0, gStaticCastersPrepared );
+   EXPECT_EQ( numDynamic, gDynamicCastersPrepared );
+   EXPECT_EQ( updates + 1, LightShadowMap::smStaticPassUpdates );
+   EXPECT_EQ( hits + 1, LightShadowMap::smStaticPassHits );
+
+   // Moving a static caster in range refills it.
+   mat.setPosition( Point3F( 0.0f, 35.0f, 0.0f ) );
+   boxes[0]->setTransform( mat );
+
+   gStaticCastersPrepared = gDynamicCastersPrepared = 0;
+   shadowMap->render( pass, NULL );
+   EXPECT_EQ( numStatic, gStaticCastersPrepared );
+   EXPECT_EQ( updates + 2, LightShadowMap::smStaticPassUpdates );
+
+   delete shadowMap;
+   pass->deleteObject();
+}
+
+TEST(StaticShadowCache, StressTestCasterInstances)
+{
+   // 64 lights over 4000 static boxes and 100 wandering
+   // objects for 300 frames, with a static box nudged every
+   // 30 frames.  Prints the caster instances submitted with
+   // and without the cache and the bookkeeping time.
+
+   const U32 numLights = 64;
+   const U32 numStatic = 4000;
+   const U32 numDynamic = 100;
+   const U32 numFrames = 300;
+   const F32 worldSize = 1000.0f;
+
+   MRandomLCG random(1376312589);
+
+   Vector<Box3F> staticBoxes(numStatic);
+   for (U32 i = 0; i < numStatic; i++)
+   {
+      const Point3F pos(random.randF(0.0f, worldSize), random.randF(0.0f, worldSize), 0.0f);
+      staticBoxes.push_back(Box3F(pos, pos + Point3F(4.0f, 4.0f, 8.0f)));
+   }
+
+   Vector<StaticShadowCache> caches(numLights);
+   Vector<Box3F> lightBounds(numLights);
+   for (U32 i = 0; i < numLights; i++)
+   {
+      const Point3F pos(random.randF(0.0f, worldSize), random.randF(0.0f, worldSize), 10.0f);
+      const F32 range = random.randF(20.0f, 60.0f);
+      caches.increment();
+      lightBounds.push_back(Box3F(pos - Point3F(range, range, range), pos + Point3F(range, range, range)));
+      caches.last().setBounds(lightBounds.last());
+   }
+
+   const MatrixF proj(true);
+   const RectI viewport(0, 0, 1024, 1024);
+
+   U64 uncachedInsts = 0;
+   U64 cachedInsts = 0;
+   U32 staticUpdates = 0;
+
+   const U32 start = Platform::getRealMilliseconds();
+
+   for (U32 frame = 0; frame < numFrames; frame++)
+   {
+      // Every so often a static object is moved by a script.
+      if (frame % 30 == 29)
+      {
+         Box3F &box = staticBoxes[random.randI(0, numStatic - 1)];
+         const Box3F prevBox = box;
+         box.minExtents.x += 2.0f;
+         box.maxExtents.x += 2.0f;
+
+         for (U32 i = 0; i < numLights; i++)
+         {
+            if (caches[i].overlaps(prevBox) || caches[i].overlaps(box))
+               caches[i].invalidate();
+         }
+      }
+
+      for (U32 i = 0; i < numLights; i++)
+      {
+         // The dynamic objects wander everywhere, so assume a
+         // share of them proportional to the light's area.
+         const F32 extent = lightBounds[i].len_x() / worldSize;
+         const U32 dynamicInsts = U32(numDynamic * extent * extent) + 1;
+
+         U32 staticInsts = 0;
+         for (U32 j = 0; j < numStatic; j++)
+         {
+            if (lightBounds[i].isOverlapped(staticBoxes[j]))
+               staticInsts++;
+         }
+
+         uncachedInsts += staticInsts + dynamicInsts;
+         cachedInsts += dynamicInsts;
+
+         if (caches[i].needsUpdate(0, proj, viewport))
+         {
+            caches[i].markUpdated(0, proj, viewport);
+            cachedInsts += staticInsts;
+            staticUpdates++;
+         }
+      }
+   }
+
+   const U32 elapsed = Platform::getRealMilliseconds() - start;
+
+   Con::printf("StaticShadowCache: %d lights, %d frames: %llu caster instances uncached, %llu cached, %d static updates, %.3fms per frame",
+      numLights, numFrames, uncachedInsts, cachedInsts, staticUpdates, F32(elapsed) / numFrames);
+
+   // Only the first frame and the moves may refill a light's cache.
+   EXPECT_LE(staticUpdates, numLights * (1 + numFrames / 30));
+}
+
+#endif
@@ -30,6 +30,7 @@
 #include "materials/processedCustomMaterial.h"
 #include "materials/materialFeatureTypes.h"
 #include "shaderGen/featureMgr.h"
+#include "shaderGen/shaderGen.h"
 #include "gfx/gfxDevice.h"
 #include "gfx/sim/cubemapData.h"
 #include "gfx/gfxCubemap.h"
@@ -371,7 +372,10 @@ bool MatInstance::processMaterial()
       
       if( !mProcessedMaterial->init(features, mVertexFormat, mFeaturesDelegate) )
       {
-         Con::errorf( "Failed to initialize material '%s'", getMaterial()->getName() );
+         // While ShaderGen is batching, shaders which are not
+         // generated yet are expected to fail.
+         if ( !SHADERGEN->isBatching() )
+            Con::errorf( "Failed to initialize material '%s'", getMaterial()->getName() );
          SAFE_DELETE( mProcessedMaterial );
          return false;
       }
@@ -28,6 +28,10 @@
 #include "lighting/lightManager.h"
 #include "core/util/safeDelete.h"
 #include "shaderGen/shaderGen.h"
+#include "gfx/gfxShaderCache.h"
+#include "gfx/gfxVertexTypes.h"
+#include "platform/threads/threadPool.h"
+#include "ts/tsMesh.h"
 #include "core/module.h"
 #include "console/consoleTypes.h"
 #include "console/engineAPI.h"
@@ -499,6 +503,204 @@ bool MaterialManager::_handleGFXEvent( GFXDevice::GFXDeviceEventType event_ )
    return true;
 }
 
+U32 MaterialManager::_initMaterialPermutations()
+{
+   struct Permutation
+   {
+      FeatureSet features;
+      const GFXVertexFormat *format;
+      MatFeaturesDelegate featuresDelegate;
+   };
+
+   Vector<Permutation> permutations;
+
+   // Start with the default features on the formats used by most
+   // geometry: shapes with and without a second uv set and colors,
+   // and the generic mesh formats used by the rest of the scene.
+   GFXVertexFormat shapeFormat;
+   TSBasicVertexFormat().getFormat( shapeFormat );
+
+   GFXVertexFormat shapeColorFormat;
+   TSBasicVertexFormat shapeColorDesc;
+   shapeColorDesc.texCoordOffset = 0;
+   shapeColorDesc.colorOffset = 0;
+   shapeColorDesc.getFormat( shapeColorFormat );
+
+   const GFXVertexFormat *formats[] = 
+   {
+      &shapeFormat,
+      &shapeColorFormat,
+      getGFXVertexFormat<GFXVertexPNTT>(),
+      getGFXVertexFormat<GFXVertexPNTTB>(),
+   };
+
+   for ( U32 i = 0; i < sizeof( formats ) / sizeof( formats[0] ); i++ )
+   {
+      Permutation perm;
+      perm.features = getDefaultFeatures();
+      perm.format = formats[i];
+      permutations.push_back( perm );
+   }
+
+   // Then add the features the live instances were created with, like
+   // the shadow, reflection and deferred passes, along with the vertex
+   // formats and feature hooks they were used with.
+   const Vector<BaseMatInstance*> instances( mMatInstanceList );
+   for ( U32 i = 0; i < instances.size(); i++ )
+   {
+      BaseMatInstance *inst = instances[i];
+      if ( !inst->isValid() || !inst->getVertexFormat() )
+         continue;
+
+      bool found = false;
+      for ( U32 j = 0; j < permutations.size() && !found; j++ )
+      {
+         const Permutation &perm = permutations[j];
+         found = perm.features == inst->getRequestedFeatures() &&
+                 perm.format->isEqual( *inst->getVertexFormat() ) &&
+                 perm.featuresDelegate == inst->getFeaturesDelegate();
+      }
+
+      if ( found )
+         continue;
+
+      Permutation perm;
+      perm.features = inst->getRequestedFeatures();
+      perm.format = inst->getVertexFormat();
+      perm.featuresDelegate = inst->getFeaturesDelegate();
+      permutations.push_back( perm );
+   }
+
+   U32 count = 0;
+   for ( U32 i = 0; i < mMaterialSet->size(); i++ )
+   {
+      BaseMaterialDefinition *mat = dynamic_cast<BaseMaterialDefinition*>( (*mMaterialSet)[i] );
+      if ( !mat )
+         continue;
+
+      for ( U32 j = 0; j < permutations.size(); j++ )
+      {
+         const Permutation &perm = permutations[j];
+
+         BaseMatInstance *matInst = mat->createMatInstance();
+         matInst->getFeaturesDelegate() = perm.featuresDelegate;
+         matInst->init( perm.features, perm.format );
+         if ( matInst->isValid() )
+            count++;
+
+         delete matInst;
+      }
+   }
+
+   return count;
+}
+
+U32 MaterialManager::generateShaders( ThreadPool *pool, U32 *outGenerateMs )
+{
+   PROFILE_SCOPE( MaterialManager_GenerateShaders );
+
+   U32 total = 0;
+   U32 generateMs = 0;
+
+   // A material stops initializing at the first shader which isn't
+   // generated yet, so each round gets one pass further until no
+   // new shaders are requested.
+   for ( ;; )
+   {
+      SHADERGEN->beginBatch();
+      _initMaterialPermutations();
+
+      const U32 start = Platform::getRealMilliseconds();
+      const U32 generated = SHADERGEN->endBatch( pool );
+      generateMs += Platform::getRealMilliseconds() - start;
+
+      if ( generated == 0 )
+         break;
+
+      total += generated;
+   }
+
+   if ( outGenerateMs )
+      *outGenerateMs = generateMs;
+
+   return total;
+}
+
+U32 MaterialManager::precompileShaders()
+{
+   PROFILE_SCOPE( MaterialManager_PrecompileShaders );
+
+   // ShaderGen can generate the source in parallel, but the
+   // shaders are still created and compiled on this thread.
+   generateShaders();
+
+   return _initMaterialPermutations();
+}
+
+DefineEngineFunction( precompileShaders, S32, (),,
+   "@brief Generates and compiles the shaders of every loaded material into the persistent "
+   "shader cache so that they don't have to be built when first used.\n\n"
+   "Load the materials of a level before calling this.  Run with -precompileShaders "
+   "and -level to do this from the command line.\n\n"
+   "@return The number of material instances initialized.\n"
+   "@ingroup Materials")
+{
+   if ( !GFXShaderCache::isEnabled() )
+      Con::warnf( "precompileShaders - The shader cache is disabled, nothing will be saved." );
+
+   GFXShaderCache::resetStats();
+   const U32 start = Platform::getRealMilliseconds();
+
+   const U32 count = MATMGR->precompileShaders();
+
+   Con::printf( "precompileShaders - Initialized %u material instances in %u ms (%u shader cache hits, %u misses).",
+      count, Platform::getRealMilliseconds() - start, 
+      GFXShaderCache::getHitCount(), GFXShaderCache::getMissCount() );
+
+   return count;
+}
+
+DefineEngineFunction( benchmarkShaderGen, void, ( S32 maxThreads ), ( 0 ),
+   "@brief Times generating the shader source of every loaded material "
+   "with an increasing number of worker threads.\n\n"
+   "The procedural shaders are flushed and the shader cache is bypassed "
+   "for every run.  Load the materials of a level before calling this.\n\n"
+   "The thread counts reported include the calling thread, which "
+   "generates alongside the workers while it waits for the batch.\n\n"
+   "@param maxThreads The most worker threads to try or 0 to use as many "
+   "as the global thread pool.\n"
+   "@ingroup Materials")
+{
+   if ( maxThreads <= 0 )
+      maxThreads = ThreadPool::GLOBAL().getNumThreads();
+
+   const bool cacheEnabled = GFXShaderCache::smEnabled;
+   GFXShaderCache::smEnabled = false;
+
+   U32 firstMs = 0;
+   for ( S32 workers = 1; workers <= maxThreads; )
+   {
+      SHADERGEN->flushProceduralShaders();
+
+      ThreadPool pool( "ShaderGenBenchmark", workers );
+
+      U32 generateMs = 0;
+      const U32 count = MATMGR->generateShaders( &pool, &generateMs );
+      if ( workers == 1 )
+         firstMs = generateMs;
+
+      Con::printf( "benchmarkShaderGen - %d threads (%d workers): %u shaders in %u ms (%.2fx)",
+         workers + 1, workers, count, generateMs, generateMs ? F32( firstMs ) / F32( generateMs ) : 0.0f );
+
+      // Double the workers each run, but always end on the maximum.
+      if ( workers == maxThreads )
+         break;
+      workers = getMin( workers * 2, maxThreads );
+   }
+
+   GFXShaderCache::smEnabled = cacheEnabled;
+}
+
 DefineEngineFunction( reInitMaterials, void, (),,
    "@brief Flushes all procedural shaders and re-initializes all active material instances.\n\n" 
    "@ingroup Materials")
@@ -38,6 +38,7 @@
 class SimSet;
 class MatInstance;
 class GuiTreeViewCtrl;
+class ThreadPool;
 
 class MaterialManager : public ManagedSingleton<MaterialManager>
 {
@@ -124,8 +125,27 @@ public:
    /// Re-initializes the material instances for a specific target material.   
    void reInitInstance( BaseMaterialDefinition *target );
 
+   /// Initializes every registered material with the default features on
+   /// the common vertex formats and with every feature set and vertex
+   /// format the live material instances use, so that their shaders are
+   /// generated and compiled into the persistent shader cache.
+   /// @return The number of material instances that initialized.
+   U32 precompileShaders();
+
+   /// Generates the source of the shader permutations used by
+   /// precompileShaders() in parallel using ShaderGen batches.
+   /// @param pool The pool to generate on; defaults to the global pool.
+   /// @param outGenerateMs If not NULL the time spent generating is returned.
+   /// @return The number of shaders generated.
+   U32 generateShaders( ThreadPool *pool = NULL, U32 *outGenerateMs = NULL );
+
 protected:
 
+   /// Initializes every registered material with each of the permutations
+   /// precompileShaders() covers and returns the number of instances that
+   /// initialized.
+   U32 _initMaterialPermutations();
+
    // MatInstance tracks it's instances here
    friend class MatInstance;
    void _track(MatInstance*);
@@ -184,7 +184,11 @@ String ProcessedMaterial::_getTexturePath(const String& filename)
 
 GFXTexHandle ProcessedMaterial::_createTexture( const char* filename, GFXTextureProfile *profile)
 {
-   return GFXTexHandle( _getTexturePath(filename), profile, avar("%s() - NA (line %d)", __FUNCTION__, __LINE__) );
+   // Materials are created as objects come into view so
+   // read the texture in the background to avoid a hitch.
+   GFXTexHandle tex;
+   tex.setAsync( _getTexturePath(filename), profile, avar("%s() - NA (line %d)", __FUNCTION__, __LINE__) );
+   return tex;
 }
 
 GFXTexHandle ProcessedMaterial::_createCompositeTexture(const char *filenameR, const char *filenameG, const char *filenameB, const char *filenameA, U32 inputKey[4], GFXTextureProfile *profile)
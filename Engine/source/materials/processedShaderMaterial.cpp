@@ -51,24 +51,53 @@
 #include "gui/controls/guiTreeViewCtrl.h"
 #include "ts/tsShape.h"
 
+// The constants which aren't part of ShaderGenVars, interned
+// once so ShaderConstHandles::init doesn't hash the names.
+namespace
+{
+   const GFXShaderConstId sDiffuseMaterialColorId( "$diffuseMaterialColor" );
+   const GFXShaderConstId sAccuScaleId( "$accuScale" );
+   const GFXShaderConstId sAccuDirectionId( "$accuDirection" );
+   const GFXShaderConstId sAccuStrengthId( "$accuStrength" );
+   const GFXShaderConstId sAccuCoverageId( "$accuCoverage" );
+   const GFXShaderConstId sAccuSpecularId( "$accuSpecular" );
+   const GFXShaderConstId sParallaxInfoId( "$parallaxInfo" );
+   const GFXShaderConstId sTargetSizeId( "$targetSize" );
+   const GFXShaderConstId sOneOverTargetSizeId( "$oneOverTargetSize" );
+   const GFXShaderConstId sDetailBumpStrengthId( "$detailBumpStrength" );
+   const GFXShaderConstId sViewProjId( "$viewProj" );
+   const GFXShaderConstId sImposterUVsId( "$imposterUVs" );
+   const GFXShaderConstId sImposterLimitsId( "$imposterLimits" );
+   const GFXShaderConstId sNodeTransformsId( "$nodeTransforms" );
+
+   /// Returns the id of the indexed $rtParams constant.
+   const GFXShaderConstId& _getRTParamsId( U32 index )
+   {
+      static GFXShaderConstId sRTParamsIds[GFX_TEXTURE_STAGE_COUNT];
+      if ( !sRTParamsIds[index].isValid() )
+         sRTParamsIds[index] = GFXShaderConstId( String::ToString( "$rtParams%d", index ) );
+      return sRTParamsIds[index];
+   }
+}
+
 ///
 /// ShaderConstHandles
 ///
 void ShaderConstHandles::init( GFXShader *shader, CustomMaterial* mat /*=NULL*/)
 {
-   mDiffuseColorSC = shader->getShaderConstHandle("$diffuseMaterialColor");
+   mDiffuseColorSC = shader->getShaderConstHandle(sDiffuseMaterialColorId);
    mTexMatSC = shader->getShaderConstHandle(ShaderGenVars::texMat);
    mToneMapTexSC = shader->getShaderConstHandle(ShaderGenVars::toneMap);
    mORMConfigSC = shader->getShaderConstHandle(ShaderGenVars::ormConfig);
    mRoughnessSC = shader->getShaderConstHandle(ShaderGenVars::roughness);
    mMetalnessSC = shader->getShaderConstHandle(ShaderGenVars::metalness);
    mGlowMulSC = shader->getShaderConstHandle(ShaderGenVars::glowMul);
-   mAccuScaleSC = shader->getShaderConstHandle("$accuScale");
-   mAccuDirectionSC = shader->getShaderConstHandle("$accuDirection");
-   mAccuStrengthSC = shader->getShaderConstHandle("$accuStrength");
-   mAccuCoverageSC = shader->getShaderConstHandle("$accuCoverage");
-   mAccuSpecularSC = shader->getShaderConstHandle("$accuSpecular");
-   mParallaxInfoSC = shader->getShaderConstHandle("$parallaxInfo");
+   mAccuScaleSC = shader->getShaderConstHandle(sAccuScaleId);
+   mAccuDirectionSC = shader->getShaderConstHandle(sAccuDirectionId);
+   mAccuStrengthSC = shader->getShaderConstHandle(sAccuStrengthId);
+   mAccuCoverageSC = shader->getShaderConstHandle(sAccuCoverageId);
+   mAccuSpecularSC = shader->getShaderConstHandle(sAccuSpecularId);
+   mParallaxInfoSC = shader->getShaderConstHandle(sParallaxInfoId);
    mFogDataSC = shader->getShaderConstHandle(ShaderGenVars::fogData);
    mFogColorSC = shader->getShaderConstHandle(ShaderGenVars::fogColor);
    mDetailScaleSC = shader->getShaderConstHandle(ShaderGenVars::detailScale);
@@ -100,20 +129,20 @@ void ShaderConstHandles::init( GFXShader *shader, CustomMaterial* mat /*=NULL*/)
    mDiffuseAtlasTileSC = shader->getShaderConstHandle(ShaderGenVars::diffuseAtlasTileParams);
    mBumpAtlasParamsSC = shader->getShaderConstHandle(ShaderGenVars::bumpAtlasParams);
    mBumpAtlasTileSC = shader->getShaderConstHandle(ShaderGenVars::bumpAtlasTileParams);
-   mRTSizeSC = shader->getShaderConstHandle( "$targetSize" );
-   mOneOverRTSizeSC = shader->getShaderConstHandle( "$oneOverTargetSize" );
-   mDetailBumpStrength = shader->getShaderConstHandle( "$detailBumpStrength" );
-   mViewProjSC = shader->getShaderConstHandle( "$viewProj" );
+   mRTSizeSC = shader->getShaderConstHandle( sTargetSizeId );
+   mOneOverRTSizeSC = shader->getShaderConstHandle( sOneOverTargetSizeId );
+   mDetailBumpStrength = shader->getShaderConstHandle( sDetailBumpStrengthId );
+   mViewProjSC = shader->getShaderConstHandle( sViewProjId );
 
    // MFT_ImposterVert
-   mImposterUVs = shader->getShaderConstHandle( "$imposterUVs" );
-   mImposterLimits = shader->getShaderConstHandle( "$imposterLimits" );
+   mImposterUVs = shader->getShaderConstHandle( sImposterUVsId );
+   mImposterLimits = shader->getShaderConstHandle( sImposterLimitsId );
 
    for (S32 i = 0; i < GFX_TEXTURE_STAGE_COUNT; ++i)
-      mRTParamsSC[i] = shader->getShaderConstHandle( String::ToString( "$rtParams%d", i ) );
+      mRTParamsSC[i] = shader->getShaderConstHandle( _getRTParamsId( i ) );
 
    // MFT_HardwareSkinning
-   mNodeTransforms = shader->getShaderConstHandle( "$nodeTransforms" );
+   mNodeTransforms = shader->getShaderConstHandle( sNodeTransformsId );
 
    // Clear any existing texture handles.
    dMemset( mTexHandlesSC, 0, sizeof( mTexHandlesSC ) );
@@ -825,6 +854,9 @@ void ProcessedShaderMaterial::setTextureStages( SceneRenderState *state, const S
    NamedTexTarget *texTarget;
    GFXTextureObject *texObject; 
 
+   // Feed the texture streamer the size of the object.
+   GFX->setTextureScreenSize( sgData.screenSize );
+
    for( U32 i=0; i<rpd->mNumTex; i++ )
    {
       U32 currTexFlag = rpd->mTexType[i];
@@ -905,6 +937,8 @@ void ProcessedShaderMaterial::setTextureStages( SceneRenderState *state, const S
          }
       }
    }
+
+   GFX->setTextureScreenSize( 0.0f );
 }
 
 void ProcessedShaderMaterial::_setTextureTransforms(const U32 pass)
@@ -87,6 +87,10 @@ struct SceneData
    GFXCubemap *cubemap;
    F32 visibility;
 
+   /// The approximate size of the object on screen in pixels or
+   /// zero if unknown.  This is passed to the texture streamer.
+   F32 screenSize;
+
    /// Enables wireframe rendering for the object.
    bool wireframe;
 
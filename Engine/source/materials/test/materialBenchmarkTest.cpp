@@ -0,0 +1,280 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2014 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "testing/nullGFXDevice.h"
+#include "materials/materialManager.h"
+#include "materials/materialDefinition.h"
+#include "materials/baseMatInstance.h"
+#include "materials/matStateHint.h"
+#include "materials/sceneData.h"
+#include "math/util/matrixSet.h"
+#include "lighting/lightManager.h"
+#include "scene/sceneManager.h"
+#include "scene/sceneRenderState.h"
+#include "gfx/gfxDevice.h"
+#include "gfx/gfxVertexTypes.h"
+#include "platform/platformMemory.h"
+#include "console/console.h"
+
+FIXTURE(MaterialBenchmark)
+{
+public:
+   NullGFXDevice device;
+   Vector<Material*> materials;
+
+   void SetUp()
+   {
+      // The null device compiles nothing, but with a pixel shader
+      // version set ShaderGen still builds the passes and the null
+      // shader hands out constant handles, so the whole binding
+      // path runs without a GPU.
+      device.create(3.0f);
+   }
+
+   void TearDown()
+   {
+      for (U32 i = 0; i < materials.size(); i++)
+         materials[i]->deleteObject();
+      materials.clear();
+
+      device.destroy();
+   }
+
+   /// Registers a set of materials which cover the common
+   /// state combinations a level ends up with.
+   void createMaterials(U32 count)
+   {
+      for (U32 i = 0; i < count; i++)
+      {
+         Material *mat = MATMGR->allocateAndRegister(
+            String::ToString("materialBenchmark%d", i),
+            String::ToString("materialBenchmarkMap%d", i));
+         ASSERT_TRUE(mat != NULL);
+
+         mat->mDiffuse[0].set((i % 7) / 7.0f, (i % 5) / 5.0f, (i % 3) / 3.0f, 1.0f);
+         mat->mDoubleSided = (i % 4) == 1;
+         mat->mAlphaTest = (i % 8) == 2;
+         mat->mAlphaRef = 64;
+         mat->mVertColor[0] = (i % 6) == 3;
+         mat->mEmissive[0] = (i % 10) == 5;
+
+         if ((i % 5) == 4)
+         {
+            mat->mTranslucent = true;
+            mat->mTranslucentBlendOp = (i % 2) ? Material::LerpAlpha : Material::AddAlpha;
+         }
+
+         materials.push_back(mat);
+      }
+   }
+};
+
+/// Reports the cost of a timed section per operation.
+static void _printPerOp(const char *what, U32 ms, U32 allocs, U32 count)
+{
+   const F64 ns = (F64)ms * 1000000.0 / (F64)getMax(count, (U32)1);
+   const F64 allocsPerOp = (F64)allocs / (F64)getMax(count, (U32)1);
+   Con::printf("   %s: %d ms, %.1f ns and %.3f allocs per op (%d ops)", what, ms, ns, allocsPerOp, count);
+}
+
+TEST(MatStateHint, Compare)
+{
+   MatStateHint a(String("materialBenchmarkHint|Translucent|LerpAlpha"));
+   MatStateHint b(String("materialBenchmarkHint|Translucent|") + String("LerpAlpha"));
+   MatStateHint c(String("materialBenchmarkHint|Opaque"));
+
+   // Hints are interned so equal states are equal regardless
+   // of where the string came from.
+   EXPECT_TRUE(a == b);
+   EXPECT_FALSE(a != b);
+   EXPECT_TRUE(a != c);
+   EXPECT_EQ((U32)a, (U32)b);
+
+   MatStateHint empty;
+   c.clear();
+   EXPECT_TRUE(c == empty);
+}
+
+TEST_FIX(MaterialBenchmark, StressTestLookup)
+{
+   // The same name and mapTo lookups the shape and
+   // interior loaders make, over 400 materials.
+
+   const U32 numMaterials = 400;
+   const U32 numIterations = 250;
+
+   createMaterials(numMaterials);
+
+   Vector<String> names;
+   Vector<String> mapTos;
+   for (U32 i = 0; i < numMaterials; i++)
+   {
+      names.push_back(materials[i]->getName());
+      mapTos.push_back(materials[i]->mMapTo);
+   }
+
+   U32 found = 0;
+   U32 allocs = Memory::getAllocCount();
+   U32 start = Platform::getRealMilliseconds();
+   for (U32 n = 0; n < numIterations; n++)
+      for (U32 i = 0; i < numMaterials; i++)
+         found += MATMGR->getMaterialDefinitionByName(names[i]) == materials[i];
+   const U32 nameTime = Platform::getRealMilliseconds() - start;
+   const U32 nameAllocs = Memory::getAllocCount() - allocs;
+
+   // This is what MaterialList does for every texture name.
+   allocs = Memory::getAllocCount();
+   start = Platform::getRealMilliseconds();
+   for (U32 n = 0; n < numIterations; n++)
+      for (U32 i = 0; i < numMaterials; i++)
+         found += MATMGR->getMapEntry(mapTos[i]) == names[i];
+   const U32 mapTime = Platform::getRealMilliseconds() - start;
+   const U32 mapAllocs = Memory::getAllocCount() - allocs;
+
+   // The mapTo search walks the material set so run it less.
+   const U32 numScans = numIterations / 25;
+   allocs = Memory::getAllocCount();
+   start = Platform::getRealMilliseconds();
+   for (U32 n = 0; n < numScans; n++)
+      for (U32 i = 0; i < numMaterials; i++)
+         found += MATMGR->getMaterialDefinitionByMapTo(mapTos[i]) == materials[i];
+   const U32 scanTime = Platform::getRealMilliseconds() - start;
+   const U32 scanAllocs = Memory::getAllocCount() - allocs;
+
+   const U32 numLookups = numIterations * numMaterials;
+   Con::printf("Material lookups (%d materials x %d):", numMaterials, numIterations);
+   _printPerOp("by name     ", nameTime, nameAllocs, numLookups);
+   _printPerOp("map entry   ", mapTime, mapAllocs, numLookups);
+   _printPerOp("mapTo search", scanTime, scanAllocs, numScans * numMaterials);
+
+   EXPECT_EQ(found, numLookups * 2 + numScans * numMaterials);
+}
+
+TEST_FIX(MaterialBenchmark, StressTestPerDrawBinding)
+{
+   // Instance creation and per draw binding on the null
+   // device, so the numbers are all engine side.
+
+   const U32 numMaterials = 300;
+   const U32 numDraws = 2000000;
+
+   // Material instances need the active light manager for their
+   // features and the scene for the render state.
+   if (!LIGHTMGR || !gClientSceneGraph)
+   {
+      Con::printf("MaterialBenchmark: no active light manager or scene, skipping.");
+      return;
+   }
+
+   createMaterials(numMaterials);
+
+   Vector<BaseMatInstance*> instances;
+   U32 allocs = Memory::getAllocCount();
+   U32 start = Platform::getRealMilliseconds();
+   for (U32 i = 0; i < numMaterials; i++)
+   {
+      BaseMatInstance *inst = MATMGR->createMatInstance(materials[i]->getName(), getGFXVertexFormat<GFXVertexPNTT>());
+      if (inst)
+         instances.push_back(inst);
+   }
+   const U32 createTime = Platform::getRealMilliseconds() - start;
+   const U32 createAllocs = Memory::getAllocCount() - allocs;
+
+   ASSERT_EQ(instances.size(), numMaterials);
+
+   const RectI viewport(0, 0, 1024, 768);
+   MatrixF cameraMat(true);
+   cameraMat.setPosition(Point3F(0, -10, 2));
+   const Frustum frustum(false, -0.1f, 0.1f, 0.075f, -0.075f, 0.1f, 1000.0f, cameraMat);
+
+   MatrixF worldToCamera(cameraMat);
+   worldToCamera.inverse();
+   MatrixF projection;
+   frustum.getProjectionMatrix(&projection);
+
+   SceneRenderState state(gClientSceneGraph, SPT_Diffuse,
+      SceneCameraState(viewport, frustum, worldToCamera, projection), NULL, false);
+
+   MatrixSet matrixSet;
+   matrixSet.setSceneView(worldToCamera);
+   matrixSet.setSceneProjection(projection);
+
+   SceneData sgData;
+   sgData.init(&state);
+
+   // Walk the instances like a sorted render bin would, a few
+   // draws per material before switching.
+   const U32 drawsPerMaterial = 4;
+   MatrixF objTrans(true);
+   U32 passes = 0;
+
+   allocs = Memory::getAllocCount();
+   start = Platform::getRealMilliseconds();
+   for (U32 d = 0; d < numDraws; d += drawsPerMaterial)
+   {
+      BaseMatInstance *mat = instances[(d / drawsPerMaterial) % numMaterials];
+      while (mat->setupPass(&state, sgData))
+      {
+         for (U32 j = 0; j < drawsPerMaterial; j++)
+         {
+            objTrans.setPosition(Point3F(F32(d + j), 0, 0));
+            sgData.objTrans = &objTrans;
+            matrixSet.setWorld(objTrans);
+
+            mat->setSceneInfo(&state, sgData);
+            mat->setTransforms(matrixSet, &state);
+            passes++;
+         }
+      }
+   }
+   const U32 drawTime = Platform::getRealMilliseconds() - start;
+   const U32 drawAllocs = Memory::getAllocCount() - allocs;
+
+   // The bins compare state hints between neighbours to decide
+   // whether the material needs to be set up again.
+   U32 switches = 0;
+   allocs = Memory::getAllocCount();
+   start = Platform::getRealMilliseconds();
+   for (U32 d = 1; d < numDraws; d++)
+   {
+      const MatStateHint &prev = instances[(d - 1) % numMaterials]->getStateHint();
+      const MatStateHint &curr = instances[d % numMaterials]->getStateHint();
+      switches += prev != curr;
+   }
+   const U32 hintTime = Platform::getRealMilliseconds() - start;
+   const U32 hintAllocs = Memory::getAllocCount() - allocs;
+
+   Con::printf("Material binding (%d materials):", numMaterials);
+   _printPerOp("createMatInstance", createTime, createAllocs, numMaterials);
+   _printPerOp("setupPass/setSceneInfo/setTransforms per draw", drawTime, drawAllocs, passes);
+   _printPerOp("MatStateHint compare", hintTime, hintAllocs, numDraws - 1);
+   Con::printf("   %d of %d neighbouring draws switched state", switches, numDraws - 1);
+
+   EXPECT_GE(passes, numDraws);
+
+   for (U32 i = 0; i < instances.size(); i++)
+      SAFE_DELETE(instances[i]);
+}
+
+#endif
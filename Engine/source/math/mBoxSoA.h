@@ -0,0 +1,122 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _MBOXSOA_H_
+#define _MBOXSOA_H_
+
+#ifndef _MBOX_H_
+#include "math/mBox.h"
+#endif
+
+#ifndef _TVECTOR_H_
+#include "core/util/tVector.h"
+#endif
+
+
+/// A batch of axis-aligned boxes in structure-of-arrays layout.
+///
+/// Each coordinate of the min and max extents is kept in an array of its own so
+/// that bulk tests such as PlaneSet::testPotentialIntersection(const Box3FSoA&,U32,U32,S8*)
+/// can load the same coordinate of several boxes with a single instruction.
+class Box3FSoA
+{
+   protected:
+
+      Vector< F32 > mMinX;
+      Vector< F32 > mMinY;
+      Vector< F32 > mMinZ;
+      Vector< F32 > mMaxX;
+      Vector< F32 > mMaxY;
+      Vector< F32 > mMaxZ;
+
+   public:
+
+      Box3FSoA()
+      {
+         VECTOR_SET_ASSOCIATION( mMinX );
+         VECTOR_SET_ASSOCIATION( mMinY );
+         VECTOR_SET_ASSOCIATION( mMinZ );
+         VECTOR_SET_ASSOCIATION( mMaxX );
+         VECTOR_SET_ASSOCIATION( mMaxY );
+         VECTOR_SET_ASSOCIATION( mMaxZ );
+      }
+
+      /// Return the number of boxes in the batch.
+      U32 size() const { return mMinX.size(); }
+
+      /// Return true if the batch holds no boxes.
+      bool empty() const { return mMinX.empty(); }
+
+      /// Remove all boxes from the batch.  Memory is retained.
+      void clear()
+      {
+         mMinX.clear();
+         mMinY.clear();
+         mMinZ.clear();
+         mMaxX.clear();
+         mMaxY.clear();
+         mMaxZ.clear();
+      }
+
+      /// Make room for at least @a count boxes.
+      void reserve( U32 count )
+      {
+         mMinX.reserve( count );
+         mMinY.reserve( count );
+         mMinZ.reserve( count );
+         mMaxX.reserve( count );
+         mMaxY.reserve( count );
+         mMaxZ.reserve( count );
+      }
+
+      /// Append a box to the batch.
+      void push_back( const Box3F& box )
+      {
+         mMinX.push_back( box.minExtents.x );
+         mMinY.push_back( box.minExtents.y );
+         mMinZ.push_back( box.minExtents.z );
+         mMaxX.push_back( box.maxExtents.x );
+         mMaxY.push_back( box.maxExtents.y );
+         mMaxZ.push_back( box.maxExtents.z );
+      }
+
+      /// Return the box at the given index.
+      Box3F get( U32 index ) const
+      {
+         return Box3F( mMinX[ index ], mMinY[ index ], mMinZ[ index ],
+                       mMaxX[ index ], mMaxY[ index ], mMaxZ[ index ] );
+      }
+
+      /// @name Coordinate Arrays
+      /// @{
+
+      const F32* getMinX() const { return mMinX.address(); }
+      const F32* getMinY() const { return mMinY.address(); }
+      const F32* getMinZ() const { return mMinZ.address(); }
+      const F32* getMaxX() const { return mMaxX.address(); }
+      const F32* getMaxY() const { return mMaxY.address(); }
+      const F32* getMaxZ() const { return mMaxZ.address(); }
+
+      /// @}
+};
+
+#endif // !_MBOXSOA_H_
@@ -91,6 +91,35 @@ extern void (*m_matF_x_point4F)(const F32 *m, const F32 *p, F32 *presult);
 extern void (*m_matF_x_scale_x_planeF)(const F32 *m, const F32* s, const F32 *p, F32 *presult);
 extern void (*m_matF_x_box3F)(const F32 *m, F32 *min, F32 *max);
 
+// Classify a batch of AABBs stored as separate min/max coordinate arrays against a set
+// of planes (x,y,z,d each).  Writes one OverlapTestResult per box to results.  Matches
+// PlaneSetF::testPotentialIntersection(const Box3F&) exactly.
+extern void (*m_planeF_classify_box3F_soa)(const F32 *planes, U32 numPlanes,
+                                           const F32 *minX, const F32 *minY, const F32 *minZ,
+                                           const F32 *maxX, const F32 *maxY, const F32 *maxZ,
+                                           U32 numBoxes, S8 *results);
+
+// The C version of the above.  The SSE version classifies the boxes that
+// don't fill a full vector with it.
+extern void m_planeF_classify_box3F_soa_C(const F32 *planes, U32 numPlanes,
+                                          const F32 *minX, const F32 *minY, const F32 *minZ,
+                                          const F32 *maxX, const F32 *maxY, const F32 *maxZ,
+                                          U32 numBoxes, S8 *results);
+
+// Test a sphere (x,y,z,radius) against a batch of AABBs stored as separate min/max
+// coordinate arrays.  Writes 1 to results for each box the sphere touches, else 0.
+extern void (*m_sphere_overlap_box3F_soa)(const F32 *sphere,
+                                          const F32 *minX, const F32 *minY, const F32 *minZ,
+                                          const F32 *maxX, const F32 *maxY, const F32 *maxZ,
+                                          U32 numBoxes, U8 *results);
+
+// Test a cone (apex x,y,z, unit axis x,y,z, length, cos and sin of the half angle) against
+// a batch of spheres stored as separate center and radius arrays.  Writes 1 to results for
+// each sphere the cone may touch, else 0.  The test is conservative near the apex.
+extern void (*m_cone_overlap_sphere_soa)(const F32 *cone,
+                                         const F32 *x, const F32 *y, const F32 *z, const F32 *radius,
+                                         U32 numSpheres, U8 *results);
+
 // Note that x must point to at least 4 values for quartics, and 3 for cubics
 extern U32 (*mSolveQuadratic)(F32 a, F32 b, F32 c, F32* x);
 extern U32 (*mSolveCubic)(F32 a, F32 b, F32 c, F32 d, F32* x);
@@ -24,6 +24,11 @@
 #include "math/mPlane.h"
 #include "math/mMatrix.h"
 
+#if defined(TORQUE_CPU_X86) || defined(TORQUE_CPU_X64)
+#include <xmmintrin.h>
+#define ADD_SSE_INTRINSICS_FN
+#endif
+
 
 #if defined(TORQUE_SUPPORTS_VC_INLINE_X86_ASM)
 #define ADD_SSE_FN
@@ -374,6 +379,186 @@ void SSE_MatrixF_x_MatrixF_Aligned(const F32 *matA, const F32 *matB, F32 *result
 
 #endif
 
+#if defined(ADD_SSE_INTRINSICS_FN)
+
+// Tests four boxes at a time against each plane.  Since the plane is the same for
+// all four lanes, picking the p- and n-vertex per axis is a scalar choice between
+// the min and max vectors.  The arithmetic is kept in the same order as in
+// PlaneF::distToPlane so results are identical to the C version.
+static void SSE_PlaneF_classify_Box3F_SoA(const F32 *planes, U32 numPlanes,
+                                          const F32 *minX, const F32 *minY, const F32 *minZ,
+                                          const F32 *maxX, const F32 *maxY, const F32 *maxZ,
+                                          U32 numBoxes, S8 *results)
+{
+   const __m128 backEpsilon = _mm_set1_ps(-0.005f);
+   const __m128 frontEpsilon = _mm_set1_ps(0.005f);
+
+   const U32 numVectorBoxes = numBoxes & ~3;
+   for (U32 i = 0; i < numVectorBoxes; i += 4)
+   {
+      const __m128 bMinX = _mm_loadu_ps(&minX[i]);
+      const __m128 bMinY = _mm_loadu_ps(&minY[i]);
+      const __m128 bMinZ = _mm_loadu_ps(&minZ[i]);
+      const __m128 bMaxX = _mm_loadu_ps(&maxX[i]);
+      const __m128 bMaxY = _mm_loadu_ps(&maxY[i]);
+      const __m128 bMaxZ = _mm_loadu_ps(&maxZ[i]);
+
+      __m128 outside = _mm_setzero_ps();
+      __m128 intersecting = _mm_setzero_ps();
+
+      for (U32 n = 0; n < numPlanes; n++)
+      {
+         const F32 *plane = &planes[n * 4];
+
+         const __m128 a = _mm_set1_ps(plane[0]);
+         const __m128 b = _mm_set1_ps(plane[1]);
+         const __m128 c = _mm_set1_ps(plane[2]);
+         const __m128 d = _mm_set1_ps(plane[3]);
+
+         const bool posX = plane[0] > 0.0f;
+         const bool posY = plane[1] > 0.0f;
+         const bool posZ = plane[2] > 0.0f;
+
+         const __m128 pDist = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+            _mm_mul_ps(a, posX ? bMaxX : bMinX),
+            _mm_mul_ps(b, posY ? bMaxY : bMinY)),
+            _mm_mul_ps(c, posZ ? bMaxZ : bMinZ)), d);
+
+         outside = _mm_or_ps(outside, _mm_cmple_ps(pDist, backEpsilon));
+         if (_mm_movemask_ps(outside) == 0xF)
+            break;
+
+         const __m128 nDist = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+            _mm_mul_ps(a, posX ? bMinX : bMaxX),
+            _mm_mul_ps(b, posY ? bMinY : bMaxY)),
+            _mm_mul_ps(c, posZ ? bMinZ : bMaxZ)), d);
+
+         intersecting = _mm_or_ps(intersecting, _mm_cmplt_ps(nDist, frontEpsilon));
+      }
+
+      const S32 outsideMask = _mm_movemask_ps(outside);
+      const S32 intersectingMask = _mm_movemask_ps(intersecting);
+
+      for (U32 k = 0; k < 4; k++)
+      {
+         if (outsideMask & (1 << k))
+            results[i + k] = GeometryOutside;
+         else if (intersectingMask & (1 << k))
+            results[i + k] = GeometryIntersecting;
+         else
+            results[i + k] = GeometryInside;
+      }
+   }
+
+   // Do the remainder in C.
+   if (numVectorBoxes < numBoxes)
+      m_planeF_classify_box3F_soa_C(planes, numPlanes,
+                                    &minX[numVectorBoxes], &minY[numVectorBoxes], &minZ[numVectorBoxes],
+                                    &maxX[numVectorBoxes], &maxY[numVectorBoxes], &maxZ[numVectorBoxes],
+                                    numBoxes - numVectorBoxes, &results[numVectorBoxes]);
+}
+
+extern void m_sphere_overlap_box3F_soa_C(const F32 *sphere,
+                                         const F32 *minX, const F32 *minY, const F32 *minZ,
+                                         const F32 *maxX, const F32 *maxY, const F32 *maxZ,
+                                         U32 numBoxes, U8 *results);
+
+// Tests one sphere against four boxes at a time.  The arithmetic is kept in
+// the same order as the C version so results are identical.
+static void SSE_Sphere_overlap_Box3F_SoA(const F32 *sphere,
+                                         const F32 *minX, const F32 *minY, const F32 *minZ,
+                                         const F32 *maxX, const F32 *maxY, const F32 *maxZ,
+                                         U32 numBoxes, U8 *results)
+{
+   const __m128 zero = _mm_setzero_ps();
+   const __m128 cx = _mm_set1_ps(sphere[0]);
+   const __m128 cy = _mm_set1_ps(sphere[1]);
+   const __m128 cz = _mm_set1_ps(sphere[2]);
+   const __m128 radiusSq = _mm_set1_ps(sphere[3] * sphere[3]);
+
+   const U32 numVectorBoxes = numBoxes & ~3;
+   for (U32 i = 0; i < numVectorBoxes; i += 4)
+   {
+      const __m128 dx = _mm_add_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&minX[i]), cx), zero),
+                                   _mm_max_ps(_mm_sub_ps(cx, _mm_loadu_ps(&maxX[i])), zero));
+      const __m128 dy = _mm_add_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&minY[i]), cy), zero),
+                                   _mm_max_ps(_mm_sub_ps(cy, _mm_loadu_ps(&maxY[i])), zero));
+      const __m128 dz = _mm_add_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&minZ[i]), cz), zero),
+                                   _mm_max_ps(_mm_sub_ps(cz, _mm_loadu_ps(&maxZ[i])), zero));
+
+      const __m128 distSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+      const S32 mask = _mm_movemask_ps(_mm_cmple_ps(distSq, radiusSq));
+
+      results[i + 0] = (mask >> 0) & 1;
+      results[i + 1] = (mask >> 1) & 1;
+      results[i + 2] = (mask >> 2) & 1;
+      results[i + 3] = (mask >> 3) & 1;
+   }
+
+   // Do the remainder in C.
+   if (numVectorBoxes < numBoxes)
+      m_sphere_overlap_box3F_soa_C(sphere,
+                                   &minX[numVectorBoxes], &minY[numVectorBoxes], &minZ[numVectorBoxes],
+                                   &maxX[numVectorBoxes], &maxY[numVectorBoxes], &maxZ[numVectorBoxes],
+                                   numBoxes - numVectorBoxes, &results[numVectorBoxes]);
+}
+
+extern void m_cone_overlap_sphere_soa_C(const F32 *cone,
+                                        const F32 *x, const F32 *y, const F32 *z, const F32 *radius,
+                                        U32 numSpheres, U8 *results);
+
+// Tests one cone against four spheres at a time, see the C version.
+static void SSE_Cone_overlap_Sphere_SoA(const F32 *cone,
+                                        const F32 *x, const F32 *y, const F32 *z, const F32 *radius,
+                                        U32 numSpheres, U8 *results)
+{
+   const __m128 zero = _mm_setzero_ps();
+   const __m128 ax = _mm_set1_ps(cone[0]);
+   const __m128 ay = _mm_set1_ps(cone[1]);
+   const __m128 az = _mm_set1_ps(cone[2]);
+   const __m128 dx = _mm_set1_ps(cone[3]);
+   const __m128 dy = _mm_set1_ps(cone[4]);
+   const __m128 dz = _mm_set1_ps(cone[5]);
+   const __m128 length = _mm_set1_ps(cone[6]);
+   const __m128 cosAngle = _mm_set1_ps(cone[7]);
+   const __m128 sinAngle = _mm_set1_ps(cone[8]);
+
+   const U32 numVectorSpheres = numSpheres & ~3;
+   for (U32 i = 0; i < numVectorSpheres; i += 4)
+   {
+      const __m128 vx = _mm_sub_ps(_mm_loadu_ps(&x[i]), ax);
+      const __m128 vy = _mm_sub_ps(_mm_loadu_ps(&y[i]), ay);
+      const __m128 vz = _mm_sub_ps(_mm_loadu_ps(&z[i]), az);
+      const __m128 r = _mm_loadu_ps(&radius[i]);
+
+      const __m128 lenSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz));
+      const __m128 axisLen = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, dx), _mm_mul_ps(vy, dy)), _mm_mul_ps(vz, dz));
+
+      const __m128 closest = _mm_sub_ps(
+         _mm_mul_ps(cosAngle, _mm_sqrt_ps(_mm_max_ps(_mm_sub_ps(lenSq, _mm_mul_ps(axisLen, axisLen)), zero))),
+         _mm_mul_ps(axisLen, sinAngle));
+
+      const __m128 culled = _mm_or_ps(_mm_or_ps(
+         _mm_cmpgt_ps(closest, r),
+         _mm_cmpgt_ps(axisLen, _mm_add_ps(r, length))),
+         _mm_cmplt_ps(axisLen, _mm_sub_ps(zero, r)));
+
+      const S32 mask = _mm_movemask_ps(culled);
+
+      results[i + 0] = !((mask >> 0) & 1);
+      results[i + 1] = !((mask >> 1) & 1);
+      results[i + 2] = !((mask >> 2) & 1);
+      results[i + 3] = !((mask >> 3) & 1);
+   }
+
+   // Do the remainder in C.
+   if (numVectorSpheres < numSpheres)
+      m_cone_overlap_sphere_soa_C(cone, &x[numVectorSpheres], &y[numVectorSpheres], &z[numVectorSpheres],
+                                  &radius[numVectorSpheres], numSpheres - numVectorSpheres, &results[numVectorSpheres]);
+}
+
+#endif
+
 void mInstall_Library_SSE()
 {
 #if defined(ADD_SSE_FN)
@@ -382,4 +567,9 @@ void mInstall_Library_SSE()
    // m_matF_x_point3F = Athlon_MatrixF_x_Point3F;
    // m_matF_x_vectorF = Athlon_MatrixF_x_VectorF;
 #endif
+#if defined(ADD_SSE_INTRINSICS_FN)
+   m_planeF_classify_box3F_soa = SSE_PlaneF_classify_Box3F_SoA;
+   m_sphere_overlap_box3F_soa = SSE_Sphere_overlap_Box3F_SoA;
+   m_cone_overlap_sphere_soa = SSE_Cone_overlap_Sphere_SoA;
+#endif
 }
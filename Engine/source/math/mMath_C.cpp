@@ -850,6 +850,85 @@ void m_point3F_bulk_dot_indexed_C(const F32* refVector,
    }
 }
 
+void m_planeF_classify_box3F_soa_C(const F32 *planes, U32 numPlanes,
+                                   const F32 *minX, const F32 *minY, const F32 *minZ,
+                                   const F32 *maxX, const F32 *maxY, const F32 *maxZ,
+                                   U32 numBoxes, S8 *results)
+{
+   // Same logic as PlaneF::whichSide(const Box3F&) folded over
+   // PlaneSetF::testPotentialIntersection.
+
+   for (U32 i = 0; i < numBoxes; i++)
+   {
+      S8 result = GeometryInside;
+
+      for (U32 n = 0; n < numPlanes; n++)
+      {
+         const F32 *plane = &planes[n * 4];
+
+         const F32 px = (plane[0] > 0.0f) ? maxX[i] : minX[i];
+         const F32 py = (plane[1] > 0.0f) ? maxY[i] : minY[i];
+         const F32 pz = (plane[2] > 0.0f) ? maxZ[i] : minZ[i];
+
+         if ((plane[0] * px + plane[1] * py + plane[2] * pz) + plane[3] <= -0.005f)
+         {
+            result = GeometryOutside;
+            break;
+         }
+
+         const F32 nx = (plane[0] > 0.0f) ? minX[i] : maxX[i];
+         const F32 ny = (plane[1] > 0.0f) ? minY[i] : maxY[i];
+         const F32 nz = (plane[2] > 0.0f) ? minZ[i] : maxZ[i];
+
+         if ((plane[0] * nx + plane[1] * ny + plane[2] * nz) + plane[3] < 0.005f)
+            result = GeometryIntersecting;
+      }
+
+      results[i] = result;
+   }
+}
+
+// Not static so the SSE version can use it for the remainder.
+void m_sphere_overlap_box3F_soa_C(const F32 *sphere,
+                                  const F32 *minX, const F32 *minY, const F32 *minZ,
+                                  const F32 *maxX, const F32 *maxY, const F32 *maxZ,
+                                  U32 numBoxes, U8 *results)
+{
+   // Arvo's test; the distance from the center to the closest
+   // point of the box along each axis.
+   const F32 radiusSq = sphere[3] * sphere[3];
+
+   for (U32 i = 0; i < numBoxes; i++)
+   {
+      const F32 dx = getMax(minX[i] - sphere[0], 0.0f) + getMax(sphere[0] - maxX[i], 0.0f);
+      const F32 dy = getMax(minY[i] - sphere[1], 0.0f) + getMax(sphere[1] - maxY[i], 0.0f);
+      const F32 dz = getMax(minZ[i] - sphere[2], 0.0f) + getMax(sphere[2] - maxZ[i], 0.0f);
+
+      results[i] = (dx * dx + dy * dy + dz * dz) <= radiusSq;
+   }
+}
+
+// Not static so the SSE version can use it for the remainder.
+void m_cone_overlap_sphere_soa_C(const F32 *cone,
+                                 const F32 *x, const F32 *y, const F32 *z, const F32 *radius,
+                                 U32 numSpheres, U8 *results)
+{
+   for (U32 i = 0; i < numSpheres; i++)
+   {
+      const F32 vx = x[i] - cone[0];
+      const F32 vy = y[i] - cone[1];
+      const F32 vz = z[i] - cone[2];
+
+      const F32 lenSq = vx * vx + vy * vy + vz * vz;
+      const F32 axisLen = vx * cone[3] + vy * cone[4] + vz * cone[5];
+
+      // Distance from the sphere center to the closest point on the cone surface.
+      const F32 closest = cone[7] * mSqrt(getMax(lenSq - axisLen * axisLen, 0.0f)) - axisLen * cone[8];
+
+      results[i] = !(closest > radius[i] || axisLen > radius[i] + cone[6] || axisLen < -radius[i]);
+   }
+}
+
 //------------------------------------------------------------------------------
 // Math function pointer declarations
 
@@ -905,6 +984,20 @@ void (*m_matF_x_point4F)(const F32 *m, const F32 *p, F32 *presult) = m_matF_x_po
 void (*m_matF_x_scale_x_planeF)(const F32 *m, const F32* s, const F32 *p, F32 *presult) = m_matF_x_scale_x_planeF_C;
 void (*m_matF_x_box3F)(const F32 *m, F32 *min, F32 *max)    = m_matF_x_box3F_C;
 
+void (*m_planeF_classify_box3F_soa)(const F32 *planes, U32 numPlanes,
+                                    const F32 *minX, const F32 *minY, const F32 *minZ,
+                                    const F32 *maxX, const F32 *maxY, const F32 *maxZ,
+                                    U32 numBoxes, S8 *results) = m_planeF_classify_box3F_soa_C;
+
+void (*m_sphere_overlap_box3F_soa)(const F32 *sphere,
+                                   const F32 *minX, const F32 *minY, const F32 *minZ,
+                                   const F32 *maxX, const F32 *maxY, const F32 *maxZ,
+                                   U32 numBoxes, U8 *results) = m_sphere_overlap_box3F_soa_C;
+
+void (*m_cone_overlap_sphere_soa)(const F32 *cone,
+                                  const F32 *x, const F32 *y, const F32 *z, const F32 *radius,
+                                  U32 numSpheres, U8 *results) = m_cone_overlap_sphere_soa_C;
+
 //------------------------------------------------------------------------------
 void mInstallLibrary_C()
 {
@@ -949,5 +1042,9 @@ void mInstallLibrary_C()
    m_matF_x_point4F        = m_matF_x_point4F_C;
    m_matF_x_scale_x_planeF = m_matF_x_scale_x_planeF_C;
    m_matF_x_box3F          = m_matF_x_box3F_C;
+
+   m_planeF_classify_box3F_soa = m_planeF_classify_box3F_soa_C;
+   m_sphere_overlap_box3F_soa = m_sphere_overlap_box3F_soa_C;
+   m_cone_overlap_sphere_soa = m_cone_overlap_sphere_soa_C;
 }
 
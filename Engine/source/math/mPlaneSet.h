@@ -39,6 +39,14 @@
 #include "math/mOrientedBox.h"
 #endif
 
+#ifndef _MBOXSOA_H_
+#include "math/mBoxSoA.h"
+#endif
+
+#ifndef _MMATHFN_H_
+#include "math/mMathFn.h"
+#endif
+
 #ifndef _TEMPALLOC_H_
 #include "util/tempAlloc.h"
 #endif
@@ -152,6 +160,16 @@ class PlaneSet
          return _testOverlap( obb );
       }
 
+      /// Test intersection of a range of boxes in the given batch with the volume defined by
+      /// the plane set.  This gives the same results as calling testPotentialIntersection(const Box3F&)
+      /// on each box but tests several boxes at once where SIMD support is available.
+      ///
+      /// @param boxes Batch of AABBs.
+      /// @param start Index of first box in @a boxes to test.
+      /// @param numBoxes Number of boxes to test.
+      /// @param outResults Receives one OverlapTestResult for each of the boxes tested.
+      void testPotentialIntersection( const Box3FSoA& boxes, U32 start, U32 numBoxes, S8* outResults ) const;
+
       /// Returns a bitmask of which planes are hit by the given box.
       U32 testPlanes( const Box3F& bounds, U32 planeMask = 0xFFFFFFFF, F32 expand = 0.0f ) const;
 
@@ -251,6 +269,23 @@ inline OverlapTestResult PlaneSet< T >::_testOverlap( const P& bounds ) const
 
 //-----------------------------------------------------------------------------
 
+template< typename T >
+inline void PlaneSet< T >::testPotentialIntersection( const Box3FSoA& boxes, U32 start, U32 numBoxes, S8* outResults ) const
+{
+   AssertFatal( start + numBoxes <= boxes.size(), "PlaneSet::testPotentialIntersection - Box range out of bounds" );
+   AssertFatal( sizeof( T ) == sizeof( F32 ) * 4, "PlaneSet::testPotentialIntersection - Plane type must be 4 floats" );
+
+   if( !numBoxes )
+      return;
+
+   m_planeF_classify_box3F_soa( reinterpret_cast< const F32* >( mPlanes ), mNumPlanes,
+                                &boxes.getMinX()[ start ], &boxes.getMinY()[ start ], &boxes.getMinZ()[ start ],
+                                &boxes.getMaxX()[ start ], &boxes.getMaxY()[ start ], &boxes.getMaxZ()[ start ],
+                                numBoxes, outResults );
+}
+
+//-----------------------------------------------------------------------------
+
 template< typename T >
 inline bool PlaneSet< T >::isContained( const Point3F& point, F32 epsilon ) const
 {
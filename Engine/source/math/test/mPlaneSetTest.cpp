@@ -0,0 +1,144 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2014 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "math/mPlaneSet.h"
+#include "math/mRandom.h"
+#include "math/mathUtils.h"
+#include "math/util/frustum.h"
+#include "console/console.h"
+
+FIXTURE(PlaneSet)
+{
+public:
+   Box3FSoA boxes;
+   Vector<Box3F> boxList;
+   Frustum frusta[3];
+
+   void SetUp()
+   {
+      // Randomly sized boxes scattered around the origin. Use a fixed seed so
+      // the tests are deterministic.
+      MRandomLCG random(1376312589);
+      for (U32 i = 0; i < 50000; i++)
+      {
+         Point3F center(random.randF(-1000.f, 1000.f), random.randF(-1000.f, 1000.f), random.randF(-100.f, 100.f));
+         Point3F extents(random.randF(0.1f, 50.f), random.randF(0.1f, 50.f), random.randF(0.1f, 50.f));
+
+         Box3F box(center - extents, center + extents);
+         boxList.push_back(box);
+         boxes.push_back(box);
+      }
+
+      // A typical game camera, one looking down at an angle and an
+      // orthographic one like those used for shadow map cascades.
+      MatrixF xfm(true);
+      frusta[0].set(false, mDegToRad(90.f), 16.f / 9.f, 0.1f, 1000.f, xfm);
+
+      xfm.set(EulerF(mDegToRad(30.f), 0.f, mDegToRad(45.f)), Point3F(10.f, -20.f, 50.f));
+      frusta[1].set(false, mDegToRad(60.f), 4.f / 3.f, 1.f, 500.f, xfm);
+
+      xfm.set(EulerF(mDegToRad(90.f), 0.f, 0.f), Point3F(0.f, 0.f, 500.f));
+      frusta[2].set(true, -250.f, 250.f, 250.f, -250.f, 1.f, 1000.f, xfm);
+   }
+};
+
+TEST_FIX(PlaneSet, TestPotentialIntersectionBatched)
+{
+   const U32 numBoxes = boxes.size();
+   Vector<S8> results(__FILE__, __LINE__);
+   Vector<S8> resultsC(__FILE__, __LINE__);
+   results.setSize(numBoxes);
+   resultsC.setSize(numBoxes);
+
+   for (U32 f = 0; f < 3; f++)
+   {
+      const PlaneSetF planes(frusta[f].getPlanes(), frusta[f].getNumPlanes());
+
+      planes.testPotentialIntersection(boxes, 0, numBoxes, results.address());
+      m_planeF_classify_box3F_soa_C(reinterpret_cast<const F32*>(planes.getPlanes()), planes.getNumPlanes(),
+         boxes.getMinX(), boxes.getMinY(), boxes.getMinZ(),
+         boxes.getMaxX(), boxes.getMaxY(), boxes.getMaxZ(),
+         numBoxes, resultsC.address());
+
+      // The installed (possibly SIMD) version and the C version must both
+      // agree exactly with the scalar per-box test.
+      for (U32 i = 0; i < numBoxes; i++)
+      {
+         const S8 expected = planes.testPotentialIntersection(boxList[i]);
+         ASSERT_EQ(expected, results[i]) << "batched test differs from scalar test on box " << i;
+         ASSERT_EQ(expected, resultsC[i]) << "C batched test differs from scalar test on box " << i;
+      }
+   }
+
+   // Ranges not starting at a vector boundary and not spanning a full vector.
+   const PlaneSetF planes(frusta[0].getPlanes(), frusta[0].getNumPlanes());
+   planes.testPotentialIntersection(boxes, 3, 6, results.address());
+   for (U32 i = 0; i < 6; i++)
+      EXPECT_EQ(planes.testPotentialIntersection(boxList[i + 3]), results[i]);
+}
+
+TEST_FIX(PlaneSet, StressTestPotentialIntersectionBatched)
+{
+   // testPotentialIntersection() per box against the
+   // batched version on the same 50k boxes.
+
+   const U32 numBoxes = boxes.size();
+   const U32 numIterations = 20;
+
+   Vector<S8> results(__FILE__, __LINE__);
+   results.setSize(numBoxes);
+
+   U32 numInside = 0;
+   U32 scalarTime = 0;
+   U32 batchedTime = 0;
+
+   for (U32 f = 0; f < 3; f++)
+   {
+      const PlaneSetF planes(frusta[f].getPlanes(), frusta[f].getNumPlanes());
+
+      U32 start = Platform::getRealMilliseconds();
+      for (U32 n = 0; n < numIterations; n++)
+         for (U32 i = 0; i < numBoxes; i++)
+            results[i] = planes.testPotentialIntersection(boxList[i]);
+      scalarTime += Platform::getRealMilliseconds() - start;
+
+      start = Platform::getRealMilliseconds();
+      for (U32 n = 0; n < numIterations; n++)
+         planes.testPotentialIntersection(boxes, 0, numBoxes, results.address());
+      batchedTime += Platform::getRealMilliseconds() - start;
+
+      for (U32 i = 0; i < numBoxes; i++)
+         if (results[i] != GeometryOutside)
+            numInside++;
+   }
+
+   const F32 numTests = F32(numBoxes * numIterations * 3);
+   Con::printf("PlaneSet batched AABB culling: %i boxes, %i visible per pass", numBoxes, numInside / 3);
+   Con::printf("   scalar:  %.2f ns/box", F32(scalarTime) * 1000000.f / numTests);
+   Con::printf("   batched: %.2f ns/box", F32(batchedTime) * 1000000.f / numTests);
+
+   EXPECT_GT(numInside, 0u);
+}
+
+#endif
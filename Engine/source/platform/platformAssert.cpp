@@ -157,7 +157,8 @@ bool PlatformAssert::processAssert(Type        assertType,
 //--------------------------------------
 const char* avar(const char *message, ...)
 {
-   static char buffer[4096];
+   // Per-thread so worker threads formatting messages don't clobber each other.
+   static thread_local char buffer[4096];
    va_list args;
    va_start(args, message);
    dVsprintf(buffer, sizeof(buffer), message, args);
@@ -28,6 +28,7 @@
 #include "console/console.h"
 #include "platform/profiler.h"
 #include "platform/threads/mutex.h"
+#include "platform/platformIntrinsics.h"
 #include "core/module.h"
 
 // If profile paths are enabled, disable profiling of the
@@ -219,6 +220,7 @@ bool gAlwaysLogLeaks = 0;
 U32 gBytesAllocated = 0;
 U32 gBlocksAllocated = 0;
 U32 gPageBytesAllocated = 0;
+volatile U32 gAllocCount = 0;
 
 struct HeapIterator
 {
@@ -1586,6 +1588,11 @@ dsize_t getMemoryUsed()
    return size;
 }
 
+U32 getAllocCount()
+{
+   return dAtomicRead( gAllocCount );
+}
+
 #ifdef TORQUE_DEBUG_GUARD
 DefineEngineFunction( dumpAlloc, void, ( S32 allocNum ),,
 				"@brief Dumps information about the given allocated memory block.\n\n"
@@ -1720,21 +1727,25 @@ void setMinimumAllocUnit(U32 allocUnit)
 
 void* FN_CDECL operator new(dsize_t size, const char* fileName, const U32 line)
 {
+   dFetchAndAdd( Memory::gAllocCount, 1 );
    return Memory::alloc(size, false, fileName, line);
 }
 
 void* FN_CDECL operator new[](dsize_t size, const char* fileName, const U32 line)
 {
+   dFetchAndAdd( Memory::gAllocCount, 1 );
    return Memory::alloc(size, true, fileName, line);
 }
 
 void* FN_CDECL operator new(dsize_t size)
 {
+   dFetchAndAdd( Memory::gAllocCount, 1 );
    return Memory::alloc(size, false, NULL, 0);
 }
 
 void* FN_CDECL operator new[](dsize_t size)
 {
+   dFetchAndAdd( Memory::gAllocCount, 1 );
    return Memory::alloc(size, true, NULL, 0);
 }
 
@@ -1750,6 +1761,7 @@ void FN_CDECL operator delete[](void* mem)
 
 void* dMalloc_r(dsize_t in_size, const char* fileName, const dsize_t line)
 {
+   dFetchAndAdd( Memory::gAllocCount, 1 );
    return Memory::alloc(in_size, false, fileName, line);
 }
 
@@ -1760,6 +1772,7 @@ void dFree(void* in_pFree)
 
 void* dRealloc_r(void* in_pResize, dsize_t in_size, const char* fileName, const dsize_t line)
 {
+   dFetchAndAdd( Memory::gAllocCount, 1 );
    return Memory::realloc(in_pResize, in_size, fileName, line);
 }
 
@@ -1778,6 +1791,7 @@ AFTER_MODULE_INIT( Sim )
 // Don't manage our own memory
 void* dMalloc_r(dsize_t in_size, const char* fileName, const dsize_t line)
 {
+   dFetchAndAdd( Memory::gAllocCount, 1 );
    return malloc(in_size);
 }
 
@@ -1788,6 +1802,7 @@ void dFree(void* in_pFree)
 
 void* dRealloc_r(void* in_pResize, dsize_t in_size, const char* fileName, const dsize_t line)
 {
+   dFetchAndAdd( Memory::gAllocCount, 1 );
    return realloc(in_pResize,in_size);
 }
 
@@ -52,6 +52,11 @@ namespace Memory
    S32         countUnflaggedAllocs(const char *file, S32 *outUnflaggedRealloc = NULL, EFlag flag = FLAG_Debug );
    dsize_t     getMemoryUsed();
    dsize_t     getMemoryAllocated();
+
+   /// Returns the number of allocations made through dMalloc/dRealloc (and
+   /// operator new when the memory manager is enabled) since startup.  Other
+   /// threads allocate too, so deltas include their allocations.
+   U32         getAllocCount();
    void        getMemoryInfo( void* ptr, Info& info );
    void        validate();
 }
@@ -23,6 +23,7 @@
 #ifdef TORQUE_TESTS_ENABLED
 #include "testing/unitTesting.h"
 #include "platform/threads/threadPool.h"
+#include "platform/threads/threadPoolBatch.h"
 #include "console/console.h"
 #include "core/util/tVector.h"
 
@@ -58,6 +59,21 @@ public:
          Platform::sleep(ms);
       }
    };
+
+   // A batch item that counts how often it has been run.
+   struct BatchItem : public ThreadPoolBatch::Item
+   {
+      U32 mIndex;
+      Vector<U32>& mResults;
+      BatchItem(U32 index, Vector<U32>& results)
+         : mIndex(index), mResults(results) {}
+
+   protected:
+      virtual void executeItem()
+      {
+         mResults[mIndex]++;
+      }
+   };
 };
 
 TEST_FIX(ThreadPool, BasicAPI)
@@ -118,4 +134,61 @@ TEST_FIX(ThreadPool, Synchronous)
    EXPECT_EQ(true, item->hasExecuted());
 }
 
-#endif
\ No newline at end of file
+TEST_FIX(ThreadPool, Batch)
+{
+   const U32 numItems = 100;
+   Vector<U32> results(__FILE__, __LINE__);
+   results.setSize(numItems);
+   for (U32 i = 0; i < numItems; i++)
+      results[i] = 0;
+
+   // Keep the pool busy with unrelated work; waiting on the
+   // batch must not block on it.
+   ThreadPool* pool = &ThreadPool::GLOBAL();
+   ThreadSafeRef<DelayItem> delay(new DelayItem(500));
+   pool->queueWorkItem(delay);
+
+   ThreadPoolBatch batch(pool);
+   for (U32 i = 0; i < numItems; i++)
+      batch.add(new BatchItem(i, results));
+   EXPECT_EQ(numItems, batch.getNumItems());
+
+   batch.wait();
+   EXPECT_EQ(0, batch.getNumItems());
+
+   // Every item must have run exactly once.
+   for (U32 i = 0; i < numItems; i++)
+      EXPECT_EQ(1, results[i]) << "item not run exactly once";
+
+   pool->waitForAllItems();
+}
+
+TEST_FIX(ThreadPool, BatchIssue)
+{
+   const U32 numItems = 100;
+   Vector<U32> results(__FILE__, __LINE__);
+   results.setSize(numItems);
+   for (U32 i = 0; i < numItems; i++)
+      results[i] = 0;
+
+   ThreadPool* pool = &ThreadPool::GLOBAL();
+   ThreadPoolBatch batch(pool);
+
+   // Issue half the items early and add the rest after.
+   for (U32 i = 0; i < numItems / 2; i++)
+      batch.add(new BatchItem(i, results));
+   batch.issue();
+   for (U32 i = numItems / 2; i < numItems; i++)
+      batch.add(new BatchItem(i, results));
+
+   batch.wait();
+   EXPECT_EQ(0, batch.getNumItems());
+
+   // Every item must have run exactly once.
+   for (U32 i = 0; i < numItems; i++)
+      EXPECT_EQ(1, results[i]) << "item not run exactly once";
+
+   pool->waitForAllItems();
+}
+
+#endif
@@ -357,6 +357,12 @@ class ThreadPool
       /// @see ThreadPool::getMainThreadThesholdTimeMS
       static void processMainThreadWorkItems();
 
+      /// Return the number of worker threads spawned by the pool.
+      U32 getNumThreads() const
+      {
+         return mNumThreads;
+      }
+
       /// Return the interval in which item priorities are updated on the queue.
       /// @return update interval in milliseconds.
       U32 getQueueUpdateInterval() const
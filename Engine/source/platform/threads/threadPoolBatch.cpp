@@ -0,0 +1,126 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "platform/threads/threadPoolBatch.h"
+
+#include "platform/profiler.h"
+
+
+//=============================================================================
+//    ThreadPoolBatch::Item.
+//=============================================================================
+
+//--------------------------------------------------------------------------
+
+void ThreadPoolBatch::Item::_run()
+{
+   // Whoever gets here second finds the item claimed and does nothing.
+   // This is either the pool's worker picking up an item that the
+   // issuing thread has already executed during wait() or vice versa.
+
+   if( !_claim() )
+      return;
+
+   executeItem();
+   mBatch->mCompleted.release();
+}
+
+//=============================================================================
+//    ThreadPoolBatch.
+//=============================================================================
+
+//--------------------------------------------------------------------------
+
+ThreadPoolBatch::ThreadPoolBatch( ThreadPool* pool, U32 minParallelItems )
+   : mPool( pool ),
+     mCompleted( 0 ),
+     mMinParallelItems( getMax( minParallelItems, 1U ) ),
+     mNumIssued( 0 )
+{
+   VECTOR_SET_ASSOCIATION( mItems );
+}
+
+//--------------------------------------------------------------------------
+
+ThreadPoolBatch::~ThreadPoolBatch()
+{
+   wait();
+}
+
+//--------------------------------------------------------------------------
+
+void ThreadPoolBatch::add( Item* item )
+{
+   AssertFatal( item->mBatch == NULL, "ThreadPoolBatch::add - item already belongs to a batch" );
+
+   item->mBatch = this;
+   mItems.push_back( item );
+}
+
+//--------------------------------------------------------------------------
+
+void ThreadPoolBatch::issue()
+{
+   if( mPool )
+      for( U32 i = mNumIssued; i < mItems.size(); ++ i )
+         mPool->queueWorkItem( mItems[ i ] );
+
+   mNumIssued = mItems.size();
+}
+
+//--------------------------------------------------------------------------
+
+void ThreadPoolBatch::wait()
+{
+   if( mItems.empty() )
+      return;
+
+   PROFILE_SCOPE( ThreadPoolBatch_wait );
+
+   const U32 numItems = mItems.size();
+
+   // Hand all but the first item to the pool.  The first one we always
+   // run ourselves.  If the batch is too small to make this worthwhile,
+   // do everything on this thread.  Skip any items issue() already
+   // handed over.
+
+   if( mPool && numItems >= mMinParallelItems )
+      for( U32 i = getMax( mNumIssued, 1U ); i < numItems; ++ i )
+         mPool->queueWorkItem( mItems[ i ] );
+
+   // Run whatever no worker has picked up yet.  Going through the list
+   // in order means we take work from the same end that the workers do
+   // but since items are claimed atomically, this is merely a matter of
+   // how much work gets duplicated in checks, not of correctness.
+
+   for( U32 i = 0; i < numItems; ++ i )
+      mItems[ i ]->_run();
+
+   // Wait for the items still being processed by workers.
+
+   for( U32 i = 0; i < numItems; ++ i )
+      mCompleted.acquire();
+
+   mItems.clear();
+   mNumIssued = 0;
+}
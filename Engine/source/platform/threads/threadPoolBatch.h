@@ -0,0 +1,141 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _THREADPOOLBATCH_H_
+#define _THREADPOOLBATCH_H_
+
+#ifndef _THREADPOOL_H_
+   #include "platform/threads/threadPool.h"
+#endif
+#ifndef _TVECTOR_H_
+   #include "core/util/tVector.h"
+#endif
+
+
+/// @file
+/// Fork/join helper on top of ThreadPool.
+
+
+/// A set of work items that are issued together and waited on as a unit.
+///
+/// ThreadPool::waitForAllItems() blocks until the pool's entire queue has
+/// drained which, on the global pool, includes unrelated long-running work
+/// like async I/O.  A batch only waits for its own items.  Also, while
+/// waiting, the issuing thread will pick up any of the batch's items that
+/// no worker has started yet so a batch never stalls behind a busy pool.
+///
+/// This makes batches suitable for splitting per-frame work (culling, particle
+/// updates, etc.) across the pool's worker threads.
+///
+/// @note Batches follow the same rule as the global pool: only issue them from
+///   the main thread.
+class ThreadPoolBatch
+{
+   public:
+
+      /// A work item that belongs to a batch.  Subclasses implement
+      /// executeItem() rather than execute().
+      class Item : public ThreadPool::WorkItem
+      {
+         public:
+
+            typedef ThreadPool::WorkItem Parent;
+            friend class ThreadPoolBatch;
+
+         protected:
+
+            /// Batch that issued this item.
+            ThreadPoolBatch* mBatch;
+
+            /// Set to 1 by whichever thread gets to execute the item first.
+            volatile U32 mClaimed;
+
+            /// Try to claim the item for execution on the calling thread.
+            bool _claim() { return dCompareAndSwap( mClaimed, 0, 1 ); }
+
+            /// Run the item if it has not yet been claimed by another thread.
+            void _run();
+
+            // WorkItem.
+            virtual void execute() { _run(); }
+
+            /// Do the actual work of the item.
+            virtual void executeItem() = 0;
+
+         public:
+
+            Item( ThreadPool::Context* context = 0 )
+               : Parent( context ),
+                 mBatch( NULL ),
+                 mClaimed( 0 ) {}
+      };
+
+      typedef ThreadSafeRef< Item > ItemPtr;
+
+   protected:
+
+      /// Pool to which items are issued.
+      ThreadPool* mPool;
+
+      /// Items issued through this batch since the last wait().
+      Vector< ItemPtr > mItems;
+
+      /// Released once for every completed item.
+      Semaphore mCompleted;
+
+      /// Minimum number of items before work is sent to the pool.
+      U32 mMinParallelItems;
+
+      /// Number of items already handed to the pool by issue().
+      U32 mNumIssued;
+
+   public:
+
+      /// Create a batch that issues its items to the given pool.
+      ///
+      /// @param pool Thread pool to run items on; defaults to the global pool.
+      /// @param minParallelItems If fewer than this many items are in the batch
+      ///   when wait() is called, all items are simply run on the calling thread.
+      ThreadPoolBatch( ThreadPool* pool = &ThreadPool::GLOBAL(), U32 minParallelItems = 2 );
+
+      /// Waits for any outstanding items.
+      ~ThreadPoolBatch();
+
+      /// Add an item to the batch.  The item is not issued to the pool
+      /// until wait() is called.
+      void add( Item* item );
+
+      /// Return the number of items in the batch.
+      U32 getNumItems() const { return mItems.size(); }
+
+      /// Hand the items added so far to the pool without waiting so
+      /// the calling thread can do other work while they run.  A later
+      /// wait() is still required to complete them.
+      void issue();
+
+      /// Issue all items to the pool and block until every one of them
+      /// has completed.  The calling thread participates in running
+      /// the items.  Afterwards, the batch is empty and can be reused.
+      void wait();
+};
+
+#endif // !_THREADPOOLBATCH_H_
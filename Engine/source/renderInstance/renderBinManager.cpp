@@ -27,10 +27,38 @@
 #include "materials/matInstance.h"
 #include "scene/sceneManager.h"
 #include "console/engineAPI.h"
+#include "core/module.h"
+#include "core/util/hashFunction.h"
+#include "gfx/gfxDevice.h"
 
 
 IMPLEMENT_CONOBJECT(RenderBinManager);
 
+bool RenderBinManager::smAutoInstancing = true;
+U32 RenderBinManager::smInstancingDrawsSaved = 0;
+
+static bool _clearInstancingStats( GFXDevice::GFXDeviceEventType type )
+{
+   if ( type == GFXDevice::deStartOfFrame )
+      RenderBinManager::smInstancingDrawsSaved = 0;
+
+   return true;
+}
+
+AFTER_MODULE_INIT( Sim )
+{
+   Con::addVariable( "$pref::Rendering::autoInstancing", TypeBool, &RenderBinManager::smAutoInstancing,
+      "@brief Groups identical mesh instances after the render bins are sorted so that "
+      "each group is drawn with a single instanced draw call.\n"
+      "Only meshes which use an instancing material are grouped.\n"
+      "@see $pref::TS::maxInstancingVerts\n"
+      "@ingroup RenderBin\n" );
+
+   Con::addVariable( "$RenderBinStats::instancingDrawsSaved", TypeS32, &RenderBinManager::smInstancingDrawsSaved, "@internal" );
+
+   GFXDevice::getDeviceEventSignal().notify( &_clearInstancingStats );
+}
+
 
 RenderBinManager::RenderBinManager( const RenderInstType& ritype, F32 renderOrder, F32 processAddOrder ) :
    mProcessAddOrder( processAddOrder ),
@@ -40,6 +68,8 @@ RenderBinManager::RenderBinManager( const RenderInstType& ritype, F32 renderOrde
    mBasicOnly ( false )
 {
    VECTOR_SET_ASSOCIATION( mElementList );
+   VECTOR_SET_ASSOCIATION( mGroupKeys );
+   VECTOR_SET_ASSOCIATION( mGroupScratch );
    mElementList.reserve( 2048 );
 }
 
@@ -141,6 +171,45 @@ void RenderBinManager::sort()
    dQsort( mElementList.address(), mElementList.size(), sizeof(MainSortElem), cmpKeyFunc);
 }
 
+U32 RenderBinManager::getInstanceGroupKey( RenderInst *inst )
+{
+   if ( inst->type != RenderPassManager::RIT_Mesh )
+      return 0;
+
+   MeshRenderInst *ri = static_cast<MeshRenderInst*>( inst );
+   if ( !ri->matInst || !ri->matInst->isInstanced() || ri->mCustomShaderData.size() > 0 )
+      return 0;
+
+   // Hash everything newPassNeeded() compares.  A collision only
+   // costs a broken batch as the render loops still compare the
+   // instances before drawing them together.
+   const void *batchData[] = { ri->vertBuff, ri->primBuff, ri->prim };
+   U32 key = Torque::hash( (const U8*)batchData, sizeof( batchData ), ri->matInst->getStateHint() );
+   key = Torque::hash( (const U8*)ri->lights, sizeof( ri->lights ), key ^ ri->primBuffIndex );
+
+   return key ? key : 1;
+}
+
+void RenderBinManager::groupInstances( Vector< MainSortElem > &elements )
+{
+   PROFILE_SCOPE( RenderBinManager_groupInstances );
+
+   const U32 count = elements.size();
+   if ( count < 2 )
+      return;
+
+   mGroupKeys.setSize( count );
+   for ( U32 i = 0; i < count; i++ )
+      mGroupKeys[i] = getInstanceGroupKey( elements[i].inst );
+
+   mGrouper.computeOrder( mGroupKeys.address(), count );
+   if ( mGrouper.getRunsBefore() == mGrouper.getRunsAfter() )
+      return;
+
+   mGrouper.applyOrder( elements, mGroupScratch );
+   smInstancingDrawsSaved += mGrouper.getRunsBefore() - mGrouper.getRunsAfter();
+}
+
 S32 FN_CDECL RenderBinManager::cmpKeyFunc(const void* p1, const void* p2)
 {
    const MainSortElem* mse1 = (const MainSortElem*) p1;
@@ -171,6 +240,7 @@ void RenderBinManager::setupSGData(MeshRenderInst *ri, SceneData &data)
    data.accuTex      = ri->accuTex;
    data.lightmap     = ri->lightmap;
    data.visibility   = ri->visibility;
+   data.screenSize   = ri->screenSize;
    data.materialHint = ri->materialHint;
    data.customShaderData.clear();
    for (U32 i = 0; i < ri->mCustomShaderData.size(); i++)
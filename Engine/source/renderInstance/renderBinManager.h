@@ -34,6 +34,9 @@
 #ifndef _UTIL_DELEGATE_H_
 #include "core/util/delegate.h"
 #endif
+#ifndef _RENDERINSTANCEGROUPER_H_
+#include "renderInstance/renderInstanceGrouper.h"
+#endif
 
 class SceneRenderState;
 
@@ -75,12 +78,24 @@ public:
    /// Returns the primary render instance type.
    const RenderInstType& getRenderInstType() { return mRenderInstType; }
 
+   /// Returns the number of instances added to this bin since the last clear.
+   U32 getElementCount() const { return mElementList.size(); }
+
    /// Returns the render pass this bin is registered to.
    RenderPassManager* getRenderPass() const { return mRenderPass; }
 
    /// QSort callback function
    static S32 FN_CDECL cmpKeyFunc(const void* p1, const void* p2);
 
+   /// If true the mesh bins regroup their instances after sorting
+   /// so that each set of identical instanced meshes is drawn with
+   /// a single instanced draw call.
+   static bool smAutoInstancing;
+
+   /// The number of draw calls removed by instance grouping
+   /// since the start of the frame.
+   static U32 smInstancingDrawsSaved;
+
    DECLARE_CONOBJECT(RenderBinManager);
    static void initPersistFields();
 
@@ -119,6 +134,19 @@ protected:
    virtual void setupSGData(MeshRenderInst *ri, SceneData &data );
    virtual void internalAddElement(RenderInst* inst);
 
+   /// Moves the mesh instances which share an instanced material and
+   /// geometry next to each other.  Called after sorting the list.
+   /// @see smAutoInstancing
+   void groupInstances( Vector< MainSortElem > &elements );
+
+   /// Returns the key used to group the instance or zero if
+   /// it cannot be drawn instanced.
+   static U32 getInstanceGroupKey( RenderInst *inst );
+
+   RenderInstanceGrouper mGrouper;
+   Vector< U32 > mGroupKeys;
+   Vector< MainSortElem > mGroupScratch;
+
    /// A inlined helper method for testing if the next 
    /// MeshRenderInst requires a new batch/pass.
    inline bool newPassNeeded( MeshRenderInst *ri, MeshRenderInst* nextRI ) const;
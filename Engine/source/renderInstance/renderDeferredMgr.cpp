@@ -289,6 +289,12 @@ void RenderDeferredMgr::sort()
 {
    PROFILE_SCOPE( RenderDeferredMgr_sort );
    Parent::sort();
+
+   // The meshes are sorted front to back, so group the instanced
+   // ones or they will rarely end up next to each other.
+   if ( smAutoInstancing )
+      groupInstances( mElementList );
+
    dQsort( mTerrainElementList.address(), mTerrainElementList.size(), sizeof(MainSortElem), cmpKeyFunc);
    dQsort( mObjectElementList.address(), mObjectElementList.size(), sizeof(MainSortElem), cmpKeyFunc);
 }
@@ -951,7 +957,7 @@ void LinearEyeDepthConditioner::processPix( Vector<ShaderComponent*> &componentL
 
    meta->addStatement( assignOutput( depth ) );
 
-   output = meta;
+   setOutput( meta );
 }
 
 Var *LinearEyeDepthConditioner::_conditionOutput( Var *unconditionedOutput, MultiLine *meta )
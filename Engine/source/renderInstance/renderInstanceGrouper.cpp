@@ -0,0 +1,103 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "renderInstance/renderInstanceGrouper.h"
+#include "platform/profiler.h"
+
+
+RenderInstanceGrouper::RenderInstanceGrouper()
+   :  mRunsBefore( 0 ),
+      mRunsAfter( 0 )
+{
+   VECTOR_SET_ASSOCIATION( mSorted );
+   VECTOR_SET_ASSOCIATION( mGroupStart );
+   VECTOR_SET_ASSOCIATION( mOrder );
+}
+
+S32 QSORT_CALLBACK RenderInstanceGrouper::_cmpKeyIndex( const void *a, const void *b )
+{
+   const KeyIndex *ka = (const KeyIndex*)a;
+   const KeyIndex *kb = (const KeyIndex*)b;
+
+   if ( ka->key != kb->key )
+      return ka->key < kb->key ? -1 : 1;
+
+   return S32( ka->index ) - S32( kb->index );
+}
+
+void RenderInstanceGrouper::computeOrder( const U32 *keys, U32 count )
+{
+   PROFILE_SCOPE( RenderInstanceGrouper_computeOrder );
+
+   mRunsBefore = 0;
+   mRunsAfter = 0;
+
+   // Gather the groupable instances and sort them by key
+   // keeping the bin order within each key.
+   mSorted.clear();
+   for ( U32 i = 0; i < count; i++ )
+   {
+      if ( !keys[i] )
+         continue;
+
+      if ( i == 0 || keys[i] != keys[i-1] )
+         mRunsBefore++;
+
+      mSorted.increment();
+      mSorted.last().key = keys[i];
+      mSorted.last().index = i;
+   }
+
+   dQsort( mSorted.address(), mSorted.size(), sizeof( KeyIndex ), _cmpKeyIndex );
+
+   // The first entry of each key is the instance
+   // the rest of the group is moved up to.
+   mGroupStart.setSize( count );
+   dMemset( mGroupStart.address(), 0xFF, count * sizeof( S32 ) );
+   for ( U32 i = 0; i < mSorted.size(); i++ )
+   {
+      if ( i == 0 || mSorted[i].key != mSorted[i-1].key )
+      {
+         mGroupStart[ mSorted[i].index ] = i;
+         mRunsAfter++;
+      }
+   }
+
+   mOrder.clear();
+   mOrder.reserve( count );
+   for ( U32 i = 0; i < count; i++ )
+   {
+      if ( !keys[i] )
+      {
+         mOrder.push_back( i );
+         continue;
+      }
+
+      const S32 start = mGroupStart[i];
+      if ( start < 0 )
+         continue;
+
+      for ( U32 j = start; j < mSorted.size() && mSorted[j].key == keys[i]; j++ )
+         mOrder.push_back( mSorted[j].index );
+   }
+}
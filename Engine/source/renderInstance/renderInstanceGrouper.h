@@ -0,0 +1,91 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _RENDERINSTANCEGROUPER_H_
+#define _RENDERINSTANCEGROUPER_H_
+
+#ifndef _TVECTOR_H_
+#include "core/util/tVector.h"
+#endif
+
+
+/// Reorders a sorted render bin so that the instances which can be
+/// drawn together with one instanced draw call are contiguous.
+///
+/// Each instance is given a group key with zero meaning it cannot
+/// be grouped.  All the instances sharing a key are moved up next
+/// to the first of them, so a bin sorted front to back stays mostly
+/// front to back.  Ungrouped instances and the groups themselves
+/// keep their sorted order.
+class RenderInstanceGrouper
+{
+public:
+
+   RenderInstanceGrouper();
+
+   /// Computes the grouped order for the keys.
+   void computeOrder( const U32 *keys, U32 count );
+
+   /// Returns the source index for each slot of the grouped order.
+   const Vector<U32>& getOrder() const { return mOrder; }
+
+   /// Returns the runs of equal non-zero keys before grouping.
+   U32 getRunsBefore() const { return mRunsBefore; }
+
+   /// Returns the runs of equal non-zero keys after grouping,
+   /// which is the number of distinct keys.
+   U32 getRunsAfter() const { return mRunsAfter; }
+
+   /// Reorders the elements by the last computed order.
+   template<class T>
+   void applyOrder( Vector<T> &elements, Vector<T> &scratch ) const
+   {
+      AssertFatal( elements.size() == mOrder.size(), "RenderInstanceGrouper::applyOrder - Order is out of date!" );
+
+      scratch = elements;
+      for ( U32 i = 0; i < mOrder.size(); i++ )
+         elements[i] = scratch[ mOrder[i] ];
+   }
+
+protected:
+
+   struct KeyIndex
+   {
+      U32 key;
+      U32 index;
+   };
+
+   static S32 QSORT_CALLBACK _cmpKeyIndex( const void *a, const void *b );
+
+   Vector<KeyIndex> mSorted;
+
+   /// For the first instance of each group the position of the
+   /// group within mSorted, otherwise -1.
+   Vector<S32> mGroupStart;
+
+   Vector<U32> mOrder;
+
+   U32 mRunsBefore;
+   U32 mRunsAfter;
+};
+
+#endif // _RENDERINSTANCEGROUPER_H_
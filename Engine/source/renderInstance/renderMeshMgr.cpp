@@ -89,6 +89,17 @@ void RenderMeshMgr::addElement( RenderInst *inst )
    internalAddElement(inst);
 }
 
+//-----------------------------------------------------------------------------
+// sort
+//-----------------------------------------------------------------------------
+void RenderMeshMgr::sort()
+{
+   Parent::sort();
+
+   if ( smAutoInstancing )
+      groupInstances( mElementList );
+}
+
 //-----------------------------------------------------------------------------
 // render
 //-----------------------------------------------------------------------------
@@ -40,6 +40,7 @@ public:
    virtual void init();
    virtual void render(SceneRenderState * state);
    virtual void addElement( RenderInst *inst );
+   virtual void sort();
 
    // ConsoleObject interface
    static void initPersistFields();
@@ -364,6 +364,10 @@ struct MeshRenderInst : public RenderInst
    bool  reflective;
    F32   visibility;
 
+   /// The approximate size of the mesh on screen in pixels
+   /// or zero if unknown.  Used for texture streaming.
+   F32   screenSize;
+
    /// A generic hint value passed from the game
    /// code down to the material for use by shader 
    /// features.
@@ -0,0 +1,115 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2014 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "renderInstance/renderInstanceGrouper.h"
+#include "math/mRandom.h"
+#include "console/console.h"
+
+TEST(RenderInstanceGrouper, Order)
+{
+   // Zero keys never group and stay where they are relative to
+   // the groups, which take the place of their first instance.
+   const U32 keys[] = { 5, 0, 7, 5, 0, 7, 5, 9 };
+   const U32 expected[] = { 0, 3, 6, 1, 2, 5, 4, 7 };
+
+   RenderInstanceGrouper grouper;
+   grouper.computeOrder(keys, 8);
+
+   const Vector<U32> &order = grouper.getOrder();
+   ASSERT_EQ(order.size(), 8);
+   for (U32 i = 0; i < 8; i++)
+      EXPECT_EQ(order[i], expected[i]) << "Wrong source at slot " << i;
+
+   EXPECT_EQ(grouper.getRunsBefore(), 6);
+   EXPECT_EQ(grouper.getRunsAfter(), 3);
+
+   Vector<U32> elements;
+   for (U32 i = 0; i < 8; i++)
+      elements.push_back(keys[i]);
+
+   Vector<U32> scratch;
+   grouper.applyOrder(elements, scratch);
+   const U32 grouped[] = { 5, 5, 5, 0, 7, 7, 0, 9 };
+   for (U32 i = 0; i < 8; i++)
+      EXPECT_EQ(elements[i], grouped[i]);
+}
+
+TEST(RenderInstanceGrouper, AlreadyGrouped)
+{
+   const U32 keys[] = { 0, 3, 3, 3, 0, 0, 4, 4 };
+
+   RenderInstanceGrouper grouper;
+   grouper.computeOrder(keys, 8);
+
+   EXPECT_EQ(grouper.getRunsBefore(), grouper.getRunsAfter());
+   for (U32 i = 0; i < 8; i++)
+      EXPECT_EQ(grouper.getOrder()[i], i);
+
+   grouper.computeOrder(NULL, 0);
+   EXPECT_EQ(grouper.getOrder().size(), 0);
+   EXPECT_EQ(grouper.getRunsAfter(), 0);
+}
+
+TEST(RenderInstanceGrouper, StressTestDenseScene)
+{
+   // A deferred bin of 20k statics sorted front to back, so the
+   // copies of each mesh end up scattered through it.  Grouping
+   // has to save more draws than it costs to be worth doing.
+
+   const U32 numInstances = 20000;
+   const U32 numMeshes = 40;
+   const U32 numFrames = 50;
+
+   MRandomLCG random(1376312589);
+
+   Vector<U32> keys;
+   keys.setSize(numInstances);
+   for (U32 i = 0; i < numInstances; i++)
+      keys[i] = random.randI(1, numMeshes);
+
+   Vector<U32> elements;
+   Vector<U32> scratch;
+   RenderInstanceGrouper grouper;
+
+   const U32 start = Platform::getRealMilliseconds();
+   for (U32 i = 0; i < numFrames; i++)
+   {
+      elements = keys;
+      grouper.computeOrder(elements.address(), numInstances);
+      grouper.applyOrder(elements, scratch);
+   }
+   const U32 elapsed = Platform::getRealMilliseconds() - start;
+
+   Con::printf("RenderInstanceGrouper: %d instances of %d meshes: %d draws before, %d after, %.3fms per frame",
+      numInstances, numMeshes, grouper.getRunsBefore(), grouper.getRunsAfter(), F32(elapsed) / numFrames);
+
+   U32 runs = 1;
+   for (U32 i = 1; i < numInstances; i++)
+      runs += elements[i] != elements[i - 1];
+
+   EXPECT_EQ(grouper.getRunsAfter(), numMeshes);
+   EXPECT_EQ(runs, numMeshes);
+}
+
+#endif
@@ -31,6 +31,9 @@
 #include "terrain/terrData.h"
 #include "util/tempAlloc.h"
 #include "gfx/sim/debugDraw.h"
+#include "platform/threads/threadPoolBatch.h"
+#include "math/mBoxSoA.h"
+#include "collision/occluderPolyList.h"
 
 
 extern bool gEditingMission;
@@ -41,6 +44,12 @@ bool SceneCullingState::smDisableZoneCulling = false;
 U32 SceneCullingState::smMaxOccludersPerZone = 4;
 F32 SceneCullingState::smOccluderMinWidthPercentage = 0.1f;
 F32 SceneCullingState::smOccluderMinHeightPercentage = 0.1f;
+S32 SceneCullingState::smParallelCullThreshold = 2048;
+bool SceneCullingState::smSoftwareOcclusion = false;
+U32 SceneCullingState::smSoftwareOcclusionWidth = 256;
+U32 SceneCullingState::smSoftwareOcclusionHeight = 128;
+U32 SceneCullingState::smMaxSoftwareOccluders = 16;
+F32 SceneCullingState::smSoftwareOccluderMinScreenArea = 0.005f;
 
 
 
@@ -712,6 +721,89 @@ U32 SceneCullingState::cullObjects( SceneObject** objects, U32 numObjects, U32 c
 {
    PROFILE_SCOPE( SceneCullingState_cullObjects );
 
+   // Terrain occlusion is safe to run concurrently as
+   // TerrainBlock::castRay() is reentrant.
+
+   if( smParallelCullThreshold > 0 &&
+       numObjects >= U32( smParallelCullThreshold ) )
+      return _cullObjectsParallel( objects, numObjects, cullOptions );
+
+   return _cullObjects( objects, numObjects, cullOptions );
+}
+
+//-----------------------------------------------------------------------------
+
+SceneCullingState::ObjectCullTest SceneCullingState::_getObjectCullTest( SceneObject* object, U32 cullOptions ) const
+{
+   // If we should respect editor overrides, test that now.
+
+   if( !( cullOptions & CullEditorOverrides ) &&
+       gEditingMission &&
+       ( ( object->isCullingDisabledInEditor() && object->isRenderEnabled() ) || object->isSelected() ) )
+   {
+      return ObjectCullTestAccept;
+   }
+
+   // If the object is render-disabled, it gets culled.  The only
+   // way around this is the editor override above.
+
+   else if( !( cullOptions & DontCullRenderDisabled ) &&
+            !object->isRenderEnabled() )
+   {
+      return ObjectCullTestReject;
+   }
+
+   // Global bounds objects are never culled.  Note that this means
+   // that if these objects are to respect zoning, they need to manually
+   // trigger the respective culling checks for whatever they want to
+   // batch.
+
+   else if( object->isGlobalBounds() )
+      return ObjectCullTestAccept;
+
+   // If terrain occlusion checks are enabled, run them now.
+
+   else if( !mDisableTerrainOcclusion &&
+            object->getWorldBox().minExtents.x > -1e5 &&
+            isOccludedByTerrain( object ) )
+   {
+      // Occluded by terrain.
+      return ObjectCullTestReject;
+   }
+
+   // If the object shouldn't be subjected to more fine-grained culling
+   // or if zone culling is disabled, just test against the root frustum.
+
+   else if( !( object->getTypeMask() & CULLING_INCLUDE_TYPEMASK ) ||
+            ( object->getTypeMask() & CULLING_EXCLUDE_TYPEMASK ) ||
+            disableZoneCulling() )
+   {
+      return ObjectCullTestFrustum;
+   }
+
+   // Otherwise the object needs to be tested against the
+   // culling volumes of the zones it is assigned to.
+
+   return ObjectCullTestZones;
+}
+
+//-----------------------------------------------------------------------------
+
+U32 SceneCullingState::_cullObjects( SceneObject** objects, U32 numObjects, U32 cullOptions ) const
+{
+   // Below a handful of objects, setting up the batches
+   // costs more than it saves.
+
+   if( numObjects < 8 )
+      return _cullObjectsSerial( objects, numObjects, cullOptions );
+
+   return _cullObjectsBatched( objects, numObjects, cullOptions );
+}
+
+//-----------------------------------------------------------------------------
+
+U32 SceneCullingState::_cullObjectsSerial( SceneObject** objects, U32 numObjects, U32 cullOptions ) const
+{
    U32 numRemainingObjects = 0;
 
    // We test near and far planes separately in order to not do the tests
@@ -724,73 +816,267 @@ U32 SceneCullingState::cullObjects( SceneObject** objects, U32 numObjects, U32 c
       SceneObject* object = objects[ i ];
       bool isCulled = true;
 
-      // If we should respect editor overrides, test that now.
-
-      if( !( cullOptions & CullEditorOverrides ) &&
-          gEditingMission &&
-          ( ( object->isCullingDisabledInEditor() && object->isRenderEnabled() ) || object->isSelected() ) )
+      const ObjectCullTest cullTest = _getObjectCullTest( object, cullOptions );
+      switch( cullTest )
       {
-         isCulled = false;
-      }
+         case ObjectCullTestAccept:
+            isCulled = false;
+            break;
 
-      // If the object is render-disabled, it gets culled.  The only
-      // way around this is the editor override above.
+         case ObjectCullTestReject:
+            isCulled = true;
+            break;
 
-      else if( !( cullOptions & DontCullRenderDisabled ) &&
-               !object->isRenderEnabled() )
-      {
-         isCulled = true;
+         case ObjectCullTestFrustum:
+            isCulled = getCullingFrustum().isCulled( object->getWorldBox() );
+            break;
+
+         // Go through the zones that the object is assigned to and
+         // test the object against the frustums of each of the zones.
+
+         case ObjectCullTestZones:
+         {
+            CullingTestResult result = _test(
+               object->getWorldBox(),
+               SceneObject::ObjectZonesIterator( object ),
+               nearPlane,
+               farPlane
+            );
+
+            isCulled = ( result == SceneZoneCullingState::CullingTestNegative ||
+                         result == SceneZoneCullingState::CullingTestPositiveByOcclusion );
+            break;
+         }
       }
 
-      // Global bounds objects are never culled.  Note that this means
-      // that if these objects are to respect zoning, they need to manually
-      // trigger the respective culling checks for whatever they want to
-      // batch.
+      if( !isCulled )
+         isCulled = isOccludedWithExtraPlanesCull( object->getWorldBox() );
 
-      else if( object->isGlobalBounds() )
-         isCulled = false;
+      // Objects that are accepted without geometric tests are
+      // not subject to software occlusion either.
 
-      // If terrain occlusion checks are enabled, run them now.
+      if( !isCulled && cullTest != ObjectCullTestAccept )
+         isCulled = _isSoftwareOccluded( object );
 
-      else if( !mDisableTerrainOcclusion &&
-               object->getWorldBox().minExtents.x > -1e5 &&
-               isOccludedByTerrain( object ) )
-      {
-         // Occluded by terrain.
-         isCulled = true;
-      }
+      if( !isCulled )
+         objects[ numRemainingObjects ++ ] = object;
+   }
+
+   return numRemainingObjects;
+}
+
+//-----------------------------------------------------------------------------
 
-      // If the object shouldn't be subjected to more fine-grained culling
-      // or if zone culling is disabled, just test against the root frustum.
+namespace {
+
+   /// An object queued for batched testing against the volumes of a single zone.
+   struct ZoneCullEntry
+   {
+      U32 mZone;
+      U32 mObjectIndex;
+   };
+
+   S32 QSORT_CALLBACK _compareZoneCullEntries( const void* a, const void* b )
+   {
+      const ZoneCullEntry* entryA = reinterpret_cast< const ZoneCullEntry* >( a );
+      const ZoneCullEntry* entryB = reinterpret_cast< const ZoneCullEntry* >( b );
+
+      if( entryA->mZone != entryB->mZone )
+         return ( entryA->mZone < entryB->mZone ) ? -1 : 1;
+
+      return S32( entryA->mObjectIndex ) - S32( entryB->mObjectIndex );
+   }
+}
+
+U32 SceneCullingState::_cullObjectsBatched( SceneObject** objects, U32 numObjects, U32 cullOptions ) const
+{
+   PROFILE_SCOPE( SceneCullingState_cullObjectsBatched );
+
+   // This gives the exact same results as _cullObjectsSerial() but rather than
+   // testing one object at a time against one plane at a time, the world boxes
+   // of all objects that need geometric tests are gathered in SoA form and then
+   // tested in bulk against each plane set.
+   //
+   // Objects tested against the root frustum only go into one batch.  Objects
+   // that are in exactly one zone are sorted by zone so that each zone's objects
+   // form a contiguous run that can be tested against that zone's culling volumes.
+   // Objects spanning several zones are rare enough to just go the serial route.
+
+   TempAlloc< bool > isCulled( numObjects );
+   TempAlloc< bool > isAccepted( numObjects );
 
-      else if( !( object->getTypeMask() & CULLING_INCLUDE_TYPEMASK ) ||
-               ( object->getTypeMask() & CULLING_EXCLUDE_TYPEMASK ) ||
-               disableZoneCulling() )
+   Box3FSoA frustumBoxes;
+   Vector< U32 > frustumObjects;
+   Vector< ZoneCullEntry > zoneEntries;
+
+   const PlaneF* frustumPlanes = getCullingFrustum().getPlanes();
+   const PlaneF& nearPlane = frustumPlanes[ Frustum::PlaneNear ];
+   const PlaneF& farPlane = frustumPlanes[ Frustum::PlaneFar ];
+
+   for( U32 i = 0; i < numObjects; ++ i )
+   {
+      SceneObject* object = objects[ i ];
+      const ObjectCullTest cullTest = _getObjectCullTest( object, cullOptions );
+
+      isAccepted[ i ] = ( cullTest == ObjectCullTestAccept );
+
+      switch( cullTest )
       {
-         isCulled = getCullingFrustum().isCulled( object->getWorldBox() );
+         case ObjectCullTestAccept:
+            isCulled[ i ] = false;
+            break;
+
+         case ObjectCullTestReject:
+            isCulled[ i ] = true;
+            break;
+
+         case ObjectCullTestFrustum:
+            frustumObjects.push_back( i );
+            frustumBoxes.push_back( object->getWorldBox() );
+            break;
+
+         case ObjectCullTestZones:
+         {
+            SceneObject::ZoneRef* zoneRef = object->_getZoneRefHead();
+            if( zoneRef && !zoneRef->nextInObj )
+            {
+               ZoneCullEntry entry;
+               entry.mZone = zoneRef->zone;
+               entry.mObjectIndex = i;
+               zoneEntries.push_back( entry );
+            }
+            else
+            {
+               CullingTestResult result = _test(
+                  object->getWorldBox(),
+                  SceneObject::ObjectZonesIterator( object ),
+                  nearPlane,
+                  farPlane
+               );
+
+               isCulled[ i ] = ( result == SceneZoneCullingState::CullingTestNegative ||
+                                 result == SceneZoneCullingState::CullingTestPositiveByOcclusion );
+            }
+            break;
+         }
       }
+   }
 
-      // Go through the zones that the object is assigned to and
-      // test the object against the frustums of each of the zones.
+   // Test against the root frustum.
 
-      else
+   if( !frustumObjects.empty() )
+   {
+      const U32 numBoxes = frustumBoxes.size();
+      TempAlloc< S8 > results( numBoxes );
+
+      PlaneSetF( frustumPlanes, getCullingFrustum().getNumPlanes() )
+         .testPotentialIntersection( frustumBoxes, 0, numBoxes, results );
+
+      for( U32 i = 0; i < numBoxes; ++ i )
+         isCulled[ frustumObjects[ i ] ] = ( results[ i ] == GeometryOutside );
+   }
+
+   // Test against zone culling volumes.
+
+   if( !zoneEntries.empty() )
+   {
+      const U32 numEntries = zoneEntries.size();
+      dQsort( zoneEntries.address(), numEntries, sizeof( ZoneCullEntry ), _compareZoneCullEntries );
+
+      Box3FSoA zoneBoxes;
+      zoneBoxes.reserve( numEntries );
+      for( U32 i = 0; i < numEntries; ++ i )
+         zoneBoxes.push_back( objects[ zoneEntries[ i ].mObjectIndex ]->getWorldBox() );
+
+      TempAlloc< S8 > results( numEntries );
+      TempAlloc< bool > isDecided( numEntries );
+
+      // Near and far plane are adjacent in the frustum's plane list.
+
+      const PlaneSetF nearFarPlanes( &frustumPlanes[ Frustum::PlaneNear ], 2 );
+
+      for( U32 runStart = 0; runStart < numEntries; )
       {
-         CullingTestResult result = _test(
-            object->getWorldBox(),
-            SceneObject::ObjectZonesIterator( object ),
-            nearPlane,
-            farPlane
-         );
+         const U32 zoneId = zoneEntries[ runStart ].mZone;
+
+         U32 runEnd = runStart + 1;
+         while( runEnd < numEntries && zoneEntries[ runEnd ].mZone == zoneId )
+            ++ runEnd;
 
-         isCulled = ( result == SceneZoneCullingState::CullingTestNegative ||
-                      result == SceneZoneCullingState::CullingTestPositiveByOcclusion );
+         const U32 runLength = runEnd - runStart;
+         const SceneZoneCullingState& zoneState = getZoneState( zoneId );
+
+         // A zone without includers isn't visible.
+
+         if( !zoneState.hasIncluders() )
+         {
+            for( U32 i = runStart; i < runEnd; ++ i )
+               isCulled[ zoneEntries[ i ].mObjectIndex ] = true;
+
+            runStart = runEnd;
+            continue;
+         }
+
+         // Reject everything in front of the near or beyond the far plane.
+
+         nearFarPlanes.testPotentialIntersection( zoneBoxes, runStart, runLength, &results[ runStart ] );
+         for( U32 i = runStart; i < runEnd; ++ i )
+         {
+            isDecided[ i ] = ( results[ i ] == GeometryOutside );
+            isCulled[ zoneEntries[ i ].mObjectIndex ] = true;
+         }
+
+         // Go through the sorted volumes.  The first volume that tests positive
+         // on a box decides the box's fate: occluders cull it, includers accept it.
+         // Boxes that no volume tests positive on stay culled.
+
+         for( SceneZoneCullingState::CullingVolumeIterator iter( zoneState ); iter.isValid(); ++ iter )
+         {
+            const SceneCullingVolume& volume = *iter;
+            volume.getPlanes().testPotentialIntersection( zoneBoxes, runStart, runLength, &results[ runStart ] );
+
+            bool haveUndecided = false;
+            for( U32 i = runStart; i < runEnd; ++ i )
+            {
+               if( isDecided[ i ] )
+                  continue;
+
+               if( volume.isOccluder() )
+               {
+                  if( results[ i ] == GeometryInside )
+                     isDecided[ i ] = true;
+               }
+               else if( results[ i ] != GeometryOutside )
+               {
+                  isCulled[ zoneEntries[ i ].mObjectIndex ] = false;
+                  isDecided[ i ] = true;
+               }
+
+               if( !isDecided[ i ] )
+                  haveUndecided = true;
+            }
+
+            if( !haveUndecided )
+               break;
+         }
+
+         runStart = runEnd;
       }
+   }
 
-      if( !isCulled )
-         isCulled = isOccludedWithExtraPlanesCull( object->getWorldBox() );
+   // Compact the list.
 
-      if( !isCulled )
-         objects[ numRemainingObjects ++ ] = object;
+   U32 numRemainingObjects = 0;
+   for( U32 i = 0; i < numObjects; ++ i )
+   {
+      SceneObject* object = objects[ i ];
+      if( isCulled[ i ] || isOccludedWithExtraPlanesCull( object->getWorldBox() ) )
+         continue;
+
+      if( !isAccepted[ i ] && _isSoftwareOccluded( object ) )
+         continue;
+
+      objects[ numRemainingObjects ++ ] = object;
    }
 
    return numRemainingObjects;
@@ -798,6 +1084,213 @@ U32 SceneCullingState::cullObjects( SceneObject** objects, U32 numObjects, U32 c
 
 //-----------------------------------------------------------------------------
 
+/// Culls a contiguous range of the object list passed to cullObjects().
+struct SceneCullingState::CullObjectsWorkItem : public ThreadPoolBatch::Item
+{
+   const SceneCullingState* mState;
+   SceneObject** mObjects;
+   U32 mNumObjects;
+   U32 mCullOptions;
+
+   /// Number of objects at the beginning of the range that survived culling.
+   U32 mNumRemaining;
+
+   CullObjectsWorkItem( const SceneCullingState* state, SceneObject** objects, U32 numObjects, U32 cullOptions )
+      : mState( state ),
+        mObjects( objects ),
+        mNumObjects( numObjects ),
+        mCullOptions( cullOptions ),
+        mNumRemaining( 0 ) {}
+
+protected:
+
+   virtual void executeItem()
+   {
+      mNumRemaining = mState->_cullObjects( mObjects, mNumObjects, mCullOptions );
+   }
+};
+
+//-----------------------------------------------------------------------------
+
+void SceneCullingState::_prepareConcurrentCulling() const
+{
+   // The frustum computes its planes lazily.
+
+   getCullingFrustum().getPlanes();
+
+   // Zone states sort their culling volumes on first test.
+
+   const U32 numZones = mZoneStates.size();
+   for( U32 i = 0; i < numZones; ++ i )
+      mZoneStates[ i ].getCullingVolumes();
+}
+
+//-----------------------------------------------------------------------------
+
+U32 SceneCullingState::_cullObjectsParallel( SceneObject** objects, U32 numObjects, U32 cullOptions ) const
+{
+   PROFILE_SCOPE( SceneCullingState_cullObjectsParallel );
+
+   ThreadPool& pool = ThreadPool::GLOBAL();
+
+   // One range per worker plus one for this thread, but don't cut
+   // the list into slivers that aren't worth the overhead.
+
+   const U32 minObjectsPerRange = getMax( U32( smParallelCullThreshold ) / 2, 1U );
+   const U32 numRanges = mClamp( numObjects / minObjectsPerRange, 1, pool.getNumThreads() + 1 );
+   if( numRanges < 2 )
+      return _cullObjects( objects, numObjects, cullOptions );
+
+   _prepareConcurrentCulling();
+
+   // Cull the ranges.  Each range is compacted in place.
+
+   Vector< ThreadSafeRef< CullObjectsWorkItem > > items;
+   items.setSize( numRanges );
+
+   ThreadPoolBatch batch( &pool );
+
+   const U32 objectsPerRange = numObjects / numRanges;
+   for( U32 i = 0, start = 0; i < numRanges; ++ i, start += objectsPerRange )
+   {
+      const U32 count = ( i == numRanges - 1 ) ? numObjects - start : objectsPerRange;
+      items[ i ] = new CullObjectsWorkItem( this, &objects[ start ], count, cullOptions );
+      batch.add( items[ i ] );
+   }
+
+   batch.wait();
+
+   // Merge the surviving objects of all ranges at the front of
+   // the list, keeping the original order.
+
+   U32 numRemainingObjects = items[ 0 ]->mNumRemaining;
+   for( U32 i = 1; i < numRanges; ++ i )
+   {
+      const CullObjectsWorkItem* item = items[ i ].ptr();
+      if( item->mNumRemaining )
+         dMemmove( &objects[ numRemainingObjects ], item->mObjects, item->mNumRemaining * sizeof( SceneObject* ) );
+      numRemainingObjects += item->mNumRemaining;
+   }
+
+   return numRemainingObjects;
+}
+
+//-----------------------------------------------------------------------------
+
+namespace {
+
+   /// A software occluder candidate.
+   struct OccluderCandidate
+   {
+      SceneObject* mObject;
+      F32 mScreenArea;
+   };
+
+   S32 QSORT_CALLBACK _compareOccluderCandidates( const void* a, const void* b )
+   {
+      const OccluderCandidate* candidateA = reinterpret_cast< const OccluderCandidate* >( a );
+      const OccluderCandidate* candidateB = reinterpret_cast< const OccluderCandidate* >( b );
+
+      // Largest first.
+
+      if( candidateA->mScreenArea > candidateB->mScreenArea )
+         return -1;
+      else if( candidateA->mScreenArea < candidateB->mScreenArea )
+         return 1;
+
+      return 0;
+   }
+}
+
+void SceneCullingState::buildOcclusionBuffer( SceneObject* const* objects, U32 numObjects )
+{
+   PROFILE_SCOPE( SceneCullingState_buildOcclusionBuffer );
+
+   if( mOcclusionBuffer.isNull() )
+      mOcclusionBuffer.reset( new SceneOcclusionBuffer );
+
+   mOcclusionBuffer->setup( getCullingFrustum(), smSoftwareOcclusionWidth, smSoftwareOcclusionHeight );
+   mSoftwareOccluders.clear();
+
+   // Find the visible occluders that are large enough on
+   // screen to be worth rasterizing.
+
+   Vector< OccluderCandidate > candidates;
+
+   for( U32 i = 0; i < numObjects; ++ i )
+   {
+      SceneObject* object = objects[ i ];
+
+      if( !object->isSoftwareOccluder() ||
+          !object->isRenderEnabled() ||
+          object->isGlobalBounds() )
+         continue;
+
+      const Box3F& worldBox = object->getWorldBox();
+      if( getCullingFrustum().isCulled( worldBox ) )
+         continue;
+
+      const F32 screenArea = mOcclusionBuffer->getScreenArea( worldBox );
+      if( screenArea < smSoftwareOccluderMinScreenArea )
+         continue;
+
+      OccluderCandidate candidate;
+      candidate.mObject = object;
+      candidate.mScreenArea = screenArea;
+      candidates.push_back( candidate );
+   }
+
+   if( candidates.empty() )
+      return;
+
+   dQsort( candidates.address(), candidates.size(), sizeof( OccluderCandidate ), _compareOccluderCandidates );
+
+   // Rasterize them.
+
+   const U32 numOccluders = getMin( U32( candidates.size() ), smMaxSoftwareOccluders );
+   const Box3F& frustumBox = getCullingFrustum().getBounds();
+
+   OccluderPolyList polyList;
+   for( U32 i = 0; i < numOccluders; ++ i )
+   {
+      SceneObject* object = candidates[ i ].mObject;
+
+      const Box3F queryBox = object->getWorldBox().getOverlap( frustumBox );
+
+      polyList.clear();
+      if( !object->buildOccluderPolyList( getCameraState(), &polyList, queryBox ) || polyList.isEmpty() )
+         continue;
+
+      mOcclusionBuffer->rasterizeTriangles(
+         polyList.getVertexList().address(),
+         polyList.getVertexList().size(),
+         polyList.getIndexList().address(),
+         polyList.getNumTriangles()
+      );
+
+      mSoftwareOccluders.push_back( object );
+   }
+
+   mOcclusionBuffer->resolve();
+}
+
+//-----------------------------------------------------------------------------
+
+bool SceneCullingState::_isSoftwareOccluded( SceneObject* object ) const
+{
+   if( mOcclusionBuffer.isNull() || mOcclusionBuffer->isEmpty() )
+      return false;
+
+   // Occluders would end up hiding themselves.
+
+   if( object->isSoftwareOccluder() && mSoftwareOccluders.contains( object ) )
+      return false;
+
+   return mOcclusionBuffer->isOccluded( object->getWorldBox() );
+}
+
+//-----------------------------------------------------------------------------
+
 bool SceneCullingState::isOccludedByTerrain( SceneObject* object ) const
 {
    PROFILE_SCOPE( SceneCullingState_isOccludedByTerrain );
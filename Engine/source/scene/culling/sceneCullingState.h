@@ -47,6 +47,14 @@
 #include "core/bitVector.h"
 #endif
 
+#ifndef _AUTOPTR_H_
+#include "core/util/autoPtr.h"
+#endif
+
+#ifndef _SCENEOCCLUSIONBUFFER_H_
+#include "scene/culling/sceneOcclusionBuffer.h"
+#endif
+
 
 class SceneObject;
 class SceneManager;
@@ -92,6 +100,35 @@ class SceneCullingState
 
       /// @}
 
+      /// If cullObjects() is given at least this many objects, the list is split
+      /// into ranges that are culled concurrently on the global thread pool.
+      /// Zero or less disables parallel culling.
+      static S32 smParallelCullThreshold;
+
+      /// @name Software Occlusion
+      /// Objects flagged as software occluders can be rasterized into a small
+      /// CPU-side depth buffer which other objects are then tested against.
+      /// @{
+
+      /// Whether to build a software occlusion buffer for diffuse passes.
+      static bool smSoftwareOcclusion;
+
+      /// Horizontal resolution of the software occlusion buffer.
+      static U32 smSoftwareOcclusionWidth;
+
+      /// Vertical resolution of the software occlusion buffer.
+      static U32 smSoftwareOcclusionHeight;
+
+      /// Maximum number of occluders rasterized into the buffer.  Occluders
+      /// covering more of the screen are preferred.
+      static U32 smMaxSoftwareOccluders;
+
+      /// Fraction of the screen that the bounds of an occluder must at
+      /// least cover in order to be rasterized.
+      static F32 smSoftwareOccluderMinScreenArea;
+
+      /// @}
+
    protected:
 
       /// Scene which is being culled.
@@ -132,6 +169,13 @@ class SceneCullingState
       /// frustum.
       bool mDisableZoneCulling;
 
+      /// The software occlusion buffer, if one has been built.
+      AutoPtr< SceneOcclusionBuffer > mOcclusionBuffer;
+
+      /// Objects that have been rasterized into #mOcclusionBuffer.  These are
+      /// not tested against the buffer as they would occlude themselves.
+      Vector< SceneObject* > mSoftwareOccluders;
+
    public:
 
       ///
@@ -216,6 +260,20 @@ class SceneCullingState
       /// Set whether isCulled() should do terrain occlusion checks or not.
       void setDisableTerrainOcclusion( bool value ) { mDisableTerrainOcclusion = value; }
 
+      /// Rasterize the largest visible software occluders among the given objects
+      /// into the software occlusion buffer.  Subsequent culling will reject objects
+      /// hidden behind them.
+      ///
+      /// @note This should only be called after the zones have been traversed.
+      /// @see SceneObject::isSoftwareOccluder
+      void buildOcclusionBuffer( SceneObject* const* objects, U32 numObjects );
+
+      /// Return the software occlusion buffer or NULL if none has been built.
+      const SceneOcclusionBuffer* getOcclusionBuffer() const { return mOcclusionBuffer.ptr(); }
+
+      /// Return the objects that have been rasterized into the software occlusion buffer.
+      const Vector< SceneObject* >& getSoftwareOccluders() const { return mSoftwareOccluders; }
+
       /// @}
 
       /// @name Zones
@@ -323,6 +381,43 @@ class SceneCullingState
 
       typedef SceneZoneCullingState::CullingTestResult CullingTestResult;
 
+      struct CullObjectsWorkItem;
+
+      /// How an object passed to cullObjects() needs to be tested.
+      enum ObjectCullTest
+      {
+         ObjectCullTestAccept,   ///< Object is visible without further tests.
+         ObjectCullTestReject,   ///< Object is culled without further tests.
+         ObjectCullTestFrustum,  ///< Object is tested against the root frustum only.
+         ObjectCullTestZones     ///< Object is tested against the volumes of its zones.
+      };
+
+      /// Decide how the given object needs to be culled.  Performs all
+      /// non-geometric tests and the terrain occlusion test.
+      ObjectCullTest _getObjectCullTest( SceneObject* object, U32 cullOptions ) const;
+
+      /// Cull the given range of objects on the calling thread.  This is the workhorse
+      /// of cullObjects() and is safe to call concurrently on disjoint ranges once
+      /// _prepareConcurrentCulling() has been run.
+      U32 _cullObjects( SceneObject** objects, U32 numObjects, U32 cullOptions ) const;
+
+      /// Cull the given objects one at a time.
+      U32 _cullObjectsSerial( SceneObject** objects, U32 numObjects, U32 cullOptions ) const;
+
+      /// Cull the given objects by testing their bounds in batches.  Gives the same
+      /// results as _cullObjectsSerial().
+      U32 _cullObjectsBatched( SceneObject** objects, U32 numObjects, U32 cullOptions ) const;
+
+      /// Split the given list in ranges and cull them on the thread pool.
+      U32 _cullObjectsParallel( SceneObject** objects, U32 numObjects, U32 cullOptions ) const;
+
+      /// Return true if the given object is hidden in the software occlusion buffer.
+      bool _isSoftwareOccluded( SceneObject* object ) const;
+
+      /// Bring all lazily computed state that culling tests read up to date so that
+      /// the tests can run concurrently without mutating the culling state.
+      void _prepareConcurrentCulling() const;
+
       // Helper methods to avoid code duplication.
 
       template< bool OCCLUDERS_ONLY, typename T > CullingTestResult _test( const T& bounds, const U32* zones, U32 numZones ) const;
@@ -0,0 +1,888 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "scene/culling/sceneOcclusionBuffer.h"
+
+#include "math/util/frustum.h"
+#include "math/mMathFn.h"
+#include "platform/profiler.h"
+
+#if defined( TORQUE_CPU_X64 ) || defined( __SSE__ ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 )
+   #define TORQUE_OCCLUSION_SSE
+   #include <xmmintrin.h>
+#endif
+
+
+namespace {
+
+   /// Guard band in multiples of the viewport extents.  Triangles reaching
+   /// past it get clipped so edge functions stay well within float precision.
+   const F32 GuardBand = 8.0f;
+
+   /// Clip planes in homogeneous clip space.  A vertex is on the inside
+   /// of a plane if the dot product with it is non-negative.
+   const Point4F sClipPlanes[] =
+   {
+      Point4F(  0.0f,  0.0f, 1.0f, 0.0f ),      // Near.
+      Point4F( -1.0f,  0.0f, 0.0f, GuardBand ), // Guard band right.
+      Point4F(  1.0f,  0.0f, 0.0f, GuardBand ), // Guard band left.
+      Point4F(  0.0f, -1.0f, 0.0f, GuardBand ), // Guard band top.
+      Point4F(  0.0f,  1.0f, 0.0f, GuardBand ), // Guard band bottom.
+   };
+
+   const U32 NumClipPlanes = sizeof( sClipPlanes ) / sizeof( sClipPlanes[ 0 ] );
+   const U32 ClipPlaneMask = ( 1 << NumClipPlanes ) - 1;
+
+   /// Maximum number of vertices a triangle can have after clipping.
+   const U32 MaxClippedVerts = 3 + NumClipPlanes;
+
+   /// Maximum number of edge functions for a polygon; a triangle with
+   /// three inner edges is also bounded by two edges of each neighbor.
+   const U32 MaxEdges = 9;
+
+   /// Compute the edge function going from @a p to @a q.  Points to the
+   /// left of it on screen are on the inside.  The function is always
+   /// derived from the endpoints in the same order and then negated as
+   /// needed so that triangles sharing an edge get exactly opposite values
+   /// along it and no pixel falls through the crack between them.
+   template< class Edge >
+   inline void _setupEdge( const Point3F& p, const Point3F& q, Edge& edge )
+   {
+      const bool swap = ( q.x < p.x || ( q.x == p.x && q.y < p.y ) );
+      const Point3F& from = swap ? q : p;
+      const Point3F& to = swap ? p : q;
+
+      edge.a = from.y - to.y;
+      edge.b = to.x - from.x;
+      edge.c = -( edge.a * from.x + edge.b * from.y );
+
+      if( swap )
+      {
+         edge.a = -edge.a;
+         edge.b = -edge.b;
+         edge.c = -edge.c;
+      }
+   }
+
+   /// Pull an edge in by half a pixel so that it only passes pixels that
+   /// are entirely on its inner side rather than just their centers.
+   template< class Edge >
+   inline void _shrinkEdge( Edge& edge )
+   {
+      edge.c -= 0.5f * ( mFabs( edge.a ) + mFabs( edge.b ) );
+   }
+
+   inline F32 _dot( const Point4F& plane, const Point4F& v )
+   {
+      return plane.x * v.x + plane.y * v.y + plane.z * v.z + plane.w * v.w;
+   }
+
+   /// Return a mask with one bit for each clip plane the vertex is outside
+   /// of and, shifted past those, one bit for each side of the view volume
+   /// it is outside of.
+   inline U32 _computeOutCode( const Point4F& v )
+   {
+      U32 code = 0;
+
+      for( U32 i = 0; i < NumClipPlanes; ++ i )
+         if( _dot( sClipPlanes[ i ], v ) < 0.0f )
+            code |= BIT( i );
+
+      if( v.x > v.w )   code |= BIT( NumClipPlanes + 0 );
+      if( v.x < -v.w )  code |= BIT( NumClipPlanes + 1 );
+      if( v.y > v.w )   code |= BIT( NumClipPlanes + 2 );
+      if( v.y < -v.w )  code |= BIT( NumClipPlanes + 3 );
+      if( v.z > v.w )   code |= BIT( NumClipPlanes + 4 );
+
+      return code;
+   }
+
+   template< class WeldPoint >
+   S32 QSORT_CALLBACK _compareWeldPoints( const void* a, const void* b )
+   {
+      const Point3F& posA = reinterpret_cast< const WeldPoint* >( a )->mPos;
+      const Point3F& posB = reinterpret_cast< const WeldPoint* >( b )->mPos;
+
+      if( posA.x != posB.x )
+         return posA.x < posB.x ? -1 : 1;
+      if( posA.y != posB.y )
+         return posA.y < posB.y ? -1 : 1;
+      if( posA.z != posB.z )
+         return posA.z < posB.z ? -1 : 1;
+
+      return 0;
+   }
+
+   template< class MeshEdge >
+   S32 QSORT_CALLBACK _compareMeshEdges( const void* a, const void* b )
+   {
+      const MeshEdge* edgeA = reinterpret_cast< const MeshEdge* >( a );
+      const MeshEdge* edgeB = reinterpret_cast< const MeshEdge* >( b );
+
+      if( edgeA->mLow != edgeB->mLow )
+         return edgeA->mLow < edgeB->mLow ? -1 : 1;
+      if( edgeA->mHigh != edgeB->mHigh )
+         return edgeA->mHigh < edgeB->mHigh ? -1 : 1;
+
+      return S32( edgeA->mEdge ) - S32( edgeB->mEdge );
+   }
+}
+
+//-----------------------------------------------------------------------------
+
+SceneOcclusionBuffer::SceneOcclusionBuffer()
+   : mWidth( 0 ),
+     mHeight( 0 ),
+     mTilesX( 0 ),
+     mTilesY( 0 ),
+     mWorldToClip( true ),
+     mNumRasterizedTriangles( 0 ),
+     mNeedsResolve( false ),
+     mIsEmpty( true )
+{
+   VECTOR_SET_ASSOCIATION( mDepth );
+   VECTOR_SET_ASSOCIATION( mTileMaxDepth );
+   VECTOR_SET_ASSOCIATION( mClipVerts );
+   VECTOR_SET_ASSOCIATION( mClipCodes );
+   VECTOR_SET_ASSOCIATION( mScreenVerts );
+   VECTOR_SET_ASSOCIATION( mWeldPoints );
+   VECTOR_SET_ASSOCIATION( mWeldIndices );
+   VECTOR_SET_ASSOCIATION( mFacing );
+   VECTOR_SET_ASSOCIATION( mMeshEdges );
+   VECTOR_SET_ASSOCIATION( mInnerEdges );
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneOcclusionBuffer::setup( const Frustum& frustum, U32 width, U32 height )
+{
+   AssertFatal( width > 0 && height > 0, "SceneOcclusionBuffer::setup - Invalid resolution" );
+
+   mTilesX = ( width + TileSize - 1 ) / TileSize;
+   mTilesY = ( height + TileSize - 1 ) / TileSize;
+   mWidth = mTilesX * TileSize;
+   mHeight = mTilesY * TileSize;
+
+   mDepth.setSize( mWidth * mHeight );
+   mTileMaxDepth.setSize( mTilesX * mTilesY );
+
+   // Set up the projection.  View space has x to the right, y forward,
+   // and z up.  Depth goes from 0 on the near plane to 1 on the far plane.
+   // This mirrors MathUtils::makeProjection() but does not depend on GFX.
+
+   const F32 left = frustum.getNearLeft();
+   const F32 right = frustum.getNearRight();
+   const F32 top = frustum.getNearTop();
+   const F32 bottom = frustum.getNearBottom();
+   const F32 nearDist = frustum.getNearDist();
+   const F32 farDist = frustum.getFarDist();
+
+   MatrixF proj( true );
+   if( frustum.isOrtho() )
+   {
+      proj.setRow( 0, Point4F( 2.0f / ( right - left ), 0.0f, 0.0f, -( right + left ) / ( right - left ) ) );
+      proj.setRow( 1, Point4F( 0.0f, 0.0f, 2.0f / ( top - bottom ), -( top + bottom ) / ( top - bottom ) ) );
+      proj.setRow( 2, Point4F( 0.0f, 1.0f / ( farDist - nearDist ), 0.0f, -nearDist / ( farDist - nearDist ) ) );
+      proj.setRow( 3, Point4F( 0.0f, 0.0f, 0.0f, 1.0f ) );
+   }
+   else
+   {
+      proj.setRow( 0, Point4F( 2.0f * nearDist / ( right - left ), -( right + left ) / ( right - left ), 0.0f, 0.0f ) );
+      proj.setRow( 1, Point4F( 0.0f, -( top + bottom ) / ( top - bottom ), 2.0f * nearDist / ( top - bottom ), 0.0f ) );
+      proj.setRow( 2, Point4F( 0.0f, farDist / ( farDist - nearDist ), 0.0f, -farDist * nearDist / ( farDist - nearDist ) ) );
+      proj.setRow( 3, Point4F( 0.0f, 1.0f, 0.0f, 0.0f ) );
+   }
+
+   MatrixF worldToView = frustum.getTransform();
+   worldToView.inverse();
+
+   mWorldToClip.mul( proj, worldToView );
+
+   clear();
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneOcclusionBuffer::clear()
+{
+   const U32 numPixels = mDepth.size();
+   for( U32 i = 0; i < numPixels; ++ i )
+      mDepth[ i ] = 1.0f;
+
+   const U32 numTiles = mTileMaxDepth.size();
+   for( U32 i = 0; i < numTiles; ++ i )
+      mTileMaxDepth[ i ] = 1.0f;
+
+   mNumRasterizedTriangles = 0;
+   mNeedsResolve = false;
+   mIsEmpty = true;
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneOcclusionBuffer::rasterizeTriangles( const Point3F* points, U32 numPoints, const U32* indices, U32 numTriangles )
+{
+   PROFILE_SCOPE( SceneOcclusionBuffer_rasterizeTriangles );
+
+   if( !numTriangles )
+      return;
+
+   // Transform all points to clip space and project those
+   // in front of the near plane to pixel coordinates.
+
+   mClipVerts.setSize( numPoints );
+   mClipCodes.setSize( numPoints );
+   mScreenVerts.setSize( numPoints );
+
+   const F32 halfWidth = F32( mWidth ) * 0.5f;
+   const F32 halfHeight = F32( mHeight ) * 0.5f;
+
+   const F32* m = mWorldToClip;
+   for( U32 i = 0; i < numPoints; ++ i )
+   {
+      const Point3F& p = points[ i ];
+      Point4F& v = mClipVerts[ i ];
+
+      v.x = m[ 0 ] * p.x + m[ 1 ] * p.y + m[ 2 ] * p.z + m[ 3 ];
+      v.y = m[ 4 ] * p.x + m[ 5 ] * p.y + m[ 6 ] * p.z + m[ 7 ];
+      v.z = m[ 8 ] * p.x + m[ 9 ] * p.y + m[ 10 ] * p.z + m[ 11 ];
+      v.w = m[ 12 ] * p.x + m[ 13 ] * p.y + m[ 14 ] * p.z + m[ 15 ];
+
+      mClipCodes[ i ] = _computeOutCode( v );
+
+      if( !( mClipCodes[ i ] & ClipPlaneMask ) )
+      {
+         const F32 invW = 1.0f / v.w;
+         Point3F& screen = mScreenVerts[ i ];
+
+         screen.x = ( v.x * invW + 1.0f ) * halfWidth;
+         screen.y = ( 1.0f - v.y * invW ) * halfHeight;
+         screen.z = v.z * invW;
+      }
+   }
+
+   // Weld the points so that meshes which don't share vertices between
+   // their faces still have their inner edges found.
+
+   mWeldPoints.setSize( numPoints );
+   for( U32 i = 0; i < numPoints; ++ i )
+   {
+      mWeldPoints[ i ].mPos = points[ i ];
+      mWeldPoints[ i ].mIndex = i;
+   }
+
+   dQsort( mWeldPoints.address(), numPoints, sizeof( WeldPoint ), _compareWeldPoints< WeldPoint > );
+
+   mWeldIndices.setSize( numPoints );
+   for( U32 i = 0, first = 0; i < numPoints; ++ i )
+   {
+      if( mWeldPoints[ i ].mPos != mWeldPoints[ first ].mPos )
+         first = i;
+
+      mWeldIndices[ mWeldPoints[ i ].mIndex ] = mWeldPoints[ first ].mIndex;
+   }
+
+   // Find out which way the triangles face on screen.  Triangles
+   // which need clipping are left out of the mesh and rasterized
+   // with all their edges on the outline.
+
+   mFacing.setSize( numTriangles );
+   for( U32 i = 0; i < numTriangles; ++ i )
+   {
+      const U32* tri = &indices[ i * 3 ];
+
+      AssertFatal( tri[ 0 ] < numPoints && tri[ 1 ] < numPoints && tri[ 2 ] < numPoints,
+         "SceneOcclusionBuffer::rasterizeTriangles - Vertex index out of range" );
+
+      mFacing[ i ] = 0;
+      if( ( mClipCodes[ tri[ 0 ] ] | mClipCodes[ tri[ 1 ] ] | mClipCodes[ tri[ 2 ] ] ) & ClipPlaneMask )
+         continue;
+
+      const Point3F& v0 = mScreenVerts[ tri[ 0 ] ];
+      const Point3F& v1 = mScreenVerts[ tri[ 1 ] ];
+      const Point3F& v2 = mScreenVerts[ tri[ 2 ] ];
+
+      const F32 area = ( v1.x - v0.x ) * ( v2.y - v0.y ) - ( v2.x - v0.x ) * ( v1.y - v0.y );
+      if( mFabs( area ) >= 1.0e-6f )
+         mFacing[ i ] = area > 0.0f ? 1 : -1;
+   }
+
+   _findInnerEdges( indices, numTriangles );
+
+   // Rasterize the triangles.
+
+   for( U32 i = 0; i < numTriangles; ++ i )
+   {
+      const U32* tri = &indices[ i * 3 ];
+
+      // Trivially reject triangles that are fully outside of a clip
+      // plane or a side of the view volume.
+
+      if( mClipCodes[ tri[ 0 ] ] & mClipCodes[ tri[ 1 ] ] & mClipCodes[ tri[ 2 ] ] )
+         continue;
+
+      if( mFacing[ i ] )
+      {
+         ++ mNumRasterizedTriangles;
+         _rasterizeMeshTriangle( indices, i );
+      }
+      else
+         _rasterizeTriangle( mClipVerts[ tri[ 0 ] ], mClipVerts[ tri[ 1 ] ], mClipVerts[ tri[ 2 ] ] );
+   }
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneOcclusionBuffer::_findInnerEdges( const U32* indices, U32 numTriangles )
+{
+   mInnerEdges.setSize( numTriangles * 3 );
+   mMeshEdges.clear();
+
+   for( U32 i = 0; i < numTriangles; ++ i )
+   {
+      mInnerEdges[ i * 3 + 0 ] = -1;
+      mInnerEdges[ i * 3 + 1 ] = -1;
+      mInnerEdges[ i * 3 + 2 ] = -1;
+
+      if( !mFacing[ i ] )
+         continue;
+
+      for( U32 j = 0; j < 3; ++ j )
+      {
+         const U32 from = mWeldIndices[ indices[ i * 3 + j ] ];
+         const U32 to = mWeldIndices[ indices[ i * 3 + ( j + 1 ) % 3 ] ];
+
+         MeshEdge edge;
+         edge.mLow = getMin( from, to );
+         edge.mHigh = getMax( from, to );
+         edge.mEdge = i * 3 + j;
+         mMeshEdges.push_back( edge );
+      }
+   }
+
+   dQsort( mMeshEdges.address(), mMeshEdges.size(), sizeof( MeshEdge ), _compareMeshEdges< MeshEdge > );
+
+   // An edge is inner if exactly two triangles share it and they lie on
+   // opposite sides of it on screen.  That is the case if they face the
+   // same way and run along the edge in opposite directions or if they
+   // face opposite ways and run along it in the same direction.  Where
+   // they lie on the same side the edge is part of the outline.
+
+   const U32 numEdges = mMeshEdges.size();
+   for( U32 i = 0; i < numEdges; )
+   {
+      U32 count = 1;
+      while( i + count < numEdges &&
+             mMeshEdges[ i + count ].mLow == mMeshEdges[ i ].mLow &&
+             mMeshEdges[ i + count ].mHigh == mMeshEdges[ i ].mHigh )
+         ++ count;
+
+      if( count == 2 )
+      {
+         const U32 edgeA = mMeshEdges[ i ].mEdge;
+         const U32 edgeB = mMeshEdges[ i + 1 ].mEdge;
+         const U32 triA = edgeA / 3;
+         const U32 triB = edgeB / 3;
+
+         const bool sameDirection = mWeldIndices[ indices[ edgeA ] ] == mWeldIndices[ indices[ edgeB ] ];
+         const bool sameFacing = mFacing[ triA ] == mFacing[ triB ];
+
+         if( triA != triB && sameFacing != sameDirection )
+         {
+            mInnerEdges[ edgeA ] = edgeB;
+            mInnerEdges[ edgeB ] = edgeA;
+         }
+      }
+
+      i += count;
+   }
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneOcclusionBuffer::_rasterizeMeshTriangle( const U32* indices, U32 triangle )
+{
+   EdgeFunction edges[ MaxEdges ];
+   U32 numEdges = 0;
+
+   // The edge functions of the triangle itself.  Outline edges are pulled
+   // in.  Across inner edges, pixels may reach into the triangle on the
+   // other side but not past that triangle's own edges, so those bound
+   // the coverage as well.  This keeps pixels from poking out of the
+   // outline next to the ends of inner edges.
+
+   for( U32 i = 0; i < 3; ++ i )
+   {
+      const U32 edge = triangle * 3 + i;
+      const U32 next = triangle * 3 + ( i + 1 ) % 3;
+
+      const Point3F& p = mScreenVerts[ indices[ mFacing[ triangle ] > 0 ? edge : next ] ];
+      const Point3F& q = mScreenVerts[ indices[ mFacing[ triangle ] > 0 ? next : edge ] ];
+
+      EdgeFunction& function = edges[ numEdges ++ ];
+      _setupEdge( p, q, function );
+
+      const S32 other = mInnerEdges[ edge ];
+      if( other < 0 )
+      {
+         _shrinkEdge( function );
+         continue;
+      }
+
+      const U32 otherTriangle = other / 3;
+      for( U32 j = 1; j < 3; ++ j )
+      {
+         const U32 otherEdge = otherTriangle * 3 + ( other + j ) % 3;
+         const U32 otherNext = otherTriangle * 3 + ( other + j + 1 ) % 3;
+
+         const Point3F& otherP = mScreenVerts[ indices[ mFacing[ otherTriangle ] > 0 ? otherEdge : otherNext ] ];
+         const Point3F& otherQ = mScreenVerts[ indices[ mFacing[ otherTriangle ] > 0 ? otherNext : otherEdge ] ];
+
+         EdgeFunction& otherFunction = edges[ numEdges ++ ];
+         _setupEdge( otherP, otherQ, otherFunction );
+
+         if( mInnerEdges[ otherEdge ] < 0 )
+            _shrinkEdge( otherFunction );
+      }
+   }
+
+   const Point3F verts[] =
+   {
+      mScreenVerts[ indices[ triangle * 3 + 0 ] ],
+      mScreenVerts[ indices[ triangle * 3 + ( mFacing[ triangle ] > 0 ? 1 : 2 ) ] ],
+      mScreenVerts[ indices[ triangle * 3 + ( mFacing[ triangle ] > 0 ? 2 : 1 ) ] ],
+   };
+
+   _rasterizeScreenPolygon( verts, 3, edges, numEdges );
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneOcclusionBuffer::_rasterizeTriangle( const Point4F& v0, const Point4F& v1, const Point4F& v2 )
+{
+   const U32 code0 = _computeOutCode( v0 );
+   const U32 code1 = _computeOutCode( v1 );
+   const U32 code2 = _computeOutCode( v2 );
+
+   ++ mNumRasterizedTriangles;
+
+   Point4F verts[ 2 ][ MaxClippedVerts ];
+   U32 numVerts = 3;
+
+   verts[ 0 ][ 0 ] = v0;
+   verts[ 0 ][ 1 ] = v1;
+   verts[ 0 ][ 2 ] = v2;
+
+   // Clip against the near plane and the guard band, if needed.
+
+   U32 current = 0;
+   const U32 clipCode = ( code0 | code1 | code2 ) & ClipPlaneMask;
+   if( clipCode )
+   {
+      for( U32 plane = 0; plane < NumClipPlanes && numVerts >= 3; ++ plane )
+      {
+         if( !( clipCode & BIT( plane ) ) )
+            continue;
+
+         const Point4F* in = verts[ current ];
+         Point4F* out = verts[ current ^ 1 ];
+         U32 numOut = 0;
+
+         for( U32 i = 0; i < numVerts; ++ i )
+         {
+            const Point4F& a = in[ i ];
+            const Point4F& b = in[ ( i + 1 ) % numVerts ];
+
+            const F32 distA = _dot( sClipPlanes[ plane ], a );
+            const F32 distB = _dot( sClipPlanes[ plane ], b );
+
+            if( distA >= 0.0f )
+               out[ numOut ++ ] = a;
+
+            if( ( distA >= 0.0f ) != ( distB >= 0.0f ) )
+            {
+               const F32 t = distA / ( distA - distB );
+               out[ numOut ++ ] = a + ( b - a ) * t;
+            }
+         }
+
+         numVerts = numOut;
+         current ^= 1;
+      }
+
+      if( numVerts < 3 )
+         return;
+   }
+
+   // Project to pixel coordinates.  Everything is in front of the
+   // near plane now so w is positive.
+
+   Point3F screen[ MaxClippedVerts ];
+   const F32 halfWidth = F32( mWidth ) * 0.5f;
+   const F32 halfHeight = F32( mHeight ) * 0.5f;
+
+   for( U32 i = 0; i < numVerts; ++ i )
+   {
+      const Point4F& v = verts[ current ][ i ];
+      const F32 invW = 1.0f / v.w;
+
+      screen[ i ].x = ( v.x * invW + 1.0f ) * halfWidth;
+      screen[ i ].y = ( 1.0f - v.y * invW ) * halfHeight;
+      screen[ i ].z = v.z * invW;
+   }
+
+   // Make the winding consistent.  Occluders are rasterized two-sided.
+
+   F32 area = 0.0f;
+   for( U32 i = 2; i < numVerts; ++ i )
+      area += ( screen[ i - 1 ].x - screen[ 0 ].x ) * ( screen[ i ].y - screen[ 0 ].y )
+            - ( screen[ i ].x - screen[ 0 ].x ) * ( screen[ i - 1 ].y - screen[ 0 ].y );
+
+   if( mFabs( area ) < 1.0e-6f )
+      return;
+
+   if( area < 0.0f )
+      for( U32 i = 1; i < numVerts - i; ++ i )
+         std::swap( screen[ i ], screen[ numVerts - i ] );
+
+   // Clipping produces convex polygons, so the polygon is covered where
+   // all its edges agree.  All of them are part of the outline.
+
+   EdgeFunction edges[ MaxClippedVerts ];
+   for( U32 i = 0; i < numVerts; ++ i )
+   {
+      _setupEdge( screen[ i ], screen[ ( i + 1 ) % numVerts ], edges[ i ] );
+      _shrinkEdge( edges[ i ] );
+   }
+
+   _rasterizeScreenPolygon( screen, numVerts, edges, numVerts );
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneOcclusionBuffer::_rasterizeScreenPolygon( const Point3F* verts, U32 numVerts, const EdgeFunction* edges, U32 numEdges )
+{
+   AssertFatal( numVerts >= 3 && numEdges <= MaxEdges, "SceneOcclusionBuffer::_rasterizeScreenPolygon - Bad polygon" );
+
+   // Take the depth plane from the largest triangle in the
+   // polygon's fan as clipping may produce slivers.
+
+   const Point3F& v0 = verts[ 0 ];
+   U32 planeVert = 2;
+   F32 area = 0.0f;
+   for( U32 i = 2; i < numVerts; ++ i )
+   {
+      const F32 fanArea = ( verts[ i - 1 ].x - v0.x ) * ( verts[ i ].y - v0.y )
+                        - ( verts[ i ].x - v0.x ) * ( verts[ i - 1 ].y - v0.y );
+      if( fanArea > area )
+      {
+         area = fanArea;
+         planeVert = i;
+      }
+   }
+
+   if( area < 1.0e-6f )
+      return;
+
+   const Point3F& v1 = verts[ planeVert - 1 ];
+   const Point3F& v2 = verts[ planeVert ];
+
+   // Find the pixels whose centers may be covered.
+
+   Point3F boundsMin = v0;
+   Point3F boundsMax = v0;
+   for( U32 i = 1; i < numVerts; ++ i )
+   {
+      boundsMin.setMin( verts[ i ] );
+      boundsMax.setMax( verts[ i ] );
+   }
+
+   const S32 minX = getMax( S32( mCeil( boundsMin.x - 0.5f ) ), 0 );
+   const S32 maxX = getMin( S32( mFloor( boundsMax.x - 0.5f ) ), S32( mWidth ) - 1 );
+   const S32 minY = getMax( S32( mCeil( boundsMin.y - 0.5f ) ), 0 );
+   const S32 maxY = getMin( S32( mFloor( boundsMax.y - 0.5f ) ), S32( mHeight ) - 1 );
+
+   if( minX > maxX || minY > maxY )
+      return;
+
+   // Depth plane.  Every pixel receives the farthest depth the polygon's
+   // plane reaches within the pixel's area, but never more than the
+   // farthest depth of the polygon.
+
+   const F32 invArea = 1.0f / area;
+   const F32 dzdx = ( ( v1.z - v0.z ) * ( v2.y - v0.y ) - ( v2.z - v0.z ) * ( v1.y - v0.y ) ) * invArea;
+   const F32 dzdy = ( ( v2.z - v0.z ) * ( v1.x - v0.x ) - ( v1.z - v0.z ) * ( v2.x - v0.x ) ) * invArea;
+   const F32 zBias = 0.5f * ( mFabs( dzdx ) + mFabs( dzdy ) );
+   const F32 zMax = boundsMax.z;
+   const F32 z0 = v0.z - dzdx * v0.x - dzdy * v0.y + zBias;
+
+   mNeedsResolve = true;
+   mIsEmpty = false;
+
+   // Start rows on a four pixel boundary.  As the width is a multiple
+   // of the tile size, groups of four never cross the end of a row.
+
+   const S32 startX = minX & ~3;
+
+#ifdef TORQUE_OCCLUSION_SSE
+
+   const __m128 laneOffsets = _mm_set_ps( 3.5f, 2.5f, 1.5f, 0.5f );
+   const __m128 zero = _mm_setzero_ps();
+   const __m128 zMaxV = _mm_set1_ps( zMax );
+   const __m128 dzdxV = _mm_set1_ps( dzdx );
+
+   __m128 aV[ MaxEdges ];
+   for( U32 i = 0; i < numEdges; ++ i )
+      aV[ i ] = _mm_set1_ps( edges[ i ].a );
+
+   const __m128 xStep = _mm_set1_ps( 4.0f );
+   const __m128 zStep = _mm_set1_ps( dzdx * 4.0f );
+
+   const __m128 startXV = _mm_add_ps( _mm_set1_ps( F32( startX ) ), laneOffsets );
+
+   __m128 rowV[ MaxEdges ];
+
+   for( S32 y = minY; y <= maxY; ++ y )
+   {
+      const F32 py = F32( y ) + 0.5f;
+
+      // The edge functions are evaluated from scratch for every group rather
+      // than stepped so that they stay bit-exact with neighbouring triangles.
+
+      for( U32 i = 0; i < numEdges; ++ i )
+         rowV[ i ] = _mm_set1_ps( edges[ i ].b * py + edges[ i ].c );
+
+      __m128 px = startXV;
+      __m128 z = _mm_add_ps( _mm_mul_ps( dzdxV, startXV ), _mm_set1_ps( z0 + dzdy * py ) );
+
+      F32* row = &mDepth[ y * mWidth ];
+
+      for( S32 x = startX; x <= maxX; x += 4 )
+      {
+         __m128 e = _mm_add_ps( _mm_mul_ps( aV[ 0 ], px ), rowV[ 0 ] );
+         for( U32 i = 1; i < numEdges; ++ i )
+            e = _mm_min_ps( e, _mm_add_ps( _mm_mul_ps( aV[ i ], px ), rowV[ i ] ) );
+
+         const __m128 inside = _mm_cmpge_ps( e, zero );
+         if( _mm_movemask_ps( inside ) )
+         {
+            const __m128 depth = _mm_loadu_ps( &row[ x ] );
+            const __m128 newDepth = _mm_min_ps( depth, _mm_min_ps( z, zMaxV ) );
+            _mm_storeu_ps( &row[ x ],
+               _mm_or_ps( _mm_and_ps( inside, newDepth ), _mm_andnot_ps( inside, depth ) ) );
+         }
+
+         px = _mm_add_ps( px, xStep );
+         z = _mm_add_ps( z, zStep );
+      }
+   }
+
+#else
+
+   F32 rowE[ MaxEdges ];
+
+   for( S32 y = minY; y <= maxY; ++ y )
+   {
+      const F32 py = F32( y ) + 0.5f;
+      F32* row = &mDepth[ y * mWidth ];
+
+      for( U32 i = 0; i < numEdges; ++ i )
+         rowE[ i ] = edges[ i ].b * py + edges[ i ].c;
+
+      for( S32 x = startX; x <= maxX; ++ x )
+      {
+         const F32 px = F32( x ) + 0.5f;
+
+         bool inside = true;
+         for( U32 i = 0; i < numEdges && inside; ++ i )
+            inside = ( edges[ i ].a * px + rowE[ i ] >= 0.0f );
+
+         if( inside )
+         {
+            const F32 z = getMin( z0 + dzdx * px + dzdy * py, zMax );
+            if( z < row[ x ] )
+               row[ x ] = z;
+         }
+      }
+   }
+
+#endif
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneOcclusionBuffer::resolve()
+{
+   PROFILE_SCOPE( SceneOcclusionBuffer_resolve );
+
+   if( !mNeedsResolve )
+      return;
+
+   for( U32 tileY = 0; tileY < mTilesY; ++ tileY )
+      for( U32 tileX = 0; tileX < mTilesX; ++ tileX )
+      {
+         const F32* row = &mDepth[ tileY * TileSize * mWidth + tileX * TileSize ];
+         F32 maxDepth = 0.0f;
+
+         for( U32 y = 0; y < TileSize; ++ y, row += mWidth )
+            for( U32 x = 0; x < TileSize; ++ x )
+               maxDepth = getMax( maxDepth, row[ x ] );
+
+         mTileMaxDepth[ tileY * mTilesX + tileX ] = maxDepth;
+      }
+
+   mNeedsResolve = false;
+}
+
+//-----------------------------------------------------------------------------
+
+bool SceneOcclusionBuffer::_projectBox( const Box3F& box, Point3F& outMin, Point3F& outMax ) const
+{
+   const F32* m = mWorldToClip;
+   const F32 halfWidth = F32( mWidth ) * 0.5f;
+   const F32 halfHeight = F32( mHeight ) * 0.5f;
+
+   outMin.set( F32_MAX, F32_MAX, F32_MAX );
+   outMax.set( -F32_MAX, -F32_MAX, -F32_MAX );
+
+   for( U32 i = 0; i < 8; ++ i )
+   {
+      const F32 px = ( i & 1 ) ? box.maxExtents.x : box.minExtents.x;
+      const F32 py = ( i & 2 ) ? box.maxExtents.y : box.minExtents.y;
+      const F32 pz = ( i & 4 ) ? box.maxExtents.z : box.minExtents.z;
+
+      const F32 w = m[ 12 ] * px + m[ 13 ] * py + m[ 14 ] * pz + m[ 15 ];
+      const F32 z = m[ 8 ] * px + m[ 9 ] * py + m[ 10 ] * pz + m[ 11 ];
+
+      // Boxes reaching in front of the near plane cover the
+      // screen in ways not worth figuring out.
+
+      if( z < 0.0f || w <= 0.0f )
+         return false;
+
+      const F32 invW = 1.0f / w;
+      const F32 x = ( ( m[ 0 ] * px + m[ 1 ] * py + m[ 2 ] * pz + m[ 3 ] ) * invW + 1.0f ) * halfWidth;
+      const F32 y = ( 1.0f - ( m[ 4 ] * px + m[ 5 ] * py + m[ 6 ] * pz + m[ 7 ] ) * invW ) * halfHeight;
+
+      outMin.setMin( Point3F( x, y, z * invW ) );
+      outMax.setMax( Point3F( x, y, z * invW ) );
+   }
+
+   return true;
+}
+
+//-----------------------------------------------------------------------------
+
+bool SceneOcclusionBuffer::isOccluded( const Box3F& box ) const
+{
+   AssertFatal( !mNeedsResolve, "SceneOcclusionBuffer::isOccluded - Buffer has not been resolved" );
+
+   if( mIsEmpty )
+      return false;
+
+   Point3F screenMin;
+   Point3F screenMax;
+
+   if( !_projectBox( box, screenMin, screenMax ) )
+      return false;
+
+   // Leave anything off-screen or beyond the far plane to frustum culling.
+
+   const F32 boxDepth = screenMin.z;
+   if( boxDepth >= 1.0f ||
+       screenMax.x < 0.0f || screenMax.y < 0.0f ||
+       screenMin.x >= F32( mWidth ) || screenMin.y >= F32( mHeight ) )
+      return false;
+
+   // Find all the pixels the box touches.
+
+   const S32 minX = mClamp( S32( mFloor( screenMin.x ) ), 0, S32( mWidth ) - 1 );
+   const S32 maxX = mClamp( S32( mFloor( screenMax.x ) ), 0, S32( mWidth ) - 1 );
+   const S32 minY = mClamp( S32( mFloor( screenMin.y ) ), 0, S32( mHeight ) - 1 );
+   const S32 maxY = mClamp( S32( mFloor( screenMax.y ) ), 0, S32( mHeight ) - 1 );
+
+   // Go through the tiles.  Tiles entirely in front of the box can be skipped.
+   // In all others, the box is visible if any pixel isn't in front of it.
+
+   for( S32 tileY = minY / TileSize; tileY <= maxY / TileSize; ++ tileY )
+      for( S32 tileX = minX / TileSize; tileX <= maxX / TileSize; ++ tileX )
+      {
+         if( mTileMaxDepth[ tileY * mTilesX + tileX ] < boxDepth )
+            continue;
+
+         const S32 x0 = getMax( minX, tileX * TileSize );
+         const S32 x1 = getMin( maxX, tileX * TileSize + TileSize - 1 );
+         const S32 y0 = getMax( minY, tileY * TileSize );
+         const S32 y1 = getMin( maxY, tileY * TileSize + TileSize - 1 );
+
+#ifdef TORQUE_OCCLUSION_SSE
+         const __m128 boxDepthV = _mm_set1_ps( boxDepth );
+#endif
+
+         for( S32 y = y0; y <= y1; ++ y )
+         {
+            const F32* row = &mDepth[ y * mWidth ];
+
+#ifdef TORQUE_OCCLUSION_SSE
+
+            for( S32 x = x0 & ~3; x <= x1; x += 4 )
+            {
+               U32 laneMask = 0xF;
+               if( x < x0 )
+                  laneMask &= 0xF << ( x0 - x );
+               if( x + 3 > x1 )
+                  laneMask &= 0xF >> ( x + 3 - x1 );
+
+               const __m128 notInFront = _mm_cmpge_ps( _mm_loadu_ps( &row[ x ] ), boxDepthV );
+               if( U32( _mm_movemask_ps( notInFront ) ) & laneMask )
+                  return false;
+            }
+
+#else
+
+            for( S32 x = x0; x <= x1; ++ x )
+               if( row[ x ] >= boxDepth )
+                  return false;
+
+#endif
+         }
+      }
+
+   return true;
+}
+
+//-----------------------------------------------------------------------------
+
+F32 SceneOcclusionBuffer::getScreenArea( const Box3F& box ) const
+{
+   Point3F screenMin;
+   Point3F screenMax;
+
+   if( !_projectBox( box, screenMin, screenMax ) )
+      return 1.0f;
+
+   const F32 width = mClampF( screenMax.x, 0.0f, F32( mWidth ) ) - mClampF( screenMin.x, 0.0f, F32( mWidth ) );
+   const F32 height = mClampF( screenMax.y, 0.0f, F32( mHeight ) ) - mClampF( screenMin.y, 0.0f, F32( mHeight ) );
+
+   return ( width * height ) / F32( mWidth * mHeight );
+}
@@ -0,0 +1,247 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _SCENEOCCLUSIONBUFFER_H_
+#define _SCENEOCCLUSIONBUFFER_H_
+
+#ifndef _MMATRIX_H_
+#include "math/mMatrix.h"
+#endif
+
+#ifndef _MBOX_H_
+#include "math/mBox.h"
+#endif
+
+#ifndef _MPOINT4_H_
+#include "math/mPoint4.h"
+#endif
+
+#ifndef _TVECTOR_H_
+#include "core/util/tVector.h"
+#endif
+
+
+class Frustum;
+
+
+/// A small CPU-side depth buffer that occluder geometry is rasterized into
+/// and that object bounds can then be tested against.
+///
+/// Unlike GFXOcclusionQuery, results are available immediately and unlike
+/// OcclusionVolume, no hand-placed geometry is needed.  The buffer is low
+/// resolution and only approximates the occluders, so any occluder geometry
+/// fed to it must lie within the visible geometry of the occluding object.
+///
+/// Depth is stored as post-projection depth in the range [0,1] with 0 on the
+/// near plane.  Occluders are rasterized inner-conservatively: a pixel is only
+/// covered if it lies entirely within the occluder mesh, and it holds the
+/// farthest depth the occluder reaches within its area.  To find the outline
+/// of a mesh, vertices at the same position are welded and edges shared by two
+/// triangles lying on opposite sides of them on screen count as inner edges.
+/// Only outline edges are pulled in by half a pixel; inner edges keep pixel
+/// center coverage so the pixels along them stay covered.  A coarse per-tile
+/// maximum depth allows rejecting most tests without touching the pixels.
+///
+/// Rasterization and testing use SSE where available.
+///
+/// Usage:
+///
+/// @code
+///   buffer.setup( frustum, 256, 128 );
+///   buffer.rasterizeTriangles( points, numPoints, indices, numTriangles );
+///   buffer.resolve();
+///   bool occluded = buffer.isOccluded( box );
+/// @endcode
+///
+/// @note Once resolved, the buffer may be tested against from several
+///   threads concurrently.
+class SceneOcclusionBuffer
+{
+   public:
+
+      enum
+      {
+         /// Width and height of the tiles for which maximum depth is tracked.
+         /// The dimensions of the buffer are rounded up to this.
+         TileSize = 8
+      };
+
+   protected:
+
+      /// Width of the buffer in pixels.
+      U32 mWidth;
+
+      /// Height of the buffer in pixels.
+      U32 mHeight;
+
+      /// Number of tiles in each row.
+      U32 mTilesX;
+
+      /// Number of tile rows.
+      U32 mTilesY;
+
+      /// Depth values; mWidth * mHeight.
+      Vector< F32 > mDepth;
+
+      /// Maximum depth value for each tile; mTilesX * mTilesY.
+      Vector< F32 > mTileMaxDepth;
+
+      /// Transforms world space to clip space.
+      MatrixF mWorldToClip;
+
+      /// Number of triangles that passed trivial rejection and were rasterized.
+      U32 mNumRasterizedTriangles;
+
+      /// True if there has been rasterization since the last resolve().
+      bool mNeedsResolve;
+
+      /// True if nothing has been rasterized since the last clear().
+      bool mIsEmpty;
+
+      /// A line in pixel space; a pixel is covered if a * x + b * y + c is
+      /// non-negative at its center for all edges of a polygon.
+      struct EdgeFunction
+      {
+         F32 a, b, c;
+      };
+
+      /// A point of the current batch sorted by position for welding.
+      struct WeldPoint
+      {
+         Point3F mPos;
+         U32 mIndex;
+      };
+
+      /// A triangle edge of the current batch sorted by its welded
+      /// end points for finding shared edges.
+      struct MeshEdge
+      {
+         U32 mLow;
+         U32 mHigh;
+         U32 mEdge;
+      };
+
+      /// Scratch space for the clip-space vertices of the current batch.
+      Vector< Point4F > mClipVerts;
+
+      /// Scratch space for the clip codes of the current batch.
+      Vector< U32 > mClipCodes;
+
+      /// Scratch space for the pixel coordinates of the current batch.
+      /// Only valid for points in front of the near plane.
+      Vector< Point3F > mScreenVerts;
+
+      /// Scratch space for welding the points of the current batch.
+      Vector< WeldPoint > mWeldPoints;
+
+      /// Welded point index for each point of the current batch.
+      Vector< U32 > mWeldIndices;
+
+      /// On-screen winding of each triangle of the current batch; 1 or -1
+      /// for triangles which need no clipping and 0 for all others.
+      Vector< S32 > mFacing;
+
+      /// Scratch space for finding the shared edges of the current batch.
+      Vector< MeshEdge > mMeshEdges;
+
+      /// For edge i of triangle t at t * 3 + i, the edge of the triangle on
+      /// the other side if it is an inner edge or -1 if it is on the outline.
+      Vector< S32 > mInnerEdges;
+
+      /// Find the inner edges of the current batch.
+      void _findInnerEdges( const U32* indices, U32 numTriangles );
+
+      /// Rasterize a triangle of the current batch which needs no clipping.
+      void _rasterizeMeshTriangle( const U32* indices, U32 triangle );
+
+      /// Clip, project, and rasterize a single clip-space triangle.
+      void _rasterizeTriangle( const Point4F& v0, const Point4F& v1, const Point4F& v2 );
+
+      /// Rasterize a polygon that is fully in front of the near plane and
+      /// given in pixel coordinates with depth in z.  The vertices must be
+      /// wound the same way as the edges and define the depth plane and the
+      /// bounds.  Coverage is given by @a edges.
+      void _rasterizeScreenPolygon( const Point3F* verts, U32 numVerts, const EdgeFunction* edges, U32 numEdges );
+
+      /// Project the corners of the given box to pixel coordinates and return
+      /// the pixel space bounds in @a outMin and @a outMax with the nearest
+      /// depth in the z components.  Returns false if the box reaches in
+      /// front of the near plane.
+      bool _projectBox( const Box3F& box, Point3F& outMin, Point3F& outMax ) const;
+
+   public:
+
+      SceneOcclusionBuffer();
+
+      /// Set up the buffer for the given view and clear it.
+      ///
+      /// @param frustum The view frustum.  Any projection offset must already be baked in.
+      /// @param width Horizontal resolution; rounded up to a multiple of TileSize.
+      /// @param height Vertical resolution; rounded up to a multiple of TileSize.
+      void setup( const Frustum& frustum, U32 width, U32 height );
+
+      /// Reset all depth values to the far plane.
+      void clear();
+
+      /// Rasterize an indexed triangle list into the buffer.  Triangles
+      /// are rasterized two-sided.
+      ///
+      /// @param points World-space vertex positions.
+      /// @param numPoints Number of entries in @a points.
+      /// @param indices Three vertex indices for every triangle.
+      /// @param numTriangles Number of triangles in @a indices.
+      void rasterizeTriangles( const Point3F* points, U32 numPoints, const U32* indices, U32 numTriangles );
+
+      /// Update the per-tile depth data after rasterizing occluders.  Must be
+      /// called before testing against the buffer.
+      void resolve();
+
+      /// Return true if the given world-space box is completely hidden
+      /// behind the occluders in the buffer.
+      bool isOccluded( const Box3F& box ) const;
+
+      /// Return the fraction of the viewport covered by the screen-space
+      /// bounds of the given world-space box.  Returns 1 for boxes that
+      /// reach in front of the near plane.
+      F32 getScreenArea( const Box3F& box ) const;
+
+      /// Return true if nothing has been rasterized since the buffer was cleared.
+      bool isEmpty() const { return mIsEmpty; }
+
+      /// Return the number of triangles rasterized since the buffer was cleared.
+      U32 getNumRasterizedTriangles() const { return mNumRasterizedTriangles; }
+
+      /// Return the horizontal resolution of the buffer.
+      U32 getWidth() const { return mWidth; }
+
+      /// Return the vertical resolution of the buffer.
+      U32 getHeight() const { return mHeight; }
+
+      /// Return the depth value stored for the given pixel.
+      F32 getDepth( U32 x, U32 y ) const
+      {
+         AssertFatal( x < mWidth && y < mHeight, "SceneOcclusionBuffer::getDepth - Pixel out of range" );
+         return mDepth[ y * mWidth + x ];
+      }
+};
+
+#endif // !_SCENEOCCLUSIONBUFFER_H_
@@ -0,0 +1,172 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2014 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "testing/nullGFXDevice.h"
+#include "scene/culling/sceneCullingState.h"
+#include "scene/sceneManager.h"
+#include "scene/sceneRenderState.h"
+#include "renderInstance/renderPassManager.h"
+#include "gfx/gfxDevice.h"
+#include "math/mRandom.h"
+#include "console/console.h"
+
+/// Counts the objects which survive culling and get to prepare their render instances.
+static U32 gSceneCullingTestPrepared = 0;
+
+/// A small box that does nothing but count the times it is asked to render.
+class SceneCullingTestBox : public SceneObject
+{
+   typedef SceneObject Parent;
+
+public:
+
+   SceneCullingTestBox()
+   {
+      mNetFlags.set( IsGhost );
+      mTypeMask |= StaticShapeObjectType;
+      mObjBox.set( Point3F( -1, -1, -1 ), Point3F( 1, 1, 1 ) );
+   }
+
+   bool onAdd()
+   {
+      if ( !Parent::onAdd() )
+         return false;
+
+      resetWorldBox();
+      return true;
+   }
+
+   void prepRenderImage( SceneRenderState *state )
+   {
+      gSceneCullingTestPrepared++;
+   }
+};
+
+FIXTURE(SceneCullingState)
+{
+public:
+   NullGFXDevice device;
+   Vector<SceneCullingTestBox*> boxes;
+   S32 oldThreshold;
+
+   void SetUp()
+   {
+      device.create();
+      oldThreshold = SceneCullingState::smParallelCullThreshold;
+   }
+
+   void TearDown()
+   {
+      for ( U32 i = 0; i < boxes.size(); i++ )
+      {
+         gClientSceneGraph->removeObjectFromScene( boxes[i] );
+         boxes[i]->deleteObject();
+      }
+      boxes.clear();
+
+      SceneCullingState::smParallelCullThreshold = oldThreshold;
+      device.destroy();
+   }
+
+   /// Scatters boxes all around the camera so that the frustum
+   /// only keeps part of them.
+   void createBoxes( U32 count, U32 seed )
+   {
+      MRandomLCG rand( seed );
+      for ( U32 i = 0; i < count; i++ )
+      {
+         SceneCullingTestBox *box = new SceneCullingTestBox();
+         MatrixF mat( true );
+         mat.setPosition( Point3F( rand.randF( -500, 500 ), rand.randF( -500, 500 ), rand.randF( -20, 20 ) ) );
+         box->setTransform( mat );
+         box->registerObject();
+         gClientSceneGraph->addObjectToScene( box );
+         boxes.push_back( box );
+      }
+   }
+};
+
+TEST_FIX(SceneCullingState, StressTestParallelCulling)
+{
+   // Renders a frame of 50000 boxes on the null device with the object
+   // list culled on this thread alone and then split across the thread
+   // pool, and prints the CPU time of each.  Both have to keep the same
+   // boxes.
+   if ( !gClientSceneGraph )
+   {
+      Con::printf( "SceneCullingState: no client scene, skipping." );
+      return;
+   }
+
+   const U32 numBoxes = 50000;
+   const U32 numFrames = 50;
+
+   createBoxes( numBoxes, 1 );
+
+   RenderPassManager *pass = new RenderPassManager();
+   pass->registerObject();
+
+   const RectI viewport( 0, 0, 1024, 768 );
+   MatrixF cameraMat( true );
+   const Frustum frustum( false, -0.1f, 0.1f, 0.075f, -0.075f, 0.1f, 1000.0f, cameraMat );
+
+   MatrixF worldToCamera( cameraMat );
+   worldToCamera.inverse();
+   MatrixF projection;
+   frustum.getProjectionMatrix( &projection );
+
+   GFX->setWorldMatrix( worldToCamera );
+   GFX->setProjectionMatrix( projection );
+
+   U32 prepared[2];
+   for ( U32 mode = 0; mode < 2; mode++ )
+   {
+      SceneCullingState::smParallelCullThreshold = mode == 0 ? 0 : oldThreshold;
+
+      gSceneCullingTestPrepared = 0;
+      const U32 start = Platform::getRealMilliseconds();
+      for ( U32 frame = 0; frame < numFrames; frame++ )
+      {
+         SceneRenderState state( gClientSceneGraph, SPT_Diffuse,
+            SceneCameraState( viewport, frustum, worldToCamera, projection ), pass, false );
+         gClientSceneGraph->renderSceneNoLights( &state, StaticShapeObjectType );
+      }
+      const U32 elapsed = Platform::getRealMilliseconds() - start;
+
+      prepared[mode] = gSceneCullingTestPrepared / numFrames;
+      Con::printf( "SceneCullingState %s: %d boxes, %d visible, %.2f ms per frame",
+         mode == 0 ? "serial" : "parallel",
+         numBoxes,
+         prepared[mode],
+         F32( elapsed ) / numFrames );
+   }
+
+   EXPECT_GT( prepared[0], 0 );
+   EXPECT_LT( prepared[0], numBoxes );
+   EXPECT_EQ( prepared[0], prepared[1] );
+
+   pass->deleteObject();
+}
+
+#endif
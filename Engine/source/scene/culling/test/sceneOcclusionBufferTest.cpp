@@ -0,0 +1,262 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2014 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "scene/culling/sceneOcclusionBuffer.h"
+#include "math/mRandom.h"
+#include "math/util/frustum.h"
+#include "console/console.h"
+
+FIXTURE(SceneOcclusionBuffer)
+{
+public:
+   SceneOcclusionBuffer buffer;
+   Vector<Point3F> points;
+   Vector<U32> indices;
+
+   /// Adds a quad spanning the given corners to the geometry.
+   void addQuad(const Point3F& a, const Point3F& b, const Point3F& c, const Point3F& d)
+   {
+      const U32 base = points.size();
+      points.push_back(a);
+      points.push_back(b);
+      points.push_back(c);
+      points.push_back(d);
+
+      const U32 quad[] = { 0, 1, 2, 0, 2, 3 };
+      for (U32 i = 0; i < 6; i++)
+         indices.push_back(base + quad[i]);
+   }
+
+   /// Adds the six sides of the given box to the geometry.
+   void addBox(const Box3F& box)
+   {
+      const U32 base = points.size();
+      // Bit 0 of the corner index selects x, bit 1 y, and bit 2 z.
+      for (U32 i = 0; i < 8; i++)
+         points.push_back(Point3F((i & 1) ? box.maxExtents.x : box.minExtents.x,
+                                  (i & 2) ? box.maxExtents.y : box.minExtents.y,
+                                  (i & 4) ? box.maxExtents.z : box.minExtents.z));
+
+      const U32 faces[6][4] = {
+         { 0, 2, 6, 4 }, { 1, 5, 7, 3 },  // -x, +x
+         { 0, 4, 5, 1 }, { 2, 3, 7, 6 },  // -y, +y
+         { 0, 1, 3, 2 }, { 4, 6, 7, 5 },  // -z, +z
+      };
+      for (U32 i = 0; i < 6; i++)
+      {
+         const U32 quad[] = { 0, 1, 2, 0, 2, 3 };
+         for (U32 j = 0; j < 6; j++)
+            indices.push_back(base + faces[i][quad[j]]);
+      }
+   }
+
+   void rasterize()
+   {
+      buffer.rasterizeTriangles(points.address(), points.size(), indices.address(), indices.size() / 3);
+      buffer.resolve();
+   }
+
+   void SetUp()
+   {
+      points.clear();
+      indices.clear();
+   }
+};
+
+TEST_FIX(SceneOcclusionBuffer, Wall)
+{
+   // Camera at the origin looking down +Y at a wall 10 units away.
+   Frustum frustum;
+   frustum.set(false, mDegToRad(60.f), 2.f, 0.1f, 1000.f);
+   buffer.setup(frustum, 256, 128);
+
+   EXPECT_TRUE(buffer.isEmpty());
+   EXPECT_FALSE(buffer.isOccluded(Box3F(Point3F(-1.f, 19.f, -1.f), Point3F(1.f, 21.f, 1.f))));
+
+   addQuad(Point3F(-5.f, 10.f, -3.f), Point3F(5.f, 10.f, -3.f),
+           Point3F(5.f, 10.f, 3.f), Point3F(-5.f, 10.f, 3.f));
+   rasterize();
+
+   EXPECT_FALSE(buffer.isEmpty());
+   EXPECT_EQ(2u, buffer.getNumRasterizedTriangles());
+
+   // Behind the wall.
+   EXPECT_TRUE(buffer.isOccluded(Box3F(Point3F(-1.f, 19.f, -1.f), Point3F(1.f, 21.f, 1.f))));
+   EXPECT_TRUE(buffer.isOccluded(Box3F(Point3F(-5.f, 50.f, -5.f), Point3F(5.f, 60.f, 5.f))));
+
+   // In front of the wall.
+   EXPECT_FALSE(buffer.isOccluded(Box3F(Point3F(-1.f, 5.f, -1.f), Point3F(1.f, 7.f, 1.f))));
+
+   // Reaching through the wall.
+   EXPECT_FALSE(buffer.isOccluded(Box3F(Point3F(-1.f, 9.f, -1.f), Point3F(1.f, 21.f, 1.f))));
+
+   // Behind the wall but above its top edge.
+   EXPECT_FALSE(buffer.isOccluded(Box3F(Point3F(-1.f, 19.f, 8.f), Point3F(1.f, 21.f, 10.f))));
+
+   // Behind the wall but off to the side.
+   EXPECT_FALSE(buffer.isOccluded(Box3F(Point3F(12.f, 19.f, -1.f), Point3F(14.f, 21.f, 1.f))));
+
+   // Reaching in front of the near plane.
+   EXPECT_FALSE(buffer.isOccluded(Box3F(Point3F(-1.f, -1.f, -1.f), Point3F(1.f, 21.f, 1.f))));
+
+   // Clearing removes the wall.
+   buffer.clear();
+   EXPECT_TRUE(buffer.isEmpty());
+   EXPECT_FALSE(buffer.isOccluded(Box3F(Point3F(-1.f, 19.f, -1.f), Point3F(1.f, 21.f, 1.f))));
+}
+
+TEST_FIX(SceneOcclusionBuffer, NearPlaneClipping)
+{
+   // A floor below the camera that extends behind it has to be
+   // clipped against the near plane and still hide what's under it.
+   MatrixF xfm(true);
+   xfm.setPosition(Point3F(0.f, 0.f, 2.f));
+
+   Frustum frustum;
+   frustum.set(false, mDegToRad(90.f), 2.f, 0.1f, 1000.f, xfm);
+   buffer.setup(frustum, 256, 128);
+
+   addQuad(Point3F(-100.f, -100.f, 0.f), Point3F(100.f, -100.f, 0.f),
+           Point3F(100.f, 100.f, 0.f), Point3F(-100.f, 100.f, 0.f));
+   rasterize();
+
+   EXPECT_TRUE(buffer.isOccluded(Box3F(Point3F(-1.f, 20.f, -5.f), Point3F(1.f, 22.f, -3.f))));
+   EXPECT_FALSE(buffer.isOccluded(Box3F(Point3F(-1.f, 20.f, -5.f), Point3F(1.f, 22.f, 1.f))));
+   EXPECT_FALSE(buffer.isOccluded(Box3F(Point3F(-1.f, 20.f, 1.f), Point3F(1.f, 22.f, 3.f))));
+}
+
+TEST_FIX(SceneOcclusionBuffer, Ortho)
+{
+   // Orthographic camera looking straight down at a roof.
+   MatrixF xfm(true);
+   xfm.set(EulerF(mDegToRad(90.f), 0.f, 0.f), Point3F(0.f, 0.f, 100.f));
+
+   Frustum frustum;
+   frustum.set(true, -50.f, 50.f, 50.f, -50.f, 1.f, 200.f, xfm);
+   buffer.setup(frustum, 128, 128);
+
+   addBox(Box3F(Point3F(-10.f, -10.f, 10.f), Point3F(10.f, 10.f, 20.f)));
+   rasterize();
+
+   EXPECT_TRUE(buffer.isOccluded(Box3F(Point3F(-5.f, -5.f, 0.f), Point3F(5.f, 5.f, 5.f))));
+   EXPECT_FALSE(buffer.isOccluded(Box3F(Point3F(-5.f, -5.f, 0.f), Point3F(5.f, 5.f, 25.f))));
+   EXPECT_FALSE(buffer.isOccluded(Box3F(Point3F(15.f, -5.f, 0.f), Point3F(20.f, 5.f, 5.f))));
+}
+
+TEST_FIX(SceneOcclusionBuffer, EdgeMidPixel)
+{
+   // Orthographic camera looking down +Y with one unit per pixel, so
+   // pixel column 138 spans x from 10 to 11.
+   Frustum frustum;
+   frustum.set(true, -128.f, 128.f, 64.f, -64.f, 1.f, 200.f);
+   buffer.setup(frustum, 256, 128);
+
+   // The right edge of the wall lands past the center of that column.
+   addQuad(Point3F(-20.f, 50.f, -20.f), Point3F(10.6f, 50.f, -20.f),
+           Point3F(10.6f, 50.f, 20.f), Point3F(-20.f, 50.f, 20.f));
+   rasterize();
+
+   // Only partly covered, so it must not hide what peeks past the edge.
+   EXPECT_FALSE(buffer.isOccluded(Box3F(Point3F(10.7f, 60.f, -1.f), Point3F(10.9f, 70.f, 1.f))));
+
+   // The column next to it is fully covered.
+   EXPECT_TRUE(buffer.isOccluded(Box3F(Point3F(9.2f, 60.f, -1.f), Point3F(9.8f, 70.f, 1.f))));
+
+   // The diagonal shared by the two triangles of the wall leaves no gap.
+   EXPECT_TRUE(buffer.isOccluded(Box3F(Point3F(-10.f, 60.f, -5.f), Point3F(0.f, 70.f, 5.f))));
+}
+
+TEST_FIX(SceneOcclusionBuffer, StressTestCity)
+{
+   // A city block of occluders: time to rasterize them, time to
+   // test 50k boxes, and the share of frustum visible boxes the
+   // buffer rejects.
+
+   MRandomLCG random(1376312589);
+
+   MatrixF xfm(true);
+   xfm.set(EulerF(mDegToRad(5.f), 0.f, 0.f), Point3F(0.f, -50.f, 2.f));
+
+   Frustum frustum;
+   frustum.set(false, mDegToRad(90.f), 16.f / 9.f, 0.1f, 1000.f, xfm);
+
+   // Buildings along both sides of a street.
+   for (U32 i = 0; i < 64; i++)
+   {
+      const F32 x = (i & 1) ? random.randF(10.f, 40.f) : random.randF(-40.f, -10.f);
+      const F32 y = F32(i / 2) * 30.f;
+      const Point3F extents(random.randF(5.f, 15.f), random.randF(10.f, 15.f), random.randF(10.f, 60.f));
+      addBox(Box3F(Point3F(x - extents.x, y - extents.y, 0.f), Point3F(x + extents.x, y + extents.y, extents.z)));
+   }
+
+   Vector<Box3F> boxes;
+   for (U32 i = 0; i < 50000; i++)
+   {
+      const Point3F center(random.randF(-500.f, 500.f), random.randF(0.f, 1000.f), random.randF(0.f, 20.f));
+      const Point3F extents(random.randF(0.5f, 5.f), random.randF(0.5f, 5.f), random.randF(0.5f, 5.f));
+      boxes.push_back(Box3F(center - extents, center + extents));
+   }
+
+   const U32 numIterations = 20;
+
+   U32 start = Platform::getRealMilliseconds();
+   for (U32 n = 0; n < numIterations; n++)
+   {
+      buffer.setup(frustum, 256, 128);
+      rasterize();
+   }
+   const U32 rasterTime = Platform::getRealMilliseconds() - start;
+
+   U32 numVisible = 0;
+   U32 numOccluded = 0;
+
+   start = Platform::getRealMilliseconds();
+   for (U32 n = 0; n < numIterations; n++)
+   {
+      numVisible = 0;
+      numOccluded = 0;
+
+      for (U32 i = 0; i < boxes.size(); i++)
+      {
+         if (frustum.isCulled(boxes[i]))
+            continue;
+
+         numVisible++;
+         if (buffer.isOccluded(boxes[i]))
+            numOccluded++;
+      }
+   }
+   const U32 testTime = Platform::getRealMilliseconds() - start;
+
+   Con::printf("SceneOcclusionBuffer: %i occluder triangles, %i of %i boxes in frustum",
+      indices.size() / 3, numVisible, boxes.size());
+   Con::printf("   occluded: %i (%.1f%%)", numOccluded, numVisible ? F32(numOccluded) * 100.f / F32(numVisible) : 0.f);
+   Con::printf("   rasterize: %.3f ms/frame", F32(rasterTime) / F32(numIterations));
+   Con::printf("   frustum and occlusion tests: %.3f ms/frame", F32(testTime) / F32(numIterations));
+
+   EXPECT_GT(numOccluded, 0u);
+   EXPECT_LT(numOccluded, numVisible);
+}
+
+#endif
@@ -71,6 +71,33 @@ MODULE_BEGIN( Scene )
          "If true, zone culling will be disabled and the scene contents will only be culled against the root frustum.\n\n"
          "@ingroup Rendering\n" );
 
+      Con::addVariable( "$Scene::parallelCullThreshold", TypeS32, &SceneCullingState::smParallelCullThreshold,
+         "Minimum number of objects in a culling query before culling is split across the worker threads "
+         "of the global thread pool.  Set to 0 to always cull on the main thread.\n\n"
+         "@ingroup Rendering\n" );
+
+      Con::addVariable( "$Scene::softwareOcclusion", TypeBool, &SceneCullingState::smSoftwareOcclusion,
+         "If true, objects flagged as software occluders are rasterized into a small CPU depth buffer "
+         "for diffuse passes and objects hidden behind them are culled.\n\n"
+         "@ingroup Rendering\n" );
+
+      Con::addVariable( "$Scene::softwareOcclusionWidth", TypeS32, &SceneCullingState::smSoftwareOcclusionWidth,
+         "Horizontal resolution of the software occlusion buffer.\n\n"
+         "@ingroup Rendering\n" );
+
+      Con::addVariable( "$Scene::softwareOcclusionHeight", TypeS32, &SceneCullingState::smSoftwareOcclusionHeight,
+         "Vertical resolution of the software occlusion buffer.\n\n"
+         "@ingroup Rendering\n" );
+
+      Con::addVariable( "$Scene::maxSoftwareOccluders", TypeS32, &SceneCullingState::smMaxSoftwareOccluders,
+         "Maximum number of occluders rasterized into the software occlusion buffer.  Occluders covering "
+         "more of the screen are preferred.\n\n"
+         "@ingroup Rendering\n" );
+
+      Con::addVariable( "$Scene::softwareOccluderMinScreenArea", TypeF32, &SceneCullingState::smSoftwareOccluderMinScreenArea,
+         "Fraction of the screen the bounds of a software occluder must at least cover to be rasterized.\n\n"
+         "@ingroup Rendering\n" );
+
       Con::addVariable( "$Scene::renderBoundingBoxes", TypeBool, &SceneManager::smRenderBoundingBoxes,
          "If true, the bounding boxes of objects will be displayed.\n\n"
          "@ingroup Rendering" );
@@ -428,6 +455,25 @@ void SceneManager::_renderScene( SceneRenderState* state, U32 objectMask, SceneZ
    mBatchQueryList.clear();
    getContainer()->findObjectList( queryBox, objectMask, &mBatchQueryList );
 
+   // Drop the objects rejected by the state's object filter.
+
+   if( !state->getObjectFilterDelegate().empty() )
+   {
+      for( U32 i = 0; i < mBatchQueryList.size(); )
+      {
+         if( state->isObjectRendered( mBatchQueryList[ i ] ) )
+            i ++;
+         else
+            mBatchQueryList.erase_fast( i );
+      }
+   }
+
+   // Rasterize the software occluders so the culling below
+   // can reject what is hidden behind them.
+
+   if( SceneCullingState::smSoftwareOcclusion && state->isDiffusePass() )
+      state->getCullingState().buildOcclusionBuffer( mBatchQueryList.address(), mBatchQueryList.size() );
+
    // Cull the list.
 
    U32 numRenderObjects = state->getCullingState().cullObjects(
@@ -447,7 +493,7 @@ void SceneManager::_renderScene( SceneRenderState* state, U32 objectMask, SceneZ
    if( connection )
    {
       Player* player = dynamic_cast< Player* >( connection->getControlObject() );
-      if( player )
+      if( player && state->isObjectRendered( player ) )
       {
          mBatchQueryList.setSize( numRenderObjects );
          if( !mBatchQueryList.contains( player ) )
@@ -601,7 +647,11 @@ bool SceneManager::addObjectToScene( SceneObject* object )
 
    // Notify the object.
 
-   return object->onSceneAdd();
+   if( !object->onSceneAdd() )
+      return false;
+
+   getObjectChangeSignal().trigger( object, object->getWorldBox() );
+   return true;
 }
 
 //-----------------------------------------------------------------------------
@@ -614,6 +664,7 @@ void SceneManager::removeObjectFromScene( SceneObject* obj )
    // Notify the object.
 
    obj->onSceneRemove();
+   getObjectChangeSignal().trigger( obj, obj->getWorldBox() );
 
    // Remove the object from the container.
 
@@ -632,7 +683,7 @@ void SceneManager::removeObjectFromScene( SceneObject* obj )
 
 //-----------------------------------------------------------------------------
 
-void SceneManager::notifyObjectDirty( SceneObject* object )
+void SceneManager::notifyObjectDirty( SceneObject* object, const Box3F* prevWorldBox )
 {
    // Update container state.
 
@@ -643,6 +694,12 @@ void SceneManager::notifyObjectDirty( SceneObject* object )
 
    if( getZoneManager() )
       getZoneManager()->notifyObjectChanged( object );
+
+   // Let listeners know about both the old and the new extents.
+
+   if( prevWorldBox )
+      getObjectChangeSignal().trigger( object, *prevWorldBox );
+   getObjectChangeSignal().trigger( object, object->getWorldBox() );
 }
 
 //-----------------------------------------------------------------------------
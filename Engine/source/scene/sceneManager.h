@@ -109,6 +109,10 @@ class SceneManager
       /// A signal used to notify of render passes.
       typedef Signal< void( SceneManager*, const SceneRenderState* ) > RenderSignal;
 
+      /// A signal used to notify of objects being added, removed or changed.  The
+      /// box is the world space area affected by the change.
+      typedef Signal< void( SceneObject*, const Box3F& ) > ObjectChangeSignal;
+
       /// If true use the last stored locked frustum for culling
       /// the diffuse render pass.
       /// @see smLockedDiffuseFrustum
@@ -222,8 +226,16 @@ class SceneManager
       void removeObjectFromScene( SceneObject* object );
 
       /// Let the scene manager know that the given object has changed its transform or
-      /// sizing state.
-      void notifyObjectDirty( SceneObject* object );
+      /// sizing state.  If known, pass the world box the object had before the change.
+      void notifyObjectDirty( SceneObject* object, const Box3F* prevWorldBox = NULL );
+
+      /// Returns the signal triggered when objects are added to, removed from
+      /// or changed within any scene.
+      static ObjectChangeSignal& getObjectChangeSignal()
+      {
+         static ObjectChangeSignal theSignal;
+         return theSignal;
+      }
 
       /// @}
 
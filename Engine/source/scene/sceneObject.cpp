@@ -192,6 +192,16 @@ bool SceneObject::castRayRendered(const Point3F &start, const Point3F &end, RayI
 
 //-----------------------------------------------------------------------------
 
+bool SceneObject::buildOccluderPolyList( const SceneCameraState& cameraState, AbstractPolyList* polyList, const Box3F& box )
+{
+   // By default, occlusion uses the collision geometry.  Objects whose
+   // collision geometry extends past their visible geometry should not
+   // be flagged as software occluders or need to override this.
+   return buildPolyList( PLC_Collision, polyList, box, SphereF( box.getCenter(), box.len() * 0.5f ) );
+}
+
+//-----------------------------------------------------------------------------
+
 bool SceneObject::containsPoint( const Point3F& point )
 {
    // If it's not in the AABB, then it can't be in the OBB either,
@@ -421,6 +431,7 @@ void SceneObject::setTransform( const MatrixF& mat )
 
    // Update the transforms.
 
+   const Box3F prevWorldBox = mWorldBox;
    mObjToWorld = mWorldToObj = mat;
    mWorldToObj.affineInverse();
 
@@ -431,7 +442,7 @@ void SceneObject::setTransform( const MatrixF& mat )
    // If we're in a SceneManager, sync our scene state.
 
    if( mSceneManager != NULL )
-      mSceneManager->notifyObjectDirty( this );
+      mSceneManager->notifyObjectDirty( this, &prevWorldBox );
 
    setRenderTransform( mat );
 }
@@ -664,6 +675,11 @@ void SceneObject::initPersistFields()
          "Determines if the object may be selected from wihin the Tools.\n"
          "@see isSelectable()\n" );
 
+      addProtectedField( "isSoftwareOccluder", TypeBool, Offset( mObjectFlags, SceneObject ),
+         &_setSoftwareOccluder, &_getSoftwareOccluder,
+         "Controls whether the object hides objects behind it when software occlusion culling is enabled.\n"
+         "@see $Scene::softwareOcclusion\n" );
+
    endGroup( "Editing" );
 
    addGroup( "Mounting" );
@@ -883,6 +899,38 @@ bool SceneObject::_setSelectionEnabled( void *object, const char *index, const c
    return false;
 }
 
+//-----------------------------------------------------------------------------
+
+void SceneObject::setSoftwareOccluder( bool value )
+{
+   if( value )
+      mObjectFlags.set( SoftwareOccluderFlag );
+   else
+      mObjectFlags.clear( SoftwareOccluderFlag );
+
+   setMaskBits( FlagMask );
+}
+
+//-----------------------------------------------------------------------------
+
+const char* SceneObject::_getSoftwareOccluder( void* object, const char* data )
+{
+   SceneObject* obj = reinterpret_cast< SceneObject* >( object );
+   if( obj->mObjectFlags.test( SoftwareOccluderFlag ) )
+      return "1";
+   else
+      return "0";
+}
+
+//-----------------------------------------------------------------------------
+
+bool SceneObject::_setSoftwareOccluder( void *object, const char *index, const char *data )
+{
+   SceneObject* obj = reinterpret_cast< SceneObject* >( object );
+   obj->setSoftwareOccluder( dAtob( data ) );
+   return false;
+}
+
 //--------------------------------------------------------------------------
 
 U32 SceneObject::packUpdate( NetConnection* conn, U32 mask, BitStream* stream )
@@ -171,7 +171,11 @@ class SceneObject : public NetObject, private SceneContainer::Link, public Proce
          /// If set, object will be used as a sound occluder.
          SoundOccluderFlag = BIT( 4 ),
 
-         NextFreeFlag = BIT( 5 )
+         /// If set, object geometry will be rasterized into the software occlusion
+         /// buffer.  In this case, the object should implement buildOccluderPolyList().
+         SoftwareOccluderFlag = BIT( 5 ),
+
+         NextFreeFlag = BIT( 6 )
       };
 
    protected:
@@ -444,6 +448,12 @@ class SceneObject : public NetObject, private SceneContainer::Link, public Proce
       /// Return true if the object should be taken into account for visual occlusion.
       bool isVisualOccluder() const { return mObjectFlags.test( VisualOccluderFlag ); }
 
+      /// Return true if the object should be rasterized into the software occlusion buffer.
+      bool isSoftwareOccluder() const { return mObjectFlags.test( SoftwareOccluderFlag ); }
+
+      /// Set whether the object gets rasterized into the software occlusion buffer.
+      void setSoftwareOccluder( bool value );
+
       /// @}
 
       /// @name Collision and transform related interface
@@ -606,6 +616,19 @@ class SceneObject : public NetObject, private SceneContainer::Link, public Proce
       ///   if method is not implemented.
       virtual void buildSilhouette( const SceneCameraState& cameraState, Vector< Point3F >& outPoints ) {}
 
+      /// Build the geometry that represents this object in the software occlusion buffer.
+      ///
+      /// The geometry must not extend beyond what the object actually renders or
+      /// objects behind it will be culled incorrectly.  It should also be as simple
+      /// as possible.  The default implementation uses the collision geometry.
+      ///
+      /// @param cameraState Camera view parameters.
+      /// @param polyList Poly list to receive the geometry.
+      /// @param box World-space area of interest.  Geometry outside of it can be omitted.
+      /// @return True if any geometry was added.
+      /// @see SoftwareOccluderFlag
+      virtual bool buildOccluderPolyList( const SceneCameraState& cameraState, AbstractPolyList* polyList, const Box3F& box );
+
       /// Return true if the given point is contained by the object's (collision) shape.
       ///
       /// The default implementation will return true if the point is within the object's
@@ -815,6 +838,8 @@ class SceneObject : public NetObject, private SceneContainer::Link, public Proce
       static bool _setRenderEnabled( void *object, const char *index, const char *data );
       static const char* _getSelectionEnabled( void *object, const char *data );
       static bool _setSelectionEnabled( void *object, const char *index, const char *data );
+      static const char* _getSoftwareOccluder( void *object, const char *data );
+      static bool _setSoftwareOccluder( void *object, const char *index, const char *data );
       static bool _setFieldPosition( void *object, const char *index, const char *data );
       static bool _setFieldRotation( void *object, const char *index, const char *data );
       static bool _setFieldScale( void *object, const char *index, const char *data );
@@ -61,6 +61,10 @@ class SceneRenderState
       /// @see getOverrideMaterial
       typedef Delegate< BaseMatInstance*( BaseMatInstance* ) > MatDelegate;
 
+      /// The delegate used to filter the objects rendered.
+      /// @see getObjectFilterDelegate
+      typedef Delegate< bool( SceneObject* ) > ObjectFilterDelegate;
+
    protected:
 
       /// SceneManager being rendered in this state.
@@ -81,6 +85,9 @@ class SceneRenderState
       /// The optional material override delegate.
       MatDelegate mMatDelegate;
 
+      /// The optional object filter delegate.
+      ObjectFilterDelegate mObjectFilter;
+
       ///
       MatrixF mDiffuseCameraTransform;
 
@@ -329,6 +336,24 @@ class SceneRenderState
       const MatDelegate& getMaterialDelegate() const { return mMatDelegate; }
 
       /// @}
+
+      /// @name Object Filtering
+      /// @{
+
+      /// Returns true if the object passes the optional filter
+      /// and should be rendered with this state.
+      bool isObjectRendered( SceneObject *object ) const
+      {
+         return mObjectFilter.empty() || mObjectFilter( object );
+      }
+
+      /// Returns the optional object filter delegate which can further
+      /// restrict the objects selected by the type mask of a render call.
+      /// @see isObjectRendered
+      ObjectFilterDelegate& getObjectFilterDelegate() { return mObjectFilter; }
+      const ObjectFilterDelegate& getObjectFilterDelegate() const { return mObjectFilter; }
+
+      /// @}
 };
 
 #endif // _SCENERENDERSTATE_H_
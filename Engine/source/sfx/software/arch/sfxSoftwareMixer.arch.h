@@ -0,0 +1,39 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _SFXSOFTWAREMIXER_ARCH_H_
+#define _SFXSOFTWAREMIXER_ARCH_H_
+
+// Portable versions, also used by the SIMD versions for the remainder.
+#if (defined( TORQUE_CPU_X86 ) || defined( TORQUE_CPU_X64 ))
+# // x86 CPU family implementations
+extern void sfx_mix_mono_SSE( F32 *out, const F32 *src, U32 count, F32 pos, F32 step,
+                              F32 gainLeft, F32 gainRight );
+extern void sfx_mix_stereo_SSE( F32 *out, const F32 *src, U32 srcChannels, U32 count, F32 pos, F32 step,
+                                F32 gainLeft, F32 gainRight );
+extern void sfx_mix_to_s16_SSE( S16 *out, const F32 *src, U32 count );
+#
+#else
+# // Other CPU types go here...
+#endif
+
+#endif // _SFXSOFTWAREMIXER_ARCH_H_
@@ -0,0 +1,127 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+
+#if (defined( TORQUE_CPU_X86 ) || defined( TORQUE_CPU_X64 ))
+#include "sfx/software/sfxSoftwareMixer.h"
+#include "sfx/software/arch/sfxSoftwareMixer.arch.h"
+#include <emmintrin.h>
+
+// Accumulate four mono samples panned into four interleaved stereo frames.
+static inline void _accumulateFrames( F32 *out, __m128 left, __m128 right )
+{
+   _mm_storeu_ps( out, _mm_add_ps( _mm_loadu_ps( out ), _mm_unpacklo_ps( left, right ) ) );
+   _mm_storeu_ps( out + 4, _mm_add_ps( _mm_loadu_ps( out + 4 ), _mm_unpackhi_ps( left, right ) ) );
+}
+
+void sfx_mix_mono_SSE( F32 *out, const F32 *src, U32 count, F32 pos, F32 step,
+                       F32 gainLeft, F32 gainRight )
+{
+   const __m128 vStep = _mm_set1_ps( step );
+   const __m128 vBase = _mm_add_ps( _mm_set1_ps( pos ), _mm_mul_ps( _mm_setr_ps( 0.0f, 1.0f, 2.0f, 3.0f ), vStep ) );
+   const __m128 vGainLeft = _mm_set1_ps( gainLeft );
+   const __m128 vGainRight = _mm_set1_ps( gainRight );
+
+   const U32 end = count & ~3;
+   for ( U32 i = 0; i < end; i += 4 )
+   {
+      // Read positions are never negative so truncation is the floor.
+      const __m128 p = _mm_add_ps( vBase, _mm_mul_ps( _mm_set1_ps( F32( i ) ), vStep ) );
+      const __m128i index = _mm_cvttps_epi32( p );
+      const __m128 frac = _mm_sub_ps( p, _mm_cvtepi32_ps( index ) );
+
+      S32 idx[4];
+      _mm_storeu_si128( (__m128i*)idx, index );
+
+      const __m128 a = _mm_setr_ps( src[idx[0]], src[idx[1]], src[idx[2]], src[idx[3]] );
+      const __m128 b = _mm_setr_ps( src[idx[0] + 1], src[idx[1] + 1], src[idx[2] + 1], src[idx[3] + 1] );
+      const __m128 sample = _mm_add_ps( a, _mm_mul_ps( _mm_sub_ps( b, a ), frac ) );
+
+      _accumulateFrames( out + i * 2, _mm_mul_ps( sample, vGainLeft ), _mm_mul_ps( sample, vGainRight ) );
+   }
+
+   sfx_mix_mono_C( out + end * 2, src, count & 3, pos + F32( end ) * step, step, gainLeft, gainRight );
+}
+
+void sfx_mix_stereo_SSE( F32 *out, const F32 *src, U32 srcChannels, U32 count, F32 pos, F32 step,
+                         F32 gainLeft, F32 gainRight )
+{
+   const __m128 vStep = _mm_set1_ps( step );
+   const __m128 vBase = _mm_add_ps( _mm_set1_ps( pos ), _mm_mul_ps( _mm_setr_ps( 0.0f, 1.0f, 2.0f, 3.0f ), vStep ) );
+   const __m128 vGainLeft = _mm_set1_ps( gainLeft );
+   const __m128 vGainRight = _mm_set1_ps( gainRight );
+
+   const U32 end = count & ~3;
+   for ( U32 i = 0; i < end; i += 4 )
+   {
+      const __m128 p = _mm_add_ps( vBase, _mm_mul_ps( _mm_set1_ps( F32( i ) ), vStep ) );
+      const __m128i index = _mm_cvttps_epi32( p );
+      const __m128 frac = _mm_sub_ps( p, _mm_cvtepi32_ps( index ) );
+
+      S32 idx[4];
+      _mm_storeu_si128( (__m128i*)idx, index );
+
+      const F32 *a0 = src + idx[0] * srcChannels;
+      const F32 *a1 = src + idx[1] * srcChannels;
+      const F32 *a2 = src + idx[2] * srcChannels;
+      const F32 *a3 = src + idx[3] * srcChannels;
+      const F32 *b0 = a0 + srcChannels;
+      const F32 *b1 = a1 + srcChannels;
+      const F32 *b2 = a2 + srcChannels;
+      const F32 *b3 = a3 + srcChannels;
+
+      const __m128 aLeft = _mm_setr_ps( a0[0], a1[0], a2[0], a3[0] );
+      const __m128 bLeft = _mm_setr_ps( b0[0], b1[0], b2[0], b3[0] );
+      const __m128 aRight = _mm_setr_ps( a0[1], a1[1], a2[1], a3[1] );
+      const __m128 bRight = _mm_setr_ps( b0[1], b1[1], b2[1], b3[1] );
+
+      const __m128 left = _mm_add_ps( aLeft, _mm_mul_ps( _mm_sub_ps( bLeft, aLeft ), frac ) );
+      const __m128 right = _mm_add_ps( aRight, _mm_mul_ps( _mm_sub_ps( bRight, aRight ), frac ) );
+
+      _accumulateFrames( out + i * 2, _mm_mul_ps( left, vGainLeft ), _mm_mul_ps( right, vGainRight ) );
+   }
+
+   sfx_mix_stereo_C( out + end * 2, src, srcChannels, count & 3, pos + F32( end ) * step, step, gainLeft, gainRight );
+}
+
+void sfx_mix_to_s16_SSE( S16 *out, const F32 *src, U32 count )
+{
+   const __m128 vMin = _mm_set1_ps( -1.0f );
+   const __m128 vMax = _mm_set1_ps( 1.0f );
+   const __m128 vScale = _mm_set1_ps( 32767.0f );
+
+   const U32 end = count & ~7;
+   for ( U32 i = 0; i < end; i += 8 )
+   {
+      const __m128 lo = _mm_min_ps( _mm_max_ps( _mm_loadu_ps( src + i ), vMin ), vMax );
+      const __m128 hi = _mm_min_ps( _mm_max_ps( _mm_loadu_ps( src + i + 4 ), vMin ), vMax );
+
+      const __m128i packed = _mm_packs_epi32( _mm_cvttps_epi32( _mm_mul_ps( lo, vScale ) ),
+                                              _mm_cvttps_epi32( _mm_mul_ps( hi, vScale ) ) );
+      _mm_storeu_si128( (__m128i*)( out + i ), packed );
+   }
+
+   sfx_mix_to_s16_C( out + end, src + end, count & 7 );
+}
+
+#endif
@@ -0,0 +1,69 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "sfx/software/sfxSoftwareBuffer.h"
+
+
+SFXSoftwareBuffer::SFXSoftwareBuffer( const ThreadSafeRef< SFXStream >& stream,
+                                      SFXDescription* description )
+   : Parent( stream, description )
+{
+   VECTOR_SET_ASSOCIATION( mSamples );
+
+   const U32 bytesPerChannel = getFormat().getBytesPerChannel();
+   AssertFatal( bytesPerChannel == 1 || bytesPerChannel == 2,
+      "SFXSoftwareBuffer::SFXSoftwareBuffer() - Only 8 and 16 bit formats are supported!" );
+
+   mSamples.setSize( mBufferSize / bytesPerChannel );
+   if( !mSamples.empty() )
+      dMemset( mSamples.address(), 0, mSamples.memSize() );
+}
+
+SFXSoftwareBuffer::~SFXSoftwareBuffer()
+{
+}
+
+bool SFXSoftwareBuffer::_copyData( U32 offset, const U8* data, U32 length )
+{
+   const U32 bytesPerChannel = getFormat().getBytesPerChannel();
+   const U32 start = offset / bytesPerChannel;
+   const U32 count = length / bytesPerChannel;
+
+   AssertFatal( start + count <= mSamples.size(),
+      "SFXSoftwareBuffer::_copyData() - Write exceeds buffer!" );
+
+   F32* dest = mSamples.address() + start;
+   if( bytesPerChannel == 1 )
+   {
+      // 8 bit PCM is unsigned.
+      for( U32 i = 0; i < count; ++ i )
+         dest[ i ] = F32( S32( data[ i ] ) - 128 ) / 128.0f;
+   }
+   else
+   {
+      const S16* src = reinterpret_cast< const S16* >( data );
+      for( U32 i = 0; i < count; ++ i )
+         dest[ i ] = F32( src[ i ] ) / 32768.0f;
+   }
+
+   return true;
+}
@@ -0,0 +1,73 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _SFXSOFTWAREBUFFER_H_
+#define _SFXSOFTWAREBUFFER_H_
+
+#ifndef _SFXINTERNAL_H_
+#  include "sfx/sfxInternal.h"
+#endif
+#ifndef _TVECTOR_H_
+#  include "core/util/tVector.h"
+#endif
+
+
+/// Software mixer SFXBuffer implementation.
+///
+/// The stream data is converted to interleaved float samples as it
+/// arrives so that voices can resample it straight into the mix.  For
+/// streaming buffers, the samples form the wrap-around ring that the
+/// voices loop over.
+class SFXSoftwareBuffer : public SFXInternal::SFXWrapAroundBuffer
+{
+      typedef SFXInternal::SFXWrapAroundBuffer Parent;
+
+      friend class SFXSoftwareDevice;
+      friend class SFXSoftwareVoice;
+
+   protected:
+
+      /// The buffered data as interleaved float samples.
+      Vector< F32 > mSamples;
+
+      ///
+      SFXSoftwareBuffer( const ThreadSafeRef< SFXStream >& stream,
+                         SFXDescription* description );
+
+      // SFXWrapAroundBuffer.
+      virtual bool _copyData( U32 offset, const U8* data, U32 length );
+
+   public:
+
+      virtual ~SFXSoftwareBuffer();
+
+      /// Return the number of interleaved channels in the buffered samples.
+      U32 getNumChannels() const { return getFormat().getChannels(); }
+
+      /// Return the number of frames held by the buffer.
+      U32 getNumFrames() const { return mSamples.size() / getNumChannels(); }
+
+      /// Return the buffered interleaved float samples.
+      const F32* getSamples() const { return mSamples.address(); }
+};
+
+#endif // _SFXSOFTWAREBUFFER_H_
@@ -0,0 +1,255 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "sfx/software/sfxSoftwareDevice.h"
+#include "sfx/software/sfxSoftwareMixer.h"
+#include "sfx/sfxInternal.h"
+#include "core/stream/fileStream.h"
+#include "platform/profiler.h"
+
+
+bool SFXSoftwareDevice::smRealtime = true;
+String SFXSoftwareDevice::smWaveFile;
+SFXSoftwareDevice* SFXSoftwareDevice::smActiveDevice = NULL;
+
+
+SFXSoftwareDevice::SFXSoftwareDevice( SFXProvider* provider,
+                                      String name,
+                                      bool useHardware,
+                                      S32 maxBuffers,
+                                      Sink sink )
+
+   :  SFXDevice( name, provider, useHardware, maxBuffers ),
+      mSink( sink ),
+      mWaveStream( NULL ),
+      mWaveDataSize( 0 ),
+      mLastUpdateTime( 0 ),
+      mUpdateRemainder( 0 ),
+      mDistanceModel( SFXDistanceModelLinear ),
+      mDopplerFactor( 1.0f ),
+      mRolloffFactor( 1.0f ),
+      mStatNumMixedVoices( 0 )
+{
+   VECTOR_SET_ASSOCIATION( mMixBuffer );
+   VECTOR_SET_ASSOCIATION( mWaveBuffer );
+
+   mMaxBuffers = maxBuffers > 0 ? maxBuffers : 64;
+
+   smActiveDevice = this;
+}
+
+SFXSoftwareDevice::~SFXSoftwareDevice()
+{
+   if( smActiveDevice == this )
+      smActiveDevice = NULL;
+
+   if( mWaveStream )
+   {
+      _writeWaveHeader();
+      delete mWaveStream;
+   }
+}
+
+bool SFXSoftwareDevice::openWaveFile( const String& fileName )
+{
+   AssertFatal( !mWaveStream, "SFXSoftwareDevice::openWaveFile() - File already open!" );
+
+   if( fileName.isEmpty() )
+      return false;
+
+   mWaveStream = FileStream::createAndOpen( fileName, Torque::FS::File::Write );
+   if( !mWaveStream )
+   {
+      Con::errorf( "SFXSoftwareDevice::openWaveFile() - Could not open '%s'", fileName.c_str() );
+      return false;
+   }
+
+   mWaveDataSize = 0;
+   _writeWaveHeader();
+
+   return true;
+}
+
+void SFXSoftwareDevice::_writeWaveHeader()
+{
+   const U16 bitsPerSample = 16;
+   const U16 blockAlign = OUTPUT_CHANNELS * bitsPerSample / 8;
+
+   mWaveStream->setPosition( 0 );
+
+   mWaveStream->write( 4, "RIFF" );
+   mWaveStream->write( U32( 36 + mWaveDataSize ) );
+   mWaveStream->write( 4, "WAVE" );
+
+   mWaveStream->write( 4, "fmt " );
+   mWaveStream->write( U32( 16 ) );
+   mWaveStream->write( U16( 1 ) ); // PCM
+   mWaveStream->write( U16( OUTPUT_CHANNELS ) );
+   mWaveStream->write( U32( OUTPUT_RATE ) );
+   mWaveStream->write( U32( OUTPUT_RATE * blockAlign ) );
+   mWaveStream->write( blockAlign );
+   mWaveStream->write( bitsPerSample );
+
+   mWaveStream->write( 4, "data" );
+   mWaveStream->write( mWaveDataSize );
+
+   mWaveStream->setPosition( 44 + mWaveDataSize );
+}
+
+SFXBuffer* SFXSoftwareDevice::createBuffer( const ThreadSafeRef< SFXStream >& stream, SFXDescription* description )
+{
+   SFXSoftwareBuffer* buffer = new SFXSoftwareBuffer( stream, description );
+   _addBuffer( buffer );
+
+   return buffer;
+}
+
+SFXVoice* SFXSoftwareDevice::createVoice( bool is3D, SFXBuffer* buffer )
+{
+   // Don't bother going any further if we've
+   // exceeded the maximum voices.
+   if ( mVoices.size() >= mMaxBuffers )
+      return NULL;
+
+   AssertFatal( buffer, "SFXSoftwareDevice::createVoice() - Got null buffer!" );
+
+   SFXSoftwareBuffer* softwareBuffer = dynamic_cast< SFXSoftwareBuffer* >( buffer );
+   AssertFatal( softwareBuffer, "SFXSoftwareDevice::createVoice() - Got bad buffer!" );
+
+   SFXSoftwareVoice* voice = new SFXSoftwareVoice( this, softwareBuffer, is3D );
+
+   _addVoice( voice );
+   return voice;
+}
+
+void SFXSoftwareDevice::setDistanceModel( SFXDistanceModel model )
+{
+   mDistanceModel = model;
+}
+
+void SFXSoftwareDevice::setDopplerFactor( F32 factor )
+{
+   mDopplerFactor = factor;
+}
+
+void SFXSoftwareDevice::setRolloffFactor( F32 factor )
+{
+   mRolloffFactor = factor;
+}
+
+void SFXSoftwareDevice::setListener( U32 index, const SFXListenerProperties& listener )
+{
+   // We only mix for a single listener.
+   if( index == 0 )
+      mListener = listener;
+}
+
+void SFXSoftwareDevice::update()
+{
+   Parent::update();
+
+   if( !smRealtime )
+   {
+      mLastUpdateTime = 0;
+      return;
+   }
+
+   // Mix the time that has passed since the last update.
+
+   const U32 currentTime = Platform::getRealMilliseconds();
+   if( !mLastUpdateTime )
+   {
+      mLastUpdateTime = currentTime;
+      return;
+   }
+
+   const U32 elapsed = getMin( currentTime - mLastUpdateTime, U32( MAX_UPDATE_MIX_MS ) );
+   mLastUpdateTime = currentTime;
+
+   const U32 scaledFrames = elapsed * OUTPUT_RATE + mUpdateRemainder;
+   mUpdateRemainder = scaledFrames % 1000;
+
+   const U32 numFrames = scaledFrames / 1000;
+   if( numFrames )
+      mix( numFrames );
+}
+
+void SFXSoftwareDevice::mix( U32 numFrames )
+{
+   PROFILE_SCOPE( SFXSoftwareDevice_Mix );
+
+   // The memory sink keeps the whole mix.
+
+   if( mSink == SinkMemory )
+   {
+      mMixBuffer.setSize( numFrames * OUTPUT_CHANNELS );
+      mStatNumMixedVoices = _mixChunk( mMixBuffer.address(), numFrames );
+      return;
+   }
+
+   // The wave sink mixes and writes out a chunk at a time.
+
+   mStatNumMixedVoices = 0;
+   while( numFrames > 0 )
+   {
+      const U32 count = getMin( numFrames, U32( MIX_CHUNK_FRAMES ) );
+      const U32 numSamples = count * OUTPUT_CHANNELS;
+
+      mMixBuffer.setSize( numSamples );
+      mStatNumMixedVoices = getMax( mStatNumMixedVoices, _mixChunk( mMixBuffer.address(), count ) );
+
+      if( mWaveStream )
+      {
+         mWaveBuffer.setSize( numSamples );
+         sfx_mix_to_s16( mWaveBuffer.address(), mMixBuffer.address(), numSamples );
+
+         #ifdef TORQUE_BIG_ENDIAN
+         for( U32 i = 0; i < numSamples; ++ i )
+            mWaveBuffer[ i ] = convertHostToLEndian( mWaveBuffer[ i ] );
+         #endif
+
+         const U32 numBytes = numSamples * sizeof( S16 );
+         mWaveStream->write( numBytes, mWaveBuffer.address() );
+         mWaveDataSize += numBytes;
+      }
+
+      numFrames -= count;
+   }
+}
+
+U32 SFXSoftwareDevice::_mixChunk( F32* out, U32 numFrames )
+{
+   dMemset( out, 0, numFrames * OUTPUT_CHANNELS * sizeof( F32 ) );
+
+   U32 numMixed = 0;
+   for( VoiceIterator iter = mVoices.begin(); iter != mVoices.end(); ++ iter )
+   {
+      SFXSoftwareVoice* voice = static_cast< SFXSoftwareVoice* >( *iter );
+      if( !voice->isMixing() )
+         continue;
+
+      voice->_mix( out, numFrames );
+      numMixed ++;
+   }
+
+   return numMixed;
+}
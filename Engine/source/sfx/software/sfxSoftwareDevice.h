@@ -0,0 +1,193 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _SFXSOFTWAREDEVICE_H_
+#define _SFXSOFTWAREDEVICE_H_
+
+class SFXProvider;
+class FileStream;
+
+#ifndef _SFXDEVICE_H_
+   #include "sfx/sfxDevice.h"
+#endif
+#ifndef _SFXPROVIDER_H_
+   #include "sfx/sfxProvider.h"
+#endif
+#ifndef _SFXSOFTWAREBUFFER_H_
+   #include "sfx/software/sfxSoftwareBuffer.h"
+#endif
+#ifndef _SFXSOFTWAREVOICE_H_
+   #include "sfx/software/sfxSoftwareVoice.h"
+#endif
+
+
+/// A device that mixes all voices on the CPU.
+///
+/// Voices are resampled to a fixed stereo float output, attenuated
+/// and panned against the listener, and the mix is handed to a sink.
+/// The memory sink keeps the most recent mix around while the wave
+/// sink appends it to a 16 bit WAV file.
+///
+/// Neither sink needs any audio hardware so the device works both as
+/// a fallback when no other provider initializes and as a headless
+/// harness for measuring the cost of the sound system.
+class SFXSoftwareDevice : public SFXDevice
+{
+   typedef SFXDevice Parent;
+
+   public:
+
+      enum Sink
+      {
+         SinkMemory,    ///< Keep the last mix in memory.
+         SinkWave,      ///< Append the mix to a WAV file.
+      };
+
+      enum
+      {
+         /// Sample rate of the mix.
+         OUTPUT_RATE = 44100,
+
+         /// Number of interleaved channels in the mix.
+         OUTPUT_CHANNELS = 2,
+
+         /// Number of frames mixed in one go for the wave sink.
+         MIX_CHUNK_FRAMES = 1024,
+
+         /// Maximum amount of milliseconds mixed by a single update()
+         /// so that a stall doesn't make us mix a huge backlog.
+         MAX_UPDATE_MIX_MS = 250,
+      };
+
+      /// If false, update() does not mix and mixing only happens
+      /// on explicit mix() calls.
+      static bool smRealtime;
+
+      /// Path of the WAV file written by the wave sink.
+      static String smWaveFile;
+
+   protected:
+
+      ///
+      Sink mSink;
+
+      /// The most recent mix for the memory sink and the chunk
+      /// being mixed for the wave sink.
+      Vector< F32 > mMixBuffer;
+
+      /// Scratch space for converting the mix for the wave sink.
+      Vector< S16 > mWaveBuffer;
+
+      /// Open WAV file for the wave sink.
+      FileStream* mWaveStream;
+
+      /// Number of sample data bytes written to #mWaveStream.
+      U32 mWaveDataSize;
+
+      /// Real time of the last mix in update().
+      U32 mLastUpdateTime;
+
+      /// Frames owed to update() from rounding the elapsed time;
+      /// in units of 1/1000 frames.
+      U32 mUpdateRemainder;
+
+      ///
+      SFXListenerProperties mListener;
+
+      ///
+      SFXDistanceModel mDistanceModel;
+
+      ///
+      F32 mDopplerFactor;
+
+      ///
+      F32 mRolloffFactor;
+
+      /// Number of voices that contributed to the last mix.
+      U32 mStatNumMixedVoices;
+
+      /// Patch the RIFF and data chunk sizes of the WAV file.
+      void _writeWaveHeader();
+
+      /// Mix into @a out which must hold @a numFrames stereo frames.
+      U32 _mixChunk( F32* out, U32 numFrames );
+
+   public:
+
+      SFXSoftwareDevice( SFXProvider* provider,
+                         String name,
+                         bool useHardware,
+                         S32 maxBuffers,
+                         Sink sink );
+
+      virtual ~SFXSoftwareDevice();
+
+      /// Open @a fileName for the wave sink.
+      /// @return True if the file could be created.
+      bool openWaveFile( const String& fileName );
+
+      /// Mix @a numFrames frames of all playing voices and hand
+      /// them to the sink.
+      void mix( U32 numFrames );
+
+      /// Return the most recent mix of the memory sink as
+      /// interleaved stereo samples.
+      const Vector< F32 >& getMixBuffer() const { return mMixBuffer; }
+
+      /// Return the number of voices that contributed to the last mix.
+      U32 getNumMixedVoices() const { return mStatNumMixedVoices; }
+
+      ///
+      Sink getSink() const { return mSink; }
+
+      ///
+      const SFXListenerProperties& getListener() const { return mListener; }
+
+      ///
+      SFXDistanceModel getDistanceModel() const { return mDistanceModel; }
+
+      ///
+      F32 getDopplerFactor() const { return mDopplerFactor; }
+
+      ///
+      F32 getRolloffFactor() const { return mRolloffFactor; }
+
+      /// Return the software device the sound system is using or
+      /// NULL if it is using a different device.
+      static SFXSoftwareDevice* getActiveDevice() { return smActiveDevice; }
+
+      // SFXDevice.
+      virtual SFXBuffer* createBuffer( const ThreadSafeRef< SFXStream >& stream, SFXDescription* description );
+      virtual SFXVoice* createVoice( bool is3D, SFXBuffer* buffer );
+      virtual void setDistanceModel( SFXDistanceModel model );
+      virtual void setDopplerFactor( F32 factor );
+      virtual void setRolloffFactor( F32 factor );
+      virtual void setListener( U32 index, const SFXListenerProperties& listener );
+      virtual void update();
+
+   protected:
+
+      ///
+      static SFXSoftwareDevice* smActiveDevice;
+};
+
+#endif // _SFXSOFTWAREDEVICE_H_
@@ -0,0 +1,111 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "sfx/software/sfxSoftwareMixer.h"
+#include "sfx/software/arch/sfxSoftwareMixer.arch.h"
+
+#include "math/mMathFn.h"
+#include "core/module.h"
+
+
+void (*sfx_mix_mono)( F32 *out, const F32 *src, U32 count, F32 pos, F32 step,
+                      F32 gainLeft, F32 gainRight ) = NULL;
+
+void (*sfx_mix_stereo)( F32 *out, const F32 *src, U32 srcChannels, U32 count, F32 pos, F32 step,
+                        F32 gainLeft, F32 gainRight ) = NULL;
+
+void (*sfx_mix_to_s16)( S16 *out, const F32 *src, U32 count ) = NULL;
+
+//------------------------------------------------------------------------------
+// Default C++ Implementations
+//------------------------------------------------------------------------------
+
+void sfx_mix_mono_C( F32 *out, const F32 *src, U32 count, F32 pos, F32 step,
+                     F32 gainLeft, F32 gainRight )
+{
+   for ( U32 i = 0; i < count; i++ )
+   {
+      // Read positions are never negative so truncation is the floor.
+      const F32 p = pos + F32( i ) * step;
+      const U32 index = U32( p );
+      const F32 frac = p - F32( index );
+
+      const F32 a = src[index];
+      const F32 sample = a + ( src[index + 1] - a ) * frac;
+
+      out[i * 2 + 0] += sample * gainLeft;
+      out[i * 2 + 1] += sample * gainRight;
+   }
+}
+
+void sfx_mix_stereo_C( F32 *out, const F32 *src, U32 srcChannels, U32 count, F32 pos, F32 step,
+                       F32 gainLeft, F32 gainRight )
+{
+   for ( U32 i = 0; i < count; i++ )
+   {
+      const F32 p = pos + F32( i ) * step;
+      const U32 index = U32( p );
+      const F32 frac = p - F32( index );
+
+      const F32 *a = src + index * srcChannels;
+      const F32 *b = a + srcChannels;
+
+      out[i * 2 + 0] += ( a[0] + ( b[0] - a[0] ) * frac ) * gainLeft;
+      out[i * 2 + 1] += ( a[1] + ( b[1] - a[1] ) * frac ) * gainRight;
+   }
+}
+
+void sfx_mix_to_s16_C( S16 *out, const F32 *src, U32 count )
+{
+   for ( U32 i = 0; i < count; i++ )
+   {
+      const F32 sample = mClampF( src[i], -1.0f, 1.0f );
+      out[i] = S16( sample * 32767.0f );
+   }
+}
+
+//------------------------------------------------------------------------------
+
+MODULE_BEGIN( SFXSoftwareMixer )
+
+   MODULE_INIT_BEFORE( SFX )
+
+   MODULE_INIT
+   {
+      // Assign defaults (C++ versions)
+      sfx_mix_mono = sfx_mix_mono_C;
+      sfx_mix_stereo = sfx_mix_stereo_C;
+      sfx_mix_to_s16 = sfx_mix_to_s16_C;
+
+      // Find the best implementation for the current CPU
+      if ( Platform::SystemInfo.processor.properties & CPU_PROP_SSE2 )
+      {
+         #if ( defined( TORQUE_CPU_X86 ) || defined( TORQUE_CPU_X64 ) )
+            sfx_mix_mono = sfx_mix_mono_SSE;
+            sfx_mix_stereo = sfx_mix_stereo_SSE;
+            sfx_mix_to_s16 = sfx_mix_to_s16_SSE;
+         #endif
+      }
+   }
+
+MODULE_END;
@@ -0,0 +1,82 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _SFXSOFTWAREMIXER_H_
+#define _SFXSOFTWAREMIXER_H_
+
+/// Resample a run of frames from a mono source with linear interpolation
+/// and accumulate them into an interleaved stereo mix.
+///
+/// Output frame i reads the source at the fractional frame position
+/// pos + i * step.  The caller guarantees that the frame at and the frame
+/// after every read position lie within the source.
+///
+/// @param out        Interleaved stereo mix to accumulate into.
+/// @param src        Source frames.
+/// @param count      Number of output frames to mix.
+/// @param pos        Read position of the first output frame.
+/// @param step       Source frames advanced per output frame.
+/// @param gainLeft   Gain applied for the left output channel.
+/// @param gainRight  Gain applied for the right output channel.
+extern void (*sfx_mix_mono)( F32 *out,
+                             const F32 *src,
+                             U32 count,
+                             F32 pos,
+                             F32 step,
+                             F32 gainLeft,
+                             F32 gainRight );
+
+/// Resample a run of frames from an interleaved multi-channel source with
+/// linear interpolation and accumulate them into an interleaved stereo mix.
+/// Only the first two source channels are mixed.
+///
+/// @see sfx_mix_mono
+/// @param srcChannels  Number of interleaved channels in the source.
+extern void (*sfx_mix_stereo)( F32 *out,
+                               const F32 *src,
+                               U32 srcChannels,
+                               U32 count,
+                               F32 pos,
+                               F32 step,
+                               F32 gainLeft,
+                               F32 gainRight );
+
+/// Convert and clamp an interleaved float mix to signed 16-bit samples.
+///
+/// @param out    Receives the converted samples.
+/// @param src    The float samples.
+/// @param count  Number of samples (not frames) to convert.
+extern void (*sfx_mix_to_s16)( S16 *out, const F32 *src, U32 count );
+
+/// @name Portable Versions
+/// The SSE mixers hand the frames that don't fill a vector to these.
+/// @{
+
+extern void sfx_mix_mono_C( F32 *out, const F32 *src, U32 count, F32 pos, F32 step,
+                            F32 gainLeft, F32 gainRight );
+extern void sfx_mix_stereo_C( F32 *out, const F32 *src, U32 srcChannels, U32 count, F32 pos, F32 step,
+                              F32 gainLeft, F32 gainRight );
+extern void sfx_mix_to_s16_C( S16 *out, const F32 *src, U32 count );
+
+/// @}
+
+#endif // _SFXSOFTWAREMIXER_H_
@@ -0,0 +1,121 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "sfx/sfxProvider.h"
+#include "sfx/software/sfxSoftwareDevice.h"
+#include "console/console.h"
+#include "console/consoleTypes.h"
+#include "core/module.h"
+
+
+class SFXSoftwareProvider : public SFXProvider
+{
+public:
+
+   SFXSoftwareProvider()
+      : SFXProvider( "Software" ) {}
+   virtual ~SFXSoftwareProvider();
+
+protected:
+   void addDeviceDesc( const String& name, const String& desc );
+   void init();
+
+public:
+
+   SFXDevice* createDevice( const String& deviceName, bool useHardware, S32 maxBuffers );
+
+};
+
+MODULE_BEGIN( SFXSoftware )
+
+   MODULE_INIT_BEFORE( SFX )
+   MODULE_SHUTDOWN_AFTER( SFX )
+
+   SFXSoftwareProvider* mProvider;
+
+   MODULE_INIT
+   {
+      mProvider = new SFXSoftwareProvider;
+   }
+
+   MODULE_SHUTDOWN
+   {
+      delete mProvider;
+   }
+
+MODULE_END;
+
+void SFXSoftwareProvider::init()
+{
+   Con::addVariable( "SFX::Software::realtime", TypeBool, &SFXSoftwareDevice::smRealtime,
+      "If true, the software device mixes the time passed since its last update on every update.  "
+      "Disable to drive mixing manually, e.g. from a benchmark.\n"
+      "@ingroup SFX" );
+   Con::addVariable( "SFX::Software::waveFile", TypeRealString, &SFXSoftwareDevice::smWaveFile,
+      "Path of the WAV file the software \"Wave\" device writes its mix to.  The device fails to "
+      "initialize while this is empty.\n"
+      "@ingroup SFX" );
+
+   regProvider( this );
+   addDeviceDesc( "Memory", "SFX Software Memory Device" );
+   addDeviceDesc( "Wave", "SFX Software Wave Device" );
+}
+
+SFXSoftwareProvider::~SFXSoftwareProvider()
+{
+}
+
+
+void SFXSoftwareProvider::addDeviceDesc( const String& name, const String& desc )
+{
+   SFXDeviceInfo* info = new SFXDeviceInfo;
+   info->name = desc;
+   info->driver = name;
+   info->hasHardware = false;
+   info->maxBuffers = 64;
+
+   mDeviceInfo.push_back( info );
+}
+
+SFXDevice* SFXSoftwareProvider::createDevice( const String& deviceName, bool useHardware, S32 maxBuffers )
+{
+   SFXDeviceInfo* info = _findDeviceInfo( deviceName );
+
+   // Do we find one to create?
+   if ( !info )
+      return NULL;
+
+   if ( info->driver.equal( "Wave" ) )
+   {
+      SFXSoftwareDevice* device = new SFXSoftwareDevice( this, info->name, useHardware, maxBuffers,
+                                                         SFXSoftwareDevice::SinkWave );
+      if ( !device->openWaveFile( SFXSoftwareDevice::smWaveFile ) )
+      {
+         delete device;
+         return NULL;
+      }
+
+      return device;
+   }
+
+   return new SFXSoftwareDevice( this, info->name, useHardware, maxBuffers, SFXSoftwareDevice::SinkMemory );
+}
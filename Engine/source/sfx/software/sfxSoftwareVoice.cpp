@@ -0,0 +1,320 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "sfx/software/sfxSoftwareVoice.h"
+#include "sfx/software/sfxSoftwareDevice.h"
+#include "sfx/software/sfxSoftwareMixer.h"
+#include "sfx/sfxInternal.h"
+
+
+/// Speed of sound in meters per second for the doppler shift.
+static const F32 sSpeedOfSound = 343.3f;
+
+
+SFXSoftwareVoice::SFXSoftwareVoice( SFXSoftwareDevice* device, SFXSoftwareBuffer* buffer, bool is3D )
+   : Parent( buffer ),
+     mDevice( device ),
+     mIs3D( is3D ),
+     mMixStatus( SFXStatusStopped ),
+     mIsLooping( false ),
+     mCursor( 0.0 ),
+     mVolume( 1.0f ),
+     mPitch( 1.0f ),
+     mPosition( 0.0f, 0.0f, 0.0f ),
+     mDirection( 0.0f, 1.0f, 0.0f ),
+     mVelocity( 0.0f, 0.0f, 0.0f ),
+     mMinDistance( 1.0f ),
+     mMaxDistance( 100.0f ),
+     mRolloffFactor( -1.0f ),
+     mConeInnerAngle( 360.0f ),
+     mConeOuterAngle( 360.0f ),
+     mConeOuterVolume( 1.0f )
+{
+   AssertFatal( mDevice, "SFXSoftwareVoice::SFXSoftwareVoice() - SFXSoftwareDevice is null!" );
+   AssertFatal( buffer, "SFXSoftwareVoice::SFXSoftwareVoice() - SFXSoftwareBuffer is null!" );
+}
+
+SFXSoftwareVoice::~SFXSoftwareVoice()
+{
+}
+
+SFXStatus SFXSoftwareVoice::_status() const
+{
+   return mMixStatus;
+}
+
+void SFXSoftwareVoice::_play()
+{
+   mMixStatus = SFXStatusPlaying;
+}
+
+void SFXSoftwareVoice::_pause()
+{
+   mMixStatus = SFXStatusPaused;
+}
+
+void SFXSoftwareVoice::_stop()
+{
+   mMixStatus = SFXStatusStopped;
+   mCursor = 0.0;
+}
+
+void SFXSoftwareVoice::_seek( U32 sample )
+{
+   SFXSoftwareBuffer* buffer = _getBuffer();
+   const U32 numFrames = buffer ? buffer->getNumFrames() : 0;
+
+   mCursor = numFrames ? F64( sample % numFrames ) : 0.0;
+}
+
+U32 SFXSoftwareVoice::_tell() const
+{
+   SFXSoftwareBuffer* buffer = _getBuffer();
+   if( !buffer )
+      return 0;
+
+   // Streaming voices loop over the wrap-around ring, so map
+   // our position in it back to the position in the stream.
+
+   const U32 frame = U32( mCursor );
+   if( buffer->isStreaming() )
+      return buffer->getSamplePos( frame * buffer->getFormat().getBytesPerSample() );
+
+   return frame;
+}
+
+void SFXSoftwareVoice::play( bool looping )
+{
+   // If this is a streaming buffer,
+   // force looping.
+
+   if( mBuffer->isStreaming() )
+      looping = true;
+   mIsLooping = looping;
+
+   Parent::play( looping );
+}
+
+void SFXSoftwareVoice::setMinMaxDistance( F32 min, F32 max )
+{
+   mMinDistance = min;
+   mMaxDistance = max;
+}
+
+void SFXSoftwareVoice::setVelocity( const VectorF& velocity )
+{
+   mVelocity = velocity;
+}
+
+void SFXSoftwareVoice::setTransform( const MatrixF& transform )
+{
+   transform.getColumn( 3, &mPosition );
+   transform.getColumn( 1, &mDirection );
+}
+
+void SFXSoftwareVoice::setVolume( F32 volume )
+{
+   mVolume = volume;
+}
+
+void SFXSoftwareVoice::setPitch( F32 pitch )
+{
+   mPitch = pitch;
+}
+
+void SFXSoftwareVoice::setCone( F32 innerAngle, F32 outerAngle, F32 outerVolume )
+{
+   mConeInnerAngle = innerAngle;
+   mConeOuterAngle = outerAngle;
+   mConeOuterVolume = outerVolume;
+}
+
+void SFXSoftwareVoice::setRolloffFactor( F32 factor )
+{
+   mRolloffFactor = factor;
+}
+
+void SFXSoftwareVoice::_getMixParameters( F32& gainLeft, F32& gainRight, F32& pitch ) const
+{
+   pitch = mPitch;
+
+   if( !mIs3D )
+   {
+      gainLeft = mVolume;
+      gainRight = mVolume;
+      return;
+   }
+
+   const SFXListenerProperties& listener = mDevice->getListener();
+   const MatrixF& listenerTransform = listener.getTransform();
+
+   Point3F listenerPos;
+   Point3F listenerRight;
+   listenerTransform.getColumn( 3, &listenerPos );
+   listenerTransform.getColumn( 0, &listenerRight );
+
+   Point3F toSource = mPosition - listenerPos;
+   const F32 distance = toSource.len();
+
+   // Distance attenuation.
+
+   const F32 rolloff = mRolloffFactor != -1.0f ? mRolloffFactor : mDevice->getRolloffFactor();
+   F32 volume = SFXDistanceAttenuation( mDevice->getDistanceModel(),
+                                        mMinDistance,
+                                        mMaxDistance,
+                                        distance,
+                                        mVolume,
+                                        rolloff );
+
+   F32 pan = 0.0f;
+   if( distance > POINT_EPSILON )
+   {
+      toSource /= distance;
+      pan = mClampF( mDot( toSource, listenerRight ), -1.0f, 1.0f );
+
+      // Cone attenuation from the angle between the cone
+      // direction and the direction to the listener.
+
+      if( mConeOuterAngle < 360.0f )
+      {
+         const F32 angle = 2.0f * mRadToDeg( mAcos( mClampF( -mDot( mDirection, toSource ), -1.0f, 1.0f ) ) );
+         if( angle >= mConeOuterAngle )
+            volume *= mConeOuterVolume;
+         else if( angle > mConeInnerAngle )
+         {
+            const F32 t = ( angle - mConeInnerAngle ) / ( mConeOuterAngle - mConeInnerAngle );
+            volume *= mLerp( 1.0f, mConeOuterVolume, t );
+         }
+      }
+
+      // Doppler shift from the velocities along the line
+      // between the source and the listener.
+
+      const F32 dopplerFactor = mDevice->getDopplerFactor();
+      if( dopplerFactor > 0.0f )
+      {
+         const F32 maxSpeed = sSpeedOfSound / dopplerFactor - 1.0f;
+         const F32 listenerSpeed = getMin( -mDot( listener.getVelocity(), toSource ), maxSpeed );
+         const F32 sourceSpeed = getMin( -mDot( mVelocity, toSource ), maxSpeed );
+
+         pitch *= ( sSpeedOfSound - dopplerFactor * listenerSpeed )
+                / ( sSpeedOfSound - dopplerFactor * sourceSpeed );
+      }
+   }
+
+   // Equal power panning.
+
+   const F32 angle = ( pan + 1.0f ) * M_PI_F * 0.25f;
+   gainLeft = volume * mCos( angle );
+   gainRight = volume * mSin( angle );
+}
+
+void SFXSoftwareVoice::_mix( F32* out, U32 numFrames )
+{
+   // Bound the frames handed to the mixer in one run so that
+   // its single precision read positions stay exact enough.
+   const U32 MAX_RUN_FRAMES = 4096;
+
+   SFXSoftwareBuffer* buffer = _getBuffer();
+   if( !buffer )
+      return;
+
+   const U32 numBufferFrames = buffer->getNumFrames();
+   if( !numBufferFrames )
+      return;
+
+   F32 gainLeft, gainRight, pitch;
+   _getMixParameters( gainLeft, gainRight, pitch );
+
+   const F64 step = F64( buffer->getFormat().getSamplesPerSecond() )
+                  / F64( SFXSoftwareDevice::OUTPUT_RATE )
+                  * mClampF( pitch, 0.01f, 16.0f );
+   const bool wrap = mIsLooping || buffer->isStreaming();
+   const U32 numChannels = buffer->getNumChannels();
+   const F32* samples = buffer->getSamples();
+
+   // Inaudible voices only advance.
+
+   const bool silent = gainLeft <= 0.0f && gainRight <= 0.0f;
+
+   while( numFrames > 0 )
+   {
+      const U32 base = U32( mCursor );
+      const F64 frac = mCursor - F64( base );
+
+      // Frames whose read position and the frame after it lie in the buffer
+      // go through the mixer.  Keep a small margin to the end so rounding
+      // in the mixer never reads past the buffer.
+
+      U32 count = 0;
+      const F64 available = F64( numBufferFrames - 1 - getMin( base, numBufferFrames - 1 ) ) - frac - 0.01;
+      if( available > 0.0 )
+         count = getMin( getMin( numFrames, MAX_RUN_FRAMES ), U32( available / step ) + 1 );
+
+      if( count )
+      {
+         if( !silent )
+         {
+            if( numChannels == 1 )
+               sfx_mix_mono( out, samples + base, count, F32( frac ), F32( step ), gainLeft, gainRight );
+            else
+               sfx_mix_stereo( out, samples + base * numChannels, numChannels, count, F32( frac ), F32( step ), gainLeft, gainRight );
+         }
+      }
+      else
+      {
+         // Interpolate across the end of the buffer, either into the
+         // start of the buffer or into silence.
+
+         count = 1;
+         if( !silent )
+         {
+            const F32* a = samples + base * numChannels;
+            const F32* b = wrap ? samples : NULL;
+            const F32 t = F32( frac );
+
+            const F32 left = a[ 0 ] + ( ( b ? b[ 0 ] : 0.0f ) - a[ 0 ] ) * t;
+            const F32 right = numChannels == 1 ? left : a[ 1 ] + ( ( b ? b[ 1 ] : 0.0f ) - a[ 1 ] ) * t;
+
+            out[ 0 ] += left * gainLeft;
+            out[ 1 ] += right * gainRight;
+         }
+      }
+
+      out += count * SFXSoftwareDevice::OUTPUT_CHANNELS;
+      numFrames -= count;
+      mCursor += F64( count ) * step;
+
+      if( mCursor >= F64( numBufferFrames ) )
+      {
+         if( wrap )
+            mCursor = mFmodD( mCursor, F64( numBufferFrames ) );
+         else
+         {
+            // Played to the end.  SFXVoice::getStatus() picks this up.
+            mMixStatus = SFXStatusStopped;
+            mCursor = 0.0;
+            break;
+         }
+      }
+   }
+}
@@ -0,0 +1,130 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _SFXSOFTWAREVOICE_H_
+#define _SFXSOFTWAREVOICE_H_
+
+#ifndef _SFXVOICE_H_
+   #include "sfx/sfxVoice.h"
+#endif
+#ifndef _SFXSOFTWAREBUFFER_H_
+   #include "sfx/software/sfxSoftwareBuffer.h"
+#endif
+
+
+class SFXSoftwareDevice;
+
+
+/// Software mixer SFXVoice implementation.
+///
+/// The voice keeps a fractional read cursor into its buffer and is
+/// resampled, attenuated and panned into the device mix on each
+/// SFXSoftwareDevice::mix().
+class SFXSoftwareVoice : public SFXVoice
+{
+   public:
+
+      typedef SFXVoice Parent;
+      friend class SFXSoftwareDevice;
+
+   protected:
+
+      SFXSoftwareVoice( SFXSoftwareDevice* device, SFXSoftwareBuffer* buffer, bool is3D );
+
+      ///
+      SFXSoftwareDevice* mDevice;
+
+      ///
+      bool mIs3D;
+
+      /// Playback state as seen by the mixer.
+      SFXStatus mMixStatus;
+
+      ///
+      bool mIsLooping;
+
+      /// Read position in frames into the buffer.  Fractional
+      /// as the buffer is resampled to the device rate.
+      F64 mCursor;
+
+      ///
+      F32 mVolume;
+
+      ///
+      F32 mPitch;
+
+      /// @name 3D Properties
+      /// @{
+
+      Point3F mPosition;
+      Point3F mDirection;
+      Point3F mVelocity;
+
+      F32 mMinDistance;
+      F32 mMaxDistance;
+
+      /// Rolloff factor or -1 to use the device rolloff.
+      F32 mRolloffFactor;
+
+      F32 mConeInnerAngle;
+      F32 mConeOuterAngle;
+      F32 mConeOuterVolume;
+
+      /// @}
+
+      SFXSoftwareBuffer* _getBuffer() const { return ( SFXSoftwareBuffer* ) mBuffer.getPointer(); }
+
+      /// Compute the channel gains and the effective pitch of the
+      /// voice for the current listener.
+      void _getMixParameters( F32& gainLeft, F32& gainRight, F32& pitch ) const;
+
+      /// Resample the voice into the interleaved stereo @a out and
+      /// advance the read cursor by @a numFrames of output.
+      void _mix( F32* out, U32 numFrames );
+
+      // SFXVoice.
+      virtual SFXStatus _status() const;
+      virtual void _play();
+      virtual void _pause();
+      virtual void _stop();
+      virtual void _seek( U32 sample );
+      virtual U32 _tell() const;
+
+   public:
+
+      virtual ~SFXSoftwareVoice();
+
+      /// Return true if the mixer is currently playing the voice.
+      bool isMixing() const { return mMixStatus == SFXStatusPlaying; }
+
+      // SFXVoice.
+      virtual void play( bool looping );
+      virtual void setMinMaxDistance( F32 min, F32 max );
+      virtual void setVelocity( const VectorF& velocity );
+      virtual void setTransform( const MatrixF& transform );
+      virtual void setVolume( F32 volume );
+      virtual void setPitch( F32 pitch );
+      virtual void setCone( F32 innerAngle, F32 outerAngle, F32 outerVolume );
+      virtual void setRolloffFactor( F32 factor );
+};
+
+#endif // _SFXSOFTWAREVOICE_H_
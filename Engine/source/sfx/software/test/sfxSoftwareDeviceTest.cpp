@@ -0,0 +1,290 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2014 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "sfx/software/sfxSoftwareDevice.h"
+#include "sfx/sfxSystem.h"
+#include "sfx/sfxSound.h"
+#include "sfx/sfxDescription.h"
+#include "sfx/sfxStream.h"
+#include "T3D/gameBase/processList.h"
+#include "core/strings/stringUnit.h"
+#include "math/mRandom.h"
+#include "console/console.h"
+
+/// A mono 16 bit sine tone.
+class SFXSineStream : public SFXStream
+{
+protected:
+   SFXFormat mFormat;
+   U32 mNumSamples;
+   U32 mPosition;
+
+public:
+   SFXSineStream( U32 samplesPerSecond, U32 numSamples )
+      : mFormat( 1, 16, samplesPerSecond ),
+        mNumSamples( numSamples ),
+        mPosition( 0 ) {}
+
+   // SFXStream.
+   virtual SFXStream* clone() const { return new SFXSineStream( mFormat.getSamplesPerSecond(), mNumSamples ); }
+   virtual const SFXFormat& getFormat() const { return mFormat; }
+   virtual U32 getSampleCount() const { return mNumSamples; }
+   virtual U32 getDataLength() const { return mNumSamples * mFormat.getBytesPerSample(); }
+   virtual U32 getDuration() const { return mFormat.getDuration( mNumSamples ); }
+   virtual bool isEOS() const { return mPosition >= mNumSamples; }
+   virtual void reset() { mPosition = 0; }
+
+   virtual U32 read( U8 *buffer, U32 length )
+   {
+      const U32 count = getMin( length / 2, mNumSamples - mPosition );
+      S16 *out = (S16*)buffer;
+      for ( U32 i = 0; i < count; i++, mPosition++ )
+         out[i] = S16( mSin( F32( mPosition ) * 0.2f ) * 16000.0f );
+      return count * 2;
+   }
+};
+
+FIXTURE(SFXSoftwareDevice)
+{
+public:
+   String oldDevice;
+   bool oldRealtime;
+   SFXDescription *description;
+   Vector<SFXSound*> sounds;
+
+   void SetUp()
+   {
+      description = NULL;
+      oldRealtime = Con::getBoolVariable( "$SFX::Software::realtime" );
+
+      // Drive the mixing ourselves.
+      Con::setBoolVariable( "$SFX::Software::realtime", false );
+
+      if ( SFX )
+         oldDevice = SFX->getDeviceInfoString();
+   }
+
+   void TearDown()
+   {
+      for ( U32 i = 0; i < sounds.size(); i++ )
+         sounds[i]->deleteObject();
+      sounds.clear();
+      if ( description )
+         description->deleteObject();
+
+      Con::setBoolVariable( "$SFX::Software::realtime", oldRealtime );
+
+      if ( !SFX )
+         return;
+
+      // Put back whatever device the sound system had.
+      SFX->deleteDevice();
+      if ( oldDevice.isNotEmpty() )
+      {
+         const String provider = StringUnit::getUnit( oldDevice, 0, "\t" );
+         const String device = StringUnit::getUnit( oldDevice, 1, "\t" );
+         const bool useHardware = dAtob( StringUnit::getUnit( oldDevice, 2, "\t" ) );
+         const S32 maxBuffers = dAtoi( StringUnit::getUnit( oldDevice, 3, "\t" ) );
+         SFX->createDevice( provider, device, useHardware, maxBuffers, true );
+      }
+   }
+
+   SFXSoftwareDevice* createDevice( S32 maxVoices )
+   {
+      if ( !SFX->createDevice( "Software", "SFX Software Memory Device", false, maxVoices, true ) )
+         return NULL;
+      return SFXSoftwareDevice::getActiveDevice();
+   }
+
+   void createDescription( bool is3D, bool isLooping )
+   {
+      description = new SFXDescription;
+      description->mIs3D = is3D;
+      description->mIsLooping = isLooping;
+      description->mIsStreaming = false;
+      description->mMinDistance = 1.0f;
+      description->mMaxDistance = 100.0f;
+      description->registerObject();
+   }
+
+   /// Create and start a 100ms sound at @a pos.
+   SFXSound* createSound( const Point3F &pos )
+   {
+      ThreadSafeRef< SFXStream > stream = new SFXSineStream( 8000, 800 );
+      SFXSound *sound = SFX->createSourceFromStream( stream, description );
+      if ( !sound )
+         return NULL;
+
+      if ( description->mIs3D )
+      {
+         MatrixF transform( true );
+         transform.setPosition( pos );
+         sound->setTransform( transform );
+      }
+
+      sound->play();
+      sounds.push_back( sound );
+      return sound;
+   }
+
+   /// Run sound system updates far enough apart for each
+   /// to update the sources and assign voices.
+   void pumpUpdates( U32 count )
+   {
+      for ( U32 i = 0; i < count; i++ )
+      {
+         Platform::sleep( TickMs * 2 );
+         SFX->_update();
+      }
+   }
+
+   /// Pump updates until @a numVoices voices are being mixed.
+   bool waitForVoices( SFXSoftwareDevice *device, U32 numVoices )
+   {
+      for ( U32 i = 0; i < 50; i++ )
+      {
+         pumpUpdates( 1 );
+         device->mix( 64 );
+         if ( device->getNumMixedVoices() >= numVoices )
+            return true;
+      }
+      return false;
+   }
+};
+
+TEST_FIX(SFXSoftwareDevice, PansToTheRight)
+{
+   if ( !SFX )
+   {
+      Con::printf( "SFXSoftwareDevice: skipped, no sound system" );
+      return;
+   }
+
+   SFXSoftwareDevice *device = createDevice( 8 );
+   ASSERT_TRUE( device != NULL );
+
+   createDescription( true, true );
+   ASSERT_TRUE( createSound( Point3F( 10.0f, 0.0f, 0.0f ) ) != NULL );
+   ASSERT_TRUE( waitForVoices( device, 1 ) );
+
+   device->mix( SFXSoftwareDevice::OUTPUT_RATE / 10 );
+   const Vector<F32> &mix = device->getMixBuffer();
+
+   F32 left = 0.0f;
+   F32 right = 0.0f;
+   for ( U32 i = 0; i < mix.size(); i += 2 )
+   {
+      left += mFabs( mix[i] );
+      right += mFabs( mix[i + 1] );
+   }
+
+   EXPECT_GT( right, 0.0f );
+   EXPECT_LT( left, right * 0.01f );
+}
+
+TEST_FIX(SFXSoftwareDevice, StopsAtEnd)
+{
+   if ( !SFX )
+   {
+      Con::printf( "SFXSoftwareDevice: skipped, no sound system" );
+      return;
+   }
+
+   SFXSoftwareDevice *device = createDevice( 8 );
+   ASSERT_TRUE( device != NULL );
+
+   createDescription( false, false );
+   ASSERT_TRUE( createSound( Point3F::Zero ) != NULL );
+   ASSERT_TRUE( waitForVoices( device, 1 ) );
+
+   // Mixing past the 100ms of the sound stops the voice.
+   device->mix( SFXSoftwareDevice::OUTPUT_RATE / 5 );
+   device->mix( 64 );
+   EXPECT_EQ( 0, device->getNumMixedVoices() );
+}
+
+TEST_FIX(SFXSoftwareDevice, StressTestVirtualSources)
+{
+   // 5000 looping 3D sources fighting over 128 voices.  Times
+   // the source updates and the mix separately.
+   if ( !SFX )
+   {
+      Con::printf( "SFXSoftwareDevice: skipped, no sound system" );
+      return;
+   }
+
+   const U32 numSources = 5000;
+   const U32 maxVoices = 128;
+   const U32 numPasses = 30;
+   const U32 numMixSeconds = 5;
+
+   SFXSoftwareDevice *device = createDevice( maxVoices );
+   ASSERT_TRUE( device != NULL );
+
+   // Scatter the sources around the listener, some of them
+   // beyond their max distance.
+   createDescription( true, true );
+   MRandomLCG random( 1 );
+   for ( U32 i = 0; i < numSources; i++ )
+   {
+      const Point3F pos( random.randF( -120.0f, 120.0f ), random.randF( -120.0f, 120.0f ), random.randF( -10.0f, 10.0f ) );
+      ASSERT_TRUE( createSound( pos ) != NULL );
+   }
+
+   // Let the buffers load and the voices get handed out.
+   waitForVoices( device, maxVoices );
+
+   // Time the sound system update.  Each pass updates and
+   // sorts all sources and reassigns the voices.
+   U32 updateMs = 0;
+   for ( U32 i = 0; i < numPasses; i++ )
+   {
+      Platform::sleep( TickMs * 2 );
+
+      const U32 start = Platform::getRealMilliseconds();
+      SFX->_update();
+      updateMs += Platform::getRealMilliseconds() - start;
+   }
+
+   const S32 numPlaying = Con::getIntVariable( "$SFX::numPlaying" );
+   const S32 numVoices = Con::getIntVariable( "$SFX::numVoices" );
+   const F32 msPerPass = F32( updateMs ) / F32( numPasses );
+
+   Con::printf( "SFXSoftwareDevice: %d sources, %d playing, %d voices, update %.2f ms per pass, %.3f us per active source",
+      numSources, numPlaying, numVoices, msPerPass, numPlaying ? msPerPass * 1000.0f / F32( numPlaying ) : 0.0f );
+
+   // Time the mixing of the voices.
+   const U32 start = Platform::getRealMilliseconds();
+   for ( U32 i = 0; i < numMixSeconds; i++ )
+      device->mix( SFXSoftwareDevice::OUTPUT_RATE );
+   const F32 msPerSecond = F32( Platform::getRealMilliseconds() - start ) / F32( numMixSeconds );
+
+   const U32 numMixed = device->getNumMixedVoices();
+   Con::printf( "SFXSoftwareDevice: mixing %d voices, %.2f ms per second of audio (%.2f%% of a core), %.2f us per voice per second",
+      numMixed, msPerSecond, msPerSecond / 10.0f, numMixed ? msPerSecond * 1000.0f / F32( numMixed ) : 0.0f );
+
+   EXPECT_GT( numMixed, 0 );
+}
+
+#endif
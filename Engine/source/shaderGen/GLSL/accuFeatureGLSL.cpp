@@ -44,7 +44,7 @@ void AccuTexFeatGLSL::processVert(Vector<ShaderComponent*> &componentList,
    getOutObjToTangentSpace( componentList, meta, fd );
    addOutAccuVec( componentList, meta );
 
-   output = meta;
+   setOutput( meta );
 }
 
 void AccuTexFeatGLSL::processPix(Vector<ShaderComponent*> &componentList,
@@ -52,13 +52,13 @@ void AccuTexFeatGLSL::processPix(Vector<ShaderComponent*> &componentList,
 {
    MultiLine *meta = new MultiLine;
 
-   output = meta;
+   setOutput( meta );
 
    // OUT.col
    Var *color = (Var*) LangElement::find(getOutputTargetVarName(ShaderFeature::RenderTarget1));
    if (!color)
    {
-      output = new GenOp("   //NULL COLOR!");
+      setOutput( new GenOp("   //NULL COLOR!") );
       return;
    }
 
@@ -136,7 +136,7 @@ void AccuTexFeatGLSL::processPix(Vector<ShaderComponent*> &componentList,
       bumpNorm = (Var *)LangElement::find( "bumpNormal" );
       if (!bumpNorm)
       {
-         output = new GenOp("   //NULL bumpNormal!");
+         setOutput( new GenOp("   //NULL bumpNormal!") );
          return;
       }
    }
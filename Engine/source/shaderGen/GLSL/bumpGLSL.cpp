@@ -35,7 +35,7 @@ void BumpFeatGLSL::processVert(  Vector<ShaderComponent*> &componentList,
                                  const MaterialFeatureData &fd )
 {
    MultiLine *meta = new MultiLine;
-	output = meta;
+	setOutput( meta );
 	
 	const bool useTexAnim = fd.features[MFT_TexAnim];
 
@@ -62,7 +62,7 @@ void BumpFeatGLSL::processPix(   Vector<ShaderComponent*> &componentList,
                                  const MaterialFeatureData &fd )
 {
    MultiLine *meta = new MultiLine;
-	output = meta;
+	setOutput( meta );
 
    // Get the texture coord.
    Var *texCoord = getInTexCoord( "texCoord", "vec2", componentList );
@@ -300,7 +300,7 @@ void ParallaxFeatGLSL::processVert( Vector<ShaderComponent*> &componentList,
          outNegViewTS, texMat, outNegViewTS ) );
    }
 	
-   output = meta;
+   setOutput( meta );
 }
 
 void ParallaxFeatGLSL::processPix(  Vector<ShaderComponent*> &componentList, 
@@ -352,7 +352,7 @@ void ParallaxFeatGLSL::processPix(  Vector<ShaderComponent*> &componentList,
    
    // TODO: Fix second UV maybe?
 	
-   output = meta;
+   setOutput( meta );
 }
 
 ShaderFeature::Resources ParallaxFeatGLSL::getResources( const MaterialFeatureData &fd )
@@ -400,7 +400,7 @@ void NormalsOutFeatGLSL::processVert(  Vector<ShaderComponent*> &componentList,
       return;
 	
    MultiLine *meta = new MultiLine;
-   output = meta;
+   setOutput( meta );
 	
    ShaderConnector *connectComp = dynamic_cast<ShaderConnector *>( componentList[C_CONNECTOR] );
 	
@@ -429,7 +429,7 @@ void NormalsOutFeatGLSL::processPix(   Vector<ShaderComponent*> &componentList,
 												const MaterialFeatureData &fd )
 {
    MultiLine *meta = new MultiLine;
-   output = meta;
+   setOutput( meta );
 	
    Var *wsNormal = (Var*)LangElement::find( "wsNormal" );
    if ( !wsNormal )
@@ -44,7 +44,7 @@ void CustomFeatureGLSL::processVert(Vector<ShaderComponent*>& componentList,
    if (mOwner->isMethod("processVertGLSL"))
       Con::executef(mOwner, "processVertGLSL");
 
-   output = meta;
+   setOutput( meta );
 }
 
 void CustomFeatureGLSL::processPix(Vector<ShaderComponent*>& componentList,
@@ -60,7 +60,7 @@ void CustomFeatureGLSL::processPix(Vector<ShaderComponent*>& componentList,
    if (mOwner->isMethod("processPixelGLSL"))
       Con::executef(mOwner, "processPixelGLSL");
 
-   output = meta;
+   setOutput( meta );
 }
 
 void CustomFeatureGLSL::setTexData(Material::StageData& stageDat,
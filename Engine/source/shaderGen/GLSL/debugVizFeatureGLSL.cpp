@@ -102,5 +102,5 @@ void DebugVizGLSL::processPix(Vector<ShaderComponent*>& componentList,
       }
    }
 
-   output = meta;
+   setOutput( meta );
 }
@@ -123,7 +123,7 @@ void ParaboloidVertTransformGLSL::processVert(  Vector<ShaderComponent*> &compon
       meta->addStatement( new GenOp( "   @.xy += @;\r\n", outPosition, atlasOffset ) );
    }
 
-   output = meta;
+   setOutput( meta );
 }
 
 void ParaboloidVertTransformGLSL::processPix(   Vector<ShaderComponent*> &componentList, 
@@ -151,7 +151,7 @@ void ParaboloidVertTransformGLSL::processPix(   Vector<ShaderComponent*> &compon
    posXY->setType( "float2" );
    meta->addStatement( new GenOp( "   clip( 1.0 - abs(@.x) );\r\n", posXY ) );
 
-   output = meta;
+   setOutput( meta );
 }
 
 ShaderFeature::Resources ParaboloidVertTransformGLSL::getResources( const MaterialFeatureData &fd )
@@ -432,9 +432,10 @@ void VertPixelConnectorGLSL::printStructDefines( Stream &stream, bool in )
 void VertexParamsDefGLSL::print( Stream &stream, bool isVerterShader )
 {
    // find all the uniform variables and print them out
-   for( U32 i=0; i<LangElement::elementList.size(); i++)
+   const Vector<LangElement*> &elementList = LangElement::getElements();
+   for( U32 i=0; i<elementList.size(); i++)
    {
-      Var *var = dynamic_cast<Var*>(LangElement::elementList[i]);
+      Var *var = dynamic_cast<Var*>(elementList[i]);
       if( var )
       {
          if( var->uniform )
@@ -457,9 +458,10 @@ void VertexParamsDefGLSL::print( Stream &stream, bool isVerterShader )
 void PixelParamsDefGLSL::print( Stream &stream, bool isVerterShader )
 {
    // find all the uniform variables and print them out
-   for( U32 i=0; i<LangElement::elementList.size(); i++)
+   const Vector<LangElement*> &elementList = LangElement::getElements();
+   for( U32 i=0; i<elementList.size(); i++)
    {
-      Var *var = dynamic_cast<Var*>(LangElement::elementList[i]);
+      Var *var = dynamic_cast<Var*>(elementList[i]);
       if( var )
       {
          if( var->uniform )
@@ -478,9 +480,9 @@ void PixelParamsDefGLSL::print( Stream &stream, bool isVerterShader )
    const char *closer = "\r\nvoid main()\r\n{\r\n";
    stream.write( dStrlen(closer), closer );
 
-   for( U32 i=0; i<LangElement::elementList.size(); i++)
+   for( U32 i=0; i<elementList.size(); i++)
    {
-      Var *var = dynamic_cast<Var*>(LangElement::elementList[i]);
+      Var *var = dynamic_cast<Var*>(elementList[i]);
       if( var )
       {
          if( var->uniform && !var->sampler)
@@ -186,18 +186,18 @@ LangElement *ShaderFeatureGLSL::expandNormalMap(   LangElement *sampleNormalOp,
 
 ShaderFeatureGLSL::ShaderFeatureGLSL()
 {
-   output = NULL;
 }
 
 Var * ShaderFeatureGLSL::getVertTexCoord( const String &name )
 {
    Var *inTex = NULL;
 
-   for( U32 i=0; i<LangElement::elementList.size(); i++ )
+   const Vector<LangElement*> &elementList = LangElement::getElements();
+   for( U32 i=0; i<elementList.size(); i++ )
    {
-      if( !String::compare( (char*)LangElement::elementList[i]->name, name.c_str() ) )
+      if( !String::compare( (char*)elementList[i]->name, name.c_str() ) )
       {
-         inTex = dynamic_cast<Var*>( LangElement::elementList[i] );
+         inTex = dynamic_cast<Var*>( elementList[i] );
 			if ( inTex )
 			{
             // NOTE: This used to do this check...
@@ -556,10 +556,10 @@ Var* ShaderFeatureGLSL::getObjTrans(   Vector<ShaderComponent*> &componentList,
       instObjTrans->setStructName( "IN" );
       instObjTrans->setName( "inst_objectTrans" );
 
-      mInstancingFormat->addElement( "objTrans", GFXDeclType_Float4, instObjTrans->constNum+0 );
-      mInstancingFormat->addElement( "objTrans", GFXDeclType_Float4, instObjTrans->constNum+1 );
-      mInstancingFormat->addElement( "objTrans", GFXDeclType_Float4, instObjTrans->constNum+2 );
-      mInstancingFormat->addElement( "objTrans", GFXDeclType_Float4, instObjTrans->constNum+3 );
+      getInstancingFormat()->addElement( "objTrans", GFXDeclType_Float4, instObjTrans->constNum+0 );
+      getInstancingFormat()->addElement( "objTrans", GFXDeclType_Float4, instObjTrans->constNum+1 );
+      getInstancingFormat()->addElement( "objTrans", GFXDeclType_Float4, instObjTrans->constNum+2 );
+      getInstancingFormat()->addElement( "objTrans", GFXDeclType_Float4, instObjTrans->constNum+3 );
 
       objTrans = new Var;
       objTrans->setType( "mat4x4" );
@@ -929,7 +929,7 @@ void DiffuseMapFeatGLSL::processVert( Vector<ShaderComponent*> &componentList,
                      fd.features[MFT_TexAnim], 
                      meta, 
                      componentList );
-   output = meta;
+   setOutput( meta );
 }
 
 U32 DiffuseMapFeatGLSL::getOutputTargets(const MaterialFeatureData &fd) const
@@ -963,7 +963,7 @@ void DiffuseMapFeatGLSL::processPix(   Vector<ShaderComponent*> &componentList,
    LangElement *colorDecl = new DecOp( diffColor );
 
    MultiLine * meta = new MultiLine;
-   output = meta;
+   setOutput( meta );
    if (  fd.features[MFT_CubeMap] )
    {
       meta->addStatement(  new GenOp( "   @ = tex2D(@, @);\r\n", 
@@ -1109,12 +1109,12 @@ void OverlayTexFeatGLSL::processVert(  Vector<ShaderComponent*> &componentList,
          texMat->constSortPos = cspPass;   
       }
      
-      output = new GenOp( "   @ = tMul(@, @);\r\n", outTex, texMat, inTex );
+      setOutput( new GenOp( "   @ = tMul(@, @);\r\n", outTex, texMat, inTex ) );
       return;
    }
    
    // setup language elements to output incoming tex coords to output
-   output = new GenOp( "   @ = @;\r\n", outTex, inTex );
+   setOutput( new GenOp( "   @ = @;\r\n", outTex, inTex ) );
 }
 
 void OverlayTexFeatGLSL::processPix(   Vector<ShaderComponent*> &componentList, 
@@ -1137,7 +1137,7 @@ void OverlayTexFeatGLSL::processPix(   Vector<ShaderComponent*> &componentList,
    diffuseMap->constNum = Var::getTexUnitNum();     // used as texture unit num here
 
    LangElement *statement = new GenOp( "tex2D(@, @)", diffuseMap, inTex );
-   output = new GenOp( "   @;\r\n", assignColor( statement, Material::LerpAlpha ) );
+   setOutput( new GenOp( "   @;\r\n", assignColor( statement, Material::LerpAlpha ) ) );
 }
 
 ShaderFeature::Resources OverlayTexFeatGLSL::getResources( const MaterialFeatureData &fd )
@@ -1208,7 +1208,7 @@ void DiffuseFeatureGLSL::processPix(   Vector<ShaderComponent*> &componentList,
       op = Material::None;
 
    meta->addStatement(new GenOp("   @;\r\n", assignColor(diffuseMaterialColor, op, NULL, targ)));
-   output = meta;
+   setOutput( meta );
 }
 
 
@@ -1229,7 +1229,7 @@ void DiffuseVertColorFeatureGLSL::processVert(  Vector< ShaderComponent* >& comp
       Var* inColor = dynamic_cast< Var* >( LangElement::find( "diffuse" ) );
       if( !inColor )
       {
-         output = NULL;
+         setOutput( NULL );
          return;
       }
       
@@ -1242,10 +1242,10 @@ void DiffuseVertColorFeatureGLSL::processVert(  Vector< ShaderComponent* >& comp
       outColor->setStructName( "OUT" );
       outColor->setType( "vec4" );
 
-      output = new GenOp( "   @ = @;\r\n", outColor, inColor );
+      setOutput( new GenOp( "   @ = @;\r\n", outColor, inColor ) );
    }
    else
-      output = NULL; // Nothing we need to do.
+      setOutput( NULL ); // Nothing we need to do.
 }
 
 void DiffuseVertColorFeatureGLSL::processPix(   Vector<ShaderComponent*> &componentList, 
@@ -1267,7 +1267,7 @@ void DiffuseVertColorFeatureGLSL::processPix(   Vector<ShaderComponent*> &compon
       meta->addStatement(new GenOp("   @;\r\n", assignColor(vertColor, Material::Mul, NULL, ShaderFeature::RenderTarget1)));
    else
       meta->addStatement(new GenOp("   @;\r\n", assignColor(vertColor, Material::Mul)));
-   output = meta;
+   setOutput( meta );
 }
 
 
@@ -1289,7 +1289,7 @@ void LightmapFeatGLSL::processVert( Vector<ShaderComponent*> &componentList,
    outTex->setType( "vec2" );
 
    // setup language elements to output incoming tex coords to output
-   output = new GenOp( "   @ = @;\r\n", outTex, inTex );
+   setOutput( new GenOp( "   @ = @;\r\n", outTex, inTex ) );
 }
 
 void LightmapFeatGLSL::processPix(  Vector<ShaderComponent*> &componentList, 
@@ -1319,7 +1319,7 @@ void LightmapFeatGLSL::processPix(  Vector<ShaderComponent*> &componentList,
       lmColor->setType( "vec4" );
       LangElement *lmColorDecl = new DecOp( lmColor );
       
-      output = new GenOp( "   @ = tex2D(@, @);\r\n", lmColorDecl, lightMap, inTex );
+      setOutput( new GenOp( "   @ = tex2D(@, @);\r\n", lmColorDecl, lightMap, inTex ) );
       return;
    }
    
@@ -1360,7 +1360,7 @@ void LightmapFeatGLSL::processPix(  Vector<ShaderComponent*> &componentList,
    else
       meta->addStatement( new GenOp( "   @;\r\n", assignColor( statement, Material::Mul ) ) );
 
-   output = meta;
+   setOutput( meta );
 }
 
 ShaderFeature::Resources LightmapFeatGLSL::getResources( const MaterialFeatureData &fd )
@@ -1410,7 +1410,7 @@ void TonemapFeatGLSL::processVert( Vector<ShaderComponent*> &componentList,
       outTex2->setStructName( "OUT" );
       outTex2->setType( "vec2" );
 
-      output = new GenOp( "   @ = @;\r\n", outTex2, inTex2 );
+      setOutput( new GenOp( "   @ = @;\r\n", outTex2, inTex2 ) );
    }
 }
 
@@ -1485,7 +1485,7 @@ void TonemapFeatGLSL::processPix(  Vector<ShaderComponent*> &componentList,
    else
       meta->addStatement( new GenOp( "   @;\r\n", assignColor( toneMapColor, blendOp ) ) );
    
-   output = meta;
+   setOutput( meta );
 }
 
 ShaderFeature::Resources TonemapFeatGLSL::getResources( const MaterialFeatureData &fd )
@@ -1527,7 +1527,7 @@ void VertLitGLSL::processVert(   Vector<ShaderComponent*> &componentList,
    // handled by the MFT_LightMap or MFT_ToneNamp feature instead
    if ( fd.features[MFT_LightMap] || fd.features[MFT_ToneMap] )
    {
-      output = NULL;
+      setOutput( NULL );
       return;
    }
 
@@ -1549,14 +1549,14 @@ void VertLitGLSL::processVert(   Vector<ShaderComponent*> &componentList,
       // If there isn't a vertex color then we can't do anything
       if( !inColor )
       {
-         output = NULL;
+         setOutput( NULL );
          return;
       }
 
-      output = new GenOp( "   @ = @;\r\n", outColor, inColor );
+      setOutput( new GenOp( "   @ = @;\r\n", outColor, inColor ) );
    }
    else
-      output = NULL; // Nothing we need to do.
+      setOutput( NULL ); // Nothing we need to do.
 }
 
 void VertLitGLSL::processPix(   Vector<ShaderComponent*> &componentList, 
@@ -1566,7 +1566,7 @@ void VertLitGLSL::processPix(   Vector<ShaderComponent*> &componentList,
    // handled by the MFT_LightMap or MFT_ToneNamp feature instead
    if ( fd.features[MFT_LightMap] || fd.features[MFT_ToneMap] )
    {
-      output = NULL;
+      setOutput( NULL );
       return;
    }
    
@@ -1634,7 +1634,7 @@ void VertLitGLSL::processPix(   Vector<ShaderComponent*> &componentList,
    else
       meta->addStatement( new GenOp( "   @;\r\n", assignColor( outColor, blendOp ) ) );
    
-   output = meta;
+   setOutput( meta );
 }
 
 U32 VertLitGLSL::getOutputTargets( const MaterialFeatureData &fd ) const
@@ -1654,7 +1654,7 @@ void DetailFeatGLSL::processVert(   Vector<ShaderComponent*> &componentList,
 	addOutDetailTexCoord( componentList, 
 								meta,
 								fd.features[MFT_TexAnim], fd.features[MFT_Foliage]);
-	output = meta;
+	setOutput( meta );
 }
 
 void DetailFeatGLSL::processPix( Vector<ShaderComponent*> &componentList, 
@@ -1680,9 +1680,9 @@ void DetailFeatGLSL::processPix( Vector<ShaderComponent*> &componentList,
 
    LangElement *statement = new GenOp( "( tex2D(@, @) * 2.0 ) - 1.0", detailMap, inTex );
    if (  fd.features[MFT_isDeferred])
-      output = new GenOp( "   @;\r\n", assignColor( statement, Material::Add, NULL, ShaderFeature::RenderTarget1 ) );
+      setOutput( new GenOp( "   @;\r\n", assignColor( statement, Material::Add, NULL, ShaderFeature::RenderTarget1 ) ) );
    else
-      output = new GenOp( "   @;\r\n", assignColor( statement, Material::Add ) );
+      setOutput( new GenOp( "   @;\r\n", assignColor( statement, Material::Add ) ) );
 }
 
 ShaderFeature::Resources DetailFeatGLSL::getResources( const MaterialFeatureData &fd )
@@ -1747,7 +1747,7 @@ void VertPositionGLSL::processVert( Vector<ShaderComponent*> &componentList,
    {
 	   meta->addStatement(new GenOp("   @ = @.xyww;\r\n", outPosition, outPosition));
    }
-	output = meta;
+	setOutput( meta );
 }
 
 
@@ -1841,7 +1841,7 @@ void ReflectCubeFeatGLSL::processVert( Vector<ShaderComponent*> &componentList,
 
    meta->addStatement( new GenOp( "   @ = reflect(@, @);\r\n", reflectVec, eyeToVert, cubeNormal ) );
 
-   output = meta;
+   setOutput( meta );
 }
 
 void ReflectCubeFeatGLSL::processPix(  Vector<ShaderComponent*> &componentList, 
@@ -1985,7 +1985,7 @@ void ReflectCubeFeatGLSL::processPix(  Vector<ShaderComponent*> &componentList,
       else
          meta->addStatement(new GenOp("   @.rgb *= @.rgb;\r\n", targ, texCube));
    }
-   output = meta;
+   setOutput( meta );
 }
 
 ShaderFeature::Resources ReflectCubeFeatGLSL::getResources( const MaterialFeatureData &fd )
@@ -2100,7 +2100,7 @@ void RTLightingFeatGLSL::processVert(  Vector<ShaderComponent*> &componentList,
 		
       addOutWsPosition( componentList, fd.features[MFT_UseInstancing], meta );
 		
-      output = meta;
+      setOutput( meta );
 		
       return;
    }
@@ -2137,7 +2137,7 @@ void RTLightingFeatGLSL::processVert(  Vector<ShaderComponent*> &componentList,
 
    getOutWorldToTangent(componentList, meta, fd);
 	
-   output = meta;
+   setOutput( meta );
 }
 
 void RTLightingFeatGLSL::processPix(   Vector<ShaderComponent*> &componentList, 
@@ -2238,7 +2238,7 @@ void RTLightingFeatGLSL::processPix(   Vector<ShaderComponent*> &componentList,
 
    meta->addStatement(new GenOp("   @.rgb += @.rgb;\r\n", curColor, lighting));
 
-   output = meta;  
+   setOutput( meta );  
 }
 
 ShaderFeature::Resources RTLightingFeatGLSL::getResources( const MaterialFeatureData &fd )
@@ -2319,7 +2319,7 @@ void FogFeatGLSL::processVert(   Vector<ShaderComponent*> &componentList,
       addOutWsPosition( componentList, fd.features[MFT_UseInstancing], meta );
    }
 	
-   output = meta;
+   setOutput( meta );
 }
 
 void FogFeatGLSL::processPix( Vector<ShaderComponent*> &componentList, 
@@ -2382,7 +2382,7 @@ void FogFeatGLSL::processPix( Vector<ShaderComponent*> &componentList,
    LangElement *fogLerp = new GenOp( "lerp( @.rgb, @.rgb, @ )", fogColor, color, fogAmount );
    meta->addStatement( new GenOp( "   @.rgb = @;\r\n", color, fogLerp ) );
 	
-   output = meta;
+   setOutput( meta );
 }
 
 ShaderFeature::Resources FogFeatGLSL::getResources( const MaterialFeatureData &fd )
@@ -2407,7 +2407,7 @@ void VisibilityFeatGLSL::processVert( Vector<ShaderComponent*> &componentList,
                                       const MaterialFeatureData &fd )
 {  
    MultiLine *meta = new MultiLine;
-   output = meta;
+   setOutput( meta );
 
    if ( fd.features[ MFT_UseInstancing ] )
    {      
@@ -2428,7 +2428,7 @@ void VisibilityFeatGLSL::processVert( Vector<ShaderComponent*> &componentList,
       instVisibility->setStructName( "IN" );
       instVisibility->setName( "inst_visibility" );
       instVisibility->setType( "float" );
-      mInstancingFormat->addElement( "visibility", GFXDeclType_Float, instVisibility->constNum );
+      getInstancingFormat()->addElement( "visibility", GFXDeclType_Float, instVisibility->constNum );
       
       meta->addStatement( new GenOp( "   @ = @; // Instancing!\r\n", outVisibility, instVisibility ) );
    }
@@ -2461,7 +2461,7 @@ void VisibilityFeatGLSL::processPix(   Vector<ShaderComponent*> &componentList,
    }
 
 	MultiLine* meta = new MultiLine;      
-	output = meta;
+	setOutput( meta );
 	
    // Translucent objects do a simple alpha fade.
    if ( fd.features[ MFT_IsTranslucent ] )
@@ -2502,7 +2502,7 @@ void AlphaTestGLSL::processPix(  Vector<ShaderComponent*> &componentList,
         !fd.features[ MFT_DepthOut ] ) ||
          fd.features[MFT_IsTranslucent])
    {
-      output = NULL;
+      setOutput( NULL );
       return;
    }
 
@@ -2512,7 +2512,7 @@ void AlphaTestGLSL::processPix(  Vector<ShaderComponent*> &componentList,
 	   color = (Var*)LangElement::find(getOutputTargetVarName(ShaderFeature::DefaultTarget));
    if ( !color )
    {
-      output = NULL;
+      setOutput( NULL );
       return;
    }
 
@@ -2524,7 +2524,7 @@ void AlphaTestGLSL::processPix(  Vector<ShaderComponent*> &componentList,
    alphaTestVal->constSortPos = cspPotentialPrimitive;
 
    // Do the clip.
-   output = new GenOp( "   clip( @.a - @ );\r\n", color, alphaTestVal );
+   setOutput( new GenOp( "   clip( @.a - @ );\r\n", color, alphaTestVal ) );
 }
 
 
@@ -2535,7 +2535,7 @@ void AlphaTestGLSL::processPix(  Vector<ShaderComponent*> &componentList,
 void GlowMaskGLSL::processPix(   Vector<ShaderComponent*> &componentList,
                                  const MaterialFeatureData &fd )
 {
-   output = NULL;
+   setOutput( NULL );
 
    // Get the output color... and make it black to mask out 
    // glow passes rendered before us.
@@ -2544,7 +2544,7 @@ void GlowMaskGLSL::processPix(   Vector<ShaderComponent*> &componentList,
    // code above that doesn't contribute to the alpha mask.
    Var *color = (Var*)LangElement::find(getOutputTargetVarName(ShaderFeature::DefaultTarget));
    if ( color )
-      output = new GenOp( "   @.rgb = vec3(0);\r\n", color );
+      setOutput( new GenOp( "   @.rgb = vec3(0);\r\n", color ) );
 }
 
 
@@ -2556,7 +2556,7 @@ void RenderTargetZeroGLSL::processPix( Vector<ShaderComponent*> &componentList,
 {
    // Do not actually assign zero, but instead a number so close to zero it may as well be zero.
    // This will prevent a divide by zero causing an FP special on float render targets
-   output = new GenOp( "   @;\r\n", assignColor( new GenOp( "vec4(0.00001)" ), Material::None, NULL, mOutputTargetMask ) );
+   setOutput( new GenOp( "   @;\r\n", assignColor( new GenOp( "vec4(0.00001)" ), Material::None, NULL, mOutputTargetMask ) ) );
 }
 
 
@@ -2576,7 +2576,7 @@ void HDROutGLSL::processPix(  Vector<ShaderComponent*> &componentList,
    // Let the helper function do the work.
    Var *color = (Var*)LangElement::find(getOutputTargetVarName(ShaderFeature::DefaultTarget));
    if ( color )
-      output = new GenOp( "   @ = hdrEncode( @ );\r\n", color, color );
+      setOutput( new GenOp( "   @ = hdrEncode( @ );\r\n", color, color ) );
 }
 
 //****************************************************************************
@@ -2640,7 +2640,7 @@ void FoliageFeatureGLSL::processVert( Vector<ShaderComponent*> &componentList,
 	// Assign to foliageFade. InColor.a was set to the correct value inside foliageProcessVert.
    meta->addStatement( new GenOp( "   @ = @.a;\r\n", fade, inColor ) );
 	
-   output = meta;
+   setOutput( meta );
 }
 
 void FoliageFeatureGLSL::processPix( Vector<ShaderComponent*> &componentList, 
@@ -2669,7 +2669,7 @@ void FoliageFeatureGLSL::processPix( Vector<ShaderComponent*> &componentList,
    // Multiply foliageFade into visibility.
    meta->addStatement( new GenOp( "   @ *= @;\r\n", visibility, fade ) );
 
-   output = meta;
+   setOutput( meta );
 }
 
 void FoliageFeatureGLSL::determineFeature( Material *material, const GFXVertexFormat *vertexFormat, U32 stageNum, const FeatureType &type, const FeatureSet &features, MaterialFeatureData *outFeatureData )
@@ -2698,7 +2698,7 @@ ShaderFeatureConstHandles* FoliageFeatureGLSL::createConstHandles( GFXShader *sh
 void ParticleNormalFeatureGLSL::processVert(Vector<ShaderComponent*> &componentList, const MaterialFeatureData &fd)
 {
    MultiLine *meta = new MultiLine;
-   output = meta;
+   setOutput( meta );
 	
    // Calculate normal and tangent values since we want to keep particle verts
    // as light-weight as possible
@@ -2741,7 +2741,7 @@ void ImposterVertFeatureGLSL::processVert(   Vector<ShaderComponent*> &component
 														const MaterialFeatureData &fd )
 {      
    MultiLine *meta = new MultiLine;
-   output = meta;
+   setOutput( meta );
 	
    // Get the input vertex variables.   
    Var *inPosition = (Var*)LangElement::find( "position" );
@@ -2862,7 +2862,7 @@ void ImposterVertFeatureGLSL::processPix( Vector<ShaderComponent*> &componentLis
 	 // Multiply foliageFade into visibility.
    meta->addStatement( new GenOp( "   @ *= @;\r\n", visibility, fade ) );
 	 
-	 output = meta;
+	 setOutput( meta );
 }
 
 void ImposterVertFeatureGLSL::determineFeature( Material *material, 
@@ -2908,7 +2908,7 @@ void HardwareSkinningFeatureGLSL::processVert(Vector<ShaderComponent*> &componen
       nodeTransforms->constSortPos = cspPrimitive;
    }
 
-   U32 numIndices = mVertexFormat->getNumBlendIndices();
+   U32 numIndices = getVertexFormat()->getNumBlendIndices();
    meta->addStatement(new GenOp("   @ = vec3(0.0);\r\n", new DecOp(posePos)));
    meta->addStatement(new GenOp("   @ = vec3(0.0);\r\n", new DecOp(poseNormal)));
    meta->addStatement(new GenOp("   @;\r\n", new DecOp(poseMat)));
@@ -2937,7 +2937,7 @@ void HardwareSkinningFeatureGLSL::processVert(Vector<ShaderComponent*> &componen
    meta->addStatement(new GenOp("   @ = @;\r\n", inPosition, posePos));
    meta->addStatement(new GenOp("   @ = normalize(@);\r\n", inNormal, poseNormal));
 
-   output = meta;
+   setOutput( meta );
 }
 
 //****************************************************************************
@@ -3057,7 +3057,7 @@ void ReflectionProbeFeatGLSL::processPix(Vector<ShaderComponent*>& componentList
       skylightCubemapIdx, BRDFTexture,
       irradianceCubemapAR, specularCubemapAR));
 
-   output = meta;
+   setOutput( meta );
 }
 
 ShaderFeature::Resources ReflectionProbeFeatGLSL::getResources(const MaterialFeatureData& fd)
@@ -44,7 +44,7 @@ void AccuTexFeatHLSL::processVert(  Vector<ShaderComponent*> &componentList,
    getOutObjToTangentSpace( componentList, meta, fd );
    addOutAccuVec( componentList, meta );
 
-   output = meta;
+   setOutput( meta );
 }
 
 void AccuTexFeatHLSL::processPix(   Vector<ShaderComponent*> &componentList, 
@@ -52,13 +52,13 @@ void AccuTexFeatHLSL::processPix(   Vector<ShaderComponent*> &componentList,
 {
    MultiLine *meta = new MultiLine;
 
-   output = meta;
+   setOutput( meta );
 
    // OUT.col
    Var *color = (Var*) LangElement::find(getOutputTargetVarName(ShaderFeature::RenderTarget1));
    if (!color)
    {
-      output = new GenOp("   //NULL COLOR!");
+      setOutput( new GenOp("   //NULL COLOR!") );
       return;
    }
 
@@ -35,7 +35,7 @@ void BumpFeatHLSL::processVert(  Vector<ShaderComponent*> &componentList,
                                  const MaterialFeatureData &fd )
 {
    MultiLine *meta = new MultiLine;
-   output = meta;
+   setOutput( meta );
 
    const bool useTexAnim = fd.features[MFT_TexAnim];
 
@@ -62,7 +62,7 @@ void BumpFeatHLSL::processPix(   Vector<ShaderComponent*> &componentList,
                                  const MaterialFeatureData &fd )
 {
    MultiLine *meta = new MultiLine;
-   output = meta;
+   setOutput( meta );
 
    // Get the texture coord.
    Var *texCoord = getInTexCoord("texCoord", "float2", componentList);
@@ -304,7 +304,7 @@ void ParallaxFeatHLSL::processVert( Vector<ShaderComponent*> &componentList,
          outNegViewTS, texMat, outNegViewTS ) );
    }
 
-   output = meta;
+   setOutput( meta );
 }
 
 void ParallaxFeatHLSL::processPix(  Vector<ShaderComponent*> &componentList, 
@@ -357,7 +357,7 @@ void ParallaxFeatHLSL::processPix(  Vector<ShaderComponent*> &componentList,
 
    // TODO: Fix second UV maybe?
 
-   output = meta;
+   setOutput( meta );
 }
 
 ShaderFeature::Resources ParallaxFeatHLSL::getResources( const MaterialFeatureData &fd )
@@ -405,7 +405,7 @@ void NormalsOutFeatHLSL::processVert(  Vector<ShaderComponent*> &componentList,
       return;
 
    MultiLine *meta = new MultiLine;
-   output = meta;
+   setOutput( meta );
 
    ShaderConnector *connectComp = dynamic_cast<ShaderConnector *>( componentList[C_CONNECTOR] );
 
@@ -437,7 +437,7 @@ void NormalsOutFeatHLSL::processPix(   Vector<ShaderComponent*> &componentList,
                                        const MaterialFeatureData &fd )
 {
    MultiLine *meta = new MultiLine;
-   output = meta;
+   setOutput( meta );
 
    Var *wsNormal = (Var*)LangElement::find( "wsNormal" );
    if ( !wsNormal )
@@ -43,7 +43,7 @@ void CustomFeatureHLSL::processVert(Vector<ShaderComponent*>& componentList,
 
    getOutObjToTangentSpace( componentList, meta, fd );
 
-   output = meta;*/
+   setOutput( meta );*/
 
    meta = new MultiLine;
 
@@ -55,7 +55,7 @@ void CustomFeatureHLSL::processVert(Vector<ShaderComponent*>& componentList,
    if (mOwner->isMethod("processVertHLSL"))
       Con::executef(mOwner, "processVertHLSL");
 
-   output = meta;
+   setOutput( meta );
 }
 
 void CustomFeatureHLSL::processPix(Vector<ShaderComponent*>& componentList,
@@ -71,7 +71,7 @@ void CustomFeatureHLSL::processPix(Vector<ShaderComponent*>& componentList,
    if (mOwner->isMethod("processPixelHLSL"))
       Con::executef(mOwner, "processPixelHLSL");
 
-   output = meta;
+   setOutput( meta );
 }
 
 void CustomFeatureHLSL::setTexData(Material::StageData& stageDat,
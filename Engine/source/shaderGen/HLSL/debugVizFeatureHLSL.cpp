@@ -103,7 +103,7 @@ void DebugVizHLSL::processPix(Vector<ShaderComponent*>& componentList,
          };
       }
 
-      output = meta;
+      setOutput( meta );
       return;
    }
 
@@ -191,7 +191,7 @@ void DebugVizHLSL::processPix(Vector<ShaderComponent*>& componentList,
 
       meta->addStatement(new GenOp("   @.rgb = @.rgb;\r\n", color, ibl));
 
-      output = meta;
+      setOutput( meta );
       return;
    }
 }
@@ -31,7 +31,7 @@ void EyeSpaceDepthOutHLSL::processVert(   Vector<ShaderComponent*> &componentLis
                                           const MaterialFeatureData &fd )
 {
    MultiLine *meta = new MultiLine;
-   output = meta;
+   setOutput( meta );
 
    // grab output
    ShaderConnector *connectComp = dynamic_cast<ShaderConnector *>( componentList[C_CONNECTOR] );
@@ -110,7 +110,7 @@ void EyeSpaceDepthOutHLSL::processPix( Vector<ShaderComponent*> &componentList,
    if( !fd.features[MFT_DeferredConditioner] )
       meta->addStatement( new GenOp( "   @;\r\n", assignColor( new GenOp( "float4(@.rrr,1)", depthOut ), Material::None ) ) );
    
-   output = meta;
+   setOutput( meta );
 }
 
 ShaderFeature::Resources EyeSpaceDepthOutHLSL::getResources( const MaterialFeatureData &fd )
@@ -139,7 +139,7 @@ void DepthOutHLSL::processVert(  Vector<ShaderComponent*> &componentList,
    outDepth->setStructName( "OUT" );
    outDepth->setType( "float" );
 
-   output = new GenOp( "   @ = @.z / @.w;\r\n", outDepth, outPosition, outPosition );
+   setOutput( new GenOp( "   @ = @.z / @.w;\r\n", outDepth, outPosition, outPosition ) );
 }
 
 void DepthOutHLSL::processPix(   Vector<ShaderComponent*> &componentList, 
@@ -163,7 +163,7 @@ void DepthOutHLSL::processPix(   Vector<ShaderComponent*> &componentList,
 
    LangElement *depthOut = new GenOp( "float4( @, 0, 0, 1 )", depthVar );
 
-   output = new GenOp( "   @;\r\n", assignColor( depthOut, Material::None ) );
+   setOutput( new GenOp( "   @;\r\n", assignColor( depthOut, Material::None ) ) );
 }
 
 ShaderFeature::Resources DepthOutHLSL::getResources( const MaterialFeatureData &fd )
@@ -126,7 +126,7 @@ void ParaboloidVertTransformHLSL::processVert(  Vector<ShaderComponent*> &compon
       meta->addStatement( new GenOp( "   @.xy += @;\r\n", outPosition, atlasOffset ) );
    }
 
-   output = meta;
+   setOutput( meta );
 }
 
 void ParaboloidVertTransformHLSL::processPix(   Vector<ShaderComponent*> &componentList, 
@@ -154,7 +154,7 @@ void ParaboloidVertTransformHLSL::processPix(   Vector<ShaderComponent*> &compon
    posXY->setType( "float2" );
    meta->addStatement( new GenOp( "   clip( 1.0 - abs(@.x) );\r\n", posXY ) );
 
-   output = meta;
+   setOutput( meta );
 }
 
 ShaderFeature::Resources ParaboloidVertTransformHLSL::getResources( const MaterialFeatureData &fd )
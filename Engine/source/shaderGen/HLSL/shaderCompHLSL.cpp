@@ -286,9 +286,10 @@ void ParamsDefHLSL::assignConstantNumbers()
    for (U32 bin = cspUninit+1; bin < csp_Count; bin++)
    {   
       // Find all the uniform variables that are part of this group and assign constant numbers
-      for( U32 i=0; i<LangElement::elementList.size(); i++)
+      const Vector<LangElement*> &elementList = LangElement::getElements();
+      for( U32 i=0; i<elementList.size(); i++)
       {
-         Var *var = dynamic_cast<Var*>(LangElement::elementList[i]);
+         Var *var = dynamic_cast<Var*>(elementList[i]);
          if( var )
          {            
             bool shaderConst = var->uniform && !var->sampler && !var->texture;
@@ -333,9 +334,10 @@ void VertexParamsDefHLSL::print( Stream &stream, bool isVerterShader )
    stream.write( dStrlen(opener), opener );
 
    // find all the uniform variables and print them out
-   for( U32 i=0; i<LangElement::elementList.size(); i++)
+   const Vector<LangElement*> &elementList = LangElement::getElements();
+   for( U32 i=0; i<elementList.size(); i++)
    {
-      Var *var = dynamic_cast<Var*>(LangElement::elementList[i]);
+      Var *var = dynamic_cast<Var*>(elementList[i]);
       if( var )
       {
          if( var->uniform )
@@ -369,9 +371,10 @@ void PixelParamsDefHLSL::print( Stream &stream, bool isVerterShader )
    stream.write( dStrlen(opener), opener );
 
    // find all the sampler & uniform variables and print them out
-   for( U32 i=0; i<LangElement::elementList.size(); i++)
+   const Vector<LangElement*> &elementList = LangElement::getElements();
+   for( U32 i=0; i<elementList.size(); i++)
    {
-      Var *var = dynamic_cast<Var*>(LangElement::elementList[i]);
+      Var *var = dynamic_cast<Var*>(elementList[i]);
       if( var )
       {
          if( var->uniform )
@@ -186,18 +186,18 @@ LangElement *ShaderFeatureHLSL::expandNormalMap(   LangElement *sampleNormalOp,
 
 ShaderFeatureHLSL::ShaderFeatureHLSL()
 {
-   output = NULL;
 }
 
 Var * ShaderFeatureHLSL::getVertTexCoord( const String &name )
 {
    Var *inTex = NULL;
 
-   for( U32 i=0; i<LangElement::elementList.size(); i++ )
+   const Vector<LangElement*> &elementList = LangElement::getElements();
+   for( U32 i=0; i<elementList.size(); i++ )
    {
-      if( !String::compare( (char*)LangElement::elementList[i]->name, name.c_str() ) )
+      if( !String::compare( (char*)elementList[i]->name, name.c_str() ) )
       {
-         inTex = dynamic_cast<Var*>( LangElement::elementList[i] );
+         inTex = dynamic_cast<Var*>( elementList[i] );
          if ( inTex )
          {
             // NOTE: This used to do this check...
@@ -548,10 +548,10 @@ Var* ShaderFeatureHLSL::getObjTrans(   Vector<ShaderComponent*> &componentList,
       instObjTrans->setStructName( "IN" );
       instObjTrans->setName( "inst_objectTrans" );
 
-      mInstancingFormat->addElement( "objTrans", GFXDeclType_Float4, instObjTrans->constNum+0 );
-      mInstancingFormat->addElement( "objTrans", GFXDeclType_Float4, instObjTrans->constNum+1 );
-      mInstancingFormat->addElement( "objTrans", GFXDeclType_Float4, instObjTrans->constNum+2 );
-      mInstancingFormat->addElement( "objTrans", GFXDeclType_Float4, instObjTrans->constNum+3 );
+      getInstancingFormat()->addElement( "objTrans", GFXDeclType_Float4, instObjTrans->constNum+0 );
+      getInstancingFormat()->addElement( "objTrans", GFXDeclType_Float4, instObjTrans->constNum+1 );
+      getInstancingFormat()->addElement( "objTrans", GFXDeclType_Float4, instObjTrans->constNum+2 );
+      getInstancingFormat()->addElement( "objTrans", GFXDeclType_Float4, instObjTrans->constNum+3 );
 
       objTrans = new Var;
       objTrans->setType( "float4x4" );
@@ -927,7 +927,7 @@ void DiffuseMapFeatHLSL::processVert( Vector<ShaderComponent*> &componentList,
                      fd.features[MFT_TexAnim], 
                      meta, 
                      componentList );
-   output = meta;
+   setOutput( meta );
 }
 
 U32 DiffuseMapFeatHLSL::getOutputTargets(const MaterialFeatureData &fd) const
@@ -968,7 +968,7 @@ void DiffuseMapFeatHLSL::processPix(   Vector<ShaderComponent*> &componentList,
    LangElement *colorDecl = new DecOp(diffColor);
 
    MultiLine * meta = new MultiLine;
-   output = meta;
+   setOutput( meta );
 
    if (  fd.features[MFT_CubeMap] )
    {
@@ -1112,12 +1112,12 @@ void OverlayTexFeatHLSL::processVert(  Vector<ShaderComponent*> &componentList,
          texMat->constSortPos = cspPass;   
       }
      
-      output = new GenOp( "   @ = mul(@, @);\r\n", outTex, texMat, inTex );
+      setOutput( new GenOp( "   @ = mul(@, @);\r\n", outTex, texMat, inTex ) );
       return;
    }
    
    // setup language elements to output incoming tex coords to output
-   output = new GenOp( "   @ = @;\r\n", outTex, inTex );
+   setOutput( new GenOp( "   @ = @;\r\n", outTex, inTex ) );
 }
 
 void OverlayTexFeatHLSL::processPix(   Vector<ShaderComponent*> &componentList, 
@@ -1148,7 +1148,7 @@ void OverlayTexFeatHLSL::processPix(   Vector<ShaderComponent*> &componentList,
 
    LangElement *statement = new GenOp("@.Sample(@, @)", diffuseMapTex, diffuseMap, inTex);
 
-   output = new GenOp( "   @;\r\n", assignColor( statement, Material::LerpAlpha ) );
+   setOutput( new GenOp( "   @;\r\n", assignColor( statement, Material::LerpAlpha ) ) );
 }
 
 ShaderFeature::Resources OverlayTexFeatHLSL::getResources( const MaterialFeatureData &fd )
@@ -1218,7 +1218,7 @@ void DiffuseFeatureHLSL::processPix(   Vector<ShaderComponent*> &componentList,
       op = Material::None;
 
    meta->addStatement( new GenOp( "   @;\r\n", assignColor( diffuseMaterialColor, op, NULL, targ ) ) );
-   output = meta;
+   setOutput( meta );
 }
 
 
@@ -1239,7 +1239,7 @@ void DiffuseVertColorFeatureHLSL::processVert(  Vector< ShaderComponent* >& comp
       Var* inColor = dynamic_cast< Var* >( LangElement::find( "diffuse" ) );
       if( !inColor )
       {
-         output = NULL;
+         setOutput( NULL );
          return;
       }
       
@@ -1252,10 +1252,10 @@ void DiffuseVertColorFeatureHLSL::processVert(  Vector< ShaderComponent* >& comp
       outColor->setStructName( "OUT" );
       outColor->setType( "float4" );
 
-      output = new GenOp( "   @ = @.bgra;\r\n", outColor, inColor );
+      setOutput( new GenOp( "   @ = @.bgra;\r\n", outColor, inColor ) );
    }
    else
-      output = NULL; // Nothing we need to do.
+      setOutput( NULL ); // Nothing we need to do.
 }
 
 void DiffuseVertColorFeatureHLSL::processPix(   Vector<ShaderComponent*> &componentList, 
@@ -1277,7 +1277,7 @@ void DiffuseVertColorFeatureHLSL::processPix(   Vector<ShaderComponent*> &compon
       meta->addStatement(new GenOp("   @;\r\n", assignColor(vertColor, Material::Mul, NULL, ShaderFeature::RenderTarget1)));
    else
       meta->addStatement(new GenOp("   @;\r\n", assignColor(vertColor, Material::Mul)));
-   output = meta;
+   setOutput( meta );
 }
 
 
@@ -1299,7 +1299,7 @@ void LightmapFeatHLSL::processVert( Vector<ShaderComponent*> &componentList,
    outTex->setType( "float2" );
 
    // setup language elements to output incoming tex coords to output
-   output = new GenOp( "   @ = @;\r\n", outTex, inTex );
+   setOutput( new GenOp( "   @ = @;\r\n", outTex, inTex ) );
 }
 
 void LightmapFeatHLSL::processPix(  Vector<ShaderComponent*> &componentList, 
@@ -1335,7 +1335,7 @@ void LightmapFeatHLSL::processPix(  Vector<ShaderComponent*> &componentList,
       lmColor->setType( "float4" );
       LangElement *lmColorDecl = new DecOp( lmColor );
       
-      output = new GenOp("   @ = @.Sample(@, @);\r\n", lmColorDecl, lightMapTex, lightMap, inTex);
+      setOutput( new GenOp("   @ = @.Sample(@, @);\r\n", lmColorDecl, lightMapTex, lightMap, inTex) );
 
       return;
    }
@@ -1381,7 +1381,7 @@ void LightmapFeatHLSL::processPix(  Vector<ShaderComponent*> &componentList,
    else
       meta->addStatement( new GenOp( "   @;\r\n", assignColor( statement, Material::Mul ) ) );
 
-   output = meta;
+   setOutput( meta );
 }
 
 ShaderFeature::Resources LightmapFeatHLSL::getResources( const MaterialFeatureData &fd )
@@ -1431,7 +1431,7 @@ void TonemapFeatHLSL::processVert( Vector<ShaderComponent*> &componentList,
       outTex2->setStructName( "OUT" );
       outTex2->setType( "float2" );
 
-      output = new GenOp( "   @ = @;\r\n", outTex2, inTex2 );
+      setOutput( new GenOp( "   @ = @;\r\n", outTex2, inTex2 ) );
    }
 }
 
@@ -1513,7 +1513,7 @@ void TonemapFeatHLSL::processPix(  Vector<ShaderComponent*> &componentList,
    else
       meta->addStatement( new GenOp( "   @;\r\n", assignColor( toneMapColor, blendOp ) ) );
   
-   output = meta;
+   setOutput( meta );
 }
 
 ShaderFeature::Resources TonemapFeatHLSL::getResources( const MaterialFeatureData &fd )
@@ -1555,7 +1555,7 @@ void VertLitHLSL::processVert(   Vector<ShaderComponent*> &componentList,
    // handled by the MFT_LightMap or MFT_ToneNamp feature instead
    if ( fd.features[MFT_LightMap] || fd.features[MFT_ToneMap] )
    {
-      output = NULL;
+      setOutput( NULL );
       return;
    }
 
@@ -1570,7 +1570,7 @@ void VertLitHLSL::processVert(   Vector<ShaderComponent*> &componentList,
       // If there isn't a vertex color then we can't do anything
       if( !inColor )
       {
-         output = NULL;
+         setOutput( NULL );
          return;
       }
 
@@ -1581,10 +1581,10 @@ void VertLitHLSL::processVert(   Vector<ShaderComponent*> &componentList,
       outColor->setStructName( "OUT" );
       outColor->setType( "float4" );
 
-      output = new GenOp( "   @ = @;\r\n", outColor, inColor );
+      setOutput( new GenOp( "   @ = @;\r\n", outColor, inColor ) );
    }
    else
-      output = NULL; // Nothing we need to do.
+      setOutput( NULL ); // Nothing we need to do.
 }
 
 void VertLitHLSL::processPix(   Vector<ShaderComponent*> &componentList, 
@@ -1594,7 +1594,7 @@ void VertLitHLSL::processPix(   Vector<ShaderComponent*> &componentList,
    // handled by the MFT_LightMap or MFT_ToneNamp feature instead
    if ( fd.features[MFT_LightMap] || fd.features[MFT_ToneMap] )
    {
-      output = NULL;
+      setOutput( NULL );
       return;
    }
    
@@ -1662,7 +1662,7 @@ void VertLitHLSL::processPix(   Vector<ShaderComponent*> &componentList,
    else
       meta->addStatement( new GenOp( "   @;\r\n", assignColor( outColor, blendOp ) ) );
 
-   output = meta;
+   setOutput( meta );
 }
 
 U32 VertLitHLSL::getOutputTargets( const MaterialFeatureData &fd ) const
@@ -1681,7 +1681,7 @@ void DetailFeatHLSL::processVert(   Vector<ShaderComponent*> &componentList,
    addOutDetailTexCoord( componentList, 
                          meta,
                          fd.features[MFT_TexAnim], fd.features[MFT_Foliage] );
-   output = meta;
+   setOutput( meta );
 }
 
 void DetailFeatHLSL::processPix( Vector<ShaderComponent*> &componentList, 
@@ -1715,9 +1715,9 @@ void DetailFeatHLSL::processPix( Vector<ShaderComponent*> &componentList,
    LangElement *statement = new GenOp("( @.Sample(@, @) * 2.0 ) - 1.0", detailMapTex, detailMap, inTex);
 
    if (  fd.features[MFT_isDeferred])
-      output = new GenOp( "   @;\r\n", assignColor( statement, Material::Add, NULL, ShaderFeature::RenderTarget1 ) );
+      setOutput( new GenOp( "   @;\r\n", assignColor( statement, Material::Add, NULL, ShaderFeature::RenderTarget1 ) ) );
    else
-      output = new GenOp( "   @;\r\n", assignColor( statement, Material::Add ) );
+      setOutput( new GenOp( "   @;\r\n", assignColor( statement, Material::Add ) ) );
 }
 
 ShaderFeature::Resources DetailFeatHLSL::getResources( const MaterialFeatureData &fd )
@@ -1786,7 +1786,7 @@ void VertPositionHLSL::processVert( Vector<ShaderComponent*> &componentList,
       meta->addStatement(new GenOp("   @ = @.xyww;\r\n", outPosition, outPosition));
    }
 
-   output = meta;
+   setOutput( meta );
 }
 
 void VertPositionHLSL::processPix( Vector<ShaderComponent*> &componentList,
@@ -1890,7 +1890,7 @@ void ReflectCubeFeatHLSL::processVert( Vector<ShaderComponent*> &componentList,
 
     meta->addStatement( new GenOp( "   @ = reflect(@, @);\r\n", reflectVec, eyeToVert, cubeNormal ) );
 
-    output = meta;
+    setOutput( meta );
 }
 
 void ReflectCubeFeatHLSL::processPix(  Vector<ShaderComponent*> &componentList, 
@@ -2056,7 +2056,7 @@ void ReflectCubeFeatHLSL::processPix(  Vector<ShaderComponent*> &componentList,
       else
          meta->addStatement(new GenOp("   @.rgb *= @.rgb;\r\n", targ, texCube));
    }
-   output = meta;
+   setOutput( meta );
 }
 
 ShaderFeature::Resources ReflectCubeFeatHLSL::getResources( const MaterialFeatureData &fd )
@@ -2173,7 +2173,7 @@ void RTLightingFeatHLSL::processVert(  Vector<ShaderComponent*> &componentList,
 
       addOutWsPosition( componentList, fd.features[MFT_UseInstancing], meta );
 
-      output = meta;
+      setOutput( meta );
 
       return;
    }
@@ -2209,7 +2209,7 @@ void RTLightingFeatHLSL::processVert(  Vector<ShaderComponent*> &componentList,
    addOutWsPosition( componentList, fd.features[MFT_UseInstancing], meta );
    getOutWorldToTangent(componentList, meta, fd);
 
-   output = meta;
+   setOutput( meta );
 }
 
 void RTLightingFeatHLSL::processPix(   Vector<ShaderComponent*> &componentList, 
@@ -2307,7 +2307,7 @@ void RTLightingFeatHLSL::processPix(   Vector<ShaderComponent*> &componentList,
 
    meta->addStatement(new GenOp("   @.rgb += @.rgb;\r\n", curColor, lighting));
 
-   output = meta;  
+   setOutput( meta );  
 }
 
 ShaderFeature::Resources RTLightingFeatHLSL::getResources( const MaterialFeatureData &fd )
@@ -2388,7 +2388,7 @@ void FogFeatHLSL::processVert(   Vector<ShaderComponent*> &componentList,
       addOutWsPosition( componentList, fd.features[MFT_UseInstancing], meta );
    }
 
-   output = meta;
+   setOutput( meta );
 }
 
 void FogFeatHLSL::processPix( Vector<ShaderComponent*> &componentList, 
@@ -2451,7 +2451,7 @@ void FogFeatHLSL::processPix( Vector<ShaderComponent*> &componentList,
    LangElement *fogLerp = new GenOp( "lerp( @.rgb, @.rgb, @ )", fogColor, color, fogAmount );
    meta->addStatement( new GenOp( "   @.rgb = @;\r\n", color, fogLerp ) );
 
-   output = meta;
+   setOutput( meta );
 }
 
 ShaderFeature::Resources FogFeatHLSL::getResources( const MaterialFeatureData &fd )
@@ -2476,7 +2476,7 @@ void VisibilityFeatHLSL::processVert( Vector<ShaderComponent*> &componentList,
                                       const MaterialFeatureData &fd )
 {
    MultiLine *meta = new MultiLine;
-   output = meta;
+   setOutput( meta );
 
    if ( fd.features[ MFT_UseInstancing ] )
    {
@@ -2497,7 +2497,7 @@ void VisibilityFeatHLSL::processVert( Vector<ShaderComponent*> &componentList,
       instVisibility->setStructName( "IN" );
       instVisibility->setName( "inst_visibility" );
       instVisibility->setType( "float" );
-      mInstancingFormat->addElement( "visibility", GFXDeclType_Float, instVisibility->constNum );
+      getInstancingFormat()->addElement( "visibility", GFXDeclType_Float, instVisibility->constNum );
 
       meta->addStatement( new GenOp( "   @ = @; // Instancing!\r\n", outVisibility, instVisibility ) );
    }
@@ -2530,7 +2530,7 @@ void VisibilityFeatHLSL::processPix(   Vector<ShaderComponent*> &componentList,
    }
 
    MultiLine *meta = new MultiLine;
-   output = meta;
+   setOutput( meta );
 
    // Translucent objects do a simple alpha fade.
    if ( fd.features[ MFT_IsTranslucent ] )
@@ -2572,7 +2572,7 @@ void AlphaTestHLSL::processPix(  Vector<ShaderComponent*> &componentList,
         !fd.features[ MFT_DepthOut ] ) ||
          fd.features[MFT_IsTranslucent])
    {
-      output = NULL;
+      setOutput( NULL );
       return;
    }
 
@@ -2582,7 +2582,7 @@ void AlphaTestHLSL::processPix(  Vector<ShaderComponent*> &componentList,
 	   color = (Var*)LangElement::find(getOutputTargetVarName(ShaderFeature::DefaultTarget));
    if ( !color )
    {
-      output = NULL;
+      setOutput( NULL );
       return;
    }
 
@@ -2594,7 +2594,7 @@ void AlphaTestHLSL::processPix(  Vector<ShaderComponent*> &componentList,
    alphaTestVal->constSortPos = cspPotentialPrimitive;
 
    // Do the clip.
-   output = new GenOp( "   clip( @.a - @ );\r\n", color, alphaTestVal );
+   setOutput( new GenOp( "   clip( @.a - @ );\r\n", color, alphaTestVal ) );
 }
 
 
@@ -2605,7 +2605,7 @@ void AlphaTestHLSL::processPix(  Vector<ShaderComponent*> &componentList,
 void GlowMaskHLSL::processPix(   Vector<ShaderComponent*> &componentList,
                                  const MaterialFeatureData &fd )
 {
-   output = NULL;
+   setOutput( NULL );
 
    // Get the output color... and make it black to mask out 
    // glow passes rendered before us.
@@ -2614,7 +2614,7 @@ void GlowMaskHLSL::processPix(   Vector<ShaderComponent*> &componentList,
    // code above that doesn't contribute to the alpha mask.
    Var *color = (Var*)LangElement::find(getOutputTargetVarName(ShaderFeature::DefaultTarget));
    if ( color )
-      output = new GenOp( "   @.rgb = 0;\r\n", color );
+      setOutput( new GenOp( "   @.rgb = 0;\r\n", color ) );
 }
 
 
@@ -2626,7 +2626,7 @@ void RenderTargetZeroHLSL::processPix( Vector<ShaderComponent*> &componentList,
 {
    // Do not actually assign zero, but instead a number so close to zero it may as well be zero.
    // This will prevent a divide by zero causing an FP special on float render targets
-   output = new GenOp( "   @;\r\n", assignColor( new GenOp( "0.00001" ), Material::None, NULL, mOutputTargetMask ) );
+   setOutput( new GenOp( "   @;\r\n", assignColor( new GenOp( "0.00001" ), Material::None, NULL, mOutputTargetMask ) ) );
 }
 
 
@@ -2646,7 +2646,7 @@ void HDROutHLSL::processPix(  Vector<ShaderComponent*> &componentList,
    // Let the helper function do the work.
    Var *color = (Var*)LangElement::find(getOutputTargetVarName(ShaderFeature::DefaultTarget));
    if ( color )
-      output = new GenOp( "   @ = hdrEncode( @ );\r\n", color, color );
+      setOutput( new GenOp( "   @ = hdrEncode( @ );\r\n", color, color ) );
 }
 
 //****************************************************************************
@@ -2710,7 +2710,7 @@ void FoliageFeatureHLSL::processVert( Vector<ShaderComponent*> &componentList,
    // Assign to foliageFade. InColor.a was set to the correct value inside foliageProcessVert.
    meta->addStatement( new GenOp( "   @ = @.a;\r\n", fade, inColor ) );
 
-   output = meta;
+   setOutput( meta );
 }
 
 void FoliageFeatureHLSL::processPix( Vector<ShaderComponent*> &componentList, 
@@ -2739,7 +2739,7 @@ void FoliageFeatureHLSL::processPix( Vector<ShaderComponent*> &componentList,
    // Multiply foliageFade into visibility.
    meta->addStatement( new GenOp( "   @ *= @;\r\n", visibility, fade ) );
 
-   output = meta;
+   setOutput( meta );
 }
 
 void FoliageFeatureHLSL::determineFeature( Material *material, const GFXVertexFormat *vertexFormat, U32 stageNum, const FeatureType &type, const FeatureSet &features, MaterialFeatureData *outFeatureData )
@@ -2768,7 +2768,7 @@ ShaderFeatureConstHandles* FoliageFeatureHLSL::createConstHandles( GFXShader *sh
 void ParticleNormalFeatureHLSL::processVert(Vector<ShaderComponent*> &componentList, const MaterialFeatureData &fd)
 {
    MultiLine *meta = new MultiLine;
-   output = meta;
+   setOutput( meta );
 
    // Calculate normal and tangent values since we want to keep particle verts
    // as light-weight as possible
@@ -2811,7 +2811,7 @@ void ImposterVertFeatureHLSL::processVert(   Vector<ShaderComponent*> &component
                                              const MaterialFeatureData &fd )
 {      
    MultiLine *meta = new MultiLine;
-   output = meta;
+   setOutput( meta );
 
    // Get the input vertex variables.   
    Var *inPosition = (Var*)LangElement::find( "position" );
@@ -2932,7 +2932,7 @@ void ImposterVertFeatureHLSL::processPix( Vector<ShaderComponent*> &componentLis
    // Multiply foliageFade into visibility.
    meta->addStatement( new GenOp( "   @ *= @;\r\n", visibility, fade ) );
 
-   output = meta;
+   setOutput( meta );
 }
 
 void ImposterVertFeatureHLSL::determineFeature( Material *material, 
@@ -2978,7 +2978,7 @@ void HardwareSkinningFeatureHLSL::processVert(   Vector<ShaderComponent*> &compo
       nodeTransforms->constSortPos = cspPotentialPrimitive;
    }
    
-   U32 numIndices = mVertexFormat->getNumBlendIndices();
+   U32 numIndices = getVertexFormat()->getNumBlendIndices();
    meta->addStatement( new GenOp( "   @ = 0.0;\r\n", new DecOp( posePos ) ) );  
    meta->addStatement( new GenOp( "   @ = 0.0;\r\n", new DecOp( poseNormal ) ) );
    meta->addStatement( new GenOp( "   @;\r\n", new DecOp( poseMat ) ) );
@@ -3007,7 +3007,7 @@ void HardwareSkinningFeatureHLSL::processVert(   Vector<ShaderComponent*> &compo
    meta->addStatement( new GenOp( "   @ = @;\r\n", inPosition, posePos ) );
    meta->addStatement( new GenOp( "   @ = normalize(@);\r\n", inNormal, poseNormal ) );
 
-   output = meta;
+   setOutput( meta );
 }
 
 //****************************************************************************
@@ -3024,7 +3024,7 @@ void ReflectionProbeFeatHLSL::processVert(Vector<ShaderComponent*>& componentLis
    const MaterialFeatureData& fd)
 {
    MultiLine* meta = new MultiLine;
-   output = meta;
+   setOutput( meta );
    // Also output the worldToTanget transform which
    // we use to create the world space normal.
    //getOutWorldToTangent(componentList, meta, fd);
@@ -3148,7 +3148,7 @@ void ReflectionProbeFeatHLSL::processPix(Vector<ShaderComponent*> &componentList
 
    meta->addStatement(new GenOp("   @.rgb = @.rgb;\r\n", curColor, ibl));
 
-   output = meta;
+   setOutput( meta );
 }
 
 ShaderFeature::Resources ReflectionProbeFeatHLSL::getResources(const MaterialFeatureData &fd)
@@ -118,6 +118,9 @@ Var *ConditionerFeature::_unconditionInput( Var *conditionedInput, MultiLine *me
 
 const String &ConditionerFeature::getShaderMethodName( MethodType methodType )
 {
+   MutexHandle mh;
+   mh.lock( &mMethodMutex, true );
+
    if ( mConditionMethodName.isEmpty() )
    {
       const U32 hash = getName().getHashCaseInsensitive();
@@ -130,6 +133,9 @@ const String &ConditionerFeature::getShaderMethodName( MethodType methodType )
 
 ConditionerMethodDependency* ConditionerFeature::getConditionerMethodDependency( MethodType methodType )
 {
+   MutexHandle mh;
+   mh.lock( &mMethodMutex, true );
+
    if ( mMethodDependency[methodType] == NULL )
       mMethodDependency[methodType] = new ConditionerMethodDependency( this, methodType );
 
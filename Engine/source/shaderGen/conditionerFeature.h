@@ -28,6 +28,9 @@
 #ifndef _SHADER_DEPENDENCY_H_
 #include "shaderGen/shaderDependency.h"
 #endif
+#ifndef _PLATFORM_THREADS_MUTEX_H_
+#include "platform/threads/mutex.h"
+#endif
 
 class MultiLine;
 class ConditionerMethodDependency;
@@ -95,6 +98,10 @@ protected:
 
    String mConditionMethodName;
 
+   /// Guards the lazily created method names and dependencies
+   /// as features can be processed from several threads at once.
+   Mutex mMethodMutex;
+
    String mShaderIncludePath;
 
    void _print( Stream *stream );
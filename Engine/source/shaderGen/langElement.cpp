@@ -24,21 +24,25 @@
 #include "core/util/str.h"
 #include "gfx/gfxDevice.h"
 #include "langElement.h"
+#include "shaderGen/shaderGenContext.h"
 
 //**************************************************************************
 // Language element
 //**************************************************************************
-Vector<LangElement*> LangElement::elementList( __FILE__, __LINE__ );
+Vector<LangElement*>& LangElement::getElements()
+{
+   return ShaderGenContext::getCurrent()->mElements;
+}
 
 //--------------------------------------------------------------------------
 // Constructor
 //--------------------------------------------------------------------------
 LangElement::LangElement()
 {
-   elementList.push_back( this );
+   ShaderGenContext *context = ShaderGenContext::getCurrent();
+   context->mElements.push_back( this );
 
-   static U32 tempNum = 0;
-   dSprintf( (char*)name, sizeof(name), "tempName%d", tempNum++ );
+   dSprintf( (char*)name, sizeof(name), "tempName%d", context->mTempNameCount++ );
 }
 
 //--------------------------------------------------------------------------
@@ -46,6 +50,7 @@ LangElement::LangElement()
 //--------------------------------------------------------------------------
 LangElement * LangElement::find( const char *name )
 {
+   const Vector<LangElement*> &elementList = getElements();
    for( U32 i=0; i<elementList.size(); i++ )
    {
       if( !String::compare( (char*)elementList[i]->name, name ) )
@@ -62,13 +67,7 @@ LangElement * LangElement::find( const char *name )
 //--------------------------------------------------------------------------
 void LangElement::deleteElements()
 {
-   for( U32 i=0; i<elementList.size(); i++ )
-   {
-      delete elementList[i];
-   }
-   
-   elementList.setSize( 0 );
-
+   ShaderGenContext::getCurrent()->deleteElements();
 }
 
 //--------------------------------------------------------------------------
@@ -83,8 +82,6 @@ void LangElement::setName(const char* newName )
 //**************************************************************************
 // Variable
 //**************************************************************************
-U32 Var::texUnitCount = 0;
-
 Var::Var()
 {
    dStrcpy( (char*)type, "float4", 32 );
@@ -178,8 +175,9 @@ void Var::print( Stream &stream )
 //--------------------------------------------------------------------------
 U32 Var::getTexUnitNum(U32 numElements)
 {
-   U32 ret = texUnitCount;
-   texUnitCount += numElements;
+   ShaderGenContext *context = ShaderGenContext::getCurrent();
+   U32 ret = context->mTexUnitCount;
+   context->mTexUnitCount += numElements;
    return ret;
 }
 
@@ -188,7 +186,7 @@ U32 Var::getTexUnitNum(U32 numElements)
 //--------------------------------------------------------------------------
 void Var::reset()
 {
-   texUnitCount = 0;
+   ShaderGenContext::getCurrent()->mTexUnitCount = 0;
 }
 
 //**************************************************************************
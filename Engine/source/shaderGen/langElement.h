@@ -37,10 +37,10 @@
 /*!
    The LangElement class is the base building block for procedurally
    generated shader code.  LangElement and its subclasses are strung
-   together using the static Vector 'elementList'.
-   When a shader needs to be written to disk, the elementList is
+   together using the element list of the current ShaderGenContext.
+   When a shader needs to be written to disk, the element list is
    traversed and print() is called on each LangElement and the shader
-   is output.  elementList is cleared after each shader is printed out.
+   is output.  The element list is cleared after each shader is printed out.
 */
 //**************************************************************************
 
@@ -50,7 +50,10 @@
 //**************************************************************************
 struct LangElement
 {
-   static Vector<LangElement*> elementList;
+   /// Returns the elements of the current ShaderGenContext.
+   static Vector<LangElement*>& getElements();
+
+   /// Finds the element by name in the current ShaderGenContext.
    static LangElement * find( const char *name );
    static void deleteElements();
       
@@ -124,7 +127,7 @@ struct Var : public LangElement
    U32   arraySize;     // 1 = no array, > 1 array of "type"
    U32   rank;          // optional rank system to assist in sorting vars if needed
 
-   static U32  texUnitCount;
+   /// Allocates texture units from the current ShaderGenContext.
    static U32  getTexUnitNum(U32 numElements = 1);
    static void reset();
 
@@ -25,6 +25,7 @@
 
 #include "shaderGen/langElement.h"
 #include "shaderGen/shaderOp.h"
+#include "shaderGen/shaderGenContext.h"
 
 
 void ShaderFeature::addDependency( const ShaderDependency *dependsOn )
@@ -96,5 +97,49 @@ Var* ShaderFeature::findOrCreateLocal( const char *name,
 
 void ShaderFeature::setInstancingFormat(GFXVertexFormat *format)
 {
-   mInstancingFormat = format;
+   ShaderGenContext::getCurrent()->getFeatureState( this ).instancingFormat = format;
+}
+
+GFXVertexFormat* ShaderFeature::getInstancingFormat() const
+{
+   const ShaderGenContext::FeatureState *state = ShaderGenContext::getCurrent()->findFeatureState( this );
+   return state ? state->instancingFormat : NULL;
+}
+
+void ShaderFeature::setVertexFormat( const GFXVertexFormat *format )
+{
+   ShaderGenContext::getCurrent()->getFeatureState( this ).vertexFormat = format;
+}
+
+const GFXVertexFormat* ShaderFeature::getVertexFormat() const
+{
+   const ShaderGenContext::FeatureState *state = ShaderGenContext::getCurrent()->findFeatureState( this );
+   return state ? state->vertexFormat : NULL;
+}
+
+void ShaderFeature::setOutput( LangElement *output )
+{
+   ShaderGenContext::getCurrent()->getFeatureState( this ).output = output;
+}
+
+LangElement* ShaderFeature::getOutput() const
+{
+   const ShaderGenContext::FeatureState *state = ShaderGenContext::getCurrent()->findFeatureState( this );
+   return state ? state->output : NULL;
+}
+
+void ShaderFeature::setProcessIndex( S32 index )
+{
+   ShaderGenContext::getCurrent()->getFeatureState( this ).processIndex = index;
+}
+
+S32 ShaderFeature::getProcessIndex() const
+{
+   const ShaderGenContext::FeatureState *state = ShaderGenContext::getCurrent()->findFeatureState( this );
+   return state ? state->processIndex : 0;
+}
+
+void ShaderFeature::reset()
+{
+   ShaderGenContext::getCurrent()->resetFeatureState( this );
 }
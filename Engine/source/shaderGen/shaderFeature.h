@@ -93,21 +93,16 @@ public:
 
 protected:
 
-   LangElement *output;
-
    /// The list of unique shader dependencies.
    Vector<const ShaderDependency *> mDependencies;
 
+   /// Sets the head of the generated LangElement list.
    ///
-   S32 mProcessIndex;
-
-public:
-
-   // TODO: Make this protected and give it a proper API.
-   const GFXVertexFormat *mVertexFormat;
-
-   // TODO: Make this protected and give it a proper API.
-   GFXVertexFormat *mInstancingFormat;
+   /// The output, process index and vertex formats are kept in
+   /// the current ShaderGenContext rather than in the feature so
+   /// that one feature instance can generate several shaders at
+   /// once from different threads.
+   void setOutput( LangElement *output );
 
 public:   
 
@@ -144,24 +139,27 @@ public:
    // Base functions
    //-----------------------------------------------------------------------
    
-   ShaderFeature()
-      :  output( NULL ),
-         mProcessIndex( 0 ),
-         mVertexFormat( NULL ),
-         mInstancingFormat( NULL )
-   {
-   }
+   ShaderFeature() {}
 
    virtual ~ShaderFeature() {}
 
    /// returns output from a processed vertex or pixel shader
-   LangElement* getOutput() const { return output; }
+   LangElement* getOutput() const;
    
    ///
-   void setProcessIndex( S32 index ) { mProcessIndex = index; }
+   void setProcessIndex( S32 index );
 
    ///
-   S32 getProcessIndex() const { return mProcessIndex; }
+   S32 getProcessIndex() const;
+
+   /// Sets the vertex format of the shader being generated.
+   void setVertexFormat( const GFXVertexFormat *format );
+
+   /// Returns the vertex format of the shader being generated.
+   const GFXVertexFormat* getVertexFormat() const;
+
+   /// Returns the instancing format of the shader being generated.
+   GFXVertexFormat* getInstancingFormat() const;
 
    //-----------------------------------------------------------------------
    // Virtual Functions
@@ -210,7 +208,7 @@ public:
    //-----------------------------------------------------------------------
    virtual void processVert( Vector<ShaderComponent*> &componentList,
                              const MaterialFeatureData &fd )
-                             { output = NULL; }
+                             { setOutput( NULL ); }
 
    //-----------------------------------------------------------------------
    /*!
@@ -229,7 +227,7 @@ public:
    //-----------------------------------------------------------------------
    virtual void processPix( Vector<ShaderComponent*> &componentList, 
                             const MaterialFeatureData &fd ) 
-                            { output = NULL; }
+                            { setOutput( NULL ); }
 
    /// Allows the feature to add macros to pixel shader compiles.
    virtual void processPixMacros( Vector<GFXShaderMacro> &macros, const MaterialFeatureData &fd  ) {};
@@ -294,7 +292,7 @@ public:
 
    /// Called after processing the vertex and processing the pixel 
    /// to cleanup any temporary structures stored in the feature.
-   virtual void reset() { output = NULL; mProcessIndex = 0; mInstancingFormat = NULL; mVertexFormat = NULL; }
+   virtual void reset();
 
    /// A simpler helper function which either finds
    /// the existing local var or creates one.
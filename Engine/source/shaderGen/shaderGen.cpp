@@ -28,8 +28,14 @@
 #include "shaderGen/featureMgr.h"
 #include "shaderGen/shaderOp.h"
 #include "gfx/gfxDevice.h"
+#include "gfx/gfxShaderCache.h"
 #include "core/memVolume.h"
 #include "core/module.h"
+#include "core/stream/memStream.h"
+#include "core/util/fourcc.h"
+#include "core/util/safeDelete.h"
+#include "platform/threads/threadPoolBatch.h"
+#include "app/version.h"
 
 #ifdef TORQUE_D3D11
 #include "shaderGen/HLSL/customFeatureHLSL.h"
@@ -55,19 +61,81 @@ MODULE_BEGIN( ShaderGen )
 
 MODULE_END;
 
+/// The shader cache format of the generated shader records.
+static const U32 sShaderGenRecordFormat = MakeFourCC( 'S', 'G', 'E', 'N' );
+
 String ShaderGen::smCommonShaderPath("shaders/common");
 
+/// Generates the source of a shader recorded by a batch into
+/// memory.  The main thread writes it out once all are done.
+class ShaderGen::GenerateItem : public ThreadPoolBatch::Item
+{
+public:
+
+   GenerateItem(  ShaderGen *shaderGen,
+                  const String &cacheKey,
+                  const MaterialFeatureData &featureData,
+                  const GFXVertexFormat *vertexFormat,
+                  const Vector<GFXShaderMacro> &macros )
+      :  mShaderGen( shaderGen ),
+         mCacheKey( cacheKey ),
+         mMacros( macros ),
+         mVertStream( NULL ),
+         mPixStream( NULL ),
+         mGenerated( false )
+   {
+      // Keep our own copy as the format may not outlive the batch.
+      mVertexFormat.copy( *vertexFormat );
+
+      mState.featureData = featureData;
+      mState.vertexFormat = &mVertexFormat;
+   }
+
+   virtual ~GenerateItem()
+   {
+      SAFE_DELETE( mVertStream );
+      SAFE_DELETE( mPixStream );
+   }
+
+   ShaderGen *mShaderGen;
+
+   String mCacheKey;
+
+   Vector<GFXShaderMacro> mMacros;
+
+   GFXVertexFormat mVertexFormat;
+
+   GenState mState;
+
+   /// The generated source until it has been written out.
+   MemStream *mVertStream;
+   MemStream *mPixStream;
+
+   /// Set once the source has been written out.
+   bool mGenerated;
+
+protected:
+
+   // ThreadPoolBatch::Item
+   virtual void executeItem()
+   {
+      mVertStream = new MemStream( 16 * 1024 );
+      mPixStream = new MemStream( 16 * 1024 );
+      mShaderGen->_generate( mState, mVertStream, mPixStream, mMacros );
+   }
+};
+
 ShaderGen::ShaderGen()
 {
    mInit = false;
+   mNullDeviceShaders = false;
    GFXDevice::getDeviceEventSignal().notify(this, &ShaderGen::_handleGFXEvent);
-   mOutput = NULL;
+   mBatching = false;
 }
 
 ShaderGen::~ShaderGen()
 {
    GFXDevice::getDeviceEventSignal().remove(this, &ShaderGen::_handleGFXEvent);
-   _uninit();
 }
 
 void ShaderGen::registerInitDelegate(GFXAdapterType adapterType, ShaderGenInitDelegate& initDelegate)
@@ -93,12 +161,31 @@ bool ShaderGen::_handleGFXEvent(GFXDevice::GFXDeviceEventType event)
    return true;
 }
 
+void ShaderGen::enableNullDeviceShaders()
+{
+   mNullDeviceShaders = true;
+
+   if ( GFXDevice::devicePresent() )
+      initShaderGen();
+}
+
 void ShaderGen::initShaderGen()
 {   
    if (mInit)
       return;
 
-   const GFXAdapterType adapterType = GFX->getAdapterType();
+   GFXAdapterType adapterType = GFX->getAdapterType();
+
+   // Dedicated servers run on the null device and have no use
+   // for shaders, so only generate them when asked to.
+   if ( adapterType == NullDevice )
+   {
+      if ( !mNullDeviceShaders && !Con::getBoolVariable( "$pref::Video::nullDeviceShaders", false ) )
+         return;
+
+      adapterType = !mInitDelegates[Direct3D11] ? OpenGL : Direct3D11;
+   }
+
    if (!mInitDelegates[adapterType])
       return;
 
@@ -135,6 +222,14 @@ void ShaderGen::initShaderGen()
    Torque::FS::Remove( "shadergen:/" + ConditionerFeature::ConditionerIncludeFileName );
 }
 
+void ShaderGen::_getShaderFileNames( const char *cacheName, char *vertFile, char *pixFile )
+{
+   // Note:  We use a postfix of _V/_P here so that it sorts the matching
+   // vert and pixel shaders together when listed alphabetically.   
+   dSprintf( vertFile, 256, "shadergen:/%s_V.%s", cacheName, mFileEnding.c_str() );
+   dSprintf( pixFile, 256, "shadergen:/%s_P.%s", cacheName, mFileEnding.c_str() );
+}
+
 void ShaderGen::generateShader( const MaterialFeatureData &featureData,
                                 char *vertFile, 
                                 char *pixFile, 
@@ -145,22 +240,11 @@ void ShaderGen::generateShader( const MaterialFeatureData &featureData,
 {
    PROFILE_SCOPE( ShaderGen_GenerateShader );
 
-   mFeatureData = featureData;
-   mVertexFormat = vertexFormat;
-
-   _uninit();
-   _init();
+   GenState state;
+   state.featureData = featureData;
+   state.vertexFormat = vertexFormat;
 
-   char vertShaderName[256];
-   char pixShaderName[256];
-
-   // Note:  We use a postfix of _V/_P here so that it sorts the matching
-   // vert and pixel shaders together when listed alphabetically.   
-   dSprintf( vertShaderName, sizeof(vertShaderName), "shadergen:/%s_V.%s", cacheName, mFileEnding.c_str() );
-   dSprintf( pixShaderName, sizeof(pixShaderName), "shadergen:/%s_P.%s", cacheName, mFileEnding.c_str() );
-   
-   dStrcpy( vertFile, vertShaderName, 256 );
-   dStrcpy( pixFile, pixShaderName, 256 );
+   _getShaderFileNames( cacheName, vertFile, pixFile );
    
    // this needs to change - need to optimize down to ps v.1.1
    *pixVersion = GFX->getPixelShaderVersion();
@@ -169,88 +253,93 @@ void ShaderGen::generateShader( const MaterialFeatureData &featureData,
    {
       // If we are not regenerating the shader we will return here.
       // But we must fill in the shader macros first!
-
-      _processVertFeatures( macros, true );
-      _processPixFeatures( macros, true );      
-
+      _generate( state, NULL, NULL, macros );
       return;
    }
 
-   // create vertex shader
-   //------------------------
-   FileStream* s = new FileStream();
-   if(!s->open(vertShaderName, Torque::FS::File::Write ))
+   FileStream vertStream;
+   if ( !vertStream.open( vertFile, Torque::FS::File::Write ) )
    {
       AssertFatal(false, "Failed to open Shader Stream" );
       return;
    }
 
-   mOutput = new MultiLine;
-   mInstancingFormat.clear();
-   _processVertFeatures(macros);
-   _printVertShader( *s );
-   delete s;
-   
-   ((ShaderConnector*)mComponents[C_CONNECTOR])->reset();
-   LangElement::deleteElements();
-
-   // create pixel shader
-   //------------------------
-   s = new FileStream();
-   if(!s->open(pixShaderName, Torque::FS::File::Write ))
+   FileStream pixStream;
+   if ( !pixStream.open( pixFile, Torque::FS::File::Write ) )
    {
       AssertFatal(false, "Failed to open Shader Stream" );
       return;
    }   
 
-   mOutput = new MultiLine;
-   _processPixFeatures(macros);
-   _printPixShader( *s );
+   _generate( state, &vertStream, &pixStream, macros );
 
-   delete s;
-   LangElement::deleteElements();
+   mInstancingFormat.copy( state.instancingFormat );
 }
 
-void ShaderGen::_init()
+void ShaderGen::_generate( GenState &state, Stream *vertStream, Stream *pixStream, Vector<GFXShaderMacro> &macros )
 {
-   _createComponents();
-}
+   // Everything created while generating goes into the
+   // context of this shader rather than a shared one.
+   ShaderGenContext::Scope scope( &state.context );
 
-void ShaderGen::_uninit()
-{
-   for( U32 i=0; i<mComponents.size(); i++ )
+   if ( !vertStream || !pixStream )
    {
-      delete mComponents[i];
-      mComponents[i] = NULL;
+      _processVertFeatures( state, macros, true );
+      _processPixFeatures( state, macros, true );
+      return;
    }
-   mComponents.setSize(0);
 
-   LangElement::deleteElements();
+   _createComponents( state );
+
+   // create vertex shader
+   //------------------------
+   state.output = new MultiLine;
+   state.instancingFormat.clear();
+   _processVertFeatures( state, macros );
+   _printVertShader( state, *vertStream );
+   
+   ((ShaderConnector*)state.components[C_CONNECTOR])->reset();
+   state.context.deleteElements();
+
+   // create pixel shader
+   //------------------------
+   state.output = new MultiLine;
+   _processPixFeatures( state, macros );
+   _printPixShader( state, *pixStream );
 
-   Var::reset();
+   state.context.deleteElements();
+   _destroyComponents( state );
 }
 
-void ShaderGen::_createComponents()
+void ShaderGen::_createComponents( GenState &state )
 {
-   ShaderComponent* vertComp = mComponentFactory->createVertexInputConnector( *mVertexFormat );
-   mComponents.push_back(vertComp);
+   ShaderComponent* vertComp = mComponentFactory->createVertexInputConnector( *state.vertexFormat );
+   state.components.push_back(vertComp);
 
    ShaderComponent* vertPixelCon = mComponentFactory->createVertexPixelConnector();
-   mComponents.push_back(vertPixelCon);
+   state.components.push_back(vertPixelCon);
 
    ShaderComponent* vertParamDef = mComponentFactory->createVertexParamsDef();
-   mComponents.push_back(vertParamDef);
+   state.components.push_back(vertParamDef);
 
    ShaderComponent* pixParamDef = mComponentFactory->createPixelParamsDef();
-   mComponents.push_back(pixParamDef);
+   state.components.push_back(pixParamDef);
+}
+
+void ShaderGen::_destroyComponents( GenState &state )
+{
+   for( U32 i=0; i<state.components.size(); i++ )
+      delete state.components[i];
+
+   state.components.setSize(0);
 }
 
 //----------------------------------------------------------------------------
 // Process features
 //----------------------------------------------------------------------------
-void ShaderGen::_processVertFeatures( Vector<GFXShaderMacro> &macros, bool macrosOnly )
+void ShaderGen::_processVertFeatures( GenState &state, Vector<GFXShaderMacro> &macros, bool macrosOnly )
 {
-   const FeatureSet &features = mFeatureData.features;
+   const FeatureSet &features = state.featureData.features;
 
    for( U32 i=0; i < features.getCount(); i++ )
    {
@@ -261,39 +350,42 @@ void ShaderGen::_processVertFeatures( Vector<GFXShaderMacro> &macros, bool macro
       {
          feature->setProcessIndex( index );
 
-         feature->processVertMacros( macros, mFeatureData );
+         feature->processVertMacros( macros, state.featureData );
 
          if ( macrosOnly )
             continue;
 
-         feature->setInstancingFormat( &mInstancingFormat );
+         feature->setInstancingFormat( &state.instancingFormat );
 
-         feature->mVertexFormat = mVertexFormat;
+         feature->setVertexFormat( state.vertexFormat );
 
-         feature->processVert( mComponents, mFeatureData );
+         feature->processVert( state.components, state.featureData );
 
          String line;
          if ( index > -1 )
             line = String::ToString( "   // %s %d\r\n", feature->getName().c_str(), index );
          else
             line = String::ToString( "   // %s\r\n", feature->getName().c_str() );
-         mOutput->addStatement( new GenOp( line ) );
+         state.output->addStatement( new GenOp( line ) );
 
          if ( feature->getOutput() )
-            mOutput->addStatement( feature->getOutput() );
+            state.output->addStatement( feature->getOutput() );
 
          feature->reset();
-         mOutput->addStatement( new GenOp( "   \r\n" ) );         
+         state.output->addStatement( new GenOp( "   \r\n" ) );         
       }
    }
 
-   ShaderConnector *connect = dynamic_cast<ShaderConnector *>( mComponents[C_CONNECTOR] );
+   if ( macrosOnly )
+      return;
+
+   ShaderConnector *connect = dynamic_cast<ShaderConnector *>( state.components[C_CONNECTOR] );
    connect->sortVars();
 }
 
-void ShaderGen::_processPixFeatures( Vector<GFXShaderMacro> &macros, bool macrosOnly )
+void ShaderGen::_processPixFeatures( GenState &state, Vector<GFXShaderMacro> &macros, bool macrosOnly )
 {
-   const FeatureSet &features = mFeatureData.features;
+   const FeatureSet &features = state.featureData.features;
 
    for( U32 i=0; i < features.getCount(); i++ )
    {
@@ -304,38 +396,41 @@ void ShaderGen::_processPixFeatures( Vector<GFXShaderMacro> &macros, bool macros
       {
          feature->setProcessIndex( index );
 
-         feature->processPixMacros( macros, mFeatureData );
+         feature->processPixMacros( macros, state.featureData );
 
          if ( macrosOnly )
             continue;
 
-         feature->setInstancingFormat( &mInstancingFormat );
-         feature->processPix( mComponents, mFeatureData );
+         feature->setInstancingFormat( &state.instancingFormat );
+         feature->processPix( state.components, state.featureData );
 
          String line;
          if ( index > -1 )
             line = String::ToString( "   // %s %d\r\n", feature->getName().c_str(), index );
          else
             line = String::ToString( "   // %s\r\n", feature->getName().c_str() );
-         mOutput->addStatement( new GenOp( line ) );
+         state.output->addStatement( new GenOp( line ) );
 
          if ( feature->getOutput() )
-            mOutput->addStatement( feature->getOutput() );
+            state.output->addStatement( feature->getOutput() );
 
          feature->reset();
-         mOutput->addStatement( new GenOp( "   \r\n" ) );
+         state.output->addStatement( new GenOp( "   \r\n" ) );
       }
    }
    
-   ShaderConnector *connect = dynamic_cast<ShaderConnector *>( mComponents[C_CONNECTOR] );
+   if ( macrosOnly )
+      return;
+
+   ShaderConnector *connect = dynamic_cast<ShaderConnector *>( state.components[C_CONNECTOR] );
    connect->sortVars();
 }
 
-void ShaderGen::_printFeatureList(Stream &stream)
+void ShaderGen::_printFeatureList( GenState &state, Stream &stream )
 {
    mPrinter->printLine(stream, "// Features:");
       
-   const FeatureSet &features = mFeatureData.features;
+   const FeatureSet &features = state.featureData.features;
 
    for( U32 i=0; i < features.getCount(); i++ )
    {
@@ -357,14 +452,14 @@ void ShaderGen::_printFeatureList(Stream &stream)
    mPrinter->printLine(stream, "");
 }
 
-void ShaderGen::_printDependencies(Stream &stream)
+void ShaderGen::_printDependencies( GenState &state, Stream &stream )
 {
    Vector<const ShaderDependency *> dependencies;
 
    for( U32 i=0; i < FEATUREMGR->getFeatureCount(); i++ )
    {
       const FeatureInfo &info = FEATUREMGR->getAt( i );
-      if ( mFeatureData.features.hasFeature( *info.type ) )
+      if ( state.featureData.features.hasFeature( *info.type ) )
          dependencies.merge( info.feature->getDependencies() );
    }
 
@@ -401,50 +496,50 @@ void ShaderGen::_printDependencies(Stream &stream)
    }
 }
 
-void ShaderGen::_printFeatures( Stream &stream )
+void ShaderGen::_printFeatures( GenState &state, Stream &stream )
 {
-   mOutput->print( stream );
+   state.output->print( stream );
 }
 
-void ShaderGen::_printVertShader( Stream &stream )
+void ShaderGen::_printVertShader( GenState &state, Stream &stream )
 {
    mPrinter->printShaderHeader(stream);
 
-   _printDependencies(stream); // TODO: Split into vert and pix dependencies?
-   _printFeatureList(stream);
+   _printDependencies(state, stream); // TODO: Split into vert and pix dependencies?
+   _printFeatureList(state, stream);
 
    // print out structures
-   mComponents[C_VERT_STRUCT]->print( stream, true );
-   mComponents[C_CONNECTOR]->print( stream, true );
+   state.components[C_VERT_STRUCT]->print( stream, true );
+   state.components[C_CONNECTOR]->print( stream, true );
 
    mPrinter->printMainComment(stream);
 
-   mComponents[C_VERT_MAIN]->print( stream, true );
-   mComponents[C_VERT_STRUCT]->printOnMain( stream, true );
+   state.components[C_VERT_MAIN]->print( stream, true );
+   state.components[C_VERT_STRUCT]->printOnMain( stream, true );
 
    // print out the function
-   _printFeatures( stream );
+   _printFeatures( state, stream );
 
    mPrinter->printVertexShaderCloser(stream);
 }
 
-void ShaderGen::_printPixShader( Stream &stream )
+void ShaderGen::_printPixShader( GenState &state, Stream &stream )
 {
    mPrinter->printShaderHeader(stream);
 
-   _printDependencies(stream); // TODO: Split into vert and pix dependencies?
-   _printFeatureList(stream);
+   _printDependencies(state, stream); // TODO: Split into vert and pix dependencies?
+   _printFeatureList(state, stream);
 
-   mComponents[C_CONNECTOR]->print( stream, false );
+   state.components[C_CONNECTOR]->print( stream, false );
 
-   mPrinter->printPixelShaderOutputStruct(stream, mFeatureData);
+   mPrinter->printPixelShaderOutputStruct(stream, state.featureData);
    mPrinter->printMainComment(stream);
 
-   mComponents[C_PIX_MAIN]->print( stream, false );
-   mComponents[C_CONNECTOR]->printOnMain( stream, false );
+   state.components[C_PIX_MAIN]->print( stream, false );
+   state.components[C_CONNECTOR]->printOnMain( stream, false );
 
    // print out the function
-   _printFeatures( stream );
+   _printFeatures( state, stream );
 
    mPrinter->printPixelShaderCloser(stream);
 }
@@ -465,6 +560,10 @@ GFXShader* ShaderGen::getShader( const MaterialFeatureData &featureData, const G
       shaderDescription += macroStr;
    }
 
+   // The generated code also depends on the device
+   // and shader model it is generated for.
+   shaderDescription += String::ToString( "%d_%.1f", (S32)GFX->getAdapterType(), GFX->getPixelShaderVersion() );
+
    // Generate a single 64bit hash from the description string.
    //
    // Don't get paranoid!  This has 1 in 18446744073709551616
@@ -489,7 +588,31 @@ GFXShader* ShaderGen::getShader( const MaterialFeatureData &featureData, const G
    shaderMacros.push_back( GFXShaderMacro( "TORQUE_SHADERGEN" ) );
    if ( macros )
       shaderMacros.merge( *macros );
-   generateShader( featureData, vertFile, pixFile, &pixVersion, vertexFormat, cacheKey, shaderMacros );
+
+   GenerateItemMap::Iterator batched = mBatchItems.find( cacheKey );
+   if ( batched != mBatchItems.end() )
+   {
+      // Still waiting on endBatch().
+      GenerateItem *item = batched->value;
+      if ( !item->mGenerated )
+         return NULL;
+
+      _getShaderFileNames( cacheKey, vertFile, pixFile );
+      pixVersion = GFX->getPixelShaderVersion();
+      shaderMacros = item->mMacros;
+      mInstancingFormat.copy( item->mState.instancingFormat );
+   }
+   else if ( !_loadCachedShader( cacheKey, vertFile, pixFile, &pixVersion, shaderMacros ) )
+   {
+      if ( mBatching && Con::getBoolVariable( "ShaderGen::GenNewShaders", true ) )
+      {
+         mBatchItems.insert( cacheKey, new GenerateItem( this, cacheKey, featureData, vertexFormat, shaderMacros ) );
+         return NULL;
+      }
+
+      generateShader( featureData, vertFile, pixFile, &pixVersion, vertexFormat, cacheKey, shaderMacros );
+      _saveCachedShader( cacheKey, shaderMacros, mInstancingFormat );
+   }
 
    GFXShader *shader = GFX->createShader();
    if (!shader->init(vertFile, pixFile, pixVersion, shaderMacros, samplers, &mInstancingFormat))
@@ -503,9 +626,165 @@ GFXShader* ShaderGen::getShader( const MaterialFeatureData &featureData, const G
    return shader;
 }
 
+/// Returns the shader cache key for the generated shader record.
+static U64 _getShaderGenRecordKey( const String &cacheKey )
+{
+   // Any engine change can alter the generated code
+   // so records never outlive the build that wrote them.
+   U64 key = GFXShaderCache::hashKey( String( getCompileTimeString() ), 0 );
+   return GFXShaderCache::hashKey( cacheKey, key );
+}
+
+bool ShaderGen::_loadCachedShader(  const String &cacheKey,
+                                    char *vertFile, 
+                                    char *pixFile, 
+                                    F32 *pixVersion,
+                                    Vector<GFXShaderMacro> &macros )
+{
+   PROFILE_SCOPE( ShaderGen_LoadCachedShader );
+
+   // Source kept in memory doesn't survive the run.
+   if ( mMemFS || !GFXShaderCache::isEnabled() )
+      return false;
+
+   if ( !Con::getBoolVariable( "ShaderGen::GenNewShaders", true ) )
+      return false;
+
+   dSprintf( vertFile, 256, "shadergen:/%s_V.%s", cacheKey.c_str(), mFileEnding.c_str() );
+   dSprintf( pixFile, 256, "shadergen:/%s_P.%s", cacheKey.c_str(), mFileEnding.c_str() );
+   if ( !Torque::FS::IsFile( vertFile ) || !Torque::FS::IsFile( pixFile ) )
+      return false;
+
+   Vector<U8> data;
+   if ( !GFXShaderCache::load( _getShaderGenRecordKey( cacheKey ), sShaderGenRecordFormat, data ) )
+      return false;
+
+   MemStream stream( data.size(), data.address(), true, false );
+
+   U32 macroCount = 0;
+   stream.read( &macroCount );
+   Vector<GFXShaderMacro> cachedMacros;
+   cachedMacros.setSize( macroCount );
+   for ( U32 i = 0; i < macroCount; i++ )
+   {
+      stream.read( &cachedMacros[i].name );
+      stream.read( &cachedMacros[i].value );
+   }
+
+   U32 elementCount = 0;
+   stream.read( &elementCount );
+   GFXVertexFormat instancingFormat;
+   for ( U32 i = 0; i < elementCount; i++ )
+   {
+      String semantic;
+      U32 type = 0, index = 0, streamIndex = 0;
+      stream.read( &semantic );
+      stream.read( &type );
+      stream.read( &index );
+      stream.read( &streamIndex );
+      instancingFormat.addElement( semantic, (GFXDeclType)type, index, streamIndex );
+   }
+
+   if ( stream.getStatus() != Stream::Ok )
+      return false;
+
+   macros = cachedMacros;
+   mInstancingFormat.copy( instancingFormat );
+   *pixVersion = GFX->getPixelShaderVersion();
+   return true;
+}
+
+void ShaderGen::_saveCachedShader( const String &cacheKey, const Vector<GFXShaderMacro> &macros, const GFXVertexFormat &instancingFormat )
+{
+   if ( mMemFS || !GFXShaderCache::isEnabled() )
+      return;
+
+   MemStream stream( 1024 );
+
+   stream.write( (U32)macros.size() );
+   for ( U32 i = 0; i < macros.size(); i++ )
+   {
+      stream.write( macros[i].name );
+      stream.write( macros[i].value );
+   }
+
+   stream.write( instancingFormat.getElementCount() );
+   for ( U32 i = 0; i < instancingFormat.getElementCount(); i++ )
+   {
+      const GFXVertexElement &element = instancingFormat.getElement( i );
+      stream.write( element.getSemantic() );
+      stream.write( (U32)element.getType() );
+      stream.write( element.getSemanticIndex() );
+      stream.write( element.getStreamIndex() );
+   }
+
+   GFXShaderCache::save( _getShaderGenRecordKey( cacheKey ), sShaderGenRecordFormat, stream.getBuffer(), stream.getPosition() );
+}
+
+void ShaderGen::beginBatch()
+{
+   AssertFatal( !mBatching, "ShaderGen::beginBatch - A batch is already started!" );
+   mBatching = true;
+}
+
+U32 ShaderGen::endBatch( ThreadPool *pool )
+{
+   PROFILE_SCOPE( ShaderGen_EndBatch );
+
+   AssertFatal( mBatching, "ShaderGen::endBatch - No batch was started!" );
+   mBatching = false;
+
+   ThreadPoolBatch batch( pool ? pool : &ThreadPool::GLOBAL() );
+   Vector<GenerateItem*> items;
+
+   GenerateItemMap::Iterator iter = mBatchItems.begin();
+   for ( ; iter != mBatchItems.end(); ++iter )
+   {
+      GenerateItem *item = iter->value;
+      if ( item->mGenerated )
+         continue;
+
+      items.push_back( item );
+      batch.add( item );
+   }
+
+   batch.wait();
+
+   // Write the source and the cache records out on this
+   // thread so that they're saved in a repeatable order.
+   for ( U32 i = 0; i < items.size(); i++ )
+   {
+      GenerateItem *item = items[i];
+
+      char vertFile[256];
+      char pixFile[256];
+      _getShaderFileNames( item->mCacheKey, vertFile, pixFile );
+
+      FileStream stream;
+      if ( stream.open( vertFile, Torque::FS::File::Write ) )
+         stream.write( item->mVertStream->getPosition(), item->mVertStream->getBuffer() );
+      stream.close();
+
+      if ( stream.open( pixFile, Torque::FS::File::Write ) )
+         stream.write( item->mPixStream->getPosition(), item->mPixStream->getBuffer() );
+      stream.close();
+
+      SAFE_DELETE( item->mVertStream );
+      SAFE_DELETE( item->mPixStream );
+      item->mGenerated = true;
+
+      _saveCachedShader( item->mCacheKey, item->mMacros, item->mState.instancingFormat );
+   }
+
+   return items.size();
+}
+
 void ShaderGen::flushProceduralShaders()
 {
+   AssertFatal( !mBatching, "ShaderGen::flushProceduralShaders - Can't flush during a batch!" );
+
    // The shaders are reference counted, so we
    // just need to clear the map.
    mProcShaders.clear();  
+   mBatchItems.clear();
 }
@@ -46,6 +46,14 @@
 #ifndef _MATERIALFEATUREDATA_H_
 #include "materials/materialFeatureData.h"
 #endif
+#ifndef _SHADERGENCONTEXT_H_
+#include "shaderGen/shaderGenContext.h"
+#endif
+#ifndef _THREADSAFEREFCOUNT_H_
+#include "platform/threads/threadSafeRefCount.h"
+#endif
+
+class ThreadPool;
 
 /// Base class used by shaderGen to be API agnostic.  Subclasses implement the various methods
 /// in an API specific way.
@@ -113,6 +121,11 @@ public:
    ShaderGen processes all of the features that are present for a desired
    shader, and then prints them out to the respective vertex or pixel
    shader file.
+
+   All the state of a shader being generated lives in a GenState and its
+   ShaderGenContext so several shaders can be generated at once.  Between
+   beginBatch() and endBatch() getShader() only records the shaders that
+   are requested and endBatch() generates their source on the thread pool.
    
    For more information on shader features and components see the 
    ShaderFeature and ShaderComponent classes.
@@ -135,6 +148,16 @@ public:
    /// shader features.
    void registerInitDelegate(GFXAdapterType adapterType, ShaderGenInitDelegate& initDelegate);
 
+   /// The null device compiles nothing, so ShaderGen stays uninitialized
+   /// on it unless headless rendering asks for shaders by calling this or
+   /// by setting $pref::Video::nullDeviceShaders before the device starts.
+   /// Shaders are then generated in the language of the first real device
+   /// with a registered generator.
+   void enableNullDeviceShaders();
+
+   /// Returns true once the generator for the active device is set up.
+   bool isInitialized() const { return mInit; }
+
    /// Signal used to notify systems to register features.
    typedef Signal<void(GFXAdapterType type)> FeatureInitSignal;
 
@@ -156,6 +179,21 @@ public:
    // Returns a shader that implements the features listed by dat.
    GFXShader* getShader( const MaterialFeatureData &dat, const GFXVertexFormat *vertexFormat, const Vector<GFXShaderMacro> *macros, const Vector<String> &samplers );
 
+   /// Starts recording the shaders requested from getShader() instead of
+   /// generating them.  Until endBatch() is called getShader() returns NULL
+   /// for every shader whose source has not been generated yet.
+   void beginBatch();
+
+   /// Generates the source of all the shaders recorded since beginBatch()
+   /// in parallel and writes them out.  The shaders themselves are created
+   /// by the next getShader() call for them.
+   /// @param pool The pool to generate on; defaults to the global pool.
+   /// @return The number of shaders generated.
+   U32 endBatch( ThreadPool *pool = NULL );
+
+   /// Returns true between beginBatch() and endBatch().
+   bool isBatching() const { return mBatching; }
+
    // This will delete all of the procedural shaders that we have.  Used to regenerate shaders when
    // the ShaderFeatures have changed (due to lighting system change, or new plugin)
    virtual void flushProceduralShaders();
@@ -170,23 +208,46 @@ protected:
 
    friend class ManagedSingleton<ShaderGen>;
 
-   // Shader generation 
-   MaterialFeatureData  mFeatureData;
-   const GFXVertexFormat *mVertexFormat;
-   
-   Vector< ShaderComponent *> mComponents;
+   /// The state of a single shader being generated.
+   struct GenState
+   {
+      MaterialFeatureData featureData;
+      const GFXVertexFormat *vertexFormat;
+
+      Vector< ShaderComponent *> components;
+
+      /// The currently processing output.
+      MultiLine *output;
+
+      GFXVertexFormat instancingFormat;
+
+      /// Holds the language elements and feature outputs.
+      ShaderGenContext context;
+
+      GenState() : vertexFormat( NULL ), output( NULL ) {}
+   };
+
+   /// Generates the source of a shader recorded by a batch.
+   class GenerateItem;
 
    AutoPtr<ShaderGenPrinter> mPrinter;
    AutoPtr<ShaderGenComponentFactory> mComponentFactory;
 
    String mFileEnding;
 
-   /// The currently processing output.
-   MultiLine *mOutput;
+   /// The instancing format of the last shader generated.
    GFXVertexFormat mInstancingFormat;
 
+   /// Set between beginBatch() and endBatch().
+   bool mBatching;
+
+   /// Map of cache string -> shaders recorded or generated by a batch.
+   typedef Map<String, ThreadSafeRef<GenerateItem> > GenerateItemMap;
+   GenerateItemMap mBatchItems;
+
    /// Init 
    bool mInit;
+   bool mNullDeviceShaders;
    ShaderGenInitDelegate mInitDelegates[GFXAdapterType_Count];
    FeatureInitSignal mFeatureInitSignal;
    bool mRegisteredWithGFX;
@@ -203,25 +264,43 @@ protected:
    /// Causes the init delegate to be called.
    void initShaderGen();
 
-   void _init();
-   void _uninit();
-
    /// Creates all the various shader components that will be filled in when 
    /// the shader features are processed.
-   void _createComponents();
+   void _createComponents( GenState &state );
+   void _destroyComponents( GenState &state );
+
+   /// Generates the vertex and pixel shader source into the streams
+   /// and fills in the macros.  Only the macros are filled in if
+   /// the streams are NULL.  This can be called from any thread.
+   void _generate( GenState &state, Stream *vertStream, Stream *pixStream, Vector<GFXShaderMacro> &macros );
 
-   void _printFeatureList(Stream &stream);
+   void _printFeatureList( GenState &state, Stream &stream );
 
    /// print out the processed features to the file stream
-   void _printFeatures( Stream &stream );
+   void _printFeatures( GenState &state, Stream &stream );
+
+   void _printDependencies( GenState &state, Stream &stream );
+
+   void _processPixFeatures( GenState &state, Vector<GFXShaderMacro> &macros, bool macrosOnly = false );
+   void _printPixShader( GenState &state, Stream &stream );
+
+   void _processVertFeatures( GenState &state, Vector<GFXShaderMacro> &macros, bool macrosOnly = false );
+   void _printVertShader( GenState &state, Stream &stream );
 
-   void _printDependencies( Stream &stream );
+   /// Returns the file names of the generated shader.
+   void _getShaderFileNames( const char *cacheName, char *vertFile, char *pixFile );
 
-   void _processPixFeatures( Vector<GFXShaderMacro> &macros, bool macrosOnly = false );
-   void _printPixShader( Stream &stream );
+   /// Looks for the source of a previous run in the shader cache.  On
+   /// success this fills in what generateShader() would have returned.
+   bool _loadCachedShader( const String &cacheKey,
+                           char *vertFile, 
+                           char *pixFile, 
+                           F32 *pixVersion,
+                           Vector<GFXShaderMacro> &macros );
 
-   void _processVertFeatures( Vector<GFXShaderMacro> &macros, bool macrosOnly = false );
-   void _printVertShader( Stream &stream );
+   /// Records the macros and instancing format of freshly generated
+   /// source so that the next run can skip generating it.
+   void _saveCachedShader( const String &cacheKey, const Vector<GFXShaderMacro> &macros, const GFXVertexFormat &instancingFormat );
 
    // For ManagedSingleton.
    static const char* getSingletonName() { return "ShaderGen"; }   
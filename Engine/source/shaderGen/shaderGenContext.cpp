@@ -0,0 +1,92 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "shaderGen/shaderGenContext.h"
+
+#include "shaderGen/langElement.h"
+
+
+thread_local ShaderGenContext* ShaderGenContext::smCurrent = NULL;
+
+ShaderGenContext::ShaderGenContext()
+   :  mTempNameCount( 0 ),
+      mTexUnitCount( 0 )
+{
+}
+
+ShaderGenContext::~ShaderGenContext()
+{
+   deleteElements();
+}
+
+ShaderGenContext& ShaderGenContext::_getDefault()
+{
+   static ShaderGenContext sDefault;
+   return sDefault;
+}
+
+ShaderGenContext* ShaderGenContext::getCurrent()
+{
+   if ( smCurrent )
+      return smCurrent;
+
+   return &_getDefault();
+}
+
+ShaderGenContext::FeatureState& ShaderGenContext::getFeatureState( const ShaderFeature *feature )
+{
+   return mFeatureStates[ feature ];
+}
+
+const ShaderGenContext::FeatureState* ShaderGenContext::findFeatureState( const ShaderFeature *feature ) const
+{
+   FeatureStateMap::ConstIterator iter = mFeatureStates.find( feature );
+   if ( iter == mFeatureStates.end() )
+      return NULL;
+
+   return &iter->value;
+}
+
+void ShaderGenContext::resetFeatureState( const ShaderFeature *feature )
+{
+   mFeatureStates.erase( feature );
+}
+
+void ShaderGenContext::deleteElements()
+{
+   for ( U32 i = 0; i < mElements.size(); i++ )
+      delete mElements[i];
+
+   mElements.setSize( 0 );
+}
+
+ShaderGenContext::Scope::Scope( ShaderGenContext *context )
+   :  mPrevious( smCurrent )
+{
+   smCurrent = context;
+}
+
+ShaderGenContext::Scope::~Scope()
+{
+   smCurrent = mPrevious;
+}
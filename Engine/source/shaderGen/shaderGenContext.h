@@ -0,0 +1,118 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _SHADERGENCONTEXT_H_
+#define _SHADERGENCONTEXT_H_
+
+#ifndef _TVECTOR_H_
+#include "core/util/tVector.h"
+#endif
+#ifndef _TDICTIONARY_H_
+#include "core/util/tDictionary.h"
+#endif
+
+struct LangElement;
+class ShaderFeature;
+class GFXVertexFormat;
+
+
+/// Holds all the state which is built up while generating a single
+/// shader; the language elements, the temporary name and texture unit
+/// counters and the per-feature outputs.
+///
+/// Each thread generates into its own current context so that several
+/// shaders can be generated at the same time.  Threads which never set
+/// a context share a default one, which is what the main thread uses.
+class ShaderGenContext
+{
+public:
+
+   /// The per-feature state set up before processing the
+   /// vertex or pixel features and cleared by ShaderFeature::reset().
+   struct FeatureState
+   {
+      LangElement *output;
+      S32 processIndex;
+      const GFXVertexFormat *vertexFormat;
+      GFXVertexFormat *instancingFormat;
+
+      FeatureState()
+         :  output( NULL ),
+            processIndex( 0 ),
+            vertexFormat( NULL ),
+            instancingFormat( NULL )
+      {
+      }
+   };
+
+   /// Makes a context current on this thread for the lifetime
+   /// of the scope and restores the previous one afterwards.
+   class Scope
+   {
+   public:
+      Scope( ShaderGenContext *context );
+      ~Scope();
+
+   protected:
+      ShaderGenContext *mPrevious;
+   };
+
+   ShaderGenContext();
+   ~ShaderGenContext();
+
+   /// Returns the context current on the calling thread.
+   static ShaderGenContext* getCurrent();
+
+   /// The elements created within this context.
+   Vector<LangElement*> mElements;
+
+   /// The counter used to build unique temporary element names.
+   U32 mTempNameCount;
+
+   /// The next free texture unit.
+   U32 mTexUnitCount;
+
+   /// Returns the state of the feature, creating it if needed.
+   FeatureState& getFeatureState( const ShaderFeature *feature );
+
+   /// Returns the state of the feature or NULL if it has none.
+   const FeatureState* findFeatureState( const ShaderFeature *feature ) const;
+
+   /// Clears the state of the feature.
+   void resetFeatureState( const ShaderFeature *feature );
+
+   /// Deletes all the elements created within this context.
+   void deleteElements();
+
+protected:
+
+   typedef Map<const ShaderFeature*, FeatureState> FeatureStateMap;
+   FeatureStateMap mFeatureStates;
+
+   /// The context current on this thread or NULL for the default.
+   static thread_local ShaderGenContext *smCurrent;
+
+   /// Returns the shared context used when none is current.
+   static ShaderGenContext& _getDefault();
+};
+
+#endif // _SHADERGENCONTEXT_H_
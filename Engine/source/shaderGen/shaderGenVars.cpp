@@ -23,90 +23,90 @@
 #include "platform/platform.h"
 #include "shaderGen/shaderGenVars.h"
 
-const String ShaderGenVars::modelview("$modelview");
-const String ShaderGenVars::worldViewOnly("$worldViewOnly");
-const String ShaderGenVars::worldToCamera("$worldToCamera");
-const String ShaderGenVars::cameraToWorld("$cameraToWorld");
-const String ShaderGenVars::worldToObj("$worldToObj");
-const String ShaderGenVars::viewToObj("$viewToObj");
-const String ShaderGenVars::invCameraTrans("$invCameraTrans");
-const String ShaderGenVars::cameraToScreen("$cameraToScreen");
-const String ShaderGenVars::screenToCamera("$screenToCamera");
-const String ShaderGenVars::cubeTrans("$cubeTrans");
-const String ShaderGenVars::cubeMips("$cubeMips");
-const String ShaderGenVars::objTrans("$objTrans");
-const String ShaderGenVars::cubeEyePos("$cubeEyePos");
-const String ShaderGenVars::eyePos("$eyePos");
-const String ShaderGenVars::eyePosWorld("$eyePosWorld");
-const String ShaderGenVars::vEye("$vEye");
-const String ShaderGenVars::eyeMat("$eyeMat");
-const String ShaderGenVars::oneOverFarplane("$oneOverFarplane");
-const String ShaderGenVars::nearPlaneWorld("$nearPlaneWorld");
-const String ShaderGenVars::fogData("$fogData");
-const String ShaderGenVars::fogColor("$fogColor");
-const String ShaderGenVars::detailScale("$detailScale");
-const String ShaderGenVars::visibility("$visibility");
-const String ShaderGenVars::colorMultiply("$colorMultiply");
-const String ShaderGenVars::alphaTestValue("$alphaTestValue");
-const String ShaderGenVars::texMat("$texMat");
-const String ShaderGenVars::accumTime("$accumTime");
-const String ShaderGenVars::minnaertConstant("$minnaertConstant");
-const String ShaderGenVars::subSurfaceParams("$subSurfaceParams");
+const GFXShaderConstId ShaderGenVars::modelview("$modelview");
+const GFXShaderConstId ShaderGenVars::worldViewOnly("$worldViewOnly");
+const GFXShaderConstId ShaderGenVars::worldToCamera("$worldToCamera");
+const GFXShaderConstId ShaderGenVars::cameraToWorld("$cameraToWorld");
+const GFXShaderConstId ShaderGenVars::worldToObj("$worldToObj");
+const GFXShaderConstId ShaderGenVars::viewToObj("$viewToObj");
+const GFXShaderConstId ShaderGenVars::invCameraTrans("$invCameraTrans");
+const GFXShaderConstId ShaderGenVars::cameraToScreen("$cameraToScreen");
+const GFXShaderConstId ShaderGenVars::screenToCamera("$screenToCamera");
+const GFXShaderConstId ShaderGenVars::cubeTrans("$cubeTrans");
+const GFXShaderConstId ShaderGenVars::cubeMips("$cubeMips");
+const GFXShaderConstId ShaderGenVars::objTrans("$objTrans");
+const GFXShaderConstId ShaderGenVars::cubeEyePos("$cubeEyePos");
+const GFXShaderConstId ShaderGenVars::eyePos("$eyePos");
+const GFXShaderConstId ShaderGenVars::eyePosWorld("$eyePosWorld");
+const GFXShaderConstId ShaderGenVars::vEye("$vEye");
+const GFXShaderConstId ShaderGenVars::eyeMat("$eyeMat");
+const GFXShaderConstId ShaderGenVars::oneOverFarplane("$oneOverFarplane");
+const GFXShaderConstId ShaderGenVars::nearPlaneWorld("$nearPlaneWorld");
+const GFXShaderConstId ShaderGenVars::fogData("$fogData");
+const GFXShaderConstId ShaderGenVars::fogColor("$fogColor");
+const GFXShaderConstId ShaderGenVars::detailScale("$detailScale");
+const GFXShaderConstId ShaderGenVars::visibility("$visibility");
+const GFXShaderConstId ShaderGenVars::colorMultiply("$colorMultiply");
+const GFXShaderConstId ShaderGenVars::alphaTestValue("$alphaTestValue");
+const GFXShaderConstId ShaderGenVars::texMat("$texMat");
+const GFXShaderConstId ShaderGenVars::accumTime("$accumTime");
+const GFXShaderConstId ShaderGenVars::minnaertConstant("$minnaertConstant");
+const GFXShaderConstId ShaderGenVars::subSurfaceParams("$subSurfaceParams");
 
-const String ShaderGenVars::diffuseAtlasParams("$diffuseAtlasParams");
-const String ShaderGenVars::diffuseAtlasTileParams("$diffuseAtlasTileParams");
-const String ShaderGenVars::bumpAtlasParams("$bumpAtlasParams");
-const String ShaderGenVars::bumpAtlasTileParams("$bumpAtlasTileParams");
+const GFXShaderConstId ShaderGenVars::diffuseAtlasParams("$diffuseAtlasParams");
+const GFXShaderConstId ShaderGenVars::diffuseAtlasTileParams("$diffuseAtlasTileParams");
+const GFXShaderConstId ShaderGenVars::bumpAtlasParams("$bumpAtlasParams");
+const GFXShaderConstId ShaderGenVars::bumpAtlasTileParams("$bumpAtlasTileParams");
 
-const String ShaderGenVars::targetSize("$targetSize");
-const String ShaderGenVars::oneOverTargetSize("$oneOverTargetSize");
+const GFXShaderConstId ShaderGenVars::targetSize("$targetSize");
+const GFXShaderConstId ShaderGenVars::oneOverTargetSize("$oneOverTargetSize");
 
-const String ShaderGenVars::lightPosition("$inLightPos");
-const String ShaderGenVars::lightDiffuse("$inLightColor"); 
-const String ShaderGenVars::lightAmbient("$ambient");
-const String ShaderGenVars::lightConfigData("$inLightConfigData");
-const String ShaderGenVars::lightSpotDir("$inLightSpotDir");
-const String ShaderGenVars::lightSpotParams("$lightSpotParams");
+const GFXShaderConstId ShaderGenVars::lightPosition("$inLightPos");
+const GFXShaderConstId ShaderGenVars::lightDiffuse("$inLightColor"); 
+const GFXShaderConstId ShaderGenVars::lightAmbient("$ambient");
+const GFXShaderConstId ShaderGenVars::lightConfigData("$inLightConfigData");
+const GFXShaderConstId ShaderGenVars::lightSpotDir("$inLightSpotDir");
+const GFXShaderConstId ShaderGenVars::lightSpotParams("$lightSpotParams");
 
-const String ShaderGenVars::hasVectorLight("$hasVectorLight");
-const String ShaderGenVars::vectorLightDirection("$vectorLightDirection");
-const String ShaderGenVars::vectorLightColor("$vectorLightColor");
-const String ShaderGenVars::vectorLightBrightness("$vectorLightBrightness");
+const GFXShaderConstId ShaderGenVars::hasVectorLight("$hasVectorLight");
+const GFXShaderConstId ShaderGenVars::vectorLightDirection("$vectorLightDirection");
+const GFXShaderConstId ShaderGenVars::vectorLightColor("$vectorLightColor");
+const GFXShaderConstId ShaderGenVars::vectorLightBrightness("$vectorLightBrightness");
 
-const String ShaderGenVars::ormConfig("$ORMConfig");
-const String ShaderGenVars::roughness("$roughness");
-const String ShaderGenVars::metalness("$metalness");
-const String ShaderGenVars::glowMul("$glowMul");
+const GFXShaderConstId ShaderGenVars::ormConfig("$ORMConfig");
+const GFXShaderConstId ShaderGenVars::roughness("$roughness");
+const GFXShaderConstId ShaderGenVars::metalness("$metalness");
+const GFXShaderConstId ShaderGenVars::glowMul("$glowMul");
 
 //Reflection Probes
-const String ShaderGenVars::probePosition("$inProbePosArray");
-const String ShaderGenVars::probeRefPos("$inRefPosArray");
-const String ShaderGenVars::refScale("$inRefScale");
-const String ShaderGenVars::worldToObjArray("$worldToObjArray");
-const String ShaderGenVars::probeConfigData("$probeConfigData");
-const String ShaderGenVars::specularCubemapAR("$specularCubemapAR");
-const String ShaderGenVars::irradianceCubemapAR("$irradianceCubemapAR");
-const String ShaderGenVars::probeCount("$numProbes");
+const GFXShaderConstId ShaderGenVars::probePosition("$inProbePosArray");
+const GFXShaderConstId ShaderGenVars::probeRefPos("$inRefPosArray");
+const GFXShaderConstId ShaderGenVars::refScale("$inRefScale");
+const GFXShaderConstId ShaderGenVars::worldToObjArray("$worldToObjArray");
+const GFXShaderConstId ShaderGenVars::probeConfigData("$probeConfigData");
+const GFXShaderConstId ShaderGenVars::specularCubemapAR("$specularCubemapAR");
+const GFXShaderConstId ShaderGenVars::irradianceCubemapAR("$irradianceCubemapAR");
+const GFXShaderConstId ShaderGenVars::probeCount("$numProbes");
 
-const String ShaderGenVars::BRDFTextureMap("$BRDFTexture");
+const GFXShaderConstId ShaderGenVars::BRDFTextureMap("$BRDFTexture");
 
 //Skylight
-const String ShaderGenVars::skylightCubemapIdx("$skylightCubemapIdx");
+const GFXShaderConstId ShaderGenVars::skylightCubemapIdx("$skylightCubemapIdx");
 
 // These are ignored by the D3D layers.
-const String ShaderGenVars::fogMap("$fogMap");
-const String ShaderGenVars::dlightMap("$dlightMap");
-const String ShaderGenVars::dlightMask("$dlightMask");
-const String ShaderGenVars::dlightMapSec("$dlightMapSec");
-const String ShaderGenVars::blackfogMap("$blackfogMap");
-const String ShaderGenVars::bumpMap("$bumpMap");
-const String ShaderGenVars::lightMap("$lightMap");
-const String ShaderGenVars::lightNormMap("$lightNormMap");
-const String ShaderGenVars::cubeMap("$cubeMap");
-const String ShaderGenVars::dLightMap("$dlightMap");
-const String ShaderGenVars::dLightMapSec("$dlightMapSec");
-const String ShaderGenVars::dLightMask("$dlightMask");
-const String ShaderGenVars::toneMap("$toneMap");
+const GFXShaderConstId ShaderGenVars::fogMap("$fogMap");
+const GFXShaderConstId ShaderGenVars::dlightMap("$dlightMap");
+const GFXShaderConstId ShaderGenVars::dlightMask("$dlightMask");
+const GFXShaderConstId ShaderGenVars::dlightMapSec("$dlightMapSec");
+const GFXShaderConstId ShaderGenVars::blackfogMap("$blackfogMap");
+const GFXShaderConstId ShaderGenVars::bumpMap("$bumpMap");
+const GFXShaderConstId ShaderGenVars::lightMap("$lightMap");
+const GFXShaderConstId ShaderGenVars::lightNormMap("$lightNormMap");
+const GFXShaderConstId ShaderGenVars::cubeMap("$cubeMap");
+const GFXShaderConstId ShaderGenVars::dLightMap("$dlightMap");
+const GFXShaderConstId ShaderGenVars::dLightMapSec("$dlightMapSec");
+const GFXShaderConstId ShaderGenVars::dLightMask("$dlightMask");
+const GFXShaderConstId ShaderGenVars::toneMap("$toneMap");
 
 // Deferred shading
-const String ShaderGenVars::matInfoFlags("$matInfoFlags");
+const GFXShaderConstId ShaderGenVars::matInfoFlags("$matInfoFlags");
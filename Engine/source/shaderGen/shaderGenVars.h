@@ -22,106 +22,107 @@
 #ifndef _SHADERGENVARS_H_
 #define _SHADERGENVARS_H_
 
-#ifndef _TORQUE_STRING_H_
-#include "core/util/str.h"
+#ifndef _GFXSHADERCONSTID_H_
+#include "gfx/gfxShaderConstId.h"
 #endif
 
 ///
 /// ShaderGenVars, predefined string names for variables that shadergen based shaders use, this avoids
-/// misspelling and string creation issues
+/// misspelling and string creation issues.  The names are interned so that handle lookups thru
+/// GFXShader::getShaderConstHandle() don't need to hash the string.
 ///
 struct ShaderGenVars
 {
-   const static String modelview;
-   const static String worldViewOnly;
-   const static String worldToCamera;
-   const static String cameraToWorld;
-   const static String worldToObj;
-   const static String viewToObj;
-   const static String invCameraTrans;
-   const static String cameraToScreen;
-   const static String screenToCamera;
-   const static String cubeTrans;
-   const static String cubeMips;
-   const static String objTrans;
-   const static String cubeEyePos;
-   const static String eyePos;
-   const static String eyePosWorld;
-   const static String vEye;
-   const static String eyeMat;
-   const static String oneOverFarplane;
-   const static String nearPlaneWorld;
-   const static String fogData;
-   const static String fogColor;
-   const static String detailScale;
-   const static String visibility;
-   const static String colorMultiply;
-   const static String alphaTestValue;
-   const static String texMat;
-   const static String accumTime;
-   const static String minnaertConstant;
-   const static String subSurfaceParams;
+   const static GFXShaderConstId modelview;
+   const static GFXShaderConstId worldViewOnly;
+   const static GFXShaderConstId worldToCamera;
+   const static GFXShaderConstId cameraToWorld;
+   const static GFXShaderConstId worldToObj;
+   const static GFXShaderConstId viewToObj;
+   const static GFXShaderConstId invCameraTrans;
+   const static GFXShaderConstId cameraToScreen;
+   const static GFXShaderConstId screenToCamera;
+   const static GFXShaderConstId cubeTrans;
+   const static GFXShaderConstId cubeMips;
+   const static GFXShaderConstId objTrans;
+   const static GFXShaderConstId cubeEyePos;
+   const static GFXShaderConstId eyePos;
+   const static GFXShaderConstId eyePosWorld;
+   const static GFXShaderConstId vEye;
+   const static GFXShaderConstId eyeMat;
+   const static GFXShaderConstId oneOverFarplane;
+   const static GFXShaderConstId nearPlaneWorld;
+   const static GFXShaderConstId fogData;
+   const static GFXShaderConstId fogColor;
+   const static GFXShaderConstId detailScale;
+   const static GFXShaderConstId visibility;
+   const static GFXShaderConstId colorMultiply;
+   const static GFXShaderConstId alphaTestValue;
+   const static GFXShaderConstId texMat;
+   const static GFXShaderConstId accumTime;
+   const static GFXShaderConstId minnaertConstant;
+   const static GFXShaderConstId subSurfaceParams;
 
    // Texture atlasing parameters
-   const static String diffuseAtlasParams;
-   const static String diffuseAtlasTileParams;
-   const static String bumpAtlasParams;
-   const static String bumpAtlasTileParams;
+   const static GFXShaderConstId diffuseAtlasParams;
+   const static GFXShaderConstId diffuseAtlasTileParams;
+   const static GFXShaderConstId bumpAtlasParams;
+   const static GFXShaderConstId bumpAtlasTileParams;
 
    // Render target parameters
-   const static String targetSize;
-   const static String oneOverTargetSize;
+   const static GFXShaderConstId targetSize;
+   const static GFXShaderConstId oneOverTargetSize;
 
    // Lighting parameters used by the default
    // RTLighting shader feature.
-   const static String lightPosition;
-   const static String lightDiffuse;
-   const static String lightAmbient;
-   const static String lightConfigData;
-   const static String lightSpotDir;
-   const static String lightSpotParams;
-   const static String hasVectorLight;
-   const static String vectorLightDirection;
-   const static String vectorLightColor;
-   const static String vectorLightBrightness;
+   const static GFXShaderConstId lightPosition;
+   const static GFXShaderConstId lightDiffuse;
+   const static GFXShaderConstId lightAmbient;
+   const static GFXShaderConstId lightConfigData;
+   const static GFXShaderConstId lightSpotDir;
+   const static GFXShaderConstId lightSpotParams;
+   const static GFXShaderConstId hasVectorLight;
+   const static GFXShaderConstId vectorLightDirection;
+   const static GFXShaderConstId vectorLightColor;
+   const static GFXShaderConstId vectorLightBrightness;
 
-   const static String ormConfig;
-   const static String roughness;
-   const static String metalness;
-   const static String glowMul;
+   const static GFXShaderConstId ormConfig;
+   const static GFXShaderConstId roughness;
+   const static GFXShaderConstId metalness;
+   const static GFXShaderConstId glowMul;
 
    //Reflection Probes
-   const static String probePosition;
-   const static String probeRefPos;
-   const static String refScale;
-   const static String worldToObjArray;
-   const static String probeConfigData;
-   const static String specularCubemapAR;
-   const static String irradianceCubemapAR;
-   const static String probeCount;
+   const static GFXShaderConstId probePosition;
+   const static GFXShaderConstId probeRefPos;
+   const static GFXShaderConstId refScale;
+   const static GFXShaderConstId worldToObjArray;
+   const static GFXShaderConstId probeConfigData;
+   const static GFXShaderConstId specularCubemapAR;
+   const static GFXShaderConstId irradianceCubemapAR;
+   const static GFXShaderConstId probeCount;
 
-   const static String BRDFTextureMap;
+   const static GFXShaderConstId BRDFTextureMap;
 
    //Skylight
-   const static String skylightCubemapIdx;
+   const static GFXShaderConstId skylightCubemapIdx;
    
    // Textures
-   const static String fogMap;
-   const static String dlightMap;
-   const static String dlightMask;
-   const static String dlightMapSec;
-   const static String blackfogMap;
-   const static String bumpMap;
-   const static String lightMap;
-   const static String lightNormMap;
-   const static String cubeMap;
-   const static String dLightMap;
-   const static String dLightMapSec;
-   const static String dLightMask;
-   const static String toneMap;
+   const static GFXShaderConstId fogMap;
+   const static GFXShaderConstId dlightMap;
+   const static GFXShaderConstId dlightMask;
+   const static GFXShaderConstId dlightMapSec;
+   const static GFXShaderConstId blackfogMap;
+   const static GFXShaderConstId bumpMap;
+   const static GFXShaderConstId lightMap;
+   const static GFXShaderConstId lightNormMap;
+   const static GFXShaderConstId cubeMap;
+   const static GFXShaderConstId dLightMap;
+   const static GFXShaderConstId dLightMapSec;
+   const static GFXShaderConstId dLightMask;
+   const static GFXShaderConstId toneMap;
 
    // Deferred Shading
-   const static String matInfoFlags;
+   const static GFXShaderConstId matInfoFlags;
 };
 
 #endif
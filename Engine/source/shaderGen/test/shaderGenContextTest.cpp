@@ -0,0 +1,122 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2014 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "shaderGen/shaderGenContext.h"
+#include "shaderGen/langElement.h"
+#include "platform/threads/threadPoolBatch.h"
+
+FIXTURE(ShaderGenContext)
+{
+public:
+   // Builds a set of named elements in its own context like
+   // a shader being generated on a worker thread would.
+   struct BuildItem : public ThreadPoolBatch::Item
+   {
+      U32 mIndex;
+      U32 mCount;
+      bool mFoundAll;
+
+      BuildItem(U32 index, U32 count)
+         : mIndex(index), mCount(count), mFoundAll(false) {}
+
+   protected:
+      virtual void executeItem()
+      {
+         ShaderGenContext context;
+         ShaderGenContext::Scope scope(&context);
+
+         for (U32 i = 0; i < mCount; i++)
+         {
+            Var *var = new Var;
+            var->setName(avar("var%d_%d", mIndex, i));
+         }
+
+         mFoundAll = LangElement::getElements().size() == mCount;
+         for (U32 i = 0; i < mCount; i++)
+         {
+            if (!LangElement::find(avar("var%d_%d", mIndex, i)))
+               mFoundAll = false;
+         }
+
+         // Nothing from the other items should be visible.
+         if (LangElement::find(avar("var%d_0", mIndex + 1)))
+            mFoundAll = false;
+      }
+   };
+};
+
+TEST_FIX(ShaderGenContext, Isolation)
+{
+   ShaderGenContext first;
+   ShaderGenContext second;
+
+   {
+      ShaderGenContext::Scope scope(&first);
+      Var *var = new Var;
+      EXPECT_STREQ((const char*)var->name, "tempName0");
+      var->setName("foo");
+      EXPECT_EQ(Var::getTexUnitNum(2), 0);
+      EXPECT_EQ(Var::getTexUnitNum(), 2);
+   }
+
+   {
+      ShaderGenContext::Scope scope(&second);
+      EXPECT_TRUE(LangElement::find("foo") == NULL);
+      EXPECT_EQ(Var::getTexUnitNum(), 0);
+
+      // Temporary names are numbered per context
+      // so the generated code doesn't depend on order.
+      Var *var = new Var;
+      EXPECT_STREQ((const char*)var->name, "tempName0");
+   }
+
+   {
+      ShaderGenContext::Scope scope(&first);
+      EXPECT_TRUE(LangElement::find("foo") != NULL);
+   }
+
+   EXPECT_EQ(first.mElements.size(), 1);
+   first.deleteElements();
+   EXPECT_EQ(first.mElements.size(), 0);
+}
+
+TEST_FIX(ShaderGenContext, Threaded)
+{
+   const U32 numItems = 32;
+   Vector< ThreadSafeRef<BuildItem> > items;
+
+   ThreadPoolBatch batch;
+   for (U32 i = 0; i < numItems; i++)
+   {
+      items.push_back(new BuildItem(i, 200));
+      batch.add(items.last());
+   }
+
+   batch.wait();
+
+   for (U32 i = 0; i < numItems; i++)
+      EXPECT_TRUE(items[i]->mFoundAll) << "elements leaked between contexts";
+}
+
+#endif
@@ -0,0 +1,162 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+
+#if (defined( TORQUE_CPU_X86 ) || defined( TORQUE_CPU_X64 ))
+#include "terrain/terrIntrinsics.h"
+#include "terrain/arch/terrIntrinsics.arch.h"
+#include "math/mPoint2.h"
+#include "math/mPoint3.h"
+#include <emmintrin.h>
+
+static inline __m128 _select( const __m128 &mask, const __m128 &a, const __m128 &b )
+{
+   return _mm_or_ps( _mm_and_ps( mask, a ), _mm_andnot_ps( mask, b ) );
+}
+
+void terrain_sample_SSE2( const TerrainSampleGrid &grid, const Point2F *positions, U32 count,
+                          F32 *outHeights, Point3F *outNormals, bool normalize, bool *outValid )
+{
+   const F32 invSquareSize = 1.0f / grid.squareSize;
+   const U32 blockMask = grid.size - 1;
+
+   const __m128 vInvSquareSize = _mm_set1_ps( invSquareSize );
+   const __m128 vSquareSize = _mm_set1_ps( grid.squareSize );
+   const __m128 vFixedToFloat = _mm_set1_ps( 0.03125f );
+   const __m128 vOne = _mm_set1_ps( 1.0f );
+
+   // The gathered corner heights and flags for four positions.
+   S32 bottomLeft[4];
+   S32 bottomRight[4];
+   S32 topLeft[4];
+   S32 topRight[4];
+   S32 split[4];
+   S32 valid[4];
+   S32 ix[4];
+   S32 iy[4];
+   F32 nx[4];
+   F32 ny[4];
+   F32 nz[4];
+
+   const U32 end = count & ~3;
+   for ( U32 i = 0; i < end; i += 4 )
+   {
+      // Deinterleave the four positions.
+      const __m128 a = _mm_loadu_ps( &positions[i].x );
+      const __m128 b = _mm_loadu_ps( &positions[i+2].x );
+      __m128 xp = _mm_mul_ps( _mm_shuffle_ps( a, b, _MM_SHUFFLE( 2, 0, 2, 0 ) ), vInvSquareSize );
+      __m128 yp = _mm_mul_ps( _mm_shuffle_ps( a, b, _MM_SHUFFLE( 3, 1, 3, 1 ) ), vInvSquareSize );
+
+      const __m128i x = _mm_cvttps_epi32( xp );
+      const __m128i y = _mm_cvttps_epi32( yp );
+      xp = _mm_sub_ps( xp, _mm_cvtepi32_ps( x ) );
+      yp = _mm_sub_ps( yp, _mm_cvtepi32_ps( y ) );
+      _mm_storeu_si128( (__m128i*)ix, x );
+      _mm_storeu_si128( (__m128i*)iy, y );
+
+      // There is no gather in SSE2 so fetch the
+      // square corners one position at a time.
+      for ( U32 n = 0; n < 4; n++ )
+      {
+         const U32 sx = ix[n] & blockMask;
+         const U32 sy = iy[n] & blockMask;
+         const U32 sx1 = ( sx + 1 ) & blockMask;
+         const U32 sy1 = ( sy + 1 ) & blockMask;
+
+         const U16 flags = grid.squares[ sx + sy * grid.size ].flags;
+         valid[n] = ( ( ix[n] & ~blockMask ) || ( iy[n] & ~blockMask ) || ( flags & TerrainSquare::Empty ) ) ? 0 : -1;
+         split[n] = ( flags & TerrainSquare::Split45 ) ? -1 : 0;
+
+         bottomLeft[n] = grid.heights[ sx + sy * grid.size ];
+         bottomRight[n] = grid.heights[ sx1 + sy * grid.size ];
+         topLeft[n] = grid.heights[ sx + sy1 * grid.size ];
+         topRight[n] = grid.heights[ sx1 + sy1 * grid.size ];
+      }
+
+      const __m128 zBottomLeft = _mm_mul_ps( _mm_cvtepi32_ps( _mm_loadu_si128( (const __m128i*)bottomLeft ) ), vFixedToFloat );
+      const __m128 zBottomRight = _mm_mul_ps( _mm_cvtepi32_ps( _mm_loadu_si128( (const __m128i*)bottomRight ) ), vFixedToFloat );
+      const __m128 zTopLeft = _mm_mul_ps( _mm_cvtepi32_ps( _mm_loadu_si128( (const __m128i*)topLeft ) ), vFixedToFloat );
+      const __m128 zTopRight = _mm_mul_ps( _mm_cvtepi32_ps( _mm_loadu_si128( (const __m128i*)topRight ) ), vFixedToFloat );
+      const __m128 isSplit45 = _mm_loadu_ps( (const F32*)split );
+      const __m128 isValid = _mm_loadu_ps( (const F32*)valid );
+
+      // Pick the triangle of the square each position is over.
+      const __m128 invXp = _mm_sub_ps( vOne, xp );
+      const __m128 isBottom = _select( isSplit45, _mm_cmpgt_ps( xp, yp ), _mm_cmpgt_ps( invXp, yp ) );
+
+      const __m128 leftDiff = _mm_sub_ps( zBottomLeft, zTopLeft );
+      const __m128 rightDiff = _mm_sub_ps( zTopRight, zBottomRight );
+      const __m128 bottomDiff = _mm_sub_ps( zBottomRight, zBottomLeft );
+      const __m128 topDiff = _mm_sub_ps( zTopRight, zTopLeft );
+
+      // Split45: bottom is BL + xp * (BR-BL) + yp * (TR-BR)
+      //          top is BL + xp * (TR-TL) + yp * (TL-BL)
+      const __m128 height45 = _mm_add_ps( _mm_add_ps( zBottomLeft,
+                                 _mm_mul_ps( xp, _select( isBottom, bottomDiff, topDiff ) ) ),
+                                 _mm_mul_ps( yp, _select( isBottom, rightDiff, _mm_sub_ps( zTopLeft, zBottomLeft ) ) ) );
+
+      // Split135: bottom is BR + (1-xp) * (BL-BR) + yp * (TL-BL)
+      //           top is BR + (1-xp) * (TL-TR) + yp * (TR-BR)
+      const __m128 height135 = _mm_add_ps( _mm_add_ps( zBottomRight,
+                                 _mm_mul_ps( invXp, _select( isBottom, _mm_sub_ps( zBottomLeft, zBottomRight ), _mm_sub_ps( zTopLeft, zTopRight ) ) ) ),
+                                 _mm_mul_ps( yp, _select( isBottom, _mm_sub_ps( zTopLeft, zBottomLeft ), rightDiff ) ) );
+
+      const __m128 height = _mm_and_ps( isValid, _select( isSplit45, height45, height135 ) );
+      _mm_storeu_ps( outHeights + i, height );
+
+      for ( U32 n = 0; n < 4; n++ )
+         outValid[i+n] = valid[n] != 0;
+
+      if ( !outNormals )
+         continue;
+
+      // The x slope is the same for both splits and the y slope
+      // swaps sides between the bottom of one and the top of the other.
+      __m128 normalX = _select( isBottom, _mm_sub_ps( zBottomLeft, zBottomRight ), _mm_sub_ps( zTopLeft, zTopRight ) );
+      __m128 normalY = _select( _mm_xor_ps( isSplit45, isBottom ), leftDiff, _mm_sub_ps( zBottomRight, zTopRight ) );
+      __m128 normalZ = vSquareSize;
+
+      if ( normalize )
+      {
+         const __m128 lenSq = _mm_add_ps( _mm_add_ps( _mm_mul_ps( normalX, normalX ),
+                                                      _mm_mul_ps( normalY, normalY ) ),
+                                                      _mm_mul_ps( normalZ, normalZ ) );
+         const __m128 factor = _mm_div_ps( vOne, _mm_sqrt_ps( lenSq ) );
+         normalX = _mm_mul_ps( normalX, factor );
+         normalY = _mm_mul_ps( normalY, factor );
+         normalZ = _mm_mul_ps( normalZ, factor );
+      }
+
+      _mm_storeu_ps( nx, _mm_and_ps( isValid, normalX ) );
+      _mm_storeu_ps( ny, _mm_and_ps( isValid, normalY ) );
+      _mm_storeu_ps( nz, _select( isValid, normalZ, vOne ) );
+
+      for ( U32 n = 0; n < 4; n++ )
+         outNormals[i+n].set( nx[n], ny[n], nz[n] );
+   }
+
+   terrain_sample_C( grid, positions + end, count & 3, outHeights + end,
+                     outNormals ? outNormals + end : NULL, normalize, outValid + end );
+}
+
+#endif // TORQUE_CPU_X86 || TORQUE_CPU_X64
@@ -220,7 +220,7 @@ void TerrainBaseMapFeatGLSL::processVert( Vector<ShaderComponent*> &componentLis
                                           const MaterialFeatureData &fd )
 {
    MultiLine *meta = new MultiLine;
-   output = meta;
+   setOutput( meta );
 
    // Generate the incoming texture var.
    Var *inTex;
@@ -331,7 +331,7 @@ void TerrainBaseMapFeatGLSL::processPix(  Vector<ShaderComponent*> &componentLis
 
    meta->addStatement(new GenOp("   @ = float4(0.0, 1.0, 1.0, 0.0);\r\n", ormConfig));
 
-   output = meta;
+   setOutput( meta );
 }
 
 ShaderFeature::Resources TerrainBaseMapFeatGLSL::getResources( const MaterialFeatureData &fd )
@@ -446,7 +446,7 @@ void TerrainDetailMapFeatGLSL::processVert(  Vector<ShaderComponent*> &component
    meta->addStatement( new GenOp( "   @.w = clamp( ( @.z - @ ) * @.w, 0.0, 1.0 );\r\n", 
                                     outTex, new IndexOp(detScaleAndFade, detailIndex), dist, new IndexOp(detScaleAndFade, detailIndex)) );
 
-   output = meta;
+   setOutput( meta );
 }
 
 void TerrainDetailMapFeatGLSL::processPix(   Vector<ShaderComponent*> &componentList, 
@@ -613,7 +613,7 @@ void TerrainDetailMapFeatGLSL::processPix(   Vector<ShaderComponent*> &component
       meta->addStatement(new GenOp("   }\r\n"));
    }
 
-   output = meta;
+   setOutput( meta );
 }
 
 ShaderFeature::Resources TerrainDetailMapFeatGLSL::getResources( const MaterialFeatureData &fd )
@@ -704,7 +704,7 @@ void TerrainMacroMapFeatGLSL::processVert(  Vector<ShaderComponent*> &componentL
    meta->addStatement( new GenOp( "   @.w = clamp( ( @.z - @ ) * @.w, 0.0, 1.0 );\r\n", 
                                     outTex, detScaleAndFade, dist, detScaleAndFade ) );   
 
-   output = meta;
+   setOutput( meta );
 }
 
 
@@ -843,7 +843,7 @@ void TerrainMacroMapFeatGLSL::processPix(   Vector<ShaderComponent*> &componentL
 
    meta->addStatement( new GenOp( "   }\r\n" ) );
 
-   output = meta;
+   setOutput( meta );
 }
 
 
@@ -889,7 +889,7 @@ void TerrainNormalMapFeatGLSL::processVert(  Vector<ShaderComponent*> &component
       getOutViewToTangent(componentList, meta, fd);
    }
 
-   output = meta;
+   setOutput( meta );
 }
 
 void TerrainNormalMapFeatGLSL::processPix(   Vector<ShaderComponent*> &componentList, 
@@ -966,7 +966,7 @@ void TerrainNormalMapFeatGLSL::processPix(   Vector<ShaderComponent*> &component
       meta->addStatement(new GenOp("   }\r\n"));
    }
 
-   output = meta;
+   setOutput( meta );
 }
 
 ShaderFeature::Resources TerrainNormalMapFeatGLSL::getResources( const MaterialFeatureData &fd )
@@ -1030,7 +1030,7 @@ void TerrainLightMapFeatGLSL::processPix( Vector<ShaderComponent*> &componentLis
    }
 
    meta->addStatement( new GenOp( "   @[0] = tex2D( @, @.xy ).r;\r\n", lightMask, lightMap, inTex ) );
-   output = meta;
+   setOutput( meta );
 }
 
 ShaderFeature::Resources TerrainLightMapFeatGLSL::getResources( const MaterialFeatureData &fd )
@@ -1135,7 +1135,7 @@ void TerrainORMMapFeatGLSL::processVert(Vector<ShaderComponent*> &componentList,
 	meta->addStatement(new GenOp("   @.w = clamp( ( @.z - @ ) * @.w, 0.0, 1.0 );\r\n",
 		outTex, new IndexOp(detScaleAndFade, detailIndex), dist, new IndexOp(detScaleAndFade, detailIndex)));
 
-	output = meta;
+	setOutput( meta );
 }
 
 U32 TerrainORMMapFeatGLSL::getOutputTargets(const MaterialFeatureData &fd) const
@@ -1212,7 +1212,7 @@ void TerrainORMMapFeatGLSL::processPix(Vector<ShaderComponent*> &componentList,
       meta->addStatement(new GenOp("   @.gba += @ * @;\r\n", ormConfig, matinfoCol, detailBlend));
    }
 
-	output = meta;
+	setOutput( meta );
 }
 
 ShaderFeature::Resources TerrainORMMapFeatGLSL::getResources(const MaterialFeatureData &fd)
@@ -1279,7 +1279,7 @@ void TerrainBlankInfoMapFeatGLSL::processPix(Vector<ShaderComponent*> &component
 
    meta->addStatement(new GenOp("   @.gba += vec3(@, @, 0.0);\r\n", material, detailBlend, detailBlend));
 
-   output = meta;
+   setOutput( meta );
 }
 
 void TerrainHeightMapBlendGLSL::processVert(
@@ -1298,7 +1298,7 @@ void TerrainHeightMapBlendGLSL::processVert(
       getOutViewToTangent(componentList, meta, fd);
    }
 
-   output = meta;
+   setOutput( meta );
 }
 
 void TerrainHeightMapBlendGLSL::processPix(Vector<ShaderComponent*>& componentList,
@@ -1639,5 +1639,5 @@ void TerrainHeightMapBlendGLSL::processPix(Vector<ShaderComponent*>& componentLi
    }
 
 
-   output = meta;
+   setOutput( meta );
 }
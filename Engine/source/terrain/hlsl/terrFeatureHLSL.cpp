@@ -274,7 +274,7 @@ void TerrainBaseMapFeatHLSL::processVert( Vector<ShaderComponent*> &componentLis
                                           const MaterialFeatureData &fd )
 {
    MultiLine *meta = new MultiLine;
-   output = meta;
+   setOutput( meta );
 
    // Generate the incoming texture var.
    Var *inTex;
@@ -393,7 +393,7 @@ void TerrainBaseMapFeatHLSL::processPix(  Vector<ShaderComponent*> &componentLis
       meta->addStatement(new GenOp("   @ = float4(0.0, 1.0, 1.0, 0.0);\r\n", ormConfig));
    }
 
-   output = meta;
+   setOutput( meta );
 }
 
 ShaderFeature::Resources TerrainBaseMapFeatHLSL::getResources( const MaterialFeatureData &fd )
@@ -506,7 +506,7 @@ void TerrainDetailMapFeatHLSL::processVert(  Vector<ShaderComponent*> &component
    meta->addStatement( new GenOp( "   @.w = clamp( ( @.z - @ ) * @.w, 0.0, 1.0 );\r\n", 
                                     outTex, new IndexOp(detScaleAndFade, detailIndex), dist, new IndexOp(detScaleAndFade, detailIndex)) );
 
-   output = meta;
+   setOutput( meta );
 }
 
 void TerrainDetailMapFeatHLSL::processPix(   Vector<ShaderComponent*> &componentList, 
@@ -679,7 +679,7 @@ void TerrainDetailMapFeatHLSL::processPix(   Vector<ShaderComponent*> &component
       meta->addStatement(new GenOp("   }\r\n"));
    }
 
-   output = meta;
+   setOutput( meta );
 }
 
 ShaderFeature::Resources TerrainDetailMapFeatHLSL::getResources( const MaterialFeatureData &fd )
@@ -776,7 +776,7 @@ void TerrainMacroMapFeatHLSL::processVert(  Vector<ShaderComponent*> &componentL
    meta->addStatement( new GenOp( "   @.w = clamp( ( @.z - @ ) * @.w, 0.0, 1.0 );\r\n", 
                                     outTex, new IndexOp(macroScaleAndFade, detailIndex), dist, new IndexOp(macroScaleAndFade, detailIndex)) );
 
-   output = meta;
+   setOutput( meta );
 }
 
 
@@ -932,7 +932,7 @@ void TerrainMacroMapFeatHLSL::processPix(   Vector<ShaderComponent*> &componentL
 
    meta->addStatement( new GenOp( "   }\r\n" ) );
 
-   output = meta;
+   setOutput( meta );
 }
 
 ShaderFeature::Resources TerrainMacroMapFeatHLSL::getResources( const MaterialFeatureData &fd )
@@ -976,7 +976,7 @@ void TerrainNormalMapFeatHLSL::processVert(  Vector<ShaderComponent*> &component
       getOutViewToTangent(componentList, meta, fd);
    }
 
-   output = meta;
+   setOutput( meta );
 }
 
 void TerrainNormalMapFeatHLSL::processPix(   Vector<ShaderComponent*> &componentList, 
@@ -1054,7 +1054,7 @@ void TerrainNormalMapFeatHLSL::processPix(   Vector<ShaderComponent*> &component
       meta->addStatement(new GenOp("   }\r\n"));
    }
    
-   output = meta;
+   setOutput( meta );
 }
 
 ShaderFeature::Resources TerrainNormalMapFeatHLSL::getResources( const MaterialFeatureData &fd )
@@ -1123,7 +1123,7 @@ void TerrainLightMapFeatHLSL::processPix( Vector<ShaderComponent*> &componentLis
    lightMapTex->constNum = lightMap->constNum;
    meta->addStatement(new GenOp("   @[0] = @.Sample( @, @.xy ).r;\r\n", lightMask, lightMapTex, lightMap, inTex));
 
-   output = meta;
+   setOutput( meta );
 }
 
 ShaderFeature::Resources TerrainLightMapFeatHLSL::getResources( const MaterialFeatureData &fd )
@@ -1226,7 +1226,7 @@ void TerrainORMMapFeatHLSL::processVert(Vector<ShaderComponent*> &componentList,
    meta->addStatement(new GenOp("   @.w = clamp( ( @.z - @ ) * @.w, 0.0, 1.0 );\r\n",
       outTex, new IndexOp(detScaleAndFade, detailIndex), dist, new IndexOp(detScaleAndFade, detailIndex)));
 
-   output = meta;
+   setOutput( meta );
 }
 
 U32 TerrainORMMapFeatHLSL::getOutputTargets(const MaterialFeatureData &fd) const
@@ -1303,7 +1303,7 @@ void TerrainORMMapFeatHLSL::processPix(Vector<ShaderComponent*> &componentList,
       meta->addStatement(new GenOp("   @.gba += @ * @;\r\n", ormConfig, matinfoCol, detailBlend));
    }
 
-   output = meta;
+   setOutput( meta );
 }
 
 ShaderFeature::Resources TerrainORMMapFeatHLSL::getResources(const MaterialFeatureData &fd)
@@ -1358,7 +1358,7 @@ void TerrainBlankInfoMapFeatHLSL::processPix(Vector<ShaderComponent*> &component
       meta->addStatement(new GenOp("   @.gba += float3(@, @, 0.0);\r\n", material, detailBlend, detailBlend));
    }
 
-   output = meta;
+   setOutput( meta );
 }
 
 void TerrainHeightMapBlendHLSL::processVert(Vector<ShaderComponent*>& componentList,
@@ -1378,7 +1378,7 @@ void TerrainHeightMapBlendHLSL::processVert(Vector<ShaderComponent*>& componentL
       getOutViewToTangent(componentList, meta, fd);
    }
 
-   output = meta;
+   setOutput( meta );
 }
 
 void TerrainHeightMapBlendHLSL::processPix(Vector<ShaderComponent*>& componentList,
@@ -1718,5 +1718,5 @@ void TerrainHeightMapBlendHLSL::processPix(Vector<ShaderComponent*>& componentLi
    }
 
 
-   output = meta;
+   setOutput( meta );
 }
@@ -26,10 +26,16 @@
 #include "terrain/terrData.h"
 #include "collision/abstractPolyList.h"
 #include "collision/collision.h"
+#include "scene/sceneCameraState.h"
+#include "platform/threads/threadPoolBatch.h"
 
 
 const F32 TerrainThickness = 0.5f;
 static const U32 MaxExtent = 256;
+
+/// The maximum number of squares along each side of the
+/// coarse grid used for occlusion.
+static const U32 OccluderGridSize = 64;
 #define MAX_FLOAT 1e20f
 
 
@@ -378,6 +384,8 @@ void TerrainBlock::buildConvex(const Box3F& box,Convex* convex)
 
    const U32 BlockMask = mFile->mSize - 1;
 
+   mFile->pageIn( Point2I( xStart, yStart ), Point2I( xEnd, yEnd ) );
+
    for ( S32 y = yStart; y < yEnd; y++ ) 
    {
       S32 yi = y & BlockMask;
@@ -523,6 +531,8 @@ bool TerrainBlock::buildPolyList(PolyListContext context, AbstractPolyList* poly
    U32 heightMax = floatToFixed(osBox.maxExtents.z);
    U32 heightMin = (osBox.minExtents.z < 0.0f)? 0.0f: floatToFixed(osBox.minExtents.z);
 
+   mFile->pageIn( Point2I( xStart, yStart ), Point2I( xEnd, yEnd ) );
+
    // Index of shared points
    U32 bp[(MaxExtent + 1) * 2],*vb[2];
    vb[0] = &bp[0];
@@ -612,21 +622,141 @@ bool TerrainBlock::buildPolyList(PolyListContext context, AbstractPolyList* poly
 
 //----------------------------------------------------------------------------
 
-static F32 calcInterceptV(F32 vStart, F32 invDeltaV, F32 intercept)
+/// Returns the lowest height within a grid square or false
+/// if there are holes in the square.
+static bool getOccluderSquareHeight( const TerrainFile *file, U32 level, S32 x, S32 y, F32 *outHeight )
 {
-   return (intercept - vStart) * invDeltaV;
+   const TerrainSquare *sq = file->findSquare( level, x << level, y << level );
+   if ( sq->flags & ( TerrainSquare::Empty | TerrainSquare::HasEmpty ) )
+      return false;
+
+   *outHeight = fixedToFloat( sq->minHeight );
+   return true;
 }
 
-static F32 calcInterceptNone(F32, F32, F32)
+bool TerrainBlock::buildOccluderPolyList( const SceneCameraState &cameraState, AbstractPolyList *polyList, const Box3F &box )
 {
-   return MAX_FLOAT;
+   PROFILE_SCOPE( TerrainBlock_buildOccluderPolyList );
+
+   // The terrain is rendered single sided so from
+   // below the surface you can see right through it.
+   Point3F camPos = cameraState.getViewPosition();
+   mWorldToObj.mulP( camPos );
+
+   F32 camHeight;
+   if ( getHeight( Point2F( camPos.x, camPos.y ), &camHeight ) && camPos.z < camHeight )
+      return false;
+
+   // Use a coarse grid level to keep rasterization cheap.  Every
+   // grid square becomes a flat top at the lowest height within the
+   // square and the steps between neighboring squares are closed
+   // with walls.  All of it stays below the actual terrain surface.
+   const TerrainFile *file = mFile;
+   const U32 blockSize = file->mSize;
+
+   U32 level = 0;
+   while ( ( blockSize >> level ) > OccluderGridSize )
+      level++;
+
+   const S32 gridSize = blockSize >> level;
+   const F32 cellSize = mSquareSize * (F32)( 1 << level );
+
+   Box3F osBox = box;
+   mWorldToObj.mul( osBox );
+
+   if (  osBox.maxExtents.x < 0.0f || osBox.maxExtents.y < 0.0f ||
+         osBox.minExtents.x > gridSize * cellSize || osBox.minExtents.y > gridSize * cellSize )
+      return false;
+
+   const S32 xStart = mClamp( (S32)mFloor( osBox.minExtents.x / cellSize ), 0, gridSize - 1 );
+   const S32 xEnd   = mClamp( (S32)mFloor( osBox.maxExtents.x / cellSize ), 0, gridSize - 1 );
+   const S32 yStart = mClamp( (S32)mFloor( osBox.minExtents.y / cellSize ), 0, gridSize - 1 );
+   const S32 yEnd   = mClamp( (S32)mFloor( osBox.maxExtents.y / cellSize ), 0, gridSize - 1 );
+
+   polyList->setTransform( &getTransform(), getScale() );
+   polyList->setObject( this );
+
+   bool emitted = false;
+   for ( S32 y = yStart; y <= yEnd; y++ )
+   {
+      for ( S32 x = xStart; x <= xEnd; x++ )
+      {
+         F32 height;
+         if ( !getOccluderSquareHeight( file, level, x, y, &height ) )
+            continue;
+
+         const F32 x0 = x * cellSize, x1 = x0 + cellSize;
+         const F32 y0 = y * cellSize, y1 = y0 + cellSize;
+
+         // The top only hides things when seen from above.
+         if ( camPos.z > height )
+         {
+            U32 base = polyList->addPoint( Point3F( x0, y0, height ) );
+            polyList->addPoint( Point3F( x1, y0, height ) );
+            polyList->addPoint( Point3F( x1, y1, height ) );
+            polyList->addPoint( Point3F( x0, y1, height ) );
+
+            polyList->begin( NULL, 0 );
+            polyList->vertex( base );
+            polyList->vertex( base + 1 );
+            polyList->vertex( base + 2 );
+            polyList->vertex( base + 3 );
+            polyList->plane( base, base + 1, base + 2 );
+            polyList->end();
+
+            emitted = true;
+         }
+
+         // The walls to the next squares in x and y.
+         for ( U32 i = 0; i < 2; i++ )
+         {
+            const S32 nx = x + ( i == 0 ? 1 : 0 );
+            const S32 ny = y + ( i == 1 ? 1 : 0 );
+
+            F32 neighborHeight;
+            if (  nx >= gridSize || ny >= gridSize ||
+                  !getOccluderSquareHeight( file, level, nx, ny, &neighborHeight ) ||
+                  neighborHeight == height )
+               continue;
+
+            const F32 lo = getMin( height, neighborHeight );
+            const F32 hi = getMax( height, neighborHeight );
+
+            const Point3F start( i == 0 ? x1 : x0, i == 0 ? y0 : y1, 0.0f );
+            const Point3F end( x1, y1, 0.0f );
+
+            U32 base = polyList->addPoint( Point3F( start.x, start.y, lo ) );
+            polyList->addPoint( Point3F( end.x, end.y, lo ) );
+            polyList->addPoint( Point3F( end.x, end.y, hi ) );
+            polyList->addPoint( Point3F( start.x, start.y, hi ) );
+
+            polyList->begin( NULL, 0 );
+            polyList->vertex( base );
+            polyList->vertex( base + 1 );
+            polyList->vertex( base + 2 );
+            polyList->vertex( base + 3 );
+            polyList->plane( base, base + 1, base + 2 );
+            polyList->end();
+
+            emitted = true;
+         }
+      }
+   }
+
+   return emitted;
 }
 
-static F32 (*calcInterceptX)(F32, F32, F32);
-static F32 (*calcInterceptY)(F32, F32, F32);
+//----------------------------------------------------------------------------
+
+/// Returns the ray parameter at which the ray crosses the intercept
+/// along one axis, or MAX_FLOAT if the ray is parallel to it.
+static inline F32 calcIntercept(F32 vStart, F32 invDeltaV, F32 intercept)
+{
+   if ( invDeltaV == 0 )
+      return MAX_FLOAT;
 
-static U32 lineCount;
-static Point3F lineStart, lineEnd;
+   return (intercept - vStart) * invDeltaV;
+}
 
 bool TerrainBlock::castRay(const Point3F &start, const Point3F &end, RayInfo *info)
 {
@@ -647,12 +777,129 @@ bool TerrainBlock::castRay(const Point3F &start, const Point3F &end, RayInfo *in
    return true;
 }
 
-bool TerrainBlock::castRayI(const Point3F &start, const Point3F &end, RayInfo *info, bool collideEmpty)
+/// Casts a range of the rays passed to TerrainBlock::castRays
+/// on a worker thread.
+struct TerrainRayWorkItem : public ThreadPoolBatch::Item
+{
+   TerrainBlock *mTerrain;
+   const Point3F *mStarts;
+   const Point3F *mEnds;
+   RayInfo *mInfos;
+   bool *mHits;
+   const U32 *mRays;
+   U32 mCount;
+
+   TerrainRayWorkItem(  TerrainBlock *terrain,
+                        const Point3F *starts,
+                        const Point3F *ends,
+                        RayInfo *infos,
+                        bool *hits,
+                        const U32 *rays,
+                        U32 count )
+      :  mTerrain( terrain ),
+         mStarts( starts ),
+         mEnds( ends ),
+         mInfos( infos ),
+         mHits( hits ),
+         mRays( rays ),
+         mCount( count ) {}
+
+protected:
+
+   virtual void executeItem()
+   {
+      for ( U32 i = 0; i < mCount; i++ )
+      {
+         const U32 ray = mRays[i];
+         mHits[ray] = mTerrain->castRay( mStarts[ray], mEnds[ray], &mInfos[ray] );
+      }
+   }
+};
+
+U32 TerrainBlock::castRays(   const Point3F *starts, 
+                              const Point3F *ends, 
+                              U32 count, 
+                              RayInfo *outInfos, 
+                              bool *outHits )
 {
-   lineCount = 0;
-   lineStart = start;
-   lineEnd = end;
+   PROFILE_SCOPE( TerrainBlock_castRays );
+
+   // Test each ray against the root of the grid map first.  Only
+   // the first tile of the block can be hit, so rays entirely to
+   // one side of it or entirely above or below its height range
+   // never need to walk the quadtree.
+   const TerrainSquare *root = mFile->mGridMap[ mFile->mGridLevels ];
+   const F32 minHeight = fixedToFloat( root->minHeight );
+   const F32 maxHeight = fixedToFloat( root->maxHeight );
+   const F32 blockSize = getWorldBlockSize();
+
+   Vector<U32> rays;
+   rays.reserve( count );
+
+   for ( U32 i = 0; i < count; i++ )
+   {
+      const Point3F &start = starts[i];
+      const Point3F &end = ends[i];
+
+      outHits[i] = false;
+
+      const bool miss = ( start.z > maxHeight && end.z > maxHeight ) |
+                        ( start.z < minHeight && end.z < minHeight ) |
+                        ( start.x < 0.0f && end.x < 0.0f ) |
+                        ( start.y < 0.0f && end.y < 0.0f ) |
+                        ( start.x > blockSize && end.x > blockSize ) |
+                        ( start.y > blockSize && end.y > blockSize );
+      if ( !miss )
+         rays.push_back( i );
+   }
+
+   const U32 numRays = rays.size();
+
+   ThreadPool &pool = ThreadPool::GLOBAL();
+
+   U32 numRanges = 1;
+   if ( smParallelRayThreshold > 0 && numRays >= U32( smParallelRayThreshold ) )
+   {
+      const U32 minRaysPerRange = getMax( U32( smParallelRayThreshold ) / 2, 1U );
+      numRanges = mClamp( numRays / minRaysPerRange, 1, pool.getNumThreads() + 1 );
+   }
+
+   if ( numRanges < 2 )
+   {
+      for ( U32 i = 0; i < numRays; i++ )
+      {
+         const U32 ray = rays[i];
+         outHits[ray] = castRay( starts[ray], ends[ray], &outInfos[ray] );
+      }
+   }
+   else
+   {
+      Vector< ThreadSafeRef< TerrainRayWorkItem > > items;
+      items.setSize( numRanges );
+
+      ThreadPoolBatch batch;
+
+      const U32 raysPerRange = numRays / numRanges;
+      U32 start = 0;
+      for ( U32 i = 0; i < numRanges; i++, start += raysPerRange )
+      {
+         const U32 rangeCount = ( i == numRanges - 1 ) ? numRays - start : raysPerRange;
+         items[i] = new TerrainRayWorkItem( this, starts, ends, outInfos, outHits, rays.address() + start, rangeCount );
+         batch.add( items[i] );
+      }
+
+      batch.wait();
+   }
+
+   U32 numHits = 0;
+   for ( U32 i = 0; i < numRays; i++ )
+      numHits += outHits[ rays[i] ];
 
+   return numHits;
+}
+
+bool TerrainBlock::castRayI(const Point3F &start, const Point3F &end, RayInfo *info, bool collideEmpty)
+{
    info->object = this;
 
    if(start.x == end.x && start.y == end.y)
@@ -685,14 +932,12 @@ bool TerrainBlock::castRayI(const Point3F &start, const Point3F &end, RayInfo *i
    F32 invDeltaX;
    if(pEnd.x == pStart.x)
    {
-      calcInterceptX = calcInterceptNone;
       invDeltaX = 0;
       dx = 0;
    }
    else
    {
       invDeltaX = 1 / (pEnd.x - pStart.x);
-      calcInterceptX = calcInterceptV;
       if(pEnd.x < pStart.x)
          dx = -1;
       else
@@ -702,14 +947,12 @@ bool TerrainBlock::castRayI(const Point3F &start, const Point3F &end, RayInfo *i
    F32 invDeltaY;
    if(pEnd.y == pStart.y)
    {
-      calcInterceptY = calcInterceptNone;
       invDeltaY = 0;
       dy = 0;
    }
    else
    {
       invDeltaY = 1 / (pEnd.y - pStart.y);
-      calcInterceptY = calcInterceptV;
       if(pEnd.y < pStart.y)
          dy = -1;
       else
@@ -722,8 +965,8 @@ bool TerrainBlock::castRayI(const Point3F &start, const Point3F &end, RayInfo *i
    F32 startT = 0;
    for(;;)
    {
-      F32 nextXInt = calcInterceptX(pStart.x, invDeltaX, (F32)(blockX + (dx == 1)));
-      F32 nextYInt = calcInterceptY(pStart.y, invDeltaY, (F32)(blockY + (dy == 1)));
+      F32 nextXInt = calcIntercept(pStart.x, invDeltaX, (F32)(blockX + (dx == 1)));
+      F32 nextYInt = calcIntercept(pStart.y, invDeltaY, (F32)(blockY + (dy == 1)));
 
       F32 intersectT = 1;
 
@@ -766,6 +1009,10 @@ bool TerrainBlock::castRayI(const Point3F &start, const Point3F &end, RayInfo *i
    return false;
 }
 
+/// The deepest grid map castRayBlock can walk which
+/// allows for terrains up to 64k samples wide.
+static const U32 MaxGridLevels = 16;
+
 struct TerrLOSStackNode
 {
    F32 startT;
@@ -791,8 +1038,10 @@ bool TerrainBlock::castRayBlock( const Point3F &pStart,
 
    F32 invBlockSize = 1 / F32( BlockSquareWidth );
 
-   static Vector<TerrLOSStackNode> stack;
-   stack.setSize( GridLevels * 3 + 1 );
+   // The stack is local so that rays can be cast from
+   // several threads at once.
+   AssertFatal( GridLevels <= MaxGridLevels, "TerrainBlock::castRayBlock - The grid map is too deep!" );
+   TerrLOSStackNode stack[ MaxGridLevels * 3 + 1 ];
    U32 stackSize = 1;
 
    stack[0].startT = aStartT;
@@ -805,12 +1054,20 @@ bool TerrainBlock::castRayBlock( const Point3F &pStart,
 
    while(stackSize--)
    {
-      TerrLOSStackNode *sn = stack.address() + stackSize;
+      TerrLOSStackNode *sn = stack + stackSize;
       U32 level  = sn->level;
       F32 startT = sn->startT;
       F32 endT   = sn->endT;
       Point2I blockPos = sn->blockPos;
 
+      // The squares below the tile level are paged in with the
+      // tiles.  The levels above are always in memory.
+      if ( level < mFile->mTileLevel )
+      {
+         const S32 lastSquare = ( 1 << level ) - 1;
+         mFile->pageIn( blockPos, blockPos + Point2I( lastSquare, lastSquare ) );
+      }
+
       const TerrainSquare *sq = mFile->findSquare( level, blockPos.x, blockPos.y );
 
       F32 startZ = startT * (pEnd.z - pStart.z) + pStart.z;
@@ -914,9 +1171,9 @@ bool TerrainBlock::castRayBlock( const Point3F &pStart,
       }
       S32 subSqWidth = 1 << (level - 1);
       F32 xIntercept = (blockPos.x + subSqWidth) * invBlockSize;
-      F32 xInt = calcInterceptX(pStart.x, invDeltaX, xIntercept);
+      F32 xInt = calcIntercept(pStart.x, invDeltaX, xIntercept);
       F32 yIntercept = (blockPos.y + subSqWidth) * invBlockSize;
-      F32 yInt = calcInterceptY(pStart.y, invDeltaY, yIntercept);
+      F32 yInt = calcIntercept(pStart.y, invDeltaY, yIntercept);
 
       F32 startX = startT * (pEnd.x - pStart.x) + pStart.x;
       F32 startY = startT * (pEnd.y - pStart.y) + pStart.y;
@@ -29,6 +29,7 @@
 #include "terrain/terrData.h"
 
 #include "terrain/terrCollision.h"
+#include "terrain/terrIntrinsics.h"
 #include "terrain/terrCell.h"
 #include "terrain/terrRender.h"
 #include "terrain/terrMaterial.h"
@@ -54,6 +55,7 @@
 #include "T3D/physics/physicsCollision.h"
 #include "console/engineAPI.h"
 #include "core/util/safeRelease.h"
+#include "core/crc.h"
 
 #include "T3D/assets/TerrainMaterialAsset.h"
 using namespace Torque;
@@ -89,6 +91,8 @@ Signal<void(U32,TerrainBlock*,const Point2I& ,const Point2I&)> TerrainBlock::smU
 
 F32 TerrainBlock::smLODScale = 1.0f;
 F32 TerrainBlock::smDetailScale = 1.0f;
+S32 TerrainBlock::smParallelRayThreshold = 64;
+S32 TerrainBlock::smParallelLayerTexThreshold = 256;
 
 
 //RBP - Global function declared in Terrdata.h
@@ -195,6 +199,7 @@ TerrainBlock::TerrainBlock()
    mBaseLayerSizeConst(NULL),
    mDetailsDirty( false ),
    mLayerTexDirty( false ),
+   mLayerTexDirtyRect( RectI::Zero ),
    mBaseTexSize( 1024 ),
    mBaseTexFormat( TerrainBlock::DDS ),
    mCell( NULL ),
@@ -213,6 +218,7 @@ TerrainBlock::TerrainBlock()
 {
    mTypeMask = TerrainObjectType | StaticObjectType | StaticShapeObjectType;
    mNetFlags.set(Ghostable | ScopeAlways);
+   mObjectFlags.set( SoftwareOccluderFlag );
    mIgnoreZodiacs = false;
    zode_primBuffer = 0;
 
@@ -313,10 +319,9 @@ bool TerrainBlock::_setBaseTexFormat(void *obj, const char *index, const char *d
 
          if (terrain->isServerObject()) return false;
          terrain->_updateLayerTexture();
-         // If the cached base texture is older that the terrain file or
+         // If the cached base texture is out of date or
          // it doesn't exist then generate and cache it.
-         String baseCachePath = terrain->_getBaseTexCacheFileName();
-         if (Platform::compareModifiedTimes(baseCachePath, terrain->mTerrainAsset->getTerrainFilePath()) < 0 && terrain->mUpdateBasetex)
+         if (!terrain->_isBaseTexCacheValid() && terrain->mUpdateBasetex)
             terrain->_updateBaseTexture(true);
          break;
       }
@@ -406,6 +411,10 @@ void TerrainBlock::setFile(const Resource<TerrainFile>& terr)
 
    if (isClientObject())
    {
+      // The renderer builds its cells and textures from
+      // the whole terrain so page it all in.
+      mFile->pageInAll();
+
       if (mCRC != terr.getChecksum())
       {
          NetConnection::setLastError("Your terrain file doesn't match the version that is running on the server.");
@@ -418,14 +427,13 @@ void TerrainBlock::setFile(const Resource<TerrainFile>& terr)
       _updateMaterials();
       _updateLayerTexture();
 
-      // If the cached base texture is older that the terrain file or
-      // it doesn't exist then generate and cache it.
-      String baseCachePath = _getBaseTexCacheFileName();
-      if (Platform::compareModifiedTimes(baseCachePath, mTerrainAsset->getTerrainFilePath()) < 0 && mUpdateBasetex)
+      // If the cached base texture is out of date or it doesn't
+      // exist then generate it.  The cache is written in the 
+      // background and swapped in when it is done.
+      if (!_isBaseTexCacheValid() && mUpdateBasetex)
          _updateBaseTexture(true);
-
-      // The base texture should have been cached by now... so load it.
-      mBaseTex.set(baseCachePath, &GFXStaticTextureSRGBProfile, "TerrainBlock::mBaseTex");
+      else
+         mBaseTex.set(_getBaseTexCacheFileName(), &GFXStaticTextureSRGBProfile, "TerrainBlock::mBaseTex");
 
       GFXTextureManager::addEventDelegate(this, &TerrainBlock::_onTextureEvent);
       MATMGR->getFlushSignal().notify(this, &TerrainBlock::_onFlushMaterials);
@@ -583,6 +591,8 @@ void TerrainBlock::_onZoningChanged( SceneZoneSpaceManager *zoneManager )
 
 void TerrainBlock::setHeight( const Point2I &pos, F32 height )
 {
+   mFile->pageIn( pos, pos );
+
    U16 ht = floatToFixed( height );
    mFile->setHeight( pos.x, pos.y, ht );
 
@@ -593,6 +603,7 @@ void TerrainBlock::setHeight( const Point2I &pos, F32 height )
 
 F32 TerrainBlock::getHeight( const Point2I &pos )
 {
+   mFile->pageIn( pos, pos );
    U16 ht = mFile->getHeight( pos.x, pos.y );
    return fixedToFloat( ht );
 }
@@ -606,9 +617,25 @@ void TerrainBlock::updateGridMaterials( const Point2I &minPt, const Point2I &max
       mCell->updateGrid( gridRect, true );
    }
 
-   // We mark us as dirty... it will be updated
-   // before the next time we render the terrain.
-   mLayerTexDirty = true;
+   // We mark the painted region as dirty... it will be
+   // updated before the next time we render the terrain.
+   //
+   // A texel packs its sample and the samples after it,
+   // including the first sample of the next row, so the
+   // texels before the painted region change too.
+   const S32 layerSize = mFile->mSize;
+   const S32 minX = minPt.x <= 0 ? 0 : minPt.x - 1;
+   const S32 maxX = minPt.x <= 0 ? layerSize - 1 : getMin( maxPt.x, layerSize - 1 );
+   const S32 minY = getMax( minPt.y - 2, 0 );
+   const S32 maxY = getMin( maxPt.y, layerSize - 1 );
+   if ( minX <= maxX && minY <= maxY )
+   {
+      const RectI dirtyRect( minX, minY, maxX - minX + 1, maxY - minY + 1 );
+      if ( mLayerTexDirtyRect.isValidRect() )
+         mLayerTexDirtyRect.unionRects( dirtyRect );
+      else
+         mLayerTexDirtyRect = dirtyRect;
+   }
 
    // Signal anyone that cares that the opacity was changed.
    smUpdateSignal.trigger( LayersUpdate, this, minPt, maxPt );
@@ -707,6 +734,8 @@ bool TerrainBlock::getHeight( const Point2F &pos, F32 *height ) const
    x &= blockMask;
    y &= blockMask;
    
+   mFile->pageIn( Point2I( x, y ), Point2I( x, y ) );
+
    const TerrainSquare *sq = mFile->findSquare( 0, x, y );
    if ( sq->flags & TerrainSquare::Empty )
       return false;
@@ -758,6 +787,8 @@ bool TerrainBlock::getNormal( const Point2F &pos, Point3F *normal, bool normaliz
    x &= blockMask;
    y &= blockMask;
    
+   mFile->pageIn( Point2I( x, y ), Point2I( x, y ) );
+
    const TerrainSquare *sq = mFile->findSquare( 0, x, y );
    if ( skipEmpty && sq->flags & TerrainSquare::Empty )
       return false;
@@ -813,6 +844,8 @@ bool TerrainBlock::getSmoothNormal( const Point2F &pos,
    x &= blockMask;
    y &= blockMask;
    
+   mFile->pageIn( Point2I( x - 1, y - 1 ), Point2I( x, y ) );
+
    const TerrainSquare *sq = mFile->findSquare( 0, x, y );
    if ( skipEmpty && sq->flags & TerrainSquare::Empty )
       return false;
@@ -850,6 +883,8 @@ bool TerrainBlock::getNormalAndHeight( const Point2F &pos, Point3F *normal, F32
    x &= blockMask;
    y &= blockMask;
    
+   mFile->pageIn( Point2I( x, y ), Point2I( x, y ) );
+
    const TerrainSquare *sq = mFile->findSquare( 0, x, y );
    if ( sq->flags & TerrainSquare::Empty )
       return false;
@@ -897,6 +932,101 @@ bool TerrainBlock::getNormalAndHeight( const Point2F &pos, Point3F *normal, F32
 }
 
 
+void TerrainBlock::_pageIn( const Point2F *positions, U32 count ) const
+{
+   if ( mFile->isFullyResident() || count == 0 )
+      return;
+
+   // Flag just the tiles under the squares the positions land
+   // on, so that queries scattered across the terrain don't page
+   // in everything between them.
+   const F32 invSquareSize = 1.0f / mSquareSize;
+   const U32 blockMask = mFile->mSize - 1;
+   const U32 tileLevel = mFile->mTileLevel;
+   const U32 tilesPerSide = mFile->mTilesPerSide;
+
+   Vector<bool> touched;
+   touched.setSize( tilesPerSide * tilesPerSide );
+   dMemset( touched.address(), 0, touched.memSize() );
+
+   for ( U32 i = 0; i < count; i++ )
+   {
+      // Skip the positions off the terrain like getHeight() does.
+      const S32 x = S32( positions[i].x * invSquareSize );
+      const S32 y = S32( positions[i].y * invSquareSize );
+      if ( x & ~blockMask || y & ~blockMask )
+         continue;
+
+      // The square also reads the samples after it, which
+      // wrap around at the far edges.
+      const U32 x0 = x >> tileLevel;
+      const U32 x1 = ( ( x + 1 ) & blockMask ) >> tileLevel;
+      const U32 y0 = ( y >> tileLevel ) * tilesPerSide;
+      const U32 y1 = ( ( ( y + 1 ) & blockMask ) >> tileLevel ) * tilesPerSide;
+
+      touched[ x0 + y0 ] = true;
+      touched[ x1 + y0 ] = true;
+      touched[ x0 + y1 ] = true;
+      touched[ x1 + y1 ] = true;
+   }
+
+   for ( U32 tileY = 0; tileY < tilesPerSide; tileY++ )
+   {
+      for ( U32 tileX = 0; tileX < tilesPerSide; tileX++ )
+      {
+         if ( touched[ tileX + tileY * tilesPerSide ] )
+            mFile->_pageInTiles( tileX, tileY, tileX, tileY );
+      }
+   }
+}
+
+U32 TerrainBlock::getHeights( const Point2F *positions, U32 count, F32 *outHeights, bool *outValid ) const
+{
+   PROFILE_SCOPE( TerrainBlock_getHeights );
+
+   TerrainSampleGrid grid;
+   grid.heights = mFile->mHeightMap.address();
+   grid.squares = mFile->mGridMap[0];
+   grid.size = mFile->mSize;
+   grid.squareSize = mSquareSize;
+
+   _pageIn( positions, count );
+
+   terrain_sample( grid, positions, count, outHeights, NULL, false, outValid );
+
+   U32 numValid = 0;
+   for ( U32 i = 0; i < count; i++ )
+      numValid += outValid[i];
+
+   return numValid;
+}
+
+U32 TerrainBlock::getNormalsAndHeights(   const Point2F *positions, 
+                                          U32 count, 
+                                          Point3F *outNormals, 
+                                          F32 *outHeights, 
+                                          bool *outValid, 
+                                          bool normalize ) const
+{
+   PROFILE_SCOPE( TerrainBlock_getNormalsAndHeights );
+
+   TerrainSampleGrid grid;
+   grid.heights = mFile->mHeightMap.address();
+   grid.squares = mFile->mGridMap[0];
+   grid.size = mFile->mSize;
+   grid.squareSize = mSquareSize;
+
+   _pageIn( positions, count );
+
+   terrain_sample( grid, positions, count, outHeights, outNormals, normalize, outValid );
+
+   U32 numValid = 0;
+   for ( U32 i = 0; i < count; i++ )
+      numValid += outValid[i];
+
+   return numValid;
+}
+
 bool TerrainBlock::getNormalHeightMaterial(  const Point2F &pos, 
                                              Point3F *normal, 
                                              F32 *height, 
@@ -922,6 +1052,8 @@ bool TerrainBlock::getNormalHeightMaterial(  const Point2F &pos,
    x &= blockMask;
    y &= blockMask;
    
+   mFile->pageIn( Point2I( x, y ), Point2I( x, y ) );
+
    const TerrainSquare *sq = mFile->findSquare( 0, x, y );
    if ( sq->flags & TerrainSquare::Empty )
       return false;
@@ -1030,6 +1162,7 @@ void TerrainBlock::removeMaterial( U32 index )
    if ( mFile->mMaterials.size() == 1 )
       return;
 
+   mFile->pageInAll();
    mFile->mMaterials.erase( index );
    mFile->_initMaterialInstMapping();
 
@@ -1111,6 +1244,8 @@ GFXTextureObject* TerrainBlock::getLightMapTex()
 
 void TerrainBlock::onEditorEnable()
 {
+   // The editor works directly on the whole terrain.
+   mFile->pageInAll();
 }
 
 void TerrainBlock::onEditorDisable()
@@ -1153,6 +1288,53 @@ String TerrainBlock::_getBaseTexCacheFileName() const
    return basePath.getFullPath();
 }
 
+String TerrainBlock::_getBaseTexHashFileName() const
+{
+   Torque::Path basePath( mTerrainAsset->getTerrainFilePath() );
+   basePath.setFileName( basePath.getFileName() + "_basetex" );
+   basePath.setExtension( "hash" );
+   return basePath.getFullPath();
+}
+
+U32 TerrainBlock::_getBaseTexHash() const
+{
+   // The terrain file checksum covers the layer map.
+   U32 hash = CRC::calculateCRC( &mCRC, sizeof( mCRC ) );
+   hash = CRC::calculateCRC( &mBaseTexSize, sizeof( mBaseTexSize ), hash );
+   hash = CRC::calculateCRC( &mBaseTexFormat, sizeof( mBaseTexFormat ), hash );
+
+   for ( U32 i=0; i < mFile->mMaterials.size(); i++ )
+   {
+      const TerrainMaterial *mat = mFile->mMaterials[i];
+
+      const char *diffuseMap = mat->getDiffuseMap();
+      hash = CRC::calculateCRC( diffuseMap, dStrlen( diffuseMap ), hash );
+
+      const F32 diffuseSize = mat->getDiffuseSize();
+      hash = CRC::calculateCRC( &diffuseSize, sizeof( diffuseSize ), hash );
+   }
+
+   return hash;
+}
+
+bool TerrainBlock::_isBaseTexCacheValid() const
+{
+   const String cachePath = _getBaseTexCacheFileName();
+   if ( !Platform::isFile( cachePath ) )
+      return false;
+
+   FileStream stream;
+   if ( stream.open( _getBaseTexHashFileName(), Torque::FS::File::Read ) )
+   {
+      U32 hash = 0;
+      return stream.read( &hash ) && hash == _getBaseTexHash();
+   }
+
+   // Caches written before the hash was stored are
+   // valid if they are newer than the terrain file.
+   return Platform::compareModifiedTimes( cachePath, mTerrainAsset->getTerrainFilePath() ) >= 0;
+}
+
 void TerrainBlock::_rebuildQuadtree()
 {
    SAFE_DELETE( mCell );
@@ -1170,6 +1352,9 @@ void TerrainBlock::_updatePhysics()
    if ( !PHYSICSMGR )
       return;
 
+   // The physics heightfield is built from the whole terrain.
+   mFile->pageInAll();
+
    SAFE_DELETE( mPhysicsRep );
 
    PhysicsCollision *colShape;
@@ -1214,6 +1399,8 @@ void TerrainBlock::onRemove()
 
    if ( isClientObject() )
    {
+      // A pending cache write finishes on its own.
+      mBaseTexCacheItem = NULL;
       mBaseTex = NULL;
       mLayerTex = NULL;
       SAFE_DELETE( mBaseMaterial );
@@ -1326,6 +1513,18 @@ void TerrainBlock::initPersistFields()
 
    Con::addVariable( "$pref::Terrain::detailScale", TypeF32, &smDetailScale, "A global detail scale used to tweak the material detail distances.\n\n" 
 	   "@ingroup Terrain");
+
+   Con::addVariable( "$TerrainBlock::pagedLoading", TypeBool, &TerrainFile::smPagedLoading, "If true terrain files in the tiled format only load "
+      "the tiles which are touched by queries.  The client and the editor still load the whole terrain.\n\n"
+      "@ingroup Terrain");
+
+   Con::addVariable( "$TerrainBlock::parallelRayThreshold", TypeS32, &smParallelRayThreshold, "The number of rays cast in one batch before they are "
+      "spread across the worker threads.  Set to 0 to always cast them on the main thread.\n\n"
+      "@ingroup Terrain");
+
+   Con::addVariable( "$TerrainBlock::parallelLayerTexThreshold", TypeS32, &smParallelLayerTexThreshold, "The number of layer texture rows "
+      "updated at once before they are spread across the worker threads.  Set to 0 to always update them on the main thread.\n\n"
+      "@ingroup Terrain");
 }
 
 void TerrainBlock::inspectPostApply()
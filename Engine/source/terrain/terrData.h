@@ -49,6 +49,9 @@
 #ifndef _GFXPRIMITIVEBUFFER_H_
 #include "gfx/gfxPrimitiveBuffer.h"
 #endif
+#ifndef _THREADSAFEREFCOUNT_H_
+#include "platform/threads/threadSafeRefCount.h"
+#endif
 
 #ifndef _ASSET_PTR_H_
 #include "assets/assetPtr.h"
@@ -62,6 +65,7 @@ class TerrainBlock;
 class TerrCell;
 class PhysicsBody;
 class TerrainCellMaterial;
+class TerrainBaseTexCacheWorkItem;
 
 class TerrainBlock : public SceneObject
 {
@@ -169,6 +173,15 @@ protected:
    ///
    bool mLayerTexDirty;
 
+   /// The region of the layer texture changed by material
+   /// painting since the last render or an empty rect.
+   /// @see updateGridMaterials
+   RectI mLayerTexDirtyRect;
+
+   /// The base texture cache file being written on a
+   /// worker thread or NULL if none is pending.
+   ThreadSafeRef<TerrainBaseTexCacheWorkItem> mBaseTexCacheItem;
+
    /// The desired size for the base texture.
    U32 mBaseTexSize;
 
@@ -214,13 +227,40 @@ protected:
    /// material detail distances.
    static F32 smDetailScale;
 
+   /// The number of rays passed to castRays before they
+   /// are spread across the worker threads.  Zero or less
+   /// keeps them on the calling thread.
+   /// @see castRays
+   static S32 smParallelRayThreshold;
+
+   /// The number of layer texture rows updated at once
+   /// before they are spread across the worker threads.
+   /// Zero or less keeps them on the calling thread.
+   /// @see fillLayerTexels
+   static S32 smParallelLayerTexThreshold;
+
    /// True if the zoning needs to be recalculated for the terrain.
    bool mZoningDirty;
 
    String _getBaseTexCacheFileName() const;
 
+   /// Returns the file which stores the hash of the
+   /// inputs the cached base texture was built from.
+   String _getBaseTexHashFileName() const;
+
+   /// Returns a hash of the terrain file and the material
+   /// inputs which the base texture is generated from.
+   U32 _getBaseTexHash() const;
+
+   /// Returns true if the cached base texture exists and
+   /// was built from the current terrain and materials.
+   bool _isBaseTexCacheValid() const;
+
    void _rebuildQuadtree();
 
+   /// Pages in the terrain file tiles under a batch of positions.
+   void _pageIn( const Point2F *positions, U32 count ) const;
+
    void _updatePhysics();
 
    void _renderBlock( SceneRenderState *state );
@@ -241,10 +281,22 @@ protected:
    ///
    void _updateMaterials();
 
-   /// 
+   /// Renders the base texture.  When writing to the cache the
+   /// rendered texture is used until the cache file has been
+   /// compressed and written on a worker thread.
    void _updateBaseTexture( bool writeToCache );
 
-   void _updateLayerTexture();
+   /// Swaps in the cached base texture once the
+   /// worker thread has finished writing it.
+   void _updateBaseTexCache();
+
+   /// Cancels the pending cache write, waiting
+   /// for it if it's already writing the files.
+   void _cancelBaseTexCache();
+
+   /// Updates the layer texture from the layer map.  If a 
+   /// rect is passed only the texels within it are updated.
+   void _updateLayerTexture( const RectI *rect = NULL );
 
    void _updateBounds();
 
@@ -320,13 +372,28 @@ public:
    /// Accessors and mutators for TerrainMaterialUndoAction.
    /// @{
    const Vector<TerrainMaterial*>& getMaterials() const { return mFile->mMaterials; }   
-   const Vector<U8>& getLayerMap() const { return mFile->mLayerMap; }
+   const Vector<U8>& getLayerMap() const { mFile->pageInAll(); return mFile->mLayerMap; }
    void setMaterials( const Vector<TerrainMaterial*> &materials ) { mFile->mMaterials = materials; }
    void setLayerMap( const Vector<U8> &layers ) { mFile->mLayerMap = layers; }
    /// @}
 
    TerrainMaterial* getMaterial( U32 index ) const;
 
+   /// Fills a rect of layer texture texels from a layer map.  Each
+   /// texel packs the layer index of its sample and the three samples
+   /// after it.  Large rects are spread across the worker threads.
+   ///
+   /// @param layerMap  The square layer map.
+   /// @param layerSize The width and height of the layer map.
+   /// @param rect      The texels to fill.
+   /// @param bits      The first texel of the rect in a 4 byte per texel buffer.
+   /// @param pitch     The bytes between rows of the buffer.
+   static void fillLayerTexels(  const U8 *layerMap, 
+                                 U32 layerSize, 
+                                 const RectI &rect, 
+                                 U8 *bits, 
+                                 U32 pitch );
+
    const char* getMaterialName( U32 index ) const;
 
    U32 getMaterialCount() const;
@@ -411,6 +478,29 @@ public:
                                  F32 *height, 
                                  StringTableEntry &matName ) const;
 
+   /// Batched version of getHeight for many 2d positions
+   /// in the terrains object space.
+   ///
+   /// Each position gets a flag in outValid which is false
+   /// where getHeight would have returned false.
+   ///
+   /// @return The number of valid positions.
+   U32 getHeights(   const Point2F *positions, 
+                     U32 count, 
+                     F32 *outHeights, 
+                     bool *outValid ) const;
+
+   /// Batched version of getNormalAndHeight for many 2d 
+   /// positions in the terrains object space.
+   ///
+   /// @see getHeights
+   U32 getNormalsAndHeights(  const Point2F *positions, 
+                              U32 count, 
+                              Point3F *outNormals, 
+                              F32 *outHeights, 
+                              bool *outValid, 
+                              bool normalize = true ) const;
+
    // only the editor currently uses this method - should always be using a ray to collide with
    bool collideBox( const Point3F &start, const Point3F &end, RayInfo* info )
    {
@@ -462,8 +552,28 @@ public:
 
    void buildConvex(const Box3F& box,Convex* convex);
    bool buildPolyList(PolyListContext context, AbstractPolyList* polyList, const Box3F &box, const SphereF &sphere);
+   bool buildOccluderPolyList( const SceneCameraState &cameraState, AbstractPolyList *polyList, const Box3F &box );
    bool castRay(const Point3F &start, const Point3F &end, RayInfo* info);
    bool castRayI(const Point3F &start, const Point3F &end, RayInfo* info, bool emptyCollide);
+
+   /// Casts a batch of rays in the terrains object space.
+   ///
+   /// This gives the same results as calling castRay for each
+   /// ray, but rejects rays which miss the whole terrain up front
+   /// and spreads large batches across the worker threads.
+   ///
+   /// @param starts    The start of each ray.
+   /// @param ends      The end of each ray.
+   /// @param count     Number of rays.
+   /// @param outInfos  Receives the collision info for each ray which hits.
+   /// @param outHits   Receives true for each ray which hits.
+   ///
+   /// @return The number of rays which hit the terrain.
+   U32 castRays(  const Point3F *starts, 
+                  const Point3F *ends, 
+                  U32 count, 
+                  RayInfo *outInfos, 
+                  bool *outHits );
    
    bool castRayBlock(   const Point3F &pStart, 
                         const Point3F &pEnd, 
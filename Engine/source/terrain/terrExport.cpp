@@ -31,6 +31,7 @@
 
 bool TerrainBlock::exportHeightMap( const UTF8 *filePath, const String &format ) const
 {
+   mFile->pageInAll();
 
    GBitmap output(   mFile->mSize,
                      mFile->mSize,
@@ -92,6 +93,8 @@ bool TerrainBlock::exportHeightMap( const UTF8 *filePath, const String &format )
 
 bool TerrainBlock::exportLayerMaps( const UTF8 *filePrefix, const String &format ) const
 {
+   mFile->pageInAll();
+
    for(S32 i = 0; i < mFile->mMaterials.size(); i++)
    {
       Vector<const U8>::iterator iBits = mFile->mLayerMap.begin();
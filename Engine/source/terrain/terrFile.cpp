@@ -30,6 +30,7 @@
 #include "gfx/bitmap/gBitmap.h"
 #include "platform/profiler.h"
 #include "math/mPlane.h"
+#include "core/util/safeDelete.h"
 
 
 template<>
@@ -44,11 +45,19 @@ template<> ResourceBase::Signature Resource<TerrainFile>::signature()
 }
 
 
+bool TerrainFile::smPagedLoading = true;
+
 TerrainFile::TerrainFile()
    : mSize( 256 ),
      mGridLevels(0),
      mFileVersion( FILE_VERSION ),
-     mNeedsResaving( false )
+     mNeedsResaving( false ),
+     mTileSize( 0 ),
+     mTileLevel( 0 ),
+     mTilesPerSide( 0 ),
+     mTileDataStart( 0 ),
+     mPageStream( NULL ),
+     mResidentTiles( 0 )
 {
    mLayerMap.setSize( mSize * mSize );
    dMemset( mLayerMap.address(), 0, mLayerMap.memSize() );
@@ -59,6 +68,36 @@ TerrainFile::TerrainFile()
 
 TerrainFile::~TerrainFile()
 {
+   SAFE_DELETE( mPageStream );
+}
+
+/// Reads and writes arrays of U16 in the little
+/// endian byte order of the tiled file format.
+static bool readU16s( Stream &stream, U16 *out, U32 count )
+{
+   if ( !stream.read( count * sizeof( U16 ), out ) )
+      return false;
+
+#ifdef TORQUE_BIG_ENDIAN
+   for ( U32 i=0; i < count; i++ )
+      out[i] = convertLEndianToHost( out[i] );
+#endif
+
+   return true;
+}
+
+static bool writeU16s( Stream &stream, const U16 *in, U32 count )
+{
+#ifdef TORQUE_BIG_ENDIAN
+   for ( U32 i=0; i < count; i++ )
+   {
+      if ( !stream.write( in[i] ) )
+         return false;
+   }
+   return true;
+#else
+   return stream.write( count * sizeof( U16 ), in );
+#endif
 }
 
 static U16 calcDev( const PlaneF &pl, const Point3F &pt )
@@ -90,7 +129,7 @@ inline U32 getMostSignificantBit( U32 v )
    return bit;
 }
 
-void TerrainFile::_buildGridMap()
+void TerrainFile::_allocGridMap()
 {
    // The grid level count is the same as the
    // most significant bit of the size.  While 
@@ -117,6 +156,11 @@ void TerrainFile::_buildGridMap()
       mGridMap[i] = grid;
 	  grid += 1 << ( 2 * ( mGridLevels - i ) );
    }
+}
+
+void TerrainFile::_buildGridMap()
+{
+   _allocGridMap();
 
    for( S32 i = mGridLevels; i >= 0; i-- )
    {
@@ -268,6 +312,9 @@ void TerrainFile::_initMaterialInstMapping()
 
 bool TerrainFile::save( const char *filename )
 {
+   // Everything has to be in memory to write it out.
+   pageInAll();
+
    FileStream stream;
    stream.open( filename, Torque::FS::File::Write );
    if ( stream.getStatus() != Stream::Ok )
@@ -277,19 +324,26 @@ bool TerrainFile::save( const char *filename )
 
    stream.write( mSize );
 
-   // Write out the height map.
-   for ( U32 i=0; i < mHeightMap.size(); i++)
-      stream.write( mHeightMap[i] );
-
-   // Write out the layer map.
-   for ( U32 i=0; i < mLayerMap.size(); i++)
-      stream.write( mLayerMap[i] );
+   // Tiles are never larger than the terrain.
+   mTileSize = getMin( mSize, (U32)TILE_SIZE );
+   mTileLevel = getBinLog2( mTileSize );
+   mTilesPerSide = mSize / mTileSize;
+   stream.write( mTileSize );
 
    // Write out the material names.
    stream.write( (U32)mMaterials.size() );
    for ( U32 i=0; i < mMaterials.size(); i++ )
       stream.write( String( mMaterials[i]->getInternalName() ) );
 
+   // The grid levels at and above the tile level are at
+   // the start of the pool and always stay in memory.
+   writeU16s( stream, (const U16*)mGridMapPool.address(), _getUpperSquareCount() * 4 );
+
+   // Then the tiles in rows.
+   for ( U32 y=0; y < mTilesPerSide; y++ )
+      for ( U32 x=0; x < mTilesPerSide; x++ )
+         _writeTile( stream, x, y );
+
    return stream.getStatus() == FileStream::Ok;
 }
 
@@ -316,13 +370,21 @@ TerrainFile* TerrainFile::load( const Torque::Path &path )
    ret->mFileVersion = version;
    ret->mFilePath = path;
 
-   if ( version >= 7 )
-      ret->_load( stream );
+   if ( version >= 8 )
+   {
+      // The tiled format has the grid map precomputed.
+      ret->_loadTiled( stream );
+   }
    else
-      ret->_loadLegacy( stream );
+   {
+      if ( version >= 7 )
+         ret->_load( stream );
+      else
+         ret->_loadLegacy( stream );
 
-   // Update the collision structures.
-   ret->_buildGridMap();
+      // Update the collision structures.
+      ret->_buildGridMap();
+   }
    
    // Do the material mapping.
    ret->_initMaterialInstMapping();
@@ -362,6 +424,231 @@ void TerrainFile::_load( FileStream &stream )
    _resolveMaterials( materials );
 }
 
+void TerrainFile::_loadTiled( FileStream &stream )
+{
+   stream.read( &mSize );
+   stream.read( &mTileSize );
+
+   // Get the material name count.
+   U32 materialCount;
+   stream.read( &materialCount );
+   Vector<String> materials;
+   materials.setSize( materialCount );
+
+   // Load the material names.
+   for ( U32 i=0; i < materialCount; i++ )
+      stream.read( &materials[i] );
+
+   // Resolve the TerrainMaterial objects from the names.
+   _resolveMaterials( materials );
+
+   mTileLevel = getBinLog2( mTileSize );
+   mTilesPerSide = mSize / mTileSize;
+
+   // Size the maps for the whole terrain.  The memory for 
+   // tiles that are never paged in is never touched.
+   mHeightMap.setSize( mSize * mSize );
+   mLayerMap.setSize( mSize * mSize );
+   _allocGridMap();
+
+   readU16s( stream, (U16*)mGridMapPool.address(), _getUpperSquareCount() * 4 );
+
+   mTileDataStart = stream.getPosition();
+
+   const U32 tileCount = mTilesPerSide * mTilesPerSide;
+   mTileResident.setSize( tileCount );
+
+   if ( smPagedLoading && tileCount > 1 )
+   {
+      mPageStream = new FileStream;
+      if ( mPageStream->open( mFilePath.getFullPath(), Torque::FS::File::Read ) )
+      {
+         for ( U32 i=0; i < tileCount; i++ )
+            mTileResident[i] = 0;
+         mResidentTiles = 0;
+         return;
+      }
+
+      Con::errorf( "TerrainFile::_loadTiled - could not reopen '%s' for paging", mFilePath.getFullPath().c_str() );
+      SAFE_DELETE( mPageStream );
+   }
+
+   for ( U32 y=0; y < mTilesPerSide; y++ )
+      for ( U32 x=0; x < mTilesPerSide; x++ )
+         _readTile( stream, x, y );
+
+   for ( U32 i=0; i < tileCount; i++ )
+      mTileResident[i] = 1;
+   mResidentTiles = tileCount;
+}
+
+U32 TerrainFile::_getUpperSquareCount() const
+{
+   U32 count = 0;
+   for ( U32 level = mTileLevel; level <= mGridLevels; level++ )
+   {
+      const U32 squares = mSize >> level;
+      count += squares * squares;
+   }
+
+   return count;
+}
+
+U32 TerrainFile::_getTileBytes() const
+{
+   U32 squareCount = 0;
+   for ( U32 level = 0; level < mTileLevel; level++ )
+   {
+      const U32 squares = mTileSize >> level;
+      squareCount += squares * squares;
+   }
+
+   return mTileSize * mTileSize * ( sizeof( U16 ) + sizeof( U8 ) ) + 
+            squareCount * sizeof( TerrainSquare );
+}
+
+bool TerrainFile::_readTile( Stream &stream, U32 tileX, U32 tileY )
+{
+   const U32 x = tileX * mTileSize;
+   const U32 y = tileY * mTileSize;
+
+   for ( U32 row=0; row < mTileSize; row++ )
+      readU16s( stream, &mHeightMap[ x + ( y + row ) * mSize ], mTileSize );
+
+   for ( U32 row=0; row < mTileSize; row++ )
+      stream.read( mTileSize, &mLayerMap[ x + ( y + row ) * mSize ] );
+
+   for ( U32 level=0; level < mTileLevel; level++ )
+   {
+      const U32 squares = mTileSize >> level;
+      for ( U32 row=0; row < squares; row++ )
+         readU16s( stream, (U16*)findSquare( level, x, y + ( row << level ) ), squares * 4 );
+   }
+
+   return stream.getStatus() == Stream::Ok;
+}
+
+bool TerrainFile::_writeTile( Stream &stream, U32 tileX, U32 tileY ) const
+{
+   const U32 x = tileX * mTileSize;
+   const U32 y = tileY * mTileSize;
+
+   for ( U32 row=0; row < mTileSize; row++ )
+      writeU16s( stream, &mHeightMap[ x + ( y + row ) * mSize ], mTileSize );
+
+   for ( U32 row=0; row < mTileSize; row++ )
+      stream.write( mTileSize, &mLayerMap[ x + ( y + row ) * mSize ] );
+
+   for ( U32 level=0; level < mTileLevel; level++ )
+   {
+      const U32 squares = mTileSize >> level;
+      for ( U32 row=0; row < squares; row++ )
+         writeU16s( stream, (const U16*)findSquare( level, x, y + ( row << level ) ), squares * 4 );
+   }
+
+   return stream.getStatus() == Stream::Ok;
+}
+
+U32 TerrainFile::_getTileRanges( S32 min, S32 max, U32 outRanges[3][2] ) const
+{
+   const S32 last = mSize - 1;
+
+   // The squares read the samples one past their far edge.
+   U32 count = 0;
+   outRanges[count][0] = mClamp( min, 0, last ) >> mTileLevel;
+   outRanges[count][1] = mClamp( max + 1, 0, last ) >> mTileLevel;
+   count++;
+
+   // Samples past the edges wrap around like getHeight.
+   if ( max + 1 > last )
+   {
+      outRanges[count][0] = outRanges[count][1] = 0;
+      count++;
+   }
+   if ( min < 0 )
+   {
+      outRanges[count][0] = outRanges[count][1] = mTilesPerSide - 1;
+      count++;
+   }
+
+   return count;
+}
+
+void TerrainFile::pageIn( const Point2I &minPt, const Point2I &maxPt ) const
+{
+   if ( isFullyResident() )
+      return;
+
+   U32 xRanges[3][2], yRanges[3][2];
+   const U32 xCount = _getTileRanges( minPt.x, maxPt.x, xRanges );
+   const U32 yCount = _getTileRanges( minPt.y, maxPt.y, yRanges );
+
+   for ( U32 y=0; y < yCount; y++ )
+      for ( U32 x=0; x < xCount; x++ )
+         _pageInTiles( xRanges[x][0], yRanges[y][0], xRanges[x][1], yRanges[y][1] );
+}
+
+void TerrainFile::pageInAll() const
+{
+   if ( isFullyResident() )
+      return;
+
+   PROFILE_SCOPE( TerrainFile_pageInAll );
+
+   _pageInTiles( 0, 0, mTilesPerSide - 1, mTilesPerSide - 1 );
+}
+
+void TerrainFile::_pageInTiles( U32 minX, U32 minY, U32 maxX, U32 maxY ) const
+{
+   for ( U32 y = minY; y <= maxY; y++ )
+   {
+      for ( U32 x = minX; x <= maxX; x++ )
+      {
+         // Paging is logically const... it only fills
+         // in data which was already there on disk.
+         if ( !dAtomicRead( mTileResident[ x + y * mTilesPerSide ] ) )
+            const_cast<TerrainFile*>( this )->_pageInTile( x, y );
+      }
+   }
+}
+
+void TerrainFile::_pageInTile( U32 tileX, U32 tileY )
+{
+   PROFILE_SCOPE( TerrainFile_pageInTile );
+
+   // Collision queries can come from worker threads.
+   MutexHandle handle;
+   handle.lock( &mPageMutex, true );
+
+   const U32 tile = tileX + tileY * mTilesPerSide;
+   if ( mTileResident[tile] || !mPageStream )
+      return;
+
+   mPageStream->setPosition( mTileDataStart + tile * _getTileBytes() );
+   if ( !_readTile( *mPageStream, tileX, tileY ) )
+      Con::errorf( "TerrainFile::_pageInTile - failed to read tile %d, %d from '%s'", 
+         tileX, tileY, mFilePath.getFullPath().c_str() );
+
+   // The atomics publish the tile data to the threads
+   // which check for it without taking the lock.
+   dFetchAndAdd( mTileResident[tile], 1 );
+   dFetchAndAdd( mResidentTiles, 1 );
+
+   // We don't need the file anymore once it's all in memory.
+   if ( isFullyResident() )
+      SAFE_DELETE( mPageStream );
+}
+
+U64 TerrainFile::getResidentBytes() const
+{
+   // Files which are not tiled are always fully in memory.
+   if ( mTileResident.empty() )
+      return (U64)mHeightMap.memSize() + mLayerMap.memSize() + mGridMapPool.memSize();
+
+   return (U64)_getUpperSquareCount() * sizeof( TerrainSquare ) + 
+            (U64)mResidentTiles * _getTileBytes();
+}
+
 void TerrainFile::_loadLegacy(  FileStream &stream )
 {
    // Some legacy constants.
@@ -575,6 +862,8 @@ void TerrainFile::_resolveMaterials( const Vector<String> &materials )
 
 void TerrainFile::setSize( U32 newSize, bool clear )
 {
+   pageInAll();
+
    // Make sure the resolution is a power of two.
    newSize = getNextPow2( newSize );
 
@@ -609,6 +898,8 @@ void TerrainFile::setSize( U32 newSize, bool clear )
 
 void TerrainFile::smooth( F32 factor, U32 steps, bool updateCollision )
 {
+   pageInAll();
+
    const U32 blockSize = mSize * mSize;
 
    // Grab some temp buffers for our smoothing results.
@@ -675,6 +966,7 @@ void TerrainFile::smooth( F32 factor, U32 steps, bool updateCollision )
 void TerrainFile::setHeightMap( const Vector<U16> &heightmap, bool updateCollision )
 {
    AssertFatal( mHeightMap.size() == heightmap.size(), "TerrainFile::setHeightMap - Incorrect heightmap size!" );
+   pageInAll();
    dMemcpy( mHeightMap.address(), heightmap.address(), mHeightMap.size() ); 
 
    if ( updateCollision )
@@ -690,6 +982,8 @@ void TerrainFile::import(  const GBitmap &heightMap,
    AssertFatal( heightMap.getWidth() == heightMap.getHeight(), "TerrainFile::import - Height map is not square!" );
    AssertFatal( isPow2( heightMap.getWidth() ), "TerrainFile::import - Height map is not power of two!" );
 
+   pageInAll();
+
    const U32 newSize = heightMap.getWidth();
    if ( newSize != mSize )
    {
@@ -827,6 +1121,9 @@ void TerrainFile::updateGrid( const Point2I &minPt, const Point2I &maxPt )
 
    PROFILE_SCOPE( TerrainFile_UpdateGrid );
 
+   // The parent squares are rebuilt from all their children.
+   pageInAll();
+
    for ( S32 y = minPt.y - 1; y < maxPt.y + 1; y++ )
    {
       for ( S32 x = minPt.x - 1; x < maxPt.x + 1; x++ )
@@ -35,9 +35,16 @@
 #ifndef _TERRMATERIAL_H_
 #include "terrain/terrMaterial.h"
 #endif
+#ifndef _PLATFORM_THREADS_MUTEX_H_
+#include "platform/threads/mutex.h"
+#endif
+#ifndef _PLATFORMINTRINSICS_H_
+#include "platform/platformIntrinsics.h"
+#endif
 
 class TerrainMaterial;
 class FileStream;
+class Stream;
 class GBitmap;
 
 
@@ -111,9 +118,68 @@ protected:
    /// The full path and name of the TerrainFile
    Torque::Path mFilePath;
 
+   /// The dimensions of a tile in the tiled file format.
+   U32 mTileSize;
+
+   /// The grid level of a whole tile.  Squares below
+   /// this level are stored with the tiles.
+   U32 mTileLevel;
+
+   /// The number of tiles along each side of the terrain.
+   U32 mTilesPerSide;
+
+   /// The file position of the first tile.
+   U32 mTileDataStart;
+
+   /// The open file which tiles are paged in from.  This
+   /// is closed once every tile is resident.
+   mutable FileStream *mPageStream;
+
+   /// Non-zero for each tile which has been loaded.  These and
+   /// mResidentTiles are set under mPageMutex once the tile data
+   /// is in place, but read without it, so use the atomics.
+   mutable Vector<U32> mTileResident;
+
+   /// The number of loaded tiles.
+   mutable volatile U32 mResidentTiles;
+
+   /// Serializes paging from multiple threads.
+   mutable Mutex mPageMutex;
+
    /// The internal loading function.
    void _load( FileStream &stream );
 
+   /// Loads the tiled file format.  If paging is enabled
+   /// only the header and upper grid levels are read.
+   void _loadTiled( FileStream &stream );
+
+   /// Reads or writes a single tile of the tiled format.
+   /// @{
+   bool _readTile( Stream &stream, U32 tileX, U32 tileY );
+   bool _writeTile( Stream &stream, U32 tileX, U32 tileY ) const;
+   /// @}
+
+   /// Returns the size in bytes of a tile on disk.
+   U32 _getTileBytes() const;
+
+   /// Returns the number of squares in the grid levels
+   /// at and above the tile level.
+   U32 _getUpperSquareCount() const;
+
+   /// Loads any tiles which are not resident in the
+   /// inclusive range of tiles.
+   void _pageInTiles( U32 minX, U32 minY, U32 maxX, U32 maxY ) const;
+
+   /// Reads a tile from the page file.
+   void _pageInTile( U32 tileX, U32 tileY );
+
+   /// Returns the tile ranges along one axis which cover
+   /// the samples read by squares from min to max.
+   U32 _getTileRanges( S32 min, S32 max, U32 outRanges[3][2] ) const;
+
+   /// Sizes the grid map pool and assigns each level its memory.
+   void _allocGridMap();
+
    /// The legacy file loading code.
    void _loadLegacy( FileStream &stream );
 
@@ -131,9 +197,16 @@ public:
 
    enum Constants
    {
-      FILE_VERSION = 7
+      FILE_VERSION = 8,
+
+      /// The dimensions of a tile when saving.
+      TILE_SIZE = 256,
    };
 
+   /// If true tiled files only load the tiles which
+   /// are touched by queries.
+   static bool smPagedLoading;
+
    TerrainFile();
 
    virtual ~TerrainFile();
@@ -184,13 +257,37 @@ public:
    U16 getMaxHeight() const { return mGridMap[mGridLevels]->maxHeight; }
 
    /// Returns the constant heightmap vector.
-   const Vector<U16>& getHeightMap() const { return mHeightMap; }
+   const Vector<U16>& getHeightMap() const { pageInAll(); return mHeightMap; }
 
    /// Sets a new heightmap state.
    void setHeightMap( const Vector<U16> &heightmap, bool updateCollision );
 
    /// Check if the given point is valid within the (non-tiled) terrain file.
    bool isPointInTerrain( U32 x, U32 y ) const;
+
+   /// Makes sure the tiles holding the height map samples,
+   /// layers and grid squares for the inclusive range of squares 
+   /// are loaded.  This includes the samples one past the far
+   /// edge of each square.  Does nothing for files which are
+   /// fully resident.
+   void pageIn( const Point2I &minPt, const Point2I &maxPt ) const;
+
+   /// Loads every tile which is not yet resident.
+   void pageInAll() const;
+
+   /// Returns true if no more tiles need to be paged in.
+   bool isFullyResident() const { return dAtomicRead( mResidentTiles ) == mTileResident.size(); }
+
+   /// Returns the number of tiles in the file or zero
+   /// if it was not loaded from a tiled file.
+   U32 getTileCount() const { return mTileResident.size(); }
+
+   /// Returns the number of tiles paged in.
+   U32 getResidentTileCount() const { return dAtomicRead( mResidentTiles ); }
+
+   /// Returns the memory used by the resident height, layer 
+   /// and grid map data.
+   U64 getResidentBytes() const;
 };
 
 
@@ -0,0 +1,139 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "terrain/terrIntrinsics.h"
+#include "terrain/arch/terrIntrinsics.arch.h"
+
+#include "math/mPoint2.h"
+#include "math/mPoint3.h"
+#include "core/module.h"
+
+
+void (*terrain_sample)( const TerrainSampleGrid &grid, const Point2F *positions, U32 count,
+                        F32 *outHeights, Point3F *outNormals, bool normalize, bool *outValid ) = NULL;
+
+//------------------------------------------------------------------------------
+// Default C++ Implementations
+//------------------------------------------------------------------------------
+
+void terrain_sample_C( const TerrainSampleGrid &grid, const Point2F *positions, U32 count,
+                       F32 *outHeights, Point3F *outNormals, bool normalize, bool *outValid )
+{
+   const F32 invSquareSize = 1.0f / grid.squareSize;
+   const U32 blockMask = grid.size - 1;
+
+   for ( U32 i = 0; i < count; i++ )
+   {
+      F32 xp = positions[i].x * invSquareSize;
+      F32 yp = positions[i].y * invSquareSize;
+      S32 x = S32(xp);
+      S32 y = S32(yp);
+      xp -= (F32)x;
+      yp -= (F32)y;
+
+      outValid[i] = false;
+      outHeights[i] = 0.0f;
+      if ( outNormals )
+         outNormals[i].set( 0.0f, 0.0f, 1.0f );
+
+      if ( x & ~blockMask || y & ~blockMask )
+         continue;
+
+      const TerrainSquare &sq = grid.squares[ x + y * grid.size ];
+      if ( sq.flags & TerrainSquare::Empty )
+         continue;
+
+      // Neighbors wrap around the edge like TerrainFile::getHeight.
+      const U32 x1 = ( x + 1 ) & blockMask;
+      const U32 y1 = ( y + 1 ) & blockMask;
+      const F32 zBottomLeft  = fixedToFloat( grid.heights[ x + y * grid.size ] );
+      const F32 zBottomRight = fixedToFloat( grid.heights[ x1 + y * grid.size ] );
+      const F32 zTopLeft     = fixedToFloat( grid.heights[ x + y1 * grid.size ] );
+      const F32 zTopRight    = fixedToFloat( grid.heights[ x1 + y1 * grid.size ] );
+
+      Point3F normal;
+      if ( sq.flags & TerrainSquare::Split45 )
+      {
+         if ( xp > yp )
+         {
+            // bottom half
+            normal.set( zBottomLeft-zBottomRight, zBottomRight-zTopRight, grid.squareSize );
+            outHeights[i] = zBottomLeft + xp * (zBottomRight-zBottomLeft) + yp * (zTopRight-zBottomRight);
+         }
+         else
+         {
+            // top half
+            normal.set( zTopLeft-zTopRight, zBottomLeft-zTopLeft, grid.squareSize );
+            outHeights[i] = zBottomLeft + xp * (zTopRight-zTopLeft) + yp * (zTopLeft-zBottomLeft);
+         }
+      }
+      else
+      {
+         if ( 1.0f-xp > yp )
+         {
+            // bottom half
+            normal.set( zBottomLeft-zBottomRight, zBottomLeft-zTopLeft, grid.squareSize );
+            outHeights[i] = zBottomRight + (1.0f-xp) * (zBottomLeft-zBottomRight) + yp * (zTopLeft-zBottomLeft);
+         }
+         else
+         {
+            // top half
+            normal.set( zTopLeft-zTopRight, zBottomRight-zTopRight, grid.squareSize );
+            outHeights[i] = zBottomRight + (1.0f-xp) * (zTopLeft-zTopRight) + yp * (zTopRight-zBottomRight);
+         }
+      }
+
+      if ( outNormals )
+      {
+         if ( normalize )
+            normal.normalize();
+         outNormals[i] = normal;
+      }
+
+      outValid[i] = true;
+   }
+}
+
+//------------------------------------------------------------------------------
+// Initializer.
+//------------------------------------------------------------------------------
+
+MODULE_BEGIN( TerrainIntrinsics )
+
+   MODULE_INIT_AFTER( 3D )
+
+   MODULE_INIT
+   {
+      // Assign defaults (C++ versions)
+      terrain_sample = terrain_sample_C;
+
+      // Find the best implementation for the current CPU
+      if ( Platform::SystemInfo.processor.properties & CPU_PROP_SSE2 )
+      {
+         #if ( defined( TORQUE_CPU_X86 ) || defined( TORQUE_CPU_X64 ) )
+            terrain_sample = terrain_sample_SSE2;
+         #endif
+      }
+   }
+
+MODULE_END;
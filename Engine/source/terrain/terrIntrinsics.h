@@ -0,0 +1,81 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _TERRINTRINSICS_H_
+#define _TERRINTRINSICS_H_
+
+#ifndef _TERRFILE_H_
+#include "terrain/terrFile.h"
+#endif
+
+class Point2F;
+class Point3F;
+
+
+/// The level 0 grid map and height map of a terrain
+/// file as read by the terrain sampling functions.
+struct TerrainSampleGrid
+{
+   /// The fixed point height map.
+   const U16 *heights;
+
+   /// The level 0 squares of the grid map which hold
+   /// the split and empty flags for each square.
+   const TerrainSquare *squares;
+
+   /// The dimensions of the height map which must
+   /// be a power of two.
+   U32 size;
+
+   /// The size of a terrain square in object space.
+   F32 squareSize;
+};
+
+/// Sample the terrain height and optionally the normal at a
+/// batch of 2d positions in the terrains object space.
+///
+/// This gives the same results as TerrainBlock::getNormalAndHeight
+/// for each position.  Positions outside of the terrain or over
+/// an empty square are flagged as invalid and get a zero height
+/// and an up normal.
+///
+/// @param grid         The terrain to sample.
+/// @param positions    The positions to sample.
+/// @param count        Number of positions.
+/// @param outHeights   Receives the height at each position.
+/// @param outNormals   Receives the normal at each position or NULL.
+/// @param normalize    Normalize the output normals.
+/// @param outValid     Receives true where the position hit the terrain.
+extern void (*terrain_sample)( const TerrainSampleGrid &grid,
+                               const Point2F *positions,
+                               U32 count,
+                               F32 *outHeights,
+                               Point3F *outNormals,
+                               bool normalize,
+                               bool *outValid );
+
+/// The portable terrain_sample, which the SIMD version
+/// also uses for the positions past its last group of four.
+extern void terrain_sample_C( const TerrainSampleGrid &grid, const Point2F *positions, U32 count,
+                              F32 *outHeights, Point3F *outNormals, bool normalize, bool *outValid );
+
+#endif // _TERRINTRINSICS_H_
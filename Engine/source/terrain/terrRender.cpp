@@ -63,6 +63,7 @@
 #include "gfx/gfxDebugEvent.h"
 #include "gfx/gfxCardProfile.h"
 #include "core/stream/fileStream.h"
+#include "platform/threads/threadPoolBatch.h"
 
 
 bool TerrainBlock::smDebugRender = false;
@@ -246,46 +247,133 @@ void TerrainBlock::_updateMaterials()
       mCell->deleteMaterials();
 }
 
-void TerrainBlock::_updateLayerTexture()
+/// Fills the layer texture texels in a rect.
+static void _fillLayerTexelRows( const U8 *layerMap, U32 layerSize, const RectI &rect, U8 *bits, U32 pitch )
 {
+   const U32 pixelCount = layerSize * layerSize;
+
+   for ( S32 y=0; y < rect.extent.y; y++ )
+   {
+      U8 *texel = bits + y * pitch;
+      U32 i = rect.point.x + ( rect.point.y + y ) * layerSize;
+
+      for ( S32 x=0; x < rect.extent.x; x++, i++, texel += 4 )
+      {
+         texel[0] = layerMap[i];
+
+         if ( i + 1 >= pixelCount )
+            texel[1] = texel[0];
+         else
+            texel[1] = layerMap[i+1];
+
+         if ( i + layerSize >= pixelCount )
+            texel[2] = texel[0];
+         else
+            texel[2] = layerMap[i + layerSize];
+
+         if ( i + layerSize + 1 >= pixelCount )
+            texel[3] = texel[0];
+         else
+            texel[3] = layerMap[i + layerSize + 1];
+      }
+   }
+}
+
+/// Fills a range of layer texture rows on a worker thread.
+struct TerrainLayerTexWorkItem : public ThreadPoolBatch::Item
+{
+   const U8 *mLayerMap;
+   U32 mLayerSize;
+   RectI mRect;
+   U8 *mBits;
+   U32 mPitch;
+
+   TerrainLayerTexWorkItem(   const U8 *layerMap,
+                              U32 layerSize,
+                              const RectI &rect,
+                              U8 *bits,
+                              U32 pitch )
+      :  mLayerMap( layerMap ),
+         mLayerSize( layerSize ),
+         mRect( rect ),
+         mBits( bits ),
+         mPitch( pitch ) {}
+
+protected:
+
+   virtual void executeItem()
+   {
+      _fillLayerTexelRows( mLayerMap, mLayerSize, mRect, mBits, mPitch );
+   }
+};
+
+void TerrainBlock::fillLayerTexels( const U8 *layerMap, U32 layerSize, const RectI &rect, U8 *bits, U32 pitch )
+{
+   PROFILE_SCOPE( TerrainBlock_fillLayerTexels );
+
+   const U32 numRows = rect.extent.y;
+
+   ThreadPool &pool = ThreadPool::GLOBAL();
+
+   U32 numRanges = 1;
+   if ( smParallelLayerTexThreshold > 0 && numRows >= U32( smParallelLayerTexThreshold ) )
+   {
+      const U32 minRowsPerRange = getMax( U32( smParallelLayerTexThreshold ) / 2, 1U );
+      numRanges = mClamp( numRows / minRowsPerRange, 1, pool.getNumThreads() + 1 );
+   }
+
+   if ( numRanges < 2 )
+   {
+      _fillLayerTexelRows( layerMap, layerSize, rect, bits, pitch );
+      return;
+   }
+
+   Vector< ThreadSafeRef< TerrainLayerTexWorkItem > > items;
+   items.setSize( numRanges );
+
+   ThreadPoolBatch batch;
+
+   const U32 rowsPerRange = numRows / numRanges;
+   U32 start = 0;
+   for ( U32 i=0; i < numRanges; i++, start += rowsPerRange )
+   {
+      const U32 rangeRows = ( i == numRanges - 1 ) ? numRows - start : rowsPerRange;
+      const RectI rangeRect( rect.point.x, rect.point.y + start, rect.extent.x, rangeRows );
+      items[i] = new TerrainLayerTexWorkItem( layerMap, layerSize, rangeRect, bits + start * pitch, pitch );
+      batch.add( items[i] );
+   }
+
+   batch.wait();
+}
+
+void TerrainBlock::_updateLayerTexture( const RectI *rect )
+{
+   PROFILE_SCOPE( TerrainBlock_UpdateLayerTexture );
+
    const U32 layerSize = mFile->mSize;
    const Vector<U8> &layerMap = mFile->mLayerMap;
-   const U32 pixelCount = layerMap.size();
 
    if (  mLayerTex.isNull() ||
          mLayerTex.getWidth() != layerSize ||
          mLayerTex.getHeight() != layerSize )
+   {
       mLayerTex.set( layerSize, layerSize, GFXFormatB8G8R8A8, &TerrainLayerTexProfile, "" );
 
+      // A new texture needs every texel filled.
+      rect = NULL;
+   }
+
    AssertFatal(   mLayerTex.getWidth() == layerSize &&
                   mLayerTex.getHeight() == layerSize,
       "TerrainBlock::_updateLayerTexture - The texture size doesn't match the requested size!" );
 
-   // Update the layer texture.
-   GFXLockedRect *lock = mLayerTex.lock();
-
-   for ( U32 i=0; i < pixelCount; i++ )
-   {  
-      lock->bits[0] = layerMap[i];
-
-      if ( i + 1 >= pixelCount )
-         lock->bits[1] = lock->bits[0];
-      else
-         lock->bits[1] = layerMap[i+1];
-
-      if ( i + layerSize >= pixelCount )
-         lock->bits[2] = lock->bits[0];
-      else
-         lock->bits[2] = layerMap[i + layerSize];
-
-      if ( i + layerSize + 1 >= pixelCount )
-         lock->bits[3] = lock->bits[0];
-      else
-         lock->bits[3] = layerMap[i + layerSize + 1];
-
-      lock->bits += 4;
-   }
+   RectI updateRect( 0, 0, layerSize, layerSize );
+   if ( rect && !updateRect.intersect( *rect ) )
+      return;
 
+   // Update the layer texture.
+   GFXLockedRect *lock = mLayerTex.lock( 0, &updateRect );
+   fillLayerTexels( layerMap.address(), layerSize, updateRect, lock->bits, lock->pitch );
    mLayerTex.unlock();
    //mLayerTex->dumpToDisk( "png", "./layerTex.png" );
 }
@@ -432,62 +520,162 @@ void TerrainBlock::_updateBaseTexture(bool writeToCache)
    if ( !sceneBegun )
       GFX->endScene();
 
+   // Use the render target we updated until the cache
+   // is written.  This is all realtime painting needs.
+   mBaseTex = blendTex;
+
    /// Do we cache this sucker?
    if (mBaseTexFormat == NONE || !writeToCache)
    {
-      // We didn't cache the result, so set the base texture
-      // to the render target we updated.  This should be good
-      // for realtime painting cases.
-      mBaseTex = blendTex;
+      // A cache still being written is older than this
+      // update so it must not be swapped in.
+      _cancelBaseTexCache();
+      return;
    }
-   else if (mBaseTexFormat == DDS)
+
+   // Read back the render target now... the compression 
+   // and writing of the cache file is done on a worker
+   // thread and swapped in when it finishes.
+   GBitmap *blendBmp = new GBitmap( destSize.x, destSize.y, false, GFXFormatR8G8B8A8 );
+   blendTex.copyToBmp( blendBmp );
+
+   /*
+   // Test code for dumping uncompressed bitmap to disk.
    {
-      String cachePath = _getBaseTexCacheFileName();
+   FileStream fs;
+   if ( fs.open( "./basetex.png", Torque::FS::File::Write ) )
+   {
+   blendBmp->writeBitmap( "png", fs );
+   fs.close();
+   }         
+   }
+   */
+
+   // The new item writes the same files, so the old one
+   // has to be done with them first.
+   _cancelBaseTexCache();
+
+   // Remove the old hash first so that a cache which
+   // is only partially written is never trusted.
+   const String hashPath = _getBaseTexHashFileName();
+   if ( Platform::isFile( hashPath ) )
+      dFileDelete( hashPath );
+
+   mBaseTexCacheItem = new TerrainBaseTexCacheWorkItem( blendBmp, 
+                                                         mBaseTexFormat, 
+                                                         _getBaseTexCacheFileName(), 
+                                                         hashPath,
+                                                         _getBaseTexHash() );
+   ThreadPool::GLOBAL().queueWorkItem( mBaseTexCacheItem );
+}
 
-      FileStream fs;
-      if ( fs.open( _getBaseTexCacheFileName(), Torque::FS::File::Write ) )
-      {
-         // Read back the render target, dxt compress it, and write it to disk.
-         GBitmap blendBmp( destSize.x, destSize.y, false, GFXFormatR8G8B8A8 );
-         blendTex.copyToBmp( &blendBmp );
-
-         /*
-         // Test code for dumping uncompressed bitmap to disk.
-         {
-         FileStream fs;
-         if ( fs.open( "./basetex.png", Torque::FS::File::Write ) )
-         {
-         blendBmp.writeBitmap( "png", fs );
-         fs.close();
-         }         
-         }
-         */
-
-         blendBmp.extrudeMipLevels();
-
-         DDSFile *blendDDS = DDSFile::createDDSFileFromGBitmap( &blendBmp );
-         ImageUtil::ddsCompress( blendDDS, GFXFormatBC1 );
-
-         // Write result to file stream
-         blendDDS->write( fs );
-         
-         delete blendDDS;
-      }
-      fs.close();
+void TerrainBlock::_updateBaseTexCache()
+{
+   if ( !mBaseTexCacheItem || !mBaseTexCacheItem->hasExecuted() )
+      return;
+
+   // Swap the compressed texture in for the render target.
+   if ( mBaseTexCacheItem->succeeded() )
+      mBaseTex.set( mBaseTexCacheItem->getCachePath(), &GFXStaticTextureSRGBProfile, "TerrainBlock::mBaseTex" );
+
+   mBaseTexCacheItem = NULL;
+}
+
+void TerrainBlock::_cancelBaseTexCache()
+{
+   if ( !mBaseTexCacheItem )
+      return;
+
+   mBaseTexCacheItem->cancel();
+   mBaseTexCacheItem = NULL;
+}
+
+TerrainBaseTexCacheWorkItem::TerrainBaseTexCacheWorkItem(   GBitmap *bitmap,
+                                                            TerrainBlock::BaseTexFormat format,
+                                                            const String &cachePath,
+                                                            const String &hashPath,
+                                                            U32 hash )
+   :  mBitmap( bitmap ),
+      mFormat( format ),
+      mCachePath( cachePath ),
+      mHashPath( hashPath ),
+      mHash( hash ),
+      mSucceeded( false ),
+      mCancelled( false )
+{
+}
+
+TerrainBaseTexCacheWorkItem::~TerrainBaseTexCacheWorkItem()
+{
+   SAFE_DELETE( mBitmap );
+}
+
+bool TerrainBaseTexCacheWorkItem::writeCache( GBitmap *bitmap, TerrainBlock::BaseTexFormat format, const String &path )
+{
+   FileStream fs;
+   if ( !fs.open( path, Torque::FS::File::Write ) )
+      return false;
+
+   if ( format == TerrainBlock::DDS )
+   {
+      // Dxt compress the bitmap and write it to disk.
+      bitmap->extrudeMipLevels();
+
+      DDSFile *blendDDS = DDSFile::createDDSFileFromGBitmap( bitmap );
+      // This runs on a pool worker, which would wait forever
+      // on the pool if the compression was spread across it.
+      ImageUtil::ddsCompress( blendDDS, GFXFormatBC1, ImageUtil::LowQuality, false );
+
+      // Write result to file stream
+      const bool written = blendDDS->write( fs );
+      
+      delete blendDDS;
+      return written;
    }
-   else
+
+   return bitmap->writeBitmap( TerrainBlock::formatToExtension( format ), fs );
+}
+
+void TerrainBaseTexCacheWorkItem::cancel()
+{
+   mCancelled = true;
+
+   // Wait out a write which is already running.
+   MutexHandle handle;
+   handle.lock( &mExecuteMutex, true );
+}
+
+void TerrainBaseTexCacheWorkItem::execute()
+{
+   PROFILE_SCOPE( TerrainBaseTexCacheWorkItem_execute );
+
+   MutexHandle handle;
+   handle.lock( &mExecuteMutex, true );
+   if ( cancellationPoint() )
+      return;
+
+   // Write to a temporary file and move it into place
+   // so the cache is never seen partially written.
+   const String tempPath = mCachePath + ".tmp";
+   if ( !writeCache( mBitmap, mFormat, tempPath ) || cancellationPoint() )
    {
-      FileStream stream;
-      if (!stream.open(_getBaseTexCacheFileName(), Torque::FS::File::Write))
-      {
-         mBaseTex = blendTex;
-         return;
-      }
+      dFileDelete( tempPath );
+      return;
+   }
 
-      GBitmap bitmap(blendTex->getWidth(), blendTex->getHeight(), false, GFXFormatR8G8B8A8);
-      blendTex->copyToBmp(&bitmap);
-      bitmap.writeBitmap(formatToExtension(mBaseTexFormat), stream);
+   if ( Platform::isFile( mCachePath ) )
+      dFileDelete( mCachePath );
+   if ( !dFileRename( tempPath, mCachePath ) )
+      return;
+
+   FileStream fs;
+   if ( fs.open( mHashPath, Torque::FS::File::Write ) )
+   {
+      fs.write( mHash );
+      fs.close();
    }
+
+   mSucceeded = true;
 }
 
 void TerrainBlock::_renderBlock( SceneRenderState *state )
@@ -531,18 +719,25 @@ void TerrainBlock::_renderBlock( SceneRenderState *state )
    }
 
    // If the layer texture has been cleared or is 
-   // dirty then update it.
+   // dirty then update it.  Painting only needs
+   // the painted region updated.
    if ( mLayerTex.isNull() || mLayerTexDirty )
       _updateLayerTexture();
+   else if ( mLayerTexDirtyRect.isValidRect() )
+      _updateLayerTexture( &mLayerTexDirtyRect );
 
    // If the layer texture is dirty or we lost the base
    // texture then regenerate it.
-   if ( mLayerTexDirty || mBaseTex.isNull() )
+   if ( mLayerTexDirty || mLayerTexDirtyRect.isValidRect() || mBaseTex.isNull() )
    {
       _updateBaseTexture( false );
       mLayerTexDirty = false;
+      mLayerTexDirtyRect = RectI::Zero;
    }   
 
+   // Swap in the cached base texture if it finished.
+   _updateBaseTexCache();
+
    static Vector<TerrCell*> renderCells;
    renderCells.clear();
 
@@ -37,6 +37,14 @@
 #include "terrain/terrData.h"
 #endif
 
+#ifndef _THREADPOOL_H_
+#include "platform/threads/threadPool.h"
+#endif
+
+#ifndef _PLATFORM_THREADS_MUTEX_H_
+#include "platform/threads/mutex.h"
+#endif
+
 #include "afx/ce/afxZodiacDefs.h"
 enum TerrConstants : U32
 {
@@ -67,4 +75,66 @@ public:
 /// A special texture profile used for the terrain layer id map.
 GFX_DeclareTextureProfile( TerrainLayerTexProfile );
 
+
+/// Compresses a generated terrain base texture and writes
+/// it to the cache file on a worker thread.
+///
+/// The item owns everything it needs, so it can safely
+/// outlive the terrain which queued it.
+///
+/// @see TerrainBlock::_updateBaseTexture
+class TerrainBaseTexCacheWorkItem : public ThreadPool::WorkItem
+{
+public:
+
+   typedef ThreadPool::WorkItem Parent;
+
+   /// The item takes ownership of the bitmap.
+   TerrainBaseTexCacheWorkItem(  GBitmap *bitmap,
+                                 TerrainBlock::BaseTexFormat format,
+                                 const String &cachePath,
+                                 const String &hashPath,
+                                 U32 hash );
+
+   virtual ~TerrainBaseTexCacheWorkItem();
+
+   /// Returns true if the cache file was written.
+   bool succeeded() const { return mSucceeded; }
+
+   const String& getCachePath() const { return mCachePath; }
+
+   /// Keeps the item from replacing the cache files.  If the item
+   /// is already writing them this waits for it to finish, after
+   /// which a newer item can safely write the same files.
+   void cancel();
+
+   /// Writes the bitmap to the cache file in the format, building
+   /// the mips and compressing it for DDS.  The bitmap is modified.
+   static bool writeCache( GBitmap *bitmap, TerrainBlock::BaseTexFormat format, const String &path );
+
+protected:
+
+   GBitmap *mBitmap;
+
+   TerrainBlock::BaseTexFormat mFormat;
+
+   String mCachePath;
+
+   String mHashPath;
+
+   U32 mHash;
+
+   bool mSucceeded;
+
+   /// Set by cancel().
+   volatile bool mCancelled;
+
+   /// Held while the item executes.
+   Mutex mExecuteMutex;
+
+   // ThreadPool::WorkItem
+   virtual void execute();
+   virtual bool isCancellationRequested() { return mCancelled; }
+};
+
 #endif // _TERRRENDER_H_
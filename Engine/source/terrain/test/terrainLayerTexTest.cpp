@@ -0,0 +1,194 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2014 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "terrain/terrData.h"
+#include "terrain/terrRender.h"
+#include "gfx/bitmap/gBitmap.h"
+#include "math/mRandom.h"
+#include "console/console.h"
+#include "platform/threads/threadPool.h"
+
+FIXTURE(TerrainLayerTex)
+{
+public:
+   S32 oldThreshold;
+   Vector<U8> layerMap;
+
+   void SetUp()
+   {
+      oldThreshold = Con::getIntVariable( "$TerrainBlock::parallelLayerTexThreshold" );
+   }
+
+   void TearDown()
+   {
+      Con::setIntVariable( "$TerrainBlock::parallelLayerTexThreshold", oldThreshold );
+   }
+
+   void createLayerMap( U32 size )
+   {
+      MRandomLCG rand( 11 );
+      layerMap.setSize( size * size );
+      for ( U32 i = 0; i < layerMap.size(); i++ )
+         layerMap[i] = rand.randI( 0, 7 );
+   }
+
+   /// Fills the rect into a tightly packed buffer.
+   void fill( U32 size, const RectI &rect, Vector<U8> &outTexels )
+   {
+      const U32 pitch = rect.extent.x * 4;
+      outTexels.setSize( pitch * rect.extent.y );
+      TerrainBlock::fillLayerTexels( layerMap.address(), size, rect, outTexels.address(), pitch );
+   }
+};
+
+TEST_FIX(TerrainLayerTex, ParallelMatchesSerial)
+{
+   const U32 size = 512;
+   createLayerMap( size );
+   const RectI fullRect( 0, 0, size, size );
+
+   Con::setIntVariable( "$TerrainBlock::parallelLayerTexThreshold", 0 );
+   Vector<U8> serial;
+   fill( size, fullRect, serial );
+
+   Con::setIntVariable( "$TerrainBlock::parallelLayerTexThreshold", 16 );
+   Vector<U8> parallel;
+   fill( size, fullRect, parallel );
+
+   ASSERT_EQ( serial.size(), parallel.size() );
+   EXPECT_EQ( dMemcmp( serial.address(), parallel.address(), serial.size() ), 0 );
+
+   // Spot check the packing, including the edges.
+   EXPECT_EQ( serial[0], layerMap[0] );
+   EXPECT_EQ( serial[1], layerMap[1] );
+   EXPECT_EQ( serial[2], layerMap[size] );
+   EXPECT_EQ( serial[3], layerMap[size + 1] );
+
+   const U32 last = size * size - 1;
+   EXPECT_EQ( serial[ last * 4 + 1 ], layerMap[last] );
+   EXPECT_EQ( serial[ last * 4 + 2 ], layerMap[last] );
+   EXPECT_EQ( serial[ last * 4 + 3 ], layerMap[last] );
+}
+
+TEST_FIX(TerrainLayerTex, RegionMatchesFull)
+{
+   // Updating a painted region must give the
+   // same texels as updating the whole texture.
+   const U32 size = 256;
+   createLayerMap( size );
+
+   Vector<U8> full;
+   fill( size, RectI( 0, 0, size, size ), full );
+
+   const RectI regions[3] = 
+   {
+      RectI( 17, 33, 40, 9 ),
+      RectI( 0, 250, size, 6 ),
+      RectI( 200, 0, 56, 1 ),
+   };
+
+   for ( U32 r = 0; r < 3; r++ )
+   {
+      const RectI &rect = regions[r];
+
+      Vector<U8> region;
+      fill( size, rect, region );
+
+      for ( S32 y = 0; y < rect.extent.y; y++ )
+      {
+         const U8 *expected = full.address() + ( ( rect.point.y + y ) * size + rect.point.x ) * 4;
+         const U8 *actual = region.address() + y * rect.extent.x * 4;
+         ASSERT_EQ( dMemcmp( expected, actual, rect.extent.x * 4 ), 0 ) << "region " << r << " row " << y;
+      }
+   }
+}
+
+TEST_FIX(TerrainLayerTex, CacheWriteOnPool)
+{
+   // The DDS write compresses the mips, which must not wait
+   // on the pool the item itself is running on.
+   GBitmap *bitmap = new GBitmap( 256, 256, false, GFXFormatR8G8B8A8 );
+   MRandomLCG rand( 5 );
+   U8 *bits = bitmap->getWritableBits();
+   for ( U32 i = 0; i < 256 * 256 * 4; i++ )
+      bits[i] = rand.randI( 0, 255 );
+
+   const String cachePath = "terrainLayerTexTest_pool.dds";
+   const String hashPath = "terrainLayerTexTest_pool.hash";
+   ThreadSafeRef<TerrainBaseTexCacheWorkItem> item( 
+      new TerrainBaseTexCacheWorkItem( bitmap, TerrainBlock::DDS, cachePath, hashPath, 1234 ) );
+   ThreadPool::GLOBAL().queueWorkItem( item );
+
+   const U32 deadline = Platform::getRealMilliseconds() + 30000;
+   while ( !item->hasExecuted() && Platform::getRealMilliseconds() < deadline )
+      Platform::sleep( 10 );
+
+   ASSERT_TRUE( item->hasExecuted() ) << "cache write did not finish";
+   EXPECT_TRUE( item->succeeded() );
+   EXPECT_TRUE( Platform::isFile( cachePath ) );
+   EXPECT_TRUE( Platform::isFile( hashPath ) );
+
+   dFileDelete( cachePath );
+   dFileDelete( hashPath );
+}
+
+TEST_FIX(TerrainLayerTex, StressTestGeneration)
+{
+   // Main thread cost of a full 4k layer texture update and of
+   // kicking off the base texture cache write.
+   const U32 size = 4096;
+   createLayerMap( size );
+   const RectI fullRect( 0, 0, size, size );
+   Vector<U8> texels;
+
+   Con::setIntVariable( "$TerrainBlock::parallelLayerTexThreshold", 0 );
+   U32 start = Platform::getRealMilliseconds();
+   fill( size, fullRect, texels );
+   const U32 serialMs = Platform::getRealMilliseconds() - start;
+
+   Con::setIntVariable( "$TerrainBlock::parallelLayerTexThreshold", oldThreshold );
+   start = Platform::getRealMilliseconds();
+   fill( size, fullRect, texels );
+   const U32 parallelMs = Platform::getRealMilliseconds() - start;
+
+   Con::printf( "TerrainLayerTex: %dx%d layer texture serial %d ms, parallel %d ms",
+      size, size, serialMs, parallelMs );
+
+   // The cache write used to block the main thread on load.
+   GBitmap bitmap( 1024, 1024, false, GFXFormatR8G8B8A8 );
+   MRandomLCG rand( 3 );
+   U8 *bits = bitmap.getWritableBits();
+   for ( U32 i = 0; i < 1024 * 1024 * 4; i++ )
+      bits[i] = rand.randI( 0, 255 );
+
+   const String cachePath = "terrainLayerTexTest_basetex.dds";
+   start = Platform::getRealMilliseconds();
+   EXPECT_TRUE( TerrainBaseTexCacheWorkItem::writeCache( &bitmap, TerrainBlock::DDS, cachePath ) );
+   const U32 cacheMs = Platform::getRealMilliseconds() - start;
+   dFileDelete( cachePath );
+
+   Con::printf( "TerrainLayerTex: 1024x1024 base texture cache write %d ms moved off the main thread", cacheMs );
+}
+
+#endif
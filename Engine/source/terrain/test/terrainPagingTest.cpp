@@ -0,0 +1,313 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2014 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "terrain/terrData.h"
+#include "terrain/terrFile.h"
+#include "gfx/bitmap/gBitmap.h"
+#include "core/resourceManager.h"
+#include "collision/collision.h"
+#include "math/mRandom.h"
+#include "console/console.h"
+
+FIXTURE(TerrainPaging)
+{
+public:
+   Vector<String> fileNames;
+   bool oldPagedLoading;
+
+   void SetUp()
+   {
+      oldPagedLoading = TerrainFile::smPagedLoading;
+   }
+
+   void TearDown()
+   {
+      TerrainFile::smPagedLoading = oldPagedLoading;
+      for ( U32 i = 0; i < fileNames.size(); i++ )
+         dFileDelete( fileNames[i] );
+   }
+
+   /// Creates a rolling terrain with a hole cut in it.
+   TerrainFile* createTerrain( U32 size )
+   {
+      GBitmap heightMap( size, size, false, GFXFormatL16 );
+      for ( U32 y = 0; y < size; y++ )
+      {
+         U16 *row = (U16*)heightMap.getAddress( 0, y );
+         for ( U32 x = 0; x < size; x++ )
+         {
+            const F32 h = 0.5f + 0.25f * mSin( x * 0.05f ) * mCos( y * 0.03f ) + 0.2f * mSin( ( x + y ) * 0.011f );
+            row[x] = convertHostToBEndian( (U16)( h * U16_MAX ) );
+         }
+      }
+
+      Vector<U8> layerMap;
+      layerMap.setSize( size * size );
+      for ( U32 i = 0; i < layerMap.size(); i++ )
+         layerMap[i] = ( i / 7 ) % 3;
+      for ( U32 y = size / 4; y < size / 4 + 32; y++ )
+         for ( U32 x = size / 4; x < size / 4 + 32; x++ )
+            layerMap[ x + y * size ] = U8_MAX;
+
+      TerrainFile *file = new TerrainFile;
+      file->import( heightMap, 300.0f, layerMap, Vector<String>(), false );
+      return file;
+   }
+
+   /// Saves the terrain to a file which is removed after the test.
+   String saveTerrain( TerrainFile *file, const char *name )
+   {
+      String fileName = String::ToString( "terrainPagingTest_%s.ter", name );
+      EXPECT_TRUE( file->save( fileName ) );
+      fileNames.push_back( fileName );
+      return fileName;
+   }
+
+   /// Expects the samples and squares in the inclusive range to match.
+   void expectRegionsEqual( const TerrainFile *a, const TerrainFile *b, const Point2I &minPt, const Point2I &maxPt )
+   {
+      for ( S32 y = minPt.y; y <= maxPt.y; y++ )
+      {
+         for ( S32 x = minPt.x; x <= maxPt.x; x++ )
+         {
+            ASSERT_EQ( a->getHeight( x, y ), b->getHeight( x, y ) ) << x << ", " << y;
+            ASSERT_EQ( a->getLayerIndex( x, y ), b->getLayerIndex( x, y ) ) << x << ", " << y;
+
+            const TerrainSquare *sa = a->findSquare( 0, x, y );
+            const TerrainSquare *sb = b->findSquare( 0, x, y );
+            ASSERT_EQ( sa->minHeight, sb->minHeight );
+            ASSERT_EQ( sa->maxHeight, sb->maxHeight );
+            ASSERT_EQ( sa->heightDeviance, sb->heightDeviance );
+            ASSERT_EQ( sa->flags, sb->flags );
+         }
+      }
+   }
+};
+
+TEST_FIX(TerrainPaging, RoundTrip)
+{
+   // The grid map stored in the file should match
+   // the one built when the terrain was imported.
+   TerrainFile *original = createTerrain( 512 );
+   String fileName = saveTerrain( original, "roundTrip" );
+
+   TerrainFile::smPagedLoading = false;
+   TerrainFile *loaded = TerrainFile::load( fileName );
+   ASSERT_TRUE( loaded != NULL );
+   EXPECT_TRUE( loaded->isFullyResident() );
+   EXPECT_EQ( loaded->getTileCount(), 4 );
+
+   expectRegionsEqual( original, loaded, Point2I( 0, 0 ), Point2I( 511, 511 ) );
+
+   for ( U32 level = 1; level <= 9; level++ )
+   {
+      for ( U32 y = 0; y < 512; y += 1 << level )
+      {
+         for ( U32 x = 0; x < 512; x += 1 << level )
+         {
+            const TerrainSquare *sa = original->findSquare( level, x, y );
+            const TerrainSquare *sb = loaded->findSquare( level, x, y );
+            ASSERT_EQ( sa->minHeight, sb->minHeight ) << "level " << level;
+            ASSERT_EQ( sa->maxHeight, sb->maxHeight ) << "level " << level;
+            ASSERT_EQ( sa->heightDeviance, sb->heightDeviance ) << "level " << level;
+            ASSERT_EQ( sa->flags, sb->flags ) << "level " << level;
+         }
+      }
+   }
+
+   delete loaded;
+   delete original;
+}
+
+TEST_FIX(TerrainPaging, PagedMatchesFull)
+{
+   TerrainFile *original = createTerrain( 1024 );
+   String fileName = saveTerrain( original, "paged" );
+   delete original;
+
+   TerrainFile::smPagedLoading = false;
+   TerrainFile *full = TerrainFile::load( fileName );
+   TerrainFile::smPagedLoading = true;
+   TerrainFile *paged = TerrainFile::load( fileName );
+   ASSERT_TRUE( full != NULL && paged != NULL );
+
+   EXPECT_EQ( paged->getTileCount(), 16 );
+   EXPECT_EQ( paged->getResidentTileCount(), 0 );
+   EXPECT_FALSE( paged->isFullyResident() );
+   EXPECT_LT( paged->getResidentBytes(), full->getResidentBytes() / 16 );
+   EXPECT_EQ( paged->getMaxHeight(), full->getMaxHeight() );
+
+   // A region inside the first tile.
+   paged->pageIn( Point2I( 10, 10 ), Point2I( 20, 20 ) );
+   EXPECT_EQ( paged->getResidentTileCount(), 1 );
+   expectRegionsEqual( full, paged, Point2I( 0, 0 ), Point2I( 255, 255 ) );
+
+   // A square on the far edge reads samples which wrap
+   // around to the first tile which is already resident.
+   paged->pageIn( Point2I( 1023, 5 ), Point2I( 1023, 5 ) );
+   EXPECT_EQ( paged->getResidentTileCount(), 2 );
+
+   // A square on a tile corner needs its neighbors.
+   paged->pageIn( Point2I( 511, 511 ), Point2I( 511, 511 ) );
+   EXPECT_EQ( paged->getResidentTileCount(), 6 );
+
+   paged->pageInAll();
+   EXPECT_TRUE( paged->isFullyResident() );
+   EXPECT_EQ( paged->getResidentBytes(), full->getResidentBytes() );
+   expectRegionsEqual( full, paged, Point2I( 0, 0 ), Point2I( 1023, 1023 ) );
+
+   delete paged;
+   delete full;
+}
+
+TEST_FIX(TerrainPaging, RaysPageOnDemand)
+{
+   TerrainFile *original = createTerrain( 1024 );
+   String pagedName = saveTerrain( original, "raysPaged" );
+   String fullName = saveTerrain( original, "raysFull" );
+   delete original;
+
+   TerrainFile::smPagedLoading = true;
+   Resource<TerrainFile> pagedFile = ResourceManager::get().load( pagedName );
+   TerrainFile::smPagedLoading = false;
+   Resource<TerrainFile> fullFile = ResourceManager::get().load( fullName );
+   ASSERT_TRUE( pagedFile != NULL && fullFile != NULL );
+
+   TerrainBlock *paged = new TerrainBlock();
+   paged->setFile( pagedFile );
+   TerrainBlock *full = new TerrainBlock();
+   full->setFile( fullFile );
+
+   // Short rays and height queries around one corner.
+   MRandomLCG rand( 7 );
+   for ( U32 i = 0; i < 200; i++ )
+   {
+      const Point3F start( rand.randF( 0.0f, 200.0f ), rand.randF( 0.0f, 200.0f ), 300.0f );
+      const Point3F end = start + Point3F( rand.randF( -20.0f, 20.0f ), rand.randF( -20.0f, 20.0f ), -300.0f );
+
+      RayInfo pagedInfo, fullInfo;
+      const bool hit = full->castRay( start, end, &fullInfo );
+      ASSERT_EQ( paged->castRay( start, end, &pagedInfo ), hit );
+      if ( hit )
+         EXPECT_FLOAT_EQ( pagedInfo.t, fullInfo.t );
+
+      F32 pagedHeight = 0.0f, fullHeight = 0.0f;
+      const Point2F pos( start.x, start.y );
+      ASSERT_EQ( paged->getHeight( pos, &pagedHeight ), full->getHeight( pos, &fullHeight ) );
+      EXPECT_EQ( pagedHeight, fullHeight );
+   }
+
+   EXPECT_GT( pagedFile->getResidentTileCount(), 0 );
+   EXPECT_LT( pagedFile->getResidentTileCount(), pagedFile->getTileCount() );
+
+   delete paged;
+   delete full;
+}
+
+TEST_FIX(TerrainPaging, BatchedQueriesPageTouchedTiles)
+{
+   TerrainFile *original = createTerrain( 1024 );
+   String pagedName = saveTerrain( original, "batchPaged" );
+   String fullName = saveTerrain( original, "batchFull" );
+   delete original;
+
+   TerrainFile::smPagedLoading = true;
+   Resource<TerrainFile> pagedFile = ResourceManager::get().load( pagedName );
+   TerrainFile::smPagedLoading = false;
+   Resource<TerrainFile> fullFile = ResourceManager::get().load( fullName );
+   ASSERT_TRUE( pagedFile != NULL && fullFile != NULL );
+
+   TerrainBlock *paged = new TerrainBlock();
+   paged->setFile( pagedFile );
+   TerrainBlock *full = new TerrainBlock();
+   full->setFile( fullFile );
+
+   // Two opposite corners and a position off the terrain
+   // only need the two corner tiles.
+   const F32 squareSize = paged->getSquareSize();
+   const Point2F positions[3] =
+   {
+      Point2F( 10.0f, 10.0f ) * squareSize,
+      Point2F( 1000.0f, 1000.0f ) * squareSize,
+      Point2F( -50.0f, 2000.0f ) * squareSize,
+   };
+
+   F32 pagedHeights[3], fullHeights[3];
+   bool pagedValid[3], fullValid[3];
+   EXPECT_EQ( paged->getHeights( positions, 3, pagedHeights, pagedValid ), 2 );
+   EXPECT_EQ( pagedFile->getResidentTileCount(), 2 );
+
+   full->getHeights( positions, 3, fullHeights, fullValid );
+   for ( U32 i = 0; i < 3; i++ )
+   {
+      EXPECT_EQ( pagedValid[i], fullValid[i] );
+      if ( fullValid[i] )
+         EXPECT_EQ( pagedHeights[i], fullHeights[i] );
+   }
+
+   delete paged;
+   delete full;
+}
+
+TEST_FIX(TerrainPaging, StressTestLoad)
+{
+   // Load a 4k terrain in full and then paged, printing
+   // the time and the resident memory of each.
+   TerrainFile *original = createTerrain( 4096 );
+   String fileName = saveTerrain( original, "stress" );
+   delete original;
+
+   TerrainFile::smPagedLoading = false;
+   U32 start = Platform::getRealMilliseconds();
+   TerrainFile *full = TerrainFile::load( fileName );
+   const U32 fullMs = Platform::getRealMilliseconds() - start;
+
+   TerrainFile::smPagedLoading = true;
+   start = Platform::getRealMilliseconds();
+   TerrainFile *paged = TerrainFile::load( fileName );
+   const U32 pagedMs = Platform::getRealMilliseconds() - start;
+   ASSERT_TRUE( full != NULL && paged != NULL );
+
+   Con::printf( "TerrainPaging: full load %d ms %d MB, paged load %d ms %d KB",
+      fullMs, (U32)( full->getResidentBytes() >> 20 ), pagedMs, (U32)( paged->getResidentBytes() >> 10 ) );
+
+   // Page in the area around a few cameras.
+   const Point2I cameras[4] = { Point2I( 300, 300 ), Point2I( 2000, 1000 ), Point2I( 3800, 3900 ), Point2I( 1000, 3000 ) };
+   const S32 radius = 256;
+
+   start = Platform::getRealMilliseconds();
+   for ( U32 i = 0; i < 4; i++ )
+      paged->pageIn( cameras[i] - Point2I( radius, radius ), cameras[i] + Point2I( radius, radius ) );
+   const U32 cameraMs = Platform::getRealMilliseconds() - start;
+
+   Con::printf( "TerrainPaging: 4 cameras paged in %d of %d tiles in %d ms, %d MB resident",
+      paged->getResidentTileCount(), paged->getTileCount(), cameraMs, (U32)( paged->getResidentBytes() >> 20 ) );
+
+   EXPECT_LT( paged->getResidentTileCount(), paged->getTileCount() );
+
+   delete paged;
+   delete full;
+}
+
+#endif
@@ -0,0 +1,293 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2014 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "terrain/terrData.h"
+#include "terrain/terrFile.h"
+#include "terrain/terrIntrinsics.h"
+#include "terrain/arch/terrIntrinsics.arch.h"
+#include "gfx/bitmap/gBitmap.h"
+#include "core/resourceManager.h"
+#include "collision/collision.h"
+#include "math/mRandom.h"
+#include "console/console.h"
+
+FIXTURE(TerrainQuery)
+{
+public:
+   TerrainBlock *terrain;
+   String fileName;
+
+   void SetUp()
+   {
+      terrain = NULL;
+   }
+
+   void TearDown()
+   {
+      // Release the resource before removing its file.
+      SAFE_DELETE( terrain );
+      if ( fileName.isNotEmpty() )
+         dFileDelete( fileName );
+   }
+
+   /// Creates a rolling terrain with a hole cut in it.
+   void createTerrain( U32 size )
+   {
+      GBitmap heightMap( size, size, false, GFXFormatL16 );
+      for ( U32 y = 0; y < size; y++ )
+      {
+         U16 *row = (U16*)heightMap.getAddress( 0, y );
+         for ( U32 x = 0; x < size; x++ )
+         {
+            const F32 h = 0.5f + 0.25f * mSin( x * 0.05f ) * mCos( y * 0.03f ) + 0.2f * mSin( ( x + y ) * 0.011f );
+            row[x] = convertHostToBEndian( (U16)( h * U16_MAX ) );
+         }
+      }
+
+      Vector<U8> layerMap;
+      layerMap.setSize( size * size );
+      dMemset( layerMap.address(), 0, layerMap.memSize() );
+      for ( U32 y = size / 4; y < size / 4 + 32; y++ )
+         for ( U32 x = size / 4; x < size / 4 + 32; x++ )
+            layerMap[ x + y * size ] = U8_MAX;
+
+      TerrainFile *file = new TerrainFile;
+      file->import( heightMap, 300.0f, layerMap, Vector<String>(), false );
+
+      fileName = String::ToString( "terrainQueryTest%d.ter", size );
+      ASSERT_TRUE( file->save( fileName ) );
+      delete file;
+
+      Resource<TerrainFile> res = ResourceManager::get().load( fileName );
+      ASSERT_TRUE( res != NULL );
+
+      terrain = new TerrainBlock();
+      terrain->setFile( res );
+   }
+
+   /// Fills positions with random points over and around the terrain.
+   void randomPositions( Vector<Point2F> &positions, U32 count, U32 seed )
+   {
+      MRandomLCG rand( seed );
+      const F32 size = terrain->getWorldBlockSize();
+      positions.setSize( count );
+      for ( U32 i = 0; i < count; i++ )
+         positions[i].set( rand.randF( -10.0f, size + 10.0f ), rand.randF( -10.0f, size + 10.0f ) );
+   }
+
+   /// Fills starts and ends with random rays which mostly go down
+   /// through the terrain with some passing over or beside it.
+   void randomRays( Vector<Point3F> &starts, Vector<Point3F> &ends, U32 count, U32 seed )
+   {
+      MRandomLCG rand( seed );
+      const F32 size = terrain->getWorldBlockSize();
+      starts.setSize( count );
+      ends.setSize( count );
+      for ( U32 i = 0; i < count; i++ )
+      {
+         starts[i].set( rand.randF( -50.0f, size + 50.0f ), rand.randF( -50.0f, size + 50.0f ), rand.randF( 0.0f, 400.0f ) );
+         ends[i] = starts[i] + Point3F( rand.randF( -100.0f, 100.0f ), rand.randF( -100.0f, 100.0f ), rand.randF( -400.0f, 50.0f ) );
+      }
+
+      // Include some straight down rays.
+      for ( U32 i = 0; i < count; i += 16 )
+         ends[i].set( starts[i].x, starts[i].y, -10.0f );
+   }
+};
+
+TEST_FIX(TerrainQuery, HeightsMatchSingleQueries)
+{
+   createTerrain( 256 );
+   ASSERT_TRUE( terrain != NULL );
+
+   Vector<Point2F> positions;
+   randomPositions( positions, 10003, 1 );
+
+   Vector<F32> heights;
+   Vector<Point3F> normals;
+   Vector<bool> valid;
+   heights.setSize( positions.size() );
+   normals.setSize( positions.size() );
+   valid.setSize( positions.size() );
+
+   U32 numValid = terrain->getNormalsAndHeights( positions.address(), positions.size(), normals.address(), heights.address(), valid.address() );
+
+   U32 expectedValid = 0;
+   for ( U32 i = 0; i < positions.size(); i++ )
+   {
+      F32 height;
+      Point3F normal;
+      const bool hit = terrain->getNormalAndHeight( positions[i], &normal, &height );
+      expectedValid += hit;
+
+      ASSERT_EQ( hit, valid[i] ) << "position " << positions[i].x << ", " << positions[i].y;
+      if ( !hit )
+         continue;
+
+      EXPECT_NEAR( height, heights[i], 0.001f );
+      EXPECT_TRUE( normal.equal( normals[i], 0.0001f ) );
+   }
+
+   EXPECT_EQ( numValid, expectedValid );
+   EXPECT_LT( numValid, positions.size() );
+
+   // The height only version.
+   EXPECT_EQ( terrain->getHeights( positions.address(), positions.size(), heights.address(), valid.address() ), expectedValid );
+   for ( U32 i = 0; i < positions.size(); i++ )
+   {
+      F32 height;
+      if ( terrain->getHeight( positions[i], &height ) )
+         EXPECT_NEAR( height, heights[i], 0.001f );
+   }
+}
+
+TEST_FIX(TerrainQuery, SIMDMatchesC)
+{
+   createTerrain( 256 );
+   ASSERT_TRUE( terrain != NULL );
+
+   Vector<Point2F> positions;
+   randomPositions( positions, 1001, 2 );
+
+   Vector<F32> heights, heightsC;
+   Vector<Point3F> normals, normalsC;
+   Vector<bool> valid, validC;
+   heights.setSize( positions.size() );
+   heightsC.setSize( positions.size() );
+   normals.setSize( positions.size() );
+   normalsC.setSize( positions.size() );
+   valid.setSize( positions.size() );
+   validC.setSize( positions.size() );
+
+   terrain->getNormalsAndHeights( positions.address(), positions.size(), normals.address(), heights.address(), valid.address(), false );
+
+   void (*oldSample)( const TerrainSampleGrid&, const Point2F*, U32, F32*, Point3F*, bool, bool* ) = terrain_sample;
+   terrain_sample = terrain_sample_C;
+   terrain->getNormalsAndHeights( positions.address(), positions.size(), normalsC.address(), heightsC.address(), validC.address(), false );
+   terrain_sample = oldSample;
+
+   for ( U32 i = 0; i < positions.size(); i++ )
+   {
+      ASSERT_EQ( valid[i], validC[i] );
+      EXPECT_FLOAT_EQ( heights[i], heightsC[i] );
+      EXPECT_TRUE( normals[i].equal( normalsC[i], 0.0001f ) );
+   }
+}
+
+TEST_FIX(TerrainQuery, RaysMatchSingleQueries)
+{
+   createTerrain( 256 );
+   ASSERT_TRUE( terrain != NULL );
+
+   const U32 count = 2000;
+   Vector<Point3F> starts, ends;
+   randomRays( starts, ends, count, 3 );
+
+   Vector<RayInfo> infos;
+   Vector<bool> hits;
+   infos.setSize( count );
+   hits.setSize( count );
+
+   const U32 numHits = terrain->castRays( starts.address(), ends.address(), count, infos.address(), hits.address() );
+
+   U32 expectedHits = 0;
+   for ( U32 i = 0; i < count; i++ )
+   {
+      RayInfo info;
+      const bool hit = terrain->castRay( starts[i], ends[i], &info );
+      expectedHits += hit;
+
+      ASSERT_EQ( hit, hits[i] ) << "ray " << i;
+      if ( !hit )
+         continue;
+
+      EXPECT_FLOAT_EQ( info.t, infos[i].t );
+      EXPECT_TRUE( info.normal.equal( infos[i].normal ) );
+      EXPECT_TRUE( info.point.equal( infos[i].point ) );
+   }
+
+   EXPECT_EQ( numHits, expectedHits );
+   EXPECT_GT( numHits, 0 );
+   EXPECT_LT( numHits, count );
+}
+
+TEST_FIX(TerrainQuery, StressTestQueries)
+{
+   // A million height and normal queries and 100k rays on
+   // a 4k terrain, one at a time and batched.
+   createTerrain( 4096 );
+   ASSERT_TRUE( terrain != NULL );
+
+   const U32 numPositions = 1000000;
+   Vector<Point2F> positions;
+   randomPositions( positions, numPositions, 4 );
+
+   Vector<F32> heights;
+   Vector<Point3F> normals;
+   Vector<bool> valid;
+   heights.setSize( numPositions );
+   normals.setSize( numPositions );
+   valid.setSize( numPositions );
+
+   U32 start = Platform::getRealMilliseconds();
+   for ( U32 i = 0; i < numPositions; i++ )
+      valid[i] = terrain->getNormalAndHeight( positions[i], &normals[i], &heights[i] );
+   const U32 singleMs = Platform::getRealMilliseconds() - start;
+
+   start = Platform::getRealMilliseconds();
+   terrain->getNormalsAndHeights( positions.address(), numPositions, normals.address(), heights.address(), valid.address() );
+   const U32 batchMs = Platform::getRealMilliseconds() - start;
+
+   Con::printf( "TerrainQuery: %d normals and heights, single %d ms, batched %d ms", numPositions, singleMs, batchMs );
+
+   const U32 numRays = 100000;
+   Vector<Point3F> starts, ends;
+   randomRays( starts, ends, numRays, 5 );
+
+   Vector<RayInfo> infos;
+   Vector<bool> hits;
+   infos.setSize( numRays );
+   hits.setSize( numRays );
+
+   start = Platform::getRealMilliseconds();
+   for ( U32 i = 0; i < numRays; i++ )
+      hits[i] = terrain->castRay( starts[i], ends[i], &infos[i] );
+   const U32 singleRayMs = Platform::getRealMilliseconds() - start;
+
+   const S32 oldThreshold = Con::getIntVariable( "$TerrainBlock::parallelRayThreshold" );
+   Con::setIntVariable( "$TerrainBlock::parallelRayThreshold", 0 );
+   start = Platform::getRealMilliseconds();
+   terrain->castRays( starts.address(), ends.address(), numRays, infos.address(), hits.address() );
+   const U32 serialRayMs = Platform::getRealMilliseconds() - start;
+
+   Con::setIntVariable( "$TerrainBlock::parallelRayThreshold", oldThreshold );
+   start = Platform::getRealMilliseconds();
+   terrain->castRays( starts.address(), ends.address(), numRays, infos.address(), hits.address() );
+   const U32 parallelRayMs = Platform::getRealMilliseconds() - start;
+
+   Con::printf( "TerrainQuery: %d rays, single %d ms, batched %d ms, batched parallel %d ms",
+      numRays, singleRayMs, serialRayMs, parallelRayMs );
+}
+
+#endif
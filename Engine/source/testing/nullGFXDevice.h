@@ -0,0 +1,76 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2014 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _TESTING_NULLGFXDEVICE_H_
+#define _TESTING_NULLGFXDEVICE_H_
+
+#ifdef TORQUE_TESTS_ENABLED
+
+#include "gfx/gfxDevice.h"
+#include "gfx/Null/gfxNullDevice.h"
+
+/// Gives tests a GFX device to run against when the test runner has none.
+///
+/// create() makes a GFXNullDevice only if no device exists yet, and
+/// destroy() tears down just the device created here.  Fixtures call
+/// them from SetUp() and TearDown().
+class NullGFXDevice
+{
+public:
+
+   NullGFXDevice() : mDevice( NULL ) {}
+   ~NullGFXDevice() { destroy(); }
+
+   /// @param pixelShaderVersion  If not zero, the null device reports this
+   ///   version so that materials take their shader paths.
+   void create( F32 pixelShaderVersion = 0.0f )
+   {
+      if ( mDevice || GFXDevice::get() )
+         return;
+
+      mDevice = new GFXNullDevice();
+      if ( pixelShaderVersion > 0.0f )
+         mDevice->setPixelShaderVersion( pixelShaderVersion );
+   }
+
+   void destroy()
+   {
+      if ( !mDevice )
+         return;
+
+      mDevice->preDestroy();
+      delete mDevice;
+      mDevice = NULL;
+   }
+
+   /// Returns the device created by create() or NULL if the
+   /// test runs on a device that already existed.
+   GFXNullDevice* getDevice() const { return mDevice; }
+
+protected:
+
+   GFXNullDevice *mDevice;
+};
+
+#endif // TORQUE_TESTS_ENABLED
+
+#endif // _TESTING_NULLGFXDEVICE_H_
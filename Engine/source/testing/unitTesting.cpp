@@ -76,11 +76,12 @@ public:
    TorqueUnitTestListener( bool verbose ) : mVerbose( verbose ) {}
 };
 
-DefineEngineFunction( runAllUnitTests, int, (const char* testSpecs), (""),
+DefineEngineFunction( runAllUnitTests, int, (const char* testSpecs), ("-*.Stress*"),
    "Runs engine unit tests. Some tests are marked as 'stress' tests which do not "
    "necessarily check correctness, just performance or possible nondeterministic "
-   "glitches. There may also be interactive or networking tests which may be "
-   "excluded by using the testSpecs argument.\n"
+   "glitches. Their names start with Stress and the default testSpecs skips them, "
+   "while \"*\" runs every test. There may also be interactive or "
+   "networking tests which may be excluded by using the testSpecs argument.\n"
    "This function should only be called once per executable run, because of "
    "googletest's design.\n\n"
 
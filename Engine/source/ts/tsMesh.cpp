@@ -86,7 +86,7 @@ bool TSMesh::smUseEncodedNormals = false;
 
 const F32 TSMesh::VISIBILITY_EPSILON = 0.0001f;
 
-S32 TSMesh::smMaxInstancingVerts = 200;
+S32 TSMesh::smMaxInstancingVerts = 2000;
 MatrixF TSMesh::smDummyNodeTransform(1);
 
 // quick function to force object to face camera -- currently throws out roll :(
@@ -168,14 +168,16 @@ void TSMesh::innerRender( TSMaterialList *materials, const TSRenderState &rdata,
    const MatrixF &objToWorld = GFX->getWorldMatrix();
 
    // Sort by the center point or the bounds.
+   Box3F rBox = mBounds;
+   objToWorld.mul( rBox );
    if ( rdata.useOriginSort() )
       coreRI->sortDistSq = ( objToWorld.getPosition() - state->getCameraPosition() ).lenSquared();
    else
-   {
-      Box3F rBox = mBounds;
-      objToWorld.mul( rBox );
       coreRI->sortDistSq = rBox.getSqDistanceToPoint( state->getCameraPosition() );      
-   }
+
+   // The size on screen drives texture streaming.
+   const F32 radius = rBox.len() * 0.5f;
+   coreRI->screenSize = state->projectRadius( ( rBox.getCenter() - state->getDiffuseCameraPosition() ).len(), radius ) * 2.0f;
 
    if (getFlags(Billboard))
    {
@@ -81,6 +81,26 @@ void CatmullRomBase::_initialize( U32 count, const F32 *times )
    }
 }
 
+U32 CatmullRomBase::_findSegment( F32 t ) const
+{
+   // The times are sorted, so binary search for the first
+   // segment whose end time is at or beyond t.  This matches
+   // the result of a linear walk from the first segment but
+   // keeps evaluation cheap on splines with many nodes.
+   U32 lo = 0;
+   U32 hi = mCount - 1;
+   while ( lo < hi )
+   {
+      const U32 mid = ( lo + hi ) / 2;
+      if ( t <= mTimes[mid+1] )
+         hi = mid;
+      else
+         lo = mid + 1;
+   }
+
+   return lo;
+}
+
 void CatmullRomBase::clear()
 {
    delete [] mTimes;
@@ -105,25 +125,11 @@ F32 CatmullRomBase::arcLength( F32 t1, F32 t2 )
       t2 = mTimes[mCount-1];
 
    // find segment and parameter
-   U32 seg1;
-   for ( seg1 = 0; seg1 < mCount-1; ++seg1 )
-   {
-      if ( t1 <= mTimes[seg1+1] )
-      {
-         break;
-      }
-   }
+   U32 seg1 = _findSegment( t1 );
    F32 u1 = (t1 - mTimes[seg1])/(mTimes[seg1+1] - mTimes[seg1]);
 
    // find segment and parameter
-   U32 seg2;
-   for ( seg2 = 0; seg2 < mCount-1; ++seg2 )
-   {
-      if ( t2 <= mTimes[seg2+1] )
-      {
-         break;
-      }
-   }
+   U32 seg2 = _findSegment( t2 );
    F32 u2 = (t2 - mTimes[seg2])/(mTimes[seg2+1] - mTimes[seg2]);
 
    F32 result;
@@ -155,12 +161,7 @@ U32 CatmullRomBase::getPrevNode( F32 t )
       return mCount-1;
 
    // find segment and parameter
-   U32 i;  // segment #
-   for ( i = 0; i < mCount-1; ++i )
-   {
-      if ( t <= mTimes[i+1] )
-         break;
-   }
+   U32 i = _findSegment( t );  // segment #
 
    AssertFatal( i >= 0 && i < mCount, "CatmullRomBase::getPrevNode - Got bad output index!" );
 
@@ -61,6 +61,9 @@ protected:
 
    void _initialize( U32 count, const F32 *times = NULL );   
 
+   /// Returns the index of the segment containing time t.
+   U32 _findSegment( F32 t ) const;
+
    /// The time to arrive at each point.
    F32 *mTimes;
 
@@ -168,14 +171,7 @@ inline TYPE CatmullRom<TYPE>::evaluate( F32 t )
       return mPositions[mCount-1];
 
    // find segment and parameter
-   U32 i;  // segment #
-   for ( i = 0; i < mCount-1; ++i )
-   {
-      if ( t <= mTimes[i+1] )
-      {
-         break;
-      }
-   }
+   U32 i = _findSegment( t );  // segment #
 
    AssertFatal( i >= 0 && i < mCount, "CatmullRom::evaluate - Got bad index!" );
 
@@ -221,14 +217,7 @@ inline TYPE CatmullRom<TYPE>::velocity( F32 t )
       t = mTimes[mCount-1];
 
    // find segment and parameter
-   U32 i;
-   for ( i = 0; i < mCount-1; ++i )
-   {
-      if ( t <= mTimes[i+1] )
-      {
-         break;
-      }
-   }
+   U32 i = _findSegment( t );
    F32 t0 = mTimes[i];
    F32 t1 = mTimes[i+1];
    F32 u = (t - t0)/(t1 - t0);
@@ -271,14 +260,7 @@ inline TYPE CatmullRom<TYPE>::acceleration( F32 t )
       t = mTimes[mCount-1];
 
    // find segment and parameter
-   U32 i;
-   for ( i = 0; i < mCount-1; ++i )
-   {
-      if ( t <= mTimes[i+1] )
-      {
-         break;
-      }
-   }
+   U32 i = _findSegment( t );
    F32 t0 = mTimes[i];
    F32 t1 = mTimes[i+1];
    F32 u = (t - t0)/(t1 - t0);
@@ -0,0 +1,117 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "../../shaderModel.hlsl"
+#include "../../shaderModelAutoGen.hlsl"
+
+#include "farFrustumQuad.hlsl"
+#include "../../torque.hlsl"
+#include "../../lighting.hlsl"
+
+TORQUE_UNIFORM_SAMPLER2D(deferredBuffer, 0);
+TORQUE_UNIFORM_SAMPLER2D(colorBuffer, 1);
+TORQUE_UNIFORM_SAMPLER2D(matInfoBuffer, 2);
+TORQUE_UNIFORM_SAMPLER2D(clusterData, 3);
+
+uniform float4 rtParams0;
+uniform float3 eyePosWorld;
+uniform float4 zNearFarInvNearFar;
+uniform float4x4 cameraToWorld;
+
+// { tilesX, tilesY, slices, sliceScale }
+uniform float4 clusterParams;
+
+// { 1 / zNear, data width, cluster header offset, light index offset }
+uniform float4 clusterDataParams;
+
+float4 fetchClusterData( float index )
+{
+   float row = floor( index / clusterDataParams.y );
+   return texture_clusterData.Load( int3( index - row * clusterDataParams.y, row, 0 ) );
+}
+
+float fetchLightIndex( float index )
+{
+   // The indices are packed four to a texel.
+   float texel = floor( index / 4.0 );
+   float4 indices = fetchClusterData( clusterDataParams.w + texel );
+   float c = index - texel * 4.0;
+   return dot( indices, float4( c == 0.0, c == 1.0, c == 2.0, c == 3.0 ) );
+}
+
+float4 main( FarFrustumQuadConnectP IN ) : SV_TARGET
+{
+   //unpack normal and linear depth  
+   float4 normDepth = TORQUE_DEFERRED_UNCONDITION(deferredBuffer, IN.uv0);
+  
+   //create surface
+   Surface surface = createSurface( normDepth, TORQUE_SAMPLER2D_MAKEARG(colorBuffer),TORQUE_SAMPLER2D_MAKEARG(matInfoBuffer),
+                                    IN.uv0, eyePosWorld, IN.wsEyeRay, cameraToWorld);
+                                    
+   //early out if emissive
+   if (getFlag(surface.matFlag, 0))
+   {   
+      return float4(0, 0, 0, 0);
+   }
+
+   //find the cluster holding this pixel
+   float2 screenUV = saturate( ( IN.uv0 - rtParams0.xy ) / rtParams0.zw );
+   float2 tile = min( floor( screenUV * clusterParams.xy ), clusterParams.xy - 1.0 );
+   float viewDepth = surface.depth * zNearFarInvNearFar.y;
+   float slice = clamp( floor( log( viewDepth * clusterDataParams.x ) * clusterParams.w ), 0.0, clusterParams.z - 1.0 );
+   float cluster = ( slice * clusterParams.y + tile.y ) * clusterParams.x + tile.x;
+
+   // { first light index, light count }
+   float2 header = fetchClusterData( clusterDataParams.z + cluster ).xy;
+
+   float3 lighting = 0.0.xxx;
+   [loop]
+   for ( float i = 0; i < header.y; i++ )
+   {
+      float light = fetchLightIndex( header.x + i ) * 3.0;
+
+      // { position, 1 / range^2 }, { color, spot outer cos }, { direction, spot cos delta }
+      float4 posInvSqrRange = fetchClusterData( light );
+      float3 L = posInvSqrRange.xyz - surface.P;
+
+      [branch]
+      if ( dot( L, L ) * posInvSqrRange.w < 1.0 )
+      {
+         float4 colorSpot = fetchClusterData( light + 1.0 );
+         SurfaceToLight surfaceToLight = createSurfaceToLight(surface, L);
+
+         float3 lit = getPunctualLight(surface, surfaceToLight, colorSpot.rgb, 1.0, posInvSqrRange.w, 1.0);
+
+         // Point lights have an outer cos of -2.
+         [branch]
+         if ( colorSpot.w > -1.5 )
+         {
+            float4 dirSpot = fetchClusterData( light + 2.0 );
+            lit *= getSpotAngleAtt(-surfaceToLight.L, dirSpot.xyz, float2( colorSpot.w, dirSpot.w ) );
+         }
+
+         lighting += lit;
+      }
+   }
+
+   return float4(lighting, 0);
+}
@@ -0,0 +1,120 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "../../../gl/hlslCompat.glsl"
+#include "shadergen:/autogenConditioners.h"
+#include "farFrustumQuad.glsl"
+#include "../../../gl/torque.glsl"
+#include "../../../gl/lighting.glsl"
+#line 28
+in vec4 hpos;
+in vec2 uv0;
+in vec3 wsEyeRay;
+in vec3 vsEyeRay;
+
+uniform sampler2D deferredBuffer;
+uniform sampler2D colorBuffer;
+uniform sampler2D matInfoBuffer;
+uniform sampler2D clusterData;
+
+uniform vec4 rtParams0;
+uniform vec3 eyePosWorld;
+uniform vec4 zNearFarInvNearFar;
+uniform mat4 cameraToWorld;
+
+// { tilesX, tilesY, slices, sliceScale }
+uniform vec4 clusterParams;
+
+// { 1 / zNear, data width, cluster header offset, light index offset }
+uniform vec4 clusterDataParams;
+
+vec4 fetchClusterData( float index )
+{
+   float row = floor( index / clusterDataParams.y );
+   return texelFetch( clusterData, ivec2( index - row * clusterDataParams.y, row ), 0 );
+}
+
+float fetchLightIndex( float index )
+{
+   // The indices are packed four to a texel.
+   float texel = floor( index / 4.0 );
+   vec4 indices = fetchClusterData( clusterDataParams.w + texel );
+   return indices[ int( index - texel * 4.0 ) ];
+}
+
+out vec4 OUT_col;
+
+void main()
+{
+   //unpack normal and linear depth  
+   vec4 normDepth = deferredUncondition(deferredBuffer, uv0);
+  
+   //create surface
+   Surface surface = createSurface( normDepth, colorBuffer, matInfoBuffer,
+                                    uv0, eyePosWorld, wsEyeRay, cameraToWorld);
+   
+   //early out if emissive
+   if (getFlag(surface.matFlag, 0))
+   {
+      OUT_col = vec4(0, 0, 0, 0);
+      return;
+   }
+
+   //find the cluster holding this pixel
+   vec2 screenUV = clamp( ( uv0 - rtParams0.xy ) / rtParams0.zw, 0.0, 1.0 );
+   vec2 tile = min( floor( screenUV * clusterParams.xy ), clusterParams.xy - 1.0 );
+   float viewDepth = surface.depth * zNearFarInvNearFar.y;
+   float slice = clamp( floor( log( viewDepth * clusterDataParams.x ) * clusterParams.w ), 0.0, clusterParams.z - 1.0 );
+   float cluster = ( slice * clusterParams.y + tile.y ) * clusterParams.x + tile.x;
+
+   // { first light index, light count }
+   vec2 header = fetchClusterData( clusterDataParams.z + cluster ).xy;
+
+   vec3 lighting = vec3(0.0);
+   for ( float i = 0; i < header.y; i++ )
+   {
+      float light = fetchLightIndex( header.x + i ) * 3.0;
+
+      // { position, 1 / range^2 }, { color, spot outer cos }, { direction, spot cos delta }
+      vec4 posInvSqrRange = fetchClusterData( light );
+      vec3 L = posInvSqrRange.xyz - surface.P;
+
+      if ( dot( L, L ) * posInvSqrRange.w < 1.0 )
+      {
+         vec4 colorSpot = fetchClusterData( light + 1.0 );
+         SurfaceToLight surfaceToLight = createSurfaceToLight(surface, L);
+
+         vec3 lit = getPunctualLight(surface, surfaceToLight, colorSpot.rgb, 1.0, posInvSqrRange.w, 1.0);
+
+         // Point lights have an outer cos of -2.
+         if ( colorSpot.w > -1.5 )
+         {
+            vec4 dirSpot = fetchClusterData( light + 2.0 );
+            lit *= getSpotAngleAtt(-surfaceToLight.L, dirSpot.xyz, vec2( colorSpot.w, dirSpot.w ) );
+         }
+
+         lighting += lit;
+      }
+   }
+
+   OUT_col = vec4(lighting, 0);
+}
@@ -256,6 +256,9 @@ addPath("${srcDir}/") # must come first :)
 addPathRec("${srcDir}/app")
 addPath("${srcDir}/sfx/media")
 addPath("${srcDir}/sfx/null")
+addPath("${srcDir}/sfx/software")
+addPath("${srcDir}/sfx/software/arch")
+addPath("${srcDir}/sfx/software/test")
 addPath("${srcDir}/sfx")
 addPath("${srcDir}/console")
 addPath("${srcDir}/console/test")
@@ -263,6 +266,7 @@ addPath("${srcDir}/core")
 addPath("${srcDir}/core/stream")
 addPath("${srcDir}/core/strings")
 addPath("${srcDir}/core/util")
+addPath("${srcDir}/core/util/arch")
 addPath("${srcDir}/core/util/test")
 addPath("${srcDir}/core/util/journal")
 addPath("${srcDir}/core/util/journal/test")
@@ -305,6 +309,7 @@ addPath("${srcDir}/gfx/Null")
 addPath("${srcDir}/gfx/test")
 addPath("${srcDir}/gfx/bitmap")
 addPath("${srcDir}/gfx/bitmap/loaders")
+addPath("${srcDir}/gfx/bitmap/test")
 addPath("${srcDir}/gfx/util")
 addPath("${srcDir}/gfx/video")
 addPath("${srcDir}/gfx")
@@ -320,19 +325,27 @@ addPath("${srcDir}/gui/utility")
 addPath("${srcDir}/gui")
 addPath("${srcDir}/collision")
 addPath("${srcDir}/materials")
+addPath("${srcDir}/materials/test")
 addPath("${srcDir}/lighting")
 addPath("${srcDir}/lighting/common")
 addPath("${srcDir}/renderInstance")
 addPath("${srcDir}/renderInstance/debug")
+addPath("${srcDir}/renderInstance/test")
 addPath("${srcDir}/scene")
 addPath("${srcDir}/scene/culling")
+addPath("${srcDir}/scene/culling/test")
 addPath("${srcDir}/scene/zones")
 addPath("${srcDir}/scene/mixin")
 addPath("${srcDir}/shaderGen")
+addPath("${srcDir}/shaderGen/test")
 addPath("${srcDir}/terrain")
+addPath("${srcDir}/terrain/arch")
+addPath("${srcDir}/terrain/test")
 addPath("${srcDir}/environment")
+addPath("${srcDir}/environment/test")
 addPath("${srcDir}/forest")
 addPath("${srcDir}/forest/ts")
+addPath("${srcDir}/forest/test")
 addPath("${srcDir}/ts")
 addPath("${srcDir}/ts/arch")
 addPath("${srcDir}/physics")
@@ -345,9 +358,12 @@ set(BLACKLIST "" )
 addPath("${srcDir}/T3D/examples")
 addPath("${srcDir}/T3D/fps")
 addPath("${srcDir}/T3D/fx")
+addPath("${srcDir}/T3D/fx/arch")
+addPath("${srcDir}/T3D/fx/test")
 addPath("${srcDir}/T3D/vehicles")
 addPath("${srcDir}/T3D/physics")
 addPath("${srcDir}/T3D/decal")
+addPath("${srcDir}/T3D/decal/test")
 addPath("${srcDir}/T3D/sfx")
 addPath("${srcDir}/T3D/gameBase")
 addPath("${srcDir}/T3D/turret")
@@ -386,6 +402,7 @@ endif()
 # lighting
 if(TORQUE_ADVANCED_LIGHTING)
     addPath("${srcDir}/lighting/advanced")
+    addPath("${srcDir}/lighting/advanced/test")
     addPathRec("${srcDir}/lighting/shadowMap")
     if(WIN32)
 		addPathRec("${srcDir}/lighting/advanced/hlsl")